@@ -15,28 +15,77 @@ struct arena_s {
     size_t chunk_size;
     size_t chunk_count;
     size_t total_allocated;
+    bool paged;                 // 块由页分配器分配 (大页/预取/NUMA 模式)
+    page_alloc_config_t page_config;
 };
 
-arena_t* arena_create(size_t initial_size) {
-    if (initial_size == 0) initial_size = 4096;
-    
+// 分配至少能容纳 data_size 字节的块; 页分配模式下整块向上取整, 多出的部分也可用
+static arena_chunk_t* chunk_alloc(arena_t *a, size_t data_size) {
+    arena_chunk_t *chunk;
+    if (a->paged) {
+        size_t unit = a->page_config.huge != PAGE_HUGE_NONE ? page_alloc_get_huge_page_size()
+                                                            : page_alloc_get_page_size();
+        size_t total = (sizeof(arena_chunk_t) + data_size + unit - 1) / unit * unit;
+        chunk = page_alloc_ex(total, &a->page_config, NULL);
+        if (!chunk) return NULL;
+        data_size = total - sizeof(arena_chunk_t);
+    } else {
+        chunk = malloc(sizeof(arena_chunk_t) + data_size);
+        if (!chunk) return NULL;
+    }
+    chunk->size = data_size;
+    chunk->used = 0;
+    chunk->next = NULL;
+    return chunk;
+}
+
+static void chunk_free(arena_t *a, arena_chunk_t *chunk) {
+    if (a->paged) page_free(chunk);
+    else free(chunk);
+}
+
+arena_config_t arena_default_config(void) {
+    arena_config_t config = {
+        .chunk_size = 4096,
+        .huge_pages = false,
+        .prefault = false,
+        .numa = PAGE_NUMA_DEFAULT,
+        .numa_node = 0
+    };
+    return config;
+}
+
+arena_t* arena_create_ex(const arena_config_t *config) {
+    arena_config_t cfg = config ? *config : arena_default_config();
+    if (cfg.chunk_size == 0) cfg.chunk_size = 4096;
+
     arena_t *a = malloc(sizeof(arena_t));
     if (!a) return NULL;
-    
-    a->chunk_size = initial_size > 1024 ? initial_size : 4096;
+
+    a->chunk_size = cfg.chunk_size > 1024 ? cfg.chunk_size : 4096;
     a->chunk_count = 1;
     a->total_allocated = 0;
-    a->current = malloc(sizeof(arena_chunk_t) + a->chunk_size);
+    a->paged = cfg.huge_pages || cfg.prefault || cfg.numa != PAGE_NUMA_DEFAULT;
+    a->page_config = page_alloc_default_config();
+    a->page_config.zero_initialize = false;
+    a->page_config.huge = cfg.huge_pages ? PAGE_HUGE_EXPLICIT : PAGE_HUGE_NONE;
+    a->page_config.prefault = cfg.prefault;
+    a->page_config.numa = cfg.numa;
+    a->page_config.numa_node = cfg.numa_node;
+    a->current = chunk_alloc(a, a->chunk_size);
     if (!a->current) {
         free(a);
         return NULL;
     }
-    a->current->size = a->chunk_size;
-    a->current->used = 0;
-    a->current->next = NULL;
     return a;
 }
 
+arena_t* arena_create(size_t initial_size) {
+    arena_config_t config = arena_default_config();
+    config.chunk_size = initial_size;
+    return arena_create_ex(&config);
+}
+
 arena_t* arena_create_default(void) {
     return arena_create(4096);
 }
@@ -46,7 +95,7 @@ void arena_destroy(arena_t *a) {
     arena_chunk_t *curr = a->current;
     while (curr) {
         arena_chunk_t *next = curr->next;
-        free(curr);
+        chunk_free(a, curr);
         curr = next;
     }
     free(a);
@@ -60,10 +109,8 @@ void* arena_alloc(arena_t *a, size_t size) {
 
     if (a->current->used + size > a->current->size) {
         size_t next_size = size > a->chunk_size ? size : a->chunk_size;
-        arena_chunk_t *new_chunk = malloc(sizeof(arena_chunk_t) + next_size);
+        arena_chunk_t *new_chunk = chunk_alloc(a, next_size);
         if (!new_chunk) return NULL;
-        new_chunk->size = next_size;
-        new_chunk->used = 0;
         new_chunk->next = a->current;
         a->current = new_chunk;
         a->chunk_count++;
@@ -113,7 +160,7 @@ void arena_reset(arena_t *a) {
     arena_chunk_t *curr = a->current;
     while (curr->next) {
         arena_chunk_t *next = curr->next;
-        free(curr);
+        chunk_free(a, curr);
         curr = next;
         a->chunk_count--;
     }
@@ -136,7 +183,7 @@ void arena_reset_keep_first(arena_t *a) {
     arena_chunk_t *curr = a->current;
     while (curr != first) {
         arena_chunk_t *next = curr->next;
-        free(curr);
+        chunk_free(a, curr);
         curr = next;
         a->chunk_count--;
     }
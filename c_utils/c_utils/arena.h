@@ -3,12 +3,25 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include "page_allocator.h"
 
 typedef struct arena_s arena_t;
 
+// 块的分配方式; 全部为默认值时与 arena_create 相同 (malloc 块)
+// huge_pages 时每块按 2MB 大页向上取整, 先尝试显式大页, 不可用时用透明大页, 减少大缓冲区的 TLB 缺失
+typedef struct {
+    size_t chunk_size;          // 块大小 (0 表示 4096)
+    bool huge_pages;            // 按 2MB 大页块增长
+    bool prefault;              // 新块预先缺页
+    page_numa_policy_t numa;    // 新块的 NUMA 放置策略
+    int numa_node;              // PAGE_NUMA_BIND 使用的节点
+} arena_config_t;
+
 // 创建与销毁
 arena_t* arena_create(size_t initial_size);
 arena_t* arena_create_default(void);
+arena_config_t arena_default_config(void);
+arena_t* arena_create_ex(const arena_config_t *config);
 void     arena_destroy(arena_t *a);
 
 // 内存分配
@@ -1,6 +1,9 @@
 #include "astar.h"
+#include "graph_heap_internal.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <limits.h>
 #include <math.h>
 
 #define ASTAR_DEFAULT_MAX_ITERATIONS 10000
@@ -32,7 +35,13 @@ static void pq_free(astar_pq_t *pq) {
 }
 
 static void pq_push(astar_pq_t *pq, astar_node_t *node) {
-    if (!pq || !node || pq->size >= pq->capacity) return;
+    if (!pq || !node) return;
+    if (pq->size >= pq->capacity) {
+        astar_node_t **nodes = realloc(pq->nodes, sizeof(astar_node_t*) * pq->capacity * 2);
+        if (!nodes) return;
+        pq->nodes = nodes;
+        pq->capacity *= 2;
+    }
     
     size_t i = pq->size++;
     while (i > 0) {
@@ -239,6 +248,7 @@ astar_result_t astar_search(
         result.path = malloc(sizeof(point_t));
         if (result.path) {
             result.path[0] = start;
+            result.path_capacity = 1;
         }
         return result;
     }
@@ -283,6 +293,8 @@ astar_result_t astar_search(
         if (current->pos.x == goal.x && current->pos.y == goal.y) {
             result.found = true;
             result.path = reconstruct_path(current, &result.path_len);
+            result.path_capacity = result.path_len;
+            result.cost = current->g;
             break;
         }
         
@@ -339,6 +351,393 @@ astar_result_t astar_search_simple(
     return astar_search(world, start, goal, is_walkable, NULL, ASTAR_MANHATTAN, 10000);
 }
 
+// 网格 A*
+#define GRID_POS_NONE UINT32_MAX
+
+GRAPH_HEAP_DEFINE(grid_heap_u64, uint64_t, uint32_t)
+
+struct astar_grid_s {
+    int width;
+    int height;
+    astar_grid_moves_t moves;
+    size_t cells;
+    uint8_t *cost;           // 0 为障碍
+    size_t weighted;         // 代价倍数不为 1 的可通行格子数, 为 0 时才能使用 JPS
+    int *g;
+    int *parent;             // 父格子编号 (JPS 中为上一个跳点), 起点为 -1
+    uint32_t *heap_pos;
+    uint32_t *stamp;         // g/parent/heap_pos 只在 stamp 等于本次查询编号时有效, 免去每次清空
+    uint32_t query;
+    uint64_t *closed;        // 关闭集位图
+    uint64_t *row_bits;      // 按行的可通行位图, 每行 row_words 个字, 供 JPS 按字扫描
+    uint64_t *col_bits;      // 按列的可通行位图, 每列 col_words 个字
+    size_t row_words;
+    size_t col_words;
+    size_t closed_words;
+    uint64_t *heap_key;      // (f << 32) | h: f 相同时先扩展离终点近的格子
+    int *heap_node;
+    size_t heap_size;
+};
+
+astar_grid_t* astar_grid_create(int width, int height, astar_grid_moves_t moves) {
+    if (width <= 0 || height <= 0 || (size_t)width * (size_t)height > INT_MAX) return NULL;
+
+    astar_grid_t *grid = calloc(1, sizeof(astar_grid_t));
+    if (!grid) return NULL;
+    grid->width = width;
+    grid->height = height;
+    grid->moves = moves;
+    grid->cells = (size_t)width * (size_t)height;
+    grid->closed_words = (grid->cells + 63) / 64;
+    grid->row_words = ((size_t)width + 63) / 64;
+    grid->col_words = ((size_t)height + 63) / 64;
+    grid->cost = malloc(grid->cells);
+    grid->g = malloc(grid->cells * sizeof(int));
+    grid->parent = malloc(grid->cells * sizeof(int));
+    grid->heap_pos = malloc(grid->cells * sizeof(uint32_t));
+    grid->stamp = calloc(grid->cells, sizeof(uint32_t));
+    grid->closed = malloc(grid->closed_words * sizeof(uint64_t));
+    grid->heap_key = malloc(grid->cells * sizeof(uint64_t));
+    grid->heap_node = malloc(grid->cells * sizeof(int));
+    grid->row_bits = calloc((size_t)height * grid->row_words, sizeof(uint64_t));
+    grid->col_bits = calloc((size_t)width * grid->col_words, sizeof(uint64_t));
+    if (!grid->cost || !grid->g || !grid->parent || !grid->heap_pos || !grid->stamp ||
+        !grid->closed || !grid->heap_key || !grid->heap_node || !grid->row_bits || !grid->col_bits) {
+        astar_grid_free(grid);
+        return NULL;
+    }
+    memset(grid->cost, 1, grid->cells);
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++) {
+            grid->row_bits[(size_t)y * grid->row_words + (size_t)x / 64] |= 1ULL << (x & 63);
+            grid->col_bits[(size_t)x * grid->col_words + (size_t)y / 64] |= 1ULL << (y & 63);
+        }
+    }
+    return grid;
+}
+
+void astar_grid_free(astar_grid_t *grid) {
+    if (!grid) return;
+    free(grid->cost);
+    free(grid->g);
+    free(grid->parent);
+    free(grid->heap_pos);
+    free(grid->stamp);
+    free(grid->closed);
+    free(grid->heap_key);
+    free(grid->heap_node);
+    free(grid->row_bits);
+    free(grid->col_bits);
+    free(grid);
+}
+
+static inline bool grid_walkable(const astar_grid_t *grid, int x, int y) {
+    return (unsigned)x < (unsigned)grid->width && (unsigned)y < (unsigned)grid->height &&
+           grid->cost[(size_t)y * (size_t)grid->width + (size_t)x] != 0;
+}
+
+bool astar_grid_set_cost(astar_grid_t *grid, int x, int y, int cost) {
+    if (!grid || (unsigned)x >= (unsigned)grid->width || (unsigned)y >= (unsigned)grid->height ||
+        cost < 0 || cost > UINT8_MAX) {
+        return false;
+    }
+    uint8_t *cell = &grid->cost[(size_t)y * (size_t)grid->width + (size_t)x];
+    if (*cell > 1) grid->weighted--;
+    if (cost > 1) grid->weighted++;
+    *cell = (uint8_t)cost;
+
+    uint64_t *row = &grid->row_bits[(size_t)y * grid->row_words + (size_t)x / 64];
+    uint64_t *col = &grid->col_bits[(size_t)x * grid->col_words + (size_t)y / 64];
+    if (cost != 0) {
+        *row |= 1ULL << (x & 63);
+        *col |= 1ULL << (y & 63);
+    } else {
+        *row &= ~(1ULL << (x & 63));
+        *col &= ~(1ULL << (y & 63));
+    }
+    return true;
+}
+
+int astar_grid_get_cost(const astar_grid_t *grid, int x, int y) {
+    if (!grid || (unsigned)x >= (unsigned)grid->width || (unsigned)y >= (unsigned)grid->height) return 0;
+    return grid->cost[(size_t)y * (size_t)grid->width + (size_t)x];
+}
+
+bool astar_grid_is_walkable(const astar_grid_t *grid, int x, int y) {
+    return grid && grid_walkable(grid, x, y);
+}
+
+// 八方向为对角线距离, 四方向为曼哈顿距离 (直线 10, 对角 14)
+static inline int grid_distance(const astar_grid_t *grid, int x0, int y0, int x1, int y1) {
+    int ddx = abs(x0 - x1);
+    int ddy = abs(y0 - y1);
+    if (grid->moves == ASTAR_GRID_4) return 10 * (ddx + ddy);
+    int lo = ddx < ddy ? ddx : ddy;
+    int hi = ddx < ddy ? ddy : ddx;
+    return lo * 14 + (hi - lo) * 10;
+}
+
+// 堆的三个数组放在网格里跨查询复用, 键为 64 位的 (f << 32) | h
+static inline void grid_heap_sift_up(astar_grid_t *grid, size_t i, int node, uint64_t key) {
+    grid_heap_u64_sift_up(grid->heap_node, grid->heap_key, grid->heap_pos, i, node, key);
+}
+
+static inline int grid_heap_pop(astar_grid_t *grid) {
+    return grid_heap_u64_pop(grid->heap_node, grid->heap_key, grid->heap_pos, &grid->heap_size, GRID_POS_NONE);
+}
+
+static inline bool grid_is_closed(const astar_grid_t *grid, int v) {
+    return (grid->closed[(size_t)v >> 6] >> (v & 63)) & 1;
+}
+
+// 以代价 g 经 parent 到达 v: 首次到达入堆, 更优则原地 decrease-key
+static void grid_relax(astar_grid_t *grid, int v, int g, int parent, point_t goal) {
+    if (grid->stamp[v] != grid->query) {
+        grid->stamp[v] = grid->query;
+        grid->g[v] = INT_MAX;
+        grid->heap_pos[v] = GRID_POS_NONE;
+    }
+    if (g >= grid->g[v]) return;
+    grid->g[v] = g;
+    grid->parent[v] = parent;
+
+    int x = v % grid->width;
+    int y = v / grid->width;
+    uint64_t h = (uint64_t)grid_distance(grid, x, y, goal.x, goal.y);
+    uint64_t key = ((uint64_t)g + h) << 32 | h;
+    if (grid->heap_pos[v] == GRID_POS_NONE) {
+        grid_heap_sift_up(grid, grid->heap_size++, v, key);
+    } else {
+        grid_heap_sift_up(grid, grid->heap_pos[v], v, key);
+    }
+}
+
+// 普通 A* 扩展: 四方向取偶数下标, 对角移动要求两侧直线格都可通行
+static void grid_expand(astar_grid_t *grid, int u, point_t goal) {
+    int x = u % grid->width;
+    int y = u / grid->width;
+    int step = grid->moves == ASTAR_GRID_4 ? 2 : 1;
+    for (int i = 0; i < 8; i += step) {
+        int nx = x + dx[i];
+        int ny = y + dy[i];
+        if (!grid_walkable(grid, nx, ny)) continue;
+        if ((i & 1) && (!grid_walkable(grid, nx, y) || !grid_walkable(grid, x, ny))) continue;
+        int v = ny * grid->width + nx;
+        if (grid_is_closed(grid, v)) continue;
+        grid_relax(grid, v, grid->g[u] + move_cost[i] * grid->cost[v], u, goal);
+    }
+}
+
+// 在一条线 (行或列) 上从 pos 朝 dir 方向按 64 位字扫描, 返回第一个停止位置:
+// 本线上的障碍, 或两侧线上 "上一格是障碍、这一格可通行" 的位置 (被迫邻居)
+// side0/side1 为 NULL 表示该侧在网格外; 越过末端返回 length, 越过开头返回 -1
+static int jps_scan(const uint64_t *line, const uint64_t *side0, const uint64_t *side1,
+                    size_t words, int length, int pos, int dir) {
+    size_t w = (size_t)pos / 64;
+    int bit = pos & 63;
+    if (dir > 0) {
+        uint64_t first = ~0ULL << bit;
+        for (; w < words; w++) {
+            uint64_t stop = ~line[w];
+            if (side0) stop |= side0[w] & ~(side0[w] << 1 | (w > 0 ? side0[w - 1] >> 63 : 0));
+            if (side1) stop |= side1[w] & ~(side1[w] << 1 | (w > 0 ? side1[w - 1] >> 63 : 0));
+            stop &= first;
+            if (stop) {
+                int found = (int)(w * 64) + __builtin_ctzll(stop);
+                return found < length ? found : length;
+            }
+            first = ~0ULL;
+        }
+        return length;
+    }
+
+    uint64_t first = bit == 63 ? ~0ULL : (1ULL << (bit + 1)) - 1;
+    for (;; w--) {
+        uint64_t stop = ~line[w];
+        if (side0) stop |= side0[w] & ~(side0[w] >> 1 | (w + 1 < words ? side0[w + 1] << 63 : 0));
+        if (side1) stop |= side1[w] & ~(side1[w] >> 1 | (w + 1 < words ? side1[w + 1] << 63 : 0));
+        stop &= first;
+        if (stop) return (int)(w * 64) + 63 - __builtin_clzll(stop);
+        if (w == 0) return -1;
+        first = ~0ULL;
+    }
+}
+
+// 从 (x, y) 沿 (ddx, ddy) 跳跃, 返回遇到的跳点编号, 撞墙返回 -1
+// 不切角的规则: 直线移动时侧面的格子从被挡变为可通行即为跳点;
+// 对角移动时, 两个直线分量方向上存在跳点即为跳点
+static int jps_jump(const astar_grid_t *grid, int x, int y, int ddx, int ddy, point_t goal) {
+    if (!grid_walkable(grid, x, y)) return -1;
+    if (ddy == 0) {
+        const uint64_t *rows = grid->row_bits;
+        size_t words = grid->row_words;
+        int stop = jps_scan(rows + (size_t)y * words,
+                            y > 0 ? rows + (size_t)(y - 1) * words : NULL,
+                            y + 1 < grid->height ? rows + (size_t)(y + 1) * words : NULL,
+                            words, grid->width, x, ddx);
+        if (goal.y == y && (goal.x - x) * ddx >= 0 && (stop - goal.x) * ddx >= 0) return y * grid->width + goal.x;
+        return grid_walkable(grid, stop, y) ? y * grid->width + stop : -1;
+    }
+    if (ddx == 0) {
+        const uint64_t *cols = grid->col_bits;
+        size_t words = grid->col_words;
+        int stop = jps_scan(cols + (size_t)x * words,
+                            x > 0 ? cols + (size_t)(x - 1) * words : NULL,
+                            x + 1 < grid->width ? cols + (size_t)(x + 1) * words : NULL,
+                            words, grid->height, y, ddy);
+        if (goal.x == x && (goal.y - y) * ddy >= 0 && (stop - goal.y) * ddy >= 0) return goal.y * grid->width + x;
+        return grid_walkable(grid, x, stop) ? stop * grid->width + x : -1;
+    }
+
+    for (;;) {
+        if (x == goal.x && y == goal.y) return y * grid->width + x;
+        if (jps_jump(grid, x + ddx, y, ddx, 0, goal) >= 0 || jps_jump(grid, x, y + ddy, 0, ddy, goal) >= 0) {
+            return y * grid->width + x;
+        }
+        if (!grid_walkable(grid, x + ddx, y) || !grid_walkable(grid, x, y + ddy)) return -1;
+        x += ddx;
+        y += ddy;
+        if (!grid_walkable(grid, x, y)) return -1;
+    }
+}
+
+// JPS 扩展: 按到达方向剪枝邻居, 再沿每个方向跳到下一个跳点
+static void jps_expand(astar_grid_t *grid, int u, point_t goal) {
+    int x = u % grid->width;
+    int y = u / grid->width;
+    int dirs[8][2];
+    int count = 0;
+
+    if (grid->parent[u] < 0) {
+        for (int i = 0; i < 8; i++) {
+            if (!grid_walkable(grid, x + dx[i], y + dy[i])) continue;
+            if ((i & 1) && (!grid_walkable(grid, x + dx[i], y) || !grid_walkable(grid, x, y + dy[i]))) continue;
+            dirs[count][0] = dx[i];
+            dirs[count][1] = dy[i];
+            count++;
+        }
+    } else {
+        int px = grid->parent[u] % grid->width;
+        int py = grid->parent[u] / grid->width;
+        int ddx = (x > px) - (x < px);
+        int ddy = (y > py) - (y < py);
+#define JPS_DIR(a, b) do { dirs[count][0] = (a); dirs[count][1] = (b); count++; } while (0)
+        if (ddx != 0 && ddy != 0) {
+            bool vertical = grid_walkable(grid, x, y + ddy);
+            bool horizontal = grid_walkable(grid, x + ddx, y);
+            if (vertical) JPS_DIR(0, ddy);
+            if (horizontal) JPS_DIR(ddx, 0);
+            if (vertical && horizontal) JPS_DIR(ddx, ddy);
+        } else if (ddx != 0) {
+            bool next = grid_walkable(grid, x + ddx, y);
+            bool up = grid_walkable(grid, x, y - 1);
+            bool down = grid_walkable(grid, x, y + 1);
+            if (next) {
+                JPS_DIR(ddx, 0);
+                if (up) JPS_DIR(ddx, -1);
+                if (down) JPS_DIR(ddx, 1);
+            }
+            if (up) JPS_DIR(0, -1);
+            if (down) JPS_DIR(0, 1);
+        } else {
+            bool next = grid_walkable(grid, x, y + ddy);
+            bool left = grid_walkable(grid, x - 1, y);
+            bool right = grid_walkable(grid, x + 1, y);
+            if (next) {
+                JPS_DIR(0, ddy);
+                if (left) JPS_DIR(-1, ddy);
+                if (right) JPS_DIR(1, ddy);
+            }
+            if (left) JPS_DIR(-1, 0);
+            if (right) JPS_DIR(1, 0);
+        }
+#undef JPS_DIR
+    }
+
+    for (int i = 0; i < count; i++) {
+        int v = jps_jump(grid, x + dirs[i][0], y + dirs[i][1], dirs[i][0], dirs[i][1], goal);
+        if (v < 0 || grid_is_closed(grid, v)) continue;
+        int d = grid_distance(grid, x, y, v % grid->width, v / grid->width);
+        grid_relax(grid, v, grid->g[u] + d, u, goal);
+    }
+}
+
+// 沿父链重建逐格路径, 相邻跳点之间为直线或对角线, 逐格补齐
+static bool grid_build_path(const astar_grid_t *grid, int goal, astar_result_t *result) {
+    size_t len = 1;
+    for (int v = goal; grid->parent[v] >= 0; v = grid->parent[v]) {
+        int p = grid->parent[v];
+        int ddx = abs(v % grid->width - p % grid->width);
+        int ddy = abs(v / grid->width - p / grid->width);
+        len += (size_t)(ddx > ddy ? ddx : ddy);
+    }
+    if (len > result->path_capacity) {
+        point_t *path = realloc(result->path, len * sizeof(point_t));
+        if (!path) return false;
+        result->path = path;
+        result->path_capacity = len;
+    }
+
+    size_t i = len;
+    int v = goal;
+    int x = v % grid->width;
+    int y = v / grid->width;
+    result->path[--i] = (point_t){ x, y };
+    while (grid->parent[v] >= 0) {
+        v = grid->parent[v];
+        int px = v % grid->width;
+        int py = v / grid->width;
+        int sx = (px > x) - (px < x);
+        int sy = (py > y) - (py < y);
+        while (x != px || y != py) {
+            x += sx;
+            y += sy;
+            result->path[--i] = (point_t){ x, y };
+        }
+    }
+    result->path_len = len;
+    return true;
+}
+
+bool astar_grid_search(astar_grid_t *grid, point_t start, point_t goal,
+                       astar_grid_mode_t mode, astar_result_t *result) {
+    if (!grid || !result) return false;
+    result->found = false;
+    result->path_len = 0;
+    result->nodes_expanded = 0;
+    result->cost = 0;
+    if (!grid_walkable(grid, start.x, start.y) || !grid_walkable(grid, goal.x, goal.y)) return false;
+
+    // 查询编号回绕时才需要清空时间戳
+    if (++grid->query == 0) {
+        memset(grid->stamp, 0, grid->cells * sizeof(uint32_t));
+        grid->query = 1;
+    }
+    memset(grid->closed, 0, grid->closed_words * sizeof(uint64_t));
+    grid->heap_size = 0;
+
+    bool jps = mode == ASTAR_GRID_JPS && grid->moves == ASTAR_GRID_8 && grid->weighted == 0;
+    int target = goal.y * grid->width + goal.x;
+    grid_relax(grid, start.y * grid->width + start.x, 0, -1, goal);
+
+    while (grid->heap_size > 0) {
+        int u = grid_heap_pop(grid);
+        grid->closed[(size_t)u >> 6] |= 1ULL << (u & 63);
+        result->nodes_expanded++;
+        if (u == target) {
+            result->cost = grid->g[u];
+            result->found = grid_build_path(grid, u, result);
+            return result->found;
+        }
+        if (jps) {
+            jps_expand(grid, u, goal);
+        } else {
+            grid_expand(grid, u, goal);
+        }
+    }
+    return false;
+}
+
 // 路径操作
 void astar_result_reverse(astar_result_t *result) {
     if (!result || !result->path || result->path_len <= 1) return;
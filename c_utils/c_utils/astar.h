@@ -22,6 +22,8 @@ typedef struct {
     size_t path_len;    // 路径长度
     bool found;         // 是否找到路径
     int nodes_expanded; // 扩展的节点数
+    int cost;           // 路径总代价 (仅网格搜索填写)
+    size_t path_capacity; // path 缓冲区容量, 网格搜索在容量足够时复用
 } astar_result_t;
 
 // 网格世界回调函数类型
@@ -68,6 +70,35 @@ astar_result_t astar_search_simple(
     int height
 );
 
+// 网格专用 A*
+// 每个格子的 g 值、父节点、堆位置在创建时一次性分配, 关闭集为位图, 查询之间复用不再分配内存
+// 开放集为带位置索引的四叉堆, 松弛时原地 decrease-key
+// 格子代价: 0 为障碍, 1..255 为进入该格的代价倍数 (直线 10, 对角 14 乘以倍数)
+typedef struct astar_grid_s astar_grid_t;
+
+typedef enum {
+    ASTAR_GRID_4,      // 四方向
+    ASTAR_GRID_8,      // 八方向, 对角移动要求相邻的两个直线格都可通行 (不切角)
+} astar_grid_moves_t;
+
+typedef enum {
+    ASTAR_GRID_ASTAR,  // 普通 A*
+    ASTAR_GRID_JPS,    // 跳点搜索: 只把跳点放入开放集, 要求八方向且所有格子代价相同, 否则退化为普通 A*
+} astar_grid_mode_t;
+
+astar_grid_t* astar_grid_create(int width, int height, astar_grid_moves_t moves);
+void          astar_grid_free(astar_grid_t *grid);
+// 设置格子代价, 越界返回 false
+bool          astar_grid_set_cost(astar_grid_t *grid, int x, int y, int cost);
+int           astar_grid_get_cost(const astar_grid_t *grid, int x, int y);
+bool          astar_grid_is_walkable(const astar_grid_t *grid, int x, int y);
+
+// 网格搜索: 结果写入 result, path 为逐格的完整路径 (JPS 的跳点之间会补齐)
+// result 可以在多次查询间复用, 路径缓冲区只在容量不足时扩大; 用完后调用 free(result->path)
+// 返回: 是否找到路径, 参数错误或内存不足也返回 false
+bool astar_grid_search(astar_grid_t *grid, point_t start, point_t goal,
+                       astar_grid_mode_t mode, astar_result_t *result);
+
 // 路径操作
 void astar_result_reverse(astar_result_t *result);
 bool astar_path_contains(const astar_result_t *result, point_t point);
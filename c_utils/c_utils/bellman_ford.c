@@ -1,6 +1,8 @@
 #include "bellman_ford.h"
 #include <limits.h>
 #include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
 
 // 验证输入参数是否有效
 bool bellman_ford_validate_input(int n, int m, bf_edge_t *edges, int start, int *dist) {
@@ -123,3 +125,107 @@ bool bellman_ford_reconstruct_path(int start, int end, const int *pred, int *pat
     *path_len = temp_len;
     return true;
 }
+
+// 高 32 位为距离, 低 32 位为前驱; 距离在高位, 整体比较即按距离比较
+#define BF_PACK(d, p) ((int64_t)(((uint64_t)(uint32_t)(d) << 32) | (uint32_t)(p)))
+#define BF_DIST(s) ((int)((s) >> 32))
+#define BF_PRED(s) ((int)(uint32_t)(s))
+#define BF_LOCAL 256
+
+typedef struct {
+    const graph_csr_t *g;
+    int64_t *state;
+    unsigned char *queued;
+    const int *frontier;
+    int *next;
+    size_t next_size;
+} bf_ctx_t;
+
+static void bf_flush(bf_ctx_t *c, const int *local, size_t count) {
+    size_t at = __atomic_fetch_add(&c->next_size, count, __ATOMIC_RELAXED);
+    memcpy(c->next + at, local, count * sizeof(int));
+}
+
+static void bf_relax(void *arg, size_t begin, size_t end, int worker) {
+    (void)worker;
+    bf_ctx_t *c = arg;
+    int local[BF_LOCAL];
+    size_t count = 0;
+    for (size_t i = begin; i < end; i++) {
+        int u = c->frontier[i];
+        // 读取最新距离, 本轮其他任务的更新可以直接被利用
+        long long du = BF_DIST(__atomic_load_n(&c->state[u], __ATOMIC_RELAXED));
+        const int *to, *weight;
+        size_t degree = graph_csr_neighbors(c->g, u, &to, &weight);
+        for (size_t k = 0; k < degree; k++) {
+            int v = to[k];
+            long long nd = du + weight[k];
+            if (nd >= INT_MAX) continue;
+            if (nd < INT_MIN) nd = INT_MIN;
+            int64_t desired = BF_PACK((int)nd, u);
+            int64_t cur = __atomic_load_n(&c->state[v], __ATOMIC_RELAXED);
+            bool improved = false;
+            while (nd < BF_DIST(cur)) {
+                if (__atomic_compare_exchange_n(&c->state[v], &cur, desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    improved = true;
+                    break;
+                }
+            }
+            if (improved && !__atomic_exchange_n(&c->queued[v], 1, __ATOMIC_RELAXED)) {
+                local[count++] = v;
+                if (count == BF_LOCAL) {
+                    bf_flush(c, local, count);
+                    count = 0;
+                }
+            }
+        }
+    }
+    if (count) bf_flush(c, local, count);
+}
+
+bool bellman_ford_csr(const graph_csr_t *g, int start, int *dist, int *pred, threadpool_t *pool) {
+    if (!g || !dist || start < 0 || (size_t)start >= g->nodes) return false;
+    size_t n = g->nodes;
+
+    int64_t *state = malloc(n * sizeof(int64_t));
+    unsigned char *queued = calloc(n, 1);
+    int *frontier = malloc(n * sizeof(int));
+    int *next = malloc(n * sizeof(int));
+    if (!state || !queued || !frontier || !next) {
+        free(state);
+        free(queued);
+        free(frontier);
+        free(next);
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) state[i] = BF_PACK(INT_MAX, -1);
+    state[start] = BF_PACK(0, -1);
+    frontier[0] = start;
+    size_t frontier_size = 1;
+
+    bf_ctx_t c = { .g = g, .state = state, .queued = queued };
+    for (size_t round = 0; round < n && frontier_size > 0; round++) {
+        c.frontier = frontier;
+        c.next = next;
+        c.next_size = 0;
+        graph_csr_parallel_for(pool, frontier_size, 64, bf_relax, &c);
+
+        frontier_size = c.next_size;
+        for (size_t i = 0; i < frontier_size; i++) queued[next[i]] = 0;
+        int *tmp = frontier;
+        frontier = next;
+        next = tmp;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        dist[i] = BF_DIST(state[i]);
+        if (pred) pred[i] = BF_PRED(state[i]);
+    }
+
+    free(state);
+    free(queued);
+    free(frontier);
+    free(next);
+    return frontier_size > 0;
+}
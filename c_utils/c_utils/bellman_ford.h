@@ -2,6 +2,7 @@
 #define C_UTILS_BELLMAN_FORD_H
 
 #include <stdbool.h>
+#include "graph_csr.h"
 
 // 边的定义
 typedef struct { int u, v, w; } bf_edge_t;
@@ -21,4 +22,12 @@ bool bellman_ford_reconstruct_path(int start, int end, const int *pred, int *pat
 // 验证输入参数是否有效
 bool bellman_ford_validate_input(int n, int m, bf_edge_t *edges, int start, int *dist);
 
+// CSR 图上的并行 Bellman-Ford
+// 每轮只松弛上一轮距离变小的节点的出边, 前沿在线程池上并行处理;
+// 距离和前驱打包在一个 64 位字里用 CAS 一起更新, 保证前驱与距离一致
+// 第 n 轮之后仍有节点更新即判定存在从 start 可达的负环
+// pred 可为 NULL; pool 为 NULL 时在调用线程执行
+// 返回是否存在负环 (参数无效时返回 false)
+bool bellman_ford_csr(const graph_csr_t *g, int start, int *dist, int *pred, threadpool_t *pool);
+
 #endif // C_UTILS_BELLMAN_FORD_H
@@ -4,193 +4,1342 @@
 #include <stdio.h>
 #include <ctype.h>
 
-// 内部辅助函数：创建指定长度的 bigint
-static bigint_t* bigint_create(size_t len) {
+typedef uint64_t limb_t;
+typedef unsigned __int128 dlimb_t;
+
+// 各算法的切换阈值 (limb 数), 在 x86-64 上按 benchmark 调整
+#define KARATSUBA_THRESHOLD 32
+#define TOOM3_THRESHOLD     160
+#define NTT_THRESHOLD       3500
+#define BZ_THRESHOLD        160
+
+// 十进制转换: 10^19 是 64 位内最大的 10 的幂, 分治到 2^STR_BASE_LEVEL 个 19 位块以下时逐块除
+#define DEC_CHUNK_DIGITS 19
+#define DEC_CHUNK_BASE   10000000000000000000ULL
+#define STR_BASE_LEVEL   4
+
+// ---------------------------------------------------------------------------
+// limb 数组运算 (mpn): 小端序, 长度由调用者给出
+// ---------------------------------------------------------------------------
+
+static size_t mpn_norm(const limb_t *a, size_t n) {
+    while (n > 0 && a[n - 1] == 0) n--;
+    return n;
+}
+
+static int mpn_cmp(const limb_t *a, const limb_t *b, size_t n) {
+    while (n-- > 0) {
+        if (a[n] != b[n]) return a[n] > b[n] ? 1 : -1;
+    }
+    return 0;
+}
+
+// 规范化长度的比较
+static int mpn_cmp2(const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+    if (an != bn) return an > bn ? 1 : -1;
+    return mpn_cmp(a, b, an);
+}
+
+static limb_t mpn_add_n(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+    limb_t c = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t s = (dlimb_t)a[i] + b[i] + c;
+        r[i] = (limb_t)s;
+        c = (limb_t)(s >> 64);
+    }
+    return c;
+}
+
+static limb_t mpn_add_1(limb_t *r, const limb_t *a, size_t n, limb_t v) {
+    for (size_t i = 0; i < n; i++) {
+        limb_t s = a[i] + v;
+        v = s < v;
+        r[i] = s;
+    }
+    return v;
+}
+
+// an >= bn, r 可与 a 相同
+static limb_t mpn_add(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+    limb_t c = mpn_add_n(r, a, b, bn);
+    return mpn_add_1(r + bn, a + bn, an - bn, c);
+}
+
+static limb_t mpn_sub_n(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+    limb_t c = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t d = (dlimb_t)a[i] - b[i] - c;
+        r[i] = (limb_t)d;
+        c = (limb_t)(d >> 127);
+    }
+    return c;
+}
+
+static limb_t mpn_sub_1(limb_t *r, const limb_t *a, size_t n, limb_t v) {
+    for (size_t i = 0; i < n; i++) {
+        limb_t t = a[i];
+        r[i] = t - v;
+        v = t < v;
+    }
+    return v;
+}
+
+// an >= bn, 返回借位
+static limb_t mpn_sub(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+    limb_t c = mpn_sub_n(r, a, b, bn);
+    return mpn_sub_1(r + bn, a + bn, an - bn, c);
+}
+
+// r = |a - b| (an >= bn, r 有 an 个 limb), a < b 时返回 true
+static bool mpn_absdiff(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+    if (mpn_norm(a + bn, an - bn) == 0 && mpn_cmp(a, b, bn) < 0) {
+        mpn_sub_n(r, b, a, bn);
+        memset(r + bn, 0, (an - bn) * sizeof(limb_t));
+        return true;
+    }
+    mpn_sub(r, a, an, b, bn);
+    return false;
+}
+
+static limb_t mpn_mul_1(limb_t *r, const limb_t *a, size_t n, limb_t v) {
+    limb_t c = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t p = (dlimb_t)a[i] * v + c;
+        r[i] = (limb_t)p;
+        c = (limb_t)(p >> 64);
+    }
+    return c;
+}
+
+static limb_t mpn_addmul_1(limb_t *r, const limb_t *a, size_t n, limb_t v) {
+    limb_t c = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t p = (dlimb_t)a[i] * v + r[i] + c;
+        r[i] = (limb_t)p;
+        c = (limb_t)(p >> 64);
+    }
+    return c;
+}
+
+static limb_t mpn_submul_1(limb_t *r, const limb_t *a, size_t n, limb_t v) {
+    limb_t c = 0;
+    for (size_t i = 0; i < n; i++) {
+        dlimb_t p = (dlimb_t)a[i] * v + c;
+        limb_t lo = (limb_t)p, t = r[i];
+        c = (limb_t)(p >> 64) + (t < lo);
+        r[i] = t - lo;
+    }
+    return c;
+}
+
+// 0 < cnt < 64, 从高位向低位处理, r 可与 a 相同
+static limb_t mpn_lshift(limb_t *r, const limb_t *a, size_t n, unsigned cnt) {
+    limb_t out = a[n - 1] >> (64 - cnt);
+    for (size_t i = n - 1; i > 0; i--) r[i] = (a[i] << cnt) | (a[i - 1] >> (64 - cnt));
+    r[0] = a[0] << cnt;
+    return out;
+}
+
+static void mpn_rshift(limb_t *r, const limb_t *a, size_t n, unsigned cnt) {
+    for (size_t i = 0; i + 1 < n; i++) r[i] = (a[i] >> cnt) | (a[i + 1] << (64 - cnt));
+    r[n - 1] = a[n - 1] >> cnt;
+}
+
+// 128/64 位除法, 要求 hi < d
+static inline limb_t udiv128(limb_t hi, limb_t lo, limb_t d, limb_t *rem) {
+#if defined(__x86_64__) && defined(__GNUC__)
+    limb_t q, r;
+    __asm__("divq %4" : "=a"(q), "=d"(r) : "a"(lo), "d"(hi), "rm"(d));
+    *rem = r;
+    return q;
+#else
+    dlimb_t num = ((dlimb_t)hi << 64) | lo;
+    limb_t q = (limb_t)(num / d);
+    *rem = (limb_t)(num - (dlimb_t)q * d);
+    return q;
+#endif
+}
+
+// q = a / d, 返回余数; q 可与 a 相同
+static limb_t mpn_divrem_1(limb_t *q, const limb_t *a, size_t n, limb_t d) {
+    limb_t r = 0;
+    for (size_t i = n; i-- > 0;) q[i] = udiv128(r, a[i], d, &r);
+    return r;
+}
+
+// 精确除以 3: 乘以 3 在模 2^64 下的逆元, 逐 limb 传递借位
+static void mpn_divexact_3(limb_t *r, const limb_t *a, size_t n) {
+    const limb_t inv3 = 0xAAAAAAAAAAAAAAABULL;
+    limb_t c = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t s = a[i];
+        limb_t x = s - c;
+        c = x > s;
+        limb_t q = x * inv3;
+        r[i] = q;
+        c += (limb_t)(((dlimb_t)q * 3) >> 64);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// 乘法
+// ---------------------------------------------------------------------------
+
+static bool mpn_mul(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn);
+
+// r[0 .. an+bn) = a * b
+static void mpn_mul_basecase(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+    r[an] = mpn_mul_1(r, a, an, b[0]);
+    for (size_t j = 1; j < bn; j++) r[an + j] = mpn_addmul_1(r + j, a, an, b[j]);
+}
+
+// 递归所需临时空间的上界
+static size_t karatsuba_scratch(size_t n) {
+    return 4 * n + 8 * 64;
+}
+
+// 减法形式的 Karatsuba: 中间项 a0*b1 + a1*b0 = z0 + z2 - (a1 - a0)(b1 - b0)
+// r 有 2n 个 limb, 不能与 a、b 重叠
+static void mpn_karatsuba(limb_t *r, const limb_t *a, const limb_t *b, size_t n, limb_t *tmp) {
+    if (n < KARATSUBA_THRESHOLD) {
+        mpn_mul_basecase(r, a, n, b, n);
+        return;
+    }
+    size_t lo = n / 2, hi = n - lo;
+    limb_t *t = tmp, *da = tmp + 2 * hi, *db = tmp + 3 * hi, *m = tmp + 2 * hi;
+    limb_t *next = tmp + 4 * hi + 1;
+
+    bool sa = mpn_absdiff(da, a + lo, hi, a, lo);
+    bool sb = mpn_absdiff(db, b + lo, hi, b, lo);
+    mpn_karatsuba(t, da, db, hi, next);
+    mpn_karatsuba(r, a, b, lo, next);
+    mpn_karatsuba(r + 2 * lo, a + lo, b + lo, hi, next);
+
+    // m = z0 + z2 -/+ |t|, 共 2hi+1 个 limb (da/db 已不再使用)
+    m[2 * hi] = mpn_add(m, r + 2 * lo, 2 * hi, r, 2 * lo);
+    if (sa == sb) mpn_sub(m, m, 2 * hi + 1, t, 2 * hi);
+    else mpn_add(m, m, 2 * hi + 1, t, 2 * hi);
+    mpn_add(r + lo, r + lo, 2 * n - lo, m, 2 * hi + 1);
+}
+
+// limb 数组的只读视图, 用于 Toom-3 中复用带符号的 bigint 运算
+static bigint_t mpn_view(const limb_t *p, size_t n) {
+    bigint_t v = { (limb_t *)p, mpn_norm(p, n), n, false };
+    return v;
+}
+
+static bigint_t* bigint_alloc(size_t cap);
+static bigint_t* bigint_add_signed(const bigint_t *a, const bigint_t *b, bool negate_b);
+static void bigint_normalize(bigint_t *b);
+
+// 原地精确除以 3 或 2 (按绝对值)
+static void bigint_divexact_3(bigint_t *b) {
+    mpn_divexact_3(b->limbs, b->limbs, b->len);
+    bigint_normalize(b);
+}
+
+static void bigint_half(bigint_t *b) {
+    if (b->len == 0) return;
+    mpn_rshift(b->limbs, b->limbs, b->len, 1);
+    bigint_normalize(b);
+}
+
+static bigint_t* bigint_add3(const bigint_t *a, const bigint_t *b, const bigint_t *c) {
+    bigint_t *t = bigint_add(a, b);
+    bigint_t *r = t ? bigint_add(t, c) : NULL;
+    bigint_free(t);
+    return r;
+}
+
+// Toom-3: 在 0, 1, -1, -2, ∞ 处求值, 5 次子乘法, 按 Bodrato 的顺序插值
+// a、b 各 n 个 limb, r 有 2n 个 limb
+static bool mpn_toom3(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+    size_t k = (n + 2) / 3;
+    bigint_t a0 = mpn_view(a, k), a1 = mpn_view(a + k, k), a2 = mpn_view(a + 2 * k, n - 2 * k);
+    bigint_t b0 = mpn_view(b, k), b1 = mpn_view(b + k, k), b2 = mpn_view(b + 2 * k, n - 2 * k);
+    bigint_t *v[16] = {0};
+    bool ok = false;
+
+    // 求值: p(1) = a0+a1+a2, p(-1) = a0-a1+a2, p(-2) = 2(p(-1)+a2) - a0
+    bigint_t *ta = v[0] = bigint_add(&a0, &a2);
+    bigint_t *tb = v[1] = bigint_add(&b0, &b2);
+    if (!ta || !tb) goto done;
+    bigint_t *pa1 = v[2] = bigint_add(ta, &a1), *pam1 = v[3] = bigint_sub_signed(ta, &a1);
+    bigint_t *pb1 = v[4] = bigint_add(tb, &b1), *pbm1 = v[5] = bigint_sub_signed(tb, &b1);
+    if (!pa1 || !pam1 || !pb1 || !pbm1) goto done;
+    bigint_t *ua = v[6] = bigint_add(pam1, &a2), *ub = v[7] = bigint_add(pbm1, &b2);
+    if (!ua || !ub) goto done;
+    bigint_t *pam2 = v[8] = bigint_add_signed(ua, ua, false);
+    bigint_t *pbm2 = v[9] = bigint_add_signed(ub, ub, false);
+    if (!pam2 || !pbm2) goto done;
+    bigint_t *qa = bigint_sub_signed(pam2, &a0), *qb = bigint_sub_signed(pbm2, &b0);
+    bigint_free(pam2);
+    bigint_free(pbm2);
+    v[8] = pam2 = qa;
+    v[9] = pbm2 = qb;
+    if (!pam2 || !pbm2) goto done;
+
+    bigint_t *r0 = v[10] = bigint_mul(&a0, &b0);
+    bigint_t *r1 = v[11] = bigint_mul(pa1, pb1);
+    bigint_t *rm1 = v[12] = bigint_mul(pam1, pbm1);
+    bigint_t *rm2 = v[13] = bigint_mul(pam2, pbm2);
+    bigint_t *rinf = v[14] = bigint_mul(&a2, &b2);
+    if (!r0 || !r1 || !rm1 || !rm2 || !rinf) goto done;
+
+    // 插值
+    bigint_t *s3 = bigint_sub_signed(rm2, r1);
+    bigint_t *s1 = bigint_sub_signed(r1, rm1);
+    bigint_t *s2 = bigint_sub_signed(rm1, r0);
+    v[0] = NULL;
+    bigint_free(ta);
+    bigint_free(tb);
+    v[1] = NULL;
+    v[2] = s3;
+    bigint_free(pa1);
+    v[3] = s1;
+    bigint_free(pam1);
+    v[4] = s2;
+    bigint_free(pb1);
+    bigint_free(pbm1);
+    v[5] = NULL;
+    if (!s3 || !s1 || !s2) goto done;
+    bigint_divexact_3(s3);
+    bigint_half(s1);
+    // s3 = (s2 - s3) / 2 + 2 * rinf
+    bigint_t *u = bigint_sub_signed(s2, s3);
+    if (!u) goto done;
+    bigint_half(u);
+    bigint_t *w = bigint_add3(u, rinf, rinf);
+    bigint_free(u);
+    bigint_free(s3);
+    v[2] = s3 = w;
+    if (!s3) goto done;
+    // s2 = s2 + s1 - rinf, s1 = s1 - s3
+    w = bigint_add(s2, s1);
+    u = w ? bigint_sub_signed(w, rinf) : NULL;
+    bigint_free(w);
+    bigint_free(s2);
+    v[4] = s2 = u;
+    if (!s2) goto done;
+    u = bigint_sub_signed(s1, s3);
+    bigint_free(s1);
+    v[3] = s1 = u;
+    if (!s1) goto done;
+
+    // 重组: 各系数非负, 依次加到 k 个 limb 的偏移上
+    memset(r, 0, 2 * n * sizeof(limb_t));
+    const bigint_t *coef[5] = { r0, s1, s2, s3, rinf };
+    for (size_t i = 0; i < 5; i++) {
+        size_t off = i * k;
+        if (coef[i]->len == 0) continue;
+        mpn_add(r + off, r + off, 2 * n - off, coef[i]->limbs, coef[i]->len);
+    }
+    ok = true;
+done:
+    for (size_t i = 0; i < 16; i++) bigint_free(v[i]);
+    return ok;
+}
+
+// 三素数 NTT: 把 limb 拆成 32 位系数, 分别在三个 NTT 友好素数下做循环卷积, 再用 Garner 算法合并
+// 系数上界 min(la, lb) * (2^32-1)^2 < 2^86 小于三素数之积, 卷积长度最多 2^23
+#define NTT_MAX_LOG2 23
+
+typedef struct {
+    uint32_t p;
+    uint32_t g;
+} ntt_prime_t;
+
+static const ntt_prime_t ntt_primes[3] = {
+    { 998244353u, 3 }, { 167772161u, 3 }, { 469762049u, 3 }
+};
+
+static uint32_t pow_mod32(uint32_t b, uint64_t e, uint32_t p) {
+    uint64_t r = 1, x = b % p;
+    while (e) {
+        if (e & 1) r = r * x % p;
+        x = x * x % p;
+        e >>= 1;
+    }
+    return (uint32_t)r;
+}
+
+// 32 位 Montgomery 乘法, R = 2^32: 返回 a*b/R mod p
+static inline uint32_t mont32_mul(uint32_t a, uint32_t b, uint32_t p, uint32_t pinv) {
+    uint64_t x = (uint64_t)a * b;
+    uint32_t m = (uint32_t)x * pinv;
+    uint32_t t = (uint32_t)((x + (uint64_t)m * p) >> 32);
+    return t >= p ? t - p : t;
+}
+
+static inline uint32_t mod_add32(uint32_t a, uint32_t b, uint32_t p) {
+    uint32_t s = a + b;
+    return s >= p ? s - p : s;
+}
+
+static inline uint32_t mod_sub32(uint32_t a, uint32_t b, uint32_t p) {
+    return a >= b ? a - b : a + p - b;
+}
+
+// 单位根表: roots[h + j] = w_{2h}^j 的 Montgomery 形式, h 为 2 的幂
+static void ntt_roots(uint32_t *roots, size_t n, uint32_t p, uint32_t pinv, uint32_t g, bool inverse) {
+    uint32_t one = (uint32_t)(((uint64_t)1 << 32) % p);
+    for (size_t h = 1; h < n; h <<= 1) {
+        uint32_t w = pow_mod32(g, (p - 1) / (2 * h), p);
+        if (inverse) w = pow_mod32(w, p - 2, p);
+        uint32_t wm = (uint32_t)(((uint64_t)w << 32) % p);
+        roots[h] = one;
+        for (size_t j = 1; j < h; j++) roots[h + j] = mont32_mul(roots[h + j - 1], wm, p, pinv);
+    }
+}
+
+// 频域抽取, 自然序输入, 位反转序输出
+static void ntt_forward(uint32_t *x, size_t n, const uint32_t *roots, uint32_t p, uint32_t pinv) {
+    for (size_t h = n / 2; h >= 1; h >>= 1) {
+        const uint32_t *w = roots + h;
+        for (size_t s = 0; s < n; s += 2 * h) {
+            uint32_t *lo = x + s, *hi = x + s + h;
+            for (size_t j = 0; j < h; j++) {
+                uint32_t u = lo[j], t = hi[j];
+                lo[j] = mod_add32(u, t, p);
+                hi[j] = mont32_mul(mod_sub32(u, t, p), w[j], p, pinv);
+            }
+        }
+    }
+}
+
+// 时域抽取, 位反转序输入, 自然序输出
+static void ntt_inverse(uint32_t *x, size_t n, const uint32_t *roots, uint32_t p, uint32_t pinv) {
+    for (size_t h = 1; h < n; h <<= 1) {
+        const uint32_t *w = roots + h;
+        for (size_t s = 0; s < n; s += 2 * h) {
+            uint32_t *lo = x + s, *hi = x + s + h;
+            for (size_t j = 0; j < h; j++) {
+                uint32_t u = lo[j], t = mont32_mul(hi[j], w[j], p, pinv);
+                lo[j] = mod_add32(u, t, p);
+                hi[j] = mod_sub32(u, t, p);
+            }
+        }
+    }
+}
+
+static void ntt_load(uint32_t *x, size_t n, const limb_t *a, size_t an, uint32_t p) {
+    for (size_t i = 0; i < an; i++) {
+        x[2 * i] = (uint32_t)a[i] % p;
+        x[2 * i + 1] = (uint32_t)(a[i] >> 32) % p;
+    }
+    memset(x + 2 * an, 0, (n - 2 * an) * sizeof(uint32_t));
+}
+
+static bool ntt_fits(size_t an, size_t bn) {
+    return 2 * (an + bn) - 1 <= ((size_t)1 << NTT_MAX_LOG2);
+}
+
+static bool mpn_mul_ntt(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+    size_t conv = 2 * (an + bn) - 1;
+    size_t n = 1;
+    while (n < conv) n <<= 1;
+
+    uint32_t *fa = malloc(n * sizeof(uint32_t));
+    uint32_t *fb = malloc(n * sizeof(uint32_t));
+    uint32_t *roots = malloc(n * sizeof(uint32_t));
+    uint32_t *res = malloc(3 * conv * sizeof(uint32_t));
+    bool ok = fa && fb && roots && res;
+
+    for (int k = 0; ok && k < 3; k++) {
+        uint32_t p = ntt_primes[k].p, g = ntt_primes[k].g;
+        // pinv = -p^{-1} mod 2^32 (牛顿迭代)
+        uint32_t inv = p;
+        for (int i = 0; i < 4; i++) inv *= 2 - p * inv;
+        uint32_t pinv = (uint32_t)0 - inv;
+
+        ntt_load(fa, n, a, an, p);
+        ntt_load(fb, n, b, bn, p);
+        ntt_roots(roots, n, p, pinv, g, false);
+        ntt_forward(fa, n, roots, p, pinv);
+        if (a == b && an == bn) {
+            memcpy(fb, fa, n * sizeof(uint32_t));
+        } else {
+            ntt_forward(fb, n, roots, p, pinv);
+        }
+        for (size_t i = 0; i < n; i++) fa[i] = mont32_mul(fa[i], fb[i], p, pinv);
+        ntt_roots(roots, n, p, pinv, g, true);
+        ntt_inverse(fa, n, roots, p, pinv);
+        // 逐点乘积带一个 R^-1, 逆变换带因子 n: 乘以 n^-1 * R^2 的 Montgomery 形式抵消
+        uint64_t scale = pow_mod32((uint32_t)(n % p), p - 2, p);
+        scale = (scale << 32) % p;
+        scale = (scale << 32) % p;
+        uint32_t *out = res + (size_t)k * conv;
+        for (size_t i = 0; i < conv; i++) out[i] = mont32_mul(fa[i], (uint32_t)scale, p, pinv);
+    }
+
+    if (ok) {
+        // Garner: x = x1 + x2*p1 + x3*p1*p2
+        const uint64_t p1 = ntt_primes[0].p, p2 = ntt_primes[1].p, p3 = ntt_primes[2].p;
+        const uint64_t inv12 = pow_mod32((uint32_t)(p1 % p2), p2 - 2, (uint32_t)p2);
+        const uint64_t inv123 = pow_mod32((uint32_t)(p1 * p2 % p3), p3 - 2, (uint32_t)p3);
+        const uint64_t p12 = p1 * p2;
+        dlimb_t carry = 0;
+        size_t rn = an + bn;
+        for (size_t i = 0; i < rn; i++) {
+            limb_t word[2];
+            for (int half = 0; half < 2; half++) {
+                size_t idx = 2 * i + half;
+                if (idx < conv) {
+                    uint64_t x1 = res[idx], r2 = res[conv + idx], r3 = res[2 * conv + idx];
+                    uint64_t x2 = (r2 + p2 - x1 % p2) % p2 * inv12 % p2;
+                    uint64_t y = (x1 + x2 % p3 * (p1 % p3)) % p3;
+                    uint64_t x3 = (r3 + p3 - y) % p3 * inv123 % p3;
+                    carry += (dlimb_t)x1 + (dlimb_t)x2 * p1 + (dlimb_t)x3 * p12;
+                }
+                word[half] = (limb_t)(uint32_t)carry;
+                carry >>= 32;
+            }
+            r[i] = word[0] | (word[1] << 32);
+        }
+    }
+    free(fa);
+    free(fb);
+    free(roots);
+    free(res);
+    return ok;
+}
+
+// 等长乘法的分派
+static bool mpn_mul_balanced(limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+    if (n >= NTT_THRESHOLD && ntt_fits(n, n)) return mpn_mul_ntt(r, a, n, b, n);
+    if (n >= TOOM3_THRESHOLD) return mpn_toom3(r, a, b, n);
+    // 模幂等场景反复做中等规模乘法, 临时空间小时放在栈上
+    limb_t stack_tmp[2048];
+    if (karatsuba_scratch(n) <= sizeof(stack_tmp) / sizeof(stack_tmp[0])) {
+        mpn_karatsuba(r, a, b, n, stack_tmp);
+        return true;
+    }
+    limb_t *tmp = malloc(karatsuba_scratch(n) * sizeof(limb_t));
+    if (!tmp) return false;
+    mpn_karatsuba(r, a, b, n, tmp);
+    free(tmp);
+    return true;
+}
+
+// r[0 .. an+bn) = a * b, r 不能与 a、b 重叠
+// 不等长时把长的一方切成与短的一方等长的块, 每块按等长算法相乘后累加
+static bool mpn_mul(limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+    if (an < bn) {
+        const limb_t *t = a;
+        a = b;
+        b = t;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn == 0) {
+        memset(r, 0, an * sizeof(limb_t));
+        return true;
+    }
+    if (bn < KARATSUBA_THRESHOLD) {
+        mpn_mul_basecase(r, a, an, b, bn);
+        return true;
+    }
+    if (an == bn) return mpn_mul_balanced(r, a, b, an);
+    if (bn >= NTT_THRESHOLD && ntt_fits(an, bn)) return mpn_mul_ntt(r, a, an, b, bn);
+
+    limb_t *t = malloc(2 * bn * sizeof(limb_t));
+    if (!t) return false;
+    if (!mpn_mul_balanced(r, a, b, bn)) {
+        free(t);
+        return false;
+    }
+    memset(r + 2 * bn, 0, (an - bn) * sizeof(limb_t));
+    bool ok = true;
+    for (size_t off = bn; ok && off < an; off += bn) {
+        size_t len = an - off < bn ? an - off : bn;
+        ok = len == bn ? mpn_mul_balanced(t, a + off, b, bn) : mpn_mul(t, b, bn, a + off, len);
+        if (ok) mpn_add(r + off, r + off, an + bn - off, t, len + bn);
+    }
+    free(t);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// 除法
+// ---------------------------------------------------------------------------
+
+// Knuth 算法 D: u 有 un+1 个 limb (u[un] 为额外的高位), v 有 vn >= 2 个 limb 且最高位为 1
+// q 得到 un-vn+1 个 limb, u 的低 vn 个 limb 得到余数
+static void mpn_div_knuth(limb_t *q, limb_t *u, size_t un, const limb_t *v, size_t vn) {
+    limb_t v1 = v[vn - 1], v2 = v[vn - 2];
+    for (size_t j = un - vn + 1; j-- > 0;) {
+        limb_t u2 = u[j + vn], u1 = u[j + vn - 1], u0 = u[j + vn - 2];
+        limb_t qhat, rhat;
+        bool rhat_overflow = false;
+        if (u2 >= v1) {
+            qhat = ~(limb_t)0;
+            rhat = u1 + v1;
+            rhat_overflow = rhat < u1;
+        } else {
+            qhat = udiv128(u2, u1, v1, &rhat);
+        }
+        while (!rhat_overflow && (dlimb_t)qhat * v2 > (((dlimb_t)rhat << 64) | u0)) {
+            qhat--;
+            limb_t old = rhat;
+            rhat += v1;
+            rhat_overflow = rhat < old;
+        }
+        limb_t borrow = mpn_submul_1(u + j, v, vn, qhat);
+        limb_t top = u[j + vn];
+        u[j + vn] = top - borrow;
+        if (top < borrow) {
+            qhat--;
+            u[j + vn] += mpn_add_n(u + j, u + j, v, vn);
+        }
+        q[j] = qhat;
+    }
+}
+
+static bool bz_div_3n2n(limb_t *q, limb_t *r, const limb_t *a, const limb_t *b, size_t k);
+
+// Burnikel-Ziegler: a 有 2n 个 limb 且 a < b * B^n, b 有 n 个 limb 且最高位为 1
+// q、r 各得到 n 个 limb
+static bool bz_div_2n1n(limb_t *q, limb_t *r, const limb_t *a, const limb_t *b, size_t n) {
+    if ((n & 1) || n < BZ_THRESHOLD) {
+        limb_t *u = malloc((3 * n + 2) * sizeof(limb_t));
+        if (!u) return false;
+        limb_t *qq = u + 2 * n + 1;
+        memcpy(u, a, 2 * n * sizeof(limb_t));
+        u[2 * n] = 0;
+        mpn_div_knuth(qq, u, 2 * n, b, n);
+        memcpy(q, qq, n * sizeof(limb_t));
+        memcpy(r, u, n * sizeof(limb_t));
+        free(u);
+        return true;
+    }
+    size_t k = n / 2;
+    limb_t *t = malloc(3 * k * sizeof(limb_t));
+    if (!t) return false;
+    // 高 3 个半块除以 b 得到商的高半部分, 余数接上最低半块再除一次
+    bool ok = bz_div_3n2n(q + k, t + k, a + k, b, k);
+    if (ok) {
+        memcpy(t, a, k * sizeof(limb_t));
+        ok = bz_div_3n2n(q, r, t, b, k);
+    }
+    free(t);
+    return ok;
+}
+
+// a 有 3k 个 limb, b 有 2k 个 limb, a < b * B^k; q 得到 k 个 limb, r 得到 2k 个 limb
+static bool bz_div_3n2n(limb_t *q, limb_t *r, const limb_t *a, const limb_t *b, size_t k) {
+    const limb_t *b1 = b + k, *b2 = b;
+    limb_t *buf = malloc((4 * k + 2) * sizeof(limb_t));
+    if (!buf) return false;
+    limb_t *rr = buf;                 // 2k+1: [a3, r1]
+    limb_t *d = buf + 2 * k + 1;      // 2k+1: q * b2
+
+    // 用 b 的高半部分估商
+    if (mpn_cmp(a + 2 * k, b1, k) < 0) {
+        if (!bz_div_2n1n(q, rr + k, a + k, b1, k)) {
+            free(buf);
+            return false;
+        }
+        rr[2 * k] = 0;
+    } else {
+        // 此时 a 的高 k 个 limb 等于 b1, 商取 B^k - 1, r1 = a2 + b1
+        memset(q, 0xFF, k * sizeof(limb_t));
+        rr[2 * k] = mpn_add_n(rr + k, a + k, b1, k);
+    }
+    memcpy(rr, a, k * sizeof(limb_t));
+    if (!mpn_mul(d, q, k, b2, k)) {
+        free(buf);
+        return false;
+    }
+    d[2 * k] = 0;
+
+    // 余数估计按 2k+1 个 limb 的补码计算, 为负时 (最高 limb 非零) 至多补两次 b
+    mpn_sub_n(rr, rr, d, 2 * k + 1);
+    while (rr[2 * k]) {
+        mpn_sub_1(q, q, k, 1);
+        rr[2 * k] += mpn_add_n(rr, rr, b, 2 * k);
+    }
+    memcpy(r, rr, 2 * k * sizeof(limb_t));
+    free(buf);
+    return true;
+}
+
+// |a| = q * |b| + r, 商和余数按绝对值计算; q 有 an-bn+1 个 limb, r 有 bn 个 limb
+// 要求 an >= bn >= 1
+static bool mpn_divrem(limb_t *q, limb_t *r, const limb_t *a, size_t an, const limb_t *b, size_t bn) {
+    if (bn == 1) {
+        r[0] = mpn_divrem_1(q, a, an, b[0]);
+        return true;
+    }
+    unsigned shift = (unsigned)__builtin_clzll(b[bn - 1]);
+
+    if (bn < BZ_THRESHOLD || an - bn < BZ_THRESHOLD) {
+        limb_t *buf = malloc((an + 1 + bn) * sizeof(limb_t));
+        if (!buf) return false;
+        limb_t *u = buf, *v = buf + an + 1;
+        if (shift) {
+            mpn_lshift(v, b, bn, shift);
+            u[an] = mpn_lshift(u, a, an, shift);
+        } else {
+            memcpy(v, b, bn * sizeof(limb_t));
+            memcpy(u, a, an * sizeof(limb_t));
+            u[an] = 0;
+        }
+        mpn_div_knuth(q, u, an, v, bn);
+        if (shift) mpn_rshift(r, u, bn, shift);
+        else memcpy(r, u, bn * sizeof(limb_t));
+        free(buf);
+        return true;
+    }
+
+    // 块大小 n = j * 2^m >= bn 且 j < BZ_THRESHOLD, 除数和被除数同时左移 pad 个 limb 补齐
+    size_t m = 0;
+    while ((bn >> m) >= BZ_THRESHOLD) m++;
+    size_t n = (((bn - 1) >> m) + 1) << m;
+    size_t pad = n - bn;
+    size_t un = an + pad + 1;
+    size_t blocks = un / n + 1;
+    if (blocks < 2) blocks = 2;
+
+    limb_t *buf = calloc(blocks * n + n + 2 * n + n, sizeof(limb_t));
+    if (!buf) return false;
+    limb_t *u = buf, *v = buf + blocks * n, *z = v + n, *rem = z + 2 * n;
+    if (shift) {
+        mpn_lshift(v + pad, b, bn, shift);
+        u[pad + an] = mpn_lshift(u + pad, a, an, shift);
+    } else {
+        memcpy(v + pad, b, bn * sizeof(limb_t));
+        memcpy(u + pad, a, an * sizeof(limb_t));
+    }
+
+    // 从高到低逐块做 2n/n 除法, 商的块依次写入 qq
+    limb_t *qq = malloc((blocks - 1) * n * sizeof(limb_t));
+    if (!qq) {
+        free(buf);
+        return false;
+    }
+    memcpy(z, u + (blocks - 2) * n, 2 * n * sizeof(limb_t));
+    bool ok = true;
+    for (size_t i = blocks - 1; ok && i-- > 0;) {
+        ok = bz_div_2n1n(qq + i * n, rem, z, v, n);
+        if (ok && i > 0) {
+            memcpy(z, u + (i - 1) * n, n * sizeof(limb_t));
+            memcpy(z + n, rem, n * sizeof(limb_t));
+        }
+    }
+    if (ok) {
+        size_t qn = an - bn + 1;
+        size_t have = (blocks - 1) * n;
+        memcpy(q, qq, (qn < have ? qn : have) * sizeof(limb_t));
+        if (qn > have) memset(q + have, 0, (qn - have) * sizeof(limb_t));
+        // 余数去掉补齐的 pad 个 limb 和 shift 位
+        if (shift) mpn_rshift(rem + pad, rem + pad, bn, shift);
+        memcpy(r, rem + pad, bn * sizeof(limb_t));
+    }
+    free(qq);
+    free(buf);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// bigint_t 封装
+// ---------------------------------------------------------------------------
+
+static bigint_t* bigint_alloc(size_t cap) {
     bigint_t *b = malloc(sizeof(bigint_t));
     if (!b) return NULL;
-    b->len = len;
-    b->digits = calloc(len, sizeof(uint32_t));
-    if (!b->digits) {
+    if (cap == 0) cap = 1;
+    b->limbs = malloc(cap * sizeof(limb_t));
+    if (!b->limbs) {
         free(b);
         return NULL;
     }
+    b->len = 0;
+    b->cap = cap;
+    b->neg = false;
     return b;
 }
 
-// 内部辅助函数：去除前导零
-static void bigint_trim(bigint_t *b) {
-    if (!b || b->len == 0) return;
-    while (b->len > 1 && b->digits[b->len - 1] == 0) {
-        b->len--;
-    }
+// 去掉高位零, 零不带符号
+static void bigint_normalize(bigint_t *b) {
+    b->len = mpn_norm(b->limbs, b->len);
+    if (b->len == 0) b->neg = false;
 }
 
-bigint_t* bigint_from_str(const char *str) {
-    if (!str || *str == '\0') return NULL;
-    
-    // 跳过前导空格
-    while (isspace((unsigned char)*str)) str++;
-    
-    // 检查是否为空（全是空格）
-    if (*str == '\0') return NULL;
-    
-    // 检查负号（暂不支持负数）
-    if (*str == '-') return NULL;
-    
-    // 跳过前导零
-    while (*str == '0' && *(str + 1) != '\0') str++;
-    
-    size_t n = strlen(str);
-    // 检查是否全为数字
-    for (size_t i = 0; i < n; i++) {
-        if (!isdigit((unsigned char)str[i])) return NULL;
-    }
-    
-    bigint_t *b = bigint_create(n);
+static bigint_t* bigint_from_limbs(const limb_t *p, size_t n, bool neg) {
+    n = mpn_norm(p, n);
+    bigint_t *b = bigint_alloc(n);
     if (!b) return NULL;
-    
-    for (size_t i = 0; i < n; i++) {
-        b->digits[i] = str[n - 1 - i] - '0';
-    }
-    
+    memcpy(b->limbs, p, n * sizeof(limb_t));
+    b->len = n;
+    b->neg = n > 0 && neg;
     return b;
 }
 
-void bigint_free(bigint_t *b) {
-    if (!b) return;
-    free(b->digits);
-    free(b);
+bigint_t* bigint_from_u64(uint64_t v) {
+    bigint_t *b = bigint_alloc(1);
+    if (!b) return NULL;
+    b->limbs[0] = v;
+    b->len = v != 0;
+    return b;
 }
 
-char* bigint_to_str(const bigint_t *b) {
-    if (!b || b->len == 0) return NULL;
-    
-    char *str = malloc(b->len + 1);
-    if (!str) return NULL;
-    
-    for (size_t i = 0; i < b->len; i++) {
-        str[i] = b->digits[b->len - 1 - i] + '0';
-    }
-    str[b->len] = '\0';
-    return str;
+bigint_t* bigint_from_i64(int64_t v) {
+    uint64_t mag = v < 0 ? (uint64_t)0 - (uint64_t)v : (uint64_t)v;
+    bigint_t *b = bigint_from_u64(mag);
+    if (b) b->neg = v < 0;
+    return b;
 }
 
-bigint_t* bigint_add(const bigint_t *a, const bigint_t *b) {
-    if (!a || !b) return NULL;
-    
-    size_t max_len = (a->len > b->len ? a->len : b->len) + 1;
-    bigint_t *res = bigint_create(max_len);
-    if (!res) return NULL;
-    
-    uint32_t carry = 0;
-    for (size_t i = 0; i < max_len; i++) {
-        uint32_t val = carry;
-        if (i < a->len) val += a->digits[i];
-        if (i < b->len) val += b->digits[i];
-        res->digits[i] = val % 10;
-        carry = val / 10;
-    }
-    
-    bigint_trim(res);
-    return res;
-}
-
-// 新增：创建零值
 bigint_t* bigint_zero(void) {
-    return bigint_from_str("0");
+    return bigint_alloc(1);
 }
 
-// 新增：创建一值
 bigint_t* bigint_one(void) {
-    return bigint_from_str("1");
+    return bigint_from_u64(1);
+}
+
+void bigint_free(bigint_t *b) {
+    if (!b) return;
+    free(b->limbs);
+    free(b);
 }
 
-// 新增：复制
 bigint_t* bigint_copy(const bigint_t *b) {
     if (!b) return NULL;
-    
-    bigint_t *copy = bigint_create(b->len);
-    if (!copy) return NULL;
-    
-    memcpy(copy->digits, b->digits, b->len * sizeof(uint32_t));
-    return copy;
+    return bigint_from_limbs(b->limbs, b->len, b->neg);
+}
+
+bigint_t* bigint_neg(const bigint_t *a) {
+    bigint_t *r = bigint_copy(a);
+    if (r && r->len) r->neg = !r->neg;
+    return r;
+}
+
+int bigint_sign(const bigint_t *b) {
+    if (!b || b->len == 0) return 0;
+    return b->neg ? -1 : 1;
+}
+
+bool bigint_is_zero(const bigint_t *b) {
+    return !b || b->len == 0;
+}
+
+size_t bigint_bit_length(const bigint_t *b) {
+    if (!b || b->len == 0) return 0;
+    return b->len * 64 - (size_t)__builtin_clzll(b->limbs[b->len - 1]);
 }
 
-// 新增：比较 (-1: a<b, 0: a==b, 1: a>b)
+// -1, 0, 1
 int bigint_compare(const bigint_t *a, const bigint_t *b) {
     if (!a && !b) return 0;
     if (!a) return -1;
     if (!b) return 1;
-    
-    if (a->len != b->len) {
-        return (a->len > b->len) ? 1 : -1;
+    if (a->neg != b->neg) return a->neg ? -1 : 1;
+    int c = mpn_cmp2(a->limbs, a->len, b->limbs, b->len);
+    return a->neg ? -c : c;
+}
+
+// a + b 或 a - b (negate_b), 同号相加, 异号用大的绝对值减小的
+static bigint_t* bigint_add_signed(const bigint_t *a, const bigint_t *b, bool negate_b) {
+    if (!a || !b) return NULL;
+    bool bneg = b->len ? (b->neg != negate_b) : false;
+    const bigint_t *x = a, *y = b;
+    bool xneg = a->neg, yneg = bneg;
+    if (mpn_cmp2(a->limbs, a->len, b->limbs, b->len) < 0) {
+        x = b;
+        y = a;
+        xneg = bneg;
+        yneg = a->neg;
     }
-    
-    for (int i = (int)a->len - 1; i >= 0; i--) {
-        if (a->digits[i] != b->digits[i]) {
-            return (a->digits[i] > b->digits[i]) ? 1 : -1;
-        }
+    bigint_t *r = bigint_alloc(x->len + 1);
+    if (!r) return NULL;
+    if (xneg == yneg) {
+        r->limbs[x->len] = mpn_add(r->limbs, x->limbs, x->len, y->limbs, y->len);
+        r->len = x->len + 1;
+    } else {
+        mpn_sub(r->limbs, x->limbs, x->len, y->limbs, y->len);
+        r->len = x->len;
     }
-    
-    return 0;
+    r->neg = xneg;
+    bigint_normalize(r);
+    return r;
 }
 
-// 新增：是否为零
-bool bigint_is_zero(const bigint_t *b) {
-    if (!b || b->len == 0) return true;
-    return (b->len == 1 && b->digits[0] == 0);
+bigint_t* bigint_add(const bigint_t *a, const bigint_t *b) {
+    return bigint_add_signed(a, b, false);
+}
+
+bigint_t* bigint_sub_signed(const bigint_t *a, const bigint_t *b) {
+    return bigint_add_signed(a, b, true);
 }
 
-// 新增：减法 (假设 a >= b)
 bigint_t* bigint_sub(const bigint_t *a, const bigint_t *b) {
     if (!a || !b) return NULL;
-    if (bigint_compare(a, b) < 0) return NULL; // 暂不支持负数结果
-    
-    bigint_t *res = bigint_create(a->len);
-    if (!res) return NULL;
-    
-    int32_t borrow = 0;
-    for (size_t i = 0; i < a->len; i++) {
-        int32_t val = (int32_t)a->digits[i] - borrow;
-        if (i < b->len) val -= b->digits[i];
-        
-        if (val < 0) {
-            val += 10;
-            borrow = 1;
+    if (bigint_compare(a, b) < 0) return NULL;
+    return bigint_add_signed(a, b, true);
+}
+
+bigint_t* bigint_mul(const bigint_t *a, const bigint_t *b) {
+    if (!a || !b) return NULL;
+    if (a->len == 0 || b->len == 0) return bigint_zero();
+    bigint_t *r = bigint_alloc(a->len + b->len);
+    if (!r) return NULL;
+    if (!mpn_mul(r->limbs, a->limbs, a->len, b->limbs, b->len)) {
+        bigint_free(r);
+        return NULL;
+    }
+    r->len = a->len + b->len;
+    r->neg = a->neg != b->neg;
+    bigint_normalize(r);
+    return r;
+}
+
+bigint_t* bigint_shl(const bigint_t *a, size_t bits) {
+    if (!a) return NULL;
+    if (a->len == 0) return bigint_zero();
+    size_t words = bits / 64;
+    unsigned cnt = (unsigned)(bits % 64);
+    bigint_t *r = bigint_alloc(a->len + words + 1);
+    if (!r) return NULL;
+    memset(r->limbs, 0, words * sizeof(limb_t));
+    if (cnt) {
+        r->limbs[a->len + words] = mpn_lshift(r->limbs + words, a->limbs, a->len, cnt);
+    } else {
+        memcpy(r->limbs + words, a->limbs, a->len * sizeof(limb_t));
+        r->limbs[a->len + words] = 0;
+    }
+    r->len = a->len + words + 1;
+    r->neg = a->neg;
+    bigint_normalize(r);
+    return r;
+}
+
+bigint_t* bigint_shr(const bigint_t *a, size_t bits) {
+    if (!a) return NULL;
+    size_t words = bits / 64;
+    if (words >= a->len) return bigint_zero();
+    unsigned cnt = (unsigned)(bits % 64);
+    size_t n = a->len - words;
+    bigint_t *r = bigint_alloc(n);
+    if (!r) return NULL;
+    if (cnt) mpn_rshift(r->limbs, a->limbs + words, n, cnt);
+    else memcpy(r->limbs, a->limbs + words, n * sizeof(limb_t));
+    r->len = n;
+    r->neg = a->neg;
+    bigint_normalize(r);
+    return r;
+}
+
+bool bigint_divmod(const bigint_t *a, const bigint_t *b, bigint_t **q, bigint_t **r) {
+    if (q) *q = NULL;
+    if (r) *r = NULL;
+    if (!a || !b || b->len == 0) return false;
+
+    bigint_t *qq, *rr;
+    if (mpn_cmp2(a->limbs, a->len, b->limbs, b->len) < 0) {
+        qq = bigint_zero();
+        rr = bigint_copy(a);
+    } else {
+        qq = bigint_alloc(a->len - b->len + 1);
+        rr = bigint_alloc(b->len);
+        if (qq && rr && mpn_divrem(qq->limbs, rr->limbs, a->limbs, a->len, b->limbs, b->len)) {
+            qq->len = a->len - b->len + 1;
+            qq->neg = a->neg != b->neg;
+            rr->len = b->len;
+            rr->neg = a->neg;
+            bigint_normalize(qq);
+            bigint_normalize(rr);
         } else {
-            borrow = 0;
+            bigint_free(qq);
+            bigint_free(rr);
+            qq = rr = NULL;
         }
-        
-        res->digits[i] = (uint32_t)val;
     }
-    
-    bigint_trim(res);
-    return res;
+    if (!qq || !rr) {
+        bigint_free(qq);
+        bigint_free(rr);
+        return false;
+    }
+    if (q) *q = qq;
+    else bigint_free(qq);
+    if (r) *r = rr;
+    else bigint_free(rr);
+    return true;
 }
 
-// 新增：乘法
-bigint_t* bigint_mul(const bigint_t *a, const bigint_t *b) {
-    if (!a || !b) return NULL;
-    
-    // 特殊情况：乘以零
-    if (bigint_is_zero(a) || bigint_is_zero(b)) {
-        return bigint_zero();
-    }
-    
-    size_t res_len = a->len + b->len;
-    bigint_t *res = bigint_create(res_len);
-    if (!res) return NULL;
-    
-    for (size_t i = 0; i < a->len; i++) {
-        uint32_t carry = 0;
-        for (size_t j = 0; j < b->len || carry; j++) {
-            uint64_t val = res->digits[i + j] + (uint64_t)a->digits[i] * 
-                          (j < b->len ? b->digits[j] : 0) + carry;
-            res->digits[i + j] = (uint32_t)(val % 10);
-            carry = (uint32_t)(val / 10);
-        }
-    }
-    
-    bigint_trim(res);
-    return res;
+bigint_t* bigint_div(const bigint_t *a, const bigint_t *b) {
+    bigint_t *q;
+    return bigint_divmod(a, b, &q, NULL) ? q : NULL;
+}
+
+bigint_t* bigint_mod(const bigint_t *a, const bigint_t *b) {
+    bigint_t *r;
+    return bigint_divmod(a, b, NULL, &r) ? r : NULL;
+}
+
+// ---------------------------------------------------------------------------
+// 模幂
+// ---------------------------------------------------------------------------
+
+typedef struct {
+    const limb_t *m;
+    size_t n;
+    limb_t minv;     // -m^-1 mod 2^64
+    limb_t *t;       // 2n+1 个 limb 的乘积缓冲
+} mont_ctx_t;
+
+// r = a * b / R mod m, R = 2^(64n); 先整体相乘 (大模数时走 Karatsuba/Toom), 再逐 limb 做 REDC
+static bool mont_mul(const mont_ctx_t *ctx, limb_t *r, const limb_t *a, const limb_t *b) {
+    size_t n = ctx->n;
+    limb_t *t = ctx->t;
+    if (!mpn_mul(t, a, n, b, n)) return false;
+    t[2 * n] = 0;
+    for (size_t i = 0; i < n; i++) {
+        limb_t u = t[i] * ctx->minv;
+        limb_t c = mpn_addmul_1(t + i, ctx->m, n, u);
+        mpn_add_1(t + i + n, t + i + n, n + 1 - i, c);
+    }
+    if (t[2 * n] || mpn_cmp(t + n, ctx->m, n) >= 0) mpn_sub_n(t + n, t + n, ctx->m, n);
+    memcpy(r, t + n, n * sizeof(limb_t));
+    return true;
+}
+
+// x * R mod m, x < m
+static bool mont_to(const mont_ctx_t *ctx, limb_t *r, const limb_t *x) {
+    size_t n = ctx->n;
+    limb_t *num = calloc(2 * n, sizeof(limb_t));
+    limb_t *q = malloc((n + 1) * sizeof(limb_t));
+    bool ok = num && q;
+    if (ok) {
+        memcpy(num + n, x, n * sizeof(limb_t));
+        size_t nn = mpn_norm(num, 2 * n);
+        if (nn < n) {
+            memset(r, 0, n * sizeof(limb_t));
+        } else {
+            ok = mpn_divrem(q, r, num, nn, ctx->m, n);
+        }
+    }
+    free(num);
+    free(q);
+    return ok;
+}
+
+static unsigned exp_bits(const bigint_t *e, size_t pos, unsigned count) {
+    unsigned v = 0;
+    for (unsigned i = count; i-- > 0;) {
+        size_t bit = pos + i;
+        v = (v << 1) | (unsigned)((e->limbs[bit / 64] >> (bit % 64)) & 1);
+    }
+    return v;
+}
+
+// 奇数模数: Montgomery 域中固定窗口求幂
+static bigint_t* powmod_montgomery(const bigint_t *base, const bigint_t *e, const bigint_t *m) {
+    size_t n = m->len;
+    size_t bits = bigint_bit_length(e);
+    unsigned w = bits >= 512 ? 5 : bits >= 64 ? 4 : 1;
+    size_t tsize = (size_t)1 << w;
+
+    mont_ctx_t ctx = { m->limbs, n, 0, NULL };
+    limb_t inv = m->limbs[0];
+    for (int i = 0; i < 6; i++) inv *= 2 - m->limbs[0] * inv;
+    ctx.minv = (limb_t)0 - inv;
+
+    limb_t *mem = calloc((tsize + 3) * n + 2 * n + 1, sizeof(limb_t));
+    if (!mem) return NULL;
+    limb_t *table = mem, *acc = mem + tsize * n, *x = acc + n, *one = x + n;
+    ctx.t = one + n;
+
+    bigint_t *result = NULL;
+    memcpy(x, base->limbs, base->len * sizeof(limb_t));
+    one[0] = 1;
+    if (!mont_to(&ctx, table, one) || !mont_to(&ctx, table + n, x)) goto done;
+    for (size_t i = 2; i < tsize; i++) {
+        if (!mont_mul(&ctx, table + i * n, table + (i - 1) * n, table + n)) goto done;
+    }
+
+    // 从最高位开始, 最高的不完整窗口先处理
+    memcpy(acc, table, n * sizeof(limb_t));
+    size_t pos = bits;
+    unsigned first = (unsigned)(bits % w);
+    if (first == 0) first = w;
+    bool started = false;
+    while (pos > 0) {
+        unsigned cnt = started ? w : first;
+        pos -= cnt;
+        if (started) {
+            for (unsigned i = 0; i < cnt; i++) {
+                if (!mont_mul(&ctx, acc, acc, acc)) goto done;
+            }
+        }
+        unsigned digit = exp_bits(e, pos, cnt);
+        if (!started) {
+            memcpy(acc, table + digit * n, n * sizeof(limb_t));
+            started = true;
+        } else if (digit) {
+            if (!mont_mul(&ctx, acc, acc, table + digit * n)) goto done;
+        }
+    }
+
+    // 离开 Montgomery 域: 乘以 1
+    memset(x, 0, n * sizeof(limb_t));
+    x[0] = 1;
+    if (!mont_mul(&ctx, acc, acc, x)) goto done;
+    result = bigint_from_limbs(acc, n, false);
+done:
+    free(mem);
+    return result;
+}
+
+// 偶数模数: 平方-乘法, 每步取模
+static bigint_t* powmod_plain(const bigint_t *base, const bigint_t *e, const bigint_t *m) {
+    bigint_t *acc = bigint_one();
+    bigint_t *x = bigint_copy(base);
+    size_t bits = bigint_bit_length(e);
+    for (size_t i = 0; acc && x && i < bits; i++) {
+        if ((e->limbs[i / 64] >> (i % 64)) & 1) {
+            bigint_t *t = bigint_mul(acc, x);
+            bigint_free(acc);
+            acc = t ? bigint_mod(t, m) : NULL;
+            bigint_free(t);
+        }
+        if (i + 1 < bits && acc) {
+            bigint_t *t = bigint_mul(x, x);
+            bigint_free(x);
+            x = t ? bigint_mod(t, m) : NULL;
+            bigint_free(t);
+        }
+    }
+    bigint_free(x);
+    return acc;
+}
+
+bigint_t* bigint_powmod(const bigint_t *base, const bigint_t *exp, const bigint_t *m) {
+    if (!base || !exp || !m || exp->neg || m->len == 0 || m->neg) return NULL;
+    if (m->len == 1 && m->limbs[0] == 1) return bigint_zero();
+
+    // 底数化到 [0, m)
+    bigint_t *b = bigint_mod(base, m);
+    if (!b) return NULL;
+    if (b->neg) {
+        bigint_t *t = bigint_add(b, m);
+        bigint_free(b);
+        b = t;
+        if (!b) return NULL;
+    }
+    bigint_t *r;
+    if (exp->len == 0) r = bigint_one();
+    else if (m->limbs[0] & 1) r = powmod_montgomery(b, exp, m);
+    else r = powmod_plain(b, exp, m);
+    bigint_free(b);
+    return r;
+}
+
+// ---------------------------------------------------------------------------
+// 十进制转换
+// ---------------------------------------------------------------------------
+
+// pow[i] = 10^(19 * 2^(STR_BASE_LEVEL + i)), 由 10^19 反复平方得到
+typedef struct {
+    bigint_t *pow[64];
+    size_t count;
+} dec_powers_t;
+
+static void dec_powers_free(dec_powers_t *p) {
+    for (size_t i = 0; i < p->count; i++) bigint_free(p->pow[i]);
+    p->count = 0;
+}
+
+static bool dec_powers_init(dec_powers_t *p, size_t levels) {
+    p->count = 0;
+    if (levels == 0) return true;
+    bigint_t *x = bigint_from_u64(DEC_CHUNK_BASE);
+    for (int i = 0; x && i < STR_BASE_LEVEL; i++) {
+        bigint_t *t = bigint_mul(x, x);
+        bigint_free(x);
+        x = t;
+    }
+    if (!x) return false;
+    p->pow[p->count++] = x;
+    while (p->count < levels) {
+        bigint_t *t = bigint_mul(p->pow[p->count - 1], p->pow[p->count - 1]);
+        if (!t) {
+            dec_powers_free(p);
+            return false;
+        }
+        p->pow[p->count++] = t;
+    }
+    return true;
+}
+
+static void write_chunk(char *out, limb_t v) {
+    for (int i = DEC_CHUNK_DIGITS - 1; i >= 0; i--) {
+        out[i] = (char)('0' + v % 10);
+        v /= 10;
+    }
+}
+
+// 把 a 写成恰好 19 * 2^(STR_BASE_LEVEL + level) 位 (含前导零)
+static bool to_str_rec(const limb_t *a, size_t an, size_t level, const dec_powers_t *pw, char *out) {
+    size_t chunks = (size_t)1 << (STR_BASE_LEVEL + level);
+    an = mpn_norm(a, an);
+    if (an == 0) {
+        memset(out, '0', chunks * DEC_CHUNK_DIGITS);
+        return true;
+    }
+    if (level == 0) {
+        limb_t *t = malloc(an * sizeof(limb_t));
+        if (!t) return false;
+        memcpy(t, a, an * sizeof(limb_t));
+        size_t c = chunks;
+        while (c > 0 && an > 0) {
+            limb_t rem = mpn_divrem_1(t, t, an, DEC_CHUNK_BASE);
+            an = mpn_norm(t, an);
+            write_chunk(out + --c * DEC_CHUNK_DIGITS, rem);
+        }
+        memset(out, '0', c * DEC_CHUNK_DIGITS);
+        free(t);
+        return true;
+    }
+    const bigint_t *d = pw->pow[level - 1];
+    size_t half = chunks / 2 * DEC_CHUNK_DIGITS;
+    if (mpn_cmp2(a, an, d->limbs, d->len) < 0) {
+        memset(out, '0', half);
+        return to_str_rec(a, an, level - 1, pw, out + half);
+    }
+    limb_t *buf = malloc((an - d->len + 1 + d->len) * sizeof(limb_t));
+    if (!buf) return false;
+    limb_t *q = buf, *r = buf + an - d->len + 1;
+    bool ok = mpn_divrem(q, r, a, an, d->limbs, d->len) &&
+              to_str_rec(q, an - d->len + 1, level - 1, pw, out) &&
+              to_str_rec(r, d->len, level - 1, pw, out + half);
+    free(buf);
+    return ok;
+}
+
+char* bigint_to_str(const bigint_t *b) {
+    if (!b) return NULL;
+    if (b->len == 0) {
+        char *s = malloc(2);
+        if (s) strcpy(s, "0");
+        return s;
+    }
+    // 十进制位数上界: bits * log10(2) + 1
+    size_t digits = (size_t)((double)bigint_bit_length(b) * 0.30102999566398120) + 2;
+    size_t chunks = (digits + DEC_CHUNK_DIGITS - 1) / DEC_CHUNK_DIGITS;
+    size_t level = 0;
+    while (((size_t)1 << (STR_BASE_LEVEL + level)) < chunks) level++;
+    size_t width = ((size_t)1 << (STR_BASE_LEVEL + level)) * DEC_CHUNK_DIGITS;
+
+    dec_powers_t pw;
+    char *buf = malloc(width + 2);
+    if (!buf || !dec_powers_init(&pw, level)) {
+        free(buf);
+        return NULL;
+    }
+    bool ok = to_str_rec(b->limbs, b->len, level, &pw, buf + 1);
+    dec_powers_free(&pw);
+    if (!ok) {
+        free(buf);
+        return NULL;
+    }
+    buf[width + 1] = '\0';
+    size_t skip = 1;
+    while (buf[skip] == '0') skip++;
+    if (b->neg) buf[--skip] = '-';
+    memmove(buf, buf + skip, width + 2 - skip);
+    return buf;
+}
+
+static limb_t parse_chunk(const char *s, size_t n) {
+    limb_t v = 0;
+    for (size_t i = 0; i < n; i++) v = v * 10 + (limb_t)(s[i] - '0');
+    return v;
+}
+
+bigint_t* bigint_from_str(const char *str) {
+    if (!str) return NULL;
+    while (isspace((unsigned char)*str)) str++;
+    bool neg = false;
+    if (*str == '-') {
+        neg = true;
+        str++;
+    }
+    size_t n = strlen(str);
+    if (n == 0) return NULL;
+    for (size_t i = 0; i < n; i++) {
+        if (!isdigit((unsigned char)str[i])) return NULL;
+    }
+    while (n > 1 && *str == '0') {
+        str++;
+        n--;
+    }
+
+    // 每 2^STR_BASE_LEVEL 个 19 位块用 Horner 法组成一个分组, 再逐层两两合并: hi * 10^w + lo
+    size_t chunks = (n + DEC_CHUNK_DIGITS - 1) / DEC_CHUNK_DIGITS;
+    size_t group_chunks = (size_t)1 << STR_BASE_LEVEL;
+    size_t groups = (chunks + group_chunks - 1) / group_chunks;
+    size_t levels = 0;
+    while (((size_t)1 << levels) < groups) levels++;
+
+    bigint_t **g = calloc(groups, sizeof(bigint_t *));
+    dec_powers_t pw;
+    if (!g || !dec_powers_init(&pw, levels)) {
+        free(g);
+        return NULL;
+    }
+    size_t total = groups;
+    bool ok = true;
+    // 分组 0 是最低位; 从字符串末尾往前切
+    for (size_t gi = 0; ok && gi < groups; gi++) {
+        size_t end = n - gi * group_chunks * DEC_CHUNK_DIGITS;
+        size_t len = group_chunks * DEC_CHUNK_DIGITS;
+        if (len > end) len = end;
+        const char *s = str + end - len;
+        size_t first = len % DEC_CHUNK_DIGITS;
+        if (first == 0) first = DEC_CHUNK_DIGITS;
+        bigint_t *x = bigint_alloc(group_chunks + 1);
+        if (!(ok = x != NULL)) break;
+        x->limbs[0] = parse_chunk(s, first);
+        x->len = 1;
+        for (size_t off = first; off < len; off += DEC_CHUNK_DIGITS) {
+            limb_t c = mpn_mul_1(x->limbs, x->limbs, x->len, DEC_CHUNK_BASE);
+            x->limbs[x->len] = c;
+            x->len += c != 0;
+            c = mpn_add_1(x->limbs, x->limbs, x->len, parse_chunk(s + off, DEC_CHUNK_DIGITS));
+            x->limbs[x->len] = c;
+            x->len += c != 0;
+        }
+        bigint_normalize(x);
+        g[gi] = x;
+    }
+    for (size_t lv = 0; ok && groups > 1; lv++) {
+        size_t next = (groups + 1) / 2;
+        for (size_t j = 0; ok && j < groups / 2; j++) {
+            bigint_t *hi = bigint_mul(g[2 * j + 1], pw.pow[lv]);
+            bigint_t *sum = hi ? bigint_add(hi, g[2 * j]) : NULL;
+            bigint_free(hi);
+            bigint_free(g[2 * j]);
+            bigint_free(g[2 * j + 1]);
+            g[2 * j] = g[2 * j + 1] = NULL;
+            g[j] = sum;
+            ok = sum != NULL;
+        }
+        if (ok && (groups & 1)) {
+            g[next - 1] = g[groups - 1];
+            g[groups - 1] = NULL;
+        }
+        groups = next;
+    }
+    bigint_t *result = NULL;
+    if (ok) {
+        result = g[0];
+        g[0] = NULL;
+        if (result->len) result->neg = neg;
+    }
+    for (size_t i = 0; i < total; i++) bigint_free(g[i]);
+    free(g);
+    dec_powers_free(&pw);
+    return result;
 }
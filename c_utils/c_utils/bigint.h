@@ -5,15 +5,23 @@
 #include <stdint.h>
 #include <stdbool.h>
 
-// 大整数实现（支持正整数）
+// 任意精度有符号整数
+// 数值按 2^64 进制小端序存放在 limbs 中, 最高 limb 非零, 零的 len 为 0 且 neg 为 false
+// 乘法按规模依次使用 schoolbook、Karatsuba、Toom-3 和三素数 NTT
 typedef struct {
-    uint32_t *digits;
+    uint64_t *limbs;
     size_t len;
+    size_t cap;
+    bool neg;
 } bigint_t;
 
 // 创建与销毁
+// 十进制字符串, 允许前导空格和一个 '-' 号, 长串按分治转换
 bigint_t* bigint_from_str(const char *str);
+bigint_t* bigint_from_i64(int64_t v);
+bigint_t* bigint_from_u64(uint64_t v);
 void      bigint_free(bigint_t *b);
+// 十进制字符串 (调用者 free), 长数按分治转换
 char*     bigint_to_str(const bigint_t *b);
 bigint_t* bigint_copy(const bigint_t *b);
 
@@ -21,13 +29,33 @@ bigint_t* bigint_copy(const bigint_t *b);
 bigint_t* bigint_zero(void);
 bigint_t* bigint_one(void);
 
-// 基本运算
+// 基本运算 (结果为新对象, 内存不足返回 NULL)
 bigint_t* bigint_add(const bigint_t *a, const bigint_t *b);
-bigint_t* bigint_sub(const bigint_t *a, const bigint_t *b);  // a >= b
+// 保持原有约定: a < b 时返回 NULL; 需要负数结果时用 bigint_sub_signed
+bigint_t* bigint_sub(const bigint_t *a, const bigint_t *b);
+bigint_t* bigint_sub_signed(const bigint_t *a, const bigint_t *b);
 bigint_t* bigint_mul(const bigint_t *a, const bigint_t *b);
+bigint_t* bigint_neg(const bigint_t *a);
+// 左移/右移 bits 位 (按绝对值移位, 保留符号)
+bigint_t* bigint_shl(const bigint_t *a, size_t bits);
+bigint_t* bigint_shr(const bigint_t *a, size_t bits);
+
+// 截断除法 (商向零取整, 余数与被除数同号, 与 C 的 / 和 % 一致)
+// 小除数用 Knuth 算法 D, 大除数用 Burnikel-Ziegler 递归除法
+// q、r 可为 NULL; 返回: 除数为零或内存不足返回 false
+bool      bigint_divmod(const bigint_t *a, const bigint_t *b, bigint_t **q, bigint_t **r);
+bigint_t* bigint_div(const bigint_t *a, const bigint_t *b);
+bigint_t* bigint_mod(const bigint_t *a, const bigint_t *b);
+
+// 模幂 base^exp mod m, 结果在 [0, m) 内
+// 奇数模数用 Montgomery 约减和固定窗口, 偶数模数用平方-乘法
+// 返回: exp < 0 或 m <= 0 返回 NULL
+bigint_t* bigint_powmod(const bigint_t *base, const bigint_t *exp, const bigint_t *m);
 
 // 比较与判断
 int       bigint_compare(const bigint_t *a, const bigint_t *b); // -1, 0, 1
 bool      bigint_is_zero(const bigint_t *b);
+int       bigint_sign(const bigint_t *b);                       // -1, 0, 1
+size_t    bigint_bit_length(const bigint_t *b);                 // 绝对值的二进制位数, 零为 0
 
 #endif // C_UTILS_BIGINT_H
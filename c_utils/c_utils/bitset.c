@@ -2,51 +2,316 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define BITSET_HAVE_AVX2 1
+#endif
+
+// 排名目录每 512 位 (8 个字) 采样一次
+#define RANK_SAMPLE_WORDS 8
+// 选择提示每 4096 个置位记录一次所在的采样块
+#define SELECT_SAMPLE_SHIFT 12
+// 字数达到该值时计数走 Harley-Seal
+#define HARLEY_SEAL_MIN_WORDS 64
+
+// 不变式: 最后一个字中超出 nbits 的位始终为 0,
+// 这样计数、比较和集合运算都可以按整字处理而不必逐位判断边界
 struct bitset_s {
-    uint8_t *bits;
+    uint64_t *words;
     size_t nbits;
+    size_t nwords;
+    uint64_t *rank;       // 排名目录: rank[i] 为前 i*512 位的置位数, 末项为总数
+    size_t *select_hint;  // select_hint[j] 为第 j*4096 个置位所在的采样块, 缩小 select 的二分范围
+    bool rank_valid;
 };
 
+typedef enum {
+    WORDS_AND,
+    WORDS_OR,
+    WORDS_XOR,
+    WORDS_NOT
+} words_op_t;
+
+typedef enum {
+    RANGE_SET,
+    RANGE_CLEAR,
+    RANGE_FLIP
+} range_op_t;
+
 // 计算需要的字节数
 static size_t bits_to_bytes(size_t nbits) {
     return (nbits + 7) / 8;
 }
 
+static size_t bits_to_words(size_t nbits) {
+    return (nbits + 63) / 64;
+}
+
+// 最后一个字的有效位掩码
+static uint64_t tail_mask(size_t nbits) {
+    return (nbits & 63) ? (1ull << (nbits & 63)) - 1 : ~0ull;
+}
+
+static void trim_tail(bitset_t *bs) {
+    if (bs->nwords) bs->words[bs->nwords - 1] &= tail_mask(bs->nbits);
+}
+
+static inline void invalidate_rank(bitset_t *bs) {
+    bs->rank_valid = false;
+}
+
+// ---------------------------------------------------------------- 字运算
+
+static void words_op_scalar(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t n, words_op_t op) {
+    switch (op) {
+    case WORDS_AND: for (size_t i = 0; i < n; i++) out[i] = a[i] & b[i]; break;
+    case WORDS_OR: for (size_t i = 0; i < n; i++) out[i] = a[i] | b[i]; break;
+    case WORDS_XOR: for (size_t i = 0; i < n; i++) out[i] = a[i] ^ b[i]; break;
+    case WORDS_NOT: for (size_t i = 0; i < n; i++) out[i] = ~a[i]; break;
+    }
+}
+
+static size_t words_count_scalar(const uint64_t *w, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) count += (size_t)__builtin_popcountll(w[i]);
+    return count;
+}
+
+// 前 n 个字中第 k 个置位的位置, 不存在返回 (size_t)-1
+// 先按字定位, 字内按 32/16/8 位二分后在字节内逐位
+#define WORDS_SELECT_BODY(popcount)                                                     \
+    for (size_t i = 0; i < n; i++) {                                                    \
+        size_t c = (size_t)popcount(w[i]);                                              \
+        if (k >= c) {                                                                   \
+            k -= c;                                                                     \
+            continue;                                                                   \
+        }                                                                               \
+        uint64_t x = w[i];                                                              \
+        unsigned pos = 0;                                                               \
+        if (k >= (c = (size_t)popcount(x & 0xFFFFFFFFull))) { k -= c; pos += 32; x >>= 32; } \
+        if (k >= (c = (size_t)popcount(x & 0xFFFF))) { k -= c; pos += 16; x >>= 16; }  \
+        if (k >= (c = (size_t)popcount(x & 0xFF))) { k -= c; pos += 8; x >>= 8; }     \
+        while (k--) x &= x - 1;                                                         \
+        return (i << 6) + pos + (size_t)__builtin_ctzll(x);                             \
+    }                                                                                   \
+    return (size_t)-1
+
+static size_t words_select_scalar(const uint64_t *w, size_t n, size_t k) {
+    WORDS_SELECT_BODY(__builtin_popcountll);
+}
+
+#ifdef BITSET_HAVE_AVX2
+#define AVX2_WORDS_LOOP(expr)                                               \
+    for (; i + 4 <= n; i += 4) {                                            \
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));           \
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));           \
+        (void)y;                                                            \
+        _mm256_storeu_si256((__m256i *)(out + i), (expr));                  \
+    }
+
+// AVX2: 一次处理 256 位, 尾部不足 4 个字时走标量
+__attribute__((target("avx2")))
+static void words_op_avx2(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t n, words_op_t op) {
+    size_t i = 0;
+    if (op == WORDS_NOT) b = a;
+    switch (op) {
+    case WORDS_AND: AVX2_WORDS_LOOP(_mm256_and_si256(x, y)); break;
+    case WORDS_OR: AVX2_WORDS_LOOP(_mm256_or_si256(x, y)); break;
+    case WORDS_XOR: AVX2_WORDS_LOOP(_mm256_xor_si256(x, y)); break;
+    case WORDS_NOT: AVX2_WORDS_LOOP(_mm256_xor_si256(x, _mm256_set1_epi64x(-1))); break;
+    }
+    words_op_scalar(out + i, a + i, b + i, n - i, op);
+}
+
+// 每个 64 位通道的置位数 (查表 pshufb + sad)
+__attribute__((target("avx2")))
+static inline __m256i popcount256(__m256i v) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0F);
+    __m256i lo = _mm256_and_si256(v, low);
+    __m256i hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low);
+    __m256i cnt = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, lo), _mm256_shuffle_epi8(lookup, hi));
+    return _mm256_sad_epu8(cnt, _mm256_setzero_si256());
+}
+
+// 进位保存加法器: a + b + c = 2 * h + l (逐位)
+#define CSA(h, l, a, b, c) do {                                             \
+        __m256i u_ = _mm256_xor_si256((a), (b));                            \
+        (h) = _mm256_or_si256(_mm256_and_si256((a), (b)), _mm256_and_si256(u_, (c))); \
+        (l) = _mm256_xor_si256(u_, (c));                                    \
+    } while (0)
+
+#define LOAD(k) _mm256_loadu_si256((const __m256i *)(w + i + 4 * (k)))
+
+// Harley-Seal: 16 个向量经进位保存加法器树压缩, 每 64 个字只做一次向量 popcount
+__attribute__((target("avx2,popcnt")))
+static size_t words_count_avx2(const uint64_t *w, size_t n) {
+    __m256i total = _mm256_setzero_si256();
+    __m256i ones = total, twos = total, fours = total, eights = total, sixteens;
+    __m256i twos_a, twos_b, fours_a, fours_b, eights_a, eights_b;
+    size_t i = 0;
+    for (; i + 64 <= n; i += 64) {
+        CSA(twos_a, ones, ones, LOAD(0), LOAD(1));
+        CSA(twos_b, ones, ones, LOAD(2), LOAD(3));
+        CSA(fours_a, twos, twos, twos_a, twos_b);
+        CSA(twos_a, ones, ones, LOAD(4), LOAD(5));
+        CSA(twos_b, ones, ones, LOAD(6), LOAD(7));
+        CSA(fours_b, twos, twos, twos_a, twos_b);
+        CSA(eights_a, fours, fours, fours_a, fours_b);
+        CSA(twos_a, ones, ones, LOAD(8), LOAD(9));
+        CSA(twos_b, ones, ones, LOAD(10), LOAD(11));
+        CSA(fours_a, twos, twos, twos_a, twos_b);
+        CSA(twos_a, ones, ones, LOAD(12), LOAD(13));
+        CSA(twos_b, ones, ones, LOAD(14), LOAD(15));
+        CSA(fours_b, twos, twos, twos_a, twos_b);
+        CSA(eights_b, fours, fours, fours_a, fours_b);
+        CSA(sixteens, eights, eights, eights_a, eights_b);
+        total = _mm256_add_epi64(total, popcount256(sixteens));
+    }
+    total = _mm256_slli_epi64(total, 4);
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(eights), 3));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(fours), 2));
+    total = _mm256_add_epi64(total, _mm256_slli_epi64(popcount256(twos), 1));
+    total = _mm256_add_epi64(total, popcount256(ones));
+
+    size_t count = (size_t)_mm256_extract_epi64(total, 0) + (size_t)_mm256_extract_epi64(total, 1) +
+                   (size_t)_mm256_extract_epi64(total, 2) + (size_t)_mm256_extract_epi64(total, 3);
+    for (; i < n; i++) count += (size_t)_mm_popcnt_u64(w[i]);
+    return count;
+}
+
+#undef LOAD
+#undef CSA
+
+__attribute__((target("popcnt")))
+static size_t words_count_popcnt(const uint64_t *w, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) count += (size_t)_mm_popcnt_u64(w[i]);
+    return count;
+}
+
+__attribute__((target("popcnt")))
+static size_t words_select_popcnt(const uint64_t *w, size_t n, size_t k) {
+    WORDS_SELECT_BODY(_mm_popcnt_u64);
+}
+
+static inline bool use_avx2(void) {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+}
+
+static inline bool use_popcnt(void) {
+    return __builtin_cpu_supports("popcnt");
+}
+#endif
+
+static void words_op(uint64_t *out, const uint64_t *a, const uint64_t *b, size_t n, words_op_t op) {
+#ifdef BITSET_HAVE_AVX2
+    if (use_avx2()) {
+        words_op_avx2(out, a, b, n, op);
+        return;
+    }
+#endif
+    words_op_scalar(out, a, b, n, op);
+}
+
+static size_t words_count(const uint64_t *w, size_t n) {
+#ifdef BITSET_HAVE_AVX2
+    if (n >= HARLEY_SEAL_MIN_WORDS && use_avx2()) return words_count_avx2(w, n);
+    if (use_popcnt()) return words_count_popcnt(w, n);
+#endif
+    return words_count_scalar(w, n);
+}
+
+static size_t words_select(const uint64_t *w, size_t n, size_t k) {
+#ifdef BITSET_HAVE_AVX2
+    if (use_popcnt()) return words_select_popcnt(w, n, k);
+#endif
+    return words_select_scalar(w, n, k);
+}
+
+// 区间 [lo, hi] 按首尾字掩码处理, 中间整字直接赋值
+static void words_range(uint64_t *w, size_t lo, size_t hi, range_op_t op) {
+    size_t fw = lo >> 6, lw = hi >> 6;
+    uint64_t fm = ~0ull << (lo & 63), lm = ~0ull >> (63 - (hi & 63));
+    if (fw == lw) fm &= lm;
+    switch (op) {
+    case RANGE_SET: w[fw] |= fm; break;
+    case RANGE_CLEAR: w[fw] &= ~fm; break;
+    case RANGE_FLIP: w[fw] ^= fm; break;
+    }
+    if (fw == lw) return;
+    switch (op) {
+    case RANGE_SET: memset(w + fw + 1, 0xFF, (lw - fw - 1) * sizeof(uint64_t)); w[lw] |= lm; break;
+    case RANGE_CLEAR: memset(w + fw + 1, 0, (lw - fw - 1) * sizeof(uint64_t)); w[lw] &= ~lm; break;
+    case RANGE_FLIP:
+        words_op(w + fw + 1, w + fw + 1, NULL, lw - fw - 1, WORDS_NOT);
+        w[lw] ^= lm;
+        break;
+    }
+}
+
+// [0, pos) 中的置位数, 不使用排名目录
+static size_t words_rank(const uint64_t *w, size_t pos) {
+    size_t count = words_count(w, pos >> 6);
+    if (pos & 63) {
+        uint64_t last = w[pos >> 6] & tail_mask(pos);
+        count += words_count(&last, 1);
+    }
+    return count;
+}
+
 // 创建与销毁
-bitset_t* bitset_create(size_t nbits) {
+static bitset_t* bitset_alloc(size_t nbits) {
     bitset_t *bs = malloc(sizeof(bitset_t));
     if (!bs) return NULL;
-    
-    bs->nbits = nbits > 0 ? nbits : 1;
-    bs->bits = calloc(bits_to_bytes(bs->nbits), 1);
-    if (!bs->bits) {
+
+    bs->nbits = nbits;
+    bs->nwords = bits_to_words(nbits);
+    bs->words = calloc(bs->nwords > 0 ? bs->nwords : 1, sizeof(uint64_t));
+    if (!bs->words) {
         free(bs);
         return NULL;
     }
-    if (nbits == 0) bs->nbits = 0;
+    bs->rank = NULL;
+    bs->select_hint = NULL;
+    bs->rank_valid = false;
     return bs;
 }
 
+bitset_t* bitset_create(size_t nbits) {
+    return bitset_alloc(nbits);
+}
+
 bitset_t* bitset_create_from_bytes(const uint8_t *bytes, size_t nbytes, size_t nbits) {
     if (!bytes || nbytes == 0 || nbits == 0) return NULL;
-    
-    bitset_t *bs = bitset_create(nbits);
+
+    bitset_t *bs = bitset_alloc(nbits);
     if (!bs) return NULL;
-    
+
+    // 第 i 位位于第 i/8 字节的第 i%8 位, 与字节序无关
     size_t copy_bytes = bits_to_bytes(nbits);
     if (copy_bytes > nbytes) copy_bytes = nbytes;
-    memcpy(bs->bits, bytes, copy_bytes);
+    for (size_t i = 0; i < copy_bytes; i++) {
+        bs->words[i >> 3] |= (uint64_t)bytes[i] << ((i & 7) * 8);
+    }
+    trim_tail(bs);
     return bs;
 }
 
 bitset_t* bitset_clone(const bitset_t *bs) {
     if (!bs) return NULL;
-    return bitset_create_from_bytes(bs->bits, bits_to_bytes(bs->nbits), bs->nbits);
+    bitset_t *copy = bitset_alloc(bs->nbits);
+    if (!copy) return NULL;
+    memcpy(copy->words, bs->words, bs->nwords * sizeof(uint64_t));
+    return copy;
 }
 
 void bitset_free(bitset_t *bs) {
     if (bs) {
-        free(bs->bits);
+        free(bs->select_hint);
+        free(bs->rank);
+        free(bs->words);
         free(bs);
     }
 }
@@ -54,188 +319,242 @@ void bitset_free(bitset_t *bs) {
 // 基本操作
 void bitset_set(bitset_t *bs, size_t bit) {
     if (!bs || bit >= bs->nbits) return;
-    bs->bits[bit / 8] |= (1 << (bit % 8));
+    bs->words[bit >> 6] |= 1ull << (bit & 63);
+    invalidate_rank(bs);
 }
 
 void bitset_clear(bitset_t *bs, size_t bit) {
     if (!bs || bit >= bs->nbits) return;
-    bs->bits[bit / 8] &= ~(1 << (bit % 8));
+    bs->words[bit >> 6] &= ~(1ull << (bit & 63));
+    invalidate_rank(bs);
 }
 
 bool bitset_test(const bitset_t *bs, size_t bit) {
     if (!bs || bit >= bs->nbits) return false;
-    return (bs->bits[bit / 8] & (1 << (bit % 8))) != 0;
+    return (bs->words[bit >> 6] >> (bit & 63)) & 1;
 }
 
 void bitset_flip(bitset_t *bs, size_t bit) {
     if (!bs || bit >= bs->nbits) return;
-    bs->bits[bit / 8] ^= (1 << (bit % 8));
+    bs->words[bit >> 6] ^= 1ull << (bit & 63);
+    invalidate_rank(bs);
 }
 
 // 批量操作
 void bitset_set_all(bitset_t *bs) {
     if (!bs) return;
-    memset(bs->bits, 0xFF, bits_to_bytes(bs->nbits));
+    memset(bs->words, 0xFF, bs->nwords * sizeof(uint64_t));
+    trim_tail(bs);
+    invalidate_rank(bs);
 }
 
 void bitset_clear_all(bitset_t *bs) {
     if (!bs) return;
-    memset(bs->bits, 0, bits_to_bytes(bs->nbits));
+    memset(bs->words, 0, bs->nwords * sizeof(uint64_t));
+    invalidate_rank(bs);
 }
 
 void bitset_flip_all(bitset_t *bs) {
     if (!bs) return;
-    size_t nbytes = bits_to_bytes(bs->nbits);
-    for (size_t i = 0; i < nbytes; i++) {
-        bs->bits[i] ^= 0xFF;
-    }
+    words_op(bs->words, bs->words, NULL, bs->nwords, WORDS_NOT);
+    trim_tail(bs);
+    invalidate_rank(bs);
 }
 
 void bitset_set_range(bitset_t *bs, size_t start, size_t end) {
     if (!bs || start >= bs->nbits || end < start) return;
     if (end >= bs->nbits) end = bs->nbits - 1;
-    for (size_t i = start; i <= end; i++) {
-        bitset_set(bs, i);
-    }
+    words_range(bs->words, start, end, RANGE_SET);
+    invalidate_rank(bs);
 }
 
 void bitset_clear_range(bitset_t *bs, size_t start, size_t end) {
     if (!bs || start >= bs->nbits || end < start) return;
     if (end >= bs->nbits) end = bs->nbits - 1;
-    for (size_t i = start; i <= end; i++) {
-        bitset_clear(bs, i);
-    }
+    words_range(bs->words, start, end, RANGE_CLEAR);
+    invalidate_rank(bs);
 }
 
 void bitset_flip_range(bitset_t *bs, size_t start, size_t end) {
     if (!bs || start >= bs->nbits || end < start) return;
     if (end >= bs->nbits) end = bs->nbits - 1;
-    for (size_t i = start; i <= end; i++) {
-        bitset_flip(bs, i);
-    }
+    words_range(bs->words, start, end, RANGE_FLIP);
+    invalidate_rank(bs);
 }
 
 // 位运算
 bitset_t* bitset_and(const bitset_t *a, const bitset_t *b) {
     if (!a || !b) return NULL;
     size_t nbits = a->nbits < b->nbits ? a->nbits : b->nbits;
-    bitset_t *result = bitset_create(nbits);
+    bitset_t *result = bitset_alloc(nbits);
     if (!result) return NULL;
-    size_t nbytes = bits_to_bytes(nbits);
-    for (size_t i = 0; i < nbytes; i++) {
-        result->bits[i] = a->bits[i] & b->bits[i];
-    }
+    words_op(result->words, a->words, b->words, result->nwords, WORDS_AND);
+    trim_tail(result);
     return result;
 }
 
-bitset_t* bitset_or(const bitset_t *a, const bitset_t *b) {
+// 或/异或: 结果取较长者的长度, 较短者缺少的部分视为 0
+static bitset_t* bitset_combine(const bitset_t *a, const bitset_t *b, words_op_t op) {
     if (!a || !b) return NULL;
-    size_t nbits = a->nbits > b->nbits ? a->nbits : b->nbits;
-    bitset_t *result = bitset_create(nbits);
-    if (!result) return NULL;
-    size_t nbytes = bits_to_bytes(nbits);
-    for (size_t i = 0; i < nbytes; i++) {
-        if (i < bits_to_bytes(a->nbits) && i < bits_to_bytes(b->nbits)) {
-            result->bits[i] = a->bits[i] | b->bits[i];
-        } else if (i < bits_to_bytes(a->nbits)) {
-            result->bits[i] = a->bits[i];
-        } else {
-            result->bits[i] = b->bits[i];
-        }
+    if (a->nbits < b->nbits) {
+        const bitset_t *t = a;
+        a = b;
+        b = t;
     }
+    bitset_t *result = bitset_alloc(a->nbits);
+    if (!result) return NULL;
+    words_op(result->words, a->words, b->words, b->nwords, op);
+    memcpy(result->words + b->nwords, a->words + b->nwords, (a->nwords - b->nwords) * sizeof(uint64_t));
     return result;
 }
 
+bitset_t* bitset_or(const bitset_t *a, const bitset_t *b) {
+    return bitset_combine(a, b, WORDS_OR);
+}
+
 bitset_t* bitset_xor(const bitset_t *a, const bitset_t *b) {
-    if (!a || !b) return NULL;
-    size_t nbits = a->nbits > b->nbits ? a->nbits : b->nbits;
-    bitset_t *result = bitset_create(nbits);
-    if (!result) return NULL;
-    size_t nbytes = bits_to_bytes(nbits);
-    for (size_t i = 0; i < nbytes; i++) {
-        if (i < bits_to_bytes(a->nbits) && i < bits_to_bytes(b->nbits)) {
-            result->bits[i] = a->bits[i] ^ b->bits[i];
-        } else if (i < bits_to_bytes(a->nbits)) {
-            result->bits[i] = a->bits[i];
-        } else {
-            result->bits[i] = b->bits[i];
-        }
-    }
-    return result;
+    return bitset_combine(a, b, WORDS_XOR);
 }
 
 bitset_t* bitset_not(const bitset_t *bs) {
     if (!bs) return NULL;
-    bitset_t *result = bitset_clone(bs);
+    bitset_t *result = bitset_alloc(bs->nbits);
     if (!result) return NULL;
-    bitset_flip_all(result);
+    words_op(result->words, bs->words, NULL, bs->nwords, WORDS_NOT);
+    trim_tail(result);
     return result;
 }
 
 // 计数与查找
 size_t bitset_count(const bitset_t *bs) {
     if (!bs) return 0;
-    size_t count = 0;
-    size_t nbytes = bits_to_bytes(bs->nbits);
-    for (size_t i = 0; i < nbytes; i++) {
-        uint8_t byte = bs->bits[i];
-        while (byte) {
-            byte &= byte - 1;
-            count++;
-        }
-    }
-    return count;
+    if (bs->rank_valid) return (size_t)bs->rank[bs->nwords / RANK_SAMPLE_WORDS + 1];
+    return words_count(bs->words, bs->nwords);
 }
 
 size_t bitset_count_range(const bitset_t *bs, size_t start, size_t end) {
     if (!bs || start >= bs->nbits || end < start) return 0;
     if (end >= bs->nbits) end = bs->nbits - 1;
-    size_t count = 0;
-    for (size_t i = start; i <= end; i++) {
-        if (bitset_test(bs, i)) count++;
-    }
-    return count;
+    return bitset_rank(bs, end + 1) - bitset_rank(bs, start);
 }
 
 size_t bitset_find_first_set(const bitset_t *bs, size_t start) {
-    if (!bs) return (size_t)-1;
-    for (size_t i = start; i < bs->nbits; i++) {
-        if (bitset_test(bs, i)) return i;
+    if (!bs || start >= bs->nbits) return (size_t)-1;
+    size_t i = start >> 6;
+    uint64_t w = bs->words[i] & (~0ull << (start & 63));
+    while (!w) {
+        if (++i >= bs->nwords) return (size_t)-1;
+        w = bs->words[i];
     }
-    return (size_t)-1;
+    return (i << 6) + (size_t)__builtin_ctzll(w);
 }
 
 size_t bitset_find_first_clear(const bitset_t *bs, size_t start) {
-    if (!bs) return (size_t)-1;
-    for (size_t i = start; i < bs->nbits; i++) {
-        if (!bitset_test(bs, i)) return i;
+    if (!bs || start >= bs->nbits) return (size_t)-1;
+    size_t i = start >> 6;
+    uint64_t w = ~bs->words[i] & (~0ull << (start & 63));
+    while (!w) {
+        if (++i >= bs->nwords) return (size_t)-1;
+        w = ~bs->words[i];
     }
-    return (size_t)-1;
+    size_t pos = (i << 6) + (size_t)__builtin_ctzll(w);
+    return pos < bs->nbits ? pos : (size_t)-1;
 }
 
 size_t bitset_find_last_set(const bitset_t *bs) {
     if (!bs) return (size_t)-1;
-    for (size_t i = bs->nbits - 1; i >= 0; i--) {
-        if (bitset_test(bs, i)) return i;
-        if (i == 0) break;
+    for (size_t i = bs->nwords; i-- > 0;) {
+        if (bs->words[i]) return (i << 6) + 63 - (size_t)__builtin_clzll(bs->words[i]);
     }
     return (size_t)-1;
 }
 
+// 排名与选择
+bool bitset_build_rank_index(bitset_t *bs) {
+    if (!bs) return false;
+    size_t nsamples = bs->nwords / RANK_SAMPLE_WORDS + 2;
+    uint64_t *rank = realloc(bs->rank, nsamples * sizeof(uint64_t));
+    if (!rank) return false;
+
+    uint64_t count = 0;
+    for (size_t s = 0; s + 1 < nsamples; s++) {
+        rank[s] = count;
+        size_t lo = s * RANK_SAMPLE_WORDS;
+        size_t n = lo + RANK_SAMPLE_WORDS <= bs->nwords ? RANK_SAMPLE_WORDS : bs->nwords - lo;
+        count += words_count(bs->words + lo, n);
+    }
+    rank[nsamples - 1] = count;
+    bs->rank = rank;
+
+    size_t nhints = (size_t)(count >> SELECT_SAMPLE_SHIFT) + 2;
+    size_t *hint = realloc(bs->select_hint, nhints * sizeof(size_t));
+    if (!hint) return false;
+    size_t s = 0;
+    for (size_t j = 0; j + 1 < nhints; j++) {
+        uint64_t target = (uint64_t)j << SELECT_SAMPLE_SHIFT;
+        while (s + 2 < nsamples && rank[s + 1] <= target) s++;
+        hint[j] = s;
+    }
+    hint[nhints - 1] = nsamples - 2;
+    bs->select_hint = hint;
+    bs->rank_valid = true;
+    return true;
+}
+
+size_t bitset_rank(const bitset_t *bs, size_t pos) {
+    if (!bs) return 0;
+    if (pos > bs->nbits) pos = bs->nbits;
+    if (!bs->rank_valid) return words_rank(bs->words, pos);
+
+    size_t sample = (pos >> 6) / RANK_SAMPLE_WORDS;
+    size_t base = sample * RANK_SAMPLE_WORDS;
+    return (size_t)bs->rank[sample] + words_rank(bs->words + base, pos - (base << 6));
+}
+
+size_t bitset_select(const bitset_t *bs, size_t k) {
+    if (!bs) return (size_t)-1;
+    size_t i = 0;
+    if (bs->rank_valid) {
+        size_t nsamples = bs->nwords / RANK_SAMPLE_WORDS + 2;
+        if (k >= bs->rank[nsamples - 1]) return (size_t)-1;
+
+        // 在提示给出的范围内找最后一个 rank[s] <= k 的采样点 (无分支二分)
+        size_t h = k >> SELECT_SAMPLE_SHIFT;
+        const uint64_t *base = bs->rank + bs->select_hint[h];
+        size_t n = bs->select_hint[h + 1] - bs->select_hint[h] + 1;
+        while (n > 1) {
+            size_t half = n / 2;
+            base = base[half] <= k ? base + half : base;
+            n -= half;
+        }
+        k -= (size_t)*base;
+        i = (size_t)(base - bs->rank) * RANK_SAMPLE_WORDS;
+    }
+    size_t pos = words_select(bs->words + i, bs->nwords - i, k);
+    return pos == (size_t)-1 ? pos : (i << 6) + pos;
+}
+
 // 状态查询
 bool bitset_is_empty(const bitset_t *bs) {
-    return bitset_count(bs) == 0;
+    if (!bs) return true;
+    for (size_t i = 0; i < bs->nwords; i++) {
+        if (bs->words[i]) return false;
+    }
+    return true;
 }
 
 bool bitset_is_all_set(const bitset_t *bs) {
     if (!bs) return false;
-    return bitset_count(bs) == bs->nbits;
+    if (bs->nwords == 0) return true;
+    for (size_t i = 0; i + 1 < bs->nwords; i++) {
+        if (bs->words[i] != ~0ull) return false;
+    }
+    return bs->words[bs->nwords - 1] == tail_mask(bs->nbits);
 }
 
 bool bitset_equals(const bitset_t *a, const bitset_t *b) {
     if (!a || !b || a->nbits != b->nbits) return false;
-    size_t nbytes = bits_to_bytes(a->nbits);
-    return memcmp(a->bits, b->bits, nbytes) == 0;
+    return memcmp(a->words, b->words, a->nwords * sizeof(uint64_t)) == 0;
 }
 
 size_t bitset_size(const bitset_t *bs) {
@@ -249,15 +568,18 @@ size_t bitset_byte_size(const bitset_t *bs) {
 // 调整大小
 bool bitset_resize(bitset_t *bs, size_t new_size) {
     if (!bs) return false;
-    size_t old_bytes = bits_to_bytes(bs->nbits);
-    size_t new_bytes = bits_to_bytes(new_size);
-    uint8_t *new_bits = realloc(bs->bits, new_bytes);
+    size_t old_words = bs->nwords;
+    size_t new_words = bits_to_words(new_size);
+    uint64_t *new_bits = realloc(bs->words, (new_words > 0 ? new_words : 1) * sizeof(uint64_t));
     if (!new_bits) return false;
-    if (new_bytes > old_bytes) {
-        memset(new_bits + old_bytes, 0, new_bytes - old_bytes);
+    if (new_words > old_words) {
+        memset(new_bits + old_words, 0, (new_words - old_words) * sizeof(uint64_t));
     }
-    bs->bits = new_bits;
+    bs->words = new_bits;
     bs->nbits = new_size;
+    bs->nwords = new_words;
+    trim_tail(bs);
+    invalidate_rank(bs);
     return true;
 }
 
@@ -266,6 +588,8 @@ bool bitset_to_bytes(const bitset_t *bs, uint8_t *out, size_t out_size) {
     if (!bs || !out) return false;
     size_t nbytes = bits_to_bytes(bs->nbits);
     if (out_size < nbytes) return false;
-    memcpy(out, bs->bits, nbytes);
+    for (size_t i = 0; i < nbytes; i++) {
+        out[i] = (uint8_t)(bs->words[i >> 3] >> ((i & 7) * 8));
+    }
     return true;
 }
@@ -5,6 +5,13 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// 稠密位集: 按 64 位字存储
+// - 区间操作只对首尾字做掩码, 中间整字处理
+// - 与/或/异或/取反用 AVX2 一次处理 256 位, 计数用 AVX2 Harley-Seal
+// - 查找基于 ctz/clz 逐字跳过
+// - 排名/选择可建立采样排名目录 (每 512 位一个累计计数), 任何修改都会使目录失效
+// 运行时检测 CPU 特性, 不支持 AVX2 时回退到标量实现
+
 typedef struct bitset_s bitset_t;
 
 // 创建与销毁
@@ -36,10 +43,19 @@ bitset_t* bitset_not(const bitset_t *bs);
 // 计数与查找
 size_t    bitset_count(const bitset_t *bs);
 size_t    bitset_count_range(const bitset_t *bs, size_t start, size_t end);
+// 从 start 开始 (含) 的下一个置位/清零位, 不存在返回 (size_t)-1
 size_t    bitset_find_first_set(const bitset_t *bs, size_t start);
 size_t    bitset_find_first_clear(const bitset_t *bs, size_t start);
 size_t    bitset_find_last_set(const bitset_t *bs);
 
+// 排名与选择 (简洁索引)
+// 建立排名目录, 之后 rank/select/count 为近似常数时间; 修改位集后需重新建立
+bool      bitset_build_rank_index(bitset_t *bs);
+// [0, pos) 中的置位数
+size_t    bitset_rank(const bitset_t *bs, size_t pos);
+// 第 k 个置位的位置 (从 0 开始), 不存在返回 (size_t)-1
+size_t    bitset_select(const bitset_t *bs, size_t k);
+
 // 状态查询
 bool      bitset_is_empty(const bitset_t *bs);
 bool      bitset_is_all_set(const bitset_t *bs);
@@ -6,6 +6,7 @@
 #include <stdbool.h>
 
 // RLE 压缩位图
+// 按行程线性扫描, 适合少量长区间; 随机稀疏集合或千万级 ID 集合请使用 roaring.h
 typedef struct {
     uint32_t *runs;  // 交替存储：[长度, 值, 长度, 值, ...]
     size_t count;     // 运行数量（每个运行占用2个uint32_t）
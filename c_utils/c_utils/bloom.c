@@ -3,6 +3,19 @@
 #include <math.h>
 #include <string.h>
 
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define BLOOM_HAVE_AVX2 1
+#endif
+
+#define BLOOM_MAGIC "BLOOMv2"
+#define BLOOM_VERSION_LEGACY 1
+#define BLOOM_VERSION 2
+#define BLOOM_HEADER_SIZE 48
+#define BLOOM_LANES 16
+#define BLOOM_MAX_HASHES BLOOM_LANES
+#define BLOOM_BATCH 16
+
 struct bloom_s {
     uint8_t *bits;
     size_t   nbits;
@@ -10,9 +23,102 @@ struct bloom_s {
     size_t   nexpected;
     double   fp_rate;
     size_t   nadded;
+    size_t   nblocks;
+    uint32_t version;
 };
 
-static uint32_t murmurhash3(const void *key, size_t len, uint32_t seed) {
+// 一个键在块内的探测参数
+typedef struct {
+    size_t   block;
+    uint32_t h1;
+    uint32_t h2;
+    uint32_t start;
+} bloom_probe_t;
+
+static const uint64_t wy_secret[4] = {
+    0xa0761d6478bd642full, 0xe7037ed1a0b428dbull, 0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull
+};
+
+static inline void wy_mum(uint64_t *a, uint64_t *b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t)*a * *b;
+    *a = (uint64_t)r;
+    *b = (uint64_t)(r >> 64);
+#else
+    uint64_t ha = *a >> 32, hb = *b >> 32, la = (uint32_t)*a, lb = (uint32_t)*b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+    uint64_t t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    *a = lo;
+    *b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+static inline uint64_t wy_mix(uint64_t a, uint64_t b) {
+    wy_mum(&a, &b);
+    return a ^ b;
+}
+
+static inline uint64_t wy_r8(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t wy_r4(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t wy_r3(const uint8_t *p, size_t k) {
+    return ((uint64_t)p[0] << 16) | ((uint64_t)p[k >> 1] << 8) | p[k - 1];
+}
+
+uint64_t bloom_hash64(const void *data, size_t len, uint64_t seed) {
+    const uint8_t *p = data;
+    uint64_t a, b;
+    seed ^= wy_mix(seed ^ wy_secret[0], wy_secret[1]);
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (wy_r4(p) << 32) | wy_r4(p + ((len >> 3) << 2));
+            b = (wy_r4(p + len - 4) << 32) | wy_r4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = wy_r3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = wy_mix(wy_r8(p) ^ wy_secret[1], wy_r8(p + 8) ^ seed);
+                see1 = wy_mix(wy_r8(p + 16) ^ wy_secret[2], wy_r8(p + 24) ^ see1);
+                see2 = wy_mix(wy_r8(p + 32) ^ wy_secret[3], wy_r8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = wy_mix(wy_r8(p) ^ wy_secret[1], wy_r8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = wy_r8(p + i - 16);
+        b = wy_r8(p + i - 8);
+    }
+    a ^= wy_secret[1];
+    b ^= seed;
+    wy_mum(&a, &b);
+    return wy_mix(a ^ wy_secret[0] ^ len, b ^ wy_secret[1]);
+}
+
+// 旧版逐字节哈希, 仅用于读取旧格式数据
+static uint32_t legacy_hash(const void *key, size_t len, uint32_t seed) {
     const uint8_t *data = (const uint8_t*)key;
     uint32_t h = seed;
     for (size_t i = 0; i < len; i++) {
@@ -23,35 +129,133 @@ static uint32_t murmurhash3(const void *key, size_t len, uint32_t seed) {
     return h;
 }
 
+// 高位选块 (乘法取高位代替取模), 低位与二次混合结果做块内双重哈希
+static inline bloom_probe_t bloom_probe(const bloom_t *b, const void *data, size_t len) {
+    bloom_probe_t pr;
+    uint64_t h = bloom_hash64(data, len, 0);
+#ifdef __SIZEOF_INT128__
+    pr.block = (size_t)(((__uint128_t)h * b->nblocks) >> 64);
+#else
+    pr.block = (size_t)(((h >> 32) * (uint64_t)b->nblocks) >> 32);
+#endif
+    uint64_t m = (h ^ (h >> 31)) * 0xbf58476d1ce4e5b9ull;
+    pr.h1 = (uint32_t)h;
+    pr.h2 = (uint32_t)(m >> 32) | 1;
+    pr.start = (uint32_t)m >> 28;
+    return pr;
+}
+
+// 第 i 次探测落在第 (start + i) % 16 个字, 位号取 h1 + i * h2 的高 5 位, 各探测必在不同的字
+static inline void block_set_scalar(uint32_t *words, bloom_probe_t pr, uint32_t k) {
+    for (uint32_t i = 0; i < k; i++) {
+        words[(pr.start + i) & (BLOOM_LANES - 1)] |= 1u << ((pr.h1 + i * pr.h2) >> 27);
+    }
+}
+
+static inline bool block_test_scalar(const uint32_t *words, bloom_probe_t pr, uint32_t k) {
+    for (uint32_t i = 0; i < k; i++) {
+        uint32_t bit = 1u << ((pr.h1 + i * pr.h2) >> 27);
+        if (!(words[(pr.start + i) & (BLOOM_LANES - 1)] & bit)) return false;
+    }
+    return true;
+}
+
+#ifdef BLOOM_HAVE_AVX2
+// 按字生成掩码: 字 w 对应第 (w - start) % 16 次探测, 超过 k 的字掩码为 0
+__attribute__((target("avx2")))
+static inline void block_masks_avx2(bloom_probe_t pr, uint32_t k, __m256i *lo, __m256i *hi) {
+    const __m256i lanes_lo = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i lanes_hi = _mm256_setr_epi32(8, 9, 10, 11, 12, 13, 14, 15);
+    const __m256i lane_mask = _mm256_set1_epi32(BLOOM_LANES - 1);
+    const __m256i start = _mm256_set1_epi32((int)pr.start);
+    const __m256i kv = _mm256_set1_epi32((int)k);
+    const __m256i h1 = _mm256_set1_epi32((int)pr.h1);
+    const __m256i h2 = _mm256_set1_epi32((int)pr.h2);
+    const __m256i one = _mm256_set1_epi32(1);
+
+    __m256i idx = _mm256_and_si256(_mm256_sub_epi32(lanes_lo, start), lane_mask);
+    __m256i bit = _mm256_srli_epi32(_mm256_add_epi32(h1, _mm256_mullo_epi32(idx, h2)), 27);
+    *lo = _mm256_and_si256(_mm256_sllv_epi32(one, bit), _mm256_cmpgt_epi32(kv, idx));
+
+    idx = _mm256_and_si256(_mm256_sub_epi32(lanes_hi, start), lane_mask);
+    bit = _mm256_srli_epi32(_mm256_add_epi32(h1, _mm256_mullo_epi32(idx, h2)), 27);
+    *hi = _mm256_and_si256(_mm256_sllv_epi32(one, bit), _mm256_cmpgt_epi32(kv, idx));
+}
+
+__attribute__((target("avx2")))
+static void block_set_avx2(uint32_t *words, bloom_probe_t pr, uint32_t k) {
+    __m256i lo, hi;
+    block_masks_avx2(pr, k, &lo, &hi);
+    __m256i *w = (__m256i *)words;
+    _mm256_store_si256(w, _mm256_or_si256(_mm256_load_si256(w), lo));
+    _mm256_store_si256(w + 1, _mm256_or_si256(_mm256_load_si256(w + 1), hi));
+}
+
+__attribute__((target("avx2")))
+static bool block_test_avx2(const uint32_t *words, bloom_probe_t pr, uint32_t k) {
+    __m256i lo, hi;
+    block_masks_avx2(pr, k, &lo, &hi);
+    const __m256i *w = (const __m256i *)words;
+    return _mm256_testc_si256(_mm256_load_si256(w), lo) && _mm256_testc_si256(_mm256_load_si256(w + 1), hi);
+}
+
+static inline bool bloom_use_avx2(void) {
+    return __builtin_cpu_supports("avx2");
+}
+#endif
+
+static inline uint32_t* block_words(const bloom_t *b, size_t block) {
+    return (uint32_t *)(b->bits + block * BLOOM_BLOCK_BYTES);
+}
+
+static inline bool block_test(const bloom_t *b, bloom_probe_t pr) {
+#ifdef BLOOM_HAVE_AVX2
+    if (bloom_use_avx2()) return block_test_avx2(block_words(b, pr.block), pr, (uint32_t)b->nhash);
+#endif
+    return block_test_scalar(block_words(b, pr.block), pr, (uint32_t)b->nhash);
+}
+
+static size_t bloom_bytes(const bloom_t *b) {
+    return b->version == BLOOM_VERSION ? b->nblocks * BLOOM_BLOCK_BYTES : (b->nbits + 7) / 8;
+}
+
 bool bloom_validate_params(size_t n, double p) {
     if (n == 0) return false;
     if (p <= 0.0 || p >= 1.0) return false;
     return true;
 }
 
+static uint8_t* alloc_blocks(size_t nblocks) {
+    uint8_t *bits = aligned_alloc(BLOOM_BLOCK_BYTES, nblocks * BLOOM_BLOCK_BYTES);
+    if (bits) memset(bits, 0, nblocks * BLOOM_BLOCK_BYTES);
+    return bits;
+}
+
 bloom_t* bloom_create(size_t n, double p) {
     if (!bloom_validate_params(n, p)) return NULL;
-    
+
     bloom_t *b = malloc(sizeof(bloom_t));
     if (!b) return NULL;
 
-    b->nbits = (size_t)(-(double)n * log(p) / (log(2) * log(2)));
-    if (b->nbits == 0) b->nbits = 1;
-    
-    b->nhash = (size_t)((double)b->nbits / (double)n * log(2));
+    // 分块后各块负载不均, 目标假阳性率越低损失越明显: 每降一个数量级多分配 10% 的位
+    double ideal = -(double)n * log(p) / (log(2) * log(2));
+    b->nhash = (size_t)(ideal / (double)n * log(2) + 0.5);
     if (b->nhash == 0) b->nhash = 1;
+    if (b->nhash > BLOOM_MAX_HASHES) b->nhash = BLOOM_MAX_HASHES;
 
-    size_t bytes = (b->nbits + 7) / 8;
-    b->bits = calloc(bytes, 1);
+    b->nblocks = (size_t)(ideal * (1.0 - 0.1 * log10(p)) / (BLOOM_BLOCK_BYTES * 8)) + 1;
+    b->nbits = b->nblocks * BLOOM_BLOCK_BYTES * 8;
+    b->version = BLOOM_VERSION;
+    b->bits = alloc_blocks(b->nblocks);
     if (!b->bits) {
         free(b);
         return NULL;
     }
-    
+
     b->nexpected = n;
     b->fp_rate = p;
     b->nadded = 0;
-    
+
     return b;
 }
 
@@ -64,10 +268,20 @@ void bloom_free(bloom_t *b) {
 
 bool bloom_add(bloom_t *b, const void *data, size_t len) {
     if (!b || !data) return false;
-    for (size_t i = 0; i < b->nhash; i++) {
-        uint32_t h = murmurhash3(data, len, (uint32_t)i);
-        size_t bit = h % b->nbits;
-        b->bits[bit / 8] |= (1 << (bit % 8));
+    if (b->version == BLOOM_VERSION_LEGACY) {
+        for (size_t i = 0; i < b->nhash; i++) {
+            uint32_t h = legacy_hash(data, len, (uint32_t)i);
+            size_t bit = h % b->nbits;
+            b->bits[bit / 8] |= (1 << (bit % 8));
+        }
+    } else {
+        bloom_probe_t pr = bloom_probe(b, data, len);
+#ifdef BLOOM_HAVE_AVX2
+        if (bloom_use_avx2()) {
+            block_set_avx2(block_words(b, pr.block), pr, (uint32_t)b->nhash);
+        } else
+#endif
+        block_set_scalar(block_words(b, pr.block), pr, (uint32_t)b->nhash);
     }
     b->nadded++;
     return true;
@@ -75,113 +289,196 @@ bool bloom_add(bloom_t *b, const void *data, size_t len) {
 
 bool bloom_check(const bloom_t *b, const void *data, size_t len) {
     if (!b || !data) return false;
-    for (size_t i = 0; i < b->nhash; i++) {
-        uint32_t h = murmurhash3(data, len, (uint32_t)i);
-        size_t bit = h % b->nbits;
-        if (!(b->bits[bit / 8] & (1 << (bit % 8)))) return false;
+    if (b->version == BLOOM_VERSION_LEGACY) {
+        for (size_t i = 0; i < b->nhash; i++) {
+            uint32_t h = legacy_hash(data, len, (uint32_t)i);
+            size_t bit = h % b->nbits;
+            if (!(b->bits[bit / 8] & (1 << (bit % 8)))) return false;
+        }
+        return true;
     }
-    return true;
+    return block_test(b, bloom_probe(b, data, len));
+}
+
+size_t bloom_check_many(const bloom_t *b, const void *const *keys, const size_t *lens, size_t count, bool *results) {
+    if (!b || !keys || !lens) return 0;
+    size_t hits = 0;
+    if (b->version == BLOOM_VERSION_LEGACY) {
+        for (size_t i = 0; i < count; i++) {
+            bool hit = bloom_check(b, keys[i], lens[i]);
+            if (results) results[i] = hit;
+            hits += hit;
+        }
+        return hits;
+    }
+
+    // 每批先算哈希并发出预取, 等到判定时块多半已在缓存中
+    bloom_probe_t probes[BLOOM_BATCH];
+    for (size_t base = 0; base < count; base += BLOOM_BATCH) {
+        size_t n = count - base < BLOOM_BATCH ? count - base : BLOOM_BATCH;
+        for (size_t i = 0; i < n; i++) {
+            if (!keys[base + i]) continue;
+            probes[i] = bloom_probe(b, keys[base + i], lens[base + i]);
+            __builtin_prefetch(block_words(b, probes[i].block));
+        }
+        for (size_t i = 0; i < n; i++) {
+            bool hit = keys[base + i] && block_test(b, probes[i]);
+            if (results) results[base + i] = hit;
+            hits += hit;
+        }
+    }
+    return hits;
 }
 
 bool bloom_reset(bloom_t *b) {
     if (!b) return false;
-    size_t bytes = (b->nbits + 7) / 8;
-    memset(b->bits, 0, bytes);
+    memset(b->bits, 0, bloom_bytes(b));
     b->nadded = 0;
     return true;
 }
 
 bool bloom_stats(const bloom_t *b, size_t *estimated_elements, double *false_positive_rate) {
     if (!b) return false;
-    
+
     if (estimated_elements) {
-        size_t set_bits = 0;
-        size_t bytes = (b->nbits + 7) / 8;
-        for (size_t i = 0; i < bytes; i++) {
-            uint8_t byte = b->bits[i];
-            while (byte) {
-                set_bits += byte & 1;
-                byte >>= 1;
-            }
-        }
         *estimated_elements = b->nadded;
     }
-    
+
     if (false_positive_rate) {
         *false_positive_rate = b->fp_rate;
     }
-    
+
     return true;
 }
 
-bool bloom_serialize(const bloom_t *b, uint8_t *buf, size_t buf_size, size_t *written) {
-    if (!b || !buf || buf_size == 0) return false;
-    
+static bool serialize_legacy(const bloom_t *b, uint8_t *buf, size_t buf_size, size_t *written) {
     size_t bytes_needed = sizeof(size_t) * 4 + sizeof(double) + (b->nbits + 7) / 8;
     if (buf_size < bytes_needed) return false;
-    
+
     size_t offset = 0;
-    
+
     memcpy(buf + offset, &b->nbits, sizeof(size_t));
     offset += sizeof(size_t);
-    
+
     memcpy(buf + offset, &b->nhash, sizeof(size_t));
     offset += sizeof(size_t);
-    
+
     memcpy(buf + offset, &b->nexpected, sizeof(size_t));
     offset += sizeof(size_t);
-    
+
     memcpy(buf + offset, &b->nadded, sizeof(size_t));
     offset += sizeof(size_t);
-    
+
     memcpy(buf + offset, &b->fp_rate, sizeof(double));
     offset += sizeof(double);
-    
+
     size_t bits_bytes = (b->nbits + 7) / 8;
     memcpy(buf + offset, b->bits, bits_bytes);
     offset += bits_bytes;
-    
+
     if (written) *written = offset;
-    
+
     return true;
 }
 
-bloom_t* bloom_deserialize(const uint8_t *buf, size_t buf_size) {
-    if (!buf || buf_size < sizeof(size_t) * 4 + sizeof(double)) return NULL;
-    
+// 新格式: 魔数(8) 版本(4) 哈希数(4) 块数(8) 预期元素数(8) 已添加数(8) 假阳性率(8) 块数据
+bool bloom_serialize(const bloom_t *b, uint8_t *buf, size_t buf_size, size_t *written) {
+    if (!b || !buf || buf_size == 0) return false;
+    if (b->version == BLOOM_VERSION_LEGACY) return serialize_legacy(b, buf, buf_size, written);
+
+    size_t bytes = b->nblocks * BLOOM_BLOCK_BYTES;
+    if (buf_size < BLOOM_HEADER_SIZE + bytes) return false;
+
+    uint32_t version = BLOOM_VERSION, nhash = (uint32_t)b->nhash;
+    uint64_t nblocks = b->nblocks, nexpected = b->nexpected, nadded = b->nadded;
+    memcpy(buf, BLOOM_MAGIC, 8);
+    memcpy(buf + 8, &version, 4);
+    memcpy(buf + 12, &nhash, 4);
+    memcpy(buf + 16, &nblocks, 8);
+    memcpy(buf + 24, &nexpected, 8);
+    memcpy(buf + 32, &nadded, 8);
+    memcpy(buf + 40, &b->fp_rate, 8);
+    memcpy(buf + BLOOM_HEADER_SIZE, b->bits, bytes);
+
+    if (written) *written = BLOOM_HEADER_SIZE + bytes;
+    return true;
+}
+
+static bloom_t* deserialize_legacy(const uint8_t *buf, size_t buf_size) {
+    if (buf_size < sizeof(size_t) * 4 + sizeof(double)) return NULL;
+
     size_t offset = 0;
-    
+
     bloom_t *b = malloc(sizeof(bloom_t));
     if (!b) return NULL;
-    
+
     memcpy(&b->nbits, buf + offset, sizeof(size_t));
     offset += sizeof(size_t);
-    
+
     memcpy(&b->nhash, buf + offset, sizeof(size_t));
     offset += sizeof(size_t);
-    
+
     memcpy(&b->nexpected, buf + offset, sizeof(size_t));
     offset += sizeof(size_t);
-    
+
     memcpy(&b->nadded, buf + offset, sizeof(size_t));
     offset += sizeof(size_t);
-    
+
     memcpy(&b->fp_rate, buf + offset, sizeof(double));
     offset += sizeof(double);
-    
-    size_t bits_bytes = (b->nbits + 7) / 8;
-    if (buf_size < offset + bits_bytes) {
+
+    size_t bits_bytes = b->nbits / 8 + (b->nbits % 8 != 0);
+    if (b->nbits == 0 || buf_size - offset < bits_bytes) {
         free(b);
         return NULL;
     }
-    
+
     b->bits = malloc(bits_bytes);
     if (!b->bits) {
         free(b);
         return NULL;
     }
-    
+
     memcpy(b->bits, buf + offset, bits_bytes);
-    
+    b->nblocks = 0;
+    b->version = BLOOM_VERSION_LEGACY;
+
+    return b;
+}
+
+bloom_t* bloom_deserialize(const uint8_t *buf, size_t buf_size) {
+    if (!buf) return NULL;
+    if (buf_size < 8 || memcmp(buf, BLOOM_MAGIC, 8) != 0) return deserialize_legacy(buf, buf_size);
+    if (buf_size < BLOOM_HEADER_SIZE) return NULL;
+
+    uint32_t version, nhash;
+    uint64_t nblocks, nexpected, nadded;
+    double fp_rate;
+    memcpy(&version, buf + 8, 4);
+    memcpy(&nhash, buf + 12, 4);
+    memcpy(&nblocks, buf + 16, 8);
+    memcpy(&nexpected, buf + 24, 8);
+    memcpy(&nadded, buf + 32, 8);
+    memcpy(&fp_rate, buf + 40, 8);
+    if (version != BLOOM_VERSION || nhash == 0 || nhash > BLOOM_MAX_HASHES || nblocks == 0 ||
+        nblocks > (buf_size - BLOOM_HEADER_SIZE) / BLOOM_BLOCK_BYTES) {
+        return NULL;
+    }
+
+    bloom_t *b = malloc(sizeof(bloom_t));
+    if (!b) return NULL;
+    b->bits = alloc_blocks((size_t)nblocks);
+    if (!b->bits) {
+        free(b);
+        return NULL;
+    }
+    memcpy(b->bits, buf + BLOOM_HEADER_SIZE, (size_t)nblocks * BLOOM_BLOCK_BYTES);
+    b->nblocks = (size_t)nblocks;
+    b->nbits = b->nblocks * BLOOM_BLOCK_BYTES * 8;
+    b->nhash = nhash;
+    b->nexpected = (size_t)nexpected;
+    b->nadded = (size_t)nadded;
+    b->fp_rate = fp_rate;
+    b->version = BLOOM_VERSION;
     return b;
 }
@@ -5,8 +5,21 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+// 分块布隆过滤器: 每个键的 k 个位全部落在同一个 64 字节块 (一条缓存行) 内,
+// 块内 16 个 32 位字按双重哈希各置一位, 支持 AVX2 时一次处理整块;
+// 哈希为 wyhash 风格的 64 位哈希. 仍可反序列化旧版 (逐字节哈希, 全局分散探测) 的数据
 typedef struct bloom_s bloom_t;
 
+// 块大小 (字节), 与缓存行一致
+#define BLOOM_BLOCK_BYTES 64
+
+// 64 位哈希 (wyhash 风格), 供布隆过滤器及其他需要强哈希的模块使用
+// data: 数据指针
+// len: 数据长度
+// seed: 种子
+// 返回: 64 位哈希值
+uint64_t bloom_hash64(const void *data, size_t len, uint64_t seed);
+
 // 创建布隆过滤器
 // n: 预期存储的元素数量
 // p: 期望的假阳性概率 (例如 0.01 表示 1%)
@@ -30,6 +43,15 @@ bool     bloom_add(bloom_t *b, const void *data, size_t len);
 // 返回: true 表示可能存在，false 表示肯定不存在
 bool     bloom_check(const bloom_t *b, const void *data, size_t len);
 
+// 批量检查元素是否存在: 先计算整批哈希并预取对应块, 再逐个判定, 隐藏内存延迟
+// b: 布隆过滤器
+// keys: 键指针数组
+// lens: 键长度数组
+// count: 键数量
+// results: 输出每个键的结果 (可为 NULL)
+// 返回: 可能存在的键的数量
+size_t   bloom_check_many(const bloom_t *b, const void *const *keys, const size_t *lens, size_t count, bool *results);
+
 // 重置布隆过滤器
 // b: 布隆过滤器
 // 返回: 成功返回 true，失败返回 false
@@ -43,6 +65,7 @@ bool     bloom_reset(bloom_t *b);
 bool     bloom_stats(const bloom_t *b, size_t *estimated_elements, double *false_positive_rate);
 
 // 序列化布隆过滤器
+// 格式以 "BLOOMv2" 魔数开头; 由旧版数据反序列化得到的过滤器仍按旧格式写出
 // b: 布隆过滤器
 // buf: 输出缓冲区
 // buf_size: 缓冲区大小
@@ -50,7 +73,7 @@ bool     bloom_stats(const bloom_t *b, size_t *estimated_elements, double *false
 // 返回: 成功返回 true，失败返回 false
 bool     bloom_serialize(const bloom_t *b, uint8_t *buf, size_t buf_size, size_t *written);
 
-// 反序列化布隆过滤器
+// 反序列化布隆过滤器 (兼容没有魔数的旧版格式)
 // buf: 输入缓冲区
 // buf_size: 缓冲区大小
 // 返回: 成功返回过滤器指针，失败返回 NULL
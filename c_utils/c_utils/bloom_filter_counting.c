@@ -1,18 +1,36 @@
 #include "bloom_filter_counting.h"
+#include "bloom.h"
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
 
+#define BLOOM_COUNTING_MAGIC "BLOOMCv2"
+#define BLOOM_COUNTING_VERSION_LEGACY 1
+#define BLOOM_COUNTING_VERSION 2
+#define BLOOM_COUNTING_HEADER_SIZE 24
+#define BLOOM_COUNTING_GROUP 8
+#define BLOOM_COUNTING_BATCH 16
+
 // 计数布隆过滤器结构
 struct bloom_counting_s {
     uint8_t *counts;
     size_t size;
     int num_hashes;
     uint8_t max_count;
+    size_t nblocks;
+    uint32_t version;
 };
 
-// MurmurHash3 简化版
-static uint32_t murmurhash3(const void *key, size_t len, uint32_t seed) {
+// 一个键在块内的探测参数
+typedef struct {
+    size_t block;
+    uint32_t h1;
+    uint32_t h2;
+    uint32_t start;
+} counting_probe_t;
+
+// 旧版逐字节哈希, 仅用于读取旧格式数据
+static uint32_t legacy_hash(const void *key, size_t len, uint32_t seed) {
     const uint8_t *data = (const uint8_t*)key;
     uint32_t h = seed;
     for (size_t i = 0; i < len; i++) {
@@ -23,23 +41,65 @@ static uint32_t murmurhash3(const void *key, size_t len, uint32_t seed) {
     return h;
 }
 
+static inline counting_probe_t counting_probe(const bloom_counting_t *bf, const void *key, size_t key_len) {
+    counting_probe_t pr;
+    uint64_t h = bloom_hash64(key, key_len, 0);
+#ifdef __SIZEOF_INT128__
+    pr.block = (size_t)(((__uint128_t)h * bf->nblocks) >> 64);
+#else
+    pr.block = (size_t)(((h >> 32) * (uint64_t)bf->nblocks) >> 32);
+#endif
+    uint64_t m = (h ^ (h >> 31)) * 0xbf58476d1ce4e5b9ull;
+    pr.h1 = (uint32_t)h;
+    pr.h2 = (uint32_t)(m >> 32) | 1;
+    pr.start = (uint32_t)m >> 29;
+    return pr;
+}
+
+// 第 i 次探测: 块内第 (start + i) % 8 组, 组内取 h1 + i * h2 的高 3 位, 各探测必在不同计数器
+static inline uint8_t* probe_counter(const bloom_counting_t *bf, counting_probe_t pr, int i) {
+    uint32_t group = (pr.start + (uint32_t)i) & (BLOOM_COUNTING_GROUP - 1);
+    uint32_t slot = (pr.h1 + (uint32_t)i * pr.h2) >> 29;
+    return bf->counts + pr.block * BLOOM_BLOCK_BYTES + group * BLOOM_COUNTING_GROUP + slot;
+}
+
+// 旧格式下第 i 次探测的计数器
+static inline uint8_t* legacy_counter(const bloom_counting_t *bf, const void *key, size_t key_len, int i) {
+    return bf->counts + legacy_hash(key, key_len, (uint32_t)i) % bf->size;
+}
+
+static uint8_t* alloc_counts(size_t nblocks) {
+    uint8_t *counts = aligned_alloc(BLOOM_BLOCK_BYTES, nblocks * BLOOM_BLOCK_BYTES);
+    if (counts) memset(counts, 0, nblocks * BLOOM_BLOCK_BYTES);
+    return counts;
+}
+
+// 验证计数布隆过滤器输入参数
+bool bloom_counting_validate_params(size_t size, int num_hashes, uint8_t max_count) {
+    (void)max_count;
+    return size > 0 && num_hashes > 0;
+}
+
 // 创建计数布隆过滤器
 bloom_counting_t* bloom_counting_create(size_t size, int num_hashes, uint8_t max_count) {
-    if (size == 0 || num_hashes == 0) return NULL;
-    
+    if (!bloom_counting_validate_params(size, num_hashes, max_count)) return NULL;
+    if (size > SIZE_MAX - BLOOM_BLOCK_BYTES) return NULL;
+
     bloom_counting_t *bf = malloc(sizeof(bloom_counting_t));
     if (!bf) return NULL;
-    
-    bf->counts = calloc(size, sizeof(uint8_t));
+
+    bf->nblocks = (size + BLOOM_BLOCK_BYTES - 1) / BLOOM_BLOCK_BYTES;
+    bf->counts = alloc_counts(bf->nblocks);
     if (!bf->counts) {
         free(bf);
         return NULL;
     }
-    
-    bf->size = size;
-    bf->num_hashes = num_hashes;
+
+    bf->size = bf->nblocks * BLOOM_BLOCK_BYTES;
+    bf->num_hashes = num_hashes > BLOOM_COUNTING_MAX_HASHES ? BLOOM_COUNTING_MAX_HASHES : num_hashes;
     bf->max_count = max_count > 0 ? max_count : 255;
-    
+    bf->version = BLOOM_COUNTING_VERSION;
+
     return bf;
 }
 
@@ -54,11 +114,14 @@ void bloom_counting_free(bloom_counting_t *bf) {
 // 添加元素
 bool bloom_counting_add(bloom_counting_t *bf, const void *key, size_t key_len) {
     if (!bf || !key) return false;
-    
+
+    counting_probe_t pr = { 0 };
+    if (bf->version == BLOOM_COUNTING_VERSION) pr = counting_probe(bf, key, key_len);
     for (int i = 0; i < bf->num_hashes; i++) {
-        uint32_t h = murmurhash3(key, key_len, (uint32_t)i) % bf->size;
-        if (bf->counts[h] < bf->max_count) {
-            bf->counts[h]++;
+        uint8_t *c = bf->version == BLOOM_COUNTING_VERSION ? probe_counter(bf, pr, i)
+                                                          : legacy_counter(bf, key, key_len, i);
+        if (*c < bf->max_count) {
+            (*c)++;
         }
     }
     return true;
@@ -67,36 +130,80 @@ bool bloom_counting_add(bloom_counting_t *bf, const void *key, size_t key_len) {
 // 移除元素
 bool bloom_counting_remove(bloom_counting_t *bf, const void *key, size_t key_len) {
     if (!bf || !key) return false;
-    
+
+    counting_probe_t pr = { 0 };
+    if (bf->version == BLOOM_COUNTING_VERSION) pr = counting_probe(bf, key, key_len);
     for (int i = 0; i < bf->num_hashes; i++) {
-        uint32_t h = murmurhash3(key, key_len, (uint32_t)i) % bf->size;
-        if (bf->counts[h] > 0) {
-            bf->counts[h]--;
+        uint8_t *c = bf->version == BLOOM_COUNTING_VERSION ? probe_counter(bf, pr, i)
+                                                          : legacy_counter(bf, key, key_len, i);
+        if (*c > 0) {
+            (*c)--;
         }
     }
     return true;
 }
 
+// 已算好探测参数时的判定
+static inline bool counting_test(const bloom_counting_t *bf, counting_probe_t pr) {
+    for (int i = 0; i < bf->num_hashes; i++) {
+        if (*probe_counter(bf, pr, i) == 0) return false;
+    }
+    return true;
+}
+
 // 检查元素是否存在
 bool bloom_counting_check(const bloom_counting_t *bf, const void *key, size_t key_len) {
     if (!bf || !key) return false;
-    
+
+    if (bf->version == BLOOM_COUNTING_VERSION) return counting_test(bf, counting_probe(bf, key, key_len));
     for (int i = 0; i < bf->num_hashes; i++) {
-        uint32_t h = murmurhash3(key, key_len, (uint32_t)i) % bf->size;
-        if (bf->counts[h] == 0) return false;
+        if (*legacy_counter(bf, key, key_len, i) == 0) return false;
     }
     return true;
 }
 
+// 批量检查元素是否存在
+size_t bloom_counting_check_many(const bloom_counting_t *bf, const void *const *keys, const size_t *lens,
+                                 size_t count, bool *results) {
+    if (!bf || !keys || !lens) return 0;
+
+    size_t hits = 0;
+    counting_probe_t probes[BLOOM_COUNTING_BATCH];
+    for (size_t base = 0; base < count; base += BLOOM_COUNTING_BATCH) {
+        size_t n = count - base < BLOOM_COUNTING_BATCH ? count - base : BLOOM_COUNTING_BATCH;
+        if (bf->version == BLOOM_COUNTING_VERSION) {
+            for (size_t i = 0; i < n; i++) {
+                if (!keys[base + i]) continue;
+                probes[i] = counting_probe(bf, keys[base + i], lens[base + i]);
+                __builtin_prefetch(bf->counts + probes[i].block * BLOOM_BLOCK_BYTES);
+            }
+        }
+        for (size_t i = 0; i < n; i++) {
+            bool hit;
+            if (bf->version == BLOOM_COUNTING_VERSION) {
+                hit = keys[base + i] && counting_test(bf, probes[i]);
+            } else {
+                hit = bloom_counting_check(bf, keys[base + i], lens[base + i]);
+            }
+            if (results) results[base + i] = hit;
+            hits += hit;
+        }
+    }
+    return hits;
+}
+
 // 获取元素计数（估算）
 uint8_t bloom_counting_estimate(const bloom_counting_t *bf, const void *key, size_t key_len) {
     if (!bf || !key) return 0;
-    
+
+    counting_probe_t pr = { 0 };
+    if (bf->version == BLOOM_COUNTING_VERSION) pr = counting_probe(bf, key, key_len);
     uint8_t min_count = bf->max_count;
     for (int i = 0; i < bf->num_hashes; i++) {
-        uint32_t h = murmurhash3(key, key_len, (uint32_t)i) % bf->size;
-        if (bf->counts[h] < min_count) {
-            min_count = bf->counts[h];
+        const uint8_t *c = bf->version == BLOOM_COUNTING_VERSION ? probe_counter(bf, pr, i)
+                                                                : legacy_counter(bf, key, key_len, i);
+        if (*c < min_count) {
+            min_count = *c;
         }
     }
     return min_count;
@@ -112,7 +219,7 @@ bool bloom_counting_reset(bloom_counting_t *bf) {
 // 获取计数布隆过滤器统计信息
 bool bloom_counting_stats(const bloom_counting_t *bf, size_t *total_elements, double *false_positive_rate) {
     if (!bf) return false;
-    
+
     if (total_elements) {
         // 估算元素数量：所有计数器的平均值除以哈希函数数量
         size_t sum = 0;
@@ -121,7 +228,7 @@ bool bloom_counting_stats(const bloom_counting_t *bf, size_t *total_elements, do
         }
         *total_elements = sum / bf->num_hashes;
     }
-    
+
     if (false_positive_rate) {
         // 假阳性概率估算
         double bits_set = 0;
@@ -131,17 +238,14 @@ bool bloom_counting_stats(const bloom_counting_t *bf, size_t *total_elements, do
         double p = bits_set / bf->size;
         *false_positive_rate = pow(p, bf->num_hashes);
     }
-    
+
     return true;
 }
 
-// 序列化计数布隆过滤器
-bool bloom_counting_serialize(const bloom_counting_t *bf, uint8_t *buf, size_t buf_size, size_t *written) {
-    if (!bf || !buf) return false;
-    
+static bool serialize_legacy(const bloom_counting_t *bf, uint8_t *buf, size_t buf_size, size_t *written) {
     size_t required = sizeof(size_t) + sizeof(int) + sizeof(uint8_t) + bf->size * sizeof(uint8_t);
     if (buf_size < required) return false;
-    
+
     size_t offset = 0;
     memcpy(buf + offset, &bf->size, sizeof(size_t));
     offset += sizeof(size_t);
@@ -151,32 +255,82 @@ bool bloom_counting_serialize(const bloom_counting_t *bf, uint8_t *buf, size_t b
     offset += sizeof(uint8_t);
     memcpy(buf + offset, bf->counts, bf->size * sizeof(uint8_t));
     offset += bf->size * sizeof(uint8_t);
-    
+
     if (written) *written = offset;
     return true;
 }
 
-// 反序列化计数布隆过滤器
-bloom_counting_t* bloom_counting_deserialize(const uint8_t *buf, size_t buf_size) {
-    if (!buf || buf_size < sizeof(size_t) + sizeof(int) + sizeof(uint8_t)) return NULL;
-    
+// 序列化计数布隆过滤器
+// 新格式: 魔数(8) 版本(4) 哈希数(4) 块数(4) 最大计数(1) 保留(3) 计数器
+bool bloom_counting_serialize(const bloom_counting_t *bf, uint8_t *buf, size_t buf_size, size_t *written) {
+    if (!bf || !buf) return false;
+    if (bf->version == BLOOM_COUNTING_VERSION_LEGACY) return serialize_legacy(bf, buf, buf_size, written);
+    if (bf->nblocks > UINT32_MAX || buf_size < BLOOM_COUNTING_HEADER_SIZE + bf->size) return false;
+
+    uint32_t version = BLOOM_COUNTING_VERSION, num_hashes = (uint32_t)bf->num_hashes;
+    uint32_t nblocks = (uint32_t)bf->nblocks;
+    memcpy(buf, BLOOM_COUNTING_MAGIC, 8);
+    memcpy(buf + 8, &version, 4);
+    memcpy(buf + 12, &num_hashes, 4);
+    memcpy(buf + 16, &nblocks, 4);
+    buf[20] = bf->max_count;
+    memset(buf + 21, 0, 3);
+    memcpy(buf + BLOOM_COUNTING_HEADER_SIZE, bf->counts, bf->size);
+
+    if (written) *written = BLOOM_COUNTING_HEADER_SIZE + bf->size;
+    return true;
+}
+
+static bloom_counting_t* deserialize_legacy(const uint8_t *buf, size_t buf_size) {
+    if (buf_size < sizeof(size_t) + sizeof(int) + sizeof(uint8_t)) return NULL;
+
     size_t offset = 0;
     size_t size;
     int num_hashes;
     uint8_t max_count;
-    
+
     memcpy(&size, buf + offset, sizeof(size_t));
     offset += sizeof(size_t);
     memcpy(&num_hashes, buf + offset, sizeof(int));
     offset += sizeof(int);
     memcpy(&max_count, buf + offset, sizeof(uint8_t));
     offset += sizeof(uint8_t);
-    
-    if (buf_size < offset + size * sizeof(uint8_t)) return NULL;
-    
-    bloom_counting_t *bf = bloom_counting_create(size, num_hashes, max_count);
+
+    if (size == 0 || num_hashes <= 0 || buf_size - offset < size) return NULL;
+
+    bloom_counting_t *bf = malloc(sizeof(bloom_counting_t));
+    if (!bf) return NULL;
+    bf->counts = malloc(size);
+    if (!bf->counts) {
+        free(bf);
+        return NULL;
+    }
+    memcpy(bf->counts, buf + offset, size);
+    bf->size = size;
+    bf->num_hashes = num_hashes;
+    bf->max_count = max_count > 0 ? max_count : 255;
+    bf->nblocks = 0;
+    bf->version = BLOOM_COUNTING_VERSION_LEGACY;
+    return bf;
+}
+
+// 反序列化计数布隆过滤器
+bloom_counting_t* bloom_counting_deserialize(const uint8_t *buf, size_t buf_size) {
+    if (!buf) return NULL;
+    if (buf_size < 8 || memcmp(buf, BLOOM_COUNTING_MAGIC, 8) != 0) return deserialize_legacy(buf, buf_size);
+    if (buf_size < BLOOM_COUNTING_HEADER_SIZE) return NULL;
+
+    uint32_t version, num_hashes, nblocks;
+    memcpy(&version, buf + 8, 4);
+    memcpy(&num_hashes, buf + 12, 4);
+    memcpy(&nblocks, buf + 16, 4);
+    if (version != BLOOM_COUNTING_VERSION || num_hashes == 0 || num_hashes > BLOOM_COUNTING_MAX_HASHES ||
+        nblocks == 0 || nblocks > (buf_size - BLOOM_COUNTING_HEADER_SIZE) / BLOOM_BLOCK_BYTES) {
+        return NULL;
+    }
+
+    bloom_counting_t *bf = bloom_counting_create((size_t)nblocks * BLOOM_BLOCK_BYTES, (int)num_hashes, buf[20]);
     if (!bf) return NULL;
-    
-    memcpy(bf->counts, buf + offset, size * sizeof(uint8_t));
+    memcpy(bf->counts, buf + BLOOM_COUNTING_HEADER_SIZE, bf->size);
     return bf;
 }
@@ -5,11 +5,17 @@
 #include <stddef.h>
 #include <stdbool.h>
 
+// 分块计数布隆过滤器: 每 64 个 8 位计数器组成一块 (一条缓存行), 分为 8 组,
+// 一个键的各次探测落在同一块的不同组内, 增减和查询都只访问一条缓存行;
+// 哈希使用 bloom_hash64 并做双重哈希. 仍可反序列化旧版格式
 typedef struct bloom_counting_s bloom_counting_t;
 
+// 每个键最多的探测次数 (块内组数)
+#define BLOOM_COUNTING_MAX_HASHES 8
+
 // 创建计数布隆过滤器
-// size: 过滤器大小（位数）
-// num_hashes: 哈希函数数量
+// size: 计数器数量, 向上取整到 64 的倍数
+// num_hashes: 哈希函数数量, 超过 BLOOM_COUNTING_MAX_HASHES 时取该上限
 // max_count: 每个计数器的最大值（建议 15 或 255）
 // 返回: 成功返回过滤器指针，失败返回 NULL
 bloom_counting_t* bloom_counting_create(size_t size, int num_hashes, uint8_t max_count);
@@ -38,6 +44,16 @@ bool bloom_counting_remove(bloom_counting_t *bf, const void *key, size_t key_len
 // 返回: true 表示可能存在，false 表示肯定不存在
 bool bloom_counting_check(const bloom_counting_t *bf, const void *key, size_t key_len);
 
+// 批量检查元素是否存在, 先计算整批哈希并预取对应块
+// bf: 计数布隆过滤器
+// keys: 键指针数组
+// lens: 键长度数组
+// count: 键数量
+// results: 输出每个键的结果 (可为 NULL)
+// 返回: 可能存在的键的数量
+size_t bloom_counting_check_many(const bloom_counting_t *bf, const void *const *keys, const size_t *lens,
+                                 size_t count, bool *results);
+
 // 获取元素计数（估算）
 // bf: 计数布隆过滤器
 // key: 键指针
@@ -58,6 +74,7 @@ bool bloom_counting_reset(bloom_counting_t *bf);
 bool bloom_counting_stats(const bloom_counting_t *bf, size_t *total_elements, double *false_positive_rate);
 
 // 序列化计数布隆过滤器
+// 格式以 "BLOOMCv2" 魔数开头; 由旧版数据反序列化得到的过滤器仍按旧格式写出
 // bf: 计数布隆过滤器
 // buf: 输出缓冲区
 // buf_size: 缓冲区大小
@@ -65,7 +82,7 @@ bool bloom_counting_stats(const bloom_counting_t *bf, size_t *total_elements, do
 // 返回: 成功返回 true，失败返回 false
 bool bloom_counting_serialize(const bloom_counting_t *bf, uint8_t *buf, size_t buf_size, size_t *written);
 
-// 反序列化计数布隆过滤器
+// 反序列化计数布隆过滤器 (兼容没有魔数的旧版格式)
 // buf: 输入缓冲区
 // buf_size: 缓冲区大小
 // 返回: 成功返回过滤器指针，失败返回 NULL
@@ -1,24 +1,50 @@
 #include "bplus_tree.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
 
-// B+ 树节点结构
+// 节点头: version + num_keys/is_leaf + next/prev/retired
+#define BPLUS_NODE_HEADER (sizeof(uint64_t) * 2 + sizeof(void *) * 3)
+
+// 每个键占 8 字节内联键 + 键指针 + 值/子节点指针, 子节点比键多一个
+#define BPLUS_NODE_KEYS ((BPLUS_NODE_SIZE - BPLUS_NODE_HEADER - sizeof(void *)) / \
+                         (sizeof(uint64_t) + 2 * sizeof(void *)))
+
+// 树高上限; 4KB 节点下 3 层即可容纳数百万键
+#define BPLUS_MAX_HEIGHT 32
+
+// 版本字: bit0 写锁, bit1 节点已废弃, 其余位为修改计数
+#define BPLUS_VERSION_LOCKED 1u
+#define BPLUS_VERSION_OBSOLETE 2u
+#define BPLUS_VERSION_STEP 4u
+
+// B+ 树节点结构, 整个节点占一页
 typedef struct bplus_node_s {
+    _Atomic uint64_t version;
+    uint16_t num_keys;
     bool is_leaf;
-    int num_keys;
-    void *keys[BPLUS_ORDER - 1];
-    union {
-        void *values[BPLUS_ORDER - 1];
-        struct bplus_node_s *children[BPLUS_ORDER];
-    } u;
-    struct bplus_node_s *next;  // 用于叶子节点的链表
+    struct bplus_node_s *next;      // 叶子链表
+    struct bplus_node_s *prev;      // 叶子链表 (仅写者使用)
+    struct bplus_node_s *retired;   // 待回收链表
+    uint64_t keys[BPLUS_NODE_KEYS];             // 整数键或键前缀
+    const void *key_ptrs[BPLUS_NODE_KEYS];      // 指针键模式下的原始键
+    void *slots[BPLUS_NODE_KEYS + 1];           // 叶子: 值; 内部节点: 子节点
 } bplus_node_t;
 
+_Static_assert(sizeof(bplus_node_t) <= BPLUS_NODE_SIZE, "bplus node exceeds BPLUS_NODE_SIZE");
+_Static_assert(BPLUS_NODE_KEYS >= 4, "BPLUS_NODE_SIZE too small");
+
 // B+ 树结构
 struct bplus_tree_s {
-    bplus_node_t *root;
-    int (*compar)(const void *, const void *);
-    size_t size;
+    bplus_node_t *_Atomic root;
+    int (*compar)(const void *, const void *);  // NULL 表示整数键
+    bplus_key_prefix_fn prefix;
+    _Atomic size_t size;
+    int height;
+    pthread_mutex_t write_lock;
+    atomic_size_t active_readers;
+    bplus_node_t *retired;
 };
 
 // 迭代器结构
@@ -28,31 +54,244 @@ struct bplus_iterator_s {
     int index;
 };
 
+// 查找用的键: 内联部分 + 原始指针
+typedef struct {
+    uint64_t bits;
+    const void *ptr;
+} bplus_key_t;
+
+// 写操作中被加锁的节点, 操作完成后统一解锁
+typedef struct {
+    bplus_node_t *nodes[BPLUS_MAX_HEIGHT * 2 + 4];
+    bool obsolete[BPLUS_MAX_HEIGHT * 2 + 4];
+    int count;
+} bplus_lock_set_t;
+
+static bplus_key_t make_key(const bplus_tree_t *tree, const void *key) {
+    bplus_key_t k;
+    k.ptr = key;
+    if (!tree->compar) {
+        k.bits = *(const uint64_t *)key;
+    } else {
+        k.bits = tree->prefix ? tree->prefix(key) : 0;
+    }
+    return k;
+}
+
+static inline int key_cmp(const bplus_tree_t *tree, uint64_t bits, const void *ptr, const bplus_key_t *k) {
+    if (bits != k->bits) return bits < k->bits ? -1 : 1;
+    if (!tree->compar) return 0;
+    return tree->compar(ptr, k->ptr);
+}
+
+// 节点内查找: upper 为 false 时返回第一个 >= key 的位置, 为 true 时返回第一个 > key 的位置
+static size_t node_search(const bplus_tree_t *tree, const bplus_node_t *node, size_t num, const bplus_key_t *k,
+                          bool upper) {
+    if (num == 0) return 0;
+
+    if (!tree->compar) {
+        // 整数键: 无分支二分, 循环次数只取决于 num
+        const uint64_t *keys = node->keys;
+        uint64_t key = k->bits;
+        size_t base = 0;
+        size_t len = num;
+        if (upper) {
+            while (len > 1) {
+                size_t half = len / 2;
+                base = keys[base + half] <= key ? base + half : base;
+                len -= half;
+            }
+            return base + (keys[base] <= key);
+        }
+        while (len > 1) {
+            size_t half = len / 2;
+            base = keys[base + half] < key ? base + half : base;
+            len -= half;
+        }
+        return base + (keys[base] < key);
+    }
+
+    size_t lo = 0;
+    size_t hi = num;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        int c = key_cmp(tree, node->keys[mid], node->key_ptrs[mid], k);
+        if (c < 0 || (upper && c == 0)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
 // 创建节点
 static bplus_node_t* create_node(bool is_leaf) {
-    bplus_node_t *node = calloc(1, sizeof(bplus_node_t));
+    bplus_node_t *node = aligned_alloc(64, BPLUS_NODE_SIZE);
+    if (!node) return NULL;
+    atomic_init(&node->version, 0);
+    node->num_keys = 0;
     node->is_leaf = is_leaf;
+    node->next = NULL;
+    node->prev = NULL;
+    node->retired = NULL;
     return node;
 }
 
-// 创建 B+ 树
-bplus_tree_t* bplus_tree_create(int (*compar)(const void *, const void *)) {
+// ---------------- 乐观锁 ----------------
+
+static inline size_t clamp_keys(uint16_t num) {
+    return num > BPLUS_NODE_KEYS ? BPLUS_NODE_KEYS : num;
+}
+
+// 读取节点版本, 节点被锁定或已废弃时返回 false
+static inline bool read_lock(bplus_node_t *node, uint64_t *version) {
+    *version = atomic_load_explicit(&node->version, memory_order_acquire);
+    return (*version & (BPLUS_VERSION_LOCKED | BPLUS_VERSION_OBSOLETE)) == 0;
+}
+
+// 检查读取期间节点未被修改
+static inline bool read_validate(bplus_node_t *node, uint64_t version) {
+    atomic_thread_fence(memory_order_acquire);
+    return atomic_load_explicit(&node->version, memory_order_relaxed) == version;
+}
+
+// 写者由互斥锁串行化, 节点锁只用于让并发读者察觉修改
+static void write_lock(bplus_lock_set_t *set, bplus_node_t *node) {
+    for (int i = 0; i < set->count; i++) {
+        if (set->nodes[i] == node) return;
+    }
+    uint64_t v = atomic_load_explicit(&node->version, memory_order_relaxed);
+    atomic_store_explicit(&node->version, v | BPLUS_VERSION_LOCKED, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    set->obsolete[set->count] = false;
+    set->nodes[set->count++] = node;
+}
+
+static void mark_obsolete(bplus_lock_set_t *set, bplus_node_t *node) {
+    write_lock(set, node);
+    for (int i = 0; i < set->count; i++) {
+        if (set->nodes[i] == node) set->obsolete[i] = true;
+    }
+}
+
+static void retire_node(bplus_tree_t *tree, bplus_node_t *node) {
+    node->retired = tree->retired;
+    tree->retired = node;
+}
+
+// 解锁全部节点, 废弃节点保持废弃标记并进入待回收链表
+static void unlock_all(bplus_tree_t *tree, bplus_lock_set_t *set) {
+    for (int i = 0; i < set->count; i++) {
+        bplus_node_t *node = set->nodes[i];
+        uint64_t v = atomic_load_explicit(&node->version, memory_order_relaxed) & ~(uint64_t)BPLUS_VERSION_LOCKED;
+        if (set->obsolete[i]) {
+            v |= BPLUS_VERSION_OBSOLETE;
+            retire_node(tree, node);
+        }
+        atomic_store_explicit(&node->version, v + BPLUS_VERSION_STEP, memory_order_release);
+    }
+    set->count = 0;
+}
+
+// 没有活跃读者时回收废弃节点; 废弃节点已不可达, 之后进入的读者不会再访问
+static void reclaim_retired(bplus_tree_t *tree) {
+    if (!tree->retired) return;
+    atomic_thread_fence(memory_order_seq_cst);
+    if (atomic_load_explicit(&tree->active_readers, memory_order_seq_cst) != 0) return;
+    while (tree->retired) {
+        bplus_node_t *node = tree->retired;
+        tree->retired = node->retired;
+        free(node);
+    }
+}
+
+static inline void reader_enter(const bplus_tree_t *tree) {
+    atomic_fetch_add_explicit(&((bplus_tree_t *)tree)->active_readers, 1, memory_order_seq_cst);
+}
+
+static inline void reader_exit(const bplus_tree_t *tree) {
+    atomic_fetch_sub_explicit(&((bplus_tree_t *)tree)->active_readers, 1, memory_order_release);
+}
+
+typedef enum {
+    FIND_KEY,
+    FIND_LEFTMOST,
+    FIND_RIGHTMOST
+} find_mode_t;
+
+// 读者下降到叶子: 读子节点版本后再校验父节点, 保证子节点指针有效; 失败时从根重试
+static bplus_node_t* reader_find_leaf(const bplus_tree_t *tree, const bplus_key_t *k, find_mode_t mode,
+                                      uint64_t *version) {
+restart:;
+    bplus_node_t *node = atomic_load_explicit(&tree->root, memory_order_acquire);
+    uint64_t v;
+    if (!read_lock(node, &v)) goto restart;
+    if (node != atomic_load_explicit(&tree->root, memory_order_acquire)) goto restart;
+
+    while (!node->is_leaf) {
+        size_t num = clamp_keys(node->num_keys);
+        size_t idx = mode == FIND_KEY ? node_search(tree, node, num, k, true) : (mode == FIND_LEFTMOST ? 0 : num);
+        bplus_node_t *child = node->slots[idx];
+        if (!read_validate(node, v)) goto restart;
+
+        uint64_t cv;
+        if (!read_lock(child, &cv)) goto restart;
+        if (!read_validate(node, v)) goto restart;
+        node = child;
+        v = cv;
+    }
+
+    *version = v;
+    return node;
+}
+
+// ---------------- 创建与释放 ----------------
+
+static bplus_tree_t* tree_create(int (*compar)(const void *, const void *), bplus_key_prefix_fn prefix) {
     bplus_tree_t *tree = malloc(sizeof(bplus_tree_t));
     if (!tree) return NULL;
-    
-    tree->root = NULL;
+
+    bplus_node_t *root = create_node(true);
+    if (!root) {
+        free(tree);
+        return NULL;
+    }
+    atomic_init(&tree->root, root);
     tree->compar = compar;
-    tree->size = 0;
+    tree->prefix = prefix;
+    atomic_init(&tree->size, 0);
+    tree->height = 1;
+    pthread_mutex_init(&tree->write_lock, NULL);
+    atomic_init(&tree->active_readers, 0);
+    tree->retired = NULL;
     return tree;
 }
 
+// 创建 B+ 树
+bplus_tree_t* bplus_tree_create(int (*compar)(const void *, const void *)) {
+    if (!compar) return NULL;
+    return tree_create(compar, NULL);
+}
+
+// 创建带内联键前缀的 B+ 树
+bplus_tree_t* bplus_tree_create_with_prefix(int (*compar)(const void *, const void *), bplus_key_prefix_fn prefix) {
+    if (!compar) return NULL;
+    return tree_create(compar, prefix);
+}
+
+// 创建整数键 B+ 树
+bplus_tree_t* bplus_tree_create_u64(void) {
+    return tree_create(NULL, NULL);
+}
+
 // 释放节点
 static void free_node(bplus_node_t *node) {
     if (!node) return;
-    
+
     if (!node->is_leaf) {
         for (int i = 0; i <= node->num_keys; i++) {
-            free_node(node->u.children[i]);
+            free_node(node->slots[i]);
         }
     }
     free(node);
@@ -61,105 +300,674 @@ static void free_node(bplus_node_t *node) {
 // 释放 B+ 树
 void bplus_tree_free(bplus_tree_t *tree) {
     if (!tree) return;
-    
-    free_node(tree->root);
+
+    free_node(atomic_load(&tree->root));
+    while (tree->retired) {
+        bplus_node_t *node = tree->retired;
+        tree->retired = node->retired;
+        free(node);
+    }
+    pthread_mutex_destroy(&tree->write_lock);
     free(tree);
 }
 
-// 简化的插入实现（仅支持叶子节点）
-bool bplus_tree_insert(bplus_tree_t *tree, const void *key, void *value) {
-    if (!tree) return false;
-    
-    // 创建根节点（如果不存在）
-    if (!tree->root) {
-        tree->root = create_node(true);
-        if (!tree->root) return false;
-    }
-    
-    bplus_node_t *leaf = tree->root;
-    
-    // 查找插入位置
-    int i = leaf->num_keys - 1;
-    while (i >= 0 && tree->compar && tree->compar(leaf->keys[i], key) > 0) {
-        leaf->keys[i + 1] = leaf->keys[i];
-        leaf->u.values[i + 1] = leaf->u.values[i];
-        i--;
-    }
-    
-    // 插入新键值
-    leaf->keys[i + 1] = (void *)key;
-    leaf->u.values[i + 1] = value;
-    leaf->num_keys++;
-    tree->size++;
-    
+// ---------------- 插入 ----------------
+
+static void node_insert_entry(bplus_node_t *node, size_t pos, uint64_t bits, const void *ptr, void *slot) {
+    size_t move = node->num_keys - pos;
+    memmove(node->keys + pos + 1, node->keys + pos, move * sizeof(uint64_t));
+    memmove(node->key_ptrs + pos + 1, node->key_ptrs + pos, move * sizeof(void *));
+    if (node->is_leaf) {
+        memmove(node->slots + pos + 1, node->slots + pos, move * sizeof(void *));
+        node->slots[pos] = slot;
+    } else {
+        // 内部节点: 新子节点位于新分隔键右侧
+        memmove(node->slots + pos + 2, node->slots + pos + 1, move * sizeof(void *));
+        node->slots[pos + 1] = slot;
+    }
+    node->keys[pos] = bits;
+    node->key_ptrs[pos] = ptr;
+    node->num_keys++;
+}
+
+// 满叶子分裂: 左半保留在原节点, 右半移到新节点, 新条目插入对应一侧
+// 追加到最右叶子末尾时原节点保持装满, 顺序插入得到满叶子
+static void split_leaf(bplus_node_t *leaf, bplus_node_t *right, size_t pos, const bplus_key_t *k, void *value) {
+    size_t total = BPLUS_NODE_KEYS + 1;
+    size_t split = (pos == BPLUS_NODE_KEYS && !leaf->next) ? BPLUS_NODE_KEYS : total / 2;
+
+    if (pos < split) {
+        size_t moved = BPLUS_NODE_KEYS - (split - 1);
+        memcpy(right->keys, leaf->keys + split - 1, moved * sizeof(uint64_t));
+        memcpy(right->key_ptrs, leaf->key_ptrs + split - 1, moved * sizeof(void *));
+        memcpy(right->slots, leaf->slots + split - 1, moved * sizeof(void *));
+        right->num_keys = (uint16_t)moved;
+        leaf->num_keys = (uint16_t)(split - 1);
+        node_insert_entry(leaf, pos, k->bits, k->ptr, value);
+    } else {
+        size_t moved = BPLUS_NODE_KEYS - split;
+        memcpy(right->keys, leaf->keys + split, moved * sizeof(uint64_t));
+        memcpy(right->key_ptrs, leaf->key_ptrs + split, moved * sizeof(void *));
+        memcpy(right->slots, leaf->slots + split, moved * sizeof(void *));
+        right->num_keys = (uint16_t)moved;
+        leaf->num_keys = (uint16_t)split;
+        node_insert_entry(right, pos - split, k->bits, k->ptr, value);
+    }
+
+    right->next = leaf->next;
+    right->prev = leaf;
+    if (leaf->next) leaf->next->prev = right;
+    leaf->next = right;
+}
+
+// 满内部节点分裂: 中间键上移到 *up_bits/*up_ptr
+static void split_inner(bplus_node_t *node, bplus_node_t *right, size_t pos, uint64_t bits, const void *ptr,
+                        bplus_node_t *child, uint64_t *up_bits, const void **up_ptr) {
+    // 先在栈上合并出 K+1 个键和 K+2 个子节点, 再分到两侧
+    uint64_t keys[BPLUS_NODE_KEYS + 1];
+    const void *ptrs[BPLUS_NODE_KEYS + 1];
+    void *slots[BPLUS_NODE_KEYS + 2];
+    size_t n = BPLUS_NODE_KEYS;
+
+    memcpy(keys, node->keys, pos * sizeof(uint64_t));
+    memcpy(ptrs, node->key_ptrs, pos * sizeof(void *));
+    keys[pos] = bits;
+    ptrs[pos] = ptr;
+    memcpy(keys + pos + 1, node->keys + pos, (n - pos) * sizeof(uint64_t));
+    memcpy(ptrs + pos + 1, node->key_ptrs + pos, (n - pos) * sizeof(void *));
+
+    memcpy(slots, node->slots, (pos + 1) * sizeof(void *));
+    slots[pos + 1] = child;
+    memcpy(slots + pos + 2, node->slots + pos + 1, (n - pos) * sizeof(void *));
+
+    size_t mid = (n + 1) / 2;
+    memcpy(node->keys, keys, mid * sizeof(uint64_t));
+    memcpy(node->key_ptrs, ptrs, mid * sizeof(void *));
+    memcpy(node->slots, slots, (mid + 1) * sizeof(void *));
+    node->num_keys = (uint16_t)mid;
+
+    size_t right_keys = n - mid;
+    memcpy(right->keys, keys + mid + 1, right_keys * sizeof(uint64_t));
+    memcpy(right->key_ptrs, ptrs + mid + 1, right_keys * sizeof(void *));
+    memcpy(right->slots, slots + mid + 1, (right_keys + 1) * sizeof(void *));
+    right->num_keys = (uint16_t)right_keys;
+
+    *up_bits = keys[mid];
+    *up_ptr = ptrs[mid];
+}
+
+static bool tree_insert(bplus_tree_t *tree, const bplus_key_t *k, void *value) {
+    bplus_node_t *path[BPLUS_MAX_HEIGHT];
+    size_t path_idx[BPLUS_MAX_HEIGHT];
+    int depth = 0;
+    bplus_lock_set_t locks;
+    locks.count = 0;
+
+    pthread_mutex_lock(&tree->write_lock);
+
+    bplus_node_t *node = atomic_load_explicit(&tree->root, memory_order_relaxed);
+    while (!node->is_leaf) {
+        size_t idx = node_search(tree, node, node->num_keys, k, true);
+        path[depth] = node;
+        path_idx[depth] = idx;
+        depth++;
+        node = node->slots[idx];
+    }
+
+    size_t pos = node_search(tree, node, node->num_keys, k, false);
+    if (pos < node->num_keys && key_cmp(tree, node->keys[pos], node->key_ptrs[pos], k) == 0) {
+        write_lock(&locks, node);
+        node->slots[pos] = value;
+        unlock_all(tree, &locks);
+        pthread_mutex_unlock(&tree->write_lock);
+        return true;
+    }
+
+    if (node->num_keys < BPLUS_NODE_KEYS) {
+        write_lock(&locks, node);
+        node_insert_entry(node, pos, k->bits, k->ptr, value);
+        unlock_all(tree, &locks);
+        atomic_fetch_add_explicit(&tree->size, 1, memory_order_relaxed);
+        pthread_mutex_unlock(&tree->write_lock);
+        return true;
+    }
+
+    // 先分配分裂所需的全部节点: 叶子右半 + 自底向上连续的满内部节点 + 可能的新根,
+    // 分配失败时树保持原样
+    bplus_node_t *spare[BPLUS_MAX_HEIGHT + 2];
+    int needed = 1;
+    int level = depth - 1;
+    while (level >= 0 && path[level]->num_keys == BPLUS_NODE_KEYS) {
+        needed++;
+        level--;
+    }
+    if (level < 0) needed++;
+    if (level < 0 && tree->height >= BPLUS_MAX_HEIGHT) {
+        pthread_mutex_unlock(&tree->write_lock);
+        return false;
+    }
+    for (int i = 0; i < needed; i++) {
+        spare[i] = create_node(i == 0);
+        if (!spare[i]) {
+            while (i-- > 0) free(spare[i]);
+            pthread_mutex_unlock(&tree->write_lock);
+            return false;
+        }
+    }
+
+    // 分裂路径上所有被修改的节点在整个操作期间保持锁定, 读者不会看到半完成的分裂
+    write_lock(&locks, node);
+    bplus_node_t *right = spare[0];
+    split_leaf(node, right, pos, k, value);
+
+    uint64_t sep_bits = right->keys[0];
+    const void *sep_ptr = right->key_ptrs[0];
+    bplus_node_t *left = node;
+    int used = 1;
+
+    for (level = depth - 1;; level--) {
+        if (level < 0) {
+            bplus_node_t *root = spare[used++];
+            root->keys[0] = sep_bits;
+            root->key_ptrs[0] = sep_ptr;
+            root->slots[0] = left;
+            root->slots[1] = right;
+            root->num_keys = 1;
+            atomic_store_explicit(&tree->root, root, memory_order_release);
+            tree->height++;
+            break;
+        }
+
+        bplus_node_t *parent = path[level];
+        size_t idx = path_idx[level];
+        write_lock(&locks, parent);
+        if (parent->num_keys < BPLUS_NODE_KEYS) {
+            node_insert_entry(parent, idx, sep_bits, sep_ptr, right);
+            break;
+        }
+
+        bplus_node_t *parent_right = spare[used++];
+        split_inner(parent, parent_right, idx, sep_bits, sep_ptr, right, &sep_bits, &sep_ptr);
+        left = parent;
+        right = parent_right;
+    }
+
+    unlock_all(tree, &locks);
+    atomic_fetch_add_explicit(&tree->size, 1, memory_order_relaxed);
+    pthread_mutex_unlock(&tree->write_lock);
     return true;
 }
 
+// 插入键值对
+bool bplus_tree_insert(bplus_tree_t *tree, const void *key, void *value) {
+    if (!tree || !key) return false;
+    bplus_key_t k = make_key(tree, key);
+    return tree_insert(tree, &k, value);
+}
+
+bool bplus_tree_insert_u64(bplus_tree_t *tree, uint64_t key, void *value) {
+    if (!tree || tree->compar) return false;
+    bplus_key_t k = { key, NULL };
+    return tree_insert(tree, &k, value);
+}
+
+// ---------------- 查找 ----------------
+
+static bool tree_lookup(const bplus_tree_t *tree, const bplus_key_t *k, void **value) {
+    reader_enter(tree);
+    for (;;) {
+        uint64_t v;
+        bplus_node_t *leaf = reader_find_leaf(tree, k, FIND_KEY, &v);
+        size_t num = clamp_keys(leaf->num_keys);
+        size_t pos = node_search(tree, leaf, num, k, false);
+        bool found = pos < num && key_cmp(tree, leaf->keys[pos], leaf->key_ptrs[pos], k) == 0;
+        void *result = found ? leaf->slots[pos] : NULL;
+        if (read_validate(leaf, v)) {
+            reader_exit(tree);
+            *value = result;
+            return found;
+        }
+    }
+}
+
 // 获取值
 void* bplus_tree_get(const bplus_tree_t *tree, const void *key) {
-    if (!tree || !tree->root) return NULL;
-    
-    bplus_node_t *curr = tree->root;
-    
-    // 遍历到叶子节点
-    while (curr && !curr->is_leaf) {
-        int i = 0;
-        while (i < curr->num_keys && tree->compar && tree->compar(key, curr->keys[i]) >= 0) {
-            i++;
+    if (!tree || !key) return NULL;
+    bplus_key_t k = make_key(tree, key);
+    void *value = NULL;
+    tree_lookup(tree, &k, &value);
+    return value;
+}
+
+void* bplus_tree_get_u64(const bplus_tree_t *tree, uint64_t key, bool *found) {
+    if (found) *found = false;
+    if (!tree || tree->compar) return NULL;
+    bplus_key_t k = { key, NULL };
+    void *value = NULL;
+    bool hit = tree_lookup(tree, &k, &value);
+    if (found) *found = hit;
+    return value;
+}
+
+// ---------------- 删除 ----------------
+
+static void node_remove_entry(bplus_node_t *node, size_t key_pos, size_t slot_pos) {
+    size_t n = node->num_keys;
+    memmove(node->keys + key_pos, node->keys + key_pos + 1, (n - key_pos - 1) * sizeof(uint64_t));
+    memmove(node->key_ptrs + key_pos, node->key_ptrs + key_pos + 1, (n - key_pos - 1) * sizeof(void *));
+    size_t slots = node->is_leaf ? n : n + 1;
+    memmove(node->slots + slot_pos, node->slots + slot_pos + 1, (slots - slot_pos - 1) * sizeof(void *));
+    node->num_keys--;
+}
+
+static bool tree_delete(bplus_tree_t *tree, const bplus_key_t *k) {
+    bplus_node_t *path[BPLUS_MAX_HEIGHT];
+    size_t path_idx[BPLUS_MAX_HEIGHT];
+    int depth = 0;
+    bplus_lock_set_t locks;
+    locks.count = 0;
+
+    pthread_mutex_lock(&tree->write_lock);
+
+    bplus_node_t *root = atomic_load_explicit(&tree->root, memory_order_relaxed);
+    bplus_node_t *leaf = root;
+    while (!leaf->is_leaf) {
+        size_t idx = node_search(tree, leaf, leaf->num_keys, k, true);
+        path[depth] = leaf;
+        path_idx[depth] = idx;
+        depth++;
+        leaf = leaf->slots[idx];
+    }
+
+    size_t pos = node_search(tree, leaf, leaf->num_keys, k, false);
+    if (pos >= leaf->num_keys || key_cmp(tree, leaf->keys[pos], leaf->key_ptrs[pos], k) != 0) {
+        pthread_mutex_unlock(&tree->write_lock);
+        return false;
+    }
+
+    write_lock(&locks, leaf);
+    node_remove_entry(leaf, pos, pos);
+
+    // 删除后的后继键, 用于替换上层引用了被删键的分隔键
+    const bplus_node_t *succ_node = NULL;
+    size_t succ_pos = 0;
+    if (pos < leaf->num_keys) {
+        succ_node = leaf;
+        succ_pos = pos;
+    } else if (leaf->next) {
+        succ_node = leaf->next;
+    }
+
+    // 叶子删空: 从链表和父节点摘除; 父节点没有子节点时继续向上
+    // removed_level 记录实际删除分隔键的那一层, 其上各层仍在原路径上
+    int removed_level = depth;
+    if (leaf->num_keys == 0 && depth > 0) {
+        if (leaf->prev) {
+            write_lock(&locks, leaf->prev);
+            leaf->prev->next = leaf->next;
         }
-        curr = curr->u.children[i];
-    }
-    
-    // 在叶子节点中查找
-    if (curr && curr->is_leaf) {
-        for (int i = 0; i < curr->num_keys; i++) {
-            if (tree->compar && tree->compar(curr->keys[i], key) == 0) {
-                return curr->u.values[i];
+        if (leaf->next) leaf->next->prev = leaf->prev;
+        mark_obsolete(&locks, leaf);
+
+        for (int level = depth - 1; level >= 0; level--) {
+            bplus_node_t *parent = path[level];
+            size_t idx = path_idx[level];
+            write_lock(&locks, parent);
+            removed_level = level;
+            if (parent->num_keys == 0) {
+                // 只剩这一个子节点, 父节点随之删除 (根节点至少有两个子节点, 不会走到这里)
+                mark_obsolete(&locks, parent);
+                continue;
+            }
+            node_remove_entry(parent, idx > 0 ? idx - 1 : 0, idx);
+            break;
+        }
+    }
+
+    // 指针键模式下分隔键引用用户的键, 被删键不能继续留在内部节点中.
+    // 等于被删键的分隔键只可能是某层下降位置左侧的那个, 用后继键替换
+    if (tree->compar && succ_node) {
+        for (int level = 0; level < removed_level; level++) {
+            bplus_node_t *node = path[level];
+            size_t idx = path_idx[level];
+            if (idx > 0 && key_cmp(tree, node->keys[idx - 1], node->key_ptrs[idx - 1], k) == 0) {
+                write_lock(&locks, node);
+                node->keys[idx - 1] = succ_node->keys[succ_pos];
+                node->key_ptrs[idx - 1] = succ_node->key_ptrs[succ_pos];
             }
         }
     }
-    
-    return NULL;
+
+    // 根节点只剩一个子节点时降低树高
+    root = atomic_load_explicit(&tree->root, memory_order_relaxed);
+    while (!root->is_leaf && root->num_keys == 0) {
+        bplus_node_t *child = root->slots[0];
+        mark_obsolete(&locks, root);
+        atomic_store_explicit(&tree->root, child, memory_order_release);
+        tree->height--;
+        root = child;
+    }
+
+    unlock_all(tree, &locks);
+    atomic_fetch_sub_explicit(&tree->size, 1, memory_order_relaxed);
+    reclaim_retired(tree);
+    pthread_mutex_unlock(&tree->write_lock);
+    return true;
 }
 
-// 删除键值对（简化实现）
+// 删除键值对
 bool bplus_tree_delete(bplus_tree_t *tree, const void *key) {
-    if (!tree || !tree->root) return false;
-    
-    // 简化实现：仅标记为已删除
-    // 完整实现需要处理节点合并等复杂逻辑
-    
-    return false;  // 暂不支持删除
+    if (!tree || !key) return false;
+    bplus_key_t k = make_key(tree, key);
+    return tree_delete(tree, &k);
+}
+
+bool bplus_tree_delete_u64(bplus_tree_t *tree, uint64_t key) {
+    if (!tree || tree->compar) return false;
+    bplus_key_t k = { key, NULL };
+    return tree_delete(tree, &k);
+}
+
+// ---------------- 批量构建 ----------------
+
+// 每组不超过 cap 个元素时所需的最少组数, 元素在各组间均分
+static size_t group_count(size_t count, size_t cap) {
+    return (count + cap - 1) / cap;
+}
+
+static bool tree_bulk_load(bplus_tree_t *tree, const uint64_t *u64_keys, const void *const *ptr_keys,
+                           void *const *values, size_t count) {
+    pthread_mutex_lock(&tree->write_lock);
+
+    bplus_node_t *old_root = atomic_load_explicit(&tree->root, memory_order_relaxed);
+    if (atomic_load(&tree->size) != 0 || !old_root->is_leaf) {
+        pthread_mutex_unlock(&tree->write_lock);
+        return false;
+    }
+    if (count == 0) {
+        pthread_mutex_unlock(&tree->write_lock);
+        return true;
+    }
+
+    // 检查严格递增
+    for (size_t i = 1; i < count; i++) {
+        bplus_key_t cur = u64_keys ? (bplus_key_t){ u64_keys[i], NULL } : make_key(tree, ptr_keys[i]);
+        bplus_key_t prev = u64_keys ? (bplus_key_t){ u64_keys[i - 1], NULL } : make_key(tree, ptr_keys[i - 1]);
+        if (key_cmp(tree, prev.bits, prev.ptr, &cur) >= 0) {
+            pthread_mutex_unlock(&tree->write_lock);
+            return false;
+        }
+    }
+
+    size_t leaf_count = group_count(count, BPLUS_NODE_KEYS);
+    bplus_node_t **level = malloc(leaf_count * sizeof(bplus_node_t *));
+    // 每个节点子树中的最小键, 作为上一层的分隔键
+    uint64_t *min_bits = malloc(leaf_count * sizeof(uint64_t));
+    const void **min_ptrs = malloc(leaf_count * sizeof(void *));
+    if (!level || !min_bits || !min_ptrs) goto fail_arrays;
+
+    size_t built = 0;
+    size_t offset = 0;
+    for (size_t i = 0; i < leaf_count; i++) {
+        size_t n = count / leaf_count + (i < count % leaf_count ? 1 : 0);
+        bplus_node_t *leaf = create_node(true);
+        if (!leaf) goto fail_nodes;
+        for (size_t j = 0; j < n; j++) {
+            if (u64_keys) {
+                leaf->keys[j] = u64_keys[offset + j];
+                leaf->key_ptrs[j] = NULL;
+            } else {
+                leaf->keys[j] = tree->prefix ? tree->prefix(ptr_keys[offset + j]) : 0;
+                leaf->key_ptrs[j] = ptr_keys[offset + j];
+            }
+            leaf->slots[j] = values ? values[offset + j] : NULL;
+        }
+        leaf->num_keys = (uint16_t)n;
+        if (i > 0) {
+            level[i - 1]->next = leaf;
+            leaf->prev = level[i - 1];
+        }
+        level[i] = leaf;
+        min_bits[i] = leaf->keys[0];
+        min_ptrs[i] = leaf->key_ptrs[0];
+        built++;
+        offset += n;
+    }
+
+    size_t level_count = leaf_count;
+    int height = 1;
+    while (level_count > 1) {
+        size_t parents = group_count(level_count, BPLUS_NODE_KEYS + 1);
+        size_t child = 0;
+        for (size_t i = 0; i < parents; i++) {
+            size_t n = level_count / parents + (i < level_count % parents ? 1 : 0);
+            bplus_node_t *node = create_node(false);
+            if (!node) {
+                // 已构建的上层节点通过 level[0..i) 可达, 剩余子节点仍在 level[child..)
+                for (size_t j = 0; j < i; j++) free_node(level[j]);
+                for (size_t j = child; j < level_count; j++) free_node(level[j]);
+                goto fail_arrays;
+            }
+            node->slots[0] = level[child];
+            for (size_t j = 1; j < n; j++) {
+                node->keys[j - 1] = min_bits[child + j];
+                node->key_ptrs[j - 1] = min_ptrs[child + j];
+                node->slots[j] = level[child + j];
+            }
+            node->num_keys = (uint16_t)(n - 1);
+            min_bits[i] = min_bits[child];
+            min_ptrs[i] = min_ptrs[child];
+            level[i] = node;
+            child += n;
+        }
+        level_count = parents;
+        height++;
+    }
+
+    atomic_store_explicit(&tree->root, level[0], memory_order_release);
+    tree->height = height;
+    atomic_store(&tree->size, count);
+    retire_node(tree, old_root);
+    reclaim_retired(tree);
+
+    free(level);
+    free(min_bits);
+    free(min_ptrs);
+    pthread_mutex_unlock(&tree->write_lock);
+    return true;
+
+fail_nodes:
+    for (size_t j = 0; j < built; j++) free(level[j]);
+fail_arrays:
+    free(level);
+    free(min_bits);
+    free(min_ptrs);
+    pthread_mutex_unlock(&tree->write_lock);
+    return false;
 }
 
+// 批量构建
+bool bplus_tree_bulk_load(bplus_tree_t *tree, const void *const *keys, void *const *values, size_t count) {
+    if (!tree || !tree->compar || (count > 0 && !keys)) return false;
+    return tree_bulk_load(tree, NULL, keys, values, count);
+}
+
+bool bplus_tree_bulk_load_u64(bplus_tree_t *tree, const uint64_t *keys, void *const *values, size_t count) {
+    if (!tree || tree->compar || (count > 0 && !keys)) return false;
+    return tree_bulk_load(tree, keys, NULL, values, count);
+}
+
+// ---------------- 范围查询 ----------------
+
+typedef bool (*range_emit_fn)(const bplus_tree_t *tree, uint64_t bits, const void *ptr, void *value, void *ctx);
+
+// 沿叶子链表扫描; 每个叶子先拷贝到栈上再校验版本, 校验失败时从最后输出的键之后重新定位
+static size_t tree_range(const bplus_tree_t *tree, const bplus_key_t *start, const bplus_key_t *end,
+                         range_emit_fn emit, void *ctx) {
+    uint64_t bits[BPLUS_NODE_KEYS];
+    const void *ptrs[BPLUS_NODE_KEYS];
+    void *vals[BPLUS_NODE_KEYS];
+    bplus_key_t cursor;
+    bool have_cursor = start != NULL;
+    bool after_cursor = false;
+    size_t count = 0;
+
+    if (start) cursor = *start;
+    if (start && end && key_cmp(tree, end->bits, end->ptr, start) < 0) return 0;
+
+    reader_enter(tree);
+restart:;
+    uint64_t v;
+    bplus_node_t *leaf = reader_find_leaf(tree, &cursor, have_cursor ? FIND_KEY : FIND_LEFTMOST, &v);
+
+    for (;;) {
+        size_t num = clamp_keys(leaf->num_keys);
+        size_t i = have_cursor ? node_search(tree, leaf, num, &cursor, after_cursor) : 0;
+        size_t n = num - i;
+        memcpy(bits, leaf->keys + i, n * sizeof(uint64_t));
+        memcpy(ptrs, leaf->key_ptrs + i, n * sizeof(void *));
+        memcpy(vals, leaf->slots + i, n * sizeof(void *));
+        bplus_node_t *next = leaf->next;
+        if (!read_validate(leaf, v)) goto restart;
+
+        for (size_t j = 0; j < n; j++) {
+            if (end && key_cmp(tree, bits[j], ptrs[j], end) > 0) goto done;
+            if (!emit(tree, bits[j], ptrs[j], vals[j], ctx)) goto done;
+            count++;
+            cursor.bits = bits[j];
+            cursor.ptr = ptrs[j];
+            have_cursor = true;
+            after_cursor = true;
+        }
+
+        if (!next) break;
+        uint64_t nv;
+        if (!read_lock(next, &nv) || !read_validate(leaf, v)) goto restart;
+        leaf = next;
+        v = nv;
+    }
+
+done:
+    reader_exit(tree);
+    return count;
+}
+
+typedef struct {
+    bool (*callback)(const void *key, void *value, void *user_data);
+    void *user_data;
+} range_ptr_ctx_t;
+
+static bool emit_ptr(const bplus_tree_t *tree, uint64_t bits, const void *ptr, void *value, void *ctx) {
+    range_ptr_ctx_t *c = ctx;
+    if (!tree->compar) return c->callback(&bits, value, c->user_data);
+    return c->callback(ptr, value, c->user_data);
+}
+
+// 范围查询
+size_t bplus_tree_range_query(const bplus_tree_t *tree, const void *start_key, const void *end_key,
+                              bool (*callback)(const void *key, void *value, void *user_data),
+                              void *user_data) {
+    if (!tree || !callback) return 0;
+
+    bplus_key_t start;
+    bplus_key_t end;
+    if (start_key) start = make_key(tree, start_key);
+    if (end_key) end = make_key(tree, end_key);
+    range_ptr_ctx_t ctx = { callback, user_data };
+    return tree_range(tree, start_key ? &start : NULL, end_key ? &end : NULL, emit_ptr, &ctx);
+}
+
+typedef struct {
+    bplus_range_u64_cb callback;
+    void *user_data;
+} range_u64_ctx_t;
+
+static bool emit_u64(const bplus_tree_t *tree, uint64_t bits, const void *ptr, void *value, void *ctx) {
+    (void)tree;
+    (void)ptr;
+    range_u64_ctx_t *c = ctx;
+    return c->callback(bits, value, c->user_data);
+}
+
+size_t bplus_tree_range_query_u64(const bplus_tree_t *tree, uint64_t start_key, uint64_t end_key,
+                                  bplus_range_u64_cb callback, void *user_data) {
+    if (!tree || tree->compar || !callback) return 0;
+
+    bplus_key_t start = { start_key, NULL };
+    bplus_key_t end = { end_key, NULL };
+    range_u64_ctx_t ctx = { callback, user_data };
+    return tree_range(tree, &start, &end, emit_u64, &ctx);
+}
+
+// ---------------- 其他查询 ----------------
+
 // 检查 B+ 树是否为空
 bool bplus_tree_is_empty(const bplus_tree_t *tree) {
     if (!tree) return true;
-    return tree->size == 0;
+    return atomic_load_explicit(&tree->size, memory_order_relaxed) == 0;
 }
 
 // 获取 B+ 树大小
 size_t bplus_tree_size(const bplus_tree_t *tree) {
     if (!tree) return 0;
-    return tree->size;
+    return atomic_load_explicit(&tree->size, memory_order_relaxed);
+}
+
+static bool tree_edge(const bplus_tree_t *tree, bool rightmost, const void **key, void **value) {
+    reader_enter(tree);
+    for (;;) {
+        uint64_t v;
+        bplus_node_t *leaf = reader_find_leaf(tree, NULL, rightmost ? FIND_RIGHTMOST : FIND_LEFTMOST, &v);
+        size_t num = clamp_keys(leaf->num_keys);
+        size_t pos = rightmost ? num - 1 : 0;
+        const void *k = NULL;
+        void *val = NULL;
+        if (num > 0) {
+            k = tree->compar ? leaf->key_ptrs[pos] : (const void *)&leaf->keys[pos];
+            val = leaf->slots[pos];
+        }
+        if (read_validate(leaf, v)) {
+            reader_exit(tree);
+            if (num == 0) return false;
+            if (key) *key = k;
+            if (value) *value = val;
+            return true;
+        }
+    }
+}
+
+// 获取最小键
+bool bplus_tree_min(const bplus_tree_t *tree, const void **key, void **value) {
+    if (!tree) return false;
+    return tree_edge(tree, false, key, value);
+}
+
+// 获取最大键
+bool bplus_tree_max(const bplus_tree_t *tree, const void **key, void **value) {
+    if (!tree) return false;
+    return tree_edge(tree, true, key, value);
+}
+
+// ---------------- 迭代器 ----------------
+
+static bplus_node_t* leftmost_leaf(const bplus_tree_t *tree) {
+    bplus_node_t *node = atomic_load_explicit(&tree->root, memory_order_acquire);
+    while (node && !node->is_leaf) {
+        node = node->slots[0];
+    }
+    return node;
 }
 
 // 创建 B+ 树迭代器
 bplus_iterator_t* bplus_iterator_create(const bplus_tree_t *tree) {
     if (!tree) return NULL;
-    
+
     bplus_iterator_t *iter = malloc(sizeof(bplus_iterator_t));
     if (!iter) return NULL;
-    
+
     iter->tree = tree;
-    iter->current = tree->root;
+    iter->current = leftmost_leaf(tree);
     iter->index = 0;
-    
-    // 找到最左边的叶子节点
-    while (iter->current && !iter->current->is_leaf) {
-        iter->current = iter->current->u.children[0];
-    }
-    
     return iter;
 }
 
@@ -172,125 +980,91 @@ void bplus_iterator_free(bplus_iterator_t *iter) {
 
 // 迭代到下一个元素
 bool bplus_iterator_next(bplus_iterator_t *iter, const void **key, void **value) {
-    if (!iter || !iter->current) return false;
-    
-    if (iter->index < iter->current->num_keys) {
-        if (key) *key = iter->current->keys[iter->index];
-        if (value) *value = iter->current->u.values[iter->index];
-        iter->index++;
-        return true;
-    }
-    
-    // 移动到下一个叶子节点
-    iter->current = iter->current->next;
-    iter->index = 0;
-    
-    if (iter->current && iter->index < iter->current->num_keys) {
-        if (key) *key = iter->current->keys[iter->index];
-        if (value) *value = iter->current->u.values[iter->index];
-        iter->index++;
-        return true;
+    if (!iter) return false;
+
+    while (iter->current && iter->index >= iter->current->num_keys) {
+        iter->current = iter->current->next;
+        iter->index = 0;
     }
-    
-    return false;
+    if (!iter->current) return false;
+
+    bplus_node_t *node = iter->current;
+    if (key) *key = iter->tree->compar ? node->key_ptrs[iter->index] : (const void *)&node->keys[iter->index];
+    if (value) *value = node->slots[iter->index];
+    iter->index++;
+    return true;
 }
 
 // 重置迭代器到起始位置
 void bplus_iterator_reset(bplus_iterator_t *iter) {
     if (!iter || !iter->tree) return;
-    
-    iter->current = iter->tree->root;
+
+    iter->current = leftmost_leaf(iter->tree);
     iter->index = 0;
-    
-    // 找到最左边的叶子节点
-    while (iter->current && !iter->current->is_leaf) {
-        iter->current = iter->current->u.children[0];
-    }
 }
 
-// 范围查询（简化实现）
-size_t bplus_tree_range_query(const bplus_tree_t *tree, const void *start_key, const void *end_key,
-                              bool (*callback)(const void *key, void *value, void *user_data),
-                              void *user_data) {
-    if (!tree || !callback) return 0;
-    
-    size_t count = 0;
-    bplus_iterator_t *iter = bplus_iterator_create(tree);
-    if (!iter) return 0;
-    
-    const void *key;
-    void *value;
-    
-    while (bplus_iterator_next(iter, &key, &value)) {
-        // 检查是否在范围内
-        bool in_range = true;
-        if (start_key && tree->compar && tree->compar(key, start_key) < 0) {
-            in_range = false;
-        }
-        if (end_key && tree->compar && tree->compar(key, end_key) > 0) {
-            in_range = false;
-        }
-        
-        if (in_range) {
-            if (!callback(key, value, user_data)) {
-                break;  // 回调返回 false，停止遍历
-            }
-            count++;
-        }
+// ---------------- 校验 ----------------
+
+typedef struct {
+    const bplus_tree_t *tree;
+    int leaf_depth;
+    size_t count;
+    bplus_node_t *prev_leaf;
+    bool ok;
+} validate_ctx_t;
+
+// lo/hi 为子树键的开区间下界 (含) 与上界 (不含), NULL 表示无界
+static void validate_node(validate_ctx_t *ctx, bplus_node_t *node, int depth, const bplus_key_t *lo,
+                          const bplus_key_t *hi) {
+    const bplus_tree_t *tree = ctx->tree;
+    if (!ctx->ok) return;
+    if (node->num_keys > BPLUS_NODE_KEYS) {
+        ctx->ok = false;
+        return;
     }
-    
-    bplus_iterator_free(iter);
-    return count;
-}
 
-// 获取最小键
-bool bplus_tree_min(const bplus_tree_t *tree, const void **key, void **value) {
-    if (!tree || !tree->root) return false;
-    
-    bplus_node_t *curr = tree->root;
-    
-    // 找到最左边的叶子节点
-    while (curr && !curr->is_leaf) {
-        curr = curr->u.children[0];
-    }
-    
-    if (curr && curr->num_keys > 0) {
-        if (key) *key = curr->keys[0];
-        if (value) *value = curr->u.values[0];
-        return true;
+    for (size_t i = 0; i < node->num_keys; i++) {
+        bplus_key_t cur = { node->keys[i], node->key_ptrs[i] };
+        if (tree->prefix && tree->prefix(cur.ptr) != cur.bits) ctx->ok = false;
+        if (i > 0 && key_cmp(tree, node->keys[i - 1], node->key_ptrs[i - 1], &cur) >= 0) ctx->ok = false;
+        if (lo && key_cmp(tree, lo->bits, lo->ptr, &cur) > 0) ctx->ok = false;
+        if (hi && key_cmp(tree, hi->bits, hi->ptr, &cur) <= 0) ctx->ok = false;
     }
-    
-    return false;
-}
+    if (!ctx->ok) return;
 
-// 获取最大键
-bool bplus_tree_max(const bplus_tree_t *tree, const void **key, void **value) {
-    if (!tree || !tree->root) return false;
-    
-    bplus_node_t *curr = tree->root;
-    
-    // 找到最右边的叶子节点
-    while (curr && !curr->is_leaf) {
-        curr = curr->u.children[curr->num_keys];
-    }
-    
-    if (curr && curr->num_keys > 0) {
-        if (key) *key = curr->keys[curr->num_keys - 1];
-        if (value) *value = curr->u.values[curr->num_keys - 1];
-        return true;
+    if (node->is_leaf) {
+        bool is_root = node == atomic_load(&tree->root);
+        if (ctx->leaf_depth < 0) ctx->leaf_depth = depth;
+        if (depth != ctx->leaf_depth || (node->num_keys == 0 && !is_root) || node->prev != ctx->prev_leaf ||
+            (ctx->prev_leaf && ctx->prev_leaf->next != node)) {
+            ctx->ok = false;
+            return;
+        }
+        ctx->prev_leaf = node;
+        ctx->count += node->num_keys;
+        return;
+    }
+
+    for (size_t i = 0; i <= node->num_keys; i++) {
+        bplus_key_t child_lo;
+        bplus_key_t child_hi;
+        if (i > 0) child_lo = (bplus_key_t){ node->keys[i - 1], node->key_ptrs[i - 1] };
+        if (i < node->num_keys) child_hi = (bplus_key_t){ node->keys[i], node->key_ptrs[i] };
+        validate_node(ctx, node->slots[i], depth + 1, i > 0 ? &child_lo : lo,
+                      i < node->num_keys ? &child_hi : hi);
     }
-    
-    return false;
 }
 
-// 验证 B+ 树结构（简化实现）
+// 验证 B+ 树结构
 bool bplus_tree_validate(const bplus_tree_t *tree) {
     if (!tree) return false;
-    
-    // 简化实现：仅检查基本结构
-    if (tree->root && tree->root->num_keys >= BPLUS_ORDER - 1) {
-        return false;  // 节点键数超过限制
-    }
-    
-    return true;
+
+    bplus_node_t *root = atomic_load(&tree->root);
+    if (!root) return false;
+    if (!root->is_leaf && root->num_keys == 0) return false;
+
+    validate_ctx_t ctx = { tree, -1, 0, NULL, true };
+    validate_node(&ctx, root, 1, NULL, NULL);
+    return ctx.ok && ctx.prev_leaf && ctx.prev_leaf->next == NULL && ctx.count == bplus_tree_size(tree) &&
+           ctx.leaf_depth == tree->height;
 }
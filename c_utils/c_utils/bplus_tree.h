@@ -3,25 +3,51 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
-// 可以通过宏定义自定义 B+ 树的阶数
-#ifndef BPLUS_ORDER
-#define BPLUS_ORDER 4
+// 节点按页分配, 默认 4KB (64 位平台上每个节点 168 个键); 可通过宏定义调整, 需为 64 的倍数
+#ifndef BPLUS_NODE_SIZE
+#define BPLUS_NODE_SIZE 4096
 #endif
 
 typedef struct bplus_tree_s bplus_tree_t;
 typedef struct bplus_iterator_s bplus_iterator_t;
 
+// 键前缀函数: 返回保序的 64 位前缀 (compar(a, b) < 0 时 prefix(a) <= prefix(b))
+// 前缀内联保存在节点中, 只有前缀相同时才调用比较函数
+typedef uint64_t (*bplus_key_prefix_fn)(const void *key);
+
+// 整数键范围查询回调, 返回 false 停止遍历
+typedef bool (*bplus_range_u64_cb)(uint64_t key, void *value, void *user_data);
+
+// 并发约定:
+// - 写操作 (insert/delete/bulk_load) 由树内部的互斥锁串行化
+// - 读操作 (get/range_query/min/max/size) 不加锁, 以乐观锁耦合与一个写者并发执行,
+//   读到被修改中的节点时自动重试
+// - 迭代器与 bplus_tree_validate 不能与写操作并发
+// - 指针键模式下, 被删除的键在仍可能有并发读者时不能释放
+
 // 创建 B+ 树
-// compar: 键比较函数
+// compar: 键比较函数, 键以指针形式保存, 调用方需保证键在树中期间有效
 // 返回: 成功返回树指针，失败返回 NULL
 bplus_tree_t* bplus_tree_create(int (*compar)(const void *, const void *));
 
+// 创建带内联键前缀的 B+ 树
+// compar: 键比较函数
+// prefix: 保序前缀函数, 例如字符串的前 8 个字节按大端拼成的整数
+// 返回: 成功返回树指针，失败返回 NULL
+bplus_tree_t* bplus_tree_create_with_prefix(int (*compar)(const void *, const void *), bplus_key_prefix_fn prefix);
+
+// 创建 64 位无符号整数键的 B+ 树
+// 键内联保存在节点中, 节点内使用无分支二分查找; 通用接口的键参数为 const uint64_t *
+// 返回: 成功返回树指针，失败返回 NULL
+bplus_tree_t* bplus_tree_create_u64(void);
+
 // 释放 B+ 树
 // tree: B+ 树
 void bplus_tree_free(bplus_tree_t *tree);
 
-// 插入键值对
+// 插入键值对, 键已存在时替换值
 // tree: B+ 树
 // key: 键指针
 // value: 值指针
@@ -35,11 +61,45 @@ bool bplus_tree_insert(bplus_tree_t *tree, const void *key, void *value);
 void* bplus_tree_get(const bplus_tree_t *tree, const void *key);
 
 // 删除键值对
+// 叶子删空时从父节点摘除 (不做借位与合并), 空的内部节点逐级向上回收
 // tree: B+ 树
 // key: 键指针
 // 返回: 成功返回 true，未找到返回 false
 bool bplus_tree_delete(bplus_tree_t *tree, const void *key);
 
+// 从有序数据批量构建, O(n), 叶子与内部节点均装满
+// tree: 空的 B+ 树
+// keys: 严格递增的键数组
+// values: 值数组
+// count: 元素数量
+// 返回: 成功返回 true; 树非空、键未严格递增或内存不足时返回 false
+bool bplus_tree_bulk_load(bplus_tree_t *tree, const void *const *keys, void *const *values, size_t count);
+
+// 整数键插入, 键已存在时替换值
+// tree: 由 bplus_tree_create_u64 创建的 B+ 树
+// 返回: 成功返回 true，失败返回 false
+bool bplus_tree_insert_u64(bplus_tree_t *tree, uint64_t key, void *value);
+
+// 整数键查找
+// tree: 由 bplus_tree_create_u64 创建的 B+ 树
+// found: 输出是否找到 (可为 NULL), 用于区分值本身为 NULL 的情况
+// 返回: 找到返回值指针，未找到返回 NULL
+void* bplus_tree_get_u64(const bplus_tree_t *tree, uint64_t key, bool *found);
+
+// 整数键删除
+// 返回: 成功返回 true，未找到返回 false
+bool bplus_tree_delete_u64(bplus_tree_t *tree, uint64_t key);
+
+// 整数键批量构建
+// keys: 严格递增的键数组
+// 返回: 成功返回 true，失败返回 false
+bool bplus_tree_bulk_load_u64(bplus_tree_t *tree, const uint64_t *keys, void *const *values, size_t count);
+
+// 整数键范围查询 [start_key, end_key]
+// 返回: 回调返回 true 的元素数量
+size_t bplus_tree_range_query_u64(const bplus_tree_t *tree, uint64_t start_key, uint64_t end_key,
+                                  bplus_range_u64_cb callback, void *user_data);
+
 // 检查 B+ 树是否为空
 // tree: B+ 树
 // 返回: 为空返回 true，否则返回 false
@@ -61,7 +121,7 @@ void bplus_iterator_free(bplus_iterator_t *iter);
 
 // 迭代到下一个元素
 // iter: 迭代器
-// key: 输出键指针
+// key: 输出键指针 (整数键模式下指向节点内的键, 在下一次修改前有效)
 // value: 输出值指针
 // 返回: 有下一个元素返回 true，否则返回 false
 bool bplus_iterator_next(bplus_iterator_t *iter, const void **key, void **value);
@@ -71,31 +131,32 @@ bool bplus_iterator_next(bplus_iterator_t *iter, const void **key, void **value)
 void bplus_iterator_reset(bplus_iterator_t *iter);
 
 // 范围查询
+// 沿叶子链表流式遍历, 不分配内存; 每个叶子先拷贝到栈上并校验版本, 再依次回调
 // tree: B+ 树
-// start_key: 起始键（包含）
-// end_key: 结束键（包含）
-// callback: 回调函数，参数为 (key, value, user_data)
+// start_key: 起始键（包含）, NULL 表示从最小键开始
+// end_key: 结束键（包含）, NULL 表示到最大键为止
+// callback: 回调函数，参数为 (key, value, user_data)，返回 false 停止
 // user_data: 用户数据
-// 返回: 找到的元素数量
+// 返回: 回调返回 true 的元素数量
 size_t bplus_tree_range_query(const bplus_tree_t *tree, const void *start_key, const void *end_key,
                               bool (*callback)(const void *key, void *value, void *user_data),
                               void *user_data);
 
 // 获取最小键
 // tree: B+ 树
-// key: 输出键指针
+// key: 输出键指针 (整数键模式下指向节点内的键, 在下一次修改前有效)
 // value: 输出值指针
 // 返回: 成功返回 true，失败返回 false
 bool bplus_tree_min(const bplus_tree_t *tree, const void **key, void **value);
 
 // 获取最大键
 // tree: B+ 树
-// key: 输出键指针
+// key: 输出键指针 (整数键模式下指向节点内的键, 在下一次修改前有效)
 // value: 输出值指针
 // 返回: 成功返回 true，失败返回 false
 bool bplus_tree_max(const bplus_tree_t *tree, const void **key, void **value);
 
-// 验证 B+ 树结构
+// 验证 B+ 树结构: 键有序、分隔键范围、叶子深度一致、叶子链表与元素计数
 // tree: B+ 树
 // 返回: 结构有效返回 true，无效返回 false
 bool bplus_tree_validate(const bplus_tree_t *tree);
@@ -1,6 +1,14 @@
 #include "chacha20_tiny.h"
 #include <string.h>
 
+#if defined(__x86_64__) || defined(_M_X64) || (defined(__i386__) && defined(__SSE2__))
+#include <immintrin.h>
+#define CHACHA20_HAVE_SSE2 1
+#if defined(__GNUC__)
+#define CHACHA20_HAVE_AVX2 1
+#endif
+#endif
+
 #define ROTL(a,b) (((a) << (b)) | ((a) >> (32 - (b))))
 #define QR(a,b,c,d) ( \
     a += b, d ^= a, d = ROTL(d,16), \
@@ -8,12 +16,487 @@
     a += b, d ^= a, d = ROTL(d, 8), \
     c += d, b ^= c, b = ROTL(b, 7))
 
-void chacha20_tiny(const uint8_t *key, const uint8_t *nonce, uint32_t counter, uint8_t *out, size_t len) {
-    uint32_t state[16];
+static uint32_t load_le32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static void store_le32(uint8_t *p, uint32_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+static void chacha20_setup(uint32_t state[16], const uint8_t *key, const uint8_t *nonce, uint32_t counter) {
     state[0] = 0x61707865; state[1] = 0x3320646e; state[2] = 0x79622d32; state[3] = 0x6b206574;
-    memcpy(&state[4], key, 32);
+    for (int i = 0; i < 8; i++) {
+        state[4 + i] = load_le32(key + 4 * i);
+    }
     state[12] = counter;
-    memcpy(&state[13], nonce, 12);
-    // 简化实现：仅演示状态初始化
-    memset(out, 0, len);
+    for (int i = 0; i < 3; i++) {
+        state[13 + i] = load_le32(nonce + 4 * i);
+    }
+}
+
+// 标量实现: 生成单个 64 字节密钥流块
+static void chacha20_block(const uint32_t state[16], uint8_t out[64]) {
+    uint32_t x[16];
+    memcpy(x, state, sizeof(x));
+    for (int i = 0; i < 10; i++) {
+        QR(x[0], x[4], x[8],  x[12]);
+        QR(x[1], x[5], x[9],  x[13]);
+        QR(x[2], x[6], x[10], x[14]);
+        QR(x[3], x[7], x[11], x[15]);
+        QR(x[0], x[5], x[10], x[15]);
+        QR(x[1], x[6], x[11], x[12]);
+        QR(x[2], x[7], x[8],  x[13]);
+        QR(x[3], x[4], x[9],  x[14]);
+    }
+    for (int i = 0; i < 16; i++) {
+        store_le32(out + 4 * i, x[i] + state[i]);
+    }
+}
+
+#ifdef CHACHA20_HAVE_SSE2
+// SSE2: 每个寄存器保存 4 个块的同一个状态字, 一次生成 4 块
+#define ROTL128(v, n) _mm_or_si128(_mm_slli_epi32(v, n), _mm_srli_epi32(v, 32 - (n)))
+#define QR128(a, b, c, d) do { \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = ROTL128(d, 16); \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = ROTL128(b, 12); \
+    a = _mm_add_epi32(a, b); d = _mm_xor_si128(d, a); d = ROTL128(d, 8);  \
+    c = _mm_add_epi32(c, d); b = _mm_xor_si128(b, c); b = ROTL128(b, 7);  \
+} while (0)
+
+static void chacha20_xor4_sse2(uint32_t state[16], const uint8_t *in, uint8_t *out) {
+    __m128i orig[16], x[16];
+    for (int i = 0; i < 16; i++) {
+        orig[i] = _mm_set1_epi32((int)state[i]);
+    }
+    orig[12] = _mm_add_epi32(orig[12], _mm_set_epi32(3, 2, 1, 0));
+    memcpy(x, orig, sizeof(x));
+
+    for (int i = 0; i < 10; i++) {
+        QR128(x[0], x[4], x[8],  x[12]);
+        QR128(x[1], x[5], x[9],  x[13]);
+        QR128(x[2], x[6], x[10], x[14]);
+        QR128(x[3], x[7], x[11], x[15]);
+        QR128(x[0], x[5], x[10], x[15]);
+        QR128(x[1], x[6], x[11], x[12]);
+        QR128(x[2], x[7], x[8],  x[13]);
+        QR128(x[3], x[4], x[9],  x[14]);
+    }
+
+    // 4x4 转置后每个寄存器是某一块中连续的 4 个字
+    for (int g = 0; g < 16; g += 4) {
+        __m128i a = _mm_add_epi32(x[g], orig[g]);
+        __m128i b = _mm_add_epi32(x[g + 1], orig[g + 1]);
+        __m128i c = _mm_add_epi32(x[g + 2], orig[g + 2]);
+        __m128i d = _mm_add_epi32(x[g + 3], orig[g + 3]);
+        __m128i t0 = _mm_unpacklo_epi32(a, b);
+        __m128i t1 = _mm_unpacklo_epi32(c, d);
+        __m128i t2 = _mm_unpackhi_epi32(a, b);
+        __m128i t3 = _mm_unpackhi_epi32(c, d);
+        __m128i blocks[4] = {
+            _mm_unpacklo_epi64(t0, t1), _mm_unpackhi_epi64(t0, t1),
+            _mm_unpacklo_epi64(t2, t3), _mm_unpackhi_epi64(t2, t3)
+        };
+        for (int j = 0; j < 4; j++) {
+            size_t off = (size_t)j * 64 + (size_t)g * 4;
+            __m128i m = _mm_loadu_si128((const __m128i *)(in + off));
+            _mm_storeu_si128((__m128i *)(out + off), _mm_xor_si128(m, blocks[j]));
+        }
+    }
+    state[12] += 4;
+}
+#endif
+
+#ifdef CHACHA20_HAVE_AVX2
+// AVX2: 一次生成 8 块, 16/8 位循环移位用字节重排实现
+#define ROTL256(v, n) _mm256_or_si256(_mm256_slli_epi32(v, n), _mm256_srli_epi32(v, 32 - (n)))
+#define QR256(a, b, c, d) do { \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = _mm256_shuffle_epi8(d, rot16); \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = ROTL256(b, 12); \
+    a = _mm256_add_epi32(a, b); d = _mm256_xor_si256(d, a); d = _mm256_shuffle_epi8(d, rot8);  \
+    c = _mm256_add_epi32(c, d); b = _mm256_xor_si256(b, c); b = ROTL256(b, 7);  \
+} while (0)
+
+__attribute__((target("avx2")))
+static void chacha20_xor8_avx2(uint32_t state[16], const uint8_t *in, uint8_t *out) {
+    const __m256i rot16 = _mm256_set_epi8(13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2,
+                                          13, 12, 15, 14, 9, 8, 11, 10, 5, 4, 7, 6, 1, 0, 3, 2);
+    const __m256i rot8 = _mm256_set_epi8(14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3,
+                                         14, 13, 12, 15, 10, 9, 8, 11, 6, 5, 4, 7, 2, 1, 0, 3);
+    __m256i orig[16], x[16];
+    for (int i = 0; i < 16; i++) {
+        orig[i] = _mm256_set1_epi32((int)state[i]);
+    }
+    orig[12] = _mm256_add_epi32(orig[12], _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+    memcpy(x, orig, sizeof(x));
+
+    for (int i = 0; i < 10; i++) {
+        QR256(x[0], x[4], x[8],  x[12]);
+        QR256(x[1], x[5], x[9],  x[13]);
+        QR256(x[2], x[6], x[10], x[14]);
+        QR256(x[3], x[7], x[11], x[15]);
+        QR256(x[0], x[5], x[10], x[15]);
+        QR256(x[1], x[6], x[11], x[12]);
+        QR256(x[2], x[7], x[8],  x[13]);
+        QR256(x[3], x[4], x[9],  x[14]);
+    }
+
+    // 每个 128 位通道内做 4x4 转置, 低通道为块 0-3, 高通道为块 4-7
+    for (int g = 0; g < 16; g += 4) {
+        __m256i a = _mm256_add_epi32(x[g], orig[g]);
+        __m256i b = _mm256_add_epi32(x[g + 1], orig[g + 1]);
+        __m256i c = _mm256_add_epi32(x[g + 2], orig[g + 2]);
+        __m256i d = _mm256_add_epi32(x[g + 3], orig[g + 3]);
+        __m256i t0 = _mm256_unpacklo_epi32(a, b);
+        __m256i t1 = _mm256_unpacklo_epi32(c, d);
+        __m256i t2 = _mm256_unpackhi_epi32(a, b);
+        __m256i t3 = _mm256_unpackhi_epi32(c, d);
+        __m256i blocks[4] = {
+            _mm256_unpacklo_epi64(t0, t1), _mm256_unpackhi_epi64(t0, t1),
+            _mm256_unpacklo_epi64(t2, t3), _mm256_unpackhi_epi64(t2, t3)
+        };
+        for (int j = 0; j < 4; j++) {
+            size_t lo = (size_t)j * 64 + (size_t)g * 4;
+            size_t hi = lo + 4 * 64;
+            __m128i m0 = _mm_loadu_si128((const __m128i *)(in + lo));
+            __m128i m1 = _mm_loadu_si128((const __m128i *)(in + hi));
+            _mm_storeu_si128((__m128i *)(out + lo), _mm_xor_si128(m0, _mm256_castsi256_si128(blocks[j])));
+            _mm_storeu_si128((__m128i *)(out + hi), _mm_xor_si128(m1, _mm256_extracti128_si256(blocks[j], 1)));
+        }
+    }
+    state[12] += 8;
+}
+#endif
+
+// 用密钥流异或 blocks 个完整块, state[12] 随之递增
+static void chacha20_xor_blocks(uint32_t state[16], const uint8_t *in, uint8_t *out, size_t blocks) {
+#ifdef CHACHA20_HAVE_AVX2
+    if (blocks >= 8 && __builtin_cpu_supports("avx2")) {
+        while (blocks >= 8) {
+            chacha20_xor8_avx2(state, in, out);
+            in += 8 * CHACHA20_BLOCK_SIZE;
+            out += 8 * CHACHA20_BLOCK_SIZE;
+            blocks -= 8;
+        }
+    }
+#endif
+#ifdef CHACHA20_HAVE_SSE2
+    while (blocks >= 4) {
+        chacha20_xor4_sse2(state, in, out);
+        in += 4 * CHACHA20_BLOCK_SIZE;
+        out += 4 * CHACHA20_BLOCK_SIZE;
+        blocks -= 4;
+    }
+#endif
+    uint8_t ks[CHACHA20_BLOCK_SIZE];
+    while (blocks > 0) {
+        chacha20_block(state, ks);
+        for (int i = 0; i < CHACHA20_BLOCK_SIZE; i++) {
+            out[i] = in[i] ^ ks[i];
+        }
+        state[12]++;
+        in += CHACHA20_BLOCK_SIZE;
+        out += CHACHA20_BLOCK_SIZE;
+        blocks--;
+    }
+}
+
+// 32 位计数器从 counter 开始还能生成的块数, 用完后回绕会重用密钥流
+static uint64_t chacha20_blocks_available(uint32_t counter) {
+    return ((uint64_t)1 << 32) - counter;
+}
+
+void chacha20_tiny(const uint8_t *key, const uint8_t *nonce, uint32_t counter, uint8_t *out, size_t len) {
+    if (!key || !nonce || !out || len == 0) return;
+    if (((uint64_t)len + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE > chacha20_blocks_available(counter)) return;
+    uint32_t state[16];
+    chacha20_setup(state, key, nonce, counter);
+
+    size_t full = len / CHACHA20_BLOCK_SIZE;
+    memset(out, 0, full * CHACHA20_BLOCK_SIZE);
+    chacha20_xor_blocks(state, out, out, full);
+
+    size_t tail = len % CHACHA20_BLOCK_SIZE;
+    if (tail > 0) {
+        uint8_t ks[CHACHA20_BLOCK_SIZE];
+        chacha20_block(state, ks);
+        memcpy(out + full * CHACHA20_BLOCK_SIZE, ks, tail);
+    }
+}
+
+chacha20_error_t chacha20_init(chacha20_context_t *ctx, const uint8_t *key, const uint8_t *nonce, uint32_t counter) {
+    if (!ctx) return CHACHA20_ERROR_NULL_PTR;
+    if (!key) return CHACHA20_ERROR_INVALID_KEY;
+    if (!nonce) return CHACHA20_ERROR_INVALID_NONCE;
+
+    chacha20_setup(ctx->state, key, nonce, counter);
+    ctx->counter = counter;
+    memcpy(ctx->nonce, nonce, CHACHA20_NONCE_SIZE);
+    ctx->buffer_pos = CHACHA20_BLOCK_SIZE;
+    ctx->blocks_left = chacha20_blocks_available(counter);
+    return CHACHA20_OK;
+}
+
+// 处理 len 字节需要新生成的块数 (先用缓冲区中剩余的密钥流)
+static uint64_t chacha20_blocks_needed(const chacha20_context_t *ctx, size_t len) {
+    size_t buffered = CHACHA20_BLOCK_SIZE - ctx->buffer_pos;
+    if (len <= buffered) return 0;
+    return ((uint64_t)(len - buffered) + CHACHA20_BLOCK_SIZE - 1) / CHACHA20_BLOCK_SIZE;
+}
+
+chacha20_error_t chacha20_update(chacha20_context_t *ctx, const uint8_t *in, uint8_t *out, size_t len) {
+    if (!ctx) return CHACHA20_ERROR_NULL_PTR;
+    if (len == 0) return CHACHA20_OK;
+    if (!in || !out) return CHACHA20_ERROR_NULL_PTR;
+    // 计数器不够用时整段拒绝, 不能回绕到 0 重用密钥流
+    uint64_t needed = chacha20_blocks_needed(ctx, len);
+    if (needed > ctx->blocks_left) return CHACHA20_ERROR_INVALID_COUNTER;
+    ctx->blocks_left -= needed;
+
+    // 先用完上次剩余的密钥流
+    while (len > 0 && ctx->buffer_pos < CHACHA20_BLOCK_SIZE) {
+        *out++ = *in++ ^ ctx->buffer[ctx->buffer_pos++];
+        len--;
+    }
+
+    size_t full = len / CHACHA20_BLOCK_SIZE;
+    if (full > 0) {
+        chacha20_xor_blocks(ctx->state, in, out, full);
+        in += full * CHACHA20_BLOCK_SIZE;
+        out += full * CHACHA20_BLOCK_SIZE;
+        len -= full * CHACHA20_BLOCK_SIZE;
+    }
+
+    if (len > 0) {
+        chacha20_block(ctx->state, ctx->buffer);
+        ctx->state[12]++;
+        for (size_t i = 0; i < len; i++) {
+            out[i] = in[i] ^ ctx->buffer[i];
+        }
+        ctx->buffer_pos = len;
+    }
+
+    ctx->counter = ctx->state[12];
+    return CHACHA20_OK;
+}
+
+chacha20_error_t chacha20_encrypt(const uint8_t *key, const uint8_t *nonce, uint32_t counter, const uint8_t *in, uint8_t *out, size_t len) {
+    // 计数器范围由 chacha20_update 检查, 超出时不写入任何输出
+    chacha20_context_t ctx;
+    chacha20_error_t error = chacha20_init(&ctx, key, nonce, counter);
+    if (error == CHACHA20_OK) {
+        error = chacha20_update(&ctx, in, out, len);
+    }
+    memset(&ctx, 0, sizeof(ctx));
+    return error;
+}
+
+/* ---------- ChaCha20-Poly1305 AEAD ---------- */
+
+// AEAD 分段处理数据, 密文在缓存中时立即计算 MAC
+#define AEAD_CHUNK_SIZE 4096
+
+static void aead_pad16(poly1305_ctx_t *mac, uint64_t len) {
+    static const uint8_t zeros[16] = {0};
+    if (len % 16 != 0) {
+        poly1305_update(mac, zeros, 16 - (size_t)(len % 16), NULL);
+    }
+}
+
+static void aead_finish_aad(chacha20_poly1305_ctx_t *ctx) {
+    if (ctx->stage == 0) {
+        aead_pad16(&ctx->mac, ctx->aad_len);
+        ctx->stage = 1;
+    }
+}
+
+static void aead_compute_tag(chacha20_poly1305_ctx_t *ctx, uint8_t tag[CHACHA20_POLY1305_TAG_SIZE]) {
+    uint8_t lengths[16];
+    aead_finish_aad(ctx);
+    aead_pad16(&ctx->mac, ctx->data_len);
+    for (int i = 0; i < 8; i++) {
+        lengths[i] = (uint8_t)(ctx->aad_len >> (8 * i));
+        lengths[8 + i] = (uint8_t)(ctx->data_len >> (8 * i));
+    }
+    poly1305_update(&ctx->mac, lengths, sizeof(lengths), NULL);
+    poly1305_final(&ctx->mac, tag, CHACHA20_POLY1305_TAG_SIZE, NULL);
+    memset(&ctx->cipher, 0, sizeof(ctx->cipher));
+    ctx->stage = 2;
+}
+
+chacha20_error_t chacha20_poly1305_init(chacha20_poly1305_ctx_t *ctx, const uint8_t *key, const uint8_t *nonce) {
+    if (!ctx) return CHACHA20_ERROR_NULL_PTR;
+    if (!key) return CHACHA20_ERROR_INVALID_KEY;
+    if (!nonce) return CHACHA20_ERROR_INVALID_NONCE;
+
+    // 计数器 0 的密钥流前 32 字节作为一次性 Poly1305 密钥, 数据从计数器 1 开始
+    uint8_t block[CHACHA20_BLOCK_SIZE];
+    uint32_t state[16];
+    chacha20_setup(state, key, nonce, 0);
+    chacha20_block(state, block);
+    poly1305_init(&ctx->mac, block, POLY1305_KEY_SIZE, NULL);
+    memset(block, 0, sizeof(block));
+    memset(state, 0, sizeof(state));
+
+    chacha20_init(&ctx->cipher, key, nonce, 1);
+    ctx->aad_len = 0;
+    ctx->data_len = 0;
+    ctx->stage = 0;
+    return CHACHA20_OK;
+}
+
+chacha20_error_t chacha20_poly1305_update_aad(chacha20_poly1305_ctx_t *ctx, const uint8_t *aad, size_t len) {
+    if (!ctx || (!aad && len > 0)) return CHACHA20_ERROR_NULL_PTR;
+    if (ctx->stage != 0) return CHACHA20_ERROR_INVALID_STATE;
+    poly1305_update(&ctx->mac, aad, len, NULL);
+    ctx->aad_len += len;
+    return CHACHA20_OK;
+}
+
+chacha20_error_t chacha20_poly1305_encrypt_update(chacha20_poly1305_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len) {
+    if (!ctx || ((!in || !out) && len > 0)) return CHACHA20_ERROR_NULL_PTR;
+    if (ctx->stage > 1) return CHACHA20_ERROR_INVALID_STATE;
+    // 分段处理前先检查整段, 避免处理到一半才失败
+    if (chacha20_blocks_needed(&ctx->cipher, len) > ctx->cipher.blocks_left) return CHACHA20_ERROR_INVALID_COUNTER;
+    aead_finish_aad(ctx);
+
+    while (len > 0) {
+        size_t n = len < AEAD_CHUNK_SIZE ? len : AEAD_CHUNK_SIZE;
+        chacha20_update(&ctx->cipher, in, out, n);
+        poly1305_update(&ctx->mac, out, n, NULL);
+        in += n;
+        out += n;
+        len -= n;
+        ctx->data_len += n;
+    }
+    return CHACHA20_OK;
+}
+
+chacha20_error_t chacha20_poly1305_decrypt_update(chacha20_poly1305_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len) {
+    if (!ctx || ((!in || !out) && len > 0)) return CHACHA20_ERROR_NULL_PTR;
+    if (ctx->stage > 1) return CHACHA20_ERROR_INVALID_STATE;
+    // 分段处理前先检查整段, 避免处理到一半才失败
+    if (chacha20_blocks_needed(&ctx->cipher, len) > ctx->cipher.blocks_left) return CHACHA20_ERROR_INVALID_COUNTER;
+    aead_finish_aad(ctx);
+
+    // 先对密文计算 MAC, 允许 in 与 out 是同一缓冲区
+    while (len > 0) {
+        size_t n = len < AEAD_CHUNK_SIZE ? len : AEAD_CHUNK_SIZE;
+        poly1305_update(&ctx->mac, in, n, NULL);
+        chacha20_update(&ctx->cipher, in, out, n);
+        in += n;
+        out += n;
+        len -= n;
+        ctx->data_len += n;
+    }
+    return CHACHA20_OK;
+}
+
+chacha20_error_t chacha20_poly1305_encrypt_final(chacha20_poly1305_ctx_t *ctx, uint8_t *tag) {
+    if (!ctx || !tag) return CHACHA20_ERROR_NULL_PTR;
+    if (ctx->stage > 1) return CHACHA20_ERROR_INVALID_STATE;
+    aead_compute_tag(ctx, tag);
+    return CHACHA20_OK;
+}
+
+chacha20_error_t chacha20_poly1305_decrypt_final(chacha20_poly1305_ctx_t *ctx, const uint8_t *tag) {
+    if (!ctx || !tag) return CHACHA20_ERROR_NULL_PTR;
+    if (ctx->stage > 1) return CHACHA20_ERROR_INVALID_STATE;
+
+    uint8_t expected[CHACHA20_POLY1305_TAG_SIZE];
+    aead_compute_tag(ctx, expected);
+
+    // 常数时间比较
+    uint8_t diff = 0;
+    for (int i = 0; i < CHACHA20_POLY1305_TAG_SIZE; i++) {
+        diff |= (uint8_t)(expected[i] ^ tag[i]);
+    }
+    return diff == 0 ? CHACHA20_OK : CHACHA20_ERROR_AUTH_FAILED;
+}
+
+chacha20_error_t chacha20_poly1305_encrypt(const uint8_t *key, const uint8_t *nonce,
+                                           const uint8_t *aad, size_t aad_len,
+                                           const uint8_t *in, uint8_t *out, size_t len, uint8_t *tag) {
+    chacha20_poly1305_ctx_t ctx;
+    chacha20_error_t error = chacha20_poly1305_init(&ctx, key, nonce);
+    if (error == CHACHA20_OK) error = chacha20_poly1305_update_aad(&ctx, aad, aad_len);
+    if (error == CHACHA20_OK) error = chacha20_poly1305_encrypt_update(&ctx, in, out, len);
+    if (error == CHACHA20_OK) error = chacha20_poly1305_encrypt_final(&ctx, tag);
+    memset(&ctx, 0, sizeof(ctx));
+    return error;
+}
+
+chacha20_error_t chacha20_poly1305_decrypt(const uint8_t *key, const uint8_t *nonce,
+                                           const uint8_t *aad, size_t aad_len,
+                                           const uint8_t *in, uint8_t *out, size_t len, const uint8_t *tag) {
+    if ((!in || !out) && len > 0) return CHACHA20_ERROR_NULL_PTR;
+    if (!tag) return CHACHA20_ERROR_NULL_PTR;
+
+    chacha20_poly1305_ctx_t ctx;
+    chacha20_error_t error = chacha20_poly1305_init(&ctx, key, nonce);
+    if (error == CHACHA20_OK) error = chacha20_poly1305_update_aad(&ctx, aad, aad_len);
+    if (error != CHACHA20_OK) return error;
+
+    if (chacha20_blocks_needed(&ctx.cipher, len) > ctx.cipher.blocks_left) {
+        memset(&ctx, 0, sizeof(ctx));
+        return CHACHA20_ERROR_INVALID_COUNTER;
+    }
+
+    // 先只计算 MAC, 验证通过后才解密, 失败时不输出任何明文
+    aead_finish_aad(&ctx);
+    poly1305_update(&ctx.mac, in, len, NULL);
+    ctx.data_len = len;
+    chacha20_context_t cipher = ctx.cipher;
+    error = chacha20_poly1305_decrypt_final(&ctx, tag);
+    if (error == CHACHA20_OK) {
+        chacha20_update(&cipher, in, out, len);
+    }
+    memset(&cipher, 0, sizeof(cipher));
+    memset(&ctx, 0, sizeof(ctx));
+    return error;
+}
+
+const char* chacha20_strerror(chacha20_error_t error) {
+    switch (error) {
+        case CHACHA20_OK: return "Success";
+        case CHACHA20_ERROR_INVALID_KEY: return "Invalid key";
+        case CHACHA20_ERROR_INVALID_NONCE: return "Invalid nonce";
+        case CHACHA20_ERROR_INVALID_COUNTER: return "Invalid counter";
+        case CHACHA20_ERROR_INVALID_LENGTH: return "Invalid length";
+        case CHACHA20_ERROR_NULL_PTR: return "Null pointer";
+        case CHACHA20_ERROR_AUTH_FAILED: return "Authentication failed";
+        case CHACHA20_ERROR_INVALID_STATE: return "Invalid state";
+        default: return "Unknown error";
+    }
+}
+
+bool chacha20_validate_test_vectors(void) {
+    // RFC 8439 2.3.2 块函数测试向量
+    uint8_t key[32];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)i;
+    const uint8_t nonce[12] = {0, 0, 0, 0x09, 0, 0, 0, 0x4a, 0, 0, 0, 0};
+    static const uint8_t expected[64] = {
+        0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4,
+        0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0, 0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e,
+        0xd2, 0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05, 0xd9, 0x8b, 0x02, 0xa2,
+        0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e, 0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e
+    };
+    uint8_t out[64];
+    chacha20_tiny(key, nonce, 1, out, sizeof(out));
+    if (memcmp(out, expected, sizeof(expected)) != 0) return false;
+
+    // 多块路径必须与标量逐块结果一致
+    uint8_t bulk[16 * CHACHA20_BLOCK_SIZE];
+    chacha20_tiny(key, nonce, 1, bulk, sizeof(bulk));
+    uint32_t state[16];
+    chacha20_setup(state, key, nonce, 1);
+    for (int i = 0; i < 16; i++) {
+        chacha20_block(state, out);
+        state[12]++;
+        if (memcmp(out, bulk + i * CHACHA20_BLOCK_SIZE, CHACHA20_BLOCK_SIZE) != 0) return false;
+    }
+    return true;
 }
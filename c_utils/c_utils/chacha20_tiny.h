@@ -4,6 +4,12 @@
 #include <stdint.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include "poly1305_tiny.h"
+
+#define CHACHA20_KEY_SIZE 32
+#define CHACHA20_NONCE_SIZE 12
+#define CHACHA20_BLOCK_SIZE 64
+#define CHACHA20_POLY1305_TAG_SIZE 16
 
 // ChaCha20 上下文
 typedef struct {
@@ -12,6 +18,7 @@ typedef struct {
     uint8_t  nonce[12];
     uint8_t  buffer[64];
     size_t   buffer_pos;
+    uint64_t blocks_left;    // 计数器回绕前还能生成的块数 (2^32 - 初始计数器)
 } chacha20_context_t;
 
 // ChaCha20 错误码
@@ -20,9 +27,27 @@ typedef enum {
     CHACHA20_ERROR_INVALID_KEY,
     CHACHA20_ERROR_INVALID_NONCE,
     CHACHA20_ERROR_INVALID_COUNTER,
-    CHACHA20_ERROR_INVALID_LENGTH
+    CHACHA20_ERROR_INVALID_LENGTH,
+    CHACHA20_ERROR_NULL_PTR,
+    CHACHA20_ERROR_AUTH_FAILED,
+    CHACHA20_ERROR_INVALID_STATE
 } chacha20_error_t;
 
+// ChaCha20-Poly1305 AEAD 流式上下文 (RFC 8439)
+// 用法: init -> update_aad (可多次) -> encrypt_update/decrypt_update (可多次) -> final
+typedef struct {
+    chacha20_context_t cipher;
+    poly1305_ctx_t mac;
+    uint64_t aad_len;
+    uint64_t data_len;
+    int stage;               // 0: 接收 AAD, 1: 处理数据, 2: 已结束
+} chacha20_poly1305_ctx_t;
+
+// 生成 ChaCha20 密钥流 (RFC 8439), 写入 len 字节到 out
+// x86-64 上按 CPU 能力使用 AVX2 (8 块) 或 SSE2 (4 块) 并行生成
+// 32 位计数器不回绕: counter + ceil(len / 64) 超过 2^32 时不写入任何数据
+void chacha20_tiny(const uint8_t *key, const uint8_t *nonce, uint32_t counter, uint8_t *out, size_t len);
+
 // 初始化 ChaCha20 上下文
 // ctx: 上下文指针
 // key: 密钥（必须是 32 字节）
@@ -37,6 +62,7 @@ chacha20_error_t chacha20_init(chacha20_context_t *ctx, const uint8_t *key, cons
 // out: 输出数据
 // len: 数据长度
 // 返回: 成功返回 CHACHA20_OK，失败返回错误码
+//       所需块数超出计数器剩余范围时返回 CHACHA20_ERROR_INVALID_COUNTER, 不处理任何数据
 chacha20_error_t chacha20_update(chacha20_context_t *ctx, const uint8_t *in, uint8_t *out, size_t len);
 
 // 一次性 ChaCha20 加密/解密
@@ -46,9 +72,32 @@ chacha20_error_t chacha20_update(chacha20_context_t *ctx, const uint8_t *in, uin
 // in: 输入数据
 // out: 输出数据
 // len: 数据长度
-// 返回: 成功返回 CHACHA20_OK，失败返回错误码
+// 返回: 成功返回 CHACHA20_OK，失败返回错误码; counter + ceil(len / 64) 超过 2^32 时返回 CHACHA20_ERROR_INVALID_COUNTER
 chacha20_error_t chacha20_encrypt(const uint8_t *key, const uint8_t *nonce, uint32_t counter, const uint8_t *in, uint8_t *out, size_t len);
 
+// 一次性 ChaCha20-Poly1305 加密
+// aad: 附加认证数据 (可为 NULL, 此时 aad_len 须为 0)
+// in/out: 明文/密文, 可以是同一缓冲区
+// tag: 16 字节认证标签输出
+chacha20_error_t chacha20_poly1305_encrypt(const uint8_t *key, const uint8_t *nonce,
+                                           const uint8_t *aad, size_t aad_len,
+                                           const uint8_t *in, uint8_t *out, size_t len, uint8_t *tag);
+
+// 一次性 ChaCha20-Poly1305 解密, 先验证标签再解密
+// 标签不匹配时返回 CHACHA20_ERROR_AUTH_FAILED, 且不写 out
+chacha20_error_t chacha20_poly1305_decrypt(const uint8_t *key, const uint8_t *nonce,
+                                           const uint8_t *aad, size_t aad_len,
+                                           const uint8_t *in, uint8_t *out, size_t len, const uint8_t *tag);
+
+// 流式 AEAD
+chacha20_error_t chacha20_poly1305_init(chacha20_poly1305_ctx_t *ctx, const uint8_t *key, const uint8_t *nonce);
+chacha20_error_t chacha20_poly1305_update_aad(chacha20_poly1305_ctx_t *ctx, const uint8_t *aad, size_t len);
+chacha20_error_t chacha20_poly1305_encrypt_update(chacha20_poly1305_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len);
+chacha20_error_t chacha20_poly1305_encrypt_final(chacha20_poly1305_ctx_t *ctx, uint8_t *tag);
+// 流式解密在 final 验证标签之前就输出明文, 调用方须在 final 成功后才使用这些数据
+chacha20_error_t chacha20_poly1305_decrypt_update(chacha20_poly1305_ctx_t *ctx, const uint8_t *in, uint8_t *out, size_t len);
+chacha20_error_t chacha20_poly1305_decrypt_final(chacha20_poly1305_ctx_t *ctx, const uint8_t *tag);
+
 // 获取错误信息
 // error: 错误码
 // 返回: 错误信息字符串
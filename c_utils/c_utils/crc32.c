@@ -3,13 +3,13 @@
 #include <string.h>
 #include <stdio.h>
 
-// CRC32 标准表
-static uint32_t crc32_standard_table[256];
-static uint32_t crc32c_table[256];
+// CRC32 表, 每种变体 8 张, 第 0 张为标准逐字节表, 其余用于 slicing-by-8
+static uint32_t crc32_standard_table[8][256];
+static uint32_t crc32c_table[8][256];
 static int tables_computed = 0;
 
 // 生成 CRC32 表
-static void make_crc32_table(uint32_t *table, uint32_t polynomial) {
+static void make_crc32_table(uint32_t table[8][256], uint32_t polynomial) {
     uint32_t c;
     for (int n = 0; n < 256; n++) {
         c = (uint32_t)n;
@@ -17,7 +17,14 @@ static void make_crc32_table(uint32_t *table, uint32_t polynomial) {
             if (c & 1) c = polynomial ^ (c >> 1);
             else c = c >> 1;
         }
-        table[n] = c;
+        table[0][n] = c;
+    }
+    for (int n = 0; n < 256; n++) {
+        c = table[0][n];
+        for (int k = 1; k < 8; k++) {
+            c = table[0][c & 0xff] ^ (c >> 8);
+            table[k][n] = c;
+        }
     }
 }
 
@@ -40,10 +47,10 @@ bool crc32_init(crc32_context_t *ctx, crc32_variant_t variant, crc32_error_t *er
     
     switch (variant) {
         case CRC32_STANDARD:
-            ctx->table = crc32_standard_table;
+            ctx->table = crc32_standard_table[0];
             break;
         case CRC32_C:
-            ctx->table = crc32c_table;
+            ctx->table = crc32c_table[0];
             break;
         default:
             if (error) *error = CRC32_ERROR_UNSUPPORTED_VARIANT;
@@ -64,9 +71,30 @@ bool crc32_update(crc32_context_t *ctx, const void *data, size_t len) {
     }
     
     const uint8_t *p = (const uint8_t *)data;
+    uint32_t crc = ctx->crc;
+    const uint32_t (*t)[256] = NULL;
+    if (ctx->table == crc32_standard_table[0]) t = crc32_standard_table;
+    else if (ctx->table == crc32c_table[0]) t = crc32c_table;
+    
+    // slicing-by-8: 每次处理 8 字节, 按字节组装保证与字节序无关
+    if (t) {
+        while (len >= 8) {
+            uint32_t one = crc ^ ((uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+                                  ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24));
+            uint32_t two = (uint32_t)p[4] | ((uint32_t)p[5] << 8) |
+                           ((uint32_t)p[6] << 16) | ((uint32_t)p[7] << 24);
+            crc = t[7][one & 0xff] ^ t[6][(one >> 8) & 0xff] ^
+                  t[5][(one >> 16) & 0xff] ^ t[4][one >> 24] ^
+                  t[3][two & 0xff] ^ t[2][(two >> 8) & 0xff] ^
+                  t[1][(two >> 16) & 0xff] ^ t[0][two >> 24];
+            p += 8;
+            len -= 8;
+        }
+    }
     while (len--) {
-        ctx->crc = ctx->table[(ctx->crc ^ *p++) & 0xff] ^ (ctx->crc >> 8);
+        crc = ctx->table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
     }
+    ctx->crc = crc;
     
     return true;
 }
@@ -137,9 +165,9 @@ const uint32_t* crc32_get_table(crc32_variant_t variant) {
     init_tables();
     switch (variant) {
         case CRC32_STANDARD:
-            return crc32_standard_table;
+            return crc32_standard_table[0];
         case CRC32_C:
-            return crc32c_table;
+            return crc32c_table[0];
         default:
             return NULL;
     }
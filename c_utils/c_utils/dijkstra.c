@@ -1,7 +1,9 @@
 #include "dijkstra.h"
+#include "graph_heap_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <limits.h>
+#include <stdint.h>
 
 // 创建图
 dijkstra_graph_t* dijkstra_graph_create(size_t nodes, dijkstra_error_t *error) {
@@ -74,66 +76,453 @@ bool dijkstra_graph_add_edge(dijkstra_graph_t *graph, int src, int dest, int wei
     return true;
 }
 
+// 搜索工作区: dist/pos 在搜索之间保持 "全部未访问" 状态, touched 记录入过堆的节点用于增量重置
+typedef struct {
+    int *dist;
+    int *pred;
+    graph_heap_t heap;   // 四叉堆, 键为距离; pos 为 GRAPH_POS_DONE 时距离已确定
+    int *touched;
+    size_t touched_count;
+} dijkstra_ws_t;
+
+static inline void ws_push(dijkstra_ws_t *ws, int v, int d) {
+    if (ws->touched) ws->touched[ws->touched_count++] = v;
+    graph_heap_push(&ws->heap, v, d);
+}
+
+static void ws_reset(dijkstra_ws_t *ws) {
+    for (size_t i = 0; i < ws->touched_count; i++) {
+        int v = ws->touched[i];
+        ws->dist[v] = INT_MAX;
+        ws->heap.pos[v] = GRAPH_POS_NONE;
+    }
+    ws->touched_count = 0;
+    ws->heap.size = 0;
+}
+
+// 单源搜索: target 出堆或 goal 中标记的节点全部出堆后结束
+// 返回: 遇到负权边返回 false
+static bool csr_search(const graph_csr_t *graph, dijkstra_ws_t *ws, int start, int target,
+                       const unsigned char *goal, size_t goal_count) {
+    int *dist = ws->dist;
+    int *pred = ws->pred;
+    int *pos = ws->heap.pos;
+
+    dist[start] = 0;
+    if (pred) pred[start] = -1;
+    ws_push(ws, start, 0);
+
+    while (ws->heap.size > 0) {
+        int u = graph_heap_pop(&ws->heap);
+        if (u == target) break;
+        if (goal && goal[u] && --goal_count == 0) break;
+
+        int du = dist[u];
+        const int *to, *weight;
+        size_t degree = graph_csr_neighbors(graph, u, &to, &weight);
+        for (size_t i = 0; i < degree; i++) {
+            int v = to[i];
+            int w = weight[i];
+            if (w < 0) return false;
+            if (pos[v] == GRAPH_POS_DONE || w > INT_MAX - 1 - du) continue;
+            int nd = du + w;
+            if (nd >= dist[v]) continue;
+            dist[v] = nd;
+            if (pred) pred[v] = u;
+            if (pos[v] == GRAPH_POS_NONE) {
+                ws_push(ws, v, nd);
+            } else {
+                graph_heap_decrease(&ws->heap, v, nd);
+            }
+        }
+    }
+    return true;
+}
+
+// 邻接表转换为 CSR
+graph_csr_t* dijkstra_graph_to_csr(const dijkstra_graph_t *graph) {
+    if (!graph) return NULL;
+
+    size_t edges = 0;
+    for (size_t u = 0; u < graph->nodes; u++) {
+        for (const dijkstra_edge_s *e = graph->adj[u]; e; e = (const dijkstra_edge_s *)e->next) edges++;
+    }
+
+    graph_csr_t *csr = calloc(1, sizeof(graph_csr_t));
+    if (!csr) return NULL;
+    csr->nodes = graph->nodes;
+    csr->edges = edges;
+    csr->offsets = malloc((graph->nodes + 1) * sizeof(size_t));
+    csr->targets = malloc((edges ? edges : 1) * sizeof(int));
+    csr->weights = malloc((edges ? edges : 1) * sizeof(int));
+    if (!csr->offsets || !csr->targets || !csr->weights) {
+        graph_csr_free(csr);
+        return NULL;
+    }
+
+    size_t at = 0;
+    for (size_t u = 0; u < graph->nodes; u++) {
+        csr->offsets[u] = at;
+        for (const dijkstra_edge_s *e = graph->adj[u]; e; e = (const dijkstra_edge_s *)e->next) {
+            csr->targets[at] = e->dest;
+            csr->weights[at] = e->weight;
+            at++;
+        }
+    }
+    csr->offsets[graph->nodes] = at;
+    return csr;
+}
+
 // 执行 Dijkstra 算法
 bool dijkstra(dijkstra_graph_t *graph, int start, int *dist, int *pred, dijkstra_error_t *error) {
     if (!graph || !dist) {
         if (error) *error = DIJKSTRA_ERROR_INVALID_PARAM;
         return false;
     }
-    
+
     if (start < 0 || start >= (int)graph->nodes) {
         if (error) *error = DIJKSTRA_ERROR_INVALID_NODE;
         return false;
     }
-    
-    bool *visited = calloc(graph->nodes, sizeof(bool));
-    if (!visited) {
+
+    graph_csr_t *csr = dijkstra_graph_to_csr(graph);
+    if (!csr) {
         if (error) *error = DIJKSTRA_ERROR_MEMORY_ALLOC;
         return false;
     }
-    
+
+    bool ok = dijkstra_csr(csr, start, -1, dist, pred, error);
+    graph_csr_free(csr);
+    return ok;
+}
+
+// CSR 单源最短路
+bool dijkstra_csr(const graph_csr_t *graph, int start, int target, int *dist, int *pred, dijkstra_error_t *error) {
+    if (!graph || !dist) {
+        if (error) *error = DIJKSTRA_ERROR_INVALID_PARAM;
+        return false;
+    }
+
+    if (graph->nodes == 0) {
+        if (error) *error = DIJKSTRA_ERROR_GRAPH_EMPTY;
+        return false;
+    }
+
+    if (start < 0 || (size_t)start >= graph->nodes || target < -1 || (target >= 0 && (size_t)target >= graph->nodes)) {
+        if (error) *error = DIJKSTRA_ERROR_INVALID_NODE;
+        return false;
+    }
+
+    dijkstra_ws_t ws = { .dist = dist, .pred = pred };
+    if (!graph_heap_init(&ws.heap, graph->nodes)) {
+        graph_heap_free(&ws.heap);
+        if (error) *error = DIJKSTRA_ERROR_MEMORY_ALLOC;
+        return false;
+    }
+
     // 初始化
     for (size_t i = 0; i < graph->nodes; i++) {
         dist[i] = INT_MAX;
         if (pred) pred[i] = -1;
     }
-    dist[start] = 0;
-    
-    // 主循环
-    for (size_t count = 0; count < graph->nodes - 1; count++) {
-        // 找到最小距离节点
-        int min_dist = INT_MAX;
-        int u = -1;
-        for (size_t v = 0; v < graph->nodes; v++) {
-            if (!visited[v] && dist[v] < min_dist) {
-                min_dist = dist[v];
-                u = (int)v;
-            }
+
+    bool ok = csr_search(graph, &ws, start, target, NULL, 0);
+    graph_heap_free(&ws.heap);
+
+    if (error) *error = ok ? DIJKSTRA_OK : DIJKSTRA_ERROR_NEGATIVE_WEIGHT;
+    return ok;
+}
+
+// 多源多目标: 每个工作任务持有一个工作区, 从共享计数器领取下一个源点
+typedef struct {
+    const graph_csr_t *graph;
+    const int *sources;
+    size_t source_count;
+    const int *targets;
+    size_t target_count;
+    const unsigned char *goal;
+    size_t goal_count;
+    int *out;
+    size_t next;
+    int failed;         // dijkstra_error_t, 任意任务失败即记录
+} m2m_shared_t;
+
+static void m2m_worker(void *arg) {
+    m2m_shared_t *sh = arg;
+    size_t nodes = sh->graph->nodes;
+    dijkstra_ws_t ws = {0};
+    ws.dist = malloc(nodes * sizeof(int));
+    ws.touched = malloc(nodes * sizeof(int));
+    if (!graph_heap_init(&ws.heap, nodes) || !ws.dist || !ws.touched) {
+        __atomic_store_n(&sh->failed, DIJKSTRA_ERROR_MEMORY_ALLOC, __ATOMIC_RELAXED);
+        goto done;
+    }
+    for (size_t i = 0; i < nodes; i++) ws.dist[i] = INT_MAX;
+
+    for (;;) {
+        size_t s = __atomic_fetch_add(&sh->next, 1, __ATOMIC_RELAXED);
+        if (s >= sh->source_count || __atomic_load_n(&sh->failed, __ATOMIC_RELAXED)) break;
+        if (!csr_search(sh->graph, &ws, sh->sources[s], -1, sh->goal, sh->goal_count)) {
+            __atomic_store_n(&sh->failed, DIJKSTRA_ERROR_NEGATIVE_WEIGHT, __ATOMIC_RELAXED);
+            break;
         }
-        
-        if (u == -1) break; // 所有可达节点都已处理
-        
-        visited[u] = true;
-        
-        // 更新邻接节点距离
-        dijkstra_edge_s *edge = graph->adj[u];
-        while (edge) {
-            int v = edge->dest;
-            if (!visited[v] && dist[u] != INT_MAX && 
-                dist[u] + edge->weight < dist[v]) {
-                dist[v] = dist[u] + edge->weight;
-                if (pred) pred[v] = u;
+        // 目标要么已出堆, 要么堆已耗尽 (不可达), 距离都是最终值
+        int *row = sh->out + s * sh->target_count;
+        for (size_t j = 0; j < sh->target_count; j++) row[j] = ws.dist[sh->targets[j]];
+        ws_reset(&ws);
+    }
+
+done:
+    graph_heap_free(&ws.heap);
+    free(ws.dist);
+    free(ws.touched);
+}
+
+bool dijkstra_many_to_many(const graph_csr_t *graph, const int *sources, size_t source_count,
+                           const int *targets, size_t target_count, int *out,
+                           threadpool_t *pool, dijkstra_error_t *error) {
+    if (!graph || (source_count && !sources) || (target_count && !targets) || (source_count && target_count && !out)) {
+        if (error) *error = DIJKSTRA_ERROR_INVALID_PARAM;
+        return false;
+    }
+
+    for (size_t i = 0; i < source_count; i++) {
+        if (sources[i] < 0 || (size_t)sources[i] >= graph->nodes) {
+            if (error) *error = DIJKSTRA_ERROR_INVALID_NODE;
+            return false;
+        }
+    }
+    for (size_t j = 0; j < target_count; j++) {
+        if (targets[j] < 0 || (size_t)targets[j] >= graph->nodes) {
+            if (error) *error = DIJKSTRA_ERROR_INVALID_NODE;
+            return false;
+        }
+    }
+
+    if (source_count == 0 || target_count == 0) {
+        if (error) *error = DIJKSTRA_OK;
+        return true;
+    }
+
+    // 目标集合去重, 用于判断何时可以提前结束
+    unsigned char *goal = calloc(graph->nodes, 1);
+    if (!goal) {
+        if (error) *error = DIJKSTRA_ERROR_MEMORY_ALLOC;
+        return false;
+    }
+    size_t goal_count = 0;
+    for (size_t j = 0; j < target_count; j++) {
+        if (!goal[targets[j]]) {
+            goal[targets[j]] = 1;
+            goal_count++;
+        }
+    }
+
+    m2m_shared_t shared = {
+        .graph = graph, .sources = sources, .source_count = source_count,
+        .targets = targets, .target_count = target_count,
+        .goal = goal, .goal_count = goal_count, .out = out,
+        .next = 0, .failed = DIJKSTRA_OK
+    };
+
+    threadpool_t *own_pool = NULL;
+    size_t workers = 1;
+    if (source_count > 1) {
+        if (!pool) {
+            own_pool = threadpool_create(0);
+            pool = own_pool;
+        }
+        if (pool) workers = (size_t)threadpool_get_thread_count(pool);
+        if (workers > source_count) workers = source_count;
+        if (workers == 0) workers = 1;
+    }
+
+    if (workers == 1) {
+        m2m_worker(&shared);
+    } else {
+        int *task_ids = calloc(workers, sizeof(int));
+        for (size_t i = 0; i < workers; i++) {
+            int id = task_ids ? threadpool_add_task(pool, m2m_worker, &shared) : 0;
+            if (id == 0) {
+                m2m_worker(&shared);
+            } else {
+                task_ids[i] = id;
             }
-            edge = edge->next;
         }
+        for (size_t i = 0; task_ids && i < workers; i++) {
+            if (task_ids[i] != 0) threadpool_wait_task(pool, task_ids[i], -1);
+        }
+        free(task_ids);
     }
-    
-    free(visited);
-    
-    if (error) *error = DIJKSTRA_OK;
+
+    if (own_pool) threadpool_destroy(own_pool);
+    free(goal);
+
+    if (error) *error = (dijkstra_error_t)shared.failed;
+    return shared.failed == DIJKSTRA_OK;
+}
+
+// delta-stepping: 距离在高 32 位, 前驱在低 32 位
+#define DS_PACK(d, p) ((int64_t)(((uint64_t)(uint32_t)(d) << 32) | (uint32_t)(p)))
+#define DS_DIST(s) ((int)((s) >> 32))
+#define DS_PRED(s) ((int)(uint32_t)(s))
+#define DS_MAX_BUCKETS 4096
+
+typedef struct {
+    int *items;
+    size_t count;
+    size_t capacity;
+} ds_vec_t;
+
+static bool ds_vec_push(ds_vec_t *v, int item) {
+    if (v->count == v->capacity) {
+        size_t capacity = v->capacity ? v->capacity * 2 : 256;
+        int *items = realloc(v->items, capacity * sizeof(int));
+        if (!items) return false;
+        v->items = items;
+        v->capacity = capacity;
+    }
+    v->items[v->count++] = item;
     return true;
 }
 
+typedef struct {
+    const graph_csr_t *graph;
+    int64_t *state;
+    const int *frontier;
+    ds_vec_t *improved;     // 每个任务一个, 记录本轮距离变小的节点
+    int failed;
+} ds_ctx_t;
+
+static void ds_relax(void *arg, size_t begin, size_t end, int worker) {
+    ds_ctx_t *c = arg;
+    ds_vec_t *out = &c->improved[worker];
+    for (size_t i = begin; i < end; i++) {
+        int u = c->frontier[i];
+        int du = DS_DIST(__atomic_load_n(&c->state[u], __ATOMIC_RELAXED));
+        const int *to, *weight;
+        size_t degree = graph_csr_neighbors(c->graph, u, &to, &weight);
+        for (size_t k = 0; k < degree; k++) {
+            int v = to[k];
+            if (weight[k] > INT_MAX - 1 - du) continue;
+            int nd = du + weight[k];
+            int64_t desired = DS_PACK(nd, u);
+            int64_t cur = __atomic_load_n(&c->state[v], __ATOMIC_RELAXED);
+            while (nd < DS_DIST(cur)) {
+                if (__atomic_compare_exchange_n(&c->state[v], &cur, desired, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                    if (!ds_vec_push(out, v)) __atomic_store_n(&c->failed, 1, __ATOMIC_RELAXED);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+bool dijkstra_delta_stepping(const graph_csr_t *graph, int start, int delta, int *dist, int *pred,
+                             threadpool_t *pool, dijkstra_error_t *error) {
+    if (!graph || !dist) {
+        if (error) *error = DIJKSTRA_ERROR_INVALID_PARAM;
+        return false;
+    }
+    if (graph->nodes == 0) {
+        if (error) *error = DIJKSTRA_ERROR_GRAPH_EMPTY;
+        return false;
+    }
+    if (start < 0 || (size_t)start >= graph->nodes) {
+        if (error) *error = DIJKSTRA_ERROR_INVALID_NODE;
+        return false;
+    }
+
+    int max_weight = 0;
+    for (size_t i = 0; i < graph->edges; i++) {
+        if (graph->weights[i] < 0) {
+            if (error) *error = DIJKSTRA_ERROR_NEGATIVE_WEIGHT;
+            return false;
+        }
+        if (graph->weights[i] > max_weight) max_weight = graph->weights[i];
+    }
+    if (delta <= 0) {
+        size_t avg_degree = graph->edges / graph->nodes;
+        delta = (int)(max_weight / (avg_degree ? avg_degree : 1));
+    }
+    if (delta <= 0) delta = 1;
+    // 新距离不超过当前桶上界加最大边权, 桶数组按 max_weight / delta + 2 循环使用
+    if (max_weight / delta + 2 > DS_MAX_BUCKETS) delta = max_weight / (DS_MAX_BUCKETS - 2) + 1;
+    size_t bucket_count = (size_t)(max_weight / delta) + 2;
+
+    size_t n = graph->nodes;
+    int workers = graph_csr_worker_count(pool);
+    int64_t *state = malloc(n * sizeof(int64_t));
+    unsigned *stamp = calloc(n, sizeof(unsigned));
+    ds_vec_t *buckets = calloc(bucket_count, sizeof(ds_vec_t));
+    ds_vec_t *improved = calloc((size_t)workers, sizeof(ds_vec_t));
+    ds_vec_t frontier = {0};
+    bool ok = state && stamp && buckets && improved;
+
+    if (ok) {
+        for (size_t i = 0; i < n; i++) state[i] = DS_PACK(INT_MAX, -1);
+        state[start] = DS_PACK(0, -1);
+        ok = ds_vec_push(&buckets[0], start);
+    }
+
+    ds_ctx_t c = { .graph = graph, .state = state, .improved = improved };
+    size_t pending = ok ? 1 : 0;
+    size_t current = 0;         // 当前桶的绝对编号
+    unsigned phase = 0;
+    while (ok && pending > 0) {
+        ds_vec_t *bucket = &buckets[current % bucket_count];
+        if (bucket->count == 0) {
+            current++;
+            continue;
+        }
+
+        // 取出整个桶, 丢弃已移到更小桶的过期项和本轮重复项
+        phase++;
+        pending -= bucket->count;
+        frontier.count = 0;
+        for (size_t i = 0; i < bucket->count && ok; i++) {
+            int v = bucket->items[i];
+            if ((size_t)(DS_DIST(state[v]) / delta) != current || stamp[v] == phase) continue;
+            stamp[v] = phase;
+            ok = ds_vec_push(&frontier, v);
+        }
+        bucket->count = 0;
+        if (!ok || frontier.count == 0) continue;
+
+        c.frontier = frontier.items;
+        graph_csr_parallel_for(pool, frontier.count, 64, ds_relax, &c);
+        ok = !c.failed;
+
+        for (int w = 0; w < workers && ok; w++) {
+            for (size_t i = 0; i < improved[w].count && ok; i++) {
+                int v = improved[w].items[i];
+                size_t b = (size_t)(DS_DIST(state[v]) / delta);
+                ok = ds_vec_push(&buckets[b % bucket_count], v);
+                pending++;
+            }
+            improved[w].count = 0;
+        }
+    }
+
+    if (ok) {
+        for (size_t i = 0; i < n; i++) {
+            dist[i] = DS_DIST(state[i]);
+            if (pred) pred[i] = DS_PRED(state[i]);
+        }
+    }
+
+    for (size_t i = 0; buckets && i < bucket_count; i++) free(buckets[i].items);
+    for (int w = 0; improved && w < workers; w++) free(improved[w].items);
+    free(frontier.items);
+    free(buckets);
+    free(improved);
+    free(stamp);
+    free(state);
+
+    if (error) *error = ok ? DIJKSTRA_OK : DIJKSTRA_ERROR_MEMORY_ALLOC;
+    return ok;
+}
+
 // 重建路径
 bool dijkstra_reconstruct_path(const int *pred, int start, int end, int *path, size_t *path_len, size_t max_path_len) {
     if (!pred || !path || !path_len) {
@@ -177,6 +566,7 @@ const char* dijkstra_strerror(dijkstra_error_t error) {
         case DIJKSTRA_ERROR_NO_PATH: return "No path exists";
         case DIJKSTRA_ERROR_MEMORY_ALLOC: return "Memory allocation failed";
         case DIJKSTRA_ERROR_GRAPH_EMPTY: return "Graph is empty";
+        case DIJKSTRA_ERROR_NEGATIVE_WEIGHT: return "Negative edge weight";
         default: return "Unknown error";
     }
 }
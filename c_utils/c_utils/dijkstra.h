@@ -3,6 +3,8 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include "graph_csr.h"
+#include "threadpool.h"
 
 // Dijkstra 错误码
 typedef enum {
@@ -11,7 +13,8 @@ typedef enum {
     DIJKSTRA_ERROR_INVALID_NODE,
     DIJKSTRA_ERROR_NO_PATH,
     DIJKSTRA_ERROR_MEMORY_ALLOC,
-    DIJKSTRA_ERROR_GRAPH_EMPTY
+    DIJKSTRA_ERROR_GRAPH_EMPTY,
+    DIJKSTRA_ERROR_NEGATIVE_WEIGHT
 } dijkstra_error_t;
 
 // 图的边
@@ -47,7 +50,7 @@ void dijkstra_graph_free(dijkstra_graph_t *graph);
 // 返回: 成功返回 true，失败返回 false
 bool dijkstra_graph_add_edge(dijkstra_graph_t *graph, int src, int dest, int weight, dijkstra_error_t *error);
 
-// 执行 Dijkstra 算法
+// 执行 Dijkstra 算法 (内部转换为 CSR 后用 dijkstra_csr 求解)
 // graph: 图
 // start: 起始节点
 // dist: 距离数组（输出参数，需要足够大）
@@ -56,6 +59,40 @@ bool dijkstra_graph_add_edge(dijkstra_graph_t *graph, int src, int dest, int wei
 // 返回: 成功返回 true，失败返回 false
 bool dijkstra(dijkstra_graph_t *graph, int start, int *dist, int *pred, dijkstra_error_t *error);
 
+// 邻接表转换为 CSR, 每个节点的出边顺序与邻接表遍历顺序一致
+// 返回: 成功返回 CSR 图, 失败返回 NULL
+graph_csr_t* dijkstra_graph_to_csr(const dijkstra_graph_t *graph);
+
+// CSR 图上的单源最短路 (带位置索引的四叉堆, 松弛时原地 decrease-key), O((V + E) log V)
+// graph: CSR 图, 边权必须非负
+// start: 起始节点
+// target: 目标节点, 出堆即结束; 此时只有先于目标出堆的节点距离是最终值; -1 表示求全部节点
+// dist: 距离数组 (输出参数, 至少 graph->nodes 项, 不可达为 INT_MAX)
+// pred: 前驱节点数组 (输出参数, 可为 NULL)
+// error: 错误码（输出参数，可为 NULL）
+// 返回: 成功返回 true，失败返回 false
+bool dijkstra_csr(const graph_csr_t *graph, int start, int target, int *dist, int *pred, dijkstra_error_t *error);
+
+// 多源多目标最短距离
+// out[i * target_count + j] 为 sources[i] 到 targets[j] 的距离, 不可达为 INT_MAX
+// 每个源点在所有目标都出堆后提前结束; 各源点互相独立, 分块提交到线程池并行计算,
+// 每个任务复用自己的工作区, 只重置上一次搜索访问过的节点
+// pool: 线程池, NULL 时临时创建 CPU 核心数大小的线程池
+// 返回: 成功返回 true，失败返回 false
+bool dijkstra_many_to_many(const graph_csr_t *graph, const int *sources, size_t source_count,
+                           const int *targets, size_t target_count, int *out,
+                           threadpool_t *pool, dijkstra_error_t *error);
+
+// 并行 delta-stepping 单源最短路 (边权必须非负)
+// 按距离把节点放入宽度为 delta 的桶, 依次处理最小的非空桶: 桶内节点的出边在线程池上并行松弛,
+// 距离与前驱打包为 64 位字用 CAS 取最小, 落回当前桶的节点重复处理直到桶清空
+// delta: 桶宽, <= 0 时取 最大边权 / 平均出度
+// dist/pred: 同 dijkstra_csr (pred 可为 NULL)
+// pool: NULL 时在调用线程执行
+// 返回: 成功返回 true，失败返回 false
+bool dijkstra_delta_stepping(const graph_csr_t *graph, int start, int delta, int *dist, int *pred,
+                             threadpool_t *pool, dijkstra_error_t *error);
+
 // 重建路径
 // pred: 前驱节点数组
 // start: 起始节点
@@ -2,31 +2,364 @@
 #include <stdlib.h>
 #include <math.h>
 #include <string.h>
-#include <complex.h>
+#include <stdint.h>
+
+// 头文件目录中有同名的 complex.h (复数工具模块), 本文件不使用 <complex.h> 的函数,
+// double _Complex 数组一律按交错存放的实部/虚部 double 数组访问
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define FFT_HAVE_AVX2 1
+#endif
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
-// 传统 FFT 计算函数
-void fft_compute(double _Complex *a, size_t n) {
+// 批量计算时, 总点数达到此值才值得临时创建线程池
+#define FFT_PARALLEL_MIN_POINTS (1u << 16)
+
+struct fft_plan_s {
+    size_t n;
+    int log2n;
+    double *twiddles;    // 第 m 级 (m = 1, 2, 4, ..., n/2) 的 w_{2m}^j (j < m) 从第 m-1 个复数开始连续存放
+    uint32_t *bitrev;    // n 点位反转表; n/2^s 点变换的位反转为 bitrev[i << s]
+};
+
+// 检查是否为2的幂
+static bool is_power_of_2(size_t n) {
+    return n > 0 && (n & (n - 1)) == 0;
+}
+
+static int fft_log2(size_t n) {
+    int log = 0;
+    while (((size_t)1 << log) < n) log++;
+    return log;
+}
+
+fft_plan_t* fft_plan_create(size_t n) {
+    if (!is_power_of_2(n) || n > ((size_t)1 << FFT_PLAN_MAX_LOG2)) return NULL;
+
+    fft_plan_t *plan = calloc(1, sizeof(fft_plan_t));
+    if (!plan) return NULL;
+    plan->n = n;
+    plan->log2n = fft_log2(n);
+    plan->twiddles = malloc((n > 1 ? n - 1 : 1) * 2 * sizeof(double));
+    plan->bitrev = malloc(n * sizeof(uint32_t));
+    if (!plan->twiddles || !plan->bitrev) {
+        fft_plan_destroy(plan);
+        return NULL;
+    }
+
+    plan->bitrev[0] = 0;
+    for (size_t i = 1; i < n; i++) {
+        plan->bitrev[i] = (plan->bitrev[i >> 1] >> 1) | (uint32_t)((i & 1) << (plan->log2n - 1));
+    }
+
+    // 只对最后一级调用 cos/sin, 前面各级按步长从中抽取
+    if (n > 1) {
+        size_t half = n / 2;
+        double *last = plan->twiddles + 2 * (half - 1);
+        for (size_t j = 0; j < half; j++) {
+            double angle = -M_PI * (double)j / (double)half;
+            last[2 * j] = cos(angle);
+            last[2 * j + 1] = sin(angle);
+        }
+        for (size_t m = 1; m < half; m *= 2) {
+            double *stage = plan->twiddles + 2 * (m - 1);
+            size_t step = half / m;
+            for (size_t j = 0; j < m; j++) {
+                stage[2 * j] = last[2 * j * step];
+                stage[2 * j + 1] = last[2 * j * step + 1];
+            }
+        }
+    }
+    return plan;
+}
+
+void fft_plan_destroy(fft_plan_t *plan) {
+    if (!plan) return;
+    free(plan->twiddles);
+    free(plan->bitrev);
+    free(plan);
+}
+
+size_t fft_plan_size(const fft_plan_t *plan) {
+    return plan ? plan->n : 0;
+}
+
+// 基 2 蝶形 (第 1 级, 旋转因子为 1)
+static void fft_pass2(double *a, size_t n) {
+    for (size_t i = 0; i < 2 * n; i += 4) {
+        double r0 = a[i], i0 = a[i + 1];
+        double r1 = a[i + 2], i1 = a[i + 3];
+        a[i] = r0 + r1;
+        a[i + 1] = i0 + i1;
+        a[i + 2] = r0 - r1;
+        a[i + 3] = i0 - i1;
+    }
+}
+
+// 基 4 蝶形: 把第 m 级和第 2m 级合并为一遍, 减少一半的访存遍数
+// w1 为第 m 级的旋转因子 w_{2m}^j, w2 为第 2m 级的 w_{4m}^j, w_{4m}^{j+m} = -i * w_{4m}^j
+static void fft_pass4_scalar(double *a, size_t n, size_t m, const double *w1, const double *w2) {
+    for (size_t base = 0; base < n; base += 4 * m) {
+        for (size_t j = 0; j < m; j++) {
+            double *p0 = a + 2 * (base + j);
+            double *p1 = p0 + 2 * m;
+            double *p2 = p1 + 2 * m;
+            double *p3 = p2 + 2 * m;
+            double wr = w1[2 * j], wi = w1[2 * j + 1];
+            double t1r = p1[0] * wr - p1[1] * wi, t1i = p1[0] * wi + p1[1] * wr;
+            double t3r = p3[0] * wr - p3[1] * wi, t3i = p3[0] * wi + p3[1] * wr;
+            double b0r = p0[0] + t1r, b0i = p0[1] + t1i;
+            double b1r = p0[0] - t1r, b1i = p0[1] - t1i;
+            double b2r = p2[0] + t3r, b2i = p2[1] + t3i;
+            double b3r = p2[0] - t3r, b3i = p2[1] - t3i;
+            wr = w2[2 * j];
+            wi = w2[2 * j + 1];
+            double u2r = b2r * wr - b2i * wi, u2i = b2r * wi + b2i * wr;
+            // u3 = -i * w2 * b3
+            double u3r = b3r * wi + b3i * wr, u3i = -(b3r * wr - b3i * wi);
+            p0[0] = b0r + u2r;
+            p0[1] = b0i + u2i;
+            p2[0] = b0r - u2r;
+            p2[1] = b0i - u2i;
+            p1[0] = b1r + u3r;
+            p1[1] = b1i + u3i;
+            p3[0] = b1r - u3r;
+            p3[1] = b1i - u3i;
+        }
+    }
+}
+
+#ifdef FFT_HAVE_AVX2
+// 一个 256 位向量装两个复数 (re0, im0, re1, im1)
+__attribute__((target("avx2,fma")))
+static inline __m256d fft_cmul_avx2(__m256d x, __m256d w) {
+    __m256d wr = _mm256_movedup_pd(w);
+    __m256d wi = _mm256_permute_pd(w, 0xF);
+    __m256d xs = _mm256_permute_pd(x, 0x5);
+    return _mm256_fmaddsub_pd(x, wr, _mm256_mul_pd(xs, wi));
+}
+
+// 要求 m >= 2, 每次处理相邻的两个 j
+__attribute__((target("avx2,fma")))
+static void fft_pass4_avx2(double *a, size_t n, size_t m, const double *w1, const double *w2) {
+    const __m256d neg_im = _mm256_set_pd(-0.0, 0.0, -0.0, 0.0);
+    for (size_t base = 0; base < n; base += 4 * m) {
+        for (size_t j = 0; j < m; j += 2) {
+            double *p0 = a + 2 * (base + j);
+            double *p1 = p0 + 2 * m;
+            double *p2 = p1 + 2 * m;
+            double *p3 = p2 + 2 * m;
+            __m256d tw1 = _mm256_loadu_pd(w1 + 2 * j);
+            __m256d tw2 = _mm256_loadu_pd(w2 + 2 * j);
+            __m256d x0 = _mm256_loadu_pd(p0);
+            __m256d x2 = _mm256_loadu_pd(p2);
+            __m256d t1 = fft_cmul_avx2(_mm256_loadu_pd(p1), tw1);
+            __m256d t3 = fft_cmul_avx2(_mm256_loadu_pd(p3), tw1);
+            __m256d b0 = _mm256_add_pd(x0, t1);
+            __m256d b1 = _mm256_sub_pd(x0, t1);
+            __m256d u2 = fft_cmul_avx2(_mm256_add_pd(x2, t3), tw2);
+            __m256d u3 = fft_cmul_avx2(_mm256_sub_pd(x2, t3), tw2);
+            // -i * (re, im) = (im, -re)
+            u3 = _mm256_xor_pd(_mm256_permute_pd(u3, 0x5), neg_im);
+            _mm256_storeu_pd(p0, _mm256_add_pd(b0, u2));
+            _mm256_storeu_pd(p2, _mm256_sub_pd(b0, u2));
+            _mm256_storeu_pd(p1, _mm256_add_pd(b1, u3));
+            _mm256_storeu_pd(p3, _mm256_sub_pd(b1, u3));
+        }
+    }
+}
+
+static bool fft_cpu_has_avx2(void) {
+    static int cached = -1;
+    if (cached < 0) cached = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return cached;
+}
+#endif
+
+// 用计划对 n >> shift 点做原地正向变换 (interleaved 实部/虚部)
+static void fft_plan_execute(const fft_plan_t *plan, double *a, int shift, bool simd) {
+    size_t n = plan->n >> shift;
+    int log2n = plan->log2n - shift;
     if (n <= 1) return;
-    double _Complex *even = malloc(n/2 * sizeof(double _Complex));
-    double _Complex *odd = malloc(n/2 * sizeof(double _Complex));
-    for (size_t i = 0; i < n/2; i++) {
-        even[i] = a[2*i];
-        odd[i] = a[2*i+1];
+
+    for (size_t i = 0; i < n; i++) {
+        size_t j = plan->bitrev[i << shift];
+        if (i < j) {
+            double r = a[2 * i], im = a[2 * i + 1];
+            a[2 * i] = a[2 * j];
+            a[2 * i + 1] = a[2 * j + 1];
+            a[2 * j] = r;
+            a[2 * j + 1] = im;
+        }
+    }
+
+    size_t m = 1;
+    if (log2n & 1) {
+        fft_pass2(a, n);
+        m = 2;
+    }
+#ifndef FFT_HAVE_AVX2
+    (void)simd;
+#else
+    simd = simd && fft_cpu_has_avx2();
+#endif
+    for (; m < n; m *= 4) {
+        const double *w1 = plan->twiddles + 2 * (m - 1);
+        const double *w2 = plan->twiddles + 2 * (2 * m - 1);
+#ifdef FFT_HAVE_AVX2
+        if (simd && m >= 2) {
+            fft_pass4_avx2(a, n, m, w1, w2);
+            continue;
+        }
+#endif
+        fft_pass4_scalar(a, n, m, w1, w2);
+    }
+}
+
+// 逆变换: 共轭 -> 正向变换 -> 共轭并除以 n
+static void fft_plan_execute_inverse(const fft_plan_t *plan, double *a, int shift, bool simd) {
+    size_t n = plan->n >> shift;
+    for (size_t i = 0; i < n; i++) a[2 * i + 1] = -a[2 * i + 1];
+    fft_plan_execute(plan, a, shift, simd);
+    double scale = 1.0 / (double)n;
+    for (size_t i = 0; i < n; i++) {
+        a[2 * i] *= scale;
+        a[2 * i + 1] *= -scale;
+    }
+}
+
+void fft_plan_forward(const fft_plan_t *plan, double _Complex *a) {
+    if (!plan || !a) return;
+    fft_plan_execute(plan, (double *)a, 0, true);
+}
+
+void fft_plan_inverse(const fft_plan_t *plan, double _Complex *a) {
+    if (!plan || !a) return;
+    fft_plan_execute_inverse(plan, (double *)a, 0, true);
+}
+
+// z[k] = x[2k] + i x[2k+1] 的 n/2 点变换 Z 拆分为 X:
+// E[k] = (Z[k] + conj(Z[h-k])) / 2, O[k] = -i (Z[k] - conj(Z[h-k])) / 2
+// X[k] = E[k] + w^k O[k], X[h-k] = conj(E[k] - w^k O[k])
+static void fft_real_forward(const fft_plan_t *plan, const double *in, double *out, bool simd) {
+    size_t n = plan->n;
+    if (n == 1) {
+        out[0] = in[0];
+        out[1] = 0.0;
+        return;
     }
-    fft_compute(even, n/2);
-    fft_compute(odd, n/2);
-    for (size_t k = 0; k < n/2; k++) {
-        double angle = -2.0 * M_PI * k / n;
-        double _Complex twiddle = cos(angle) + sin(angle) * _Complex_I;
-        double _Complex t = twiddle * odd[k];
-        a[k] = even[k] + t;
-        a[k + n/2] = even[k] - t;
+    size_t h = n / 2;
+    memmove(out, in, n * sizeof(double));
+    fft_plan_execute(plan, out, 1, simd);
+
+    double z0r = out[0], z0i = out[1];
+    out[0] = z0r + z0i;
+    out[1] = 0.0;
+    out[2 * h] = z0r - z0i;
+    out[2 * h + 1] = 0.0;
+
+    const double *w = plan->twiddles + 2 * (h - 1);
+    for (size_t k = 1; k <= h / 2; k++) {
+        double ar = out[2 * k], ai = out[2 * k + 1];
+        double br = out[2 * (h - k)], bi = -out[2 * (h - k) + 1];
+        double er = 0.5 * (ar + br), ei = 0.5 * (ai + bi);
+        double or_ = 0.5 * (ai - bi), oi = -0.5 * (ar - br);
+        double wr = w[2 * k], wi = w[2 * k + 1];
+        double tr = wr * or_ - wi * oi, ti = wr * oi + wi * or_;
+        out[2 * k] = er + tr;
+        out[2 * k + 1] = ei + ti;
+        out[2 * (h - k)] = er - tr;
+        out[2 * (h - k) + 1] = -(ei - ti);
+    }
+}
+
+// 逆过程: E[k] = (X[k] + conj(X[h-k])) / 2, O[k] = (X[k] - conj(X[h-k])) conj(w^k) / 2
+// Z[k] = E[k] + i O[k], Z[h-k] = conj(E[k]) + i conj(O[k]), 再做 n/2 点逆变换
+static void fft_real_inverse(const fft_plan_t *plan, const double *in, double *out, bool simd) {
+    size_t n = plan->n;
+    if (n == 1) {
+        out[0] = in[0];
+        return;
+    }
+    size_t h = n / 2;
+    const double *w = plan->twiddles + 2 * (h - 1);
+    for (size_t k = 0; k <= h / 2; k++) {
+        double ar = in[2 * k], ai = in[2 * k + 1];
+        double br = in[2 * (h - k)], bi = -in[2 * (h - k) + 1];
+        double er = 0.5 * (ar + br), ei = 0.5 * (ai + bi);
+        double dr = 0.5 * (ar - br), di = 0.5 * (ai - bi);
+        double wr = w[2 * k], wi = -w[2 * k + 1];
+        double or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+        out[2 * k] = er - oi;
+        out[2 * k + 1] = ei + or_;
+        if (k != 0 && k != h - k) {
+            out[2 * (h - k)] = er + oi;
+            out[2 * (h - k) + 1] = -ei + or_;
+        }
+    }
+    fft_plan_execute_inverse(plan, out, 1, simd);
+}
+
+void fft_plan_real_forward(const fft_plan_t *plan, const double *in, double _Complex *out) {
+    if (!plan || !in || !out) return;
+    fft_real_forward(plan, in, (double *)out, true);
+}
+
+void fft_plan_real_inverse(const fft_plan_t *plan, const double _Complex *in, double *out) {
+    if (!plan || !in || !out) return;
+    fft_real_inverse(plan, (const double *)in, out, true);
+}
+
+// 非 2 的幂长度: 直接 DFT, O(n^2)
+static bool fft_direct(double *a, size_t n, bool inverse) {
+    double *w = malloc(2 * n * sizeof(double));
+    double *out = malloc(2 * n * sizeof(double));
+    if (!w || !out) {
+        free(w);
+        free(out);
+        return false;
+    }
+    double sign = inverse ? 2.0 : -2.0;
+    for (size_t k = 0; k < n; k++) {
+        double angle = sign * M_PI * (double)k / (double)n;
+        w[2 * k] = cos(angle);
+        w[2 * k + 1] = sin(angle);
+    }
+    double scale = inverse ? 1.0 / (double)n : 1.0;
+    for (size_t j = 0; j < n; j++) {
+        double sr = 0.0, si = 0.0;
+        size_t idx = 0;
+        for (size_t k = 0; k < n; k++) {
+            double xr = a[2 * k], xi = a[2 * k + 1];
+            double wr = w[2 * idx], wi = w[2 * idx + 1];
+            sr += xr * wr - xi * wi;
+            si += xr * wi + xi * wr;
+            idx += j;
+            if (idx >= n) idx -= n;
+        }
+        out[2 * j] = sr * scale;
+        out[2 * j + 1] = si * scale;
+    }
+    memcpy(a, out, 2 * n * sizeof(double));
+    free(w);
+    free(out);
+    return true;
+}
+
+// 传统 FFT 计算函数
+void fft_compute(double _Complex *a, size_t n) {
+    if (!a || n <= 1) return;
+    fft_plan_t *plan = fft_plan_create(n);
+    if (plan) {
+        fft_plan_execute(plan, (double *)a, 0, true);
+        fft_plan_destroy(plan);
+    } else if (!is_power_of_2(n)) {
+        fft_direct((double *)a, n, false);
     }
-    free(even); free(odd);
 }
 
 // 创建 FFT 上下文
@@ -34,45 +367,89 @@ fft_error_t fft_create(fft_ctx_t** ctx, const fft_config_t* config) {
     if (!ctx) {
         return FFT_INVALID_PARAMS;
     }
-    
+
     *ctx = (fft_ctx_t*)malloc(sizeof(fft_ctx_t));
     if (!*ctx) {
         return FFT_MEMORY_ERROR;
     }
-    
+
     memset(*ctx, 0, sizeof(fft_ctx_t));
-    
+
     if (config) {
         (*ctx)->config = *config;
     } else {
-        (*ctx)->config.use_optimized = false;
+        (*ctx)->config.use_optimized = true;
         (*ctx)->config.check_size = true;
-        (*ctx)->config.use_cached_windows = false;
+        (*ctx)->config.use_cached_windows = true;
         (*ctx)->config.allow_odd_size = false;
         (*ctx)->config.max_fft_size = 65536;
         (*ctx)->config.max_batch_size = 100;
+        (*ctx)->config.pool = NULL;
     }
-    
-    (*ctx)->twiddle_factors = NULL;
-    (*ctx)->twiddle_size = 0;
+
     (*ctx)->last_error = FFT_OK;
-    
+
     return FFT_OK;
 }
 
 // 销毁 FFT 上下文
 void fft_destroy(fft_ctx_t* ctx) {
     if (ctx) {
-        if (ctx->twiddle_factors) {
-            free(ctx->twiddle_factors);
+        for (int i = 0; i <= FFT_PLAN_MAX_LOG2; i++) {
+            fft_plan_destroy(ctx->plans[i]);
         }
         free(ctx);
     }
 }
 
-// 检查是否为2的幂
-static bool is_power_of_2(size_t n) {
-    return n > 0 && (n & (n - 1)) == 0;
+static fft_error_t fft_check_size(const fft_ctx_t *ctx, size_t n) {
+    if (n == 0) {
+        return FFT_INVALID_SIZE;
+    }
+    if (ctx->config.check_size && !is_power_of_2(n) && !ctx->config.allow_odd_size) {
+        return FFT_UNSUPPORTED_SIZE;
+    }
+    if (ctx->config.max_fft_size > 0 && n > ctx->config.max_fft_size) {
+        return FFT_BUFFER_TOO_SMALL;
+    }
+    return FFT_OK;
+}
+
+// 取 n 点计划: 开启缓存时存放在上下文中, 否则临时创建 (*owned 为 true, 用完由调用方释放)
+static fft_plan_t* fft_ctx_plan(fft_ctx_t *ctx, size_t n, bool *owned) {
+    int log2n = fft_log2(n);
+    *owned = false;
+    if (!ctx->config.use_cached_windows) {
+        *owned = true;
+        return fft_plan_create(n);
+    }
+    if (!ctx->plans[log2n]) {
+        ctx->plans[log2n] = fft_plan_create(n);
+    }
+    return ctx->plans[log2n];
+}
+
+static fft_error_t fft_ctx_transform(fft_ctx_t *ctx, double _Complex *a, size_t n, bool inverse) {
+    if (n == 1) {
+        return FFT_OK;
+    }
+    if (!is_power_of_2(n)) {
+        return fft_direct((double *)a, n, inverse) ? FFT_OK : FFT_MEMORY_ERROR;
+    }
+    bool owned;
+    fft_plan_t *plan = fft_ctx_plan(ctx, n, &owned);
+    if (!plan) {
+        return FFT_MEMORY_ERROR;
+    }
+    if (inverse) {
+        fft_plan_execute_inverse(plan, (double *)a, 0, ctx->config.use_optimized);
+    } else {
+        fft_plan_execute(plan, (double *)a, 0, ctx->config.use_optimized);
+    }
+    if (owned) {
+        fft_plan_destroy(plan);
+    }
+    return FFT_OK;
 }
 
 // 计算 FFT (Cooley-Tukey)
@@ -80,24 +457,17 @@ fft_error_t fft_compute_safe(fft_ctx_t* ctx, double _Complex *a, size_t n) {
     if (!ctx || !a) {
         return FFT_INVALID_PARAMS;
     }
-    
-    if (n == 0) {
-        return FFT_INVALID_SIZE;
-    }
-    
-    if (ctx->config.check_size && !is_power_of_2(n)) {
-        if (!ctx->config.allow_odd_size) {
-            return FFT_UNSUPPORTED_SIZE;
-        }
+
+    fft_error_t err = fft_check_size(ctx, n);
+    if (err == FFT_OK) {
+        err = fft_ctx_transform(ctx, a, n, false);
     }
-    
-    if (ctx->config.max_fft_size > 0 && n > ctx->config.max_fft_size) {
-        return FFT_BUFFER_TOO_SMALL;
+    if (err != FFT_OK) {
+        ctx->last_error = err;
+        return err;
     }
-    
-    fft_compute(a, n);
     ctx->compute_count++;
-    
+
     return FFT_OK;
 }
 
@@ -106,56 +476,117 @@ fft_error_t fft_inverse(fft_ctx_t* ctx, double _Complex *a, size_t n) {
     if (!ctx || !a) {
         return FFT_INVALID_PARAMS;
     }
-    
-    if (n == 0) {
-        return FFT_INVALID_SIZE;
-    }
-    
-    if (ctx->config.check_size && !is_power_of_2(n)) {
-        if (!ctx->config.allow_odd_size) {
-            return FFT_UNSUPPORTED_SIZE;
-        }
-    }
-    
-    // 共轭
-    for (size_t i = 0; i < n; i++) {
-        a[i] = conj(a[i]);
+
+    fft_error_t err = fft_check_size(ctx, n);
+    if (err == FFT_OK) {
+        err = fft_ctx_transform(ctx, a, n, true);
     }
-    
-    // 正向 FFT
-    fft_compute(a, n);
-    
-    // 再次共轭并除以 n
-    for (size_t i = 0; i < n; i++) {
-        a[i] = conj(a[i]) / n;
+    if (err != FFT_OK) {
+        ctx->last_error = err;
+        return err;
     }
-    
     ctx->inverse_count++;
-    
+
     return FFT_OK;
 }
 
+// 批量任务: 各任务原子地领取下一个数组
+typedef struct {
+    fft_ctx_t *ctx;
+    double _Complex **arrays;
+    const size_t *sizes;
+    fft_plan_t **plans;     // 按 log2(n) 索引
+    size_t count;
+    size_t next;
+    fft_error_t error;
+} fft_batch_t;
+
+static void fft_batch_run(void *arg) {
+    fft_batch_t *b = arg;
+    for (;;) {
+        size_t i = __atomic_fetch_add(&b->next, 1, __ATOMIC_RELAXED);
+        if (i >= b->count) break;
+        double _Complex *a = b->arrays[i];
+        size_t n = b->sizes[i];
+        if (!a || n <= 1) continue;
+        if (is_power_of_2(n)) {
+            fft_plan_execute(b->plans[fft_log2(n)], (double *)a, 0, b->ctx->config.use_optimized);
+        } else if (!fft_direct((double *)a, n, false)) {
+            __atomic_store_n(&b->error, FFT_MEMORY_ERROR, __ATOMIC_RELAXED);
+        }
+    }
+}
+
 // 批量计算 FFT
 fft_error_t fft_compute_batch(fft_ctx_t* ctx, double _Complex** arrays, size_t* sizes, size_t count) {
     if (!ctx || !arrays || !sizes) {
         return FFT_INVALID_PARAMS;
     }
-    
+
     if (ctx->config.max_batch_size > 0 && count > ctx->config.max_batch_size) {
         return FFT_BUFFER_TOO_SMALL;
     }
-    
-    for (size_t i = 0; i < count; i++) {
-        if (arrays[i]) {
-            fft_error_t err = fft_compute_safe(ctx, arrays[i], sizes[i]);
-            if (err != FFT_OK) {
-                return err;
+
+    // 先检查全部长度并准备计划, 并行阶段只读
+    fft_plan_t *local[FFT_PLAN_MAX_LOG2 + 1] = { 0 };
+    fft_plan_t *plans[FFT_PLAN_MAX_LOG2 + 1] = { 0 };
+    fft_error_t err = FFT_OK;
+    size_t points = 0;
+    for (size_t i = 0; i < count && err == FFT_OK; i++) {
+        if (!arrays[i]) continue;
+        err = fft_check_size(ctx, sizes[i]);
+        if (err != FFT_OK || !is_power_of_2(sizes[i]) || sizes[i] == 1) continue;
+        points += sizes[i];
+        int log2n = fft_log2(sizes[i]);
+        if (plans[log2n]) continue;
+        bool owned;
+        plans[log2n] = fft_ctx_plan(ctx, sizes[i], &owned);
+        if (owned) local[log2n] = plans[log2n];
+        if (!plans[log2n]) err = FFT_MEMORY_ERROR;
+    }
+
+    if (err == FFT_OK) {
+        fft_batch_t batch = { ctx, arrays, sizes, plans, count, 0, FFT_OK };
+        threadpool_t *pool = ctx->config.pool;
+        threadpool_t *own_pool = NULL;
+        if (!pool && count > 1 && points >= FFT_PARALLEL_MIN_POINTS) {
+            own_pool = threadpool_create(0);
+            pool = own_pool;
+        }
+        size_t workers = pool ? (size_t)threadpool_get_thread_count(pool) : 1;
+        if (workers > count) workers = count;
+
+        // 调用线程也参与, 提交失败的任务由调用线程补做
+        int ids[64] = { 0 };
+        if (workers > 64) workers = 64;
+        for (size_t w = 1; w < workers; w++) {
+            ids[w] = threadpool_add_task(pool, fft_batch_run, &batch);
+        }
+        fft_batch_run(&batch);
+        for (size_t w = 1; w < workers; w++) {
+            if (ids[w] != 0) {
+                threadpool_wait_task(pool, ids[w], -1);
             }
         }
+        if (own_pool) {
+            threadpool_destroy(own_pool);
+        }
+        err = batch.error;
+    }
+
+    for (int i = 0; i <= FFT_PLAN_MAX_LOG2; i++) {
+        fft_plan_destroy(local[i]);
+    }
+    if (err != FFT_OK) {
+        ctx->last_error = err;
+        return err;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        if (arrays[i]) ctx->compute_count++;
     }
-    
     ctx->batch_count++;
-    
+
     return FFT_OK;
 }
 
@@ -164,20 +595,46 @@ fft_error_t fft_compute_real(fft_ctx_t* ctx, const double* real, size_t n, doubl
     if (!ctx || !real || !out) {
         return FFT_INVALID_PARAMS;
     }
-    
-    if (n == 0) {
-        return FFT_INVALID_SIZE;
+
+    fft_error_t err = fft_check_size(ctx, n);
+    if (err != FFT_OK) {
+        ctx->last_error = err;
+        return err;
     }
-    
-    // 转换为复数
-    for (size_t i = 0; i < n; i++) {
-        out[i] = real[i] + 0.0 * _Complex_I;
+
+    if (!is_power_of_2(n) || n < 2) {
+        // 转换为复数
+        double *d = (double *)out;
+        for (size_t i = 0; i < n; i++) {
+            d[2 * i] = real[i];
+            d[2 * i + 1] = 0.0;
+        }
+        err = fft_ctx_transform(ctx, out, n, false);
+    } else {
+        bool owned;
+        fft_plan_t *plan = fft_ctx_plan(ctx, n, &owned);
+        if (!plan) {
+            err = FFT_MEMORY_ERROR;
+        } else {
+            fft_real_forward(plan, real, (double *)out, ctx->config.use_optimized);
+            // 后半部分由共轭对称得到
+            double *d = (double *)out;
+            for (size_t k = n / 2 + 1; k < n; k++) {
+                d[2 * k] = d[2 * (n - k)];
+                d[2 * k + 1] = -d[2 * (n - k) + 1];
+            }
+            if (owned) {
+                fft_plan_destroy(plan);
+            }
+        }
     }
-    
-    // 计算 FFT
-    fft_error_t err = fft_compute_safe(ctx, out, n);
-    
-    return err;
+    if (err != FFT_OK) {
+        ctx->last_error = err;
+        return err;
+    }
+    ctx->compute_count++;
+
+    return FFT_OK;
 }
 
 // 从复数 FFT 结果获取实数
@@ -185,15 +642,15 @@ fft_error_t fft_get_real(fft_ctx_t* ctx, const double _Complex* in, size_t n, do
     if (!ctx || !in || !real) {
         return FFT_INVALID_PARAMS;
     }
-    
+
     if (n == 0) {
         return FFT_INVALID_SIZE;
     }
-    
+
     for (size_t i = 0; i < n; i++) {
-        real[i] = creal(in[i]);
+        real[i] = ((const double *)in)[2 * i];
     }
-    
+
     return FFT_OK;
 }
 
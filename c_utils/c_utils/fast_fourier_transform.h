@@ -4,6 +4,7 @@
 #include <complex.h>
 #include <stddef.h>
 #include <stdbool.h>
+#include "threadpool.h"
 
 // FFT 错误码
 typedef enum {
@@ -16,21 +17,27 @@ typedef enum {
     FFT_COMPUTATION_ERROR = -6
 } fft_error_t;
 
+// FFT 计划: 针对一个 2 的幂长度预先计算位反转表和各级旋转因子, 创建后只读, 可被多个线程同时使用
+// 变换为原地迭代的基 4 (长度为 2 的奇数次幂时先做一级基 2) 时间抽取, CPU 支持时用 AVX2/FMA 做复数蝶形
+typedef struct fft_plan_s fft_plan_t;
+
+#define FFT_PLAN_MAX_LOG2 31
+
 // FFT 配置选项
 typedef struct {
-    bool use_optimized;         // 是否使用优化版本
+    bool use_optimized;         // 是否使用 SIMD 蝶形 (CPU 支持 AVX2/FMA 时)
     bool check_size;            // 是否检查大小（必须是2的幂）
-    bool use_cached_windows;    // 是否使用缓存的旋转因子
-    bool allow_odd_size;        // 是否允许奇数大小
+    bool use_cached_windows;    // 是否在上下文中按长度缓存 FFT 计划 (旋转因子与位反转表)
+    bool allow_odd_size;        // 是否允许非 2 的幂大小 (按 O(n^2) 直接 DFT 计算)
     size_t max_fft_size;        // 最大 FFT 大小
     size_t max_batch_size;      // 最大批量大小
+    threadpool_t *pool;         // 批量计算的线程池, NULL 时数据量足够大才临时创建
 } fft_config_t;
 
 // FFT 上下文
 typedef struct {
     fft_config_t config;
-    double _Complex* twiddle_factors;  // 旋转因子缓存
-    size_t twiddle_size;        // 旋转因子大小
+    fft_plan_t *plans[FFT_PLAN_MAX_LOG2 + 1];  // 按 log2(n) 缓存的计划
     fft_error_t last_error;
     size_t compute_count;
     size_t inverse_count;
@@ -52,11 +59,11 @@ fft_error_t fft_compute_safe(fft_ctx_t* ctx, double _Complex *a, size_t n);
 // 返回 FFT_OK 表示成功，其他值表示错误
 fft_error_t fft_inverse(fft_ctx_t* ctx, double _Complex *a, size_t n);
 
-// 批量计算 FFT
+// 批量计算 FFT: 各数组独立, 在线程池上并行计算; 任一长度不合法则不计算任何数组
 // 返回 FFT_OK 表示成功，其他值表示错误
 fft_error_t fft_compute_batch(fft_ctx_t* ctx, double _Complex** arrays, size_t* sizes, size_t count);
 
-// 计算实数 FFT
+// 计算实数 FFT, out 为完整的 n 项频谱; 2 的幂长度时使用半长技巧
 // 返回 FFT_OK 表示成功，其他值表示错误
 fft_error_t fft_compute_real(fft_ctx_t* ctx, const double* real, size_t n, double _Complex* out);
 
@@ -65,8 +72,24 @@ fft_error_t fft_compute_real(fft_ctx_t* ctx, const double* real, size_t n, doubl
 fft_error_t fft_get_real(fft_ctx_t* ctx, const double _Complex* in, size_t n, double* real);
 
 // 传统 FFT 计算函数（向后兼容）
+// 2 的幂长度时临时创建计划计算, 其他长度按直接 DFT 计算
 void fft_compute(double _Complex *a, size_t n);
 
+// 创建计划: n 必须是 2 的幂且不超过 2^FFT_PLAN_MAX_LOG2, 否则返回 NULL
+fft_plan_t* fft_plan_create(size_t n);
+void        fft_plan_destroy(fft_plan_t *plan);
+size_t      fft_plan_size(const fft_plan_t *plan);
+
+// 原地复数变换, a 为 n 项; 逆变换结果已除以 n
+void fft_plan_forward(const fft_plan_t *plan, double _Complex *a);
+void fft_plan_inverse(const fft_plan_t *plan, double _Complex *a);
+
+// 实数变换 (半长技巧): n 个实数打包为 n/2 点复数做 FFT, 再拆分出频谱
+// 正向: in 为 n 个实数, out 为前 n/2+1 项频谱 (其余项是它们的共轭)
+// 逆向: in 为 n/2+1 项频谱, out 为 n 个实数 (已除以 n)
+void fft_plan_real_forward(const fft_plan_t *plan, const double *in, double _Complex *out);
+void fft_plan_real_inverse(const fft_plan_t *plan, const double _Complex *in, double *out);
+
 // 获取最后一次错误
 fft_error_t fft_get_last_error(fft_ctx_t* ctx);
 
@@ -2,41 +2,242 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdio.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define FW_HAVE_AVX2 1
+#endif
+
+// 分块大小: 一个 64x64 的 int 块为 16KB, 距离块和后继块加上所在行列的块可以同时留在 L2 中
+#define FW_BLOCK 64
+// 行宽按 16 个 int (64 字节) 对齐, 每行都从缓存行边界开始
+#define FW_ROW_ALIGN 16
+
+// 松弛一行: d_i[j] = min(d_i[j], d_ik + d_k[j]), 改进时 n_i[j] = n_ik
+// d_k[j] 为无穷大时跳过, 避免负权边把无穷大减小成普通距离
+// 负权环会让距离不断减小, 结果下限截断为 -FLOYD_INF, 两个距离相加不会溢出
+static void fw_relax_row_scalar(int *di, int *ni, const int *dk, int dik, int nik, size_t len) {
+    for (size_t j = 0; j < len; j++) {
+        int candidate = dik + dk[j];
+        candidate = candidate < -FLOYD_INF ? -FLOYD_INF : candidate;
+        bool better = (dk[j] != FLOYD_INF) & (candidate < di[j]);
+        di[j] = better ? candidate : di[j];
+        ni[j] = better ? nik : ni[j];
+    }
+}
+
+#ifdef FW_HAVE_AVX2
+// 按掩码选择 b 或 a: a ^ ((a ^ b) & mask), 三条单微指令, 比 vpblendvb 快
+__attribute__((target("avx2")))
+static inline __m256i fw_select(__m256i a, __m256i b, __m256i mask) {
+    return _mm256_xor_si256(a, _mm256_and_si256(_mm256_xor_si256(a, b), mask));
+}
+
+// AVX2: 一次松弛 8 个 int32, 用同一个比较掩码选择距离和后继, 尾部走标量
+__attribute__((target("avx2")))
+static void fw_relax_row_avx2(int *di, int *ni, const int *dk, int dik, int nik, size_t len) {
+    const __m256i vdik = _mm256_set1_epi32(dik);
+    const __m256i vnik = _mm256_set1_epi32(nik);
+    const __m256i vinf = _mm256_set1_epi32(FLOYD_INF);
+    const __m256i vfloor = _mm256_set1_epi32(-FLOYD_INF);
+    size_t j = 0;
+    for (; j + 8 <= len; j += 8) {
+        __m256i k = _mm256_loadu_si256((const __m256i *)(dk + j));
+        __m256i d = _mm256_loadu_si256((const __m256i *)(di + j));
+        __m256i candidate = _mm256_max_epi32(_mm256_add_epi32(vdik, k), vfloor);
+        __m256i better = _mm256_andnot_si256(_mm256_cmpeq_epi32(k, vinf), _mm256_cmpgt_epi32(d, candidate));
+        _mm256_storeu_si256((__m256i *)(di + j), fw_select(d, candidate, better));
+        __m256i nx = _mm256_loadu_si256((const __m256i *)(ni + j));
+        _mm256_storeu_si256((__m256i *)(ni + j), fw_select(nx, vnik, better));
+    }
+    fw_relax_row_scalar(di + j, ni + j, dk + j, dik, nik, len - j);
+}
+#endif
+
+typedef struct fw_ctx_s fw_ctx_t;
+typedef void (*fw_block_fn)(const fw_ctx_t *c, size_t bi, size_t bj);
+
+struct fw_ctx_s {
+    int **dist;
+    int **next;
+    size_t n;
+    size_t blocks;
+    size_t round;            // 当前轮次的主块编号
+    fw_block_fn update;      // 阶段 1/2 的块更新
+    fw_block_fn update_rest; // 阶段 3 的块更新
+};
+
+static inline size_t fw_block_end(const fw_ctx_t *c, size_t b) {
+    size_t end = (b + 1) * FW_BLOCK;
+    return end < c->n ? end : c->n;
+}
+
+// 用主块的第 k 行/列更新块 (bi, bj): k 在外层, 保证同一块内的依赖顺序与原算法一致
+#define FW_UPDATE_BLOCK_BODY(relax_row) do {                                                 \
+        size_t k0 = c->round * FW_BLOCK, k1 = fw_block_end(c, c->round);                    \
+        size_t i0 = bi * FW_BLOCK, i1 = fw_block_end(c, bi);                                 \
+        size_t j0 = bj * FW_BLOCK, j1 = fw_block_end(c, bj);                                 \
+        for (size_t k = k0; k < k1; k++) {                                                   \
+            const int *dk = c->dist[k] + j0;                                                 \
+            for (size_t i = i0; i < i1; i++) {                                               \
+                int dik = c->dist[i][k];                                                     \
+                if (dik == FLOYD_INF) continue;                                              \
+                relax_row(c->dist[i] + j0, c->next[i] + j0, dk, dik, c->next[i][k], j1 - j0); \
+            }                                                                                \
+        }                                                                                    \
+    } while (0)
+
+static void fw_update_block_scalar(const fw_ctx_t *c, size_t bi, size_t bj) {
+    FW_UPDATE_BLOCK_BODY(fw_relax_row_scalar);
+}
+
+#ifdef FW_HAVE_AVX2
+__attribute__((target("avx2")))
+static void fw_update_block_avx2(const fw_ctx_t *c, size_t bi, size_t bj) {
+    FW_UPDATE_BLOCK_BODY(fw_relax_row_avx2);
+}
+
+#define FW_STEP(x) do {                                                                      \
+        __m256i k_ = _mm256_loadu_si256((const __m256i *)(dk + 8 * (x)));                   \
+        __m256i c_ = _mm256_max_epi32(_mm256_add_epi32(vdik, k_), vfloor);                  \
+        __m256i b_ = _mm256_andnot_si256(_mm256_cmpeq_epi32(k_, vinf), _mm256_cmpgt_epi32(d##x, c_)); \
+        d##x = fw_select(d##x, c_, b_);                                                     \
+        n##x = fw_select(n##x, vnik, b_);                                                   \
+    } while (0)
+
+// d_ik >= 0 时 d_ik + 无穷大 >= 无穷大, 不会被选中, 和也不会低于 -FLOYD_INF, 可以省去两项检查
+#define FW_STEP_NONNEG(x) do {                                                               \
+        __m256i c_ = _mm256_add_epi32(vdik, _mm256_loadu_si256((const __m256i *)(dk + 8 * (x)))); \
+        __m256i b_ = _mm256_cmpgt_epi32(d##x, c_);                                          \
+        d##x = _mm256_min_epi32(d##x, c_);                                                  \
+        n##x = fw_select(n##x, vnik, b_);                                                   \
+    } while (0)
+
+// 阶段 3 的块不在主块的行列上, 所用的行块和列块在本阶段不变, 可以交换 i/k 循环:
+// 每 16 列的距离和后继留在寄存器中扫完主块的全部 k 再写回, 访存只剩主块行的读取
+__attribute__((target("avx2")))
+static void fw_update_block_rest_avx2(const fw_ctx_t *c, size_t bi, size_t bj) {
+    size_t k0 = c->round * FW_BLOCK, k1 = fw_block_end(c, c->round);
+    size_t i0 = bi * FW_BLOCK, i1 = fw_block_end(c, bi);
+    size_t j0 = bj * FW_BLOCK, j1 = fw_block_end(c, bj);
+    size_t jv = j0 + (j1 - j0) / 16 * 16;
+    const __m256i vinf = _mm256_set1_epi32(FLOYD_INF);
+    const __m256i vfloor = _mm256_set1_epi32(-FLOYD_INF);
+    for (size_t i = i0; i < i1; i++) {
+        int *di = c->dist[i], *ni = c->next[i];
+        for (size_t j = j0; j < jv; j += 16) {
+            __m256i d0 = _mm256_loadu_si256((const __m256i *)(di + j));
+            __m256i d1 = _mm256_loadu_si256((const __m256i *)(di + j + 8));
+            __m256i n0 = _mm256_loadu_si256((const __m256i *)(ni + j));
+            __m256i n1 = _mm256_loadu_si256((const __m256i *)(ni + j + 8));
+            for (size_t k = k0; k < k1; k++) {
+                if (di[k] == FLOYD_INF) continue;
+                const int *dk = c->dist[k] + j;
+                const __m256i vdik = _mm256_set1_epi32(di[k]);
+                const __m256i vnik = _mm256_set1_epi32(ni[k]);
+                if (di[k] >= 0) {
+                    FW_STEP_NONNEG(0);
+                    FW_STEP_NONNEG(1);
+                } else {
+                    FW_STEP(0);
+                    FW_STEP(1);
+                }
+            }
+            _mm256_storeu_si256((__m256i *)(di + j), d0);
+            _mm256_storeu_si256((__m256i *)(di + j + 8), d1);
+            _mm256_storeu_si256((__m256i *)(ni + j), n0);
+            _mm256_storeu_si256((__m256i *)(ni + j + 8), n1);
+        }
+        // 不足 16 列的尾部按行松弛
+        for (size_t k = k0; jv < j1 && k < k1; k++) {
+            if (di[k] == FLOYD_INF) continue;
+            fw_relax_row_avx2(di + jv, ni + jv, c->dist[k] + jv, di[k], ni[k], j1 - jv);
+        }
+    }
+}
+
+#undef FW_STEP_NONNEG
+#undef FW_STEP
+#endif
+
+#undef FW_UPDATE_BLOCK_BODY
+
+// 阶段 2: 主块所在行和列的其余块, 任务 t 的前一半为行块, 后一半为列块
+static void fw_phase_cross(void *ctx, size_t begin, size_t end, int worker) {
+    (void)worker;
+    const fw_ctx_t *c = ctx;
+    size_t others = c->blocks - 1;
+    for (size_t t = begin; t < end; t++) {
+        size_t b = t % others;
+        if (b >= c->round) b++;
+        if (t < others) {
+            c->update(c, c->round, b);
+        } else {
+            c->update(c, b, c->round);
+        }
+    }
+}
+
+// 阶段 3: 其余所有块互不依赖, 按块行划分任务
+static void fw_phase_rest(void *ctx, size_t begin, size_t end, int worker) {
+    (void)worker;
+    const fw_ctx_t *c = ctx;
+    for (size_t t = begin; t < end; t++) {
+        size_t bi = t;
+        if (bi >= c->round) bi++;
+        for (size_t bj = 0; bj < c->blocks; bj++) {
+            if (bj != c->round) c->update_rest(c, bi, bj);
+        }
+    }
+}
+
+// 释放连续分配的矩阵 (行指针数组 + 一整块数据)
+static void fw_matrix_free(int **rows) {
+    if (!rows) return;
+    free(rows[0]);
+    free(rows);
+}
+
+static int** fw_matrix_alloc(size_t n) {
+    size_t stride = (n + FW_ROW_ALIGN - 1) / FW_ROW_ALIGN * FW_ROW_ALIGN;
+    // 行宽为 4KB 的倍数时, 块内各行映射到 L1 的同一组而互相驱逐, 多补一个缓存行错开
+    if (stride % 1024 == 0) stride += FW_ROW_ALIGN;
+    int **rows = calloc(n, sizeof(int*));
+    int *cells = NULL;
+    if (!rows || posix_memalign((void **)&cells, FW_ROW_ALIGN * sizeof(int), n * stride * sizeof(int)) != 0) {
+        free(rows);
+        return NULL;
+    }
+    for (size_t i = 0; i < n; i++) rows[i] = cells + i * stride;
+    return rows;
+}
 
 // 计算全源最短路径
 bool floyd_warshall(size_t n, const int **adj, floyd_result_t *result, floyd_error_t *error) {
+    return floyd_warshall_parallel(n, adj, result, NULL, error);
+}
+
+// 分块并行计算全源最短路径
+bool floyd_warshall_parallel(size_t n, const int **adj, floyd_result_t *result, threadpool_t *pool, floyd_error_t *error) {
     if (n == 0 || !adj || !result) {
         if (error) *error = FLOYD_ERROR_INVALID_PARAM;
         return false;
     }
     
-    // 初始化结果结构
-    result->dist = calloc(n, sizeof(int*));
-    result->next = calloc(n, sizeof(int*));
+    // 距离和后继矩阵各自连续存放, 行按缓存行对齐
+    result->dist = fw_matrix_alloc(n);
+    result->next = fw_matrix_alloc(n);
     
     if (!result->dist || !result->next) {
-        free(result->dist);
-        free(result->next);
+        fw_matrix_free(result->dist);
+        fw_matrix_free(result->next);
+        result->dist = NULL;
+        result->next = NULL;
         if (error) *error = FLOYD_ERROR_MEMORY_ALLOC;
         return false;
     }
     
-    for (size_t i = 0; i < n; i++) {
-        result->dist[i] = malloc(n * sizeof(int));
-        result->next[i] = malloc(n * sizeof(int));
-        
-        if (!result->dist[i] || !result->next[i]) {
-            for (size_t j = 0; j <= i; j++) {
-                free(result->dist[j]);
-                free(result->next[j]);
-            }
-            free(result->dist);
-            free(result->next);
-            if (error) *error = FLOYD_ERROR_MEMORY_ALLOC;
-            return false;
-        }
-    }
-    
     result->nodes = n;
     result->has_negative_cycle = false;
     result->has_error = false;
@@ -57,18 +258,27 @@ bool floyd_warshall(size_t n, const int **adj, floyd_result_t *result, floyd_err
         }
     }
     
-    // Floyd-Warshall 主算法
-    for (size_t k = 0; k < n; k++) {
-        for (size_t i = 0; i < n; i++) {
-            for (size_t j = 0; j < n; j++) {
-                if (result->dist[i][k] != FLOYD_INF && 
-                    result->dist[k][j] != FLOYD_INF &&
-                    result->dist[i][k] + result->dist[k][j] < result->dist[i][j]) {
-                    result->dist[i][j] = result->dist[i][k] + result->dist[k][j];
-                    result->next[i][j] = result->next[i][k];
-                }
-            }
-        }
+    // 分块 Floyd-Warshall: 每轮先算主对角块, 再算主块所在的行列块, 最后算其余块
+    // 后两个阶段内的块互不依赖, 在线程池上并行
+    fw_ctx_t ctx = {
+        .dist = result->dist,
+        .next = result->next,
+        .n = n,
+        .blocks = (n + FW_BLOCK - 1) / FW_BLOCK,
+        .update = fw_update_block_scalar,
+        .update_rest = fw_update_block_scalar
+    };
+#ifdef FW_HAVE_AVX2
+    if (__builtin_cpu_supports("avx2")) {
+        ctx.update = fw_update_block_avx2;
+        ctx.update_rest = fw_update_block_rest_avx2;
+    }
+#endif
+    for (ctx.round = 0; ctx.round < ctx.blocks; ctx.round++) {
+        ctx.update(&ctx, ctx.round, ctx.round);
+        if (ctx.blocks == 1) break;
+        graph_csr_parallel_for(pool, 2 * (ctx.blocks - 1), 1, fw_phase_cross, &ctx);
+        graph_csr_parallel_for(pool, ctx.blocks - 1, 1, fw_phase_rest, &ctx);
     }
     
     // 检测负权环
@@ -87,25 +297,47 @@ bool floyd_warshall(size_t n, const int **adj, floyd_result_t *result, floyd_err
     return true;
 }
 
+// 由 CSR 图计算全源最短路径
+bool floyd_warshall_csr(const graph_csr_t *g, floyd_result_t *result, threadpool_t *pool, floyd_error_t *error) {
+    if (!g || g->nodes == 0 || !result) {
+        if (error) *error = FLOYD_ERROR_INVALID_PARAM;
+        return false;
+    }
+
+    size_t n = g->nodes;
+    int *cells = malloc(n * n * sizeof(int));
+    int **rows = malloc(n * sizeof(int*));
+    if (!cells || !rows) {
+        free(cells);
+        free(rows);
+        if (error) *error = FLOYD_ERROR_MEMORY_ALLOC;
+        return false;
+    }
+
+    for (size_t i = 0; i < n; i++) {
+        rows[i] = cells + i * n;
+        for (size_t j = 0; j < n; j++) rows[i][j] = i == j ? 0 : FLOYD_INF;
+        const int *to, *weight;
+        size_t degree = graph_csr_neighbors(g, (int)i, &to, &weight);
+        for (size_t k = 0; k < degree; k++) {
+            if (weight[k] < rows[i][to[k]]) rows[i][to[k]] = weight[k];
+        }
+    }
+
+    bool ok = floyd_warshall_parallel(n, (const int **)rows, result, pool, error);
+    free(rows);
+    free(cells);
+    return ok;
+}
+
 // 释放 Floyd-Warshall 结果
 void floyd_warshall_free(floyd_result_t *result) {
     if (!result) return;
     
-    if (result->dist) {
-        for (size_t i = 0; i < result->nodes; i++) {
-            free(result->dist[i]);
-        }
-        free(result->dist);
-        result->dist = NULL;
-    }
-    
-    if (result->next) {
-        for (size_t i = 0; i < result->nodes; i++) {
-            free(result->next[i]);
-        }
-        free(result->next);
-        result->next = NULL;
-    }
+    fw_matrix_free(result->dist);
+    fw_matrix_free(result->next);
+    result->dist = NULL;
+    result->next = NULL;
     
     result->nodes = 0;
     result->has_negative_cycle = false;
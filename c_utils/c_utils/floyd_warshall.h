@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include "graph_csr.h"
 
 // Floyd-Warshall 错误码
 typedef enum {
@@ -18,6 +19,7 @@ typedef enum {
 #define FLOYD_INF 1000000
 
 // Floyd-Warshall 结果
+// dist/next 的各行位于一整块连续内存中, 行首按 64 字节对齐, 只能由 floyd_warshall_free 释放
 typedef struct {
     int **dist;
     int **next;
@@ -28,7 +30,7 @@ typedef struct {
     char error_msg[256];
 } floyd_result_t;
 
-// 计算全源最短路径
+// 计算全源最短路径 (分块, 行内松弛使用 AVX2, 在调用线程执行)
 // n: 节点数量
 // adj: 邻接矩阵
 // result: 结果（输出参数）
@@ -36,6 +38,14 @@ typedef struct {
 // 返回: 成功返回 true，失败返回 false
 bool floyd_warshall(size_t n, const int **adj, floyd_result_t *result, floyd_error_t *error);
 
+// 同 floyd_warshall, 矩阵按 64x64 分块, 每轮主块所在行列的块及其余块分两个阶段在线程池上并行
+// pool: 线程池, NULL 时在调用线程执行
+bool floyd_warshall_parallel(size_t n, const int **adj, floyd_result_t *result, threadpool_t *pool, floyd_error_t *error);
+
+// 由 CSR 图计算全源最短路径 (重边取最小权重, 无边为 FLOYD_INF)
+// 参数与返回值同 floyd_warshall_parallel
+bool floyd_warshall_csr(const graph_csr_t *g, floyd_result_t *result, threadpool_t *pool, floyd_error_t *error);
+
 // 释放 Floyd-Warshall 结果
 // result: 结果
 void floyd_warshall_free(floyd_result_t *result);
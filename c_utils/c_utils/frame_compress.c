@@ -0,0 +1,988 @@
+#define _FILE_OFFSET_BITS 64
+#define _POSIX_C_SOURCE 200809L
+
+#include "frame_compress.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "crc32.h"
+#include "rle.h"
+#include "lzw.h"
+#include "huffman.h"
+#include "miniz.h"
+
+#define FRAME_VERSION 1
+#define FRAME_INDEX_ENTRY_SIZE 16
+#define FRAME_INDEX_HEAD_SIZE 8
+
+static const unsigned char FRAME_MAGIC[4] = {'C', 'U', 'F', 'Z'};
+static const unsigned char FRAME_INDEX_MAGIC[4] = {'C', 'U', 'F', 'I'};
+static const unsigned char FRAME_END_MAGIC[4] = {'C', 'U', 'F', 'E'};
+
+static void put_le32(unsigned char *p, uint32_t v) {
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static void put_le64(unsigned char *p, uint64_t v) {
+    put_le32(p, (uint32_t)v);
+    put_le32(p + 4, (uint32_t)(v >> 32));
+}
+
+static uint32_t get_le32(const unsigned char *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static uint64_t get_le64(const unsigned char *p) {
+    return (uint64_t)get_le32(p) | ((uint64_t)get_le32(p + 4) << 32);
+}
+
+static uint32_t frame_crc32c(const void *data, size_t len) {
+    return len > 0 ? crc32_compute(data, len, CRC32_C, NULL) : 0;
+}
+
+/* 各编码器对输出缓冲区的要求不同, 取最大值: RLE 最坏 2 倍, LZW 要求 n + n/10 + 100 */
+static size_t block_scratch_size(size_t block_size) {
+    size_t size = block_size * 2;
+    size_t lzw = block_size + block_size / 10 + 100;
+    size_t huffman = huffman_compress_bound(block_size);
+    if (lzw > size) size = lzw;
+    if (huffman > size) size = huffman;
+    return size;
+}
+
+static bool block_size_valid(size_t block_size) {
+    return block_size >= FRAME_MIN_BLOCK_SIZE && block_size <= FRAME_MAX_BLOCK_SIZE;
+}
+
+/* ---------- 单块编解码 ---------- */
+
+typedef struct {
+    frame_codec_t codec;      // 压缩时为期望编码, 解压时为块头中的编码
+    int level;
+    const unsigned char *src; // 压缩时为原始数据, 解压时为压缩数据
+    size_t src_len;
+    unsigned char *dst;       // 压缩时为暂存区, 解压时为原始数据的目标位置
+    size_t dst_cap;
+    size_t dst_len;
+    size_t raw_len;           // 解压时块头中的原始长度
+    uint32_t crc;
+    frame_codec_t used_codec; // 压缩后实际使用的编码
+    frame_error_t error;
+    int task_id;
+    bool active;
+    unsigned char *own_src;   // 文件输入时的块缓冲区
+    unsigned char *own_dst;   // 暂存区或文件输出时的块缓冲区
+} frame_slot_t;
+
+static void compress_block_task(void *arg) {
+    frame_slot_t *slot = (frame_slot_t *)arg;
+    size_t len = slot->src_len;
+    size_t n = 0;
+
+    slot->crc = frame_crc32c(slot->src, len);
+    slot->used_codec = FRAME_CODEC_STORE;
+    slot->dst_len = len;
+    slot->error = FRAME_OK;
+
+    switch (slot->codec) {
+        case FRAME_CODEC_RLE:
+            n = rle_encode(slot->src, len, slot->dst);
+            break;
+        case FRAME_CODEC_LZW: {
+            lzw_config_t config;
+            lzw_get_default_config(&config);
+            if (lzw_encode_ex(slot->src, len, slot->dst, slot->dst_cap, &n, &config) != LZW_OK) {
+                n = 0;
+            }
+            break;
+        }
+        case FRAME_CODEC_HUFFMAN: {
+            huffman_error_t error;
+            n = huffman_compress(slot->src, len, slot->dst, slot->dst_cap, &error);
+            if (error != HUFFMAN_OK) n = 0;
+            // 写出前先解码校验, 解不回原文的块按原样存储, 不产生读不了的帧
+            if (n > 0 && n < len) {
+                unsigned char *check = (unsigned char *)malloc(len);
+                size_t m = check ? huffman_decompress(slot->dst, n, check, len, &error) : 0;
+                if (!check || error != HUFFMAN_OK || m != len || memcmp(check, slot->src, len) != 0) n = 0;
+                free(check);
+            }
+            break;
+        }
+        case FRAME_CODEC_DEFLATE: {
+            int flags = (int)tdefl_create_comp_flags_from_zip_params(slot->level, -MZ_DEFAULT_WINDOW_BITS,
+                                                                     MZ_DEFAULT_STRATEGY);
+            /* 输出上限设为 len - 1, 不能变小的块直接放弃 */
+            n = len > 1 ? tdefl_compress_mem_to_mem(slot->dst, len - 1, slot->src, len, flags) : 0;
+            break;
+        }
+        default:
+            break;
+    }
+
+    if (n > 0 && n < len) {
+        slot->used_codec = slot->codec;
+        slot->dst_len = n;
+    }
+}
+
+/* RLE 解码不检查边界, 先确认 (计数, 字节) 对的总长度与块头一致 */
+static bool rle_block_valid(const unsigned char *in, size_t in_len, size_t raw_len) {
+    if (in_len % 2 != 0) return false;
+    size_t total = 0;
+    for (size_t i = 0; i < in_len; i += 2) {
+        if (in[i] == 0) return false;
+        total += in[i];
+    }
+    return total == raw_len;
+}
+
+static void decompress_block_task(void *arg) {
+    frame_slot_t *slot = (frame_slot_t *)arg;
+    size_t raw_len = slot->raw_len;
+    size_t n = 0;
+
+    switch (slot->codec) {
+        case FRAME_CODEC_STORE:
+            if (slot->src_len == raw_len) {
+                memcpy(slot->dst, slot->src, raw_len);
+                n = raw_len;
+            }
+            break;
+        case FRAME_CODEC_RLE:
+            if (rle_block_valid(slot->src, slot->src_len, raw_len)) {
+                n = rle_decode(slot->src, slot->src_len, slot->dst);
+            }
+            break;
+        case FRAME_CODEC_LZW:
+            if (lzw_decode(slot->src, slot->src_len, slot->dst, raw_len, &n) != LZW_OK) {
+                n = 0;
+            }
+            break;
+        case FRAME_CODEC_HUFFMAN: {
+            huffman_error_t error;
+            n = huffman_decompress(slot->src, slot->src_len, slot->dst, raw_len, &error);
+            if (error != HUFFMAN_OK) n = 0;
+            break;
+        }
+        case FRAME_CODEC_DEFLATE:
+            n = tinfl_decompress_mem_to_mem(slot->dst, raw_len, slot->src, slot->src_len, 0);
+            if (n == TINFL_DECOMPRESS_MEM_TO_MEM_FAILED) n = 0;
+            break;
+        default:
+            break;
+    }
+
+    if (n != raw_len) {
+        slot->error = FRAME_ERROR_CODEC;
+    } else if (frame_crc32c(slot->dst, raw_len) != slot->crc) {
+        slot->error = FRAME_ERROR_CHECKSUM;
+    } else {
+        slot->error = FRAME_OK;
+    }
+    slot->dst_len = n;
+}
+
+static void encode_block_header(unsigned char *p, frame_codec_t codec, size_t raw_len, size_t comp_len,
+                                uint32_t crc) {
+    p[0] = (unsigned char)codec;
+    p[1] = p[2] = p[3] = 0;
+    put_le32(p + 4, (uint32_t)raw_len);
+    put_le32(p + 8, (uint32_t)comp_len);
+    put_le32(p + 12, crc);
+}
+
+static frame_error_t decode_block_header(const unsigned char *p, size_t block_size, frame_slot_t *slot) {
+    uint32_t raw_len = get_le32(p + 4);
+    uint32_t comp_len = get_le32(p + 8);
+    if (p[0] > FRAME_CODEC_DEFLATE || raw_len == 0 || raw_len > block_size || comp_len > raw_len ||
+        (p[0] == FRAME_CODEC_STORE && comp_len != raw_len)) {
+        return FRAME_ERROR_INVALID_FORMAT;
+    }
+    slot->codec = (frame_codec_t)p[0];
+    slot->raw_len = raw_len;
+    slot->src_len = comp_len;
+    slot->crc = get_le32(p + 12);
+    return FRAME_OK;
+}
+
+static void encode_file_header(unsigned char *p, const frame_config_t *config) {
+    memcpy(p, FRAME_MAGIC, 4);
+    p[4] = FRAME_VERSION;
+    p[5] = (unsigned char)config->codec;
+    p[6] = p[7] = 0;
+    put_le32(p + 8, (uint32_t)config->block_size);
+    put_le32(p + 12, 0);
+}
+
+static frame_error_t decode_file_header(const unsigned char *p, size_t *block_size) {
+    if (memcmp(p, FRAME_MAGIC, 4) != 0 || p[4] != FRAME_VERSION) {
+        return FRAME_ERROR_INVALID_FORMAT;
+    }
+    *block_size = get_le32(p + 8);
+    return block_size_valid(*block_size) ? FRAME_OK : FRAME_ERROR_INVALID_FORMAT;
+}
+
+/* ---------- 顺序输入输出 ---------- */
+
+typedef struct {
+    FILE *fp;
+    const unsigned char *in;
+    size_t in_len;
+    unsigned char *out;
+    size_t out_size;
+    uint64_t pos;
+} frame_io_t;
+
+static frame_error_t io_read(frame_io_t *io, void *data, size_t len, size_t *got) {
+    if (io->fp) {
+        *got = fread(data, 1, len, io->fp);
+        if (*got < len && ferror(io->fp)) return FRAME_ERROR_FILE_READ;
+    } else {
+        size_t left = io->in_len - (size_t)io->pos;
+        *got = len < left ? len : left;
+        memcpy(data, io->in + io->pos, *got);
+    }
+    io->pos += *got;
+    return FRAME_OK;
+}
+
+static frame_error_t io_read_exact(frame_io_t *io, void *data, size_t len) {
+    size_t got;
+    frame_error_t error = io_read(io, data, len, &got);
+    if (error == FRAME_OK && got != len) error = FRAME_ERROR_INVALID_FORMAT;
+    return error;
+}
+
+/* 内存输入时直接返回指向输入的指针, 避免复制 */
+static frame_error_t io_view(frame_io_t *io, unsigned char *buffer, size_t len, size_t *got,
+                             const unsigned char **view) {
+    if (io->fp) {
+        *view = buffer;
+        return io_read(io, buffer, len, got);
+    }
+    size_t left = io->in_len - (size_t)io->pos;
+    *got = len < left ? len : left;
+    *view = io->in + io->pos;
+    io->pos += *got;
+    return FRAME_OK;
+}
+
+static frame_error_t io_write(frame_io_t *io, const void *data, size_t len) {
+    if (len == 0) return FRAME_OK;
+    if (io->fp) {
+        if (fwrite(data, 1, len, io->fp) != len) return FRAME_ERROR_FILE_WRITE;
+    } else {
+        if (io->out_size - (size_t)io->pos < len) return FRAME_ERROR_BUFFER_TOO_SMALL;
+        if ((const unsigned char *)data != io->out + io->pos) {
+            memcpy(io->out + io->pos, data, len);
+        }
+    }
+    io->pos += len;
+    return FRAME_OK;
+}
+
+/* ---------- 流水线 ---------- */
+
+typedef struct {
+    threadpool_t *pool;
+    threadpool_t *own_pool;
+    frame_slot_t *slots;
+    size_t window;
+} frame_pipeline_t;
+
+static frame_error_t pipeline_init(frame_pipeline_t *pipe, const frame_config_t *config, bool parallel) {
+    memset(pipe, 0, sizeof(*pipe));
+    if (parallel) {
+        pipe->pool = config->pool;
+        if (!pipe->pool) {
+            pipe->own_pool = threadpool_create(0);
+            if (!pipe->own_pool) return FRAME_ERROR_MEMORY;
+            pipe->pool = pipe->own_pool;
+        }
+        pipe->window = config->max_inflight;
+        if (pipe->window == 0) {
+            pipe->window = (size_t)threadpool_get_thread_count(pipe->pool) * 2;
+        }
+    }
+    if (pipe->window == 0) pipe->window = 1;
+
+    pipe->slots = (frame_slot_t *)calloc(pipe->window, sizeof(frame_slot_t));
+    return pipe->slots ? FRAME_OK : FRAME_ERROR_MEMORY;
+}
+
+static void pipeline_submit(frame_pipeline_t *pipe, frame_slot_t *slot, void (*task)(void *)) {
+    slot->active = true;
+    slot->task_id = pipe->pool ? threadpool_add_task(pipe->pool, task, slot) : 0;
+    if (slot->task_id == 0) {
+        task(slot);
+    }
+}
+
+static void pipeline_wait(frame_pipeline_t *pipe, frame_slot_t *slot) {
+    if (slot->task_id != 0) {
+        threadpool_wait_task(pipe->pool, slot->task_id, -1);
+        slot->task_id = 0;
+    }
+}
+
+static void pipeline_destroy(frame_pipeline_t *pipe) {
+    if (pipe->slots) {
+        for (size_t i = 0; i < pipe->window; i++) {
+            pipeline_wait(pipe, &pipe->slots[i]);
+            free(pipe->slots[i].own_src);
+            free(pipe->slots[i].own_dst);
+        }
+        free(pipe->slots);
+    }
+    if (pipe->own_pool) {
+        threadpool_destroy(pipe->own_pool);
+    }
+}
+
+/* 块索引在压缩过程中累积, 每块 16 字节 */
+typedef struct {
+    unsigned char *data;
+    size_t count;
+    size_t capacity;
+} frame_index_t;
+
+static frame_error_t index_append(frame_index_t *index, uint64_t offset, size_t raw_len, size_t comp_len) {
+    if (index->count == index->capacity) {
+        size_t capacity = index->capacity ? index->capacity * 2 : 64;
+        unsigned char *data = (unsigned char *)realloc(index->data, capacity * FRAME_INDEX_ENTRY_SIZE);
+        if (!data) return FRAME_ERROR_MEMORY;
+        index->data = data;
+        index->capacity = capacity;
+    }
+    unsigned char *p = index->data + index->count * FRAME_INDEX_ENTRY_SIZE;
+    put_le64(p, offset);
+    put_le32(p + 8, (uint32_t)raw_len);
+    put_le32(p + 12, (uint32_t)comp_len);
+    index->count++;
+    return FRAME_OK;
+}
+
+static frame_error_t write_index(frame_io_t *out, const frame_index_t *index) {
+    if (index->count > UINT32_MAX) return FRAME_ERROR_INVALID_ARGS;
+
+    uint64_t index_offset = out->pos;
+    size_t entries_len = index->count * FRAME_INDEX_ENTRY_SIZE;
+    unsigned char head[FRAME_INDEX_HEAD_SIZE];
+    memcpy(head, FRAME_INDEX_MAGIC, 4);
+    put_le32(head + 4, (uint32_t)index->count);
+
+    crc32_context_t ctx;
+    crc32_init(&ctx, CRC32_C, NULL);
+    crc32_update(&ctx, head, sizeof(head));
+    if (entries_len > 0) crc32_update(&ctx, index->data, entries_len);
+    unsigned char crc[4];
+    put_le32(crc, crc32_final(&ctx));
+
+    unsigned char footer[FRAME_FOOTER_SIZE];
+    put_le64(footer, index_offset);
+    put_le32(footer + 8, (uint32_t)index->count);
+    memcpy(footer + 12, FRAME_END_MAGIC, 4);
+
+    frame_error_t error = io_write(out, head, sizeof(head));
+    if (error == FRAME_OK) error = io_write(out, index->data, entries_len);
+    if (error == FRAME_OK) error = io_write(out, crc, sizeof(crc));
+    if (error == FRAME_OK) error = io_write(out, footer, sizeof(footer));
+    return error;
+}
+
+static frame_error_t fill_compress_slot(frame_slot_t *slot, frame_io_t *in, const frame_config_t *config,
+                                        bool *eof) {
+    size_t got;
+    const unsigned char *view;
+    frame_error_t error = io_view(in, slot->own_src, config->block_size, &got, &view);
+    if (error != FRAME_OK) return error;
+    if (got == 0) {
+        *eof = true;
+        return FRAME_OK;
+    }
+    if (got < config->block_size) *eof = true;
+    slot->codec = config->codec;
+    slot->level = config->level;
+    slot->src = view;
+    slot->src_len = got;
+    slot->dst = slot->own_dst;
+    slot->dst_cap = block_scratch_size(config->block_size);
+    return FRAME_OK;
+}
+
+static frame_error_t compress_stream(frame_io_t *in, frame_io_t *out, const frame_config_t *config,
+                                     bool parallel, frame_stats_t *stats) {
+    frame_pipeline_t pipe;
+    frame_index_t index = {NULL, 0, 0};
+    frame_error_t error = pipeline_init(&pipe, config, parallel);
+
+    for (size_t i = 0; error == FRAME_OK && i < pipe.window; i++) {
+        if (in->fp) {
+            pipe.slots[i].own_src = (unsigned char *)malloc(config->block_size);
+            if (!pipe.slots[i].own_src) error = FRAME_ERROR_MEMORY;
+        }
+        pipe.slots[i].own_dst = (unsigned char *)malloc(block_scratch_size(config->block_size));
+        if (!pipe.slots[i].own_dst) error = FRAME_ERROR_MEMORY;
+    }
+
+    /* CRC 表懒初始化, 在提交任务前于当前线程完成 */
+    crc32_get_table(CRC32_C);
+
+    unsigned char header[FRAME_HEADER_SIZE];
+    encode_file_header(header, config);
+    if (error == FRAME_OK) error = io_write(out, header, sizeof(header));
+
+    bool eof = false;
+    for (size_t i = 0; error == FRAME_OK && !eof && i < pipe.window; i++) {
+        error = fill_compress_slot(&pipe.slots[i], in, config, &eof);
+        if (error == FRAME_OK && pipe.slots[i].src_len > 0) {
+            pipeline_submit(&pipe, &pipe.slots[i], compress_block_task);
+        }
+    }
+
+    size_t stored = 0;
+    uint64_t raw_size = 0;
+    for (size_t head = 0; error == FRAME_OK && pipe.slots[head].active; head = (head + 1) % pipe.window) {
+        frame_slot_t *slot = &pipe.slots[head];
+        pipeline_wait(&pipe, slot);
+        slot->active = false;
+
+        const unsigned char *payload = slot->used_codec == FRAME_CODEC_STORE ? slot->src : slot->dst;
+        unsigned char block_header[FRAME_BLOCK_HEADER_SIZE];
+        encode_block_header(block_header, slot->used_codec, slot->src_len, slot->dst_len, slot->crc);
+
+        error = index_append(&index, out->pos, slot->src_len, slot->dst_len);
+        if (error == FRAME_OK) error = io_write(out, block_header, sizeof(block_header));
+        if (error == FRAME_OK) error = io_write(out, payload, slot->dst_len);
+        if (slot->used_codec == FRAME_CODEC_STORE) stored++;
+        raw_size += slot->src_len;
+        slot->src_len = 0;
+
+        if (error == FRAME_OK && !eof) {
+            error = fill_compress_slot(slot, in, config, &eof);
+            if (error == FRAME_OK && slot->src_len > 0) {
+                pipeline_submit(&pipe, slot, compress_block_task);
+            }
+        }
+    }
+
+    if (error == FRAME_OK) error = write_index(out, &index);
+
+    if (error == FRAME_OK && stats) {
+        stats->raw_size = raw_size;
+        stats->compressed_size = out->pos;
+        stats->block_count = index.count;
+        stats->stored_blocks = stored;
+    }
+
+    pipeline_destroy(&pipe);
+    free(index.data);
+    return error;
+}
+
+/* 读取并校验块头之后的索引和文件尾, 返回索引中的块数 */
+static frame_error_t read_trailer(frame_io_t *in, const unsigned char *head, size_t *count) {
+    *count = get_le32(head + 4);
+    size_t entries_len = *count * FRAME_INDEX_ENTRY_SIZE;
+    unsigned char *entries = (unsigned char *)malloc(entries_len + 4 + FRAME_FOOTER_SIZE);
+    if (!entries) return FRAME_ERROR_MEMORY;
+
+    frame_error_t error = io_read_exact(in, entries, entries_len + 4 + FRAME_FOOTER_SIZE);
+    if (error == FRAME_OK) {
+        crc32_context_t ctx;
+        crc32_init(&ctx, CRC32_C, NULL);
+        crc32_update(&ctx, head, FRAME_INDEX_HEAD_SIZE);
+        if (entries_len > 0) crc32_update(&ctx, entries, entries_len);
+        const unsigned char *footer = entries + entries_len + 4;
+        if (crc32_final(&ctx) != get_le32(entries + entries_len)) {
+            error = FRAME_ERROR_CHECKSUM;
+        } else if (memcmp(footer + 12, FRAME_END_MAGIC, 4) != 0 || get_le32(footer + 8) != *count) {
+            error = FRAME_ERROR_INVALID_FORMAT;
+        }
+    }
+    free(entries);
+    return error;
+}
+
+static frame_error_t fill_decompress_slot(frame_slot_t *slot, frame_io_t *in, frame_io_t *out,
+                                          size_t block_size, bool *eof, size_t *index_count) {
+    unsigned char header[FRAME_BLOCK_HEADER_SIZE];
+    frame_error_t error = io_read_exact(in, header, FRAME_INDEX_HEAD_SIZE);
+    if (error != FRAME_OK) return error;
+
+    /* 编码字节不超过 4, 不会与索引魔数 "CUFI" 混淆 */
+    if (memcmp(header, FRAME_INDEX_MAGIC, 4) == 0) {
+        *eof = true;
+        return read_trailer(in, header, index_count);
+    }
+
+    error = io_read_exact(in, header + FRAME_INDEX_HEAD_SIZE, FRAME_BLOCK_HEADER_SIZE - FRAME_INDEX_HEAD_SIZE);
+    if (error == FRAME_OK) error = decode_block_header(header, block_size, slot);
+    if (error != FRAME_OK) return error;
+
+    size_t got;
+    const unsigned char *view;
+    error = io_view(in, slot->own_src, slot->src_len, &got, &view);
+    if (error != FRAME_OK) return error;
+    if (got != slot->src_len) return FRAME_ERROR_INVALID_FORMAT;
+    slot->src = view;
+
+    /* 内存输出时直接解压到目标位置, 位置在提交时按顺序预留 */
+    if (out->fp) {
+        slot->dst = slot->own_dst;
+    } else {
+        if (out->out_size - (size_t)out->pos < slot->raw_len) return FRAME_ERROR_BUFFER_TOO_SMALL;
+        slot->dst = out->out + out->pos;
+        out->pos += slot->raw_len;
+    }
+    slot->dst_cap = slot->raw_len;
+    return FRAME_OK;
+}
+
+static frame_error_t decompress_stream(frame_io_t *in, frame_io_t *out, const frame_config_t *config,
+                                       bool parallel, frame_stats_t *stats) {
+    unsigned char header[FRAME_HEADER_SIZE];
+    size_t block_size;
+    frame_error_t error = io_read_exact(in, header, sizeof(header));
+    if (error == FRAME_OK) error = decode_file_header(header, &block_size);
+    if (error != FRAME_OK) return error;
+
+    frame_pipeline_t pipe;
+    error = pipeline_init(&pipe, config, parallel);
+    for (size_t i = 0; error == FRAME_OK && i < pipe.window; i++) {
+        if (in->fp) {
+            pipe.slots[i].own_src = (unsigned char *)malloc(block_size);
+            if (!pipe.slots[i].own_src) error = FRAME_ERROR_MEMORY;
+        }
+        if (out->fp) {
+            pipe.slots[i].own_dst = (unsigned char *)malloc(block_size);
+            if (!pipe.slots[i].own_dst) error = FRAME_ERROR_MEMORY;
+        }
+    }
+
+    crc32_get_table(CRC32_C);
+
+    bool eof = false;
+    size_t index_count = 0;
+    for (size_t i = 0; error == FRAME_OK && !eof && i < pipe.window; i++) {
+        error = fill_decompress_slot(&pipe.slots[i], in, out, block_size, &eof, &index_count);
+        if (error == FRAME_OK && !eof) {
+            pipeline_submit(&pipe, &pipe.slots[i], decompress_block_task);
+        }
+    }
+
+    size_t blocks = 0;
+    size_t stored = 0;
+    uint64_t raw_size = 0;
+    for (size_t head = 0; error == FRAME_OK && pipe.slots[head].active; head = (head + 1) % pipe.window) {
+        frame_slot_t *slot = &pipe.slots[head];
+        pipeline_wait(&pipe, slot);
+        slot->active = false;
+
+        error = slot->error;
+        if (error == FRAME_OK && out->fp) error = io_write(out, slot->dst, slot->raw_len);
+        if (slot->codec == FRAME_CODEC_STORE) stored++;
+        raw_size += slot->raw_len;
+        blocks++;
+
+        if (error == FRAME_OK && !eof) {
+            error = fill_decompress_slot(slot, in, out, block_size, &eof, &index_count);
+            if (error == FRAME_OK && !eof) {
+                pipeline_submit(&pipe, slot, decompress_block_task);
+            }
+        }
+    }
+
+    if (error == FRAME_OK && (!eof || index_count != blocks)) {
+        error = FRAME_ERROR_INVALID_FORMAT;
+    }
+
+    if (error == FRAME_OK && stats) {
+        stats->raw_size = raw_size;
+        stats->compressed_size = in->pos;
+        stats->block_count = blocks;
+        stats->stored_blocks = stored;
+    }
+
+    pipeline_destroy(&pipe);
+    return error;
+}
+
+/* ---------- 公共接口 ---------- */
+
+frame_config_t frame_default_config(void) {
+    frame_config_t config;
+    config.codec = FRAME_CODEC_DEFLATE;
+    config.level = 6;
+    config.block_size = FRAME_DEFAULT_BLOCK_SIZE;
+    config.max_inflight = 0;
+    config.pool = NULL;
+    return config;
+}
+
+static frame_error_t check_config(const frame_config_t *config) {
+    if (config->codec > FRAME_CODEC_DEFLATE || !block_size_valid(config->block_size)) {
+        return FRAME_ERROR_INVALID_ARGS;
+    }
+    if (config->codec == FRAME_CODEC_DEFLATE && (config->level < 1 || config->level > 9)) {
+        return FRAME_ERROR_INVALID_ARGS;
+    }
+    return FRAME_OK;
+}
+
+size_t frame_compress_bound(size_t input_len, size_t block_size) {
+    if (block_size == 0) block_size = FRAME_DEFAULT_BLOCK_SIZE;
+    size_t blocks = (input_len + block_size - 1) / block_size;
+    return FRAME_HEADER_SIZE + input_len + blocks * (FRAME_BLOCK_HEADER_SIZE + FRAME_INDEX_ENTRY_SIZE) +
+           FRAME_INDEX_HEAD_SIZE + 4 + FRAME_FOOTER_SIZE;
+}
+
+frame_error_t frame_compress_buffer(const void *input, size_t input_len, void *output, size_t output_size,
+                                    size_t *output_len, const frame_config_t *config, frame_stats_t *stats) {
+    if ((!input && input_len > 0) || !output || !output_len) {
+        return FRAME_ERROR_NULL_PTR;
+    }
+    frame_config_t defaults = frame_default_config();
+    if (!config) config = &defaults;
+    frame_error_t error = check_config(config);
+    if (error != FRAME_OK) return error;
+
+    frame_io_t in = {NULL, (const unsigned char *)input, input_len, NULL, 0, 0};
+    frame_io_t out = {NULL, NULL, 0, (unsigned char *)output, output_size, 0};
+    /* 只有一块时不值得调度线程池 */
+    error = compress_stream(&in, &out, config, input_len > config->block_size, stats);
+    *output_len = error == FRAME_OK ? (size_t)out.pos : 0;
+    return error;
+}
+
+frame_error_t frame_decompress_buffer(const void *input, size_t input_len, void *output, size_t output_size,
+                                      size_t *output_len, const frame_config_t *config, frame_stats_t *stats) {
+    if (!input || (!output && output_size > 0) || !output_len) {
+        return FRAME_ERROR_NULL_PTR;
+    }
+    frame_config_t defaults = frame_default_config();
+    if (!config) config = &defaults;
+
+    uint64_t size;
+    frame_error_t error = frame_get_decompressed_size(input, input_len, &size);
+    if (error != FRAME_OK) return error;
+    if (size > output_size) return FRAME_ERROR_BUFFER_TOO_SMALL;
+
+    size_t block_size;
+    error = decode_file_header((const unsigned char *)input, &block_size);
+    if (error != FRAME_OK) return error;
+
+    frame_io_t in = {NULL, (const unsigned char *)input, input_len, NULL, 0, 0};
+    frame_io_t out = {NULL, NULL, 0, (unsigned char *)output, output_size, 0};
+    error = decompress_stream(&in, &out, config, size > block_size, stats);
+    *output_len = error == FRAME_OK ? (size_t)out.pos : 0;
+    return error;
+}
+
+/* 校验文件尾和索引, entries 指向索引项 */
+static frame_error_t parse_trailer(const unsigned char *index, size_t index_len, size_t count) {
+    size_t entries_len = count * FRAME_INDEX_ENTRY_SIZE;
+    if (index_len != FRAME_INDEX_HEAD_SIZE + entries_len + 4 || memcmp(index, FRAME_INDEX_MAGIC, 4) != 0 ||
+        get_le32(index + 4) != count) {
+        return FRAME_ERROR_INVALID_FORMAT;
+    }
+    if (frame_crc32c(index, FRAME_INDEX_HEAD_SIZE + entries_len) != get_le32(index + index_len - 4)) {
+        return FRAME_ERROR_CHECKSUM;
+    }
+    return FRAME_OK;
+}
+
+static frame_error_t parse_footer(const unsigned char *footer, uint64_t container_len, uint64_t *index_offset,
+                                  size_t *count) {
+    if (memcmp(footer + 12, FRAME_END_MAGIC, 4) != 0) return FRAME_ERROR_INVALID_FORMAT;
+    *index_offset = get_le64(footer);
+    *count = get_le32(footer + 8);
+    uint64_t index_len = FRAME_INDEX_HEAD_SIZE + (uint64_t)*count * FRAME_INDEX_ENTRY_SIZE + 4;
+    if (*index_offset < FRAME_HEADER_SIZE || *index_offset + index_len + FRAME_FOOTER_SIZE != container_len) {
+        return FRAME_ERROR_INVALID_FORMAT;
+    }
+    return FRAME_OK;
+}
+
+frame_error_t frame_get_decompressed_size(const void *input, size_t input_len, uint64_t *size) {
+    if (!input || !size) return FRAME_ERROR_NULL_PTR;
+    const unsigned char *data = (const unsigned char *)input;
+    if (input_len < FRAME_HEADER_SIZE + FRAME_INDEX_HEAD_SIZE + 4 + FRAME_FOOTER_SIZE) {
+        return FRAME_ERROR_INVALID_FORMAT;
+    }
+
+    uint64_t index_offset;
+    size_t count;
+    frame_error_t error = parse_footer(data + input_len - FRAME_FOOTER_SIZE, input_len, &index_offset, &count);
+    if (error != FRAME_OK) return error;
+    size_t index_len = input_len - FRAME_FOOTER_SIZE - (size_t)index_offset;
+    error = parse_trailer(data + index_offset, index_len, count);
+    if (error != FRAME_OK) return error;
+
+    uint64_t total = 0;
+    const unsigned char *entries = data + index_offset + FRAME_INDEX_HEAD_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        total += get_le32(entries + i * FRAME_INDEX_ENTRY_SIZE + 8);
+    }
+    *size = total;
+    return FRAME_OK;
+}
+
+frame_error_t frame_compress_file(const char *input_filename, const char *output_filename,
+                                  const frame_config_t *config, frame_stats_t *stats) {
+    if (!input_filename || !output_filename) return FRAME_ERROR_NULL_PTR;
+    frame_config_t defaults = frame_default_config();
+    if (!config) config = &defaults;
+    frame_error_t error = check_config(config);
+    if (error != FRAME_OK) return error;
+
+    FILE *fin = fopen(input_filename, "rb");
+    if (!fin) return FRAME_ERROR_FILE_OPEN;
+    FILE *fout = fopen(output_filename, "wb");
+    if (!fout) {
+        fclose(fin);
+        return FRAME_ERROR_FILE_OPEN;
+    }
+
+    frame_io_t in = {fin, NULL, 0, NULL, 0, 0};
+    frame_io_t out = {fout, NULL, 0, NULL, 0, 0};
+    error = compress_stream(&in, &out, config, true, stats);
+
+    fclose(fin);
+    if (fclose(fout) != 0 && error == FRAME_OK) error = FRAME_ERROR_FILE_WRITE;
+    return error;
+}
+
+frame_error_t frame_decompress_file(const char *input_filename, const char *output_filename,
+                                    const frame_config_t *config, frame_stats_t *stats) {
+    if (!input_filename || !output_filename) return FRAME_ERROR_NULL_PTR;
+    frame_config_t defaults = frame_default_config();
+    if (!config) config = &defaults;
+
+    FILE *fin = fopen(input_filename, "rb");
+    if (!fin) return FRAME_ERROR_FILE_OPEN;
+    FILE *fout = fopen(output_filename, "wb");
+    if (!fout) {
+        fclose(fin);
+        return FRAME_ERROR_FILE_OPEN;
+    }
+
+    frame_io_t in = {fin, NULL, 0, NULL, 0, 0};
+    frame_io_t out = {fout, NULL, 0, NULL, 0, 0};
+    frame_error_t error = decompress_stream(&in, &out, config, true, stats);
+
+    fclose(fin);
+    if (fclose(fout) != 0 && error == FRAME_OK) error = FRAME_ERROR_FILE_WRITE;
+    return error;
+}
+
+/* ---------- 随机访问 ---------- */
+
+struct frame_reader {
+    FILE *fp;
+    size_t block_size;
+    size_t count;
+    uint64_t *offsets;     // 每块块头在文件中的偏移
+    uint64_t *raw_starts;  // 每块在原始数据中的起始偏移, 共 count + 1 项
+    unsigned char *packed;
+    unsigned char *cache;  // 最近一次解压的块
+    size_t cache_block;
+    size_t cache_len;
+};
+
+frame_reader_t *frame_reader_open(const char *filename, frame_error_t *error) {
+    frame_error_t err = FRAME_OK;
+    frame_reader_t *reader = NULL;
+    unsigned char *index = NULL;
+
+    if (!filename) {
+        if (error) *error = FRAME_ERROR_NULL_PTR;
+        return NULL;
+    }
+
+    FILE *fp = fopen(filename, "rb");
+    if (!fp) {
+        if (error) *error = FRAME_ERROR_FILE_OPEN;
+        return NULL;
+    }
+
+    unsigned char header[FRAME_HEADER_SIZE];
+    unsigned char footer[FRAME_FOOTER_SIZE];
+    size_t block_size = 0;
+    uint64_t index_offset = 0;
+    size_t count = 0;
+    off_t file_len = 0;
+
+    if (fread(header, 1, sizeof(header), fp) != sizeof(header)) {
+        err = FRAME_ERROR_INVALID_FORMAT;
+    } else {
+        err = decode_file_header(header, &block_size);
+    }
+    if (err == FRAME_OK) {
+        if (fseeko(fp, 0, SEEK_END) != 0 || (file_len = ftello(fp)) < (off_t)(FRAME_HEADER_SIZE + FRAME_FOOTER_SIZE) ||
+            fseeko(fp, file_len - FRAME_FOOTER_SIZE, SEEK_SET) != 0 ||
+            fread(footer, 1, sizeof(footer), fp) != sizeof(footer)) {
+            err = FRAME_ERROR_INVALID_FORMAT;
+        }
+    }
+    if (err == FRAME_OK) {
+        err = parse_footer(footer, (uint64_t)file_len, &index_offset, &count);
+    }
+
+    size_t index_len = (size_t)((uint64_t)file_len - FRAME_FOOTER_SIZE - index_offset);
+    if (err == FRAME_OK) {
+        index = (unsigned char *)malloc(index_len);
+        reader = (frame_reader_t *)calloc(1, sizeof(frame_reader_t));
+        if (reader) {
+            reader->fp = fp;
+            reader->offsets = (uint64_t *)malloc((count + 1) * sizeof(uint64_t));
+            reader->raw_starts = (uint64_t *)malloc((count + 1) * sizeof(uint64_t));
+            reader->packed = (unsigned char *)malloc(block_size);
+            reader->cache = (unsigned char *)malloc(block_size);
+        }
+        if (!index || !reader || !reader->offsets || !reader->raw_starts || !reader->packed || !reader->cache) {
+            err = FRAME_ERROR_MEMORY;
+        }
+    }
+    if (err == FRAME_OK) {
+        if (fseeko(fp, (off_t)index_offset, SEEK_SET) != 0 || fread(index, 1, index_len, fp) != index_len) {
+            err = FRAME_ERROR_FILE_READ;
+        } else {
+            err = parse_trailer(index, index_len, count);
+        }
+    }
+    if (err == FRAME_OK) {
+        const unsigned char *entries = index + FRAME_INDEX_HEAD_SIZE;
+        uint64_t raw = 0;
+        for (size_t i = 0; i < count; i++) {
+            const unsigned char *entry = entries + i * FRAME_INDEX_ENTRY_SIZE;
+            size_t raw_len = get_le32(entry + 8);
+            if (raw_len == 0 || raw_len > block_size) {
+                err = FRAME_ERROR_INVALID_FORMAT;
+                break;
+            }
+            reader->offsets[i] = get_le64(entry);
+            reader->raw_starts[i] = raw;
+            raw += raw_len;
+        }
+        reader->raw_starts[count] = raw;
+    }
+
+    free(index);
+    if (err != FRAME_OK) {
+        frame_reader_close(reader);
+        if (!reader) fclose(fp);
+        if (error) *error = err;
+        return NULL;
+    }
+
+    reader->block_size = block_size;
+    reader->count = count;
+    reader->cache_block = count;
+    crc32_get_table(CRC32_C);
+    if (error) *error = FRAME_OK;
+    return reader;
+}
+
+void frame_reader_close(frame_reader_t *reader) {
+    if (!reader) return;
+    if (reader->fp) fclose(reader->fp);
+    free(reader->offsets);
+    free(reader->raw_starts);
+    free(reader->packed);
+    free(reader->cache);
+    free(reader);
+}
+
+uint64_t frame_reader_get_size(const frame_reader_t *reader) {
+    return reader ? reader->raw_starts[reader->count] : 0;
+}
+
+size_t frame_reader_get_block_count(const frame_reader_t *reader) {
+    return reader ? reader->count : 0;
+}
+
+static frame_error_t reader_load_block(frame_reader_t *reader, size_t block) {
+    if (reader->cache_block == block) return FRAME_OK;
+
+    unsigned char header[FRAME_BLOCK_HEADER_SIZE];
+    frame_slot_t slot;
+    memset(&slot, 0, sizeof(slot));
+
+    if (fseeko(reader->fp, (off_t)reader->offsets[block], SEEK_SET) != 0 ||
+        fread(header, 1, sizeof(header), reader->fp) != sizeof(header)) {
+        return FRAME_ERROR_FILE_READ;
+    }
+    frame_error_t error = decode_block_header(header, reader->block_size, &slot);
+    if (error != FRAME_OK) return error;
+    if (slot.raw_len != reader->raw_starts[block + 1] - reader->raw_starts[block]) {
+        return FRAME_ERROR_INVALID_FORMAT;
+    }
+    if (fread(reader->packed, 1, slot.src_len, reader->fp) != slot.src_len) {
+        return FRAME_ERROR_FILE_READ;
+    }
+
+    slot.src = reader->packed;
+    slot.dst = reader->cache;
+    slot.dst_cap = reader->block_size;
+    reader->cache_block = reader->count;
+    decompress_block_task(&slot);
+    if (slot.error != FRAME_OK) return slot.error;
+
+    reader->cache_block = block;
+    reader->cache_len = slot.raw_len;
+    return FRAME_OK;
+}
+
+frame_error_t frame_reader_read(frame_reader_t *reader, uint64_t offset, void *buffer, size_t len,
+                                size_t *read_len) {
+    if (!reader || (!buffer && len > 0) || !read_len) return FRAME_ERROR_NULL_PTR;
+    *read_len = 0;
+    uint64_t size = reader->raw_starts[reader->count];
+    if (offset > size) return FRAME_ERROR_OUT_OF_RANGE;
+
+    /* 二分查找包含 offset 的块 */
+    size_t lo = 0, hi = reader->count;
+    while (hi - lo > 1) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (reader->raw_starts[mid] <= offset) lo = mid;
+        else hi = mid;
+    }
+
+    unsigned char *out = (unsigned char *)buffer;
+    size_t done = 0;
+    for (size_t block = lo; done < len && block < reader->count; block++) {
+        frame_error_t error = reader_load_block(reader, block);
+        if (error != FRAME_OK) return error;
+        size_t start = (size_t)(offset + done - reader->raw_starts[block]);
+        size_t n = reader->cache_len - start;
+        if (n > len - done) n = len - done;
+        memcpy(out + done, reader->cache + start, n);
+        done += n;
+    }
+
+    *read_len = done;
+    return FRAME_OK;
+}
+
+const char *frame_error_string(frame_error_t error) {
+    switch (error) {
+        case FRAME_OK: return "Success";
+        case FRAME_ERROR_NULL_PTR: return "Null pointer";
+        case FRAME_ERROR_INVALID_ARGS: return "Invalid arguments";
+        case FRAME_ERROR_MEMORY: return "Memory allocation failed";
+        case FRAME_ERROR_FILE_OPEN: return "Failed to open file";
+        case FRAME_ERROR_FILE_READ: return "Failed to read file";
+        case FRAME_ERROR_FILE_WRITE: return "Failed to write file";
+        case FRAME_ERROR_BUFFER_TOO_SMALL: return "Output buffer too small";
+        case FRAME_ERROR_INVALID_FORMAT: return "Invalid frame format";
+        case FRAME_ERROR_CHECKSUM: return "Checksum mismatch";
+        case FRAME_ERROR_CODEC: return "Block codec failed";
+        case FRAME_ERROR_OUT_OF_RANGE: return "Offset out of range";
+        default: return "Unknown error";
+    }
+}
@@ -0,0 +1,114 @@
+#ifndef C_UTILS_FRAME_COMPRESS_H
+#define C_UTILS_FRAME_COMPRESS_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "threadpool.h"
+
+// 分块压缩容器
+//
+// 输入被切分为固定大小、互相独立的块, 每块单独选择编码器并记录
+// 原始长度、压缩长度和原始数据的 CRC32C. 文件布局 (小端):
+//
+//   文件头   16 字节: "CUFZ" | 版本 | 默认编码 | 保留 | 块大小
+//   块       16 字节块头 (编码 | 保留 | 原始长度 | 压缩长度 | CRC32C) + 压缩数据
+//   ...
+//   块索引   "CUFI" | 块数 | 每块 (块头偏移 u64, 原始长度 u32, 压缩长度 u32) | 索引 CRC32C
+//   文件尾   16 字节: 索引偏移 u64 | 块数 u32 | "CUFE"
+//
+// 块压缩后不变小时按 STORE 保存. 压缩与解压在线程池上并行进行,
+// 同时在途的块数有上限, 因此内存占用与输入总大小无关.
+// 文件尾的块索引支持按原始偏移随机读取.
+
+#define FRAME_DEFAULT_BLOCK_SIZE (1u << 20)
+#define FRAME_MIN_BLOCK_SIZE     (1u << 10)
+#define FRAME_MAX_BLOCK_SIZE     (64u << 20)
+#define FRAME_HEADER_SIZE        16
+#define FRAME_BLOCK_HEADER_SIZE  16
+#define FRAME_FOOTER_SIZE        16
+
+// 帧压缩错误码
+typedef enum {
+    FRAME_OK = 0,
+    FRAME_ERROR_NULL_PTR,
+    FRAME_ERROR_INVALID_ARGS,
+    FRAME_ERROR_MEMORY,
+    FRAME_ERROR_FILE_OPEN,
+    FRAME_ERROR_FILE_READ,
+    FRAME_ERROR_FILE_WRITE,
+    FRAME_ERROR_BUFFER_TOO_SMALL,
+    FRAME_ERROR_INVALID_FORMAT,
+    FRAME_ERROR_CHECKSUM,
+    FRAME_ERROR_CODEC,
+    FRAME_ERROR_OUT_OF_RANGE
+} frame_error_t;
+
+// 块编码器 (数值写入文件, 不可修改)
+typedef enum {
+    FRAME_CODEC_STORE = 0,
+    FRAME_CODEC_RLE = 1,
+    FRAME_CODEC_LZW = 2,
+    FRAME_CODEC_HUFFMAN = 3,
+    FRAME_CODEC_DEFLATE = 4
+} frame_codec_t;
+
+// 帧压缩配置
+typedef struct {
+    frame_codec_t codec;     // 块编码器
+    int level;               // DEFLATE 压缩级别 (1-9), 其他编码器忽略
+    size_t block_size;       // 块大小, 范围 [FRAME_MIN_BLOCK_SIZE, FRAME_MAX_BLOCK_SIZE]
+    size_t max_inflight;     // 同时在途的最大块数, 0 表示线程数的两倍
+    threadpool_t *pool;      // 线程池, NULL 时临时创建 CPU 核心数大小的线程池
+} frame_config_t;
+
+// 帧压缩统计
+typedef struct {
+    uint64_t raw_size;        // 原始数据总长度
+    uint64_t compressed_size; // 容器总长度 (含头、索引和尾)
+    size_t block_count;       // 块数
+    size_t stored_blocks;     // 以 STORE 保存的块数
+} frame_stats_t;
+
+// 随机访问读取器
+typedef struct frame_reader frame_reader_t;
+
+// 获取默认配置 (DEFLATE 级别 6, 1MB 块)
+frame_config_t frame_default_config(void);
+
+// 计算压缩 input_len 字节所需的最大输出长度
+size_t frame_compress_bound(size_t input_len, size_t block_size);
+
+// 压缩/解压内存缓冲区
+// config 为 NULL 时使用默认配置, 解压时只使用其中的线程池与在途块数设置
+// stats 可为 NULL
+frame_error_t frame_compress_buffer(const void *input, size_t input_len, void *output, size_t output_size,
+                                    size_t *output_len, const frame_config_t *config, frame_stats_t *stats);
+frame_error_t frame_decompress_buffer(const void *input, size_t input_len, void *output, size_t output_size,
+                                      size_t *output_len, const frame_config_t *config, frame_stats_t *stats);
+
+// 从容器尾部的索引中读取原始数据总长度
+frame_error_t frame_get_decompressed_size(const void *input, size_t input_len, uint64_t *size);
+
+// 压缩/解压文件, 顺序读写, 内存占用只与块大小和在途块数有关
+// 解压不依赖文件尾索引, 输入可以是管道
+frame_error_t frame_compress_file(const char *input_filename, const char *output_filename,
+                                  const frame_config_t *config, frame_stats_t *stats);
+frame_error_t frame_decompress_file(const char *input_filename, const char *output_filename,
+                                    const frame_config_t *config, frame_stats_t *stats);
+
+// 打开容器文件并加载块索引
+frame_reader_t *frame_reader_open(const char *filename, frame_error_t *error);
+void frame_reader_close(frame_reader_t *reader);
+uint64_t frame_reader_get_size(const frame_reader_t *reader);
+size_t frame_reader_get_block_count(const frame_reader_t *reader);
+
+// 从原始偏移 offset 开始读取最多 len 字节, 只解压覆盖的块
+// read_len 返回实际读取长度 (到达末尾时可能小于 len)
+frame_error_t frame_reader_read(frame_reader_t *reader, uint64_t offset, void *buffer, size_t len,
+                                size_t *read_len);
+
+// 获取错误信息
+const char *frame_error_string(frame_error_t error);
+
+#endif // C_UTILS_FRAME_COMPRESS_H
@@ -0,0 +1,466 @@
+#include "graph_csr.h"
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+
+struct graph_csr_builder_s {
+    size_t nodes;
+    size_t count;
+    size_t capacity;
+    int *src;
+    int *dst;
+    int *weight;
+};
+
+graph_csr_builder_t* graph_csr_builder_create(size_t nodes) {
+    graph_csr_builder_t *b = calloc(1, sizeof(graph_csr_builder_t));
+    if (!b) return NULL;
+    b->nodes = nodes;
+    return b;
+}
+
+void graph_csr_builder_free(graph_csr_builder_t *b) {
+    if (!b) return;
+    free(b->src);
+    free(b->dst);
+    free(b->weight);
+    free(b);
+}
+
+static bool builder_reserve(graph_csr_builder_t *b, size_t capacity) {
+    if (capacity <= b->capacity) return true;
+    int *src = realloc(b->src, capacity * sizeof(int));
+    if (!src) return false;
+    b->src = src;
+    int *dst = realloc(b->dst, capacity * sizeof(int));
+    if (!dst) return false;
+    b->dst = dst;
+    int *weight = realloc(b->weight, capacity * sizeof(int));
+    if (!weight) return false;
+    b->weight = weight;
+    b->capacity = capacity;
+    return true;
+}
+
+bool graph_csr_builder_add_edge(graph_csr_builder_t *b, int src, int dst, int weight) {
+    if (!b || src < 0 || dst < 0) return false;
+    if (b->count == b->capacity && !builder_reserve(b, b->capacity ? b->capacity * 2 : 1024)) return false;
+    b->src[b->count] = src;
+    b->dst[b->count] = dst;
+    b->weight[b->count] = weight;
+    b->count++;
+    size_t top = (size_t)(src > dst ? src : dst) + 1;
+    if (top > b->nodes) b->nodes = top;
+    return true;
+}
+
+size_t graph_csr_builder_edge_count(const graph_csr_builder_t *b) {
+    return b ? b->count : 0;
+}
+
+graph_csr_t* graph_csr_builder_build(const graph_csr_builder_t *b) {
+    if (!b) return NULL;
+    return graph_csr_from_edges(b->nodes, b->src, b->dst, b->weight, b->count);
+}
+
+graph_csr_t* graph_csr_from_edges(size_t nodes, const int *src, const int *dst, const int *weight, size_t count) {
+    if (count && (!src || !dst)) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (src[i] < 0 || dst[i] < 0 || (size_t)src[i] >= nodes || (size_t)dst[i] >= nodes) return NULL;
+    }
+
+    graph_csr_t *g = calloc(1, sizeof(graph_csr_t));
+    if (!g) return NULL;
+    g->nodes = nodes;
+    g->edges = count;
+    g->offsets = calloc(nodes + 1, sizeof(size_t));
+    g->targets = malloc((count ? count : 1) * sizeof(int));
+    g->weights = malloc((count ? count : 1) * sizeof(int));
+    if (!g->offsets || !g->targets || !g->weights) {
+        graph_csr_free(g);
+        return NULL;
+    }
+
+    // 计数排序: 先统计出度得到每个起点的写入位置, 再按原顺序放置, 保持同一起点内的添加顺序
+    for (size_t i = 0; i < count; i++) g->offsets[src[i] + 1]++;
+    for (size_t u = 0; u < nodes; u++) g->offsets[u + 1] += g->offsets[u];
+    size_t *cursor = malloc((nodes ? nodes : 1) * sizeof(size_t));
+    if (!cursor) {
+        graph_csr_free(g);
+        return NULL;
+    }
+    memcpy(cursor, g->offsets, nodes * sizeof(size_t));
+    for (size_t i = 0; i < count; i++) {
+        size_t at = cursor[src[i]]++;
+        g->targets[at] = dst[i];
+        g->weights[at] = weight ? weight[i] : 1;
+    }
+    free(cursor);
+    return g;
+}
+
+void graph_csr_free(graph_csr_t *g) {
+    if (!g) return;
+    free(g->offsets);
+    free(g->targets);
+    free(g->weights);
+    free(g);
+}
+
+/* ---------- 边列表读取 ---------- */
+
+#define EDGE_LIST_CHUNK 65536
+
+static const char* skip_blank(const char *p, const char *end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) p++;
+    return p;
+}
+
+// 解析一个十进制整数, 失败返回 NULL
+static const char* parse_int(const char *p, const char *end, int *out) {
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+')) negative = *p++ == '-';
+    if (p >= end || *p < '0' || *p > '9') return NULL;
+    long long value = 0;
+    while (p < end && *p >= '0' && *p <= '9') {
+        value = value * 10 + (*p++ - '0');
+        if (value > (long long)INT_MAX + 1) return NULL;
+    }
+    if (negative) value = -value;
+    if (value > INT_MAX || value < INT_MIN) return NULL;
+    *out = (int)value;
+    return p;
+}
+
+static bool parse_edge_line(graph_csr_builder_t *b, const char *p, const char *end, bool undirected) {
+    p = skip_blank(p, end);
+    if (p == end || *p == '#' || *p == '%') return true;
+
+    int src, dst, weight = 1;
+    if (!(p = parse_int(p, end, &src))) return false;
+    p = skip_blank(p, end);
+    if (!(p = parse_int(p, end, &dst))) return false;
+    p = skip_blank(p, end);
+    if (p < end && !(p = parse_int(p, end, &weight))) return false;
+    if (skip_blank(p, end) != end) return false;
+
+    if (!graph_csr_builder_add_edge(b, src, dst, weight)) return false;
+    return !undirected || src == dst || graph_csr_builder_add_edge(b, dst, src, weight);
+}
+
+graph_csr_t* graph_csr_read_edge_list(FILE *fp, bool undirected) {
+    if (!fp) return NULL;
+    graph_csr_builder_t *b = graph_csr_builder_create(0);
+    size_t cap = EDGE_LIST_CHUNK;
+    char *buf = malloc(cap);
+    bool ok = b && buf;
+    size_t len = 0;
+    bool eof = false;
+
+    while (ok && !eof) {
+        // 单行超过缓冲区时扩容
+        if (len == cap) {
+            char *grown = realloc(buf, cap * 2);
+            if (!grown) {
+                ok = false;
+                break;
+            }
+            buf = grown;
+            cap *= 2;
+        }
+        size_t got = fread(buf + len, 1, cap - len, fp);
+        if (got == 0) {
+            if (ferror(fp)) {
+                ok = false;
+                break;
+            }
+            eof = true;
+        }
+        len += got;
+
+        // 处理缓冲区内的完整行, 文件末尾最后一行可以没有换行符
+        size_t start = 0;
+        while (ok) {
+            char *nl = memchr(buf + start, '\n', len - start);
+            if (!nl) {
+                if (eof && start < len) {
+                    ok = parse_edge_line(b, buf + start, buf + len, undirected);
+                    start = len;
+                }
+                break;
+            }
+            ok = parse_edge_line(b, buf + start, nl, undirected);
+            start = (size_t)(nl - buf) + 1;
+        }
+        memmove(buf, buf + start, len - start);
+        len -= start;
+    }
+
+    graph_csr_t *g = ok ? graph_csr_builder_build(b) : NULL;
+    free(buf);
+    graph_csr_builder_free(b);
+    return g;
+}
+
+graph_csr_t* graph_csr_load_edge_list(const char *path, bool undirected) {
+    if (!path) return NULL;
+    FILE *fp = fopen(path, "r");
+    if (!fp) return NULL;
+    graph_csr_t *g = graph_csr_read_edge_list(fp, undirected);
+    fclose(fp);
+    return g;
+}
+
+graph_csr_t* graph_csr_transpose(const graph_csr_t *g) {
+    if (!g) return NULL;
+    graph_csr_t *t = calloc(1, sizeof(graph_csr_t));
+    if (!t) return NULL;
+    t->nodes = g->nodes;
+    t->edges = g->edges;
+    t->offsets = calloc(g->nodes + 1, sizeof(size_t));
+    t->targets = malloc((g->edges ? g->edges : 1) * sizeof(int));
+    t->weights = malloc((g->edges ? g->edges : 1) * sizeof(int));
+    size_t *cursor = malloc((g->nodes ? g->nodes : 1) * sizeof(size_t));
+    if (!t->offsets || !t->targets || !t->weights || !cursor) {
+        free(cursor);
+        graph_csr_free(t);
+        return NULL;
+    }
+
+    for (size_t i = 0; i < g->edges; i++) t->offsets[g->targets[i] + 1]++;
+    for (size_t v = 0; v < g->nodes; v++) t->offsets[v + 1] += t->offsets[v];
+    memcpy(cursor, t->offsets, g->nodes * sizeof(size_t));
+    for (size_t u = 0; u < g->nodes; u++) {
+        for (size_t i = g->offsets[u]; i < g->offsets[u + 1]; i++) {
+            size_t at = cursor[g->targets[i]]++;
+            t->targets[at] = (int)u;
+            t->weights[at] = g->weights[i];
+        }
+    }
+    free(cursor);
+    return t;
+}
+
+/* ---------- 并行循环 ---------- */
+
+typedef struct {
+    graph_csr_range_fn fn;
+    void *ctx;
+    size_t count;
+    size_t grain;
+    size_t next;
+} pfor_shared_t;
+
+typedef struct {
+    pfor_shared_t *shared;
+    int worker;
+} pfor_task_t;
+
+static void pfor_run(void *arg) {
+    pfor_task_t *task = arg;
+    pfor_shared_t *sh = task->shared;
+    for (;;) {
+        size_t begin = __atomic_fetch_add(&sh->next, sh->grain, __ATOMIC_RELAXED);
+        if (begin >= sh->count) break;
+        size_t end = begin + sh->grain < sh->count ? begin + sh->grain : sh->count;
+        sh->fn(sh->ctx, begin, end, task->worker);
+    }
+}
+
+int graph_csr_worker_count(threadpool_t *pool) {
+    if (!pool) return 1;
+    int threads = threadpool_get_thread_count(pool);
+    return threads > 1 ? threads : 1;
+}
+
+void graph_csr_parallel_for(threadpool_t *pool, size_t count, size_t grain, graph_csr_range_fn fn, void *ctx) {
+    if (count == 0 || !fn) return;
+    if (grain == 0) grain = 1;
+    size_t workers = (size_t)graph_csr_worker_count(pool);
+    size_t chunks = (count + grain - 1) / grain;
+    if (workers > chunks) workers = chunks;
+
+    pfor_shared_t shared = { fn, ctx, count, grain, 0 };
+    pfor_task_t *tasks = workers > 1 ? malloc(workers * sizeof(pfor_task_t)) : NULL;
+    int *ids = workers > 1 ? calloc(workers, sizeof(int)) : NULL;
+    if (!tasks || !ids) {
+        free(tasks);
+        free(ids);
+        fn(ctx, 0, count, 0);
+        return;
+    }
+
+    // 任务 0 由调用线程执行, 提交失败的任务也在调用线程补做
+    for (size_t w = 0; w < workers; w++) tasks[w] = (pfor_task_t){ &shared, (int)w };
+    for (size_t w = 1; w < workers; w++) ids[w] = threadpool_add_task(pool, pfor_run, &tasks[w]);
+    pfor_run(&tasks[0]);
+    for (size_t w = 1; w < workers; w++) {
+        if (ids[w] != 0) {
+            threadpool_wait_task(pool, ids[w], -1);
+        } else {
+            pfor_run(&tasks[w]);
+        }
+    }
+    free(tasks);
+    free(ids);
+}
+
+/* ---------- 方向优化 BFS ---------- */
+
+#define BFS_ALPHA 14
+#define BFS_BETA 24
+#define BFS_LOCAL 256
+
+typedef struct {
+    const graph_csr_t *graph;
+    const graph_csr_t *reverse;
+    int *parent;
+    int *depth;
+    int level;
+    const int *queue;            // 自顶向下: 当前前沿
+    int *next_queue;
+    size_t next_size;
+    const unsigned char *front;  // 自底向上: 当前前沿标记
+    unsigned char *next;
+    size_t next_edges;           // 新前沿的出边总数
+} bfs_ctx_t;
+
+static void bfs_top_down(void *arg, size_t begin, size_t end, int worker) {
+    (void)worker;
+    bfs_ctx_t *c = arg;
+    int local[BFS_LOCAL];
+    size_t count = 0, edges = 0;
+    for (size_t i = begin; i < end; i++) {
+        int u = c->queue[i];
+        const int *to;
+        size_t degree = graph_csr_neighbors(c->graph, u, &to, NULL);
+        for (size_t k = 0; k < degree; k++) {
+            int v = to[k];
+            int expected = -1;
+            if (__atomic_load_n(&c->parent[v], __ATOMIC_RELAXED) != -1 ||
+                !__atomic_compare_exchange_n(&c->parent[v], &expected, u, false, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                continue;
+            }
+            if (c->depth) c->depth[v] = c->level + 1;
+            edges += graph_csr_degree(c->graph, v);
+            local[count++] = v;
+            if (count == BFS_LOCAL) {
+                size_t at = __atomic_fetch_add(&c->next_size, count, __ATOMIC_RELAXED);
+                memcpy(c->next_queue + at, local, count * sizeof(int));
+                count = 0;
+            }
+        }
+    }
+    if (count) {
+        size_t at = __atomic_fetch_add(&c->next_size, count, __ATOMIC_RELAXED);
+        memcpy(c->next_queue + at, local, count * sizeof(int));
+    }
+    __atomic_fetch_add(&c->next_edges, edges, __ATOMIC_RELAXED);
+}
+
+// 每个未访问节点只由负责它的任务写入, 不需要原子操作
+static void bfs_bottom_up(void *arg, size_t begin, size_t end, int worker) {
+    (void)worker;
+    bfs_ctx_t *c = arg;
+    size_t count = 0, edges = 0;
+    for (size_t v = begin; v < end; v++) {
+        if (c->parent[v] != -1) continue;
+        const int *from;
+        size_t degree = graph_csr_neighbors(c->reverse, (int)v, &from, NULL);
+        for (size_t k = 0; k < degree; k++) {
+            if (c->front[from[k]]) {
+                c->parent[v] = from[k];
+                if (c->depth) c->depth[v] = c->level + 1;
+                c->next[v] = 1;
+                count++;
+                edges += graph_csr_degree(c->graph, (int)v);
+                break;
+            }
+        }
+    }
+    __atomic_fetch_add(&c->next_size, count, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&c->next_edges, edges, __ATOMIC_RELAXED);
+}
+
+size_t graph_csr_bfs(const graph_csr_t *graph, const graph_csr_t *reverse, int source,
+                     int *parent, int *depth, threadpool_t *pool) {
+    if (!graph || source < 0 || (size_t)source >= graph->nodes) return 0;
+    if (reverse && reverse->nodes != graph->nodes) return 0;
+    size_t n = graph->nodes;
+
+    int *own_parent = parent ? NULL : malloc(n * sizeof(int));
+    int *queue = malloc(n * sizeof(int));
+    int *next_queue = malloc(n * sizeof(int));
+    unsigned char *front = reverse ? malloc(n) : NULL;
+    unsigned char *next = reverse ? malloc(n) : NULL;
+    if (!parent) parent = own_parent;
+    if (!parent || !queue || !next_queue || (reverse && (!front || !next))) {
+        free(own_parent);
+        free(queue);
+        free(next_queue);
+        free(front);
+        free(next);
+        return 0;
+    }
+
+    for (size_t i = 0; i < n; i++) parent[i] = -1;
+    if (depth) {
+        for (size_t i = 0; i < n; i++) depth[i] = -1;
+        depth[source] = 0;
+    }
+    parent[source] = source;
+    queue[0] = source;
+
+    bfs_ctx_t c = { .graph = graph, .reverse = reverse, .parent = parent, .depth = depth };
+    size_t frontier = 1;
+    size_t frontier_edges = graph_csr_degree(graph, source);
+    size_t unexplored_edges = graph->edges - frontier_edges;
+    size_t reached = 1;
+    bool bottom_up = false;
+
+    while (frontier > 0) {
+        if (!bottom_up && reverse && frontier_edges > unexplored_edges / BFS_ALPHA) {
+            memset(front, 0, n);
+            for (size_t i = 0; i < frontier; i++) front[queue[i]] = 1;
+            bottom_up = true;
+        } else if (bottom_up && frontier < n / BFS_BETA) {
+            size_t count = 0;
+            for (size_t v = 0; v < n; v++) {
+                if (front[v]) queue[count++] = (int)v;
+            }
+            bottom_up = false;
+        }
+
+        c.next_size = 0;
+        c.next_edges = 0;
+        if (bottom_up) {
+            memset(next, 0, n);
+            c.front = front;
+            c.next = next;
+            graph_csr_parallel_for(pool, n, 4096, bfs_bottom_up, &c);
+            unsigned char *tmp = front;
+            front = next;
+            next = tmp;
+        } else {
+            c.queue = queue;
+            c.next_queue = next_queue;
+            graph_csr_parallel_for(pool, frontier, 256, bfs_top_down, &c);
+            int *tmp = queue;
+            queue = next_queue;
+            next_queue = tmp;
+        }
+
+        frontier = c.next_size;
+        frontier_edges = c.next_edges;
+        unexplored_edges -= frontier_edges < unexplored_edges ? frontier_edges : unexplored_edges;
+        reached += frontier;
+        c.level++;
+    }
+
+    free(own_parent);
+    free(queue);
+    free(next_queue);
+    free(front);
+    free(next);
+    return reached;
+}
@@ -0,0 +1,75 @@
+#ifndef C_UTILS_GRAPH_CSR_H
+#define C_UTILS_GRAPH_CSR_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include "threadpool.h"
+
+// 压缩稀疏行 (CSR) 有向图, 构建后只读
+// 节点 u 的出边为 targets/weights 的 [offsets[u], offsets[u+1]) 区间, 同一起点的边保持添加顺序
+// 无向图按两条方向相反的有向边添加
+typedef struct {
+    size_t nodes;
+    size_t edges;
+    size_t *offsets;     // nodes + 1 项
+    int *targets;
+    int *weights;
+} graph_csr_t;
+
+typedef struct graph_csr_builder_s graph_csr_builder_t;
+
+// 构建器: 逐条添加边, 节点数按出现过的最大编号自动扩大
+graph_csr_builder_t* graph_csr_builder_create(size_t nodes);
+void                 graph_csr_builder_free(graph_csr_builder_t *b);
+// 返回: 节点编号为负或内存不足返回 false
+bool                 graph_csr_builder_add_edge(graph_csr_builder_t *b, int src, int dst, int weight);
+size_t               graph_csr_builder_edge_count(const graph_csr_builder_t *b);
+// 按起点计数排序生成 CSR, 构建器仍可继续使用 (内存不足返回 NULL)
+graph_csr_t*         graph_csr_builder_build(const graph_csr_builder_t *b);
+
+// 由边数组直接构建 (weight 为 NULL 时权重均为 1)
+graph_csr_t* graph_csr_from_edges(size_t nodes, const int *src, const int *dst, const int *weight, size_t count);
+void         graph_csr_free(graph_csr_t *g);
+
+// 流式读取文本边列表: 每行 "src dst [weight]", 缺省权重为 1, 空行和以 # 或 % 开头的行忽略
+// 按 64KB 块读取, 不把整个文件载入内存; undirected 为 true 时每条边加入两个方向
+// 返回: 格式错误、节点编号为负或内存不足返回 NULL
+graph_csr_t* graph_csr_read_edge_list(FILE *fp, bool undirected);
+graph_csr_t* graph_csr_load_edge_list(const char *path, bool undirected);
+
+// 转置图 (所有边反向), 用于按入边遍历
+graph_csr_t* graph_csr_transpose(const graph_csr_t *g);
+
+// 出度
+static inline size_t graph_csr_degree(const graph_csr_t *g, int u) {
+    return g->offsets[u + 1] - g->offsets[u];
+}
+
+// 零拷贝遍历出边: 返回出度, targets/weights 指向图内部数组 (可为 NULL)
+static inline size_t graph_csr_neighbors(const graph_csr_t *g, int u, const int **targets, const int **weights) {
+    size_t begin = g->offsets[u];
+    if (targets) *targets = g->targets + begin;
+    if (weights) *weights = g->weights + begin;
+    return g->offsets[u + 1] - begin;
+}
+
+// 方向优化 BFS: 前沿较小时自顶向下扩展出边, 前沿覆盖的边数超过未访问边数的 1/14 时
+// 切换为自底向上, 由未访问节点沿入边查找前沿中的父节点; 前沿缩小到节点数的 1/24 以下时切回
+// reverse: 入边图 (graph_csr_transpose 的结果, 无向图传 graph 本身), NULL 时只做自顶向下
+// parent: 输出父节点, 源点为自身, 不可达为 -1 (可为 NULL)
+// depth: 输出层数, 不可达为 -1 (可为 NULL)
+// pool: 每层的扩展在线程池上并行, NULL 时在调用线程执行
+// 返回: 可达节点数 (含源点), 参数错误或内存不足返回 0
+size_t graph_csr_bfs(const graph_csr_t *graph, const graph_csr_t *reverse, int source,
+                     int *parent, int *depth, threadpool_t *pool);
+
+// 图算法共用的并行循环
+// [0, count) 按 grain 个元素一块, 由 graph_csr_worker_count(pool) 个任务 (调用线程也参与) 动态领取
+// fn 收到任务编号 worker (0 .. worker_count-1), 可用来索引每任务的私有缓冲区
+// pool 为 NULL 或 count <= grain 时直接在调用线程以 worker 0 执行
+typedef void (*graph_csr_range_fn)(void *ctx, size_t begin, size_t end, int worker);
+int  graph_csr_worker_count(threadpool_t *pool);
+void graph_csr_parallel_for(threadpool_t *pool, size_t count, size_t grain, graph_csr_range_fn fn, void *ctx);
+
+#endif // C_UTILS_GRAPH_CSR_H
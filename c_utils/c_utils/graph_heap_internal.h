@@ -0,0 +1,105 @@
+#ifndef C_UTILS_GRAPH_HEAP_INTERNAL_H
+#define C_UTILS_GRAPH_HEAP_INTERNAL_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+
+// 图搜索内部共用的带位置索引的四叉最小堆 (dijkstra / prim / astar), 不属于公共接口
+// node 与 key 并排存放, 比较时只读 key; pos[v] 为节点 v 在堆中的下标, 支持原地 decrease-key
+
+#define GRAPH_HEAP_ARITY 4
+
+// 按键类型与位置类型生成 name##_sift_up 与 name##_pop, 三个数组由调用者持有:
+//   sift_up(node, key, pos, i, v, k): 把节点 v 以键 k 放到下标 i 并上浮, i 为新槽位或 v 的当前位置
+//   pop(node, key, pos, &size, done): 弹出堆顶 (size > 0), 并把它的位置置为 done
+#define GRAPH_HEAP_DEFINE(name, key_type, pos_type)                                              \
+    static inline void name##_sift_up(int *node, key_type *key, pos_type *pos, size_t i, int v, \
+                                      key_type k) {                                             \
+        while (i > 0) {                                                                         \
+            size_t parent = (i - 1) / GRAPH_HEAP_ARITY;                                         \
+            if (key[parent] <= k) break;                                                        \
+            node[i] = node[parent];                                                             \
+            key[i] = key[parent];                                                               \
+            pos[node[i]] = (pos_type)i;                                                         \
+            i = parent;                                                                         \
+        }                                                                                       \
+        node[i] = v;                                                                            \
+        key[i] = k;                                                                             \
+        pos[v] = (pos_type)i;                                                                   \
+    }                                                                                           \
+                                                                                                \
+    static inline int name##_pop(int *node, key_type *key, pos_type *pos, size_t *size,         \
+                                 pos_type done) {                                               \
+        int top = node[0];                                                                      \
+        pos[top] = done;                                                                        \
+        size_t n = --*size;                                                                     \
+        if (n == 0) return top;                                                                 \
+                                                                                                \
+        int v = node[n];                                                                        \
+        key_type k = key[n];                                                                    \
+        size_t i = 0;                                                                           \
+        for (;;) {                                                                              \
+            size_t first = i * GRAPH_HEAP_ARITY + 1;                                            \
+            if (first >= n) break;                                                              \
+            size_t last = first + GRAPH_HEAP_ARITY < n ? first + GRAPH_HEAP_ARITY : n;          \
+            size_t best = first;                                                                \
+            for (size_t c = first + 1; c < last; c++) {                                         \
+                if (key[c] < key[best]) best = c;                                               \
+            }                                                                                   \
+            if (key[best] >= k) break;                                                          \
+            node[i] = node[best];                                                               \
+            key[i] = key[best];                                                                 \
+            pos[node[i]] = (pos_type)i;                                                         \
+            i = best;                                                                           \
+        }                                                                                       \
+        node[i] = v;                                                                            \
+        key[i] = k;                                                                             \
+        pos[v] = (pos_type)i;                                                                   \
+        return top;                                                                             \
+    }
+
+GRAPH_HEAP_DEFINE(graph_heap_int, int, int)
+
+// int 键的堆 (dijkstra 的距离, prim 的连接边权)
+#define GRAPH_POS_NONE (-1)   // 未入堆
+#define GRAPH_POS_DONE (-2)   // 已出堆, 键值已确定
+
+typedef struct {
+    int *node;
+    int *key;
+    int *pos;
+    size_t size;
+} graph_heap_t;
+
+// 分配 n 个节点的堆, 全部标记为未入堆; 失败时已分配的部分由 graph_heap_free 释放
+static inline bool graph_heap_init(graph_heap_t *h, size_t n) {
+    h->node = malloc(n * sizeof(int));
+    h->key = malloc(n * sizeof(int));
+    h->pos = malloc(n * sizeof(int));
+    h->size = 0;
+    if (!h->node || !h->key || !h->pos) return false;
+    for (size_t i = 0; i < n; i++) h->pos[i] = GRAPH_POS_NONE;
+    return true;
+}
+
+static inline void graph_heap_free(graph_heap_t *h) {
+    free(h->node);
+    free(h->key);
+    free(h->pos);
+}
+
+// 节点 v 首次以键 k 入堆
+static inline void graph_heap_push(graph_heap_t *h, int v, int k) {
+    graph_heap_int_sift_up(h->node, h->key, h->pos, h->size++, v, k);
+}
+
+// 已在堆中的节点 v 的键减小为 k
+static inline void graph_heap_decrease(graph_heap_t *h, int v, int k) {
+    graph_heap_int_sift_up(h->node, h->key, h->pos, (size_t)h->pos[v], v, k);
+}
+
+static inline int graph_heap_pop(graph_heap_t *h) {
+    return graph_heap_int_pop(h->node, h->key, h->pos, &h->size, GRAPH_POS_DONE);
+}
+
+#endif // C_UTILS_GRAPH_HEAP_INTERNAL_H
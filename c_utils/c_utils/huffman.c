@@ -2,6 +2,7 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 void huffman_stats(const unsigned char *data, size_t len, size_t freq[256]) {
     if (freq) {
@@ -23,10 +24,44 @@ static huffman_node_t *create_node(unsigned char symbol, size_t freq) {
     return node;
 }
 
-static int compare_nodes(const void *a, const void *b) {
-    const huffman_node_t *node1 = *(const huffman_node_t **)a;
-    const huffman_node_t *node2 = *(const huffman_node_t **)b;
-    return (int)(node1->freq - node2->freq);
+typedef struct {
+    size_t freq;
+    unsigned int symbol;
+} huffman_leaf_t;
+
+static int compare_leaves(const void *a, const void *b) {
+    const huffman_leaf_t *leaf1 = (const huffman_leaf_t *)a;
+    const huffman_leaf_t *leaf2 = (const huffman_leaf_t *)b;
+    if (leaf1->freq != leaf2->freq) {
+        return leaf1->freq < leaf2->freq ? -1 : 1;
+    }
+    return (int)leaf1->symbol - (int)leaf2->symbol;
+}
+
+// 收集非零频率的符号并按 (频率, 符号) 升序排列, 返回符号个数
+static size_t collect_leaves(const size_t freq[256], huffman_leaf_t leaves[256]) {
+    size_t count = 0;
+    for (unsigned int i = 0; i < 256; i++) {
+        if (freq[i] > 0) {
+            leaves[count].freq = freq[i];
+            leaves[count].symbol = i;
+            count++;
+        }
+    }
+    qsort(leaves, count, sizeof(huffman_leaf_t), compare_leaves);
+    return count;
+}
+
+// 双队列合并: 叶子已排序, 新生成的内部节点频率单调不减, 每次只需比较两个队头
+static size_t pick_min(const size_t *leaf_freq, size_t *leaf_pos, size_t leaf_count,
+                       const size_t *node_freq, size_t *node_pos, size_t node_count, bool *is_leaf) {
+    if (*leaf_pos < leaf_count &&
+        (*node_pos >= node_count || leaf_freq[*leaf_pos] <= node_freq[*node_pos])) {
+        *is_leaf = true;
+        return (*leaf_pos)++;
+    }
+    *is_leaf = false;
+    return (*node_pos)++;
 }
 
 huffman_node_t *huffman_create_tree(const size_t freq[256], huffman_error_t *error) {
@@ -35,52 +70,68 @@ huffman_node_t *huffman_create_tree(const size_t freq[256], huffman_error_t *err
         return NULL;
     }
 
-    huffman_node_t *nodes[256];
-    size_t node_count = 0;
+    huffman_leaf_t leaves[256];
+    size_t leaf_count = collect_leaves(freq, leaves);
 
-    for (int i = 0; i < 256; i++) {
-        if (freq[i] > 0) {
-            nodes[node_count] = create_node((unsigned char)i, freq[i]);
-            if (!nodes[node_count]) {
-                for (size_t j = 0; j < node_count; j++) {
-                    free(nodes[j]);
-                }
-                if (error) *error = HUFFMAN_MEMORY_ERROR;
-                return NULL;
+    if (leaf_count == 0) {
+        if (error) *error = HUFFMAN_TREE_ERROR;
+        return NULL;
+    }
+
+    huffman_node_t *leaf_nodes[256];
+    huffman_node_t *inner_nodes[255];
+    size_t leaf_freq[256];
+    size_t inner_freq[255];
+    size_t inner_count = 0;
+
+    for (size_t i = 0; i < leaf_count; i++) {
+        leaf_freq[i] = leaves[i].freq;
+        leaf_nodes[i] = create_node((unsigned char)leaves[i].symbol, leaves[i].freq);
+        if (!leaf_nodes[i]) {
+            for (size_t j = 0; j < i; j++) {
+                free(leaf_nodes[j]);
             }
-            node_count++;
+            if (error) *error = HUFFMAN_MEMORY_ERROR;
+            return NULL;
         }
     }
 
-    if (node_count == 0) {
-        if (error) *error = HUFFMAN_TREE_ERROR;
-        return NULL;
+    if (leaf_count == 1) {
+        if (error) *error = HUFFMAN_OK;
+        return leaf_nodes[0];
     }
 
-    while (node_count > 1) {
-        qsort(nodes, node_count, sizeof(huffman_node_t *), compare_nodes);
+    size_t leaf_pos = 0;
+    size_t inner_pos = 0;
+    while (inner_count < leaf_count - 1) {
+        huffman_node_t *children[2];
+        for (int k = 0; k < 2; k++) {
+            bool is_leaf;
+            size_t idx = pick_min(leaf_freq, &leaf_pos, leaf_count,
+                                  inner_freq, &inner_pos, inner_count, &is_leaf);
+            children[k] = is_leaf ? leaf_nodes[idx] : inner_nodes[idx];
+        }
 
-        huffman_node_t *parent = create_node(0, nodes[0]->freq + nodes[1]->freq);
+        huffman_node_t *parent = create_node(0, children[0]->freq + children[1]->freq);
         if (!parent) {
-            for (size_t i = 0; i < node_count; i++) {
-                free(nodes[i]);
-            }
+            // 尚未挂入父节点的子树: 剩余叶子、剩余内部节点和本轮取出的两个孩子
+            for (size_t i = leaf_pos; i < leaf_count; i++) free(leaf_nodes[i]);
+            for (size_t i = inner_pos; i < inner_count; i++) huffman_free_tree(inner_nodes[i]);
+            huffman_free_tree(children[0]);
+            huffman_free_tree(children[1]);
             if (error) *error = HUFFMAN_MEMORY_ERROR;
             return NULL;
         }
 
-        parent->left = nodes[0];
-        parent->right = nodes[1];
-
-        nodes[0] = parent;
-        for (size_t i = 1; i < node_count - 1; i++) {
-            nodes[i] = nodes[i + 1];
-        }
-        node_count--;
+        parent->left = children[0];
+        parent->right = children[1];
+        inner_nodes[inner_count] = parent;
+        inner_freq[inner_count] = parent->freq;
+        inner_count++;
     }
 
     if (error) *error = HUFFMAN_OK;
-    return nodes[0];
+    return inner_nodes[inner_count - 1];
 }
 
 static void build_code_table_recursive(huffman_node_t *node, huffman_code_t table[256], 
@@ -116,6 +167,7 @@ int huffman_build_code_table(huffman_node_t *root, huffman_code_t table[256], hu
     return 0;
 }
 
+// 以 64 位累加器按 MSB 优先写出码字, 累积满 32 位时整字写出
 size_t huffman_encode(const unsigned char *input, size_t input_len, unsigned char *output, size_t output_size, 
                       const huffman_code_t table[256], huffman_error_t *error) {
     if (!input || !output || !table || input_len == 0) {
@@ -123,37 +175,49 @@ size_t huffman_encode(const unsigned char *input, size_t input_len, unsigned cha
         return 0;
     }
 
-    size_t bit_pos = 0;
+    uint64_t acc = 0;
+    unsigned int bits = 0;
     size_t byte_pos = 0;
 
     for (size_t i = 0; i < input_len; i++) {
-        unsigned char symbol = input[i];
-        unsigned int code = table[symbol].code;
-        size_t code_len = table[symbol].code_len;
+        const huffman_code_t *entry = &table[input[i]];
+        unsigned int code_len = (unsigned int)entry->code_len;
 
-        if (code_len == 0) {
+        if (code_len == 0 || code_len > 32) {
             if (error) *error = HUFFMAN_ENCODE_ERROR;
             return 0;
         }
 
-        for (size_t j = 0; j < code_len; j++) {
-            if (byte_pos >= output_size) {
+        acc = (acc << code_len) | entry->code;
+        bits += code_len;
+
+        if (bits >= 32) {
+            if (byte_pos + 4 > output_size) {
                 if (error) *error = HUFFMAN_BUFFER_TOO_SMALL;
                 return 0;
             }
-
-            unsigned int bit = (code >> (code_len - j - 1)) & 1;
-            output[byte_pos] |= (bit << (7 - (bit_pos % 8)));
-            bit_pos++;
-
-            if (bit_pos % 8 == 0) {
-                byte_pos++;
-            }
+            uint32_t word = (uint32_t)(acc >> (bits - 32));
+            output[byte_pos] = (unsigned char)(word >> 24);
+            output[byte_pos + 1] = (unsigned char)(word >> 16);
+            output[byte_pos + 2] = (unsigned char)(word >> 8);
+            output[byte_pos + 3] = (unsigned char)word;
+            byte_pos += 4;
+            bits -= 32;
         }
     }
 
-    if (bit_pos % 8 != 0) {
-        byte_pos++;
+    while (bits > 0) {
+        if (byte_pos >= output_size) {
+            if (error) *error = HUFFMAN_BUFFER_TOO_SMALL;
+            return 0;
+        }
+        if (bits >= 8) {
+            output[byte_pos++] = (unsigned char)(acc >> (bits - 8));
+            bits -= 8;
+        } else {
+            output[byte_pos++] = (unsigned char)(acc << (8 - bits));
+            bits = 0;
+        }
     }
 
     if (error) *error = HUFFMAN_OK;
@@ -217,3 +281,398 @@ void huffman_get_default_config(huffman_config_t *config) {
         config->max_tree_depth = 32;
     }
 }
+
+// ---------------------------------------------------------------------------
+// 规范哈夫曼编码
+// ---------------------------------------------------------------------------
+
+// 由排好序的叶子用双队列合并计算每个叶子的码长, 不构造指针树
+static unsigned int compute_lengths(const huffman_leaf_t *leaves, size_t count, unsigned char depth[256]) {
+    size_t leaf_freq[256];
+    size_t inner_freq[255];
+    int parent[511];
+    size_t inner_count = 0;
+    size_t leaf_pos = 0;
+    size_t inner_pos = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        leaf_freq[i] = leaves[i].freq;
+    }
+
+    // 节点编号: 叶子 0..count-1, 内部节点 count..2*count-2
+    while (inner_count < count - 1) {
+        size_t freq_sum = 0;
+        for (int k = 0; k < 2; k++) {
+            bool is_leaf;
+            size_t idx = pick_min(leaf_freq, &leaf_pos, count, inner_freq, &inner_pos, inner_count, &is_leaf);
+            freq_sum += is_leaf ? leaf_freq[idx] : inner_freq[idx];
+            parent[is_leaf ? idx : count + idx] = (int)(count + inner_count);
+        }
+        inner_freq[inner_count++] = freq_sum;
+    }
+
+    unsigned char node_depth[511];
+    size_t root = count + inner_count - 1;
+    node_depth[root] = 0;
+    for (size_t i = root; i-- > count;) {
+        node_depth[i] = (unsigned char)(node_depth[parent[i]] + 1);
+    }
+
+    unsigned int max_len = 0;
+    for (size_t i = 0; i < count; i++) {
+        unsigned int d = node_depth[parent[i]] + 1u;
+        depth[i] = (unsigned char)(d > 255 ? 255 : d);
+        if (d > max_len) max_len = d;
+    }
+    return max_len;
+}
+
+huffman_error_t huffman_build_lengths(const size_t freq[256], size_t max_len, unsigned char lengths[256]) {
+    if (!freq || !lengths || max_len < 8 || max_len > HUFFMAN_MAX_CODE_LEN) {
+        return HUFFMAN_INVALID_INPUT;
+    }
+
+    huffman_leaf_t leaves[256];
+    size_t count = collect_leaves(freq, leaves);
+
+    memset(lengths, 0, 256);
+    if (count == 0) {
+        return HUFFMAN_TREE_ERROR;
+    }
+    if (count == 1) {
+        lengths[leaves[0].symbol] = 1;
+        return HUFFMAN_OK;
+    }
+
+    // 超出长度上限时把频率减半 (保持非零) 重新计算, 频率趋于均匀后深度必然回落到 8 以内
+    unsigned char depth[256];
+    while (compute_lengths(leaves, count, depth) > max_len) {
+        for (size_t i = 0; i < count; i++) {
+            leaves[i].freq = (leaves[i].freq + 1) / 2;
+        }
+        qsort(leaves, count, sizeof(huffman_leaf_t), compare_leaves);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        lengths[leaves[i].symbol] = depth[i];
+    }
+    return HUFFMAN_OK;
+}
+
+// 统计各码长的符号数并检查 Kraft 不等式, 返回每个码长的第一个规范码
+static huffman_error_t canonical_first_codes(const unsigned char lengths[256],
+                                             unsigned short count[HUFFMAN_MAX_CODE_LEN + 1],
+                                             unsigned short first[HUFFMAN_MAX_CODE_LEN + 1]) {
+    memset(count, 0, (HUFFMAN_MAX_CODE_LEN + 1) * sizeof(unsigned short));
+    for (int i = 0; i < 256; i++) {
+        if (lengths[i] > HUFFMAN_MAX_CODE_LEN) {
+            return HUFFMAN_TREE_ERROR;
+        }
+        count[lengths[i]]++;
+    }
+    count[0] = 0;
+
+    unsigned int code = 0;
+    unsigned int kraft = 0;
+    for (int len = 1; len <= HUFFMAN_MAX_CODE_LEN; len++) {
+        code = (code + count[len - 1]) << 1;
+        first[len] = (unsigned short)code;
+        kraft += (unsigned int)count[len] << (HUFFMAN_MAX_CODE_LEN - len);
+    }
+    first[0] = 0;
+
+    if (kraft > (1u << HUFFMAN_MAX_CODE_LEN)) {
+        return HUFFMAN_TREE_ERROR;
+    }
+    return HUFFMAN_OK;
+}
+
+huffman_error_t huffman_build_canonical_table(const unsigned char lengths[256], huffman_code_t table[256]) {
+    if (!lengths || !table) {
+        return HUFFMAN_INVALID_INPUT;
+    }
+
+    unsigned short count[HUFFMAN_MAX_CODE_LEN + 1];
+    unsigned short next[HUFFMAN_MAX_CODE_LEN + 1];
+    huffman_error_t err = canonical_first_codes(lengths, count, next);
+    if (err != HUFFMAN_OK) {
+        return err;
+    }
+
+    for (int i = 0; i < 256; i++) {
+        table[i].symbol = (unsigned char)i;
+        table[i].code_len = lengths[i];
+        table[i].code = lengths[i] ? next[lengths[i]]++ : 0;
+    }
+    return HUFFMAN_OK;
+}
+
+size_t huffman_write_lengths(const unsigned char lengths[256], unsigned char *output, size_t output_size) {
+    if (!lengths || !output || output_size < HUFFMAN_LENGTHS_SIZE) {
+        return 0;
+    }
+    for (int i = 0; i < HUFFMAN_LENGTHS_SIZE; i++) {
+        output[i] = (unsigned char)(((lengths[2 * i] & 0x0F) << 4) | (lengths[2 * i + 1] & 0x0F));
+    }
+    return HUFFMAN_LENGTHS_SIZE;
+}
+
+size_t huffman_read_lengths(const unsigned char *input, size_t input_len, unsigned char lengths[256]) {
+    if (!input || !lengths || input_len < HUFFMAN_LENGTHS_SIZE) {
+        return 0;
+    }
+    for (int i = 0; i < HUFFMAN_LENGTHS_SIZE; i++) {
+        lengths[2 * i] = input[i] >> 4;
+        lengths[2 * i + 1] = input[i] & 0x0F;
+    }
+    return HUFFMAN_LENGTHS_SIZE;
+}
+
+// 查找表项布局: [7:0] 符号0 [15:8] 符号1 [23:16] 符号2 [25:24] 符号数 [29:26] 消耗位数
+#define LOOKUP_SIZE (1u << HUFFMAN_LOOKUP_BITS)
+#define LOOKUP_ENTRY(syms, n, nbits) ((syms) | ((unsigned int)(n) << 24) | ((unsigned int)(nbits) << 26))
+#define LOOKUP_COUNT(e) (((e) >> 24) & 0x3)
+#define LOOKUP_BITS(e) ((e) >> 26)
+
+huffman_error_t huffman_decoder_init(huffman_decoder_t *decoder, const unsigned char lengths[256]) {
+    if (!decoder || !lengths) {
+        return HUFFMAN_INVALID_INPUT;
+    }
+
+    huffman_error_t err = canonical_first_codes(lengths, decoder->count, decoder->first_code);
+    if (err != HUFFMAN_OK) {
+        return err;
+    }
+
+    unsigned short pos = 0;
+    for (int len = 1; len <= HUFFMAN_MAX_CODE_LEN; len++) {
+        decoder->offset[len] = pos;
+        for (int s = 0; s < 256; s++) {
+            if (lengths[s] == len) {
+                decoder->symbols[pos++] = (unsigned char)s;
+            }
+        }
+    }
+    decoder->offset[0] = 0;
+
+    // 先建单符号表 (符号, 码长), 再在其上贪心拼接, 一次查表最多输出 3 个符号
+    unsigned short single[LOOKUP_SIZE];
+    memset(single, 0, sizeof(single));
+    for (int len = 1; len <= HUFFMAN_LOOKUP_BITS; len++) {
+        for (unsigned int k = 0; k < decoder->count[len]; k++) {
+            unsigned int code = decoder->first_code[len] + k;
+            unsigned char sym = decoder->symbols[decoder->offset[len] + k];
+            unsigned int shift = HUFFMAN_LOOKUP_BITS - len;
+            for (unsigned int fill = 0; fill < (1u << shift); fill++) {
+                single[(code << shift) | fill] = (unsigned short)(sym | (len << 8));
+            }
+        }
+    }
+
+    for (unsigned int idx = 0; idx < LOOKUP_SIZE; idx++) {
+        unsigned int syms = 0;
+        unsigned int n = 0;
+        unsigned int used = 0;
+        while (n < 3) {
+            unsigned int window = (idx << used) & (LOOKUP_SIZE - 1);
+            unsigned int e = single[window];
+            unsigned int len = e >> 8;
+            if (len == 0 || used + len > HUFFMAN_LOOKUP_BITS) {
+                break;
+            }
+            syms |= (e & 0xFF) << (8 * n);
+            used += len;
+            n++;
+        }
+        decoder->lookup[idx] = LOOKUP_ENTRY(syms, n, used);
+    }
+
+    return HUFFMAN_OK;
+}
+
+typedef struct {
+    const unsigned char *input;
+    size_t input_len;
+    size_t pos;
+    uint64_t buf;
+    unsigned int bits;
+} huffman_reader_t;
+
+// 左对齐的 64 位位缓冲: 至少保留 56 个有效位; 输入末尾之后按 0 补齐, 由调用方检查越界
+static inline void reader_refill(huffman_reader_t *r) {
+    if (r->pos + 8 <= r->input_len) {
+        const unsigned char *p = r->input + r->pos;
+        uint64_t v = ((uint64_t)p[0] << 56) | ((uint64_t)p[1] << 48) | ((uint64_t)p[2] << 40) |
+                     ((uint64_t)p[3] << 32) | ((uint64_t)p[4] << 24) | ((uint64_t)p[5] << 16) |
+                     ((uint64_t)p[6] << 8) | (uint64_t)p[7];
+        r->buf |= v >> r->bits;
+        r->pos += (63 - r->bits) >> 3;
+        r->bits |= 56;
+    } else {
+        while (r->bits <= 56) {
+            uint64_t byte = r->pos < r->input_len ? r->input[r->pos] : 0;
+            r->buf |= byte << (56 - r->bits);
+            r->pos++;
+            r->bits += 8;
+        }
+    }
+}
+
+static inline void reader_consume(huffman_reader_t *r, unsigned int n) {
+    r->buf <<= n;
+    r->bits -= n;
+}
+
+// 超出一级查找表的长码: 按规范码逐个码长比较
+static inline int decode_slow(const huffman_decoder_t *decoder, huffman_reader_t *r) {
+    unsigned int window = (unsigned int)(r->buf >> (64 - HUFFMAN_MAX_CODE_LEN));
+    for (int len = 1; len <= HUFFMAN_MAX_CODE_LEN; len++) {
+        unsigned int code = window >> (HUFFMAN_MAX_CODE_LEN - len);
+        unsigned int index = code - decoder->first_code[len];
+        if (code >= decoder->first_code[len] && index < decoder->count[len]) {
+            reader_consume(r, (unsigned int)len);
+            return decoder->symbols[decoder->offset[len] + index];
+        }
+    }
+    return -1;
+}
+
+size_t huffman_decode_table(const huffman_decoder_t *decoder, const unsigned char *input, size_t input_len,
+                            unsigned char *output, size_t output_len, huffman_error_t *error) {
+    if (!decoder || !input || !output) {
+        if (error) *error = HUFFMAN_INVALID_INPUT;
+        return 0;
+    }
+
+    huffman_reader_t r = { input, input_len, 0, 0, 0 };
+    size_t out_pos = 0;
+
+    // 一次补充后至少有 56 位, 足够连续做 4 次一级查表 (每次最多 12 位);
+    // 慢速解码的长码可达 15 位, 连续几个长码会超出 56 位, 因此慢速解码前单独检查剩余位数
+    while (out_pos + 12 <= output_len && r.pos <= input_len + 8) {
+        reader_refill(&r);
+        for (int k = 0; k < 4; k++) {
+            unsigned int e = decoder->lookup[r.buf >> (64 - HUFFMAN_LOOKUP_BITS)];
+            unsigned int n = LOOKUP_COUNT(e);
+            if (n > 0) {
+                output[out_pos] = (unsigned char)e;
+                output[out_pos + 1] = (unsigned char)(e >> 8);
+                output[out_pos + 2] = (unsigned char)(e >> 16);
+                out_pos += n;
+                reader_consume(&r, LOOKUP_BITS(e));
+            } else {
+                if (r.bits < HUFFMAN_MAX_CODE_LEN) {
+                    reader_refill(&r);
+                }
+                int sym = decode_slow(decoder, &r);
+                if (sym < 0) {
+                    if (error) *error = HUFFMAN_DECODE_ERROR;
+                    return 0;
+                }
+                output[out_pos++] = (unsigned char)sym;
+            }
+        }
+    }
+
+    while (out_pos < output_len && r.pos <= input_len + 8) {
+        reader_refill(&r);
+        int sym = decode_slow(decoder, &r);
+        if (sym < 0) {
+            if (error) *error = HUFFMAN_DECODE_ERROR;
+            return 0;
+        }
+        output[out_pos++] = (unsigned char)sym;
+    }
+
+    // 已消耗的位数不能超过输入长度, 否则说明解码读到了补齐的 0
+    if (out_pos < output_len || r.pos * 8 - r.bits > input_len * 8) {
+        if (error) *error = HUFFMAN_DECODE_ERROR;
+        return 0;
+    }
+
+    if (error) *error = HUFFMAN_OK;
+    return out_pos;
+}
+
+size_t huffman_compress_bound(size_t input_len) {
+    return HUFFMAN_LENGTHS_SIZE + 8 + (input_len * HUFFMAN_MAX_CODE_LEN + 7) / 8 + 4;
+}
+
+size_t huffman_compress(const unsigned char *input, size_t input_len, unsigned char *output, size_t output_size,
+                        huffman_error_t *error) {
+    if (!input || !output || input_len == 0) {
+        if (error) *error = HUFFMAN_INVALID_INPUT;
+        return 0;
+    }
+    if (output_size < HUFFMAN_LENGTHS_SIZE + 8) {
+        if (error) *error = HUFFMAN_BUFFER_TOO_SMALL;
+        return 0;
+    }
+
+    size_t freq[256];
+    unsigned char lengths[256];
+    huffman_code_t table[256];
+    huffman_stats(input, input_len, freq);
+
+    huffman_error_t err = huffman_build_lengths(freq, HUFFMAN_MAX_CODE_LEN, lengths);
+    if (err == HUFFMAN_OK) {
+        err = huffman_build_canonical_table(lengths, table);
+    }
+    if (err != HUFFMAN_OK) {
+        if (error) *error = err;
+        return 0;
+    }
+
+    huffman_write_lengths(lengths, output, output_size);
+    uint64_t raw_len = (uint64_t)input_len;
+    for (int i = 0; i < 8; i++) {
+        output[HUFFMAN_LENGTHS_SIZE + i] = (unsigned char)(raw_len >> (8 * i));
+    }
+
+    size_t header = HUFFMAN_LENGTHS_SIZE + 8;
+    size_t body = huffman_encode(input, input_len, output + header, output_size - header, table, &err);
+    if (err != HUFFMAN_OK) {
+        if (error) *error = err;
+        return 0;
+    }
+
+    if (error) *error = HUFFMAN_OK;
+    return header + body;
+}
+
+size_t huffman_decompress(const unsigned char *input, size_t input_len, unsigned char *output, size_t output_size,
+                          huffman_error_t *error) {
+    if (!input || !output || input_len < HUFFMAN_LENGTHS_SIZE + 8) {
+        if (error) *error = HUFFMAN_INVALID_INPUT;
+        return 0;
+    }
+
+    unsigned char lengths[256];
+    huffman_read_lengths(input, input_len, lengths);
+
+    uint64_t raw_len = 0;
+    for (int i = 0; i < 8; i++) {
+        raw_len |= (uint64_t)input[HUFFMAN_LENGTHS_SIZE + i] << (8 * i);
+    }
+    if (raw_len > output_size) {
+        if (error) *error = HUFFMAN_BUFFER_TOO_SMALL;
+        return 0;
+    }
+
+    huffman_decoder_t *decoder = (huffman_decoder_t *)malloc(sizeof(huffman_decoder_t));
+    if (!decoder) {
+        if (error) *error = HUFFMAN_MEMORY_ERROR;
+        return 0;
+    }
+
+    huffman_error_t err = huffman_decoder_init(decoder, lengths);
+    size_t header = HUFFMAN_LENGTHS_SIZE + 8;
+    size_t out_len = 0;
+    if (err == HUFFMAN_OK) {
+        out_len = huffman_decode_table(decoder, input + header, input_len - header, output, (size_t)raw_len, &err);
+    }
+    free(decoder);
+
+    if (error) *error = err;
+    return err == HUFFMAN_OK ? out_len : 0;
+}
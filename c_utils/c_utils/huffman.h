@@ -30,6 +30,21 @@ typedef struct {
     size_t code_len;
 } huffman_code_t;
 
+// 规范哈夫曼码长上限与一级查找表位数
+#define HUFFMAN_MAX_CODE_LEN 15
+#define HUFFMAN_LOOKUP_BITS 12
+// 序列化后的码长表大小 (256 个 4 位码长)
+#define HUFFMAN_LENGTHS_SIZE 128
+
+// 规范哈夫曼表驱动解码器, 大小固定 (约 17KB), 可放在栈上或重复使用
+typedef struct {
+    unsigned int lookup[1 << HUFFMAN_LOOKUP_BITS];
+    unsigned short first_code[HUFFMAN_MAX_CODE_LEN + 1];
+    unsigned short count[HUFFMAN_MAX_CODE_LEN + 1];
+    unsigned short offset[HUFFMAN_MAX_CODE_LEN + 1];
+    unsigned char symbols[256];
+} huffman_decoder_t;
+
 // 哈夫曼配置
 typedef struct {
     bool enable_stats;
@@ -56,6 +71,30 @@ size_t huffman_decode(const unsigned char *input, size_t input_len, unsigned cha
 // 释放哈夫曼树
 void huffman_free_tree(huffman_node_t *root);
 
+// 由频率计算码长 (不超过 max_len, 取值 8..HUFFMAN_MAX_CODE_LEN), 未出现的符号码长为 0
+huffman_error_t huffman_build_lengths(const size_t freq[256], size_t max_len, unsigned char lengths[256]);
+
+// 由码长生成规范哈夫曼编码表, 结果可直接用于 huffman_encode
+huffman_error_t huffman_build_canonical_table(const unsigned char lengths[256], huffman_code_t table[256]);
+
+// 码长表的序列化/反序列化, 固定占用 HUFFMAN_LENGTHS_SIZE 字节, 失败返回 0
+size_t huffman_write_lengths(const unsigned char lengths[256], unsigned char *output, size_t output_size);
+size_t huffman_read_lengths(const unsigned char *input, size_t input_len, unsigned char lengths[256]);
+
+// 由码长初始化表驱动解码器
+huffman_error_t huffman_decoder_init(huffman_decoder_t *decoder, const unsigned char lengths[256]);
+
+// 表驱动解码, 恰好解出 output_len 个符号; 一次查表最多输出 3 个符号
+size_t huffman_decode_table(const huffman_decoder_t *decoder, const unsigned char *input, size_t input_len,
+                            unsigned char *output, size_t output_len, huffman_error_t *error);
+
+// 自包含格式: [码长表 128 字节][原始长度 8 字节小端][位流]
+size_t huffman_compress_bound(size_t input_len);
+size_t huffman_compress(const unsigned char *input, size_t input_len, unsigned char *output, size_t output_size,
+                        huffman_error_t *error);
+size_t huffman_decompress(const unsigned char *input, size_t input_len, unsigned char *output, size_t output_size,
+                          huffman_error_t *error);
+
 // 获取默认哈夫曼配置
 void huffman_get_default_config(huffman_config_t *config);
 
@@ -4,6 +4,7 @@
 #include <string.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <stdint.h>
 
 static int compare(const void *a, const void *b) {
     return ((kruskal_edge_t*)a)->w - ((kruskal_edge_t*)b)->w;
@@ -168,3 +169,212 @@ void kruskal_get_default_config(kruskal_config_t *config) {
     config->return_edges = false;
     config->max_edges = 0;
 }
+
+/* ---------- CSR 图 ---------- */
+
+static kruskal_result_t *csr_result_create(const graph_csr_t *g, kruskal_error_t *error) {
+    kruskal_result_t *result = calloc(1, sizeof(kruskal_result_t));
+    if (result) result->edges = malloc((g->nodes ? g->nodes : 1) * sizeof(kruskal_edge_t));
+    if (!result || !result->edges) {
+        free(result);
+        if (error) *error = KRUSKAL_MEMORY_ERROR;
+        return NULL;
+    }
+    return result;
+}
+
+static void csr_result_finish(const graph_csr_t *g, kruskal_result_t *result, kruskal_error_t *error) {
+    if (result->edge_count + 1 < g->nodes) {
+        result->has_error = true;
+        result->error = KRUSKAL_DISCONNECTED;
+        snprintf(result->error_msg, sizeof(result->error_msg), "Graph is disconnected");
+    }
+    if (error) *error = result->error;
+}
+
+// 取出 u < v 的边
+static kruskal_edge_t *csr_collect_edges(const graph_csr_t *g, size_t *count) {
+    size_t m = 0;
+    for (size_t u = 0; u < g->nodes; u++) {
+        for (size_t i = g->offsets[u]; i < g->offsets[u + 1]; i++) m += (size_t)g->targets[i] > u;
+    }
+    kruskal_edge_t *edges = malloc((m ? m : 1) * sizeof(kruskal_edge_t));
+    if (!edges) return NULL;
+    size_t at = 0;
+    for (size_t u = 0; u < g->nodes; u++) {
+        for (size_t i = g->offsets[u]; i < g->offsets[u + 1]; i++) {
+            if ((size_t)g->targets[i] > u) edges[at++] = (kruskal_edge_t){ (int)u, g->targets[i], g->weights[i] };
+        }
+    }
+    *count = m;
+    return edges;
+}
+
+static int compare_weight(const void *a, const void *b) {
+    int wa = ((const kruskal_edge_t *)a)->w, wb = ((const kruskal_edge_t *)b)->w;
+    return (wa > wb) - (wa < wb);
+}
+
+kruskal_result_t *kruskal_mst_csr(const graph_csr_t *g, kruskal_error_t *error) {
+    if (!g || g->nodes == 0) {
+        if (error) *error = KRUSKAL_INVALID_INPUT;
+        return NULL;
+    }
+
+    kruskal_result_t *result = csr_result_create(g, error);
+    if (!result) return NULL;
+    size_t m = 0;
+    kruskal_edge_t *edges = csr_collect_edges(g, &m);
+    dsf_t dsf;
+    if (!edges || !dsf_init(&dsf, g->nodes, NULL)) {
+        free(edges);
+        kruskal_free_result(result);
+        if (error) *error = KRUSKAL_MEMORY_ERROR;
+        return NULL;
+    }
+
+    qsort(edges, m, sizeof(kruskal_edge_t), compare_weight);
+    for (size_t i = 0; i < m && result->edge_count + 1 < g->nodes; i++) {
+        if (dsf_find(&dsf, edges[i].u, NULL) != dsf_find(&dsf, edges[i].v, NULL)) {
+            dsf_union(&dsf, edges[i].u, edges[i].v, NULL);
+            result->total_weight += edges[i].w;
+            result->edges[result->edge_count++] = edges[i];
+        }
+    }
+
+    dsf_free(&dsf);
+    free(edges);
+    csr_result_finish(g, result, error);
+    return result;
+}
+
+// Boruvka 候选: 高 32 位为偏置后的权重, 低 32 位为边编号, 整体越小越优先
+#define BORUVKA_NONE UINT64_MAX
+
+typedef struct {
+    const kruskal_edge_t *edges;
+    const uint32_t *alive;
+    int *comp;
+    uint64_t *best;
+    int *parent;
+} boruvka_ctx_t;
+
+static inline void atomic_min_u64(uint64_t *slot, uint64_t value) {
+    uint64_t cur = __atomic_load_n(slot, __ATOMIC_RELAXED);
+    while (value < cur && !__atomic_compare_exchange_n(slot, &cur, value, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+static void boruvka_find_lightest(void *arg, size_t begin, size_t end, int worker) {
+    (void)worker;
+    boruvka_ctx_t *c = arg;
+    for (size_t i = begin; i < end; i++) {
+        uint32_t id = c->alive[i];
+        const kruskal_edge_t *e = &c->edges[id];
+        int cu = c->comp[e->u], cv = c->comp[e->v];
+        if (cu == cv) continue;
+        uint64_t key = ((uint64_t)((uint32_t)e->w ^ 0x80000000u) << 32) | id;
+        atomic_min_u64(&c->best[cu], key);
+        atomic_min_u64(&c->best[cv], key);
+    }
+}
+
+static int boruvka_root(int *parent, int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+// 合并阶段之后森林只读, 并行查根不做路径压缩
+static void boruvka_relabel(void *arg, size_t begin, size_t end, int worker) {
+    (void)worker;
+    boruvka_ctx_t *c = arg;
+    int *comp = c->comp;
+    for (size_t v = begin; v < end; v++) {
+        int r = (int)v;
+        while (c->parent[r] != r) r = c->parent[r];
+        comp[v] = r;
+    }
+}
+
+kruskal_result_t *kruskal_boruvka_csr(const graph_csr_t *g, threadpool_t *pool, kruskal_error_t *error) {
+    if (!g || g->nodes == 0 || g->edges > UINT32_MAX) {
+        if (error) *error = KRUSKAL_INVALID_INPUT;
+        return NULL;
+    }
+
+    size_t n = g->nodes;
+    kruskal_result_t *result = csr_result_create(g, error);
+    if (!result) return NULL;
+    size_t m = 0;
+    kruskal_edge_t *edges = csr_collect_edges(g, &m);
+    uint32_t *alive = malloc((m ? m : 1) * sizeof(uint32_t));
+    int *comp = malloc(n * sizeof(int));
+    int *parent = malloc(n * sizeof(int));
+    int *rank = calloc(n, sizeof(int));
+    uint64_t *best = malloc(n * sizeof(uint64_t));
+    if (!edges || !alive || !comp || !parent || !rank || !best) {
+        free(edges);
+        free(alive);
+        free(comp);
+        free(parent);
+        free(rank);
+        free(best);
+        kruskal_free_result(result);
+        if (error) *error = KRUSKAL_MEMORY_ERROR;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < m; i++) alive[i] = (uint32_t)i;
+    for (size_t v = 0; v < n; v++) {
+        comp[v] = parent[v] = (int)v;
+        best[v] = BORUVKA_NONE;
+    }
+
+    boruvka_ctx_t c = { edges, alive, comp, best, parent };
+    size_t alive_count = m;
+    bool merged = true;
+    while (merged && alive_count > 0) {
+        graph_csr_parallel_for(pool, alive_count, 4096, boruvka_find_lightest, &c);
+
+        // 全序保证各分量选出的边都属于同一棵最小生成树, 并查集再排除两端互选的重复边
+        merged = false;
+        for (size_t v = 0; v < n; v++) {
+            if (best[v] == BORUVKA_NONE) continue;
+            const kruskal_edge_t *e = &edges[(uint32_t)best[v]];
+            best[v] = BORUVKA_NONE;
+            int ru = boruvka_root(parent, e->u), rv = boruvka_root(parent, e->v);
+            if (ru == rv) continue;
+            if (rank[ru] < rank[rv]) {
+                int tmp = ru;
+                ru = rv;
+                rv = tmp;
+            }
+            parent[rv] = ru;
+            if (rank[ru] == rank[rv]) rank[ru]++;
+            result->total_weight += e->w;
+            result->edges[result->edge_count++] = *e;
+            merged = true;
+        }
+
+        graph_csr_parallel_for(pool, n, 8192, boruvka_relabel, &c);
+
+        size_t kept = 0;
+        for (size_t i = 0; i < alive_count; i++) {
+            const kruskal_edge_t *e = &edges[alive[i]];
+            if (comp[e->u] != comp[e->v]) alive[kept++] = alive[i];
+        }
+        alive_count = kept;
+    }
+
+    free(edges);
+    free(alive);
+    free(comp);
+    free(parent);
+    free(rank);
+    free(best);
+    csr_result_finish(g, result, error);
+    return result;
+}
@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include "graph_csr.h"
 
 // Kruskal 错误码
 typedef enum {
@@ -55,4 +56,15 @@ void kruskal_free_result(kruskal_result_t *result);
 // 获取默认配置
 void kruskal_get_default_config(kruskal_config_t *config);
 
+// CSR 图上的最小生成树 (无向图每条边存两个方向, 只取 u < v 的一份)
+// 返回的结果总是包含最小生成森林的全部边, 需用 kruskal_free_result 释放;
+// 图不连通时 has_error 置位且错误码为 KRUSKAL_DISCONNECTED, 内存不足返回 NULL
+
+// Kruskal: 边按权重排序后用并查集合并
+kruskal_result_t *kruskal_mst_csr(const graph_csr_t *g, kruskal_error_t *error);
+
+// 并行 Boruvka: 每轮在线程池上并行为每个分量找出最轻的出边 (按 权重, 边编号 取全序, 用 64 位 CAS 取最小),
+// 再合并这些边; 每轮分量数至少减半, 分量内部的边被剔除; pool 为 NULL 时在调用线程执行
+kruskal_result_t *kruskal_boruvka_csr(const graph_csr_t *g, threadpool_t *pool, kruskal_error_t *error);
+
 #endif // C_UTILS_KRUSKAL_H
@@ -0,0 +1,1752 @@
+#include "kv_lsm.h"
+#include "skiplist_lockfree.h"
+#include "bloom.h"
+#include "crc32.h"
+#include "threadpool.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define KV_LSM_MANIFEST_MAGIC 0x4D534C43u  /* "CLSM" */
+#define KV_LSM_TABLE_MAGIC 0x54534C43u     /* "CLST" */
+#define KV_LSM_FORMAT_VERSION 1
+#define KV_LSM_TYPE_PUT 1
+#define KV_LSM_TYPE_DELETE 2
+#define KV_LSM_ENTRY_HEADER 9    // 类型(1) 键长(4) 值长(4)
+#define KV_LSM_FOOTER_SIZE 48
+
+// ---------------- 基础结构 ----------------
+
+// 内存表记录, 从跳表的 arena 分配, 是跳表节点的值; 键保存在跳表节点中
+// seq 为所属批次的序号, prev 指向被它覆盖的同键记录, 读者沿 prev 找到快照可见的版本
+typedef struct kv_lsm_record_s {
+    uint64_t seq;
+    const struct kv_lsm_record_s *prev;
+    uint32_t value_len;
+    uint8_t type;
+    uint8_t value[];
+} kv_lsm_record_t;
+
+// 内存表: 无锁跳表, 读者不加锁查找, 写者由 write_mutex 串行化; 被覆盖的记录留在 arena 中直到整表释放
+typedef struct {
+    skiplist_lf_t *list;
+    size_t refs;
+} kv_memtable_t;
+
+typedef struct {
+    const uint8_t *last_key;
+    uint32_t last_key_len;
+    uint64_t offset;
+    uint32_t size;
+} kv_block_handle_t;
+
+typedef struct {
+    uint64_t number;
+    uint8_t *map;
+    size_t size;
+    kv_block_handle_t *blocks;
+    size_t block_count;
+    bloom_t *bloom;
+    uint64_t entries;
+    const uint8_t *smallest;
+    uint32_t smallest_len;
+    const uint8_t *largest;
+    uint32_t largest_len;
+    size_t refs;
+    bool obsolete;  // 已不在任何新版本中, 最后一个引用释放时删除文件
+    char *path;
+} kv_table_t;
+
+// 各层表清单; 第 0 层从新到旧, 其余各层按最小键排序且互不重叠
+typedef struct {
+    kv_table_t **tables[KV_LSM_MAX_LEVELS];
+    size_t counts[KV_LSM_MAX_LEVELS];
+    size_t refs;
+} kv_version_t;
+
+struct kv_lsm_s {
+    char *dir;
+    kv_lsm_config_t config;
+
+    pthread_mutex_t mutex;        // 保护以下所有状态
+    pthread_mutex_t write_mutex;  // 串行化写者
+    pthread_cond_t bg_cond;
+
+    // 批次序号: 写者持有 write_mutex 分配 next_seq, 整批插入内存表后才发布到 visible_seq,
+    // 读者只看 seq 不超过 visible_seq 的记录, 因此批量写入对读者也是原子的
+    uint64_t next_seq;
+    _Atomic uint64_t visible_seq;
+
+    kv_memtable_t *mem;
+    kv_memtable_t *imm;           // 等待写成表的只读内存表
+    kv_version_t *current;
+    int wal_fd;
+    uint64_t wal_number;
+    uint64_t log_number;          // 清单中记录的最旧有效日志
+    uint64_t next_file;
+    uint8_t *compact_pointer[KV_LSM_MAX_LEVELS];
+    uint32_t compact_pointer_len[KV_LSM_MAX_LEVELS];
+
+    threadpool_t *pool;
+    bool bg_scheduled;
+    bool closing;
+    kv_error_t bg_error;
+};
+
+static inline uint32_t rd32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t rd64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void wr32(uint8_t *p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline void wr64(uint8_t *p, uint64_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline int key_cmp(const uint8_t *a, size_t a_len, const uint8_t *b, size_t b_len) {
+    int c = memcmp(a, b, a_len < b_len ? a_len : b_len);
+    if (c) return c;
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+static inline uint32_t crc32c(const void *data, size_t len) {
+    return crc32_compute(data, len, CRC32_C, NULL);
+}
+
+// 可增长的字节缓冲区
+typedef struct {
+    uint8_t *data;
+    size_t len;
+    size_t cap;
+} kv_buf_t;
+
+static bool buf_reserve(kv_buf_t *buf, size_t extra) {
+    if (buf->len + extra <= buf->cap) return true;
+    size_t cap = buf->cap ? buf->cap : 256;
+    while (cap < buf->len + extra) cap *= 2;
+    uint8_t *data = realloc(buf->data, cap);
+    if (!data) return false;
+    buf->data = data;
+    buf->cap = cap;
+    return true;
+}
+
+static bool buf_append(kv_buf_t *buf, const void *data, size_t len) {
+    if (!buf_reserve(buf, len)) return false;
+    if (len) memcpy(buf->data + buf->len, data, len);
+    buf->len += len;
+    return true;
+}
+
+// 追加一条记录: 类型(1) 键长(4) 值长(4) 键 值 (日志与数据块使用同样的编码)
+static bool buf_append_entry(kv_buf_t *buf, uint8_t type, const void *key, size_t key_len, const void *value,
+                             size_t value_len) {
+    uint8_t header[KV_LSM_ENTRY_HEADER];
+    header[0] = type;
+    wr32(header + 1, (uint32_t)key_len);
+    wr32(header + 5, (uint32_t)value_len);
+    return buf_append(buf, header, sizeof(header)) && buf_append(buf, key, key_len) &&
+           buf_append(buf, value, value_len);
+}
+
+// 解析一条记录, 越界返回 false
+static bool parse_entry(const uint8_t **p, const uint8_t *end, uint8_t *type, const uint8_t **key,
+                        uint32_t *key_len, const uint8_t **value, uint32_t *value_len) {
+    if ((size_t)(end - *p) < KV_LSM_ENTRY_HEADER) return false;
+    *type = (*p)[0];
+    *key_len = rd32(*p + 1);
+    *value_len = rd32(*p + 5);
+    if ((*type != KV_LSM_TYPE_PUT && *type != KV_LSM_TYPE_DELETE) ||
+        (uint64_t)*key_len + *value_len > (uint64_t)(end - *p) - KV_LSM_ENTRY_HEADER) {
+        return false;
+    }
+    *key = *p + KV_LSM_ENTRY_HEADER;
+    *value = *key + *key_len;
+    *p = *value + *value_len;
+    return true;
+}
+
+static kv_error_t write_all(int fd, const void *data, size_t len) {
+    const uint8_t *p = data;
+    while (len > 0) {
+        ssize_t n = write(fd, p, len);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return KV_WRITE_ERROR;
+        p += n;
+        len -= (size_t)n;
+    }
+    return KV_OK;
+}
+
+static char* file_path(const kv_lsm_t *lsm, uint64_t number, const char *suffix) {
+    size_t len = strlen(lsm->dir) + 32;
+    char *path = malloc(len);
+    if (path) snprintf(path, len, "%s/%06llu.%s", lsm->dir, (unsigned long long)number, suffix);
+    return path;
+}
+
+static void remove_file(const kv_lsm_t *lsm, uint64_t number, const char *suffix) {
+    char *path = file_path(lsm, number, suffix);
+    if (path) unlink(path);
+    free(path);
+}
+
+// ---------------- 内存表 ----------------
+
+static kv_memtable_t* memtable_create(void) {
+    kv_memtable_t *mem = calloc(1, sizeof(kv_memtable_t));
+    if (!mem) return NULL;
+    mem->list = skiplist_lf_create(NULL, 0);
+    if (!mem->list) {
+        free(mem);
+        return NULL;
+    }
+    mem->refs = 1;
+    return mem;
+}
+
+static void memtable_unref(kv_memtable_t *mem) {
+    if (!mem || --mem->refs > 0) return;
+    skiplist_lf_free(mem->list, NULL);
+    free(mem);
+}
+
+// 只由持有 write_mutex 的写者 (或打开时的重放) 调用, 读取旧记录与替换之间没有其他写者
+static bool memtable_add(kv_memtable_t *mem, uint64_t seq, uint8_t type, const uint8_t *key, size_t key_len,
+                         const uint8_t *value, size_t value_len) {
+    kv_lsm_record_t *rec = skiplist_lf_alloc(mem->list, sizeof(kv_lsm_record_t) + value_len);
+    if (!rec) return false;
+    void *prev = NULL;
+    rec->seq = seq;
+    rec->prev = skiplist_lf_get(mem->list, key, key_len, &prev) ? prev : NULL;
+    rec->value_len = (uint32_t)value_len;
+    rec->type = type;
+    if (value_len) memcpy(rec->value, value, value_len);
+    return skiplist_lf_put(mem->list, key, key_len, rec, NULL);
+}
+
+// 沿同键的版本链找到 snapshot 可见的最新记录
+static inline const kv_lsm_record_t* record_visible(const kv_lsm_record_t *rec, uint64_t snapshot) {
+    while (rec && rec->seq > snapshot) rec = rec->prev;
+    return rec;
+}
+
+static const kv_lsm_record_t* memtable_get(kv_memtable_t *mem, const uint8_t *key, size_t key_len,
+                                           uint64_t snapshot) {
+    void *rec = NULL;
+    return skiplist_lf_get(mem->list, key, key_len, &rec) ? record_visible(rec, snapshot) : NULL;
+}
+
+static inline size_t memtable_bytes(const kv_memtable_t *mem) {
+    return skiplist_lf_memory_usage(mem->list);
+}
+
+// ---------------- 有序表 ----------------
+
+static void table_unref(kv_table_t *table) {
+    if (!table || --table->refs > 0) return;
+    if (table->map) munmap(table->map, table->size);
+    if (table->obsolete && table->path) unlink(table->path);
+    bloom_free(table->bloom);
+    free(table->blocks);
+    free(table->path);
+    free(table);
+}
+
+static kv_error_t table_open(kv_lsm_t *lsm, uint64_t number, kv_table_t **out) {
+    kv_table_t *table = calloc(1, sizeof(kv_table_t));
+    if (!table) return KV_MEMORY_ERROR;
+    table->number = number;
+    table->refs = 1;
+    table->path = file_path(lsm, number, "sst");
+    if (!table->path) {
+        free(table);
+        return KV_MEMORY_ERROR;
+    }
+
+    kv_error_t err = KV_PARSE_ERROR;
+    int fd = open(table->path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+        err = KV_FILE_ERROR;
+        goto fail;
+    }
+    if ((size_t)st.st_size < KV_LSM_FOOTER_SIZE) goto fail;
+    table->size = (size_t)st.st_size;
+    table->map = mmap(NULL, table->size, PROT_READ, MAP_SHARED, fd, 0);
+    if (table->map == MAP_FAILED) {
+        table->map = NULL;
+        err = KV_READ_ERROR;
+        goto fail;
+    }
+    close(fd);
+    fd = -1;
+
+    // 尾部: 索引偏移(8) 索引长度(4) 过滤器长度(4) 过滤器偏移(8) 条目数(8) 块数(4) 魔数(4) CRC(4)
+    const uint8_t *footer = table->map + table->size - KV_LSM_FOOTER_SIZE;
+    if (rd32(footer + 36) != KV_LSM_TABLE_MAGIC || rd32(footer + 40) != crc32c(footer, 40)) goto fail;
+    uint64_t index_offset = rd64(footer);
+    uint32_t index_size = rd32(footer + 8);
+    uint32_t bloom_size = rd32(footer + 12);
+    uint64_t bloom_offset = rd64(footer + 16);
+    table->entries = rd64(footer + 24);
+    table->block_count = rd32(footer + 32);
+    size_t data_end = table->size - KV_LSM_FOOTER_SIZE;
+    if (table->block_count == 0 || index_offset > data_end || index_size + 4u > data_end - index_offset ||
+        bloom_offset > index_offset || bloom_size + 4u > index_offset - bloom_offset) {
+        goto fail;
+    }
+
+    const uint8_t *index = table->map + index_offset;
+    if (rd32(index + index_size) != crc32c(index, index_size)) goto fail;
+    table->blocks = malloc(table->block_count * sizeof(kv_block_handle_t));
+    if (!table->blocks) {
+        err = KV_MEMORY_ERROR;
+        goto fail;
+    }
+    // 索引项: 键长(4) 偏移(8) 长度(4) 块内最大键
+    const uint8_t *p = index, *end = index + index_size;
+    for (size_t i = 0; i < table->block_count; i++) {
+        if (end - p < 16) goto fail;
+        kv_block_handle_t *h = &table->blocks[i];
+        h->last_key_len = rd32(p);
+        h->offset = rd64(p + 4);
+        h->size = rd32(p + 12);
+        h->last_key = p + 16;
+        if ((size_t)(end - p - 16) < h->last_key_len || h->offset > bloom_offset ||
+            h->size + 4u > bloom_offset - h->offset) {
+            goto fail;
+        }
+        p += 16 + h->last_key_len;
+    }
+
+    if (bloom_size > 0) {
+        const uint8_t *bloom = table->map + bloom_offset;
+        if (rd32(bloom + bloom_size) != crc32c(bloom, bloom_size)) goto fail;
+        table->bloom = bloom_deserialize(bloom, bloom_size);
+    }
+
+    const uint8_t *first = table->map + table->blocks[0].offset;
+    uint8_t type;
+    const uint8_t *value;
+    uint32_t value_len;
+    if (!parse_entry(&first, first + table->blocks[0].size, &type, &table->smallest, &table->smallest_len,
+                     &value, &value_len)) {
+        goto fail;
+    }
+    table->largest = table->blocks[table->block_count - 1].last_key;
+    table->largest_len = table->blocks[table->block_count - 1].last_key_len;
+    *out = table;
+    return KV_OK;
+
+fail:
+    if (fd >= 0) close(fd);
+    table_unref(table);
+    return err;
+}
+
+static inline bool table_may_contain(const kv_table_t *table, const uint8_t *key, size_t key_len) {
+    return key_cmp(key, key_len, table->smallest, table->smallest_len) >= 0 &&
+           key_cmp(key, key_len, table->largest, table->largest_len) <= 0;
+}
+
+// 在表中查找键: 布隆过滤器 -> 块索引二分 -> 扫描一个数据块
+static bool table_get(const kv_table_t *table, const uint8_t *key, size_t key_len, uint8_t *type,
+                      const uint8_t **value, uint32_t *value_len) {
+    if (table->bloom && !bloom_check(table->bloom, key, key_len)) return false;
+
+    size_t lo = 0, hi = table->block_count;
+    while (lo < hi) {
+        size_t mid = (lo + hi) / 2;
+        const kv_block_handle_t *h = &table->blocks[mid];
+        if (key_cmp(h->last_key, h->last_key_len, key, key_len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    if (lo == table->block_count) return false;
+
+    const uint8_t *p = table->map + table->blocks[lo].offset;
+    const uint8_t *end = p + table->blocks[lo].size;
+    while (p < end) {
+        const uint8_t *entry_key;
+        uint32_t entry_key_len;
+        if (!parse_entry(&p, end, type, &entry_key, &entry_key_len, value, value_len)) return false;
+        int c = key_cmp(entry_key, entry_key_len, key, key_len);
+        if (c == 0) return true;
+        if (c > 0) return false;
+    }
+    return false;
+}
+
+// 表构建器: 数据块写满后写出并记录索引项, 完成时写过滤器、索引与尾部
+typedef struct {
+    FILE *fp;
+    char *path;
+    uint64_t number;
+    kv_buf_t block;
+    kv_buf_t index;
+    kv_buf_t keys;       // 本表所有键, 完成时按实际数量建布隆过滤器
+    kv_buf_t last_key;
+    uint64_t offset;
+    uint64_t entries;
+    uint32_t blocks;
+} kv_table_builder_t;
+
+static void builder_free(kv_table_builder_t *b) {
+    free(b->block.data);
+    free(b->index.data);
+    free(b->keys.data);
+    free(b->last_key.data);
+    free(b->path);
+    memset(b, 0, sizeof(*b));
+}
+
+static kv_error_t builder_open(kv_lsm_t *lsm, uint64_t number, kv_table_builder_t *b) {
+    memset(b, 0, sizeof(*b));
+    b->number = number;
+    b->path = file_path(lsm, number, "sst");
+    if (!b->path) return KV_MEMORY_ERROR;
+    b->fp = fopen(b->path, "wb");
+    if (!b->fp) {
+        builder_free(b);
+        return KV_FILE_ERROR;
+    }
+    setvbuf(b->fp, NULL, _IOFBF, 1 << 16);
+    return KV_OK;
+}
+
+static void builder_abandon(kv_table_builder_t *b) {
+    if (b->fp) fclose(b->fp);
+    if (b->path) unlink(b->path);
+    builder_free(b);
+}
+
+static kv_error_t builder_write(kv_table_builder_t *b, const void *data, size_t len) {
+    if (fwrite(data, 1, len, b->fp) != len) return KV_WRITE_ERROR;
+    b->offset += len;
+    return KV_OK;
+}
+
+static kv_error_t builder_flush_block(kv_table_builder_t *b) {
+    if (b->block.len == 0) return KV_OK;
+    uint8_t entry[16];
+    wr32(entry, (uint32_t)b->last_key.len);
+    wr64(entry + 4, b->offset);
+    wr32(entry + 12, (uint32_t)b->block.len);
+    if (!buf_append(&b->index, entry, sizeof(entry)) || !buf_append(&b->index, b->last_key.data, b->last_key.len)) {
+        return KV_MEMORY_ERROR;
+    }
+
+    uint8_t crc[4];
+    wr32(crc, crc32c(b->block.data, b->block.len));
+    kv_error_t err = builder_write(b, b->block.data, b->block.len);
+    if (err == KV_OK) err = builder_write(b, crc, sizeof(crc));
+    b->block.len = 0;
+    b->blocks++;
+    return err;
+}
+
+static kv_error_t builder_add(kv_lsm_t *lsm, kv_table_builder_t *b, uint8_t type, const uint8_t *key,
+                              uint32_t key_len, const uint8_t *value, uint32_t value_len) {
+    uint8_t len[4];
+    wr32(len, key_len);
+    if (!buf_append_entry(&b->block, type, key, key_len, value, value_len) ||
+        !buf_append(&b->keys, len, sizeof(len)) || !buf_append(&b->keys, key, key_len)) {
+        return KV_MEMORY_ERROR;
+    }
+    b->last_key.len = 0;
+    if (!buf_append(&b->last_key, key, key_len)) return KV_MEMORY_ERROR;
+    b->entries++;
+    return b->block.len >= lsm->config.block_size ? builder_flush_block(b) : KV_OK;
+}
+
+static size_t builder_size(const kv_table_builder_t *b) {
+    return (size_t)b->offset + b->block.len;
+}
+
+static kv_error_t builder_finish(kv_lsm_t *lsm, kv_table_builder_t *b, kv_table_t **out) {
+    kv_error_t err = builder_flush_block(b);
+
+    // 布隆过滤器
+    uint64_t bloom_offset = b->offset;
+    uint32_t bloom_size = 0;
+    bloom_t *bloom = err == KV_OK ? bloom_create((size_t)b->entries, lsm->config.bloom_fp_rate) : NULL;
+    if (bloom) {
+        for (size_t pos = 0; pos < b->keys.len;) {
+            uint32_t key_len = rd32(b->keys.data + pos);
+            bloom_add(bloom, b->keys.data + pos + 4, key_len);
+            pos += 4 + key_len;
+        }
+        size_t cap = (size_t)b->entries * 8 + 1024, written = 0;
+        uint8_t *data = malloc(cap);
+        while (data && !bloom_serialize(bloom, data, cap, &written)) {
+            cap *= 2;
+            uint8_t *grown = realloc(data, cap);
+            if (!grown) {
+                free(data);
+                data = NULL;
+            } else {
+                data = grown;
+            }
+        }
+        if (data) {
+            uint8_t crc[4];
+            wr32(crc, crc32c(data, written));
+            bloom_size = (uint32_t)written;
+            err = builder_write(b, data, written);
+            if (err == KV_OK) err = builder_write(b, crc, sizeof(crc));
+            free(data);
+        }
+        bloom_free(bloom);
+    }
+
+    // 块索引与尾部
+    uint64_t index_offset = b->offset;
+    uint8_t crc[4];
+    wr32(crc, crc32c(b->index.data, b->index.len));
+    if (err == KV_OK) err = builder_write(b, b->index.data, b->index.len);
+    if (err == KV_OK) err = builder_write(b, crc, sizeof(crc));
+
+    uint8_t footer[KV_LSM_FOOTER_SIZE];
+    memset(footer, 0, sizeof(footer));
+    wr64(footer, index_offset);
+    wr32(footer + 8, (uint32_t)b->index.len);
+    wr32(footer + 12, bloom_size);
+    wr64(footer + 16, bloom_offset);
+    wr64(footer + 24, b->entries);
+    wr32(footer + 32, b->blocks);
+    wr32(footer + 36, KV_LSM_TABLE_MAGIC);
+    wr32(footer + 40, crc32c(footer, 40));
+    if (err == KV_OK) err = builder_write(b, footer, sizeof(footer));
+
+    if (err == KV_OK && (fflush(b->fp) != 0 || fdatasync(fileno(b->fp)) != 0)) err = KV_WRITE_ERROR;
+    if (fclose(b->fp) != 0 && err == KV_OK) err = KV_WRITE_ERROR;
+    b->fp = NULL;
+    if (err == KV_OK) err = table_open(lsm, b->number, out);
+    if (err != KV_OK) {
+        builder_abandon(b);
+        return err;
+    }
+    builder_free(b);
+    return KV_OK;
+}
+
+// ---------------- 迭代器与归并 ----------------
+
+// 内存表迭代器或一层表 (按序排列、互不重叠) 的迭代器
+typedef struct {
+    bool is_memtable;
+    skiplist_lf_iter_t mem_it;
+    uint64_t snapshot;
+    kv_table_t *const *tables;
+    size_t table_count;
+    size_t table_idx;
+    size_t block;
+    const uint8_t *p;
+    const uint8_t *end;
+
+    bool valid;
+    kv_error_t error;
+    uint8_t type;
+    const uint8_t *key;
+    uint32_t key_len;
+    const uint8_t *value;
+    uint32_t value_len;
+} kv_lsm_iter_t;
+
+static void iter_next(kv_lsm_iter_t *it) {
+    it->valid = false;
+    if (it->is_memtable) {
+        // 快照之后才写入的键没有可见版本, 跳过
+        for (; skiplist_lf_iter_valid(&it->mem_it); skiplist_lf_iter_next(&it->mem_it)) {
+            const kv_lsm_record_t *rec = record_visible(skiplist_lf_iter_value(&it->mem_it), it->snapshot);
+            if (!rec) continue;
+            size_t key_len;
+            it->key = skiplist_lf_iter_key(&it->mem_it, &key_len);
+            it->key_len = (uint32_t)key_len;
+            it->type = rec->type;
+            it->value = rec->value;
+            it->value_len = rec->value_len;
+            it->valid = true;
+            skiplist_lf_iter_next(&it->mem_it);
+            return;
+        }
+        return;
+    }
+
+    for (;;) {
+        if (it->p < it->end) {
+            if (!parse_entry(&it->p, it->end, &it->type, &it->key, &it->key_len, &it->value, &it->value_len)) {
+                it->error = KV_PARSE_ERROR;
+                return;
+            }
+            it->valid = true;
+            return;
+        }
+        if (it->table_idx >= it->table_count) return;
+        const kv_table_t *table = it->tables[it->table_idx];
+        if (it->block >= table->block_count) {
+            it->table_idx++;
+            it->block = 0;
+            continue;
+        }
+        const kv_block_handle_t *h = &table->blocks[it->block++];
+        const uint8_t *data = table->map + h->offset;
+        if (rd32(data + h->size) != crc32c(data, h->size)) {
+            it->error = KV_PARSE_ERROR;
+            return;
+        }
+        it->p = data;
+        it->end = data + h->size;
+    }
+}
+
+// mem 为 NULL 时迭代器为空; 只返回 seq 不超过 snapshot 的记录
+static void iter_init_memtable(kv_lsm_iter_t *it, const kv_memtable_t *mem, uint64_t snapshot) {
+    memset(it, 0, sizeof(*it));
+    it->is_memtable = true;
+    it->snapshot = snapshot;
+    if (mem) skiplist_lf_iter_first(&it->mem_it, mem->list);
+    iter_next(it);
+}
+
+static void iter_init_tables(kv_lsm_iter_t *it, kv_table_t *const *tables, size_t count) {
+    memset(it, 0, sizeof(*it));
+    it->tables = tables;
+    it->table_count = count;
+    iter_next(it);
+}
+
+// 取所有迭代器中最小的键; 键相同时序号小 (更新) 的迭代器胜出, 其余迭代器跳过该键
+static kv_lsm_iter_t* merge_pick(kv_lsm_iter_t *iters, size_t count, kv_error_t *error) {
+    kv_lsm_iter_t *best = NULL;
+    for (size_t i = 0; i < count; i++) {
+        if (iters[i].error != KV_OK) {
+            *error = iters[i].error;
+            return NULL;
+        }
+        if (iters[i].valid &&
+            (!best || key_cmp(iters[i].key, iters[i].key_len, best->key, best->key_len) < 0)) {
+            best = &iters[i];
+        }
+    }
+    if (!best) return NULL;
+    for (size_t i = 0; i < count; i++) {
+        kv_lsm_iter_t *it = &iters[i];
+        while (it != best && it->valid && key_cmp(it->key, it->key_len, best->key, best->key_len) == 0) {
+            iter_next(it);
+        }
+    }
+    return best;
+}
+
+// ---------------- 版本与清单 ----------------
+
+static void version_unref(kv_version_t *v) {
+    if (!v || --v->refs > 0) return;
+    for (int level = 0; level < KV_LSM_MAX_LEVELS; level++) {
+        for (size_t i = 0; i < v->counts[level]; i++) table_unref(v->tables[level][i]);
+        free(v->tables[level]);
+    }
+    free(v);
+}
+
+static bool version_add(kv_version_t *v, int level, kv_table_t *table, size_t pos) {
+    kv_table_t **tables = realloc(v->tables[level], (v->counts[level] + 1) * sizeof(kv_table_t *));
+    if (!tables) return false;
+    memmove(tables + pos + 1, tables + pos, (v->counts[level] - pos) * sizeof(kv_table_t *));
+    tables[pos] = table;
+    table->refs++;
+    v->tables[level] = tables;
+    v->counts[level]++;
+    return true;
+}
+
+// 按最小键有序插入 (第 1 层及以后)
+static bool version_add_sorted(kv_version_t *v, int level, kv_table_t *table) {
+    size_t pos = 0;
+    while (pos < v->counts[level] && key_cmp(v->tables[level][pos]->smallest, v->tables[level][pos]->smallest_len,
+                                             table->smallest, table->smallest_len) < 0) {
+        pos++;
+    }
+    return version_add(v, level, table, pos);
+}
+
+static kv_version_t* version_copy(const kv_version_t *base) {
+    kv_version_t *v = calloc(1, sizeof(kv_version_t));
+    if (!v) return NULL;
+    v->refs = 1;
+    for (int level = 0; base && level < KV_LSM_MAX_LEVELS; level++) {
+        for (size_t i = 0; i < base->counts[level]; i++) {
+            if (!version_add(v, level, base->tables[level][i], v->counts[level])) {
+                version_unref(v);
+                return NULL;
+            }
+        }
+    }
+    return v;
+}
+
+static void version_remove(kv_version_t *v, int level, const kv_table_t *table) {
+    for (size_t i = 0; i < v->counts[level]; i++) {
+        if (v->tables[level][i] == table) {
+            table_unref(v->tables[level][i]);
+            memmove(v->tables[level] + i, v->tables[level] + i + 1, (v->counts[level] - i - 1) * sizeof(kv_table_t *));
+            v->counts[level]--;
+            return;
+        }
+    }
+}
+
+static size_t level_bytes(const kv_version_t *v, int level) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < v->counts[level]; i++) bytes += v->tables[level][i]->size;
+    return bytes;
+}
+
+// 清单: 魔数(4) 版本(4) 下一文件号(8) 日志号(8) 表数量(4) [层(4) 文件号(8)]... CRC(4)
+static kv_error_t manifest_write(kv_lsm_t *lsm, const kv_version_t *v, uint64_t next_file, uint64_t log_number) {
+    kv_buf_t buf = { 0 };
+    uint8_t header[28];
+    uint32_t count = 0;
+    for (int level = 0; level < KV_LSM_MAX_LEVELS; level++) count += (uint32_t)v->counts[level];
+    wr32(header, KV_LSM_MANIFEST_MAGIC);
+    wr32(header + 4, KV_LSM_FORMAT_VERSION);
+    wr64(header + 8, next_file);
+    wr64(header + 16, log_number);
+    wr32(header + 24, count);
+    bool ok = buf_append(&buf, header, sizeof(header));
+    for (int level = 0; ok && level < KV_LSM_MAX_LEVELS; level++) {
+        for (size_t i = 0; ok && i < v->counts[level]; i++) {
+            uint8_t entry[12];
+            wr32(entry, (uint32_t)level);
+            wr64(entry + 4, v->tables[level][i]->number);
+            ok = buf_append(&buf, entry, sizeof(entry));
+        }
+    }
+    uint8_t crc[4];
+    if (ok) {
+        wr32(crc, crc32c(buf.data, buf.len));
+        ok = buf_append(&buf, crc, sizeof(crc));
+    }
+    if (!ok) {
+        free(buf.data);
+        return KV_MEMORY_ERROR;
+    }
+
+    size_t dir_len = strlen(lsm->dir);
+    char *tmp = malloc(dir_len + 32);
+    char *path = malloc(dir_len + 32);
+    kv_error_t err = KV_MEMORY_ERROR;
+    if (tmp && path) {
+        snprintf(tmp, dir_len + 32, "%s/MANIFEST.tmp", lsm->dir);
+        snprintf(path, dir_len + 32, "%s/MANIFEST", lsm->dir);
+        int fd = open(tmp, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        err = fd < 0 ? KV_FILE_ERROR : write_all(fd, buf.data, buf.len);
+        if (err == KV_OK && fsync(fd) != 0) err = KV_WRITE_ERROR;
+        if (fd >= 0) close(fd);
+        if (err == KV_OK && rename(tmp, path) != 0) err = KV_FILE_ERROR;
+        if (err == KV_OK) {
+            int dir_fd = open(lsm->dir, O_RDONLY | O_CLOEXEC);
+            if (dir_fd >= 0) {
+                fsync(dir_fd);
+                close(dir_fd);
+            }
+        } else {
+            unlink(tmp);
+        }
+    }
+    free(tmp);
+    free(path);
+    free(buf.data);
+    return err;
+}
+
+static kv_error_t manifest_read(kv_lsm_t *lsm, kv_version_t *v, bool *exists) {
+    size_t len = strlen(lsm->dir) + 32;
+    char *path = malloc(len);
+    if (!path) return KV_MEMORY_ERROR;
+    snprintf(path, len, "%s/MANIFEST", lsm->dir);
+    FILE *fp = fopen(path, "rb");
+    free(path);
+    *exists = fp != NULL;
+    if (!fp) return KV_OK;
+
+    kv_buf_t buf = { 0 };
+    uint8_t chunk[4096];
+    size_t n;
+    bool ok = true;
+    while (ok && (n = fread(chunk, 1, sizeof(chunk), fp)) > 0) ok = buf_append(&buf, chunk, n);
+    fclose(fp);
+    if (!ok) {
+        free(buf.data);
+        return KV_MEMORY_ERROR;
+    }
+
+    kv_error_t err = KV_PARSE_ERROR;
+    if (buf.len >= 32 && rd32(buf.data) == KV_LSM_MANIFEST_MAGIC && rd32(buf.data + 4) == KV_LSM_FORMAT_VERSION &&
+        rd32(buf.data + buf.len - 4) == crc32c(buf.data, buf.len - 4) &&
+        buf.len == 32 + (size_t)rd32(buf.data + 24) * 12) {
+        lsm->next_file = rd64(buf.data + 8);
+        lsm->log_number = rd64(buf.data + 16);
+        err = KV_OK;
+        for (uint32_t i = 0; err == KV_OK && i < rd32(buf.data + 24); i++) {
+            const uint8_t *entry = buf.data + 28 + i * 12;
+            uint32_t level = rd32(entry);
+            kv_table_t *table = NULL;
+            if (level >= KV_LSM_MAX_LEVELS) {
+                err = KV_PARSE_ERROR;
+                break;
+            }
+            err = table_open(lsm, rd64(entry + 4), &table);
+            if (err == KV_OK) {
+                if (!version_add(v, (int)level, table, v->counts[level])) err = KV_MEMORY_ERROR;
+                table_unref(table);
+            }
+        }
+    }
+    free(buf.data);
+    return err;
+}
+
+// ---------------- 后台任务: 写表与压缩 ----------------
+
+static kv_error_t build_table_from_memtable(kv_lsm_t *lsm, uint64_t number, const kv_memtable_t *mem,
+                                            kv_table_t **out) {
+    kv_table_builder_t b;
+    kv_lsm_iter_t it;
+    kv_error_t err = builder_open(lsm, number, &b);
+    for (iter_init_memtable(&it, mem, UINT64_MAX); err == KV_OK && it.valid; iter_next(&it)) {
+        err = builder_add(lsm, &b, it.type, it.key, it.key_len, it.value, it.value_len);
+    }
+    if (err != KV_OK) {
+        if (b.path) builder_abandon(&b);
+        return err;
+    }
+    return builder_finish(lsm, &b, out);
+}
+
+static void delete_obsolete_logs(kv_lsm_t *lsm, uint64_t below) {
+    DIR *dir = opendir(lsm->dir);
+    if (!dir) return;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL) {
+        unsigned long long number;
+        char suffix[8];
+        if (sscanf(ent->d_name, "%llu.%7s", &number, suffix) == 2 && strcmp(suffix, "wal") == 0 && number < below) {
+            remove_file(lsm, number, "wal");
+        }
+    }
+    closedir(dir);
+}
+
+// 把只读内存表写成第 0 层的表; 调用时持有锁, 写表期间释放锁
+static kv_error_t flush_imm(kv_lsm_t *lsm) {
+    kv_memtable_t *imm = lsm->imm;
+    uint64_t number = lsm->next_file++;
+    pthread_mutex_unlock(&lsm->mutex);
+
+    kv_table_t *table = NULL;
+    kv_error_t err = KV_OK;
+    if (skiplist_lf_size(imm->list) > 0) err = build_table_from_memtable(lsm, number, imm, &table);
+
+    pthread_mutex_lock(&lsm->mutex);
+    kv_version_t *v = err == KV_OK ? version_copy(lsm->current) : NULL;
+    if (err == KV_OK && !v) err = KV_MEMORY_ERROR;
+    if (err == KV_OK && table && !version_add(v, 0, table, 0)) err = KV_MEMORY_ERROR;
+    uint64_t log_number = lsm->wal_number;
+    uint64_t next_file = lsm->next_file;
+    pthread_mutex_unlock(&lsm->mutex);
+
+    if (err == KV_OK) err = manifest_write(lsm, v, next_file, log_number);
+    if (err == KV_OK) delete_obsolete_logs(lsm, log_number);
+
+    pthread_mutex_lock(&lsm->mutex);
+    if (err == KV_OK) {
+        version_unref(lsm->current);
+        lsm->current = v;
+        lsm->log_number = log_number;
+        memtable_unref(lsm->imm);
+        lsm->imm = NULL;
+    } else {
+        if (table) table->obsolete = true;
+        version_unref(v);
+    }
+    table_unref(table);
+    pthread_cond_broadcast(&lsm->bg_cond);
+    return err;
+}
+
+typedef struct {
+    int level;                 // 输入层, 输出到 level + 1
+    kv_table_t **inputs[2];
+    size_t input_counts[2];
+    bool trivial_move;
+} kv_compaction_t;
+
+static double level_score(const kv_lsm_t *lsm, const kv_version_t *v, int level) {
+    if (level == 0) return (double)v->counts[0] / (double)lsm->config.level0_tables;
+    double limit = (double)lsm->config.level_base_size;
+    for (int i = 1; i < level; i++) limit *= (double)lsm->config.level_ratio;
+    return (double)level_bytes(v, level) / limit;
+}
+
+static bool needs_compaction(const kv_lsm_t *lsm, const kv_version_t *v) {
+    for (int level = 0; level < KV_LSM_MAX_LEVELS - 1; level++) {
+        if (level_score(lsm, v, level) >= 1.0) return true;
+    }
+    return false;
+}
+
+static bool ranges_overlap(const kv_table_t *t, const uint8_t *lo, size_t lo_len, const uint8_t *hi, size_t hi_len) {
+    return key_cmp(t->largest, t->largest_len, lo, lo_len) >= 0 && key_cmp(t->smallest, t->smallest_len, hi, hi_len) <= 0;
+}
+
+// 选择得分最高的层; 第 0 层取全部表, 其他层按压缩指针轮转选一张表, 再加上下一层与之重叠的表
+static bool pick_compaction(kv_lsm_t *lsm, const kv_version_t *v, kv_compaction_t *c) {
+    int best = -1;
+    double best_score = 1.0;
+    for (int level = 0; level < KV_LSM_MAX_LEVELS - 1; level++) {
+        double score = level_score(lsm, v, level);
+        if (score >= best_score) {
+            best = level;
+            best_score = score;
+        }
+    }
+    if (best < 0) return false;
+
+    memset(c, 0, sizeof(*c));
+    c->level = best;
+    if (best == 0) {
+        c->inputs[0] = malloc(v->counts[0] * sizeof(kv_table_t *));
+        if (!c->inputs[0]) return false;
+        memcpy(c->inputs[0], v->tables[0], v->counts[0] * sizeof(kv_table_t *));
+        c->input_counts[0] = v->counts[0];
+    } else {
+        size_t pick = 0;
+        for (size_t i = 0; lsm->compact_pointer[best] && i < v->counts[best]; i++) {
+            const kv_table_t *t = v->tables[best][i];
+            if (key_cmp(t->smallest, t->smallest_len, lsm->compact_pointer[best], lsm->compact_pointer_len[best]) > 0) {
+                pick = i;
+                break;
+            }
+        }
+        c->inputs[0] = malloc(sizeof(kv_table_t *));
+        if (!c->inputs[0]) return false;
+        c->inputs[0][0] = v->tables[best][pick];
+        c->input_counts[0] = 1;
+    }
+
+    // 输入键范围
+    const uint8_t *lo = c->inputs[0][0]->smallest, *hi = c->inputs[0][0]->largest;
+    size_t lo_len = c->inputs[0][0]->smallest_len, hi_len = c->inputs[0][0]->largest_len;
+    for (size_t i = 1; i < c->input_counts[0]; i++) {
+        const kv_table_t *t = c->inputs[0][i];
+        if (key_cmp(t->smallest, t->smallest_len, lo, lo_len) < 0) {
+            lo = t->smallest;
+            lo_len = t->smallest_len;
+        }
+        if (key_cmp(t->largest, t->largest_len, hi, hi_len) > 0) {
+            hi = t->largest;
+            hi_len = t->largest_len;
+        }
+    }
+
+    int next = best + 1;
+    c->inputs[1] = malloc((v->counts[next] + 1) * sizeof(kv_table_t *));
+    if (!c->inputs[1]) {
+        free(c->inputs[0]);
+        return false;
+    }
+    for (size_t i = 0; i < v->counts[next]; i++) {
+        if (ranges_overlap(v->tables[next][i], lo, lo_len, hi, hi_len)) {
+            c->inputs[1][c->input_counts[1]++] = v->tables[next][i];
+        }
+    }
+    // 非第 0 层的单张表与下一层没有重叠时直接下移, 不重写数据
+    c->trivial_move = best > 0 && c->input_counts[1] == 0;
+    return true;
+}
+
+// 输出层之下没有与输入范围重叠的表时, 删除标记可以丢弃
+static bool is_bottom(const kv_version_t *v, const kv_compaction_t *c) {
+    const uint8_t *lo = NULL, *hi = NULL;
+    size_t lo_len = 0, hi_len = 0;
+    for (int which = 0; which < 2; which++) {
+        for (size_t i = 0; i < c->input_counts[which]; i++) {
+            const kv_table_t *t = c->inputs[which][i];
+            if (!lo || key_cmp(t->smallest, t->smallest_len, lo, lo_len) < 0) {
+                lo = t->smallest;
+                lo_len = t->smallest_len;
+            }
+            if (!hi || key_cmp(t->largest, t->largest_len, hi, hi_len) > 0) {
+                hi = t->largest;
+                hi_len = t->largest_len;
+            }
+        }
+    }
+    for (int level = c->level + 2; level < KV_LSM_MAX_LEVELS; level++) {
+        for (size_t i = 0; i < v->counts[level]; i++) {
+            if (ranges_overlap(v->tables[level][i], lo, lo_len, hi, hi_len)) return false;
+        }
+    }
+    return true;
+}
+
+// 归并输入表并写出按大小切分的新表; 调用时持有锁, 归并期间释放锁
+static kv_error_t run_compaction(kv_lsm_t *lsm, kv_compaction_t *c) {
+    kv_version_t *base = lsm->current;
+    base->refs++;
+    bool drop_deletes = is_bottom(base, c);
+    pthread_mutex_unlock(&lsm->mutex);
+
+    kv_table_t **outputs = NULL;
+    size_t output_count = 0;
+    kv_error_t err = KV_OK;
+
+    if (!c->trivial_move) {
+        // 第 0 层的表各自一个迭代器 (从新到旧), 其他层与下一层各一个
+        size_t iter_count = (c->level == 0 ? c->input_counts[0] : 1) + 1;
+        kv_lsm_iter_t *iters = malloc(iter_count * sizeof(kv_lsm_iter_t));
+        kv_table_builder_t b;
+        memset(&b, 0, sizeof(b));
+        if (!iters) err = KV_MEMORY_ERROR;
+        if (err == KV_OK) {
+            if (c->level == 0) {
+                for (size_t i = 0; i < c->input_counts[0]; i++) iter_init_tables(&iters[i], &c->inputs[0][i], 1);
+            } else {
+                iter_init_tables(&iters[0], c->inputs[0], c->input_counts[0]);
+            }
+            iter_init_tables(&iters[iter_count - 1], c->inputs[1], c->input_counts[1]);
+        }
+
+        kv_lsm_iter_t *it;
+        while (err == KV_OK && (it = merge_pick(iters, iter_count, &err)) != NULL) {
+            if (it->type == KV_LSM_TYPE_DELETE && drop_deletes) {
+                iter_next(it);
+                continue;
+            }
+            if (!b.path) {
+                pthread_mutex_lock(&lsm->mutex);
+                uint64_t number = lsm->next_file++;
+                pthread_mutex_unlock(&lsm->mutex);
+                err = builder_open(lsm, number, &b);
+                if (err != KV_OK) break;
+            }
+            err = builder_add(lsm, &b, it->type, it->key, it->key_len, it->value, it->value_len);
+            iter_next(it);
+            if (err == KV_OK && builder_size(&b) >= lsm->config.table_size) {
+                kv_table_t *table;
+                kv_table_t **grown = realloc(outputs, (output_count + 1) * sizeof(kv_table_t *));
+                if (!grown) {
+                    err = KV_MEMORY_ERROR;
+                    break;
+                }
+                outputs = grown;
+                err = builder_finish(lsm, &b, &table);
+                if (err == KV_OK) outputs[output_count++] = table;
+            }
+        }
+        if (err == KV_OK && b.path) {
+            kv_table_t *table;
+            kv_table_t **grown = realloc(outputs, (output_count + 1) * sizeof(kv_table_t *));
+            if (!grown) {
+                err = KV_MEMORY_ERROR;
+            } else {
+                outputs = grown;
+                err = builder_finish(lsm, &b, &table);
+                if (err == KV_OK) outputs[output_count++] = table;
+            }
+        }
+        if (err != KV_OK && b.path) builder_abandon(&b);
+        free(iters);
+    }
+
+    // 生成新版本并写清单
+    pthread_mutex_lock(&lsm->mutex);
+    int next = c->level + 1;
+    kv_version_t *v = err == KV_OK ? version_copy(lsm->current) : NULL;
+    if (err == KV_OK && !v) err = KV_MEMORY_ERROR;
+    for (size_t i = 0; err == KV_OK && i < c->input_counts[0]; i++) {
+        kv_table_t *t = c->inputs[0][i];
+        if (c->trivial_move && !version_add_sorted(v, next, t)) err = KV_MEMORY_ERROR;
+        version_remove(v, c->level, t);
+    }
+    for (size_t i = 0; err == KV_OK && i < c->input_counts[1]; i++) version_remove(v, next, c->inputs[1][i]);
+    for (size_t i = 0; err == KV_OK && i < output_count; i++) {
+        if (!version_add_sorted(v, next, outputs[i])) err = KV_MEMORY_ERROR;
+    }
+    uint64_t next_file = lsm->next_file;
+    uint64_t log_number = lsm->log_number;
+    pthread_mutex_unlock(&lsm->mutex);
+
+    if (err == KV_OK) err = manifest_write(lsm, v, next_file, log_number);
+
+    pthread_mutex_lock(&lsm->mutex);
+    if (err == KV_OK) {
+        if (!c->trivial_move) {
+            for (size_t i = 0; i < c->input_counts[0]; i++) c->inputs[0][i]->obsolete = true;
+            for (size_t i = 0; i < c->input_counts[1]; i++) c->inputs[1][i]->obsolete = true;
+        }
+        const kv_table_t *last = c->inputs[0][c->input_counts[0] - 1];
+        if (c->level > 0) {
+            uint8_t *pointer = realloc(lsm->compact_pointer[c->level], last->largest_len + 1);
+            if (pointer) {
+                memcpy(pointer, last->largest, last->largest_len);
+                lsm->compact_pointer[c->level] = pointer;
+                lsm->compact_pointer_len[c->level] = last->largest_len;
+            }
+        }
+        version_unref(lsm->current);
+        lsm->current = v;
+    } else {
+        for (size_t i = 0; i < output_count; i++) outputs[i]->obsolete = true;
+        version_unref(v);
+    }
+    for (size_t i = 0; i < output_count; i++) table_unref(outputs[i]);
+    free(outputs);
+    version_unref(base);
+    pthread_cond_broadcast(&lsm->bg_cond);
+    return err;
+}
+
+static void background_work(void *arg) {
+    kv_lsm_t *lsm = arg;
+    pthread_mutex_lock(&lsm->mutex);
+    while (lsm->bg_error == KV_OK) {
+        kv_error_t err = KV_OK;
+        if (lsm->imm) {
+            err = flush_imm(lsm);
+        } else if (lsm->closing) {
+            break;
+        } else {
+            kv_compaction_t c;
+            if (!pick_compaction(lsm, lsm->current, &c)) break;
+            err = run_compaction(lsm, &c);
+            free(c.inputs[0]);
+            free(c.inputs[1]);
+        }
+        if (err != KV_OK) lsm->bg_error = err;
+    }
+    lsm->bg_scheduled = false;
+    pthread_cond_broadcast(&lsm->bg_cond);
+    pthread_mutex_unlock(&lsm->mutex);
+}
+
+// 调用时持有锁
+static void maybe_schedule(kv_lsm_t *lsm) {
+    if (lsm->bg_scheduled || lsm->bg_error != KV_OK) return;
+    if (!lsm->imm && (lsm->closing || !needs_compaction(lsm, lsm->current))) return;
+    threadpool_cleanup_completed(lsm->pool);
+    lsm->bg_scheduled = true;
+    if (threadpool_add_task(lsm->pool, background_work, lsm) == 0) {
+        lsm->bg_scheduled = false;
+        lsm->bg_error = KV_MEMORY_ERROR;
+    }
+}
+
+// ---------------- 写路径 ----------------
+
+static kv_error_t wal_create(kv_lsm_t *lsm, uint64_t number, int *fd) {
+    char *path = file_path(lsm, number, "wal");
+    if (!path) return KV_MEMORY_ERROR;
+    *fd = open(path, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    free(path);
+    return *fd < 0 ? KV_FILE_ERROR : KV_OK;
+}
+
+// 把当前内存表转为只读并切换到新日志; 调用时持有两把锁
+static kv_error_t switch_memtable(kv_lsm_t *lsm) {
+    kv_memtable_t *mem = memtable_create();
+    if (!mem) return KV_MEMORY_ERROR;
+    int fd;
+    uint64_t number = lsm->next_file++;
+    kv_error_t err = wal_create(lsm, number, &fd);
+    if (err != KV_OK) {
+        memtable_unref(mem);
+        return err;
+    }
+    close(lsm->wal_fd);
+    lsm->wal_fd = fd;
+    lsm->wal_number = number;
+    lsm->imm = lsm->mem;
+    lsm->mem = mem;
+    maybe_schedule(lsm);
+    return KV_OK;
+}
+
+// 为写入腾出空间: 第 0 层积压过多或只读内存表尚未写出时等待后台任务
+static kv_error_t make_room(kv_lsm_t *lsm) {
+    for (;;) {
+        if (lsm->bg_error != KV_OK) return lsm->bg_error;
+        if (lsm->current->counts[0] >= lsm->config.level0_tables * 3) {
+            maybe_schedule(lsm);
+            pthread_cond_wait(&lsm->bg_cond, &lsm->mutex);
+        } else if (memtable_bytes(lsm->mem) < lsm->config.memtable_size) {
+            return KV_OK;
+        } else if (lsm->imm) {
+            pthread_cond_wait(&lsm->bg_cond, &lsm->mutex);
+        } else {
+            return switch_memtable(lsm);
+        }
+    }
+}
+
+// 日志记录: CRC(4) 长度(4) 负载; 负载为一组记录, 重放时整体生效或整体丢弃
+static kv_error_t write_record(kv_lsm_t *lsm, kv_buf_t *payload) {
+    uint32_t crc = crc32c(payload->data + 8, payload->len - 8);
+    wr32(payload->data, crc);
+    wr32(payload->data + 4, (uint32_t)(payload->len - 8));
+
+    pthread_mutex_lock(&lsm->write_mutex);
+    pthread_mutex_lock(&lsm->mutex);
+    kv_error_t err = make_room(lsm);
+    int fd = lsm->wal_fd;
+    kv_memtable_t *mem = lsm->mem;
+    pthread_mutex_unlock(&lsm->mutex);
+
+    // 内存表只由持有 write_mutex 的写者切换, 插入无锁跳表时不需要持有 mutex
+    if (err == KV_OK) err = write_all(fd, payload->data, payload->len);
+    if (err == KV_OK && lsm->config.sync && fdatasync(fd) != 0) err = KV_WRITE_ERROR;
+    if (err == KV_OK) {
+        uint64_t seq = lsm->next_seq++;
+        const uint8_t *p = payload->data + 8, *end = payload->data + payload->len;
+        while (p < end && err == KV_OK) {
+            uint8_t type;
+            const uint8_t *key, *value;
+            uint32_t key_len, value_len;
+            if (!parse_entry(&p, end, &type, &key, &key_len, &value, &value_len)) break;
+            if (!memtable_add(mem, seq, type, key, key_len, value, value_len)) err = KV_MEMORY_ERROR;
+        }
+        // 整批插入后才对读者可见; 插入失败的批次不发布, 之后的写入也都会失败
+        if (err == KV_OK) atomic_store_explicit(&lsm->visible_seq, seq, memory_order_release);
+    }
+
+    if (err != KV_OK) {
+        // 日志写入失败后日志尾部可能不完整, 之后的写入都会失败
+        pthread_mutex_lock(&lsm->mutex);
+        if (lsm->bg_error == KV_OK) lsm->bg_error = err;
+        pthread_mutex_unlock(&lsm->mutex);
+    }
+    pthread_mutex_unlock(&lsm->write_mutex);
+    return err;
+}
+
+static kv_error_t write_ops(kv_lsm_t *lsm, const kv_entry_t *entries, size_t count, uint8_t type,
+                            const void *key, size_t key_len, const void *value, size_t value_len) {
+    kv_buf_t payload = { 0 };
+    uint8_t header[8] = { 0 };
+    bool ok = buf_append(&payload, header, sizeof(header));
+    if (entries) {
+        for (size_t i = 0; ok && i < count; i++) {
+            ok = buf_append_entry(&payload, KV_LSM_TYPE_PUT, entries[i].key, strlen(entries[i].key),
+                                  entries[i].value, strlen(entries[i].value));
+        }
+    } else {
+        ok = ok && buf_append_entry(&payload, type, key, key_len, value, value_len);
+    }
+    kv_error_t err = ok ? write_record(lsm, &payload) : KV_MEMORY_ERROR;
+    free(payload.data);
+    return err;
+}
+
+kv_error_t kv_lsm_put(kv_lsm_t *lsm, const void *key, size_t key_len, const void *value, size_t value_len) {
+    if (!lsm || !key || (!value && value_len) || key_len > UINT32_MAX || value_len > UINT32_MAX) {
+        return KV_INVALID_INPUT;
+    }
+    return write_ops(lsm, NULL, 0, KV_LSM_TYPE_PUT, key, key_len, value, value_len);
+}
+
+kv_error_t kv_lsm_delete(kv_lsm_t *lsm, const void *key, size_t key_len) {
+    if (!lsm || !key || key_len > UINT32_MAX) return KV_INVALID_INPUT;
+    return write_ops(lsm, NULL, 0, KV_LSM_TYPE_DELETE, key, key_len, NULL, 0);
+}
+
+kv_error_t kv_lsm_put_batch(kv_lsm_t *lsm, const kv_entry_t *entries, size_t count) {
+    if (!lsm || (!entries && count)) return KV_INVALID_INPUT;
+    for (size_t i = 0; i < count; i++) {
+        if (!entries[i].key || !entries[i].value) return KV_INVALID_INPUT;
+    }
+    if (count == 0) return KV_OK;
+    return write_ops(lsm, entries, count, 0, NULL, 0, NULL, 0);
+}
+
+// ---------------- 读路径 ----------------
+
+static kv_error_t copy_value(uint8_t type, const uint8_t *value, size_t len, void *buffer, size_t buffer_size,
+                             size_t *value_len) {
+    if (type == KV_LSM_TYPE_DELETE) return KV_KEY_NOT_FOUND;
+    if (value_len) *value_len = len;
+    if (len > buffer_size) return KV_BUFFER_TOO_SMALL;
+    if (len) memcpy(buffer, value, len);
+    return KV_OK;
+}
+
+kv_error_t kv_lsm_get(kv_lsm_t *lsm, const void *key, size_t key_len, void *buffer, size_t buffer_size,
+                      size_t *value_len) {
+    if (!lsm || !key || (!buffer && buffer_size)) return KV_INVALID_INPUT;
+
+    pthread_mutex_lock(&lsm->mutex);
+    kv_memtable_t *mem = lsm->mem;
+    kv_memtable_t *imm = lsm->imm;
+    kv_version_t *v = lsm->current;
+    uint64_t snapshot = atomic_load_explicit(&lsm->visible_seq, memory_order_acquire);
+    mem->refs++;
+    if (imm) imm->refs++;
+    v->refs++;
+    pthread_mutex_unlock(&lsm->mutex);
+
+    // 内存表是无锁跳表, 只读内存表与表都不再修改, 查找时不持锁; 未发布的批次不可见
+    kv_error_t err = KV_KEY_NOT_FOUND;
+    bool found = false;
+    const kv_lsm_record_t *rec = memtable_get(mem, key, key_len, snapshot);
+    if (!rec && imm) rec = memtable_get(imm, key, key_len, snapshot);
+    if (rec) {
+        err = copy_value(rec->type, rec->value, rec->value_len, buffer, buffer_size, value_len);
+        found = true;
+    }
+    for (int level = 0; !found && level < KV_LSM_MAX_LEVELS; level++) {
+        size_t count = v->counts[level];
+        kv_table_t **tables = v->tables[level];
+        size_t lo = 0, hi = count;
+        if (level > 0) {
+            // 各层内表不重叠, 二分找到唯一可能包含该键的表
+            while (lo < hi) {
+                size_t mid = (lo + hi) / 2;
+                if (key_cmp(tables[mid]->largest, tables[mid]->largest_len, key, key_len) < 0) {
+                    lo = mid + 1;
+                } else {
+                    hi = mid;
+                }
+            }
+            hi = lo < count ? lo + 1 : lo;
+        }
+        for (size_t i = lo; !found && i < hi; i++) {
+            uint8_t type;
+            const uint8_t *value;
+            uint32_t len;
+            if (table_may_contain(tables[i], key, key_len) && table_get(tables[i], key, key_len, &type, &value, &len)) {
+                err = copy_value(type, value, len, buffer, buffer_size, value_len);
+                found = true;
+            }
+        }
+    }
+
+    pthread_mutex_lock(&lsm->mutex);
+    memtable_unref(mem);
+    memtable_unref(imm);
+    version_unref(v);
+    pthread_mutex_unlock(&lsm->mutex);
+    return err;
+}
+
+kv_error_t kv_lsm_foreach(kv_lsm_t *lsm, kv_foreach_fn callback, void *user_data) {
+    if (!lsm || !callback) return KV_INVALID_INPUT;
+
+    pthread_mutex_lock(&lsm->mutex);
+    kv_memtable_t *mem = lsm->mem;
+    kv_memtable_t *imm = lsm->imm;
+    kv_version_t *v = lsm->current;
+    uint64_t snapshot = atomic_load_explicit(&lsm->visible_seq, memory_order_acquire);
+    mem->refs++;
+    if (imm) imm->refs++;
+    v->refs++;
+    pthread_mutex_unlock(&lsm->mutex);
+
+    // 内存表按 snapshot 过滤, 与引用住的只读内存表和表清单一起构成打开遍历时的快照
+    size_t iter_count = 2 + v->counts[0] + (KV_LSM_MAX_LEVELS - 1);
+    kv_lsm_iter_t *iters = malloc(iter_count * sizeof(kv_lsm_iter_t));
+    kv_error_t err = iters ? KV_OK : KV_MEMORY_ERROR;
+
+    kv_buf_t key = { 0 }, value = { 0 };
+    if (err == KV_OK) {
+        size_t n = 0;
+        iter_init_memtable(&iters[n++], mem, snapshot);
+        iter_init_memtable(&iters[n++], imm, snapshot);
+        for (size_t i = 0; i < v->counts[0]; i++) iter_init_tables(&iters[n++], &v->tables[0][i], 1);
+        for (int level = 1; level < KV_LSM_MAX_LEVELS; level++) {
+            iter_init_tables(&iters[n++], v->tables[level], v->counts[level]);
+        }
+
+        kv_lsm_iter_t *it;
+        while ((it = merge_pick(iters, iter_count, &err)) != NULL) {
+            if (it->type == KV_LSM_TYPE_PUT) {
+                key.len = 0;
+                value.len = 0;
+                if (!buf_append(&key, it->key, it->key_len) || !buf_append(&key, "", 1) ||
+                    !buf_append(&value, it->value, it->value_len) || !buf_append(&value, "", 1)) {
+                    err = KV_MEMORY_ERROR;
+                    break;
+                }
+                if (!callback((const char *)key.data, (const char *)value.data, it->value_len, user_data)) break;
+            }
+            iter_next(it);
+        }
+    }
+    free(key.data);
+    free(value.data);
+    free(iters);
+
+    pthread_mutex_lock(&lsm->mutex);
+    memtable_unref(mem);
+    memtable_unref(imm);
+    version_unref(v);
+    pthread_mutex_unlock(&lsm->mutex);
+    return err;
+}
+
+// ---------------- 打开与关闭 ----------------
+
+void kv_lsm_default_config(kv_lsm_config_t *config) {
+    if (!config) return;
+    config->memtable_size = 4 * 1024 * 1024;
+    config->block_size = 4096;
+    config->table_size = 2 * 1024 * 1024;
+    config->level0_tables = 4;
+    config->level_base_size = 10 * 1024 * 1024;
+    config->level_ratio = 10;
+    config->bloom_fp_rate = 0.01;
+    config->sync = true;
+}
+
+bool kv_lsm_is_store(const char *path) {
+    if (!path) return false;
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode)) return false;
+    size_t len = strlen(path) + 16;
+    char *manifest = malloc(len);
+    if (!manifest) return false;
+    snprintf(manifest, len, "%s/MANIFEST", path);
+    bool exists = stat(manifest, &st) == 0;
+    free(manifest);
+    return exists;
+}
+
+// 扫描目录: 收集需要重放的日志, 删除不在清单中的表和过期日志
+static kv_error_t scan_directory(kv_lsm_t *lsm, const kv_version_t *v, uint64_t **logs, size_t *log_count) {
+    DIR *dir = opendir(lsm->dir);
+    if (!dir) return KV_FILE_ERROR;
+    *logs = NULL;
+    *log_count = 0;
+    kv_error_t err = KV_OK;
+    struct dirent *ent;
+    while (err == KV_OK && (ent = readdir(dir)) != NULL) {
+        unsigned long long number;
+        char suffix[8];
+        if (sscanf(ent->d_name, "%llu.%7s", &number, suffix) != 2) continue;
+        if (number >= lsm->next_file) lsm->next_file = number + 1;
+        if (strcmp(suffix, "wal") == 0) {
+            if (number < lsm->log_number) {
+                remove_file(lsm, number, "wal");
+                continue;
+            }
+            uint64_t *grown = realloc(*logs, (*log_count + 1) * sizeof(uint64_t));
+            if (!grown) {
+                err = KV_MEMORY_ERROR;
+                break;
+            }
+            *logs = grown;
+            (*logs)[(*log_count)++] = number;
+        } else if (strcmp(suffix, "sst") == 0) {
+            bool live = false;
+            for (int level = 0; level < KV_LSM_MAX_LEVELS && !live; level++) {
+                for (size_t i = 0; i < v->counts[level] && !live; i++) live = v->tables[level][i]->number == number;
+            }
+            if (!live) remove_file(lsm, number, "sst");
+        }
+    }
+    closedir(dir);
+
+    // 日志按编号升序重放
+    for (size_t i = 1; i < *log_count; i++) {
+        uint64_t x = (*logs)[i];
+        size_t j = i;
+        while (j > 0 && (*logs)[j - 1] > x) {
+            (*logs)[j] = (*logs)[j - 1];
+            j--;
+        }
+        (*logs)[j] = x;
+    }
+    return err;
+}
+
+// 重放日志到内存表; 遇到不完整或校验失败的记录即停止 (崩溃时写了一半的尾部)
+// valid_len: 输出有效记录的总长度
+static kv_error_t replay_log(kv_lsm_t *lsm, uint64_t number, kv_memtable_t *mem, size_t *valid_len) {
+    char *path = file_path(lsm, number, "wal");
+    if (!path) return KV_MEMORY_ERROR;
+    FILE *fp = fopen(path, "rb");
+    free(path);
+    if (!fp) return KV_FILE_ERROR;
+
+    kv_buf_t buf = { 0 };
+    uint8_t chunk[1 << 14];
+    size_t n;
+    bool ok = true;
+    while (ok && (n = fread(chunk, 1, sizeof(chunk), fp)) > 0) ok = buf_append(&buf, chunk, n);
+    fclose(fp);
+    if (!ok) {
+        free(buf.data);
+        return KV_MEMORY_ERROR;
+    }
+
+    kv_error_t err = KV_OK;
+    size_t pos = 0;
+    while (err == KV_OK && buf.len - pos >= 8) {
+        uint32_t crc = rd32(buf.data + pos);
+        uint32_t len = rd32(buf.data + pos + 4);
+        if (len > buf.len - pos - 8 || crc != crc32c(buf.data + pos + 8, len)) break;
+        const uint8_t *p = buf.data + pos + 8, *end = p + len;
+        while (p < end) {
+            uint8_t type;
+            const uint8_t *key, *value;
+            uint32_t key_len, value_len;
+            if (!parse_entry(&p, end, &type, &key, &key_len, &value, &value_len)) {
+                err = KV_PARSE_ERROR;
+                break;
+            }
+            // 重放的记录序号为 0, 打开后即全部可见
+            if (!memtable_add(mem, 0, type, key, key_len, value, value_len)) {
+                err = KV_MEMORY_ERROR;
+                break;
+            }
+        }
+        pos += 8 + len;
+    }
+    *valid_len = pos;
+    free(buf.data);
+    return err;
+}
+
+static kv_error_t lsm_recover(kv_lsm_t *lsm) {
+    bool exists;
+    kv_version_t *v = version_copy(NULL);
+    if (!v) return KV_MEMORY_ERROR;
+    lsm->next_file = 1;
+    kv_error_t err = manifest_read(lsm, v, &exists);
+
+    uint64_t *logs = NULL;
+    size_t log_count = 0;
+    if (err == KV_OK) err = scan_directory(lsm, v, &logs, &log_count);
+
+    kv_memtable_t *mem = err == KV_OK ? memtable_create() : NULL;
+    size_t valid_len = 0;
+    if (err == KV_OK && !mem) err = KV_MEMORY_ERROR;
+    for (size_t i = 0; err == KV_OK && i < log_count; i++) err = replay_log(lsm, logs[i], mem, &valid_len);
+
+    // 只有一个未写满的日志时继续使用它和重放出的内存表 (截掉不完整的尾部),
+    // 否则把重放的数据写成第 0 层的表, 之后从新日志开始
+    bool reuse = err == KV_OK && log_count == 1 && memtable_bytes(mem) < lsm->config.memtable_size;
+    bool changed = !exists;
+    if (reuse) {
+        char *path = file_path(lsm, logs[0], "wal");
+        lsm->wal_fd = path ? open(path, O_WRONLY | O_APPEND | O_CLOEXEC) : -1;
+        free(path);
+        if (lsm->wal_fd < 0 || ftruncate(lsm->wal_fd, (off_t)valid_len) != 0) {
+            err = KV_FILE_ERROR;
+        } else {
+            lsm->wal_number = logs[0];
+            memtable_unref(lsm->mem);
+            lsm->mem = mem;
+            mem = NULL;
+            log_count = 0;
+        }
+    } else if (err == KV_OK && skiplist_lf_size(mem->list) > 0) {
+        kv_table_t *table = NULL;
+        err = build_table_from_memtable(lsm, lsm->next_file++, mem, &table);
+        if (err == KV_OK && !version_add(v, 0, table, 0)) err = KV_MEMORY_ERROR;
+        table_unref(table);
+    }
+    memtable_unref(mem);
+
+    if (err == KV_OK && !reuse) {
+        lsm->wal_number = lsm->next_file++;
+        err = wal_create(lsm, lsm->wal_number, &lsm->wal_fd);
+        changed = true;
+    }
+    if (err == KV_OK && changed) err = manifest_write(lsm, v, lsm->next_file, lsm->wal_number);
+    if (err == KV_OK) {
+        lsm->log_number = lsm->wal_number;
+        for (size_t i = 0; i < log_count; i++) remove_file(lsm, logs[i], "wal");
+        lsm->current = v;
+    } else {
+        version_unref(v);
+    }
+    free(logs);
+    return err;
+}
+
+kv_lsm_t* kv_lsm_open(const char *dir, const kv_lsm_config_t *config, kv_error_t *error) {
+    kv_error_t err = KV_OK;
+    if (!dir) {
+        if (error) *error = KV_INVALID_INPUT;
+        return NULL;
+    }
+    if (mkdir(dir, 0755) != 0 && errno != EEXIST) {
+        if (error) *error = KV_FILE_ERROR;
+        return NULL;
+    }
+
+    kv_lsm_t *lsm = calloc(1, sizeof(kv_lsm_t));
+    if (!lsm) {
+        if (error) *error = KV_MEMORY_ERROR;
+        return NULL;
+    }
+    if (config) {
+        lsm->config = *config;
+    } else {
+        kv_lsm_default_config(&lsm->config);
+    }
+    if (lsm->config.block_size == 0) lsm->config.block_size = 4096;
+    if (lsm->config.memtable_size == 0) lsm->config.memtable_size = 4 * 1024 * 1024;
+    if (lsm->config.table_size == 0) lsm->config.table_size = 2 * 1024 * 1024;
+    if (lsm->config.level0_tables == 0) lsm->config.level0_tables = 4;
+    if (lsm->config.level_base_size == 0) lsm->config.level_base_size = 10 * 1024 * 1024;
+    if (lsm->config.level_ratio < 2) lsm->config.level_ratio = 10;
+    if (lsm->config.bloom_fp_rate <= 0.0 || lsm->config.bloom_fp_rate >= 1.0) lsm->config.bloom_fp_rate = 0.01;
+    lsm->wal_fd = -1;
+    lsm->dir = strdup(dir);
+    pthread_mutex_init(&lsm->mutex, NULL);
+    pthread_mutex_init(&lsm->write_mutex, NULL);
+    pthread_cond_init(&lsm->bg_cond, NULL);
+    lsm->next_seq = 1;
+    atomic_init(&lsm->visible_seq, 0);
+
+    lsm->mem = memtable_create();
+    lsm->pool = threadpool_create(1);
+    if (!lsm->dir || !lsm->mem || !lsm->pool) err = KV_MEMORY_ERROR;
+    if (err == KV_OK) err = lsm_recover(lsm);
+    if (err != KV_OK) {
+        kv_lsm_close(lsm);
+        if (error) *error = err;
+        return NULL;
+    }
+
+    pthread_mutex_lock(&lsm->mutex);
+    maybe_schedule(lsm);
+    pthread_mutex_unlock(&lsm->mutex);
+    if (error) *error = KV_OK;
+    return lsm;
+}
+
+void kv_lsm_close(kv_lsm_t *lsm) {
+    if (!lsm) return;
+
+    pthread_mutex_lock(&lsm->mutex);
+    lsm->closing = true;
+    while (lsm->bg_scheduled) pthread_cond_wait(&lsm->bg_cond, &lsm->mutex);
+    pthread_mutex_unlock(&lsm->mutex);
+
+    threadpool_destroy(lsm->pool);
+    if (lsm->wal_fd >= 0) close(lsm->wal_fd);
+    memtable_unref(lsm->mem);
+    memtable_unref(lsm->imm);
+    version_unref(lsm->current);
+    for (int level = 0; level < KV_LSM_MAX_LEVELS; level++) free(lsm->compact_pointer[level]);
+    pthread_mutex_destroy(&lsm->mutex);
+    pthread_mutex_destroy(&lsm->write_mutex);
+    pthread_cond_destroy(&lsm->bg_cond);
+    free(lsm->dir);
+    free(lsm);
+}
+
+kv_error_t kv_lsm_flush(kv_lsm_t *lsm) {
+    if (!lsm) return KV_INVALID_INPUT;
+
+    pthread_mutex_lock(&lsm->write_mutex);
+    pthread_mutex_lock(&lsm->mutex);
+    kv_error_t err = KV_OK;
+    while (lsm->imm && lsm->bg_error == KV_OK) pthread_cond_wait(&lsm->bg_cond, &lsm->mutex);
+    if (lsm->bg_error == KV_OK && skiplist_lf_size(lsm->mem->list) > 0) err = switch_memtable(lsm);
+    maybe_schedule(lsm);
+    while (lsm->bg_scheduled) pthread_cond_wait(&lsm->bg_cond, &lsm->mutex);
+    if (err == KV_OK) err = lsm->bg_error;
+    pthread_mutex_unlock(&lsm->mutex);
+    pthread_mutex_unlock(&lsm->write_mutex);
+    return err;
+}
+
+kv_error_t kv_lsm_clear(kv_lsm_t *lsm) {
+    if (!lsm) return KV_INVALID_INPUT;
+
+    pthread_mutex_lock(&lsm->write_mutex);
+    pthread_mutex_lock(&lsm->mutex);
+    while (lsm->bg_scheduled) pthread_cond_wait(&lsm->bg_cond, &lsm->mutex);
+
+    // 新清单不含任何表且日志号指向新日志, 写入清单即完成清空
+    kv_error_t err = lsm->bg_error;
+    kv_version_t *v = err == KV_OK ? version_copy(NULL) : NULL;
+    kv_memtable_t *mem = err == KV_OK ? memtable_create() : NULL;
+    if (err == KV_OK && (!v || !mem)) err = KV_MEMORY_ERROR;
+    int fd = -1;
+    uint64_t number = lsm->next_file++;
+    if (err == KV_OK) err = wal_create(lsm, number, &fd);
+    if (err == KV_OK) err = manifest_write(lsm, v, lsm->next_file, number);
+    if (err == KV_OK) {
+        for (int level = 0; level < KV_LSM_MAX_LEVELS; level++) {
+            for (size_t i = 0; i < lsm->current->counts[level]; i++) lsm->current->tables[level][i]->obsolete = true;
+            free(lsm->compact_pointer[level]);
+            lsm->compact_pointer[level] = NULL;
+        }
+        version_unref(lsm->current);
+        lsm->current = v;
+        memtable_unref(lsm->mem);
+        memtable_unref(lsm->imm);
+        lsm->mem = mem;
+        lsm->imm = NULL;
+        close(lsm->wal_fd);
+        lsm->wal_fd = fd;
+        lsm->wal_number = number;
+        lsm->log_number = number;
+        delete_obsolete_logs(lsm, number);
+    } else {
+        if (fd >= 0) {
+            close(fd);
+            remove_file(lsm, number, "wal");
+        }
+        version_unref(v);
+        memtable_unref(mem);
+    }
+    pthread_mutex_unlock(&lsm->mutex);
+    pthread_mutex_unlock(&lsm->write_mutex);
+    return err;
+}
+
+size_t kv_lsm_disk_size(kv_lsm_t *lsm) {
+    if (!lsm) return 0;
+    pthread_mutex_lock(&lsm->mutex);
+    size_t size = 0;
+    for (int level = 0; level < KV_LSM_MAX_LEVELS; level++) size += level_bytes(lsm->current, level);
+    struct stat st;
+    if (fstat(lsm->wal_fd, &st) == 0) size += (size_t)st.st_size;
+    pthread_mutex_unlock(&lsm->mutex);
+    return size;
+}
+
+size_t kv_lsm_level_tables(kv_lsm_t *lsm, int level) {
+    if (!lsm || level < 0 || level >= KV_LSM_MAX_LEVELS) return 0;
+    pthread_mutex_lock(&lsm->mutex);
+    size_t count = lsm->current->counts[level];
+    pthread_mutex_unlock(&lsm->mutex);
+    return count;
+}
@@ -0,0 +1,80 @@
+#ifndef C_UTILS_KV_LSM_H
+#define C_UTILS_KV_LSM_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "kv_store.h"
+
+// 日志结构合并树 (LSM) 存储引擎: kv_store 的写优化模式
+//
+// 存储为一个目录:
+// - NNNNNN.wal: 预写日志, 写入先顺序追加到日志, 再插入内存表 (跳表)
+// - NNNNNN.sst: 不可变有序表, 依次为数据块、布隆过滤器、块索引和定长尾部, 每块带 CRC32C
+// - MANIFEST: 各层的表清单, 写临时文件后 rename 原子替换
+// 内存表是无锁跳表 (skiplist_lockfree.h), 读者查找时不持有句柄的锁; 每条记录带批次序号,
+// 读者只看打开查找时已完整写入的批次.
+// 内存表写满后转为只读, 由线程池中的后台任务写成第 0 层的表; 第 0 层表数量或其余各层的大小
+// 超过阈值时, 后台任务把该层的表与下一层重叠的表归并到下一层 (分层压缩).
+// 读取依次查内存表、只读内存表、第 0 层 (从新到旧) 和之后各层 (每层至多一张表),
+// 每张表先查布隆过滤器, 再二分块索引, 最多读取一个数据块.
+// 句柄内部加锁, 可以被多个线程同时使用; 同一目录同一时刻只能被一个句柄打开.
+
+#define KV_LSM_MAX_LEVELS 7
+
+// LSM 配置
+typedef struct {
+    size_t memtable_size;    // 内存表大小上限 (字节)
+    size_t block_size;       // 数据块目标大小
+    size_t table_size;       // 压缩输出表的目标大小
+    size_t level0_tables;    // 第 0 层触发压缩的表数量, 达到 3 倍时写入等待压缩
+    size_t level_base_size;  // 第 1 层大小上限, 之后每层乘以 level_ratio
+    size_t level_ratio;
+    double bloom_fp_rate;    // 布隆过滤器假阳性率
+    bool sync;               // 每次写入后 fdatasync 日志
+} kv_lsm_config_t;
+
+typedef struct kv_lsm_s kv_lsm_t;
+
+// 获取默认配置
+void kv_lsm_default_config(kv_lsm_config_t *config);
+
+// 检查路径是否为 LSM 存储目录
+bool kv_lsm_is_store(const char *path);
+
+// 打开 LSM 存储, 目录不存在时创建; 重放预写日志恢复未落盘的写入
+// 返回: 成功返回句柄, 失败返回 NULL 并设置 error
+kv_lsm_t* kv_lsm_open(const char *dir, const kv_lsm_config_t *config, kv_error_t *error);
+
+// 关闭存储, 等待进行中的后台任务结束
+void kv_lsm_close(kv_lsm_t *lsm);
+
+// 写入键值对
+kv_error_t kv_lsm_put(kv_lsm_t *lsm, const void *key, size_t key_len, const void *value, size_t value_len);
+
+// 写入删除标记 (不检查键是否存在)
+kv_error_t kv_lsm_delete(kv_lsm_t *lsm, const void *key, size_t key_len);
+
+// 批量写入, 作为一条日志记录原子写入
+kv_error_t kv_lsm_put_batch(kv_lsm_t *lsm, const kv_entry_t *entries, size_t count);
+
+// 读取值, 语义同 kv_store_get
+kv_error_t kv_lsm_get(kv_lsm_t *lsm, const void *key, size_t key_len, void *buffer, size_t buffer_size,
+                      size_t *value_len);
+
+// 按键的字节序遍历快照, 回调期间不持有锁
+kv_error_t kv_lsm_foreach(kv_lsm_t *lsm, kv_foreach_fn callback, void *user_data);
+
+// 把内存表写成表, 并等待后台压缩完成
+kv_error_t kv_lsm_flush(kv_lsm_t *lsm);
+
+// 删除全部数据
+kv_error_t kv_lsm_clear(kv_lsm_t *lsm);
+
+// 获取表与日志占用的磁盘空间 (字节)
+size_t kv_lsm_disk_size(kv_lsm_t *lsm);
+
+// 获取某一层的表数量
+size_t kv_lsm_level_tables(kv_lsm_t *lsm, int level);
+
+#endif // C_UTILS_KV_LSM_H
@@ -0,0 +1,749 @@
+#include "kv_pager.h"
+#include "crc32.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#define KV_META_MAGIC 0x564B5543u   /* "CUKV" */
+#define KV_META_VERSION 1
+#define KV_FIRST_DATA_PAGE 2
+#define KV_PAGE_HEADER 16
+#define KV_FREELIST_CAPACITY ((KV_PAGE_SIZE - KV_PAGE_HEADER) / sizeof(kv_pgno_t))
+#define KV_MIN_CACHE_PAGES 32
+
+// 元数据页内容 (主机字节序)
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t page_size;
+    uint32_t reserved;
+    uint64_t txid;
+    uint32_t root;
+    uint32_t page_count;
+    uint32_t freelist;
+    uint32_t reserved2;
+    uint64_t entry_count;
+    uint32_t checksum;  // 覆盖之前所有字段的 CRC32C
+} kv_meta_disk_t;
+
+// 页号 -> 下标的开放寻址表, 键 0 表示空槽 (0 号页是元数据页, 不会作为键)
+typedef struct {
+    uint32_t *keys;
+    uint32_t *vals;
+    size_t cap;
+    size_t count;
+} kv_pgmap_t;
+
+typedef struct {
+    kv_pgno_t pgno;  // 0 表示空闲帧
+    bool dirty;
+    bool ref;        // clock 访问位
+    uint32_t pins;
+} kv_frame_t;
+
+typedef struct {
+    kv_pgno_t *items;
+    size_t count;
+    size_t cap;
+} kv_pgno_list_t;
+
+struct kv_pager_s {
+    int fd;
+    kv_pager_config_t config;
+
+    uint8_t *map;
+    size_t map_pages;
+
+    kv_frame_t *frames;
+    uint8_t *frame_data;
+    size_t frame_count;
+    size_t clock_hand;
+    kv_pgmap_t frame_index;
+
+    kv_pager_meta_t meta;
+    kv_pgno_t freelist_head;
+    int meta_slot;
+
+    // 空闲页: free_ids 可立即复用, freelist_pages 是已提交空闲链表自身占用的页
+    bool free_loaded;
+    kv_pgno_list_t free_ids;
+    kv_pgno_list_t freelist_pages;
+
+    // 写事务
+    bool in_txn;
+    uint32_t page_count;
+    kv_pgmap_t fresh;        // 本事务分配的页, 可原地修改
+    kv_pgno_list_t pending;  // 本事务释放的已提交页, 提交后才可复用
+};
+
+// ---------------- 页号表 ----------------
+
+static inline size_t pgmap_slot(uint32_t key, size_t mask) {
+    return (size_t)(key * 2654435761u) & mask;
+}
+
+static bool pgmap_init(kv_pgmap_t *m, size_t cap) {
+    size_t n = 16;
+    while (n < cap) n <<= 1;
+    m->keys = calloc(n, sizeof(uint32_t));
+    m->vals = malloc(n * sizeof(uint32_t));
+    m->cap = n;
+    m->count = 0;
+    return m->keys && m->vals;
+}
+
+static void pgmap_destroy(kv_pgmap_t *m) {
+    free(m->keys);
+    free(m->vals);
+}
+
+static void pgmap_clear(kv_pgmap_t *m) {
+    if (m->count == 0) return;
+    memset(m->keys, 0, m->cap * sizeof(uint32_t));
+    m->count = 0;
+}
+
+static bool pgmap_get(const kv_pgmap_t *m, uint32_t key, uint32_t *val) {
+    size_t mask = m->cap - 1;
+    for (size_t i = pgmap_slot(key, mask);; i = (i + 1) & mask) {
+        if (m->keys[i] == key) {
+            if (val) *val = m->vals[i];
+            return true;
+        }
+        if (m->keys[i] == 0) return false;
+    }
+}
+
+static bool pgmap_put(kv_pgmap_t *m, uint32_t key, uint32_t val) {
+    if ((m->count + 1) * 2 > m->cap) {
+        kv_pgmap_t grown;
+        if (!pgmap_init(&grown, m->cap * 2)) {
+            pgmap_destroy(&grown);
+            return false;
+        }
+        for (size_t i = 0; i < m->cap; i++) {
+            if (m->keys[i]) pgmap_put(&grown, m->keys[i], m->vals[i]);
+        }
+        pgmap_destroy(m);
+        *m = grown;
+    }
+    size_t mask = m->cap - 1;
+    size_t i = pgmap_slot(key, mask);
+    while (m->keys[i] && m->keys[i] != key) i = (i + 1) & mask;
+    if (!m->keys[i]) m->count++;
+    m->keys[i] = key;
+    m->vals[i] = val;
+    return true;
+}
+
+// 线性探测删除: 把后续同簇元素前移, 不留墓碑
+static void pgmap_remove(kv_pgmap_t *m, uint32_t key) {
+    size_t mask = m->cap - 1;
+    size_t i = pgmap_slot(key, mask);
+    while (m->keys[i] != key) {
+        if (m->keys[i] == 0) return;
+        i = (i + 1) & mask;
+    }
+    m->keys[i] = 0;
+    m->count--;
+    for (size_t j = (i + 1) & mask; m->keys[j]; j = (j + 1) & mask) {
+        size_t home = pgmap_slot(m->keys[j], mask);
+        // home 不在 (i, j] 区间内时, 该元素可以移到空槽 i
+        if ((j > i && (home <= i || home > j)) || (j < i && (home <= i && home > j))) {
+            m->keys[i] = m->keys[j];
+            m->vals[i] = m->vals[j];
+            m->keys[j] = 0;
+            i = j;
+        }
+    }
+}
+
+static bool list_push(kv_pgno_list_t *list, kv_pgno_t pgno) {
+    if (list->count == list->cap) {
+        size_t cap = list->cap ? list->cap * 2 : 64;
+        kv_pgno_t *items = realloc(list->items, cap * sizeof(kv_pgno_t));
+        if (!items) return false;
+        list->items = items;
+        list->cap = cap;
+    }
+    list->items[list->count++] = pgno;
+    return true;
+}
+
+// ---------------- 文件读写 ----------------
+
+static kv_error_t write_page(kv_pager_t *p, kv_pgno_t pgno, const uint8_t *data) {
+    off_t offset = (off_t)pgno * KV_PAGE_SIZE;
+    size_t done = 0;
+    while (done < KV_PAGE_SIZE) {
+        ssize_t n = pwrite(p->fd, data + done, KV_PAGE_SIZE - done, offset + (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return KV_WRITE_ERROR;
+        done += (size_t)n;
+    }
+    return KV_OK;
+}
+
+static kv_error_t read_page(kv_pager_t *p, kv_pgno_t pgno, uint8_t *data) {
+    off_t offset = (off_t)pgno * KV_PAGE_SIZE;
+    size_t done = 0;
+    while (done < KV_PAGE_SIZE) {
+        ssize_t n = pread(p->fd, data + done, KV_PAGE_SIZE - done, offset + (off_t)done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return KV_READ_ERROR;
+        done += (size_t)n;
+    }
+    return KV_OK;
+}
+
+static kv_error_t sync_file(kv_pager_t *p) {
+    if (!p->config.sync) return KV_OK;
+    return fdatasync(p->fd) == 0 ? KV_OK : KV_WRITE_ERROR;
+}
+
+static void unmap_file(kv_pager_t *p) {
+    if (p->map) munmap(p->map, p->map_pages * KV_PAGE_SIZE);
+    p->map = NULL;
+    p->map_pages = 0;
+}
+
+// 映射已提交的全部页; 映射失败时退回页缓存读取
+static void map_file(kv_pager_t *p) {
+    if (!p->config.use_mmap) return;
+    struct stat st;
+    if (fstat(p->fd, &st) != 0) return;
+    size_t pages = (size_t)st.st_size / KV_PAGE_SIZE;
+    if (pages > p->meta.page_count) pages = p->meta.page_count;
+    if (pages == p->map_pages) return;
+
+    unmap_file(p);
+    if (pages == 0) return;
+    void *map = mmap(NULL, pages * KV_PAGE_SIZE, PROT_READ, MAP_SHARED, p->fd, 0);
+    if (map == MAP_FAILED) return;
+    p->map = map;
+    p->map_pages = pages;
+}
+
+static uint32_t meta_checksum(const kv_meta_disk_t *meta) {
+    return crc32_compute(meta, offsetof(kv_meta_disk_t, checksum), CRC32_C, NULL);
+}
+
+static bool read_meta(kv_pager_t *p, int slot, kv_meta_disk_t *meta) {
+    ssize_t n = pread(p->fd, meta, sizeof(*meta), (off_t)slot * KV_PAGE_SIZE);
+    if (n != (ssize_t)sizeof(*meta)) return false;
+    return meta->magic == KV_META_MAGIC && meta->version == KV_META_VERSION && meta->page_size == KV_PAGE_SIZE &&
+           meta->checksum == meta_checksum(meta) && meta->page_count >= KV_FIRST_DATA_PAGE &&
+           meta->root < meta->page_count && meta->freelist < meta->page_count;
+}
+
+static kv_error_t write_meta(kv_pager_t *p, int slot, uint64_t txid, kv_pgno_t root, uint32_t page_count,
+                             kv_pgno_t freelist, uint64_t entry_count) {
+    uint8_t page[KV_PAGE_SIZE];
+    kv_meta_disk_t meta;
+    memset(page, 0, sizeof(page));
+    memset(&meta, 0, sizeof(meta));
+    meta.magic = KV_META_MAGIC;
+    meta.version = KV_META_VERSION;
+    meta.page_size = KV_PAGE_SIZE;
+    meta.txid = txid;
+    meta.root = root;
+    meta.page_count = page_count;
+    meta.freelist = freelist;
+    meta.entry_count = entry_count;
+    meta.checksum = meta_checksum(&meta);
+    memcpy(page, &meta, sizeof(meta));
+    return write_page(p, (kv_pgno_t)slot, page);
+}
+
+// ---------------- 页缓存 ----------------
+
+static inline uint8_t* frame_data(kv_pager_t *p, size_t idx) {
+    return p->frame_data + idx * KV_PAGE_SIZE;
+}
+
+// clock 淘汰: 跳过固定的帧, 访问位为 1 的帧清零后给第二次机会, 脏帧写回原页号
+static kv_error_t frame_acquire(kv_pager_t *p, size_t *out) {
+    for (size_t scanned = 0; scanned < 2 * p->frame_count + 1; scanned++) {
+        size_t i = p->clock_hand;
+        p->clock_hand = (i + 1) % p->frame_count;
+        kv_frame_t *f = &p->frames[i];
+        if (f->pgno == KV_PGNO_NONE) {
+            *out = i;
+            return KV_OK;
+        }
+        if (f->pins) continue;
+        if (f->ref) {
+            f->ref = false;
+            continue;
+        }
+        if (f->dirty) {
+            kv_error_t err = write_page(p, f->pgno, frame_data(p, i));
+            if (err != KV_OK) return err;
+            f->dirty = false;
+        }
+        pgmap_remove(&p->frame_index, f->pgno);
+        f->pgno = KV_PGNO_NONE;
+        *out = i;
+        return KV_OK;
+    }
+    return KV_MEMORY_ERROR;
+}
+
+static kv_error_t frame_install(kv_pager_t *p, kv_pgno_t pgno, size_t *out) {
+    kv_error_t err = frame_acquire(p, out);
+    if (err != KV_OK) return err;
+    if (!pgmap_put(&p->frame_index, pgno, (uint32_t)*out)) return KV_MEMORY_ERROR;
+    kv_frame_t *f = &p->frames[*out];
+    f->pgno = pgno;
+    f->dirty = false;
+    f->ref = true;
+    f->pins = 1;
+    return KV_OK;
+}
+
+static void frame_drop(kv_pager_t *p, kv_pgno_t pgno) {
+    uint32_t idx;
+    if (!pgmap_get(&p->frame_index, pgno, &idx)) return;
+    pgmap_remove(&p->frame_index, pgno);
+    kv_frame_t *f = &p->frames[idx];
+    f->pgno = KV_PGNO_NONE;
+    f->dirty = false;
+    f->ref = false;
+    f->pins = 0;
+}
+
+// 取得某页在缓存中的帧; load 为 true 时未命中则从 mmap 或文件读入
+static kv_error_t frame_get(kv_pager_t *p, kv_pgno_t pgno, bool load, size_t *out) {
+    uint32_t idx;
+    if (pgmap_get(&p->frame_index, pgno, &idx)) {
+        p->frames[idx].ref = true;
+        p->frames[idx].pins++;
+        *out = idx;
+        return KV_OK;
+    }
+
+    kv_error_t err = frame_install(p, pgno, out);
+    if (err != KV_OK) return err;
+    if (!load) return KV_OK;
+
+    if (p->map && pgno < p->map_pages) {
+        memcpy(frame_data(p, *out), p->map + (size_t)pgno * KV_PAGE_SIZE, KV_PAGE_SIZE);
+        return KV_OK;
+    }
+    err = read_page(p, pgno, frame_data(p, *out));
+    if (err != KV_OK) frame_drop(p, pgno);
+    return err;
+}
+
+// ---------------- 空闲页 ----------------
+
+static kv_error_t load_freelist(kv_pager_t *p) {
+    p->free_ids.count = 0;
+    p->freelist_pages.count = 0;
+
+    kv_pgno_t pgno = p->freelist_head;
+    size_t guard = 0;
+    while (pgno != KV_PGNO_NONE) {
+        if (++guard > p->meta.page_count) return KV_PARSE_ERROR;
+        kv_error_t err;
+        const uint8_t *page = kv_pager_read(p, pgno, &err);
+        if (!page) return err;
+
+        uint16_t count;
+        kv_pgno_t next;
+        memcpy(&count, page + 2, sizeof(count));
+        memcpy(&next, page + 8, sizeof(next));
+        if (page[0] != KV_PAGE_FREELIST || count > KV_FREELIST_CAPACITY) {
+            kv_pager_unpin(p, pgno);
+            return KV_PARSE_ERROR;
+        }
+        if (!list_push(&p->freelist_pages, pgno)) return KV_MEMORY_ERROR;
+        for (uint16_t i = 0; i < count; i++) {
+            kv_pgno_t id;
+            memcpy(&id, page + KV_PAGE_HEADER + i * sizeof(kv_pgno_t), sizeof(id));
+            if (id < KV_FIRST_DATA_PAGE || id >= p->meta.page_count) {
+                kv_pager_unpin(p, pgno);
+                return KV_PARSE_ERROR;
+            }
+            if (!list_push(&p->free_ids, id)) return KV_MEMORY_ERROR;
+        }
+        kv_pager_unpin(p, pgno);
+        pgno = next;
+    }
+    p->free_loaded = true;
+    return KV_OK;
+}
+
+// 写出新的空闲链表, 链表页优先取自可立即复用的空闲页
+static kv_error_t write_freelist(kv_pager_t *p, kv_pgno_t *head) {
+    size_t total = p->free_ids.count + p->pending.count;
+    size_t pages = 0;
+    while (pages * KV_FREELIST_CAPACITY < total - (pages < p->free_ids.count ? pages : p->free_ids.count)) {
+        pages++;
+    }
+
+    kv_pgno_t *chain = malloc((pages ? pages : 1) * sizeof(kv_pgno_t));
+    if (!chain) return KV_MEMORY_ERROR;
+    for (size_t i = 0; i < pages; i++) {
+        if (p->free_ids.count > 0) {
+            chain[i] = p->free_ids.items[--p->free_ids.count];
+        } else if (p->page_count < UINT32_MAX) {
+            chain[i] = p->page_count++;
+        } else {
+            free(chain);
+            return KV_MEMORY_ERROR;
+        }
+        frame_drop(p, chain[i]);
+    }
+
+    size_t free_count = p->free_ids.count;
+    size_t next_id = 0;
+    for (size_t i = 0; i < pages; i++) {
+        uint8_t page[KV_PAGE_SIZE];
+        memset(page, 0, sizeof(page));
+        page[0] = KV_PAGE_FREELIST;
+        uint16_t count = 0;
+        while (count < KV_FREELIST_CAPACITY && next_id < free_count + p->pending.count) {
+            kv_pgno_t id = next_id < free_count ? p->free_ids.items[next_id] : p->pending.items[next_id - free_count];
+            memcpy(page + KV_PAGE_HEADER + count * sizeof(kv_pgno_t), &id, sizeof(id));
+            count++;
+            next_id++;
+        }
+        kv_pgno_t next = i + 1 < pages ? chain[i + 1] : KV_PGNO_NONE;
+        memcpy(page + 2, &count, sizeof(count));
+        memcpy(page + 8, &next, sizeof(next));
+        kv_error_t err = write_page(p, chain[i], page);
+        if (err != KV_OK) {
+            free(chain);
+            return err;
+        }
+    }
+
+    kv_error_t err = KV_OK;
+    p->freelist_pages.count = 0;
+    for (size_t i = 0; i < pages && err == KV_OK; i++) {
+        if (!list_push(&p->freelist_pages, chain[i])) err = KV_MEMORY_ERROR;
+    }
+    *head = pages ? chain[0] : KV_PGNO_NONE;
+    free(chain);
+    return err;
+}
+
+// ---------------- 公共接口 ----------------
+
+void kv_pager_default_config(kv_pager_config_t *config) {
+    if (!config) return;
+    config->cache_pages = 256;
+    config->use_mmap = true;
+    config->sync = true;
+}
+
+bool kv_pager_is_page_file(const char *path) {
+    if (!path) return false;
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+    uint32_t magic = 0;
+    bool ok = pread(fd, &magic, sizeof(magic), 0) == (ssize_t)sizeof(magic) && magic == KV_META_MAGIC;
+    if (!ok) {
+        ok = pread(fd, &magic, sizeof(magic), KV_PAGE_SIZE) == (ssize_t)sizeof(magic) && magic == KV_META_MAGIC;
+    }
+    close(fd);
+    return ok;
+}
+
+kv_pager_t* kv_pager_open(const char *path, const kv_pager_config_t *config, kv_error_t *error) {
+    kv_error_t err = KV_OK;
+    if (!path) {
+        if (error) *error = KV_INVALID_INPUT;
+        return NULL;
+    }
+
+    kv_pager_t *p = calloc(1, sizeof(kv_pager_t));
+    if (!p) {
+        if (error) *error = KV_MEMORY_ERROR;
+        return NULL;
+    }
+    if (config) {
+        p->config = *config;
+    } else {
+        kv_pager_default_config(&p->config);
+    }
+    if (p->config.cache_pages < KV_MIN_CACHE_PAGES) p->config.cache_pages = KV_MIN_CACHE_PAGES;
+
+    p->fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (p->fd < 0) {
+        free(p);
+        if (error) *error = KV_FILE_ERROR;
+        return NULL;
+    }
+
+    p->frame_count = p->config.cache_pages;
+    p->frames = calloc(p->frame_count, sizeof(kv_frame_t));
+    p->frame_data = aligned_alloc(KV_PAGE_SIZE, p->frame_count * KV_PAGE_SIZE);
+    if (!p->frames || !p->frame_data || !pgmap_init(&p->frame_index, p->frame_count * 2) ||
+        !pgmap_init(&p->fresh, 64)) {
+        err = KV_MEMORY_ERROR;
+        goto fail;
+    }
+
+    struct stat st;
+    if (fstat(p->fd, &st) != 0) {
+        err = KV_FILE_ERROR;
+        goto fail;
+    }
+
+    if (st.st_size == 0) {
+        // 新文件: 两个元数据页都写入, 事务号 0 与 1
+        err = write_meta(p, 0, 0, KV_PGNO_NONE, KV_FIRST_DATA_PAGE, KV_PGNO_NONE, 0);
+        if (err == KV_OK) err = write_meta(p, 1, 1, KV_PGNO_NONE, KV_FIRST_DATA_PAGE, KV_PGNO_NONE, 0);
+        if (err == KV_OK && fsync(p->fd) != 0) err = KV_WRITE_ERROR;
+        if (err != KV_OK) goto fail;
+    }
+
+    kv_meta_disk_t metas[2];
+    bool valid[2] = { read_meta(p, 0, &metas[0]), read_meta(p, 1, &metas[1]) };
+    if (!valid[0] && !valid[1]) {
+        err = KV_PARSE_ERROR;
+        goto fail;
+    }
+    int slot = (!valid[0] || (valid[1] && metas[1].txid > metas[0].txid)) ? 1 : 0;
+    p->meta_slot = slot;
+    p->meta.txid = metas[slot].txid;
+    p->meta.root = metas[slot].root;
+    p->meta.page_count = metas[slot].page_count;
+    p->meta.entry_count = metas[slot].entry_count;
+    p->freelist_head = metas[slot].freelist;
+    p->page_count = p->meta.page_count;
+
+    map_file(p);
+    if (error) *error = KV_OK;
+    return p;
+
+fail:
+    kv_pager_close(p);
+    if (error) *error = err;
+    return NULL;
+}
+
+void kv_pager_close(kv_pager_t *pager) {
+    if (!pager) return;
+
+    unmap_file(pager);
+    if (pager->fd >= 0) close(pager->fd);
+    free(pager->frames);
+    free(pager->frame_data);
+    pgmap_destroy(&pager->frame_index);
+    pgmap_destroy(&pager->fresh);
+    free(pager->free_ids.items);
+    free(pager->freelist_pages.items);
+    free(pager->pending.items);
+    free(pager);
+}
+
+const kv_pager_meta_t* kv_pager_get_meta(const kv_pager_t *pager) {
+    return pager ? &pager->meta : NULL;
+}
+
+size_t kv_pager_file_size(const kv_pager_t *pager) {
+    struct stat st;
+    if (!pager || fstat(pager->fd, &st) != 0) return 0;
+    return (size_t)st.st_size;
+}
+
+const uint8_t* kv_pager_read(kv_pager_t *pager, kv_pgno_t pgno, kv_error_t *error) {
+    uint32_t limit = pager->in_txn ? pager->page_count : pager->meta.page_count;
+    if (pgno < KV_FIRST_DATA_PAGE || pgno >= limit) {
+        if (error) *error = KV_PARSE_ERROR;
+        return NULL;
+    }
+
+    // 缓存中的版本优先 (可能是本事务尚未写回的页)
+    uint32_t idx;
+    if (pgmap_get(&pager->frame_index, pgno, &idx)) {
+        pager->frames[idx].ref = true;
+        pager->frames[idx].pins++;
+        return frame_data(pager, idx);
+    }
+    if (pager->map && pgno < pager->map_pages) {
+        return pager->map + (size_t)pgno * KV_PAGE_SIZE;
+    }
+
+    size_t slot;
+    kv_error_t err = frame_get(pager, pgno, true, &slot);
+    if (err != KV_OK) {
+        if (error) *error = err;
+        return NULL;
+    }
+    return frame_data(pager, slot);
+}
+
+kv_error_t kv_pager_begin(kv_pager_t *pager) {
+    if (!pager) return KV_INVALID_INPUT;
+    if (pager->in_txn) return KV_INVALID_INPUT;
+
+    if (!pager->free_loaded) {
+        kv_error_t err = load_freelist(pager);
+        kv_pager_unpin_all(pager);
+        if (err != KV_OK) return err;
+    }
+    pager->page_count = pager->meta.page_count;
+    pgmap_clear(&pager->fresh);
+    pager->pending.count = 0;
+    pager->in_txn = true;
+    return KV_OK;
+}
+
+kv_error_t kv_pager_alloc(kv_pager_t *pager, kv_pgno_t *pgno, uint8_t **data) {
+    if (!pager || !pager->in_txn) return KV_INVALID_INPUT;
+
+    kv_pgno_t id;
+    if (pager->free_ids.count > 0) {
+        id = pager->free_ids.items[--pager->free_ids.count];
+    } else {
+        if (pager->page_count == UINT32_MAX) return KV_MEMORY_ERROR;
+        id = pager->page_count++;
+    }
+    if (!pgmap_put(&pager->fresh, id, 1)) return KV_MEMORY_ERROR;
+
+    size_t slot;
+    kv_error_t err = frame_get(pager, id, false, &slot);
+    if (err != KV_OK) return err;
+    pager->frames[slot].dirty = true;
+    memset(frame_data(pager, slot), 0, KV_PAGE_SIZE);
+    *pgno = id;
+    *data = frame_data(pager, slot);
+    return KV_OK;
+}
+
+kv_error_t kv_pager_write(kv_pager_t *pager, kv_pgno_t pgno, kv_pgno_t *new_pgno, uint8_t **data) {
+    if (!pager || !pager->in_txn) return KV_INVALID_INPUT;
+    if (pgno < KV_FIRST_DATA_PAGE || pgno >= pager->page_count) return KV_PARSE_ERROR;
+
+    size_t slot;
+    kv_error_t err;
+    if (pgmap_get(&pager->fresh, pgno, NULL)) {
+        err = frame_get(pager, pgno, true, &slot);
+        if (err != KV_OK) return err;
+        pager->frames[slot].dirty = true;
+        *new_pgno = pgno;
+        *data = frame_data(pager, slot);
+        return KV_OK;
+    }
+
+    // 写时复制: 旧页在提交前保持不变
+    const uint8_t *src = kv_pager_read(pager, pgno, &err);
+    if (!src) return err;
+    uint8_t *dst;
+    err = kv_pager_alloc(pager, new_pgno, &dst);
+    if (err != KV_OK) return err;
+    memcpy(dst, src, KV_PAGE_SIZE);
+    kv_pager_unpin(pager, pgno);
+    if (!list_push(&pager->pending, pgno)) return KV_MEMORY_ERROR;
+    *data = dst;
+    return KV_OK;
+}
+
+void kv_pager_free(kv_pager_t *pager, kv_pgno_t pgno) {
+    if (!pager || !pager->in_txn || pgno < KV_FIRST_DATA_PAGE) return;
+
+    if (pgmap_get(&pager->fresh, pgno, NULL)) {
+        // 本事务分配的页未被任何已提交版本引用, 直接回收
+        pgmap_remove(&pager->fresh, pgno);
+        frame_drop(pager, pgno);
+        list_push(&pager->free_ids, pgno);
+    } else {
+        list_push(&pager->pending, pgno);
+    }
+}
+
+void kv_pager_unpin(kv_pager_t *pager, kv_pgno_t pgno) {
+    uint32_t idx;
+    if (pager && pgmap_get(&pager->frame_index, pgno, &idx) && pager->frames[idx].pins > 0) {
+        pager->frames[idx].pins--;
+    }
+}
+
+void kv_pager_unpin_all(kv_pager_t *pager) {
+    if (!pager) return;
+    for (size_t i = 0; i < pager->frame_count; i++) {
+        pager->frames[i].pins = 0;
+    }
+}
+
+kv_error_t kv_pager_commit(kv_pager_t *pager, kv_pgno_t root, uint64_t entry_count) {
+    if (!pager || !pager->in_txn) return KV_INVALID_INPUT;
+    kv_pager_unpin_all(pager);
+
+    // 旧空闲链表页在新元数据生效后才不再被引用
+    for (size_t i = 0; i < pager->freelist_pages.count; i++) {
+        if (!list_push(&pager->pending, pager->freelist_pages.items[i])) {
+            kv_pager_abort(pager);
+            return KV_MEMORY_ERROR;
+        }
+    }
+
+    kv_pgno_t freelist = KV_PGNO_NONE;
+    kv_error_t err = write_freelist(pager, &freelist);
+
+    // 1. 数据页落盘
+    for (size_t i = 0; err == KV_OK && i < pager->frame_count; i++) {
+        kv_frame_t *f = &pager->frames[i];
+        if (f->pgno != KV_PGNO_NONE && f->dirty) {
+            err = write_page(pager, f->pgno, frame_data(pager, i));
+            if (err == KV_OK) f->dirty = false;
+        }
+    }
+    if (err == KV_OK) err = sync_file(pager);
+
+    // 2. 写入另一个元数据页, 完成根切换
+    int slot = 1 - pager->meta_slot;
+    if (err == KV_OK) {
+        err = write_meta(pager, slot, pager->meta.txid + 1, root, pager->page_count, freelist, entry_count);
+    }
+    if (err == KV_OK) err = sync_file(pager);
+    if (err != KV_OK) {
+        kv_pager_abort(pager);
+        return err;
+    }
+
+    pager->meta_slot = slot;
+    pager->meta.txid++;
+    pager->meta.root = root;
+    pager->meta.page_count = pager->page_count;
+    pager->meta.entry_count = entry_count;
+    pager->freelist_head = freelist;
+
+    // 本事务释放的页从下一个事务开始可复用
+    for (size_t i = 0; i < pager->pending.count; i++) {
+        list_push(&pager->free_ids, pager->pending.items[i]);
+    }
+    pager->pending.count = 0;
+    pgmap_clear(&pager->fresh);
+    pager->in_txn = false;
+
+    if (pager->meta.page_count > pager->map_pages) map_file(pager);
+    return KV_OK;
+}
+
+void kv_pager_abort(kv_pager_t *pager) {
+    if (!pager || !pager->in_txn) return;
+
+    // 丢弃本事务写过的帧; 空闲页状态从磁盘重新加载
+    for (size_t i = 0; i < pager->frame_count; i++) {
+        kv_frame_t *f = &pager->frames[i];
+        if (f->pgno != KV_PGNO_NONE && (f->dirty || pgmap_get(&pager->fresh, f->pgno, NULL))) {
+            frame_drop(pager, f->pgno);
+        }
+        f->pins = 0;
+    }
+    pgmap_clear(&pager->fresh);
+    pager->pending.count = 0;
+    pager->free_loaded = false;
+    pager->page_count = pager->meta.page_count;
+    pager->in_txn = false;
+}
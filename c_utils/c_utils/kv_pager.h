@@ -0,0 +1,95 @@
+#ifndef C_UTILS_KV_PAGER_H
+#define C_UTILS_KV_PAGER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "kv_store.h"
+
+// 页式存储文件: kv_store 的磁盘层
+//
+// 文件由固定大小的页组成, 第 0/1 页是交替写入的元数据页, 其余为数据页.
+// 写事务只写新页 (写时复制), 提交时先落盘数据页, 再写入另一个元数据页完成根的原子切换;
+// 崩溃后打开时选择校验和有效且事务号最大的元数据页, 因此总能看到最后一次完整提交.
+// 读路径直接访问只读 mmap, 事务中新写的页经由带 clock 淘汰的页缓存.
+// 同一文件同一时刻只能有一个写者 (单进程), 句柄不是线程安全的.
+
+#define KV_PAGE_SIZE 4096
+
+// 页号, 0 和 1 为元数据页, 0 同时表示空页号
+typedef uint32_t kv_pgno_t;
+#define KV_PGNO_NONE 0
+
+// 页类型 (数据页第一个字节)
+typedef enum {
+    KV_PAGE_LEAF = 1,
+    KV_PAGE_BRANCH = 2,
+    KV_PAGE_OVERFLOW = 3,
+    KV_PAGE_FREELIST = 4
+} kv_page_type_t;
+
+// 页式文件配置
+typedef struct {
+    size_t cache_pages;  // 页缓存帧数, 最少 32
+    bool use_mmap;       // 读路径使用 mmap, 关闭时读取也经过页缓存
+    bool sync;           // 提交时调用 fdatasync
+} kv_pager_config_t;
+
+// 已提交的元数据
+typedef struct {
+    uint64_t txid;
+    kv_pgno_t root;
+    uint32_t page_count;
+    uint64_t entry_count;
+} kv_pager_meta_t;
+
+typedef struct kv_pager_s kv_pager_t;
+
+// 获取默认配置
+void kv_pager_default_config(kv_pager_config_t *config);
+
+// 检查文件是否为页式存储格式 (不存在或为空时返回 false)
+bool kv_pager_is_page_file(const char *path);
+
+// 打开页式文件, 不存在或为空时初始化
+// 返回: 成功返回句柄, 失败返回 NULL 并设置 error
+kv_pager_t* kv_pager_open(const char *path, const kv_pager_config_t *config, kv_error_t *error);
+
+// 关闭页式文件, 未提交的事务被丢弃
+void kv_pager_close(kv_pager_t *pager);
+
+// 获取已提交的元数据
+const kv_pager_meta_t* kv_pager_get_meta(const kv_pager_t *pager);
+
+// 获取文件大小 (字节)
+size_t kv_pager_file_size(const kv_pager_t *pager);
+
+// 读取页, 返回的指针在 kv_pager_unpin / kv_pager_unpin_all 或事务结束前有效
+const uint8_t* kv_pager_read(kv_pager_t *pager, kv_pgno_t pgno, kv_error_t *error);
+
+// 开始写事务
+kv_error_t kv_pager_begin(kv_pager_t *pager);
+
+// 获取页的可写副本: 本事务新分配的页原地修改, 否则复制到新页并释放旧页
+// new_pgno: 输出可写页的页号
+kv_error_t kv_pager_write(kv_pager_t *pager, kv_pgno_t pgno, kv_pgno_t *new_pgno, uint8_t **data);
+
+// 分配新页 (内容清零)
+kv_error_t kv_pager_alloc(kv_pager_t *pager, kv_pgno_t *pgno, uint8_t **data);
+
+// 释放页; 已提交的页在本事务提交后才可复用
+void kv_pager_free(kv_pager_t *pager, kv_pgno_t pgno);
+
+// 取消单个页的固定, 之后该页可被淘汰
+void kv_pager_unpin(kv_pager_t *pager, kv_pgno_t pgno);
+
+// 取消所有页的固定
+void kv_pager_unpin_all(kv_pager_t *pager);
+
+// 提交写事务并切换到新根
+kv_error_t kv_pager_commit(kv_pager_t *pager, kv_pgno_t root, uint64_t entry_count);
+
+// 放弃写事务
+void kv_pager_abort(kv_pager_t *pager);
+
+#endif // C_UTILS_KV_PAGER_H
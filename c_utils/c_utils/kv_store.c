@@ -1,8 +1,14 @@
 #include "kv_store.h"
+#include "kv_pager.h"
+#include "kv_lsm.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+// 旧版文本格式 ("key=value" 每行一条) 的解析, 仅用于迁移
 
 static kv_error_t parse_line(const char *line, char **key, char **value) {
     char *sep = strchr(line, '=');
@@ -85,188 +91,998 @@ static kv_error_t read_all_entries(const char *filename, kv_entry_t **entries, s
     return KV_OK;
 }
 
-static kv_error_t write_entries(const char *filename, const kv_entry_t *entries, size_t count) {
-    FILE *fp = fopen(filename, "w");
-    if (!fp) {
-        return KV_FILE_ERROR;
+
+// ---------------- 页格式 ----------------
+//
+// 数据页头 16 字节: 类型(1) 保留(1) 单元数(2) 单元区起点(2) 保留(2) link(4) 溢出长度(4)
+// 之后是 2 字节槽数组, 单元从页尾向前存放.
+// 叶子单元: 键长(2) 标志(1) 保留(1) 值长(4) 键 [值 | 溢出首页号(4)]
+// 分支单元: 键长(2) 保留(2) 子页号(4) 键; 页头 link 为最左子页, 单元 i 的子树包含 >= 键 i 的键
+
+#define KV_PAGE_HEADER 16
+#define KV_CELL_HEADER 8
+#define KV_MAX_KEY_SIZE 512
+#define KV_MAX_INLINE_CELL 1024
+#define KV_MAX_DEPTH 32
+#define KV_OVERFLOW_CAPACITY (KV_PAGE_SIZE - KV_PAGE_HEADER)
+#define KV_CELL_OVERFLOW 0x01
+
+struct kv_store_s {
+    kv_pager_t *pager;
+    kv_lsm_t *lsm;       // LSM 引擎时非空, pager 为空
+    kv_config_t config;
+    kv_pgno_t root;      // 当前事务中的根
+    uint64_t count;      // 当前事务中的条目数
+};
+
+typedef struct {
+    const uint8_t *data;
+    size_t len;
+} kv_cell_t;
+
+typedef struct {
+    bool split;
+    kv_pgno_t right;
+    uint16_t key_len;
+    uint8_t key[KV_MAX_KEY_SIZE];
+} kv_split_t;
+
+typedef struct {
+    kv_pgno_t pgno[KV_MAX_DEPTH];
+    uint16_t idx[KV_MAX_DEPTH];  // 分支页中选择的子页序号, 0 为最左子页
+    int depth;
+} kv_path_t;
+
+static inline uint16_t rd16(const uint8_t *p) {
+    uint16_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t rd32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline void wr16(uint8_t *p, uint16_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline void wr32(uint8_t *p, uint32_t v) {
+    memcpy(p, &v, sizeof(v));
+}
+
+static inline uint16_t page_cells(const uint8_t *page) {
+    return rd16(page + 2);
+}
+
+static inline const uint8_t* page_cell(const uint8_t *page, uint16_t i) {
+    return page + rd16(page + KV_PAGE_HEADER + 2 * i);
+}
+
+static inline size_t cell_size(const uint8_t *page, const uint8_t *cell) {
+    size_t size = KV_CELL_HEADER + rd16(cell);
+    if (page[0] == KV_PAGE_LEAF) size += (cell[2] & KV_CELL_OVERFLOW) ? 4 : rd32(cell + 4);
+    return size;
+}
+
+static inline kv_pgno_t branch_child(const uint8_t *page, uint16_t idx) {
+    return idx == 0 ? rd32(page + 8) : rd32(page_cell(page, idx - 1) + 4);
+}
+
+static inline int key_cmp(const uint8_t *a, size_t a_len, const uint8_t *b, size_t b_len) {
+    int c = memcmp(a, b, a_len < b_len ? a_len : b_len);
+    if (c) return c;
+    return (a_len > b_len) - (a_len < b_len);
+}
+
+static bool page_valid(const uint8_t *page) {
+    return (page[0] == KV_PAGE_LEAF || page[0] == KV_PAGE_BRANCH) &&
+           page_cells(page) <= (KV_PAGE_SIZE - KV_PAGE_HEADER) / 2;
+}
+
+// 叶子中第一个 >= key 的位置
+static uint16_t leaf_search(const uint8_t *page, const uint8_t *key, size_t key_len, bool *found) {
+    uint16_t lo = 0, hi = page_cells(page);
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        const uint8_t *cell = page_cell(page, mid);
+        if (key_cmp(cell + KV_CELL_HEADER, rd16(cell), key, key_len) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
     }
+    *found = false;
+    if (lo < page_cells(page)) {
+        const uint8_t *cell = page_cell(page, lo);
+        *found = key_cmp(cell + KV_CELL_HEADER, rd16(cell), key, key_len) == 0;
+    }
+    return lo;
+}
 
-    for (size_t i = 0; i < count; i++) {
-        if (fprintf(fp, "%s=%s\n", entries[i].key, entries[i].value) < 0) {
-            fclose(fp);
-            return KV_WRITE_ERROR;
+// 分支中应进入的子页序号: <= key 的分隔键个数
+static uint16_t branch_search(const uint8_t *page, const uint8_t *key, size_t key_len) {
+    uint16_t lo = 0, hi = page_cells(page);
+    while (lo < hi) {
+        uint16_t mid = (uint16_t)((lo + hi) / 2);
+        const uint8_t *cell = page_cell(page, mid);
+        if (key_cmp(cell + KV_CELL_HEADER, rd16(cell), key, key_len) <= 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
+    return lo;
+}
+
+static void page_build(uint8_t *page, uint8_t type, kv_pgno_t link, const kv_cell_t *cells, size_t count) {
+    memset(page, 0, KV_PAGE_SIZE);
+    page[0] = type;
+    wr16(page + 2, (uint16_t)count);
+    wr32(page + 8, link);
+    size_t upper = KV_PAGE_SIZE;
+    for (size_t i = 0; i < count; i++) {
+        upper -= cells[i].len;
+        memcpy(page + upper, cells[i].data, cells[i].len);
+        wr16(page + KV_PAGE_HEADER + 2 * i, (uint16_t)upper);
+    }
+    wr16(page + 4, (uint16_t)upper);
+}
 
-    fclose(fp);
+// 把页中的单元收集到数组, 单元指向 page
+static size_t page_gather(const uint8_t *page, kv_cell_t *cells) {
+    uint16_t count = page_cells(page);
+    for (uint16_t i = 0; i < count; i++) {
+        cells[i].data = page_cell(page, i);
+        cells[i].len = cell_size(page, cells[i].data);
+    }
+    return count;
+}
+
+// 把单元写入 page, 放不下时按字节数对半分裂到新分配的右页
+// 叶子分裂的分隔键为右页首键; 分支分裂时中间单元上移, 其子页成为右页的最左子页
+static kv_error_t page_store(kv_store_t *store, uint8_t *page, uint8_t type, kv_pgno_t link,
+                             const kv_cell_t *cells, size_t count, kv_split_t *split) {
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) total += cells[i].len;
+
+    split->split = false;
+    if (KV_PAGE_HEADER + 2 * count + total <= KV_PAGE_SIZE) {
+        page_build(page, type, link, cells, count);
+        return KV_OK;
+    }
+
+    size_t mid = 0, left = 0;
+    while (mid < count - 1 && (mid == 0 || left + cells[mid].len <= total / 2)) {
+        left += cells[mid].len;
+        mid++;
+    }
+    if (type == KV_PAGE_BRANCH && mid == count - 1) mid--;
+
+    kv_pgno_t right;
+    uint8_t *right_page;
+    kv_error_t err = kv_pager_alloc(store->pager, &right, &right_page);
+    if (err != KV_OK) return err;
+
+    const uint8_t *sep = cells[mid].data;
+    split->split = true;
+    split->right = right;
+    split->key_len = rd16(sep);
+    memcpy(split->key, sep + KV_CELL_HEADER, split->key_len);
+
+    if (type == KV_PAGE_LEAF) {
+        page_build(right_page, type, KV_PGNO_NONE, cells + mid, count - mid);
+    } else {
+        page_build(right_page, type, rd32(sep + 4), cells + mid + 1, count - mid - 1);
+    }
+    page_build(page, type, link, cells, mid);
     return KV_OK;
 }
 
-bool kv_save(const char *filename, const char *key, const char *value) {
-    kv_error_t error = kv_save_ex(filename, key, value, strlen(value));
-    return error == KV_OK;
+// ---------------- 溢出页 ----------------
+
+static kv_error_t overflow_write(kv_store_t *store, const uint8_t *value, size_t len, kv_pgno_t *first) {
+    size_t pages = (len + KV_OVERFLOW_CAPACITY - 1) / KV_OVERFLOW_CAPACITY;
+    kv_pgno_t next = KV_PGNO_NONE;
+    // 从尾部向前写, 每页写完即取消固定, 大值不会占满页缓存
+    for (size_t i = pages; i-- > 0;) {
+        size_t offset = i * KV_OVERFLOW_CAPACITY;
+        size_t chunk = len - offset < KV_OVERFLOW_CAPACITY ? len - offset : KV_OVERFLOW_CAPACITY;
+        kv_pgno_t pgno;
+        uint8_t *page;
+        kv_error_t err = kv_pager_alloc(store->pager, &pgno, &page);
+        if (err != KV_OK) return err;
+        page[0] = KV_PAGE_OVERFLOW;
+        wr32(page + 8, next);
+        wr32(page + 12, (uint32_t)chunk);
+        memcpy(page + KV_PAGE_HEADER, value + offset, chunk);
+        kv_pager_unpin(store->pager, pgno);
+        next = pgno;
+    }
+    *first = next;
+    return KV_OK;
 }
 
-char* kv_load(const char *filename, const char *key) {
-    char buffer[4096];
-    size_t value_len;
-    kv_error_t error = kv_load_ex(filename, key, buffer, sizeof(buffer), &value_len);
-    if (error != KV_OK) {
-        return NULL;
+static kv_error_t overflow_read(kv_store_t *store, kv_pgno_t pgno, uint8_t *out, size_t len) {
+    size_t done = 0;
+    while (done < len) {
+        kv_error_t err;
+        const uint8_t *page = kv_pager_read(store->pager, pgno, &err);
+        if (!page) return err;
+        uint32_t chunk = rd32(page + 12);
+        if (page[0] != KV_PAGE_OVERFLOW || chunk > KV_OVERFLOW_CAPACITY || chunk > len - done) {
+            kv_pager_unpin(store->pager, pgno);
+            return KV_PARSE_ERROR;
+        }
+        memcpy(out + done, page + KV_PAGE_HEADER, chunk);
+        done += chunk;
+        kv_pgno_t next = rd32(page + 8);
+        kv_pager_unpin(store->pager, pgno);
+        pgno = next;
+        if (done < len && pgno == KV_PGNO_NONE) return KV_PARSE_ERROR;
     }
-    return strdup(buffer);
+    return KV_OK;
 }
 
-kv_error_t kv_save_ex(const char *filename, const char *key, const char *value, size_t value_len) {
-    if (!filename || !key || !value) {
-        return KV_INVALID_INPUT;
+static kv_error_t overflow_free(kv_store_t *store, kv_pgno_t pgno) {
+    while (pgno != KV_PGNO_NONE) {
+        kv_error_t err;
+        const uint8_t *page = kv_pager_read(store->pager, pgno, &err);
+        if (!page) return err;
+        kv_pgno_t next = rd32(page + 8);
+        bool valid = page[0] == KV_PAGE_OVERFLOW;
+        kv_pager_unpin(store->pager, pgno);
+        if (!valid) return KV_PARSE_ERROR;
+        kv_pager_free(store->pager, pgno);
+        pgno = next;
     }
+    return KV_OK;
+}
 
-    kv_entry_t *entries = NULL;
-    size_t count;
-    kv_error_t error = read_all_entries(filename, &entries, &count);
-    if (error != KV_OK) {
-        return error;
+// ---------------- 树操作 ----------------
+
+static kv_error_t tree_descend(kv_store_t *store, const uint8_t *key, size_t key_len, kv_path_t *path,
+                               kv_pgno_t *leaf) {
+    kv_pgno_t pgno = store->root;
+    path->depth = 0;
+    for (;;) {
+        kv_error_t err;
+        const uint8_t *page = kv_pager_read(store->pager, pgno, &err);
+        if (!page) return err;
+        if (!page_valid(page) || (page[0] == KV_PAGE_BRANCH && path->depth >= KV_MAX_DEPTH)) {
+            kv_pager_unpin(store->pager, pgno);
+            return KV_PARSE_ERROR;
+        }
+        if (page[0] == KV_PAGE_LEAF) {
+            kv_pager_unpin(store->pager, pgno);
+            *leaf = pgno;
+            return KV_OK;
+        }
+        uint16_t idx = branch_search(page, key, key_len);
+        kv_pgno_t child = branch_child(page, idx);
+        kv_pager_unpin(store->pager, pgno);
+        path->pgno[path->depth] = pgno;
+        path->idx[path->depth] = idx;
+        path->depth++;
+        pgno = child;
     }
+}
 
-    // 检查是否已存在该键
-    bool key_exists = false;
-    for (size_t i = 0; i < count; i++) {
-        if (strcmp(entries[i].key, key) == 0) {
-            free(entries[i].value);
-            entries[i].value = (char *)malloc(value_len + 1);
-            if (!entries[i].value) {
-                kv_free_entries(entries, count);
-                return KV_MEMORY_ERROR;
-            }
-            strncpy(entries[i].value, value, value_len);
-            entries[i].value[value_len] = '\0';
-            key_exists = true;
-            break;
+// 子页已写为 new_child (可能分裂出 split->right) 后, 沿路径向上复制并更新父页
+// 父页无需变化时提前停止, 根保持不变
+static kv_error_t tree_propagate(kv_store_t *store, const kv_path_t *path, kv_pgno_t old_child,
+                                 kv_pgno_t new_child, kv_split_t *split) {
+    kv_split_t next_split;
+    kv_cell_t cells[(KV_PAGE_SIZE - KV_PAGE_HEADER) / 2 + 1];
+    uint8_t src[KV_PAGE_SIZE];
+    uint8_t cell[KV_CELL_HEADER + KV_MAX_KEY_SIZE];
+
+    for (int d = path->depth - 1; d >= 0; d--) {
+        if (!split->split && new_child == old_child) return KV_OK;
+
+        kv_pgno_t pgno = path->pgno[d];
+        uint16_t idx = path->idx[d];
+        kv_pgno_t new_pgno;
+        uint8_t *page;
+        kv_error_t err = kv_pager_write(store->pager, pgno, &new_pgno, &page);
+        if (err != KV_OK) return err;
+
+        uint8_t *child_ref = idx == 0 ? page + 8 : (uint8_t *)page_cell(page, idx - 1) + 4;
+        wr32(child_ref, new_child);
+
+        if (split->split) {
+            memcpy(src, page, KV_PAGE_SIZE);
+            size_t count = page_gather(src, cells);
+            memmove(cells + idx + 1, cells + idx, (count - idx) * sizeof(kv_cell_t));
+            wr16(cell, split->key_len);
+            wr16(cell + 2, 0);
+            wr32(cell + 4, split->right);
+            memcpy(cell + KV_CELL_HEADER, split->key, split->key_len);
+            cells[idx].data = cell;
+            cells[idx].len = KV_CELL_HEADER + split->key_len;
+            err = page_store(store, page, KV_PAGE_BRANCH, rd32(src + 8), cells, count + 1, &next_split);
+            if (err != KV_OK) return err;
+            *split = next_split;
         }
+        old_child = pgno;
+        new_child = new_pgno;
     }
 
-    // 如果键不存在，添加新条目
-    if (!key_exists) {
-        kv_entry_t *new_entries = (kv_entry_t *)realloc(entries, (count + 1) * sizeof(kv_entry_t));
-        if (!new_entries) {
-            kv_free_entries(entries, count);
-            return KV_MEMORY_ERROR;
+    if (split->split) {
+        kv_pgno_t root;
+        uint8_t *page;
+        kv_error_t err = kv_pager_alloc(store->pager, &root, &page);
+        if (err != KV_OK) return err;
+        wr16(cell, split->key_len);
+        wr16(cell + 2, 0);
+        wr32(cell + 4, split->right);
+        memcpy(cell + KV_CELL_HEADER, split->key, split->key_len);
+        kv_cell_t sep = { cell, KV_CELL_HEADER + split->key_len };
+        page_build(page, KV_PAGE_BRANCH, new_child, &sep, 1);
+        new_child = root;
+    }
+    store->root = new_child;
+    return KV_OK;
+}
+
+static kv_error_t tree_put(kv_store_t *store, const uint8_t *key, size_t key_len, const uint8_t *value,
+                           size_t value_len) {
+    uint8_t cell[KV_MAX_INLINE_CELL];
+    size_t cell_len = KV_CELL_HEADER + key_len;
+    wr16(cell, (uint16_t)key_len);
+    cell[2] = 0;
+    cell[3] = 0;
+    wr32(cell + 4, (uint32_t)value_len);
+    memcpy(cell + KV_CELL_HEADER, key, key_len);
+    if (cell_len + value_len <= KV_MAX_INLINE_CELL) {
+        memcpy(cell + cell_len, value, value_len);
+        cell_len += value_len;
+    } else {
+        kv_pgno_t first;
+        kv_error_t err = overflow_write(store, value, value_len, &first);
+        if (err != KV_OK) return err;
+        cell[2] = KV_CELL_OVERFLOW;
+        wr32(cell + cell_len, first);
+        cell_len += 4;
+    }
+
+    kv_cell_t new_cell = { cell, cell_len };
+    kv_split_t split = { 0 };
+    if (store->root == KV_PGNO_NONE) {
+        uint8_t *page;
+        kv_error_t err = kv_pager_alloc(store->pager, &store->root, &page);
+        if (err != KV_OK) return err;
+        page_build(page, KV_PAGE_LEAF, KV_PGNO_NONE, &new_cell, 1);
+        store->count++;
+        return KV_OK;
+    }
+
+    kv_path_t path;
+    kv_pgno_t leaf;
+    kv_error_t err = tree_descend(store, key, key_len, &path, &leaf);
+    if (err != KV_OK) return err;
+
+    kv_pgno_t new_leaf;
+    uint8_t *page;
+    err = kv_pager_write(store->pager, leaf, &new_leaf, &page);
+    if (err != KV_OK) return err;
+
+    uint8_t src[KV_PAGE_SIZE];
+    kv_cell_t cells[(KV_PAGE_SIZE - KV_PAGE_HEADER) / 2 + 1];
+    memcpy(src, page, KV_PAGE_SIZE);
+    size_t count = page_gather(src, cells);
+    bool found;
+    uint16_t pos = leaf_search(src, key, key_len, &found);
+    if (found) {
+        const uint8_t *old = cells[pos].data;
+        if (old[2] & KV_CELL_OVERFLOW) {
+            err = overflow_free(store, rd32(old + KV_CELL_HEADER + rd16(old)));
+            if (err != KV_OK) return err;
         }
-        entries = new_entries;
+        cells[pos] = new_cell;
+    } else {
+        memmove(cells + pos + 1, cells + pos, (count - pos) * sizeof(kv_cell_t));
+        cells[pos] = new_cell;
+        count++;
+        store->count++;
+    }
 
-        entries[count].key = strdup(key);
-        if (!entries[count].key) {
-            kv_free_entries(entries, count);
-            return KV_MEMORY_ERROR;
+    err = page_store(store, page, KV_PAGE_LEAF, KV_PGNO_NONE, cells, count, &split);
+    if (err != KV_OK) return err;
+    return tree_propagate(store, &path, leaf, new_leaf, &split);
+}
+
+static kv_error_t tree_delete(kv_store_t *store, const uint8_t *key, size_t key_len) {
+    if (store->root == KV_PGNO_NONE) return KV_KEY_NOT_FOUND;
+
+    kv_path_t path;
+    kv_pgno_t leaf;
+    kv_error_t err = tree_descend(store, key, key_len, &path, &leaf);
+    if (err != KV_OK) return err;
+
+    uint8_t src[KV_PAGE_SIZE];
+    kv_cell_t cells[(KV_PAGE_SIZE - KV_PAGE_HEADER) / 2 + 1];
+    const uint8_t *page = kv_pager_read(store->pager, leaf, &err);
+    if (!page) return err;
+    memcpy(src, page, KV_PAGE_SIZE);
+    kv_pager_unpin(store->pager, leaf);
+
+    bool found;
+    uint16_t pos = leaf_search(src, key, key_len, &found);
+    if (!found) return KV_KEY_NOT_FOUND;
+    const uint8_t *old = page_cell(src, pos);
+    if (old[2] & KV_CELL_OVERFLOW) {
+        err = overflow_free(store, rd32(old + KV_CELL_HEADER + rd16(old)));
+        if (err != KV_OK) return err;
+    }
+    store->count--;
+
+    kv_split_t split = { 0 };
+    size_t count = page_gather(src, cells);
+    if (count > 1) {
+        kv_pgno_t new_leaf;
+        uint8_t *dst;
+        err = kv_pager_write(store->pager, leaf, &new_leaf, &dst);
+        if (err != KV_OK) return err;
+        memmove(cells + pos, cells + pos + 1, (count - pos - 1) * sizeof(kv_cell_t));
+        page_build(dst, KV_PAGE_LEAF, KV_PGNO_NONE, cells, count - 1);
+        return tree_propagate(store, &path, leaf, new_leaf, &split);
+    }
+
+    // 叶子删空: 从父页摘除, 父页删空时继续向上 (不做合并)
+    kv_pager_free(store->pager, leaf);
+    int d = path.depth - 1;
+    for (; d >= 0; d--) {
+        kv_pgno_t pgno = path.pgno[d];
+        uint16_t idx = path.idx[d];
+        page = kv_pager_read(store->pager, pgno, &err);
+        if (!page) return err;
+        memcpy(src, page, KV_PAGE_SIZE);
+        kv_pager_unpin(store->pager, pgno);
+
+        count = page_gather(src, cells);
+        if (count == 0) {
+            kv_pager_free(store->pager, pgno);
+            continue;
         }
 
-        entries[count].value = (char *)malloc(value_len + 1);
-        if (!entries[count].value) {
-            free(entries[count].key);
-            kv_free_entries(entries, count);
-            return KV_MEMORY_ERROR;
+        kv_pgno_t link = rd32(src + 8);
+        size_t remove = idx == 0 ? 0 : idx - 1u;
+        if (idx == 0) link = rd32(cells[0].data + 4);
+        memmove(cells + remove, cells + remove + 1, (count - remove - 1) * sizeof(kv_cell_t));
+
+        kv_pgno_t new_pgno;
+        uint8_t *dst;
+        err = kv_pager_write(store->pager, pgno, &new_pgno, &dst);
+        if (err != KV_OK) return err;
+        page_build(dst, KV_PAGE_BRANCH, link, cells, count - 1);
+        path.depth = d;
+        err = tree_propagate(store, &path, pgno, new_pgno, &split);
+        if (err != KV_OK) return err;
+        break;
+    }
+    if (d < 0) {
+        store->root = KV_PGNO_NONE;
+        return KV_OK;
+    }
+
+    // 根只剩一个子页时降低树高
+    for (;;) {
+        kv_pgno_t root = store->root;
+        page = kv_pager_read(store->pager, root, &err);
+        if (!page) return err;
+        bool collapse = page[0] == KV_PAGE_BRANCH && page_cells(page) == 0;
+        kv_pgno_t child = rd32(page + 8);
+        kv_pager_unpin(store->pager, root);
+        if (!collapse) return KV_OK;
+        kv_pager_free(store->pager, root);
+        store->root = child;
+    }
+}
+
+// 查找叶子单元, 内联值直接拷贝, 溢出值读取溢出页链
+static kv_error_t tree_get(kv_store_t *store, const uint8_t *key, size_t key_len, uint8_t *buffer,
+                           size_t buffer_size, size_t *value_len) {
+    if (store->root == KV_PGNO_NONE) return KV_KEY_NOT_FOUND;
+
+    kv_path_t path;
+    kv_pgno_t leaf;
+    kv_error_t err = tree_descend(store, key, key_len, &path, &leaf);
+    if (err != KV_OK) return err;
+
+    const uint8_t *page = kv_pager_read(store->pager, leaf, &err);
+    if (!page) return err;
+    bool found;
+    uint16_t pos = leaf_search(page, key, key_len, &found);
+    if (!found) {
+        kv_pager_unpin(store->pager, leaf);
+        return KV_KEY_NOT_FOUND;
+    }
+
+    const uint8_t *cell = page_cell(page, pos);
+    size_t len = rd32(cell + 4);
+    bool overflow = (cell[2] & KV_CELL_OVERFLOW) != 0;
+    kv_pgno_t first = overflow ? rd32(cell + KV_CELL_HEADER + rd16(cell)) : KV_PGNO_NONE;
+    if (value_len) *value_len = len;
+    if (len > buffer_size) {
+        kv_pager_unpin(store->pager, leaf);
+        return KV_BUFFER_TOO_SMALL;
+    }
+    if (!overflow && buffer) memcpy(buffer, cell + KV_CELL_HEADER + rd16(cell), len);
+    kv_pager_unpin(store->pager, leaf);
+    return overflow && buffer ? overflow_read(store, first, buffer, len) : KV_OK;
+}
+
+typedef struct {
+    kv_store_t *store;
+    kv_foreach_fn callback;
+    void *user_data;
+    char *value;
+    size_t value_cap;
+    bool stopped;
+} kv_walk_t;
+
+// 深度优先遍历, 每层把页拷贝到栈上后再回调或下降, 不长期固定页
+static kv_error_t tree_walk(kv_walk_t *walk, kv_pgno_t pgno, int depth) {
+    if (depth > KV_MAX_DEPTH) return KV_PARSE_ERROR;
+
+    uint8_t page[KV_PAGE_SIZE];
+    kv_error_t err;
+    const uint8_t *src = kv_pager_read(walk->store->pager, pgno, &err);
+    if (!src) return err;
+    memcpy(page, src, KV_PAGE_SIZE);
+    kv_pager_unpin(walk->store->pager, pgno);
+    if (!page_valid(page)) return KV_PARSE_ERROR;
+
+    uint16_t count = page_cells(page);
+    if (page[0] == KV_PAGE_BRANCH) {
+        for (uint16_t i = 0; i <= count && !walk->stopped; i++) {
+            err = tree_walk(walk, branch_child(page, i), depth + 1);
+            if (err != KV_OK) return err;
         }
+        return KV_OK;
+    }
 
-        strncpy(entries[count].value, value, value_len);
-        entries[count].value[value_len] = '\0';
-        count++;
+    char key[KV_MAX_KEY_SIZE + 1];
+    for (uint16_t i = 0; i < count && !walk->stopped; i++) {
+        const uint8_t *cell = page_cell(page, i);
+        uint16_t key_len = rd16(cell);
+        size_t len = rd32(cell + 4);
+        if (key_len > KV_MAX_KEY_SIZE) return KV_PARSE_ERROR;
+        memcpy(key, cell + KV_CELL_HEADER, key_len);
+        key[key_len] = '\0';
+
+        if (len + 1 > walk->value_cap) {
+            char *value = realloc(walk->value, len + 1);
+            if (!value) return KV_MEMORY_ERROR;
+            walk->value = value;
+            walk->value_cap = len + 1;
+        }
+        if (cell[2] & KV_CELL_OVERFLOW) {
+            err = overflow_read(walk->store, rd32(cell + KV_CELL_HEADER + key_len), (uint8_t *)walk->value, len);
+            if (err != KV_OK) return err;
+        } else {
+            memcpy(walk->value, cell + KV_CELL_HEADER + key_len, len);
+        }
+        walk->value[len] = '\0';
+        if (!walk->callback(key, walk->value, len, walk->user_data)) walk->stopped = true;
     }
+    return KV_OK;
+}
 
-    error = write_entries(filename, entries, count);
-    kv_free_entries(entries, count);
-    return error;
+// ---------------- 存储句柄 ----------------
+
+static kv_error_t check_key(const kv_store_t *store, const char *key, size_t *key_len) {
+    if (!key) return KV_INVALID_INPUT;
+    *key_len = strlen(key);
+    if (*key_len == 0 || *key_len > KV_MAX_KEY_SIZE) return KV_INVALID_INPUT;
+    if (store->config.max_key_length && *key_len > store->config.max_key_length) return KV_INVALID_INPUT;
+    return KV_OK;
 }
 
-kv_error_t kv_load_ex(const char *filename, const char *key, char *buffer, size_t buffer_size, size_t *value_len) {
-    if (!filename || !key || !buffer || !value_len) {
+static kv_error_t store_put_one(kv_store_t *store, const char *key, const void *value, size_t value_len) {
+    size_t key_len;
+    kv_error_t err = check_key(store, key, &key_len);
+    if (err != KV_OK) return err;
+    if (!value && value_len) return KV_INVALID_INPUT;
+    if (value_len > UINT32_MAX) return KV_INVALID_INPUT;
+    if (store->config.max_value_length && value_len > store->config.max_value_length) return KV_INVALID_INPUT;
+    if (store->config.max_entries && store->count >= store->config.max_entries &&
+        tree_get(store, (const uint8_t *)key, key_len, NULL, 0, NULL) == KV_KEY_NOT_FOUND) {
         return KV_INVALID_INPUT;
     }
 
+    err = tree_put(store, (const uint8_t *)key, key_len, value, value_len);
+    kv_pager_unpin_all(store->pager);
+    return err;
+}
+
+static kv_error_t store_begin(kv_store_t *store) {
+    kv_error_t err = kv_pager_begin(store->pager);
+    if (err != KV_OK) return err;
+    const kv_pager_meta_t *meta = kv_pager_get_meta(store->pager);
+    store->root = meta->root;
+    store->count = meta->entry_count;
+    return KV_OK;
+}
+
+static kv_error_t store_finish(kv_store_t *store, kv_error_t err) {
+    if (err == KV_OK) err = kv_pager_commit(store->pager, store->root, store->count);
+    else kv_pager_abort(store->pager);
+
+    // 失败时回到已提交的状态
+    const kv_pager_meta_t *meta = kv_pager_get_meta(store->pager);
+    store->root = meta->root;
+    store->count = meta->entry_count;
+    return err;
+}
+
+// 把旧版 "key=value" 文本文件转换为页式文件: 先写入临时文件, 再原子替换
+static kv_error_t migrate_text_file(const char *filename, const kv_config_t *config) {
     kv_entry_t *entries = NULL;
-    size_t count;
-    kv_error_t error = read_all_entries(filename, &entries, &count);
-    if (error != KV_OK) {
-        return error;
+    size_t count = 0;
+    kv_error_t err = read_all_entries(filename, &entries, &count);
+    if (err != KV_OK) return err;
+
+    size_t path_len = strlen(filename);
+    char *tmp = malloc(path_len + sizeof(".migrate"));
+    if (!tmp) {
+        kv_free_entries(entries, count);
+        return KV_MEMORY_ERROR;
     }
+    memcpy(tmp, filename, path_len);
+    memcpy(tmp + path_len, ".migrate", sizeof(".migrate"));
+    unlink(tmp);
 
-    bool found = false;
-    for (size_t i = 0; i < count; i++) {
-        if (strcmp(entries[i].key, key) == 0) {
-            size_t len = strlen(entries[i].value);
-            if (len >= buffer_size) {
-                kv_free_entries(entries, count);
-                return KV_BUFFER_TOO_SMALL;
+    kv_config_t raw = *config;
+    raw.max_key_length = 0;
+    raw.max_value_length = 0;
+    raw.max_entries = 0;
+    kv_store_t *store = kv_store_open(tmp, &raw, &err);
+    if (store) {
+        err = store_begin(store);
+        if (err == KV_OK) {
+            // 无法表示的旧条目 (空键或超长键) 被跳过
+            for (size_t i = 0; err == KV_OK && i < count; i++) {
+                kv_error_t put = store_put_one(store, entries[i].key, entries[i].value, strlen(entries[i].value));
+                if (put != KV_OK && put != KV_INVALID_INPUT) err = put;
             }
-            strcpy(buffer, entries[i].value);
-            *value_len = len;
-            found = true;
-            break;
+            err = store_finish(store, err);
         }
+        kv_store_close(store);
     }
-
     kv_free_entries(entries, count);
-    return found ? KV_OK : KV_KEY_NOT_FOUND;
+
+    if (err == KV_OK && rename(tmp, filename) != 0) err = KV_FILE_ERROR;
+    if (err != KV_OK) unlink(tmp);
+    free(tmp);
+    return err;
 }
 
-kv_error_t kv_delete(const char *filename, const char *key) {
-    if (!filename || !key) {
-        return KV_INVALID_INPUT;
+static bool is_text_file(const char *filename) {
+    struct stat st;
+    return stat(filename, &st) == 0 && st.st_size > 0 && !kv_pager_is_page_file(filename);
+}
+
+kv_store_t* kv_store_open(const char *filename, const kv_config_t *config, kv_error_t *error) {
+    kv_error_t err = KV_OK;
+    if (!filename) {
+        if (error) *error = KV_INVALID_INPUT;
+        return NULL;
     }
 
-    kv_entry_t *entries = NULL;
-    size_t count;
-    kv_error_t error = read_all_entries(filename, &entries, &count);
-    if (error != KV_OK) {
-        return error;
+    kv_store_t *store = calloc(1, sizeof(kv_store_t));
+    if (!store) {
+        if (error) *error = KV_MEMORY_ERROR;
+        return NULL;
+    }
+    if (config) {
+        store->config = *config;
+    } else {
+        kv_get_default_config(&store->config);
     }
 
-    // 过滤掉要删除的键
-    kv_entry_t *new_entries = NULL;
-    size_t new_count = 0;
-    size_t capacity = count;
+    if (store->config.engine == KV_ENGINE_LSM || kv_lsm_is_store(filename)) {
+        kv_lsm_config_t lsm_config;
+        kv_lsm_default_config(&lsm_config);
+        if (store->config.memtable_size) lsm_config.memtable_size = store->config.memtable_size;
+        lsm_config.sync = store->config.sync_on_commit;
+        store->lsm = kv_lsm_open(filename, &lsm_config, &err);
+        if (!store->lsm) {
+            free(store);
+            store = NULL;
+        }
+        if (error) *error = err;
+        return store;
+    }
 
-    new_entries = (kv_entry_t *)malloc(capacity * sizeof(kv_entry_t));
-    if (!new_entries) {
-        kv_free_entries(entries, count);
-        return KV_MEMORY_ERROR;
+    if (is_text_file(filename)) {
+        err = migrate_text_file(filename, &store->config);
+        if (err != KV_OK) {
+            free(store);
+            if (error) *error = err;
+            return NULL;
+        }
     }
 
-    for (size_t i = 0; i < count; i++) {
-        if (strcmp(entries[i].key, key) != 0) {
-            if (new_count >= capacity) {
-                capacity *= 2;
-                kv_entry_t *tmp = (kv_entry_t *)realloc(new_entries, capacity * sizeof(kv_entry_t));
-                if (!tmp) {
-                    kv_free_entries(entries, count);
-                    kv_free_entries(new_entries, new_count);
-                    return KV_MEMORY_ERROR;
-                }
-                new_entries = tmp;
+    kv_pager_config_t pager_config;
+    kv_pager_default_config(&pager_config);
+    if (store->config.cache_pages) pager_config.cache_pages = store->config.cache_pages;
+    pager_config.use_mmap = store->config.use_mmap;
+    pager_config.sync = store->config.sync_on_commit;
+
+    store->pager = kv_pager_open(filename, &pager_config, &err);
+    if (!store->pager) {
+        free(store);
+        if (error) *error = err;
+        return NULL;
+    }
+    const kv_pager_meta_t *meta = kv_pager_get_meta(store->pager);
+    store->root = meta->root;
+    store->count = meta->entry_count;
+    if (error) *error = KV_OK;
+    return store;
+}
+
+void kv_store_close(kv_store_t *store) {
+    if (!store) return;
+    if (store->lsm) kv_lsm_close(store->lsm);
+    else kv_pager_close(store->pager);
+    free(store);
+}
+
+kv_error_t kv_store_put(kv_store_t *store, const char *key, const void *value, size_t value_len) {
+    if (!store) return KV_INVALID_INPUT;
+    if (store->lsm) {
+        size_t key_len;
+        kv_error_t err = check_key(store, key, &key_len);
+        if (err != KV_OK) return err;
+        if (!value && value_len) return KV_INVALID_INPUT;
+        if (store->config.max_value_length && value_len > store->config.max_value_length) return KV_INVALID_INPUT;
+        return kv_lsm_put(store->lsm, key, key_len, value, value_len);
+    }
+    kv_error_t err = store_begin(store);
+    if (err != KV_OK) return err;
+    return store_finish(store, store_put_one(store, key, value, value_len));
+}
+
+kv_error_t kv_store_get(kv_store_t *store, const char *key, void *buffer, size_t buffer_size, size_t *value_len) {
+    size_t key_len;
+    if (!store || (!buffer && buffer_size)) return KV_INVALID_INPUT;
+    kv_error_t err = check_key(store, key, &key_len);
+    if (err != KV_OK) return err == KV_INVALID_INPUT && key ? KV_KEY_NOT_FOUND : err;
+    if (store->lsm) return kv_lsm_get(store->lsm, key, key_len, buffer, buffer_size, value_len);
+    return tree_get(store, (const uint8_t *)key, key_len, buffer, buffer_size, value_len);
+}
+
+kv_error_t kv_store_delete(kv_store_t *store, const char *key) {
+    size_t key_len;
+    if (!store) return KV_INVALID_INPUT;
+    kv_error_t err = check_key(store, key, &key_len);
+    if (err != KV_OK) return err == KV_INVALID_INPUT && key ? KV_KEY_NOT_FOUND : err;
+    if (store->lsm) {
+        // 删除标记本身不检查键是否存在, 先查一次以保持返回值语义
+        size_t len;
+        err = kv_lsm_get(store->lsm, key, key_len, NULL, 0, &len);
+        if (err != KV_OK && err != KV_BUFFER_TOO_SMALL) return err;
+        return kv_lsm_delete(store->lsm, key, key_len);
+    }
+
+    err = store_begin(store);
+    if (err != KV_OK) return err;
+    err = tree_delete(store, (const uint8_t *)key, key_len);
+    kv_pager_unpin_all(store->pager);
+    return store_finish(store, err);
+}
+
+bool kv_store_exists(kv_store_t *store, const char *key) {
+    size_t len;
+    kv_error_t err = kv_store_get(store, key, NULL, 0, &len);
+    return err == KV_OK || err == KV_BUFFER_TOO_SMALL;
+}
+
+kv_error_t kv_store_put_batch(kv_store_t *store, const kv_entry_t *entries, size_t count) {
+    if (!store || (!entries && count)) return KV_INVALID_INPUT;
+    if (store->lsm) {
+        for (size_t i = 0; i < count; i++) {
+            size_t key_len;
+            kv_error_t err = check_key(store, entries[i].key, &key_len);
+            if (err != KV_OK) return err;
+            if (!entries[i].value) return KV_INVALID_INPUT;
+            if (store->config.max_value_length && strlen(entries[i].value) > store->config.max_value_length) {
+                return KV_INVALID_INPUT;
             }
-            new_entries[new_count].key = entries[i].key;
-            new_entries[new_count].value = entries[i].value;
-            new_count++;
+        }
+        return kv_lsm_put_batch(store->lsm, entries, count);
+    }
+    kv_error_t err = store_begin(store);
+    if (err != KV_OK) return err;
+    for (size_t i = 0; err == KV_OK && i < count; i++) {
+        if (!entries[i].value) {
+            err = KV_INVALID_INPUT;
+            break;
+        }
+        err = store_put_one(store, entries[i].key, entries[i].value, strlen(entries[i].value));
+    }
+    return store_finish(store, err);
+}
+
+kv_error_t kv_store_foreach(kv_store_t *store, kv_foreach_fn callback, void *user_data) {
+    if (!store || !callback) return KV_INVALID_INPUT;
+    if (store->lsm) return kv_lsm_foreach(store->lsm, callback, user_data);
+    if (store->root == KV_PGNO_NONE) return KV_OK;
+
+    kv_walk_t walk = { store, callback, user_data, NULL, 0, false };
+    kv_error_t err = tree_walk(&walk, store->root, 0);
+    free(walk.value);
+    return err;
+}
+
+static bool count_entry(const char *key, const char *value, size_t value_len, void *user_data) {
+    (void)key;
+    (void)value;
+    (void)value_len;
+    (*(size_t *)user_data)++;
+    return true;
+}
+
+size_t kv_store_count(const kv_store_t *store) {
+    if (!store) return 0;
+    if (store->lsm) {
+        size_t count = 0;
+        return kv_lsm_foreach(store->lsm, count_entry, &count) == KV_OK ? count : 0;
+    }
+    return (size_t)kv_pager_get_meta(store->pager)->entry_count;
+}
+
+kv_error_t kv_store_flush(kv_store_t *store) {
+    if (!store) return KV_INVALID_INPUT;
+    return store->lsm ? kv_lsm_flush(store->lsm) : KV_OK;
+}
+
+// ---------------- 按文件名操作的接口 ----------------
+
+// 只读操作在文件不存在时不创建文件
+static bool file_missing(const char *filename) {
+    struct stat st;
+    return stat(filename, &st) != 0;
+}
+
+bool kv_save(const char *filename, const char *key, const char *value) {
+    if (!value) return false;
+    kv_error_t error = kv_save_ex(filename, key, value, strlen(value));
+    return error == KV_OK;
+}
+
+char* kv_load(const char *filename, const char *key) {
+    if (!filename || !key || file_missing(filename)) {
+        return NULL;
+    }
+
+    kv_store_t *store = kv_store_open(filename, NULL, NULL);
+    if (!store) {
+        return NULL;
+    }
+
+    char *value = NULL;
+    size_t len = 0;
+    kv_error_t error = kv_store_get(store, key, NULL, 0, &len);
+    if (error == KV_OK || error == KV_BUFFER_TOO_SMALL) {
+        value = (char *)malloc(len + 1);
+        if (value && kv_store_get(store, key, value, len, &len) == KV_OK) {
+            value[len] = '\0';
         } else {
-            // 释放要删除的条目
-            free(entries[i].key);
-            free(entries[i].value);
+            free(value);
+            value = NULL;
         }
     }
+    kv_store_close(store);
+    return value;
+}
+
+kv_error_t kv_save_ex(const char *filename, const char *key, const char *value, size_t value_len) {
+    if (!filename || !key || !value) {
+        return KV_INVALID_INPUT;
+    }
+
+    kv_error_t error;
+    kv_store_t *store = kv_store_open(filename, NULL, &error);
+    if (!store) {
+        return error;
+    }
+    error = kv_store_put(store, key, value, value_len);
+    kv_store_close(store);
+    return error;
+}
+
+kv_error_t kv_load_ex(const char *filename, const char *key, char *buffer, size_t buffer_size, size_t *value_len) {
+    if (!filename || !key || !buffer || !value_len || buffer_size == 0) {
+        return KV_INVALID_INPUT;
+    }
+    if (file_missing(filename)) {
+        return KV_KEY_NOT_FOUND;
+    }
 
-    // 释放原始条目数组（已转移的条目不再释放）
-    free(entries);
+    kv_error_t error;
+    kv_store_t *store = kv_store_open(filename, NULL, &error);
+    if (!store) {
+        return error;
+    }
+    // 保留一个字节给结尾的 '\0'
+    error = kv_store_get(store, key, buffer, buffer_size - 1, value_len);
+    if (error == KV_OK) {
+        buffer[*value_len] = '\0';
+    }
+    kv_store_close(store);
+    return error;
+}
 
-    error = write_entries(filename, new_entries, new_count);
-    kv_free_entries(new_entries, new_count);
+kv_error_t kv_delete(const char *filename, const char *key) {
+    if (!filename || !key) {
+        return KV_INVALID_INPUT;
+    }
+    if (file_missing(filename)) {
+        return KV_KEY_NOT_FOUND;
+    }
+
+    kv_error_t error;
+    kv_store_t *store = kv_store_open(filename, NULL, &error);
+    if (!store) {
+        return error;
+    }
+    error = kv_store_delete(store, key);
+    kv_store_close(store);
     return error;
 }
 
 bool kv_exists(const char *filename, const char *key) {
-    char buffer[1];
-    size_t value_len;
-    kv_error_t error = kv_load_ex(filename, key, buffer, sizeof(buffer), &value_len);
-    return error == KV_OK;
+    if (!filename || !key || file_missing(filename)) {
+        return false;
+    }
+
+    kv_store_t *store = kv_store_open(filename, NULL, NULL);
+    if (!store) {
+        return false;
+    }
+    bool exists = kv_store_exists(store, key);
+    kv_store_close(store);
+    return exists;
+}
+
+typedef struct {
+    kv_entry_t *entries;
+    size_t count;
+    size_t capacity;
+    kv_error_t error;
+} kv_collect_t;
+
+static bool collect_entry(const char *key, const char *value, size_t value_len, void *user_data) {
+    kv_collect_t *collect = (kv_collect_t *)user_data;
+    if (collect->count == collect->capacity) {
+        size_t capacity = collect->capacity ? collect->capacity * 2 : 16;
+        kv_entry_t *entries = (kv_entry_t *)realloc(collect->entries, capacity * sizeof(kv_entry_t));
+        if (!entries) {
+            collect->error = KV_MEMORY_ERROR;
+            return false;
+        }
+        collect->entries = entries;
+        collect->capacity = capacity;
+    }
+
+    kv_entry_t *entry = &collect->entries[collect->count];
+    entry->key = strdup(key);
+    entry->value = (char *)malloc(value_len + 1);
+    if (!entry->key || !entry->value) {
+        free(entry->key);
+        free(entry->value);
+        collect->error = KV_MEMORY_ERROR;
+        return false;
+    }
+    memcpy(entry->value, value, value_len + 1);
+    collect->count++;
+    return true;
 }
 
 size_t kv_get_all(const char *filename, kv_entry_t **entries, kv_error_t *error) {
@@ -275,10 +1091,32 @@ size_t kv_get_all(const char *filename, kv_entry_t **entries, kv_error_t *error)
         return 0;
     }
 
-    size_t count;
-    kv_error_t err = read_all_entries(filename, entries, &count);
-    if (error) *error = err;
-    return count;
+    *entries = NULL;
+    if (file_missing(filename)) {
+        if (error) *error = KV_OK;
+        return 0;
+    }
+
+    kv_error_t err;
+    kv_store_t *store = kv_store_open(filename, NULL, &err);
+    if (!store) {
+        if (error) *error = err;
+        return 0;
+    }
+
+    kv_collect_t collect = { NULL, 0, 0, KV_OK };
+    err = kv_store_foreach(store, collect_entry, &collect);
+    kv_store_close(store);
+    if (err == KV_OK) err = collect.error;
+    if (err != KV_OK) {
+        kv_free_entries(collect.entries, collect.count);
+        if (error) *error = err;
+        return 0;
+    }
+
+    *entries = collect.entries;
+    if (error) *error = KV_OK;
+    return collect.count;
 }
 
 kv_error_t kv_save_batch(const char *filename, const kv_entry_t *entries, size_t count) {
@@ -286,14 +1124,14 @@ kv_error_t kv_save_batch(const char *filename, const kv_entry_t *entries, size_t
         return KV_INVALID_INPUT;
     }
 
-    for (size_t i = 0; i < count; i++) {
-        kv_error_t error = kv_save_ex(filename, entries[i].key, entries[i].value, strlen(entries[i].value));
-        if (error != KV_OK) {
-            return error;
-        }
+    kv_error_t error;
+    kv_store_t *store = kv_store_open(filename, NULL, &error);
+    if (!store) {
+        return error;
     }
-
-    return KV_OK;
+    error = kv_store_put_batch(store, entries, count);
+    kv_store_close(store);
+    return error;
 }
 
 kv_error_t kv_clear(const char *filename) {
@@ -301,40 +1139,59 @@ kv_error_t kv_clear(const char *filename) {
         return KV_INVALID_INPUT;
     }
 
-    FILE *fp = fopen(filename, "w");
-    if (!fp) {
-        return KV_FILE_ERROR;
+    kv_error_t error;
+    if (kv_lsm_is_store(filename)) {
+        kv_store_t *store = kv_store_open(filename, NULL, &error);
+        if (!store) {
+            return error;
+        }
+        error = kv_lsm_clear(store->lsm);
+        kv_store_close(store);
+        return error;
     }
 
-    fclose(fp);
-    return KV_OK;
+    // 在临时文件中创建空存储, 再原子替换
+    size_t path_len = strlen(filename);
+    char *tmp = (char *)malloc(path_len + sizeof(".tmp"));
+    if (!tmp) {
+        return KV_MEMORY_ERROR;
+    }
+    memcpy(tmp, filename, path_len);
+    memcpy(tmp + path_len, ".tmp", sizeof(".tmp"));
+    unlink(tmp);
+
+    kv_store_t *store = kv_store_open(tmp, NULL, &error);
+    if (store) {
+        kv_store_close(store);
+        if (rename(tmp, filename) != 0) {
+            error = KV_FILE_ERROR;
+        }
+    }
+    if (error != KV_OK) {
+        unlink(tmp);
+    }
+    free(tmp);
+    return error;
 }
 
 kv_error_t kv_get_stats(const char *filename, size_t *entry_count, size_t *file_size) {
     if (!filename || !entry_count || !file_size) {
         return KV_INVALID_INPUT;
     }
-
-    kv_entry_t *entries = NULL;
-    size_t count;
-    kv_error_t error = read_all_entries(filename, &entries, &count);
-    if (error != KV_OK) {
-        return error;
-    }
-
-    *entry_count = count;
-
-    // 获取文件大小
-    FILE *fp = fopen(filename, "r");
-    if (fp) {
-        fseek(fp, 0, SEEK_END);
-        *file_size = ftell(fp);
-        fclose(fp);
-    } else {
+    if (file_missing(filename)) {
+        *entry_count = 0;
         *file_size = 0;
+        return KV_OK;
     }
 
-    kv_free_entries(entries, count);
+    kv_error_t error;
+    kv_store_t *store = kv_store_open(filename, NULL, &error);
+    if (!store) {
+        return error;
+    }
+    *entry_count = kv_store_count(store);
+    *file_size = store->lsm ? kv_lsm_disk_size(store->lsm) : kv_pager_file_size(store->pager);
+    kv_store_close(store);
     return KV_OK;
 }
 
@@ -343,13 +1200,12 @@ kv_error_t kv_init_with_config(const char *filename, const kv_config_t *config)
         return KV_INVALID_INPUT;
     }
 
-    // 简单实现：创建空文件
-    FILE *fp = fopen(filename, "a");
-    if (!fp) {
-        return KV_FILE_ERROR;
+    kv_error_t error;
+    kv_store_t *store = kv_store_open(filename, config, &error);
+    if (!store) {
+        return error;
     }
-
-    fclose(fp);
+    kv_store_close(store);
     return KV_OK;
 }
 
@@ -360,7 +1216,12 @@ void kv_get_default_config(kv_config_t *config) {
         config->enable_backup = false;
         config->max_key_length = 256;
         config->max_value_length = 4096;
-        config->max_entries = 1000;
+        config->max_entries = 0;
+        config->cache_pages = 256;
+        config->use_mmap = true;
+        config->sync_on_commit = true;
+        config->engine = KV_ENGINE_BTREE;
+        config->memtable_size = 0;
     }
 }
 
@@ -3,6 +3,14 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+
+// 存储格式: 页式文件上的 B+ 树 (见 kv_pager.h)
+// - 点查询只访问根到叶子路径上的 O(log n) 个页, 读路径走 mmap
+// - 每次写操作 (或一个批量写) 是一个写时复制事务, 提交时原子切换根, 崩溃后保留最后一次完整提交
+// - 键按字节序排序, 超过约 1KB 的值保存在溢出页链中
+// - 打开旧版 "key=value" 文本文件时自动迁移为页式格式
+// 写密集场景可选 LSM 引擎 (见 kv_lsm.h): 存储为一个目录, 写入只追加日志, 由后台压缩整理
 
 // KV 存储错误码
 typedef enum {
@@ -17,6 +25,12 @@ typedef enum {
     KV_BUFFER_TOO_SMALL = -8
 } kv_error_t;
 
+// 存储引擎
+typedef enum {
+    KV_ENGINE_BTREE = 0,  // 页式 B+ 树, 读优化
+    KV_ENGINE_LSM = 1     // 日志结构合并树, 写优化
+} kv_engine_t;
+
 // KV 存储配置
 typedef struct {
     bool enable_compression;
@@ -24,7 +38,12 @@ typedef struct {
     bool enable_backup;
     size_t max_key_length;
     size_t max_value_length;
-    size_t max_entries;
+    size_t max_entries;        // 0 表示不限制
+    size_t cache_pages;        // 页缓存帧数
+    bool use_mmap;             // 读路径使用 mmap
+    bool sync_on_commit;       // 提交时 fdatasync
+    kv_engine_t engine;        // 新建存储使用的引擎, 打开已有的 LSM 目录时自动识别
+    size_t memtable_size;      // LSM 内存表大小, 0 使用默认值
 } kv_config_t;
 
 // KV 存储条目
@@ -33,6 +52,49 @@ typedef struct {
     char *value;
 } kv_entry_t;
 
+typedef struct kv_store_s kv_store_t;
+
+// 遍历回调, value 以 '\0' 结尾, 返回 false 停止遍历
+typedef bool (*kv_foreach_fn)(const char *key, const char *value, size_t value_len, void *user_data);
+
+// 打开存储, 文件不存在时创建
+// config: 配置, NULL 使用默认配置; max_key_length / max_value_length 为 0 时只受格式上限约束
+// LSM 引擎不检查 max_entries
+// 返回: 成功返回句柄, 失败返回 NULL 并设置 error
+kv_store_t* kv_store_open(const char *filename, const kv_config_t *config, kv_error_t *error);
+
+// 关闭存储
+void kv_store_close(kv_store_t *store);
+
+// 写入键值对, 键已存在时替换
+kv_error_t kv_store_put(kv_store_t *store, const char *key, const void *value, size_t value_len);
+
+// 读取值
+// buffer: 输出缓冲区, buffer_size 为 0 时可为 NULL (只查询长度)
+// value_len: 输出值长度, 缓冲区不足时同样设置
+// 返回: 缓冲区不足返回 KV_BUFFER_TOO_SMALL
+kv_error_t kv_store_get(kv_store_t *store, const char *key, void *buffer, size_t buffer_size, size_t *value_len);
+
+// 删除键值对
+kv_error_t kv_store_delete(kv_store_t *store, const char *key);
+
+// 检查键是否存在
+bool kv_store_exists(kv_store_t *store, const char *key);
+
+// 批量写入, 在同一个事务中提交
+kv_error_t kv_store_put_batch(kv_store_t *store, const kv_entry_t *entries, size_t count);
+
+// 按键的字节序遍历, 回调中不能修改存储
+kv_error_t kv_store_foreach(kv_store_t *store, kv_foreach_fn callback, void *user_data);
+
+// 获取键值对数量 (LSM 引擎需要遍历)
+size_t kv_store_count(const kv_store_t *store);
+
+// 把缓存的写入落盘; B+ 树引擎每次写入已提交, LSM 引擎写出内存表并等待后台压缩完成
+kv_error_t kv_store_flush(kv_store_t *store);
+
+// 以下按文件名操作的接口每次调用打开并关闭一次存储
+
 // 设置值并保存到文件
 bool kv_save(const char *filename, const char *key, const char *value);
 
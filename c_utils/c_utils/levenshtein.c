@@ -4,7 +4,19 @@
 #include <stdbool.h>
 #include <ctype.h>
 
-#define MIN3(a, b, c) ((a) < (b) ? ((a) < (c) ? (a) : (c)) : ((b) < (c) ? (b) : (c)))
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define LEV_HAVE_AVX2 1
+#endif
+
+// 单次调用时位掩码表和块状态放在栈上的上限 (64 字 = 4096 个模式字符)
+#define LEV_STACK_WORDS 64
+
+struct levenshtein_matcher {
+    size_t m;          // 模式长度
+    size_t words;      // ceil(m / 64)
+    uint64_t *peq;     // peq[c * words + w]: 模式中等于字符 c 的位置
+};
 
 static bool char_equal(char c1, char c2, bool case_sensitive) {
     if (case_sensitive) {
@@ -14,128 +26,405 @@ static bool char_equal(char c1, char c2, bool case_sensitive) {
     }
 }
 
-static size_t levenshtein_naive(const char *s1, size_t s1_len, const char *s2, size_t s2_len, 
-                               const levenshtein_config_t *config) {
-    size_t **d = (size_t **)malloc((s1_len + 1) * sizeof(size_t *));
-    if (!d) {
+// 禁用部分操作时的两行动态规划 (插入/删除不对称, 不交换两串)
+static size_t levenshtein_dp(const char *s1, size_t s1_len, const char *s2, size_t s2_len, 
+                             const levenshtein_config_t *config) {
+    size_t *prev_row = (size_t *)malloc((s2_len + 1) * sizeof(size_t));
+    size_t *curr_row = (size_t *)malloc((s2_len + 1) * sizeof(size_t));
+    if (!prev_row || !curr_row) {
+        free(prev_row);
+        free(curr_row);
         return (size_t)-1;
     }
 
-    for (size_t i = 0; i <= s1_len; i++) {
-        d[i] = (size_t *)malloc((s2_len + 1) * sizeof(size_t));
-        if (!d[i]) {
-            for (size_t j = 0; j < i; j++) {
-                free(d[j]);
-            }
-            free(d);
-            return (size_t)-1;
-        }
-        d[i][0] = i;
-    }
-
     for (size_t j = 0; j <= s2_len; j++) {
-        d[0][j] = j;
+        prev_row[j] = config->include_insertion || j == 0 ? j : (size_t)-1;
     }
 
     for (size_t i = 1; i <= s1_len; i++) {
+        curr_row[0] = config->include_deletion ? i : (size_t)-1;
+        size_t row_min = curr_row[0];
         for (size_t j = 1; j <= s2_len; j++) {
             size_t cost = char_equal(s1[i - 1], s2[j - 1], config->case_sensitive) ? 0 : 1;
-            size_t deletion = config->include_deletion ? d[i - 1][j] + 1 : (size_t)-1;
-            size_t insertion = config->include_insertion ? d[i][j - 1] + 1 : (size_t)-1;
-            size_t substitution = config->include_substitution ? d[i - 1][j - 1] + cost : (size_t)-1;
-
             size_t min_val = (size_t)-1;
-            if (deletion != (size_t)-1 && (min_val == (size_t)-1 || deletion < min_val)) {
-                min_val = deletion;
+            if (config->include_deletion && prev_row[j] != (size_t)-1 && prev_row[j] + 1 < min_val) {
+                min_val = prev_row[j] + 1;
             }
-            if (insertion != (size_t)-1 && (min_val == (size_t)-1 || insertion < min_val)) {
-                min_val = insertion;
+            if (config->include_insertion && curr_row[j - 1] != (size_t)-1 && curr_row[j - 1] + 1 < min_val) {
+                min_val = curr_row[j - 1] + 1;
             }
-            if (substitution != (size_t)-1 && (min_val == (size_t)-1 || substitution < min_val)) {
-                min_val = substitution;
+            // 字符相同时沿对角线不算编辑, 不受替换开关影响
+            if ((cost == 0 || config->include_substitution) && prev_row[j - 1] != (size_t)-1 &&
+                prev_row[j - 1] + cost < min_val) {
+                min_val = prev_row[j - 1] + cost;
             }
+            curr_row[j] = min_val;
+            if (min_val < row_min) row_min = min_val;
+        }
 
-            d[i][j] = min_val;
-
-            // 早停优化
-            if (config->max_distance > 0 && d[i][j] > config->max_distance) {
-                for (size_t x = 0; x <= s1_len; x++) {
-                    free(d[x]);
-                }
-                free(d);
-                return config->max_distance + 1;
-            }
+        // 终点的路径必经过每一行, 整行最小值超过阈值即可结束
+        if (config->max_distance > 0 && row_min > config->max_distance) {
+            free(prev_row);
+            free(curr_row);
+            return config->max_distance + 1;
         }
+
+        size_t *temp = prev_row;
+        prev_row = curr_row;
+        curr_row = temp;
     }
 
-    size_t result = d[s1_len][s2_len];
+    size_t result = prev_row[s2_len];
 
-    for (size_t i = 0; i <= s1_len; i++) {
-        free(d[i]);
-    }
-    free(d);
+    free(prev_row);
+    free(curr_row);
 
     return result;
 }
 
-static size_t levenshtein_optimized(const char *s1, size_t s1_len, const char *s2, size_t s2_len, 
-                                   const levenshtein_config_t *config) {
-    if (s1_len < s2_len) {
-        return levenshtein_optimized(s2, s2_len, s1, s1_len, config);
+/* ---------- Myers 位并行 ---------- */
+
+// 忽略大小写时, tolower 相同的字符共用同一个掩码
+static void lev_build_peq(uint64_t *peq, size_t words, const uint8_t *p, size_t m, bool case_sensitive) {
+    memset(peq, 0, 256 * words * sizeof(uint64_t));
+    for (size_t i = 0; i < m; i++) peq[(size_t)p[i] * words + i / 64] |= 1ULL << (i % 64);
+    if (case_sensitive) return;
+    for (int c = 0; c < 256; c++) {
+        int l = tolower(c);
+        if (l == c) continue;
+        for (size_t w = 0; w < words; w++) peq[(size_t)l * words + w] |= peq[(size_t)c * words + w];
     }
-
-    size_t *prev_row = (size_t *)malloc((s2_len + 1) * sizeof(size_t));
-    size_t *curr_row = (size_t *)malloc((s2_len + 1) * sizeof(size_t));
-    if (!prev_row || !curr_row) {
-        free(prev_row);
-        free(curr_row);
-        return (size_t)-1;
+    for (int c = 0; c < 256; c++) {
+        int l = tolower(c);
+        if (l != c) memcpy(peq + (size_t)c * words, peq + (size_t)l * words, words * sizeof(uint64_t));
     }
+}
 
-    for (size_t j = 0; j <= s2_len; j++) {
-        prev_row[j] = j;
+static inline uint64_t lev_low_mask(size_t bits) {
+    return bits >= 64 ? ~0ULL : (1ULL << bits) - 1;
+}
+
+// 长度差本身就是距离的下界
+static bool lev_length_exceeds(size_t m, size_t n, size_t k) {
+    return k > 0 && (m > n ? m - n : n - m) > k;
+}
+
+// 模式不超过 64 个字符: 一个字保存一整列的竖向差分 (vp: +1, vn: -1)
+// score 为第 m 行的值; 有阈值时检查终点对角线在当前列上的值, 它沿对角线单调不减
+static size_t lev_myers_64(const uint64_t *peq, size_t m, const uint8_t *t, size_t n, size_t k) {
+    uint64_t vp = lev_low_mask(m), vn = 0;
+    uint64_t top = 1ULL << (m - 1);
+    size_t score = m;
+    for (size_t j = 0; j < n; j++) {
+        uint64_t eq = peq[t[j]];
+        uint64_t xv = eq | vn;
+        uint64_t xh = (((eq & vp) + vp) ^ vp) | eq;
+        uint64_t hp = vn | ~(xh | vp);
+        uint64_t hn = vp & xh;
+        if (hp & top) {
+            score++;
+        } else if (hn & top) {
+            score--;
+        }
+        // 第 0 行 D[0][j] = j, 横向差分恒为 +1
+        hp = (hp << 1) | 1;
+        hn <<= 1;
+        vp = hn | ~(xv | hp);
+        vn = hp & xv;
+        if (k > 0 && m + j + 1 >= n) {
+            uint64_t mask = lev_low_mask(m + j + 1 - n);
+            size_t diag = j + 1 + (size_t)__builtin_popcountll(vp & mask) - (size_t)__builtin_popcountll(vn & mask);
+            if (diag > k) return k + 1;
+        }
     }
+    return k > 0 && score > k ? k + 1 : score;
+}
 
-    for (size_t i = 1; i <= s1_len; i++) {
-        curr_row[0] = i;
-        for (size_t j = 1; j <= s2_len; j++) {
-            size_t cost = char_equal(s1[i - 1], s2[j - 1], config->case_sensitive) ? 0 : 1;
-            size_t deletion = config->include_deletion ? prev_row[j] + 1 : (size_t)-1;
-            size_t insertion = config->include_insertion ? curr_row[j - 1] + 1 : (size_t)-1;
-            size_t substitution = config->include_substitution ? prev_row[j - 1] + cost : (size_t)-1;
+// 多字版本的一个块: hin 为从上一块传入的横向差分, high 为本块最后一个有效行的位
+static inline int lev_advance_block(uint64_t *pv, uint64_t *mv, uint64_t eq, int hin, uint64_t high) {
+    uint64_t xv = eq | *mv;
+    if (hin < 0) eq |= 1;
+    uint64_t xh = (((eq & *pv) + *pv) ^ *pv) | eq;
+    uint64_t ph = *mv | ~(xh | *pv);
+    uint64_t mh = *pv & xh;
+    int hout = 0;
+    if (ph & high) {
+        hout = 1;
+    } else if (mh & high) {
+        hout = -1;
+    }
+    ph <<= 1;
+    mh <<= 1;
+    if (hin < 0) {
+        mh |= 1;
+    } else if (hin > 0) {
+        ph |= 1;
+    }
+    *pv = mh | ~(xv | ph);
+    *mv = ph & xv;
+    return hout;
+}
 
-            size_t min_val = (size_t)-1;
-            if (deletion != (size_t)-1 && (min_val == (size_t)-1 || deletion < min_val)) {
-                min_val = deletion;
+// 模式超过 64 个字符: 每个块维护底行的值 bscore, 对角线下界由所在块的底值加块内差分得到
+// state 至少 3 * words 个字
+static size_t lev_myers_blocks(const uint64_t *peq, size_t words, size_t m, const uint8_t *t, size_t n,
+                               size_t k, uint64_t *state) {
+    uint64_t *pv = state, *mv = state + words, *bscore = state + 2 * words;
+    for (size_t b = 0; b < words; b++) {
+        pv[b] = ~0ULL;
+        mv[b] = 0;
+        bscore[b] = 64 * (b + 1) < m ? 64 * (b + 1) : m;
+    }
+    uint64_t last_high = 1ULL << ((m - 1) % 64);
+    for (size_t j = 0; j < n; j++) {
+        const uint64_t *eq = peq + (size_t)t[j] * words;
+        int h = 1;
+        for (size_t b = 0; b + 1 < words; b++) {
+            h = lev_advance_block(&pv[b], &mv[b], eq[b], h, 1ULL << 63);
+            bscore[b] += (uint64_t)(int64_t)h;
+        }
+        h = lev_advance_block(&pv[words - 1], &mv[words - 1], eq[words - 1], h, last_high);
+        bscore[words - 1] += (uint64_t)(int64_t)h;
+
+        if (k > 0 && m + j + 1 >= n) {
+            size_t r = m + j + 1 - n;
+            size_t diag;
+            if (r == 0) {
+                diag = j + 1;
+            } else {
+                size_t b = (r - 1) / 64;
+                uint64_t mask = lev_low_mask(r - 64 * b);
+                size_t base = b == 0 ? j + 1 : (size_t)bscore[b - 1];
+                diag = base + (size_t)__builtin_popcountll(pv[b] & mask) - (size_t)__builtin_popcountll(mv[b] & mask);
             }
-            if (insertion != (size_t)-1 && (min_val == (size_t)-1 || insertion < min_val)) {
-                min_val = insertion;
+            if (diag > k) return k + 1;
+        }
+    }
+    size_t score = (size_t)bscore[words - 1];
+    return k > 0 && score > k ? k + 1 : score;
+}
+
+// 用已构建的位掩码表计算模式与 t 的距离; 内存不足返回 (size_t)-1
+static size_t lev_myers(const uint64_t *peq, size_t words, size_t m, const uint8_t *t, size_t n, size_t k) {
+    if (lev_length_exceeds(m, n, k)) return k + 1;
+    if (m == 0) return n;
+    if (n == 0) return m;
+    // m > 0 时至少一个字; 提前排除 words == 0, 多字路径里 words - 1 才不会越界
+    if (words == 0) return (size_t)-1;
+    if (words == 1) return lev_myers_64(peq, m, t, n, k);
+
+    uint64_t stack_state[3 * LEV_STACK_WORDS] = { 0 };
+    uint64_t *state = words <= LEV_STACK_WORDS ? stack_state : malloc(3 * words * sizeof(uint64_t));
+    if (!state) return (size_t)-1;
+    size_t d = lev_myers_blocks(peq, words, m, t, n, k, state);
+    if (state != stack_state) free(state);
+    return d;
+}
+
+// 单次计算: 较短的串作模式
+static size_t lev_distance(const char *s1, size_t s1_len, const char *s2, size_t s2_len,
+                           bool case_sensitive, size_t k) {
+    if (s1_len > s2_len) {
+        const char *ts = s1;
+        s1 = s2;
+        s2 = ts;
+        size_t tl = s1_len;
+        s1_len = s2_len;
+        s2_len = tl;
+    }
+    size_t m = s1_len, words = (m + 63) / 64;
+    if (m == 0 || lev_length_exceeds(m, s2_len, k)) return lev_myers(NULL, 0, m, NULL, s2_len, k);
+    const uint8_t *p = (const uint8_t *)s1;
+
+    if (words == 1) {
+        // 短串占大多数, 每次清零 256 项的开销比计算本身还大: 用线程内常驻的表, 用完只清模式中的字符
+        static _Thread_local uint64_t peq64[256];
+        for (size_t i = 0; i < m; i++) {
+            uint64_t bit = 1ULL << i;
+            if (case_sensitive) {
+                peq64[p[i]] |= bit;
+            } else {
+                int l = tolower(p[i]);
+                peq64[l] |= bit;
+                peq64[(uint8_t)toupper(l)] |= bit;
             }
-            if (substitution != (size_t)-1 && (min_val == (size_t)-1 || substitution < min_val)) {
-                min_val = substitution;
+        }
+        size_t d = lev_myers_64(peq64, m, (const uint8_t *)s2, s2_len, k);
+        for (size_t i = 0; i < m; i++) {
+            if (case_sensitive) {
+                peq64[p[i]] = 0;
+            } else {
+                int l = tolower(p[i]);
+                peq64[l] = 0;
+                peq64[(uint8_t)toupper(l)] = 0;
             }
+        }
+        return d;
+    }
 
-            curr_row[j] = min_val;
+    uint64_t stack_peq[256 * 4];
+    uint64_t *peq = words <= 4 ? stack_peq : malloc(256 * words * sizeof(uint64_t));
+    if (!peq) return (size_t)-1;
+    lev_build_peq(peq, words, p, m, case_sensitive);
+    size_t d = lev_myers(peq, words, m, (const uint8_t *)s2, s2_len, k);
+    if (peq != stack_peq) free(peq);
+    return d;
+}
 
-            // 早停优化
-            if (config->max_distance > 0 && curr_row[j] > config->max_distance) {
-                free(prev_row);
-                free(curr_row);
-                return config->max_distance + 1;
+#ifdef LEV_HAVE_AVX2
+// 4 个文本各占一个 64 位通道, 共用模式的位掩码表
+__attribute__((target("avx2")))
+static void lev_myers_64x4(const uint64_t *peq, size_t m, const uint8_t *const t[4], const size_t n[4],
+                           size_t k, size_t out[4]) {
+    size_t len[4], maxn = 0;
+    for (int l = 0; l < 4; l++) {
+        len[l] = n[l];
+        if (len[l] > maxn) maxn = len[l];
+    }
+    const __m256i one = _mm256_set1_epi64x(1);
+    const __m256i ones = _mm256_set1_epi64x(-1);
+    const __m128i shift = _mm_cvtsi32_si128((int)(m - 1));
+    __m256i vp = _mm256_set1_epi64x((long long)lev_low_mask(m));
+    __m256i vn = _mm256_setzero_si256();
+    __m256i score = _mm256_set1_epi64x((long long)m);
+    __m256i lens = _mm256_set_epi64x((long long)len[3], (long long)len[2], (long long)len[1], (long long)len[0]);
+    bool exceeded[4] = { false, false, false, false };
+
+    for (size_t j = 0; j < maxn; j++) {
+        uint64_t e[4];
+        for (int l = 0; l < 4; l++) e[l] = j < len[l] ? peq[t[l][j]] : 0;
+        __m256i eq = _mm256_set_epi64x((long long)e[3], (long long)e[2], (long long)e[1], (long long)e[0]);
+        __m256i active = _mm256_cmpgt_epi64(lens, _mm256_set1_epi64x((long long)j));
+
+        __m256i xv = _mm256_or_si256(eq, vn);
+        __m256i ep = _mm256_and_si256(eq, vp);
+        __m256i xh = _mm256_or_si256(_mm256_xor_si256(_mm256_add_epi64(ep, vp), vp), eq);
+        __m256i hp = _mm256_or_si256(vn, _mm256_andnot_si256(_mm256_or_si256(xh, vp), ones));
+        __m256i hn = _mm256_and_si256(vp, xh);
+        __m256i delta = _mm256_sub_epi64(_mm256_and_si256(_mm256_srl_epi64(hp, shift), one),
+                                         _mm256_and_si256(_mm256_srl_epi64(hn, shift), one));
+        score = _mm256_add_epi64(score, _mm256_and_si256(delta, active));
+        hp = _mm256_or_si256(_mm256_slli_epi64(hp, 1), one);
+        hn = _mm256_slli_epi64(hn, 1);
+        // 已结束通道的 score 不再累加, vp/vn 继续更新也不影响结果
+        vp = _mm256_or_si256(hn, _mm256_andnot_si256(_mm256_or_si256(xv, hp), ones));
+        vn = _mm256_and_si256(hp, xv);
+
+        // 有阈值时每 16 列检查一次: 剩余列每列最多减 1, 下界超过阈值的通道直接结束
+        if (k > 0 && (j & 15) == 15) {
+            uint64_t sc[4];
+            _mm256_storeu_si256((__m256i *)sc, score);
+            bool any = false;
+            for (int l = 0; l < 4; l++) {
+                if (j + 1 < len[l] && sc[l] > k + (len[l] - j - 1)) {
+                    exceeded[l] = true;
+                    len[l] = j + 1;
+                }
+                if (j + 1 < len[l]) any = true;
             }
+            if (!any) break;
+            lens = _mm256_set_epi64x((long long)len[3], (long long)len[2], (long long)len[1], (long long)len[0]);
         }
+    }
+    uint64_t sc[4];
+    _mm256_storeu_si256((__m256i *)sc, score);
+    for (int l = 0; l < 4; l++) {
+        out[l] = exceeded[l] || (k > 0 && sc[l] > k) ? k + 1 : (size_t)sc[l];
+    }
+}
 
-        size_t *temp = prev_row;
-        prev_row = curr_row;
-        curr_row = temp;
+static bool lev_cpu_has_avx2(void) {
+    static int cached = -1;
+    if (cached < 0) cached = __builtin_cpu_supports("avx2");
+    return cached;
+}
+#endif
+
+levenshtein_matcher_t* levenshtein_matcher_create(const char *pattern, size_t len, bool case_sensitive) {
+    if (!pattern && len > 0) return NULL;
+    levenshtein_matcher_t *matcher = calloc(1, sizeof(levenshtein_matcher_t));
+    if (!matcher) return NULL;
+    matcher->m = len;
+    matcher->words = len > 0 ? (len + 63) / 64 : 1;
+    matcher->peq = malloc(256 * matcher->words * sizeof(uint64_t));
+    if (!matcher->peq) {
+        free(matcher);
+        return NULL;
     }
+    lev_build_peq(matcher->peq, matcher->words, (const uint8_t *)pattern, len, case_sensitive);
+    return matcher;
+}
 
-    size_t result = prev_row[s2_len];
+void levenshtein_matcher_free(levenshtein_matcher_t *matcher) {
+    if (!matcher) return;
+    free(matcher->peq);
+    free(matcher);
+}
 
-    free(prev_row);
-    free(curr_row);
+size_t levenshtein_matcher_distance(const levenshtein_matcher_t *matcher, const char *text, size_t len,
+                                    size_t max_distance) {
+    if (!matcher || (!text && len > 0)) return (size_t)-1;
+    return lev_myers(matcher->peq, matcher->words, matcher->m, (const uint8_t *)text, len, max_distance);
+}
 
-    return result;
+size_t levenshtein_matcher_batch(const levenshtein_matcher_t *matcher, const char **texts, const size_t *lens,
+                                 size_t count, size_t max_distance, size_t *distances) {
+    if (!matcher || !texts || !distances) return 0;
+    size_t calculated = 0;
+#ifdef LEV_HAVE_AVX2
+    if (matcher->m > 0 && matcher->m <= 64 && lev_cpu_has_avx2()) {
+        const uint8_t *group_t[4];
+        size_t group_n[4], group_idx[4], group_out[4];
+        int filled = 0;
+        for (size_t i = 0; i <= count; i++) {
+            if (i < count) {
+                if (!texts[i]) {
+                    distances[i] = (size_t)-1;
+                    continue;
+                }
+                size_t n = lens ? lens[i] : strlen(texts[i]);
+                calculated++;
+                // 长度差已超过阈值的不进入向量组
+                if (lev_length_exceeds(matcher->m, n, max_distance)) {
+                    distances[i] = max_distance + 1;
+                    continue;
+                }
+                group_t[filled] = (const uint8_t *)texts[i];
+                group_n[filled] = n;
+                group_idx[filled] = i;
+                filled++;
+                if (filled < 4) continue;
+            }
+            if (filled == 0) continue;
+            // 不足 4 个时用空文本补齐
+            for (int l = filled; l < 4; l++) {
+                group_t[l] = (const uint8_t *)"";
+                group_n[l] = 0;
+            }
+            lev_myers_64x4(matcher->peq, matcher->m, group_t, group_n, max_distance, group_out);
+            for (int l = 0; l < filled; l++) distances[group_idx[l]] = group_out[l];
+            filled = 0;
+        }
+        return calculated;
+    }
+#endif
+    for (size_t i = 0; i < count; i++) {
+        if (!texts[i]) {
+            distances[i] = (size_t)-1;
+            continue;
+        }
+        size_t n = lens ? lens[i] : strlen(texts[i]);
+        distances[i] = lev_myers(matcher->peq, matcher->words, matcher->m, (const uint8_t *)texts[i], n,
+                                 max_distance);
+        if (distances[i] != (size_t)-1) calculated++;
+    }
+    return calculated;
+}
+
+size_t levenshtein_distance_bounded(const char *s1, size_t s1_len, const char *s2, size_t s2_len,
+                                    size_t max_distance) {
+    if ((!s1 && s1_len > 0) || (!s2 && s2_len > 0)) return (size_t)-1;
+    return lev_distance(s1, s1_len, s2, s2_len, true, max_distance);
 }
 
 size_t levenshtein_distance(const char *s1, const char *s2) {
@@ -144,7 +433,7 @@ size_t levenshtein_distance(const char *s1, const char *s2) {
     }
     size_t s1_len = strlen(s1);
     size_t s2_len = strlen(s2);
-    size_t distance;
+    size_t distance = (size_t)-1;
     levenshtein_config_t config;
     levenshtein_get_default_config(&config);
     levenshtein_distance_ex(s1, s1_len, s2, s2_len, &distance, &config);
@@ -158,10 +447,10 @@ levenshtein_error_t levenshtein_distance_ex(const char *s1, size_t s1_len, const
     }
 
     size_t result;
-    if (config->use_optimized) {
-        result = levenshtein_optimized(s1, s1_len, s2, s2_len, config);
+    if (config->include_substitution && config->include_insertion && config->include_deletion) {
+        result = lev_distance(s1, s1_len, s2, s2_len, config->case_sensitive, config->max_distance);
     } else {
-        result = levenshtein_naive(s1, s1_len, s2, s2_len, config);
+        result = levenshtein_dp(s1, s1_len, s2, s2_len, config);
     }
 
     if (result == (size_t)-1) {
@@ -212,7 +501,7 @@ size_t levenshtein_distance_optimized(const char *s1, const char *s2) {
     }
     size_t s1_len = strlen(s1);
     size_t s2_len = strlen(s2);
-    size_t distance;
+    size_t distance = (size_t)-1;
     levenshtein_config_t config;
     levenshtein_get_default_config(&config);
     config.use_optimized = true;
@@ -226,27 +515,15 @@ size_t levenshtein_distance_batch(const char *target, const char **strings, size
         return 0;
     }
 
-    size_t target_len = strlen(target);
-    levenshtein_config_t config;
-    levenshtein_get_default_config(&config);
-
-    size_t calculated = 0;
-    for (size_t i = 0; i < count; i++) {
-        if (strings[i]) {
-            size_t str_len = strlen(strings[i]);
-            levenshtein_error_t error = levenshtein_distance_ex(target, target_len, 
-                                                              strings[i], str_len, 
-                                                              &distances[i], &config);
-            if (error == LEVENSHTEIN_OK) {
-                calculated++;
-            } else {
-                distances[i] = (size_t)-1;
-            }
-        } else {
+    levenshtein_matcher_t *matcher = levenshtein_matcher_create(target, strlen(target), true);
+    if (!matcher) {
+        for (size_t i = 0; i < count; i++) {
             distances[i] = (size_t)-1;
         }
+        return 0;
     }
-
+    size_t calculated = levenshtein_matcher_batch(matcher, strings, NULL, count, 0, distances);
+    levenshtein_matcher_free(matcher);
     return calculated;
 }
 
@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 // Levenshtein 错误码
 typedef enum {
@@ -15,14 +16,20 @@ typedef enum {
 // Levenshtein 配置
 typedef struct {
     bool case_sensitive;
-    bool use_optimized;
+    bool use_optimized;           // 保留字段: 标准编辑距离总是走位并行实现
     bool include_substitution;
     bool include_insertion;
     bool include_deletion;
-    size_t max_distance;
+    size_t max_distance;          // 非 0 时距离超过它即提前结束, 结果为 max_distance + 1
 } levenshtein_config_t;
 
+// 一对多匹配器: 模式的位掩码表只构建一次, 可在多个线程中共享 (只读)
+typedef struct levenshtein_matcher levenshtein_matcher_t;
+
 // 计算 Levenshtein 编辑距离
+// 三种操作都启用时用 Myers 位并行算法: 较短的串作模式, 每 64 个字符一个 64 位字,
+// 时间 O(n * ceil(m / 64)), 额外内存为 256 * ceil(m / 64) 个 64 位字;
+// 禁用部分操作时退回两行动态规划
 size_t levenshtein_distance(const char *s1, const char *s2);
 
 // 带错误处理的编辑距离计算
@@ -39,10 +46,29 @@ double levenshtein_similarity_ex(const char *s1, size_t s1_len, const char *s2,
 // 优化版本的编辑距离计算（使用线性空间）
 size_t levenshtein_distance_optimized(const char *s1, const char *s2);
 
-// 批量计算编辑距离
+// 批量计算编辑距离 (基于匹配器, target 只预处理一次)
 size_t levenshtein_distance_batch(const char *target, const char **strings, size_t count, 
                                  size_t *distances);
 
+// 带阈值的编辑距离: max_distance 非 0 时, 一旦最终距离的下界 (终点所在对角线上的当前值) 超过它就结束
+// 返回: 距离, 超过阈值返回 max_distance + 1, 内存不足返回 (size_t)-1
+size_t levenshtein_distance_bounded(const char *s1, size_t s1_len, const char *s2, size_t s2_len,
+                                    size_t max_distance);
+
+// 创建匹配器; 返回: 内存不足返回 NULL
+levenshtein_matcher_t* levenshtein_matcher_create(const char *pattern, size_t len, bool case_sensitive);
+void levenshtein_matcher_free(levenshtein_matcher_t *matcher);
+
+// 模式与一个文本的编辑距离, max_distance 含义同 levenshtein_distance_bounded
+size_t levenshtein_matcher_distance(const levenshtein_matcher_t *matcher, const char *text, size_t len,
+                                    size_t max_distance);
+
+// 模式与多个文本的编辑距离; lens 为 NULL 时按 strlen 计算, texts[i] 为 NULL 时结果为 (size_t)-1
+// 模式不超过 64 个字符且 CPU 支持 AVX2 时, 每 4 个文本在一组 256 位向量的 4 个通道中同时计算
+// 返回: 成功计算的个数
+size_t levenshtein_matcher_batch(const levenshtein_matcher_t *matcher, const char **texts, const size_t *lens,
+                                 size_t count, size_t max_distance, size_t *distances);
+
 // 获取默认配置
 void levenshtein_get_default_config(levenshtein_config_t *config);
 
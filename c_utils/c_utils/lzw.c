@@ -2,49 +2,75 @@
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 
 #define LZW_MAX_CODE 4096
 #define LZW_MIN_CODE_SIZE 9
 #define LZW_MAX_CODE_SIZE 12
+#define LZW_CODE_LIMIT 16
+
+#define LZW_CLEAR_CODE 256
+#define LZW_END_CODE 257
+#define LZW_FIRST_CODE 258
 
 typedef struct {
     unsigned short prefix;
     unsigned char suffix;
+    unsigned char first;
+    unsigned int length;
 } lzw_entry_t;
 
 typedef struct {
     lzw_entry_t *entries;
-    size_t size;
     size_t capacity;
     size_t next_code;
-    size_t code_size;
+    size_t min_code_size;
     size_t max_code_size;
 } lzw_dict_t;
 
+// 编码端 (prefix, suffix) -> code 的开放寻址哈希表, 槽位为 0 表示空
+typedef struct {
+    uint32_t *keys;
+    unsigned short *codes;
+    size_t mask;
+    unsigned int shift;
+} lzw_hash_t;
+
+// 以 64 位累加器按 MSB 优先顺序读写码字, 每次整 32 位与缓冲区交换
 typedef struct {
     unsigned char *buffer;
-    size_t bit_pos;
-    size_t byte_pos;
     size_t size;
+    size_t byte_pos;
+    uint64_t acc;
+    unsigned int bits;
 } lzw_bitstream_t;
 
-static lzw_dict_t *lzw_dict_create(size_t capacity, size_t initial_code_size) {
+static lzw_dict_t *lzw_dict_create(const lzw_config_t *config) {
     lzw_dict_t *dict = (lzw_dict_t *)malloc(sizeof(lzw_dict_t));
     if (!dict) {
         return NULL;
     }
 
-    dict->entries = (lzw_entry_t *)calloc(capacity, sizeof(lzw_entry_t));
+    dict->min_code_size = config->initial_code_size;
+    dict->max_code_size = config->max_code_size;
+    dict->capacity = (size_t)1 << config->max_code_size;
+    if (config->max_dictionary_size < dict->capacity) {
+        dict->capacity = config->max_dictionary_size;
+    }
+
+    dict->entries = (lzw_entry_t *)malloc(dict->capacity * sizeof(lzw_entry_t));
     if (!dict->entries) {
         free(dict);
         return NULL;
     }
 
-    dict->size = 256;
-    dict->capacity = capacity;
-    dict->next_code = 256;
-    dict->code_size = initial_code_size;
-    dict->max_code_size = LZW_MAX_CODE_SIZE;
+    for (unsigned int i = 0; i < 256; i++) {
+        dict->entries[i].prefix = 0;
+        dict->entries[i].suffix = (unsigned char)i;
+        dict->entries[i].first = (unsigned char)i;
+        dict->entries[i].length = 1;
+    }
+    dict->next_code = LZW_FIRST_CODE;
 
     return dict;
 }
@@ -57,11 +83,7 @@ static void lzw_dict_free(lzw_dict_t *dict) {
 }
 
 static void lzw_dict_reset(lzw_dict_t *dict) {
-    if (dict) {
-        dict->size = 256;
-        dict->next_code = 256;
-        dict->code_size = LZW_MIN_CODE_SIZE;
-    }
+    dict->next_code = LZW_FIRST_CODE;
 }
 
 static bool lzw_dict_add(lzw_dict_t *dict, unsigned short prefix, unsigned char suffix) {
@@ -69,66 +91,153 @@ static bool lzw_dict_add(lzw_dict_t *dict, unsigned short prefix, unsigned char
         return false;
     }
 
-    dict->entries[dict->next_code].prefix = prefix;
-    dict->entries[dict->next_code].suffix = suffix;
+    lzw_entry_t *entry = &dict->entries[dict->next_code];
+    entry->prefix = prefix;
+    entry->suffix = suffix;
+    entry->first = dict->entries[prefix].first;
+    entry->length = dict->entries[prefix].length + 1;
     dict->next_code++;
-    dict->size++;
 
-    if (dict->next_code >= (1 << dict->code_size) && dict->code_size < dict->max_code_size) {
-        dict->code_size++;
+    return true;
+}
+
+// 码宽由"对端在读这个码字时所知道的下一个码"决定: 能表示 [0, limit) 的最小位数
+static size_t lzw_code_width(const lzw_dict_t *dict, size_t limit) {
+    size_t width = dict->min_code_size;
+
+    if (limit > dict->capacity) {
+        limit = dict->capacity;
+    }
+    while (width < dict->max_code_size && ((size_t)1 << width) < limit) {
+        width++;
+    }
+    return width;
+}
+
+static bool lzw_hash_init(lzw_hash_t *hash, size_t capacity) {
+    size_t size = 1;
+    unsigned int log2 = 0;
+
+    while (size < capacity * 2) {
+        size <<= 1;
+        log2++;
+    }
+
+    hash->keys = (uint32_t *)calloc(size, sizeof(uint32_t));
+    hash->codes = (unsigned short *)malloc(size * sizeof(unsigned short));
+    if (!hash->keys || !hash->codes) {
+        free(hash->keys);
+        free(hash->codes);
+        return false;
     }
 
+    hash->mask = size - 1;
+    hash->shift = 32 - log2;
     return true;
 }
 
-static lzw_entry_t *lzw_dict_get(lzw_dict_t *dict, unsigned short code) {
-    if (code >= dict->next_code) {
-        return NULL;
+static void lzw_hash_free(lzw_hash_t *hash) {
+    free(hash->keys);
+    free(hash->codes);
+}
+
+static void lzw_hash_clear(lzw_hash_t *hash) {
+    memset(hash->keys, 0, (hash->mask + 1) * sizeof(uint32_t));
+}
+
+static inline size_t lzw_hash_slot(const lzw_hash_t *hash, uint32_t key) {
+    return (size_t)((key * 2654435761u) >> hash->shift) & hash->mask;
+}
+
+// 查找 (prefix, suffix); 未命中时返回 -1, 并通过 slot 给出可插入的位置
+static inline int lzw_hash_find(const lzw_hash_t *hash, unsigned short prefix,
+                                unsigned char suffix, size_t *slot) {
+    uint32_t key = (((uint32_t)prefix << 8) | suffix) + 1;
+    size_t i = lzw_hash_slot(hash, key);
+
+    while (hash->keys[i] != 0) {
+        if (hash->keys[i] == key) {
+            return hash->codes[i];
+        }
+        i = (i + 1) & hash->mask;
     }
-    return &dict->entries[code];
+
+    *slot = i;
+    return -1;
+}
+
+static inline void lzw_hash_insert(lzw_hash_t *hash, size_t slot, unsigned short prefix,
+                                   unsigned char suffix, unsigned short code) {
+    hash->keys[slot] = (((uint32_t)prefix << 8) | suffix) + 1;
+    hash->codes[slot] = code;
 }
 
 static void lzw_bitstream_init(lzw_bitstream_t *stream, unsigned char *buffer, size_t size) {
     stream->buffer = buffer;
-    stream->bit_pos = 0;
-    stream->byte_pos = 0;
     stream->size = size;
+    stream->byte_pos = 0;
+    stream->acc = 0;
+    stream->bits = 0;
 }
 
-static bool lzw_bitstream_write(lzw_bitstream_t *stream, unsigned int code, size_t bits) {
-    for (size_t i = 0; i < bits; i++) {
-        if (stream->byte_pos >= stream->size) {
-            return false;
-        }
-
-        unsigned int bit = (code >> (bits - i - 1)) & 1;
-        stream->buffer[stream->byte_pos] |= (bit << (7 - stream->bit_pos));
-        stream->bit_pos++;
+static inline bool lzw_bitstream_write(lzw_bitstream_t *stream, unsigned int code, size_t bits) {
+    stream->acc = (stream->acc << bits) | code;
+    stream->bits += (unsigned int)bits;
 
-        if (stream->bit_pos == 8) {
-            stream->bit_pos = 0;
-            stream->byte_pos++;
+    if (stream->bits >= 32) {
+        if (stream->byte_pos + 4 > stream->size) {
+            return false;
         }
+        uint32_t word = (uint32_t)(stream->acc >> (stream->bits - 32));
+        unsigned char *p = stream->buffer + stream->byte_pos;
+        p[0] = (unsigned char)(word >> 24);
+        p[1] = (unsigned char)(word >> 16);
+        p[2] = (unsigned char)(word >> 8);
+        p[3] = (unsigned char)word;
+        stream->byte_pos += 4;
+        stream->bits -= 32;
     }
     return true;
 }
 
-static bool lzw_bitstream_read(lzw_bitstream_t *stream, unsigned int *code, size_t bits) {
-    *code = 0;
-    for (size_t i = 0; i < bits; i++) {
+static bool lzw_bitstream_flush(lzw_bitstream_t *stream) {
+    while (stream->bits > 0) {
         if (stream->byte_pos >= stream->size) {
             return false;
         }
+        if (stream->bits >= 8) {
+            stream->buffer[stream->byte_pos++] = (unsigned char)(stream->acc >> (stream->bits - 8));
+            stream->bits -= 8;
+        } else {
+            stream->buffer[stream->byte_pos++] = (unsigned char)(stream->acc << (8 - stream->bits));
+            stream->bits = 0;
+        }
+    }
+    return true;
+}
 
-        unsigned int bit = (stream->buffer[stream->byte_pos] >> (7 - stream->bit_pos)) & 1;
-        *code |= (bit << (bits - i - 1));
-        stream->bit_pos++;
-
-        if (stream->bit_pos == 8) {
-            stream->bit_pos = 0;
-            stream->byte_pos++;
+static inline bool lzw_bitstream_read(lzw_bitstream_t *stream, unsigned int *code, size_t bits) {
+    if (stream->bits < bits) {
+        if (stream->bits <= 32 && stream->byte_pos + 4 <= stream->size) {
+            const unsigned char *p = stream->buffer + stream->byte_pos;
+            uint32_t word = ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+                            ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+            stream->acc = (stream->acc << 32) | word;
+            stream->bits += 32;
+            stream->byte_pos += 4;
+        } else {
+            while (stream->bits < bits && stream->byte_pos < stream->size) {
+                stream->acc = (stream->acc << 8) | stream->buffer[stream->byte_pos++];
+                stream->bits += 8;
+            }
+            if (stream->bits < bits) {
+                return false;
+            }
         }
     }
+
+    stream->bits -= (unsigned int)bits;
+    *code = (unsigned int)(stream->acc >> stream->bits) & ((1u << bits) - 1);
     return true;
 }
 
@@ -136,70 +245,84 @@ static size_t lzw_calculate_max_output_size(size_t input_len) {
     return input_len + input_len / 10 + 100;
 }
 
+static bool lzw_config_valid(const lzw_config_t *config) {
+    return config->initial_code_size >= LZW_MIN_CODE_SIZE &&
+           config->initial_code_size <= config->max_code_size &&
+           config->max_code_size <= LZW_CODE_LIMIT &&
+           config->max_dictionary_size > LZW_FIRST_CODE;
+}
+
 static lzw_error_t lzw_internal_encode(const unsigned char *input, size_t input_len, unsigned char *output, 
                                       size_t output_size, size_t *output_len, const lzw_config_t *config) {
-    lzw_dict_t *dict = lzw_dict_create(config->max_dictionary_size, config->initial_code_size);
+    lzw_dict_t *dict = lzw_dict_create(config);
     if (!dict) {
         return LZW_MEMORY_ERROR;
     }
 
+    lzw_hash_t hash;
+    if (!lzw_hash_init(&hash, dict->capacity)) {
+        lzw_dict_free(dict);
+        return LZW_MEMORY_ERROR;
+    }
+
+    lzw_error_t result = LZW_OK;
     lzw_bitstream_t stream;
     lzw_bitstream_init(&stream, output, output_size);
 
-    if (!lzw_bitstream_write(&stream, 256, config->initial_code_size)) {
-        lzw_dict_free(dict);
-        return LZW_BUFFER_TOO_SMALL;
+    if (!lzw_bitstream_write(&stream, LZW_CLEAR_CODE, lzw_code_width(dict, dict->next_code))) {
+        result = LZW_BUFFER_TOO_SMALL;
+        goto done;
     }
 
     unsigned short current_code = input[0];
     for (size_t i = 1; i < input_len; i++) {
         unsigned char next_char = input[i];
-        bool found = false;
+        size_t slot;
+        int found = lzw_hash_find(&hash, current_code, next_char, &slot);
 
-        for (size_t j = 256; j < dict->next_code; j++) {
-            if (dict->entries[j].prefix == current_code && dict->entries[j].suffix == next_char) {
-                current_code = (unsigned short)j;
-                found = true;
-                break;
-            }
+        if (found >= 0) {
+            current_code = (unsigned short)found;
+            continue;
         }
 
-        if (!found) {
-            if (!lzw_bitstream_write(&stream, current_code, dict->code_size)) {
-                lzw_dict_free(dict);
-                return LZW_BUFFER_TOO_SMALL;
-            }
+        if (!lzw_bitstream_write(&stream, current_code, lzw_code_width(dict, dict->next_code))) {
+            result = LZW_BUFFER_TOO_SMALL;
+            goto done;
+        }
 
-            if (!lzw_dict_add(dict, current_code, next_char)) {
-                lzw_dict_reset(dict);
+        if (dict->next_code < dict->capacity) {
+            lzw_hash_insert(&hash, slot, current_code, next_char, (unsigned short)dict->next_code);
+            lzw_dict_add(dict, current_code, next_char);
+        } else if (config->enable_reset) {
+            if (!lzw_bitstream_write(&stream, LZW_CLEAR_CODE, lzw_code_width(dict, dict->next_code))) {
+                result = LZW_BUFFER_TOO_SMALL;
+                goto done;
             }
-
-            current_code = next_char;
+            lzw_dict_reset(dict);
+            lzw_hash_clear(&hash);
         }
-    }
-
-    if (!lzw_bitstream_write(&stream, current_code, dict->code_size)) {
-        lzw_dict_free(dict);
-        return LZW_BUFFER_TOO_SMALL;
-    }
 
-    if (!lzw_bitstream_write(&stream, 257, dict->code_size)) {
-        lzw_dict_free(dict);
-        return LZW_BUFFER_TOO_SMALL;
+        current_code = next_char;
     }
 
-    if (stream.bit_pos > 0) {
-        stream.byte_pos++;
+    if (!lzw_bitstream_write(&stream, current_code, lzw_code_width(dict, dict->next_code)) ||
+        !lzw_bitstream_write(&stream, LZW_END_CODE, lzw_code_width(dict, dict->next_code + 1)) ||
+        !lzw_bitstream_flush(&stream)) {
+        result = LZW_BUFFER_TOO_SMALL;
+        goto done;
     }
 
     *output_len = stream.byte_pos;
+
+done:
+    lzw_hash_free(&hash);
     lzw_dict_free(dict);
-    return LZW_OK;
+    return result;
 }
 
 static lzw_error_t lzw_internal_decode(const unsigned char *input, size_t input_len, unsigned char *output, 
                                       size_t output_size, size_t *output_len, const lzw_config_t *config) {
-    lzw_dict_t *dict = lzw_dict_create(config->max_dictionary_size, config->initial_code_size);
+    lzw_dict_t *dict = lzw_dict_create(config);
     if (!dict) {
         return LZW_MEMORY_ERROR;
     }
@@ -208,73 +331,86 @@ static lzw_error_t lzw_internal_decode(const unsigned char *input, size_t input_
     lzw_bitstream_init(&stream, (unsigned char *)input, input_len);
 
     unsigned int code;
-    if (!lzw_bitstream_read(&stream, &code, config->initial_code_size)) {
+    if (!lzw_bitstream_read(&stream, &code, lzw_code_width(dict, dict->next_code))) {
         lzw_dict_free(dict);
         return LZW_DECODE_ERROR;
     }
 
-    if (code != 256) {
+    if (code != LZW_CLEAR_CODE) {
         lzw_dict_free(dict);
         return LZW_INVALID_CODE;
     }
 
+    lzw_error_t result = LZW_OK;
     size_t out_pos = 0;
-    if (!lzw_bitstream_read(&stream, &code, config->initial_code_size)) {
-        lzw_dict_free(dict);
-        return LZW_DECODE_ERROR;
-    }
-
-    output[out_pos++] = (unsigned char)code;
-    unsigned short prev_code = (unsigned short)code;
-
-    while (out_pos < output_size) {
-        if (!lzw_bitstream_read(&stream, &code, dict->code_size)) {
+    bool has_prev = false;
+    unsigned short prev_code = 0;
+
+    for (;;) {
+        // 编码端在写出每个码字后立即建表, 解码端要读完下一个码字才能补上, 因此差一个
+        size_t limit = dict->next_code + (has_prev ? 1 : 0);
+        if (!lzw_bitstream_read(&stream, &code, lzw_code_width(dict, limit))) {
+            result = LZW_DECODE_ERROR;
             break;
         }
 
-        if (code == 257) {
+        if (code == LZW_END_CODE) {
             break;
         }
 
-        if (code < 256) {
-            output[out_pos++] = (unsigned char)code;
-            lzw_dict_add(dict, prev_code, (unsigned char)code);
-            prev_code = (unsigned short)code;
-        } else if (code < dict->next_code) {
-            lzw_entry_t *entry = &dict->entries[code];
-            unsigned char stack[256];
-            size_t stack_pos = 0;
-
-            unsigned short curr_code = code;
-            while (curr_code >= 256) {
-                stack[stack_pos++] = dict->entries[curr_code].suffix;
-                curr_code = dict->entries[curr_code].prefix;
-            }
-            stack[stack_pos++] = (unsigned char)curr_code;
-
-            for (size_t i = stack_pos - 1; i < stack_pos; i--) {
-                if (out_pos >= output_size) {
-                    lzw_dict_free(dict);
-                    return LZW_BUFFER_TOO_SMALL;
-                }
-                output[out_pos++] = stack[i];
-            }
+        if (code == LZW_CLEAR_CODE) {
+            lzw_dict_reset(dict);
+            has_prev = false;
+            continue;
+        }
 
-            lzw_dict_add(dict, prev_code, stack[stack_pos - 1]);
-            prev_code = (unsigned short)code;
+        unsigned int length;
+        unsigned char first;
+        unsigned int walk;
+
+        if (code < 256 || (code >= LZW_FIRST_CODE && code < dict->next_code)) {
+            length = dict->entries[code].length;
+            first = dict->entries[code].first;
+            walk = code;
+        } else if (code == dict->next_code && has_prev) {
+            // KwKwK: 码字恰好是即将建立的表项, 其内容为 prev + prev 的首字符
+            length = dict->entries[prev_code].length + 1;
+            first = dict->entries[prev_code].first;
+            walk = prev_code;
         } else {
-            lzw_dict_free(dict);
-            return LZW_INVALID_CODE;
+            result = LZW_INVALID_CODE;
+            break;
         }
 
-        if (dict->next_code >= (1 << dict->code_size) && dict->code_size < dict->max_code_size) {
-            dict->code_size++;
+        if (length > output_size - out_pos) {
+            result = LZW_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        // 沿前缀链从尾到头直接写入输出缓冲区
+        size_t pos = out_pos + dict->entries[walk].length;
+        if (walk != code) {
+            output[pos] = first;
+        }
+        while (walk >= 256) {
+            output[--pos] = dict->entries[walk].suffix;
+            walk = dict->entries[walk].prefix;
+        }
+        output[--pos] = (unsigned char)walk;
+        out_pos += length;
+
+        if (has_prev) {
+            lzw_dict_add(dict, prev_code, first);
         }
+        prev_code = (unsigned short)code;
+        has_prev = true;
     }
 
-    *output_len = out_pos;
+    if (result == LZW_OK) {
+        *output_len = out_pos;
+    }
     lzw_dict_free(dict);
-    return LZW_OK;
+    return result;
 }
 
 size_t lzw_encode(const unsigned char *in, size_t in_len, unsigned char *out) {
@@ -296,6 +432,10 @@ lzw_error_t lzw_encode_ex(const unsigned char *input, size_t input_len, unsigned
         return LZW_OK;
     }
 
+    if (!lzw_config_valid(config)) {
+        return LZW_BIT_WIDTH_ERROR;
+    }
+
     if (output_size < lzw_calculate_max_output_size(input_len)) {
         return LZW_BUFFER_TOO_SMALL;
     }
@@ -321,6 +461,10 @@ lzw_error_t lzw_decode_ex(const unsigned char *input, size_t input_len, unsigned
         return LZW_OK;
     }
 
+    if (!lzw_config_valid(config)) {
+        return LZW_BIT_WIDTH_ERROR;
+    }
+
     return lzw_internal_decode(input, input_len, output, output_size, output_len, config);
 }
 
@@ -2,6 +2,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define MATRIX_HAVE_AVX2 1
+#endif
 
 matrix_t* matrix_create(size_t rows, size_t cols) {
     if (rows == 0 || cols == 0) return NULL;
@@ -47,6 +53,28 @@ matrix_t* matrix_copy(const matrix_t *m) {
     return copy;
 }
 
+bool matrix_add_into(matrix_t *dst, const matrix_t *a, const matrix_t *b) {
+    if (!dst || !a || !b) return false;
+    if (a->rows != b->rows || a->cols != b->cols) return false;
+    if (dst->rows != a->rows || dst->cols != a->cols) return false;
+
+    for (size_t i = 0; i < a->rows * a->cols; i++) {
+        dst->data[i] = a->data[i] + b->data[i];
+    }
+    return true;
+}
+
+bool matrix_sub_into(matrix_t *dst, const matrix_t *a, const matrix_t *b) {
+    if (!dst || !a || !b) return false;
+    if (a->rows != b->rows || a->cols != b->cols) return false;
+    if (dst->rows != a->rows || dst->cols != a->cols) return false;
+
+    for (size_t i = 0; i < a->rows * a->cols; i++) {
+        dst->data[i] = a->data[i] - b->data[i];
+    }
+    return true;
+}
+
 matrix_t* matrix_add(const matrix_t *a, const matrix_t *b) {
     if (!a || !b) return NULL;
     if (a->rows != b->rows || a->cols != b->cols) return NULL;
@@ -54,10 +82,7 @@ matrix_t* matrix_add(const matrix_t *a, const matrix_t *b) {
     matrix_t *res = matrix_create(a->rows, a->cols);
     if (!res) return NULL;
     
-    for (size_t i = 0; i < a->rows * a->cols; i++) {
-        res->data[i] = a->data[i] + b->data[i];
-    }
-    
+    matrix_add_into(res, a, b);
     return res;
 }
 
@@ -68,10 +93,7 @@ matrix_t* matrix_sub(const matrix_t *a, const matrix_t *b) {
     matrix_t *res = matrix_create(a->rows, a->cols);
     if (!res) return NULL;
     
-    for (size_t i = 0; i < a->rows * a->cols; i++) {
-        res->data[i] = a->data[i] - b->data[i];
-    }
-    
+    matrix_sub_into(res, a, b);
     return res;
 }
 
@@ -82,17 +104,36 @@ matrix_t* matrix_mul(const matrix_t *a, const matrix_t *b) {
     matrix_t *res = matrix_create(a->rows, b->cols);
     if (!res) return NULL;
     
-    for (size_t i = 0; i < a->rows; i++) {
-        for (size_t j = 0; j < b->cols; j++) {
-            double sum = 0;
-            for (size_t k = 0; k < a->cols; k++) {
-                sum += matrix_get(a, i, k) * matrix_get(b, k, j);
+    if (!matrix_mul_into(res, a, b)) {
+        matrix_free(res);
+        return NULL;
+    }
+    return res;
+}
+
+bool matrix_mul_into(matrix_t *dst, const matrix_t *a, const matrix_t *b) {
+    return matrix_gemm(1.0, a, b, 0.0, dst, NULL);
+}
+
+// 按 32x32 的块转置, 读写都保持在缓存内
+#define MATRIX_TRANSPOSE_BLOCK 32
+
+bool matrix_transpose_into(matrix_t *dst, const matrix_t *m) {
+    if (!dst || !m || dst == m || dst->data == m->data) return false;
+    if (dst->rows != m->cols || dst->cols != m->rows) return false;
+
+    for (size_t i0 = 0; i0 < m->rows; i0 += MATRIX_TRANSPOSE_BLOCK) {
+        size_t i1 = i0 + MATRIX_TRANSPOSE_BLOCK < m->rows ? i0 + MATRIX_TRANSPOSE_BLOCK : m->rows;
+        for (size_t j0 = 0; j0 < m->cols; j0 += MATRIX_TRANSPOSE_BLOCK) {
+            size_t j1 = j0 + MATRIX_TRANSPOSE_BLOCK < m->cols ? j0 + MATRIX_TRANSPOSE_BLOCK : m->cols;
+            for (size_t i = i0; i < i1; i++) {
+                for (size_t j = j0; j < j1; j++) {
+                    dst->data[j * m->rows + i] = m->data[i * m->cols + j];
+                }
             }
-            matrix_set(res, i, j, sum);
         }
     }
-    
-    return res;
+    return true;
 }
 
 matrix_t* matrix_transpose(const matrix_t *m) {
@@ -101,12 +142,7 @@ matrix_t* matrix_transpose(const matrix_t *m) {
     matrix_t *res = matrix_create(m->cols, m->rows);
     if (!res) return NULL;
     
-    for (size_t i = 0; i < m->rows; i++) {
-        for (size_t j = 0; j < m->cols; j++) {
-            matrix_set(res, j, i, matrix_get(m, i, j));
-        }
-    }
-    
+    matrix_transpose_into(res, m);
     return res;
 }
 
@@ -123,16 +159,21 @@ matrix_t* matrix_identity(size_t n) {
     return m;
 }
 
+void matrix_scale(matrix_t *m, double scalar) {
+    if (!m) return;
+
+    for (size_t i = 0; i < m->rows * m->cols; i++) {
+        m->data[i] *= scalar;
+    }
+}
+
 matrix_t* matrix_scalar_mul(const matrix_t *m, double scalar) {
     if (!m) return NULL;
     
-    matrix_t *res = matrix_create(m->rows, m->cols);
+    matrix_t *res = matrix_copy(m);
     if (!res) return NULL;
     
-    for (size_t i = 0; i < m->rows * m->cols; i++) {
-        res->data[i] = m->data[i] * scalar;
-    }
-    
+    matrix_scale(res, scalar);
     return res;
 }
 
@@ -176,3 +217,525 @@ void matrix_zero(matrix_t *m) {
     if (!m) return;
     memset(m->data, 0, m->rows * m->cols * sizeof(double));
 }
+
+/* ---------- GEMM ---------- */
+
+// 寄存器分块 6x8: 12 个 256 位累加器; A 块 96x256 (192KB) 留在 L2, B 面板 256x8 (16KB) 留在 L1
+#define GEMM_MR 6
+#define GEMM_NR 8
+#define GEMM_MC 96
+#define GEMM_KC 256
+#define GEMM_NC 2048
+// m*n*k 不超过此值时直接三重循环, 打包不划算
+#define GEMM_SMALL_FLOPS (32.0 * 32.0 * 32.0)
+
+typedef void (*gemm_kernel_fn)(size_t kc, const double *ap, const double *bp, double *c, size_t ldc,
+                               double alpha, size_t mr, size_t nr);
+
+// 边缘块: 只把有效的 mr x nr 部分加回 C
+static void gemm_store_partial(const double *acc, double *c, size_t ldc, size_t mr, size_t nr) {
+    for (size_t i = 0; i < mr; i++) {
+        for (size_t j = 0; j < nr; j++) c[i * ldc + j] += acc[i * GEMM_NR + j];
+    }
+}
+
+static void gemm_kernel_scalar(size_t kc, const double *ap, const double *bp, double *c, size_t ldc,
+                               double alpha, size_t mr, size_t nr) {
+    double acc[GEMM_MR * GEMM_NR] = { 0 };
+    for (size_t p = 0; p < kc; p++) {
+        for (size_t i = 0; i < GEMM_MR; i++) {
+            double av = ap[i];
+            for (size_t j = 0; j < GEMM_NR; j++) acc[i * GEMM_NR + j] += av * bp[j];
+        }
+        ap += GEMM_MR;
+        bp += GEMM_NR;
+    }
+    for (size_t i = 0; i < GEMM_MR * GEMM_NR; i++) acc[i] *= alpha;
+    gemm_store_partial(acc, c, ldc, mr, nr);
+}
+
+#ifdef MATRIX_HAVE_AVX2
+// 每步广播 A 的 6 个元素, 与 B 的两个 4 元向量做 12 次 FMA
+__attribute__((target("avx2,fma")))
+static void gemm_kernel_avx2(size_t kc, const double *ap, const double *bp, double *c, size_t ldc,
+                             double alpha, size_t mr, size_t nr) {
+    __m256d c00 = _mm256_setzero_pd(), c01 = c00, c10 = c00, c11 = c00, c20 = c00, c21 = c00;
+    __m256d c30 = c00, c31 = c00, c40 = c00, c41 = c00, c50 = c00, c51 = c00;
+    for (size_t p = 0; p < kc; p++) {
+        __m256d b0 = _mm256_load_pd(bp);
+        __m256d b1 = _mm256_load_pd(bp + 4);
+        __m256d a0 = _mm256_broadcast_sd(ap);
+        __m256d a1 = _mm256_broadcast_sd(ap + 1);
+        c00 = _mm256_fmadd_pd(a0, b0, c00);
+        c01 = _mm256_fmadd_pd(a0, b1, c01);
+        c10 = _mm256_fmadd_pd(a1, b0, c10);
+        c11 = _mm256_fmadd_pd(a1, b1, c11);
+        a0 = _mm256_broadcast_sd(ap + 2);
+        a1 = _mm256_broadcast_sd(ap + 3);
+        c20 = _mm256_fmadd_pd(a0, b0, c20);
+        c21 = _mm256_fmadd_pd(a0, b1, c21);
+        c30 = _mm256_fmadd_pd(a1, b0, c30);
+        c31 = _mm256_fmadd_pd(a1, b1, c31);
+        a0 = _mm256_broadcast_sd(ap + 4);
+        a1 = _mm256_broadcast_sd(ap + 5);
+        c40 = _mm256_fmadd_pd(a0, b0, c40);
+        c41 = _mm256_fmadd_pd(a0, b1, c41);
+        c50 = _mm256_fmadd_pd(a1, b0, c50);
+        c51 = _mm256_fmadd_pd(a1, b1, c51);
+        ap += GEMM_MR;
+        bp += GEMM_NR;
+    }
+    __m256d va = _mm256_set1_pd(alpha);
+    __m256d acc[2 * GEMM_MR] = { c00, c01, c10, c11, c20, c21, c30, c31, c40, c41, c50, c51 };
+    if (mr == GEMM_MR && nr == GEMM_NR) {
+        for (size_t i = 0; i < GEMM_MR; i++) {
+            double *row = c + i * ldc;
+            _mm256_storeu_pd(row, _mm256_fmadd_pd(va, acc[2 * i], _mm256_loadu_pd(row)));
+            _mm256_storeu_pd(row + 4, _mm256_fmadd_pd(va, acc[2 * i + 1], _mm256_loadu_pd(row + 4)));
+        }
+    } else {
+        double tmp[GEMM_MR * GEMM_NR];
+        for (size_t i = 0; i < GEMM_MR; i++) {
+            _mm256_storeu_pd(tmp + i * GEMM_NR, _mm256_mul_pd(va, acc[2 * i]));
+            _mm256_storeu_pd(tmp + i * GEMM_NR + 4, _mm256_mul_pd(va, acc[2 * i + 1]));
+        }
+        gemm_store_partial(tmp, c, ldc, mr, nr);
+    }
+}
+
+static bool matrix_cpu_has_avx2(void) {
+    static int cached = -1;
+    if (cached < 0) cached = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    return cached;
+}
+#endif
+
+static gemm_kernel_fn gemm_select_kernel(void) {
+#ifdef MATRIX_HAVE_AVX2
+    if (matrix_cpu_has_avx2()) return gemm_kernel_avx2;
+#endif
+    return gemm_kernel_scalar;
+}
+
+typedef struct {
+    bool trans_a;
+    bool trans_b;
+    size_t m;
+    double alpha;
+    const double *a;
+    size_t lda;
+    const double *b;
+    size_t ldb;
+    double *c;
+    size_t ldc;
+    gemm_kernel_fn kernel;
+    // 当前处理的 B 块: 列 [jc, jc+nc), 行 [pc, pc+kc)
+    size_t jc;
+    size_t nc;
+    size_t pc;
+    size_t kc;
+    size_t mc;
+    double *bpack;
+    double **apack;          // 每个任务一块 A 打包缓冲
+    size_t next_panel;       // 下一个未领取的行面板
+} gemm_ctx_t;
+
+typedef struct {
+    gemm_ctx_t *g;
+    int worker;
+} gemm_task_t;
+
+// A 的 mc x kc 子块 (行从 ic 起) 打包成 MR 行一组的面板, 面板内按 k 连续, 不足 MR 行补零
+static void gemm_pack_a(const gemm_ctx_t *g, size_t ic, size_t mc, double *ap) {
+    for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+        size_t mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+        double *dst = ap + ir * g->kc;
+        if (!g->trans_a) {
+            for (size_t i = 0; i < mr; i++) {
+                const double *src = g->a + (ic + ir + i) * g->lda + g->pc;
+                for (size_t p = 0; p < g->kc; p++) dst[p * GEMM_MR + i] = src[p];
+            }
+        } else {
+            for (size_t p = 0; p < g->kc; p++) {
+                const double *src = g->a + (g->pc + p) * g->lda + ic + ir;
+                for (size_t i = 0; i < mr; i++) dst[p * GEMM_MR + i] = src[i];
+            }
+        }
+        for (size_t i = mr; i < GEMM_MR; i++) {
+            for (size_t p = 0; p < g->kc; p++) dst[p * GEMM_MR + i] = 0.0;
+        }
+    }
+}
+
+// B 的 kc x nc 子块打包成 NR 列一组的面板, 面板内按 k 连续, 不足 NR 列补零
+static void gemm_pack_b(const gemm_ctx_t *g) {
+    for (size_t jr = 0; jr < g->nc; jr += GEMM_NR) {
+        size_t nr = g->nc - jr < GEMM_NR ? g->nc - jr : GEMM_NR;
+        double *dst = g->bpack + jr * g->kc;
+        if (!g->trans_b) {
+            for (size_t p = 0; p < g->kc; p++) {
+                const double *src = g->b + (g->pc + p) * g->ldb + g->jc + jr;
+                for (size_t j = 0; j < nr; j++) dst[p * GEMM_NR + j] = src[j];
+                for (size_t j = nr; j < GEMM_NR; j++) dst[p * GEMM_NR + j] = 0.0;
+            }
+        } else {
+            for (size_t j = 0; j < GEMM_NR; j++) {
+                if (j >= nr) {
+                    for (size_t p = 0; p < g->kc; p++) dst[p * GEMM_NR + j] = 0.0;
+                    continue;
+                }
+                const double *src = g->b + (g->jc + jr + j) * g->ldb + g->pc;
+                for (size_t p = 0; p < g->kc; p++) dst[p * GEMM_NR + j] = src[p];
+            }
+        }
+    }
+}
+
+// 一个行面板: 打包 A 后对 B 块的每个 NR 列面板和每组 MR 行调用微内核
+static void gemm_macro_kernel(const gemm_ctx_t *g, size_t ic, size_t mc, double *ap) {
+    gemm_pack_a(g, ic, mc, ap);
+    for (size_t jr = 0; jr < g->nc; jr += GEMM_NR) {
+        size_t nr = g->nc - jr < GEMM_NR ? g->nc - jr : GEMM_NR;
+        const double *bp = g->bpack + jr * g->kc;
+        for (size_t ir = 0; ir < mc; ir += GEMM_MR) {
+            size_t mr = mc - ir < GEMM_MR ? mc - ir : GEMM_MR;
+            g->kernel(g->kc, ap + ir * g->kc, bp, g->c + (ic + ir) * g->ldc + g->jc + jr, g->ldc,
+                      g->alpha, mr, nr);
+        }
+    }
+}
+
+static void gemm_run(void *arg) {
+    gemm_task_t *task = arg;
+    gemm_ctx_t *g = task->g;
+    for (;;) {
+        size_t panel = __atomic_fetch_add(&g->next_panel, 1, __ATOMIC_RELAXED);
+        size_t ic = panel * g->mc;
+        if (ic >= g->m) break;
+        size_t mc = g->m - ic < g->mc ? g->m - ic : g->mc;
+        gemm_macro_kernel(g, ic, mc, g->apack[task->worker]);
+    }
+}
+
+// 小矩阵: i-p-j 顺序, 最内层连续访问 C 的一行
+static void gemm_small(bool trans_a, bool trans_b, size_t m, size_t n, size_t k, double alpha,
+                       const double *a, size_t lda, const double *b, size_t ldb, double *c, size_t ldc) {
+    for (size_t i = 0; i < m; i++) {
+        double *crow = c + i * ldc;
+        for (size_t p = 0; p < k; p++) {
+            double aip = alpha * (trans_a ? a[p * lda + i] : a[i * lda + p]);
+            if (!trans_b) {
+                const double *brow = b + p * ldb;
+                for (size_t j = 0; j < n; j++) crow[j] += aip * brow[j];
+            } else {
+                for (size_t j = 0; j < n; j++) crow[j] += aip * b[j * ldb + p];
+            }
+        }
+    }
+}
+
+static double* gemm_alloc(size_t doubles) {
+    size_t bytes = (doubles * sizeof(double) + 63) & ~(size_t)63;
+    return aligned_alloc(64, bytes ? bytes : 64);
+}
+
+bool matrix_dgemm(bool trans_a, bool trans_b, size_t m, size_t n, size_t k,
+                  double alpha, const double *a, size_t lda,
+                  const double *b, size_t ldb,
+                  double beta, double *c, size_t ldc, threadpool_t *pool) {
+    if (m == 0 || n == 0) return true;
+    if (!c) return false;
+
+    // 先按 beta 缩放 C, 之后各块只做累加; beta 为 0 时直接清零, 不传播 C 中原有的 NaN
+    if (beta != 1.0) {
+        for (size_t i = 0; i < m; i++) {
+            double *row = c + i * ldc;
+            if (beta == 0.0) {
+                memset(row, 0, n * sizeof(double));
+            } else {
+                for (size_t j = 0; j < n; j++) row[j] *= beta;
+            }
+        }
+    }
+    if (k == 0 || alpha == 0.0) return true;
+    if (!a || !b) return false;
+    if ((double)m * (double)n * (double)k <= GEMM_SMALL_FLOPS) {
+        gemm_small(trans_a, trans_b, m, n, k, alpha, a, lda, b, ldb, c, ldc);
+        return true;
+    }
+
+    gemm_ctx_t g = { trans_a, trans_b, m, alpha, a, lda, b, ldb, c, ldc, gemm_select_kernel(),
+                     0, 0, 0, 0, GEMM_MC, NULL, NULL, 0 };
+    size_t workers = 1;
+    if (pool) {
+        int threads = threadpool_get_thread_count(pool);
+        workers = threads > 1 ? (size_t)threads : 1;
+    }
+    // 多任务时缩小行面板, 保证每个任务能领到约 4 块
+    if (workers > 1) {
+        size_t per = (m + 4 * workers - 1) / (4 * workers);
+        per = (per + GEMM_MR - 1) / GEMM_MR * GEMM_MR;
+        if (per < g.mc) g.mc = per;
+    }
+    size_t panels = (m + g.mc - 1) / g.mc;
+    if (workers > panels) workers = panels;
+
+    size_t kc_max = k < GEMM_KC ? k : GEMM_KC;
+    size_t nc_max = (n + GEMM_NR - 1) / GEMM_NR * GEMM_NR;
+    if (nc_max > GEMM_NC) nc_max = GEMM_NC;
+    size_t mc_max = (g.mc + GEMM_MR - 1) / GEMM_MR * GEMM_MR;
+
+    bool ok = false;
+    g.bpack = gemm_alloc(kc_max * nc_max);
+    g.apack = calloc(workers, sizeof(double *));
+    gemm_task_t *tasks = calloc(workers, sizeof(gemm_task_t));
+    int *ids = calloc(workers, sizeof(int));
+    if (!g.bpack || !g.apack || !tasks || !ids) goto cleanup;
+    for (size_t w = 0; w < workers; w++) {
+        g.apack[w] = gemm_alloc(mc_max * kc_max);
+        if (!g.apack[w]) goto cleanup;
+        tasks[w] = (gemm_task_t){ &g, (int)w };
+    }
+
+    for (size_t jc = 0; jc < n; jc += GEMM_NC) {
+        g.jc = jc;
+        g.nc = n - jc < GEMM_NC ? n - jc : GEMM_NC;
+        for (size_t pc = 0; pc < k; pc += GEMM_KC) {
+            g.pc = pc;
+            g.kc = k - pc < GEMM_KC ? k - pc : GEMM_KC;
+            gemm_pack_b(&g);
+            g.next_panel = 0;
+            // 任务 0 由调用线程执行, 提交失败的任务也在调用线程补做
+            for (size_t w = 1; w < workers; w++) ids[w] = threadpool_add_task(pool, gemm_run, &tasks[w]);
+            gemm_run(&tasks[0]);
+            for (size_t w = 1; w < workers; w++) {
+                if (ids[w] != 0) {
+                    threadpool_wait_task(pool, ids[w], -1);
+                } else {
+                    gemm_run(&tasks[w]);
+                }
+            }
+        }
+    }
+    ok = true;
+
+cleanup:
+    if (g.apack) {
+        for (size_t w = 0; w < workers; w++) free(g.apack[w]);
+    }
+    free(g.apack);
+    free(g.bpack);
+    free(tasks);
+    free(ids);
+    return ok;
+}
+
+bool matrix_gemm(double alpha, const matrix_t *a, const matrix_t *b,
+                 double beta, matrix_t *c, threadpool_t *pool) {
+    if (!a || !b || !c) return false;
+    if (a->cols != b->rows || c->rows != a->rows || c->cols != b->cols) return false;
+    if (c == a || c == b || c->data == a->data || c->data == b->data) return false;
+    return matrix_dgemm(false, false, a->rows, b->cols, a->cols, alpha, a->data, a->cols,
+                        b->data, b->cols, beta, c->data, c->cols, pool);
+}
+
+/* ---------- LU / Cholesky ---------- */
+
+// 分解的块大小: 面板分解和三角求解在块内逐行做, 块外的尾部更新交给 GEMM
+#define MATRIX_BLOCK 64
+// Cholesky 尾部更新按行块只算下三角部分
+#define MATRIX_CHOL_ROWS 256
+
+static void matrix_swap_rows(double *d, size_t cols, size_t i, size_t j) {
+    double *ri = d + i * cols, *rj = d + j * cols;
+    for (size_t c = 0; c < cols; c++) {
+        double t = ri[c];
+        ri[c] = rj[c];
+        rj[c] = t;
+    }
+}
+
+bool matrix_lu(matrix_t *a, size_t *perm, threadpool_t *pool) {
+    if (!matrix_is_square(a) || !perm) return false;
+    size_t n = a->rows;
+    double *d = a->data;
+    for (size_t i = 0; i < n; i++) perm[i] = i;
+
+    for (size_t kb = 0; kb < n; kb += MATRIX_BLOCK) {
+        size_t ke = kb + MATRIX_BLOCK < n ? kb + MATRIX_BLOCK : n;
+
+        // 面板 (列 kb..ke, 行 kb..n) 逐列选主元消去, 行交换作用于整行
+        for (size_t j = kb; j < ke; j++) {
+            size_t p = j;
+            double best = fabs(d[j * n + j]);
+            for (size_t i = j + 1; i < n; i++) {
+                double v = fabs(d[i * n + j]);
+                if (v > best) {
+                    best = v;
+                    p = i;
+                }
+            }
+            if (best == 0.0) return false;
+            if (p != j) {
+                matrix_swap_rows(d, n, p, j);
+                size_t t = perm[p];
+                perm[p] = perm[j];
+                perm[j] = t;
+            }
+            const double *pivot_row = d + j * n;
+            double inv = 1.0 / pivot_row[j];
+            for (size_t i = j + 1; i < n; i++) {
+                double *row = d + i * n;
+                double l = row[j] * inv;
+                row[j] = l;
+                for (size_t t = j + 1; t < ke; t++) row[t] -= l * pivot_row[t];
+            }
+        }
+        if (ke == n) break;
+
+        // U12 = L11^-1 A12 (单位下三角前代)
+        for (size_t i = kb + 1; i < ke; i++) {
+            double *row = d + i * n;
+            for (size_t t = kb; t < i; t++) {
+                double l = row[t];
+                const double *src = d + t * n;
+                for (size_t c = ke; c < n; c++) row[c] -= l * src[c];
+            }
+        }
+
+        // A22 -= L21 U12
+        if (!matrix_dgemm(false, false, n - ke, n - ke, ke - kb, -1.0, d + ke * n + kb, n,
+                          d + kb * n + ke, n, 1.0, d + ke * n + ke, n, pool)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool matrix_lu_solve(const matrix_t *lu, const size_t *perm, matrix_t *b) {
+    if (!matrix_is_square(lu) || !perm || !b || b->rows != lu->rows) return false;
+    size_t n = lu->rows, w = b->cols;
+    const double *d = lu->data;
+    double *x = malloc(n * w * sizeof(double));
+    if (!x) return false;
+    for (size_t i = 0; i < n; i++) memcpy(x + i * w, b->data + perm[i] * w, w * sizeof(double));
+
+    // L y = P b
+    for (size_t i = 1; i < n; i++) {
+        double *xi = x + i * w;
+        for (size_t t = 0; t < i; t++) {
+            double l = d[i * n + t];
+            const double *xt = x + t * w;
+            for (size_t c = 0; c < w; c++) xi[c] -= l * xt[c];
+        }
+    }
+    // U x = y
+    for (size_t i = n; i-- > 0;) {
+        double *xi = x + i * w;
+        for (size_t t = i + 1; t < n; t++) {
+            double u = d[i * n + t];
+            const double *xt = x + t * w;
+            for (size_t c = 0; c < w; c++) xi[c] -= u * xt[c];
+        }
+        double inv = 1.0 / d[i * n + i];
+        for (size_t c = 0; c < w; c++) xi[c] *= inv;
+    }
+    memcpy(b->data, x, n * w * sizeof(double));
+    free(x);
+    return true;
+}
+
+bool matrix_cholesky(matrix_t *a, threadpool_t *pool) {
+    if (!matrix_is_square(a)) return false;
+    size_t n = a->rows;
+    double *d = a->data;
+
+    for (size_t kb = 0; kb < n; kb += MATRIX_BLOCK) {
+        size_t ke = kb + MATRIX_BLOCK < n ? kb + MATRIX_BLOCK : n;
+
+        // 对角块 L11 (之前的块已由 GEMM 从这里减掉)
+        for (size_t j = kb; j < ke; j++) {
+            double *rj = d + j * n;
+            double s = rj[j];
+            for (size_t t = kb; t < j; t++) s -= rj[t] * rj[t];
+            if (!(s > 0.0)) return false;
+            double ljj = sqrt(s);
+            rj[j] = ljj;
+            for (size_t i = j + 1; i < ke; i++) {
+                double *ri = d + i * n;
+                double v = ri[j];
+                for (size_t t = kb; t < j; t++) v -= ri[t] * rj[t];
+                ri[j] = v / ljj;
+            }
+        }
+        if (ke == n) break;
+
+        // L21 = A21 L11^-T, 每行独立前代
+        for (size_t i = ke; i < n; i++) {
+            double *ri = d + i * n;
+            for (size_t j = kb; j < ke; j++) {
+                const double *rj = d + j * n;
+                double v = ri[j];
+                for (size_t t = kb; t < j; t++) v -= ri[t] * rj[t];
+                ri[j] = v / rj[j];
+            }
+        }
+
+        // A22 -= L21 L21^T, 按行块只更新到对角线所在的列
+        for (size_t r0 = ke; r0 < n; r0 += MATRIX_CHOL_ROWS) {
+            size_t h = n - r0 < MATRIX_CHOL_ROWS ? n - r0 : MATRIX_CHOL_ROWS;
+            if (!matrix_dgemm(false, true, h, r0 + h - ke, ke - kb, -1.0, d + r0 * n + kb, n,
+                              d + ke * n + kb, n, 1.0, d + r0 * n + ke, n, pool)) {
+                return false;
+            }
+        }
+    }
+    for (size_t i = 0; i + 1 < n; i++) memset(d + i * n + i + 1, 0, (n - i - 1) * sizeof(double));
+    return true;
+}
+
+bool matrix_cholesky_solve(const matrix_t *l, matrix_t *b) {
+    if (!matrix_is_square(l) || !b || b->rows != l->rows) return false;
+    size_t n = l->rows, w = b->cols;
+    const double *d = l->data;
+    double *x = b->data;
+
+    // L y = b
+    for (size_t i = 0; i < n; i++) {
+        double *xi = x + i * w;
+        for (size_t t = 0; t < i; t++) {
+            double v = d[i * n + t];
+            const double *xt = x + t * w;
+            for (size_t c = 0; c < w; c++) xi[c] -= v * xt[c];
+        }
+        double inv = 1.0 / d[i * n + i];
+        for (size_t c = 0; c < w; c++) xi[c] *= inv;
+    }
+    // L^T x = y: 求出 x_i 后把 L 第 i 行的贡献从前面各行减掉, 按行连续访问 L
+    for (size_t i = n; i-- > 0;) {
+        double *xi = x + i * w;
+        double inv = 1.0 / d[i * n + i];
+        for (size_t c = 0; c < w; c++) xi[c] *= inv;
+        for (size_t t = 0; t < i; t++) {
+            double v = d[i * n + t];
+            double *xt = x + t * w;
+            for (size_t c = 0; c < w; c++) xt[c] -= v * xi[c];
+        }
+    }
+    return true;
+}
+
+matrix_t* matrix_solve(const matrix_t *a, const matrix_t *b) {
+    if (!matrix_is_square(a) || !b || b->rows != a->rows) return NULL;
+    matrix_t *lu = matrix_copy(a);
+    matrix_t *x = matrix_copy(b);
+    size_t *perm = malloc(a->rows * sizeof(size_t));
+    bool ok = lu && x && perm && matrix_lu(lu, perm, NULL) && matrix_lu_solve(lu, perm, x);
+    matrix_free(lu);
+    free(perm);
+    if (!ok) {
+        matrix_free(x);
+        return NULL;
+    }
+    return x;
+}
@@ -3,7 +3,9 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include "threadpool.h"
 
+// 行主序稠密矩阵
 typedef struct {
     size_t rows;
     size_t cols;
@@ -21,13 +23,49 @@ double    matrix_get(const matrix_t *m, size_t r, size_t c);
 void      matrix_fill(matrix_t *m, double val);
 void      matrix_zero(matrix_t *m);
 
-// 矩阵运算
+// 矩阵运算 (结果为新矩阵)
 matrix_t* matrix_add(const matrix_t *a, const matrix_t *b);
 matrix_t* matrix_sub(const matrix_t *a, const matrix_t *b);
 matrix_t* matrix_mul(const matrix_t *a, const matrix_t *b);
 matrix_t* matrix_transpose(const matrix_t *m);
 matrix_t* matrix_scalar_mul(const matrix_t *m, double scalar);
 
+// 输出参数版本: 结果写入已分配的 dst, 不再分配内存
+// 返回: 尺寸不匹配返回 false
+bool      matrix_add_into(matrix_t *dst, const matrix_t *a, const matrix_t *b);   // dst 可与 a/b 相同
+bool      matrix_sub_into(matrix_t *dst, const matrix_t *a, const matrix_t *b);   // dst 可与 a/b 相同
+bool      matrix_mul_into(matrix_t *dst, const matrix_t *a, const matrix_t *b);   // dst 不能与 a/b 相同
+bool      matrix_transpose_into(matrix_t *dst, const matrix_t *m);                 // 分块转置, dst 不能与 m 相同
+void      matrix_scale(matrix_t *m, double scalar);                                // 原地缩放
+
+// 通用矩阵乘 C = alpha * op(A) * op(B) + beta * C, op 为转置或不变, 各矩阵按行主序和行距给出
+// 打包 A/B 到 L2/L1 大小的块, 6x8 寄存器分块微内核 (支持时用 AVX2/FMA)
+// pool: 行面板在线程池上并行, 调用线程也参与; NULL 时在调用线程执行
+// 返回: 内存不足返回 false (此时 C 可能已按 beta 缩放)
+bool      matrix_dgemm(bool trans_a, bool trans_b, size_t m, size_t n, size_t k,
+                       double alpha, const double *a, size_t lda,
+                       const double *b, size_t ldb,
+                       double beta, double *c, size_t ldc, threadpool_t *pool);
+// 矩阵封装: c 为 a->rows x b->cols, 不能与 a/b 相同
+bool      matrix_gemm(double alpha, const matrix_t *a, const matrix_t *b,
+                      double beta, matrix_t *c, threadpool_t *pool);
+
+// 分块 LU 分解 (部分主元): 原地得到 PA = LU, L 为单位下三角 (对角线不存)
+// perm[i] 为分解后第 i 行在原矩阵中的行号; 尾部更新走 matrix_dgemm
+// 返回: 非方阵或奇异返回 false
+bool      matrix_lu(matrix_t *a, size_t *perm, threadpool_t *pool);
+// 用 LU 分解结果原地求解 A X = B, b 为 n x nrhs
+bool      matrix_lu_solve(const matrix_t *lu, const size_t *perm, matrix_t *b);
+
+// 分块 Cholesky 分解: 对称正定矩阵原地得到下三角 L (A = L L^T), 上三角清零
+// 返回: 非方阵或不正定返回 false
+bool      matrix_cholesky(matrix_t *a, threadpool_t *pool);
+// 用 Cholesky 分解结果原地求解 A X = B
+bool      matrix_cholesky_solve(const matrix_t *l, matrix_t *b);
+
+// 求解 A X = B (LU 分解), 返回新矩阵 X; 奇异或尺寸不匹配返回 NULL
+matrix_t* matrix_solve(const matrix_t *a, const matrix_t *b);
+
 // 特殊矩阵
 matrix_t* matrix_identity(size_t n);
 
@@ -3,16 +3,63 @@
 #include <string.h>
 #include <stdint.h>
 #include <unistd.h>
+#include <stdio.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#define HUGE_PAGE_SIZE ((size_t)2 * 1024 * 1024)
+
+#ifndef MAP_HUGETLB
+#define MAP_HUGETLB 0x40000
+#endif
+#ifndef MAP_POPULATE
+#define MAP_POPULATE 0x8000
+#endif
+#ifndef MADV_HUGEPAGE
+#define MADV_HUGEPAGE 14
+#endif
+#ifndef MADV_POPULATE_WRITE
+#define MADV_POPULATE_WRITE 23
+#endif
+
+// mbind 模式 (linux/mempolicy.h), 直接走系统调用, 不依赖 libnuma
+#define NUMA_MPOL_BIND 2
+#define NUMA_MPOL_INTERLEAVE 3
+#define NUMA_MPOL_LOCAL 4
+#define NUMA_MAX_NODES 64
+
+typedef enum {
+    MAPPING_PLAIN = 1,
+    MAPPING_THP,
+    MAPPING_HUGETLB
+} mapping_kind_t;
+
+// mmap 分配登记表: 线性探测哈希, page_free 据此区分 mmap 与 posix_memalign 分配
+typedef struct {
+    void *addr;
+    size_t size;
+    mapping_kind_t kind;
+} mapping_t;
 
 static page_alloc_stats_t g_stats = {0};
 static bool g_stats_initialized = false;
 
+static pthread_mutex_t g_map_lock = PTHREAD_MUTEX_INITIALIZER;
+static mapping_t *g_maps = NULL;
+static size_t g_map_capacity = 0;
+static size_t g_map_count = 0;
+
 page_alloc_config_t page_alloc_default_config(void) {
     page_alloc_config_t config = {
         .alignment = 0,
         .zero_initialize = true,
         .min_size = 1,
-        .max_size = 0
+        .max_size = 0,
+        .huge = PAGE_HUGE_NONE,
+        .prefault = false,
+        .numa = PAGE_NUMA_DEFAULT,
+        .numa_node = 0
     };
     return config;
 }
@@ -26,6 +73,247 @@ size_t page_alloc_get_page_size(void) {
     return page_size;
 }
 
+size_t page_alloc_get_huge_page_size(void) {
+    return HUGE_PAGE_SIZE;
+}
+
+static void stats_init_once(void) {
+    if (!g_stats_initialized) {
+        memset(&g_stats, 0, sizeof(g_stats));
+        g_stats.page_size = page_alloc_get_page_size();
+        g_stats_initialized = true;
+    }
+}
+
+// ---------------------------------------------------------------- 登记表 (调用方持有 g_map_lock)
+
+static size_t map_slot(const void *addr, size_t capacity) {
+    uint64_t h = (uint64_t)(uintptr_t)addr >> 12;
+    h *= 0x9E3779B97F4A7C15ull;
+    return (size_t)(h >> 32) & (capacity - 1);
+}
+
+static bool map_grow(void) {
+    size_t capacity = g_map_capacity ? g_map_capacity * 2 : 64;
+    mapping_t *maps = calloc(capacity, sizeof(mapping_t));
+    if (!maps) return false;
+    for (size_t i = 0; i < g_map_capacity; i++) {
+        if (!g_maps[i].addr) continue;
+        size_t j = map_slot(g_maps[i].addr, capacity);
+        while (maps[j].addr) j = (j + 1) & (capacity - 1);
+        maps[j] = g_maps[i];
+    }
+    free(g_maps);
+    g_maps = maps;
+    g_map_capacity = capacity;
+    return true;
+}
+
+static bool map_insert(void *addr, size_t size, mapping_kind_t kind) {
+    if ((g_map_count + 1) * 2 > g_map_capacity && !map_grow()) return false;
+    size_t i = map_slot(addr, g_map_capacity);
+    while (g_maps[i].addr) i = (i + 1) & (g_map_capacity - 1);
+    g_maps[i] = (mapping_t){ addr, size, kind };
+    __atomic_store_n(&g_map_count, g_map_count + 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+// 删除后把后续同簇元素前移, 不留墓碑
+static bool map_remove(void *addr, mapping_t *out) {
+    if (!g_map_capacity) return false;
+    size_t mask = g_map_capacity - 1, i = map_slot(addr, g_map_capacity);
+    while (g_maps[i].addr != addr) {
+        if (!g_maps[i].addr) return false;
+        i = (i + 1) & mask;
+    }
+    *out = g_maps[i];
+    for (size_t j = (i + 1) & mask; g_maps[j].addr; j = (j + 1) & mask) {
+        size_t home = map_slot(g_maps[j].addr, g_map_capacity);
+        // home 不在 (i, j] 环形区间内时, j 可以移到 i
+        if (((j - home) & mask) >= ((j - i) & mask)) {
+            g_maps[i] = g_maps[j];
+            i = j;
+        }
+    }
+    g_maps[i].addr = NULL;
+    __atomic_store_n(&g_map_count, g_map_count - 1, __ATOMIC_RELAXED);
+    return true;
+}
+
+static void map_account(const mapping_t *m, bool add) {
+    size_t *fields[] = { &g_stats.mapped_allocated, &g_stats.current_allocated,
+                         m->kind == MAPPING_HUGETLB ? &g_stats.hugetlb_allocated
+                         : m->kind == MAPPING_THP  ? &g_stats.thp_allocated : NULL };
+    for (size_t i = 0; i < sizeof(fields) / sizeof(fields[0]); i++) {
+        if (fields[i]) *fields[i] = add ? *fields[i] + m->size : *fields[i] - m->size;
+    }
+}
+
+// ---------------------------------------------------------------- mmap 分配
+
+// 在线节点掩码, 读取 /sys/devices/system/node/online (如 "0-3,6")
+static unsigned long online_nodes(void) {
+    unsigned long mask = 0;
+    FILE *f = fopen("/sys/devices/system/node/online", "r");
+    if (f) {
+        unsigned lo, hi;
+        char sep;
+        while (fscanf(f, "%u", &lo) == 1) {
+            hi = lo;
+            if (fscanf(f, "%c", &sep) == 1 && sep == '-') {
+                if (fscanf(f, "%u", &hi) != 1) break;
+                if (fscanf(f, "%c", &sep) != 1) sep = '\n';
+            }
+            for (unsigned n = lo; n <= hi && n < NUMA_MAX_NODES; n++) mask |= 1ul << n;
+            if (sep != ',') break;
+        }
+        fclose(f);
+    }
+    return mask ? mask : 1ul;
+}
+
+static void apply_numa(void *ptr, size_t size, const page_alloc_config_t *cfg) {
+#ifdef SYS_mbind
+    unsigned long mask = 0;
+    int mode;
+    switch (cfg->numa) {
+    case PAGE_NUMA_LOCAL: mode = NUMA_MPOL_LOCAL; break;
+    case PAGE_NUMA_BIND:
+        if (cfg->numa_node < 0 || cfg->numa_node >= NUMA_MAX_NODES) {
+            g_stats.numa_failures++;
+            return;
+        }
+        mode = NUMA_MPOL_BIND;
+        mask = 1ul << cfg->numa_node;
+        break;
+    case PAGE_NUMA_INTERLEAVE: mode = NUMA_MPOL_INTERLEAVE; mask = online_nodes(); break;
+    default: return;
+    }
+    if (syscall(SYS_mbind, ptr, size, mode, mask ? &mask : NULL, mask ? NUMA_MAX_NODES + 1 : 0, 0) != 0) {
+        g_stats.numa_failures++;
+    }
+#else
+    (void)ptr;
+    (void)size;
+    if (cfg->numa != PAGE_NUMA_DEFAULT) g_stats.numa_failures++;
+#endif
+}
+
+static void prefault(void *ptr, size_t size) {
+    if (madvise(ptr, size, MADV_POPULATE_WRITE) == 0) return;
+    // 旧内核: 每页写一次
+    size_t page_size = page_alloc_get_page_size();
+    for (size_t off = 0; off < size; off += page_size) ((volatile char *)ptr)[off] = 0;
+}
+
+// 多映射 align 字节后裁掉首尾, 得到按 align 对齐的区域
+static void* map_aligned(size_t size, size_t align) {
+    size_t page_size = page_alloc_get_page_size();
+    size_t span = size + (align > page_size ? align - page_size : 0);
+    char *raw = mmap(NULL, span, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (raw == MAP_FAILED) return NULL;
+    char *ptr = (char *)(((uintptr_t)raw + align - 1) & ~(uintptr_t)(align - 1));
+    if (ptr > raw) munmap(raw, (size_t)(ptr - raw));
+    if (raw + span > ptr + size) munmap(ptr + size, (size_t)(raw + span - (ptr + size)));
+    return ptr;
+}
+
+static void* mapped_alloc(size_t size, const page_alloc_config_t *cfg, page_alloc_error_t *error) {
+    size_t page_size = page_alloc_get_page_size();
+    size_t align = cfg->alignment > page_size ? cfg->alignment : page_size;
+    size_t unit = cfg->huge != PAGE_HUGE_NONE ? HUGE_PAGE_SIZE : page_size;
+    if (cfg->huge != PAGE_HUGE_NONE && align < HUGE_PAGE_SIZE) align = HUGE_PAGE_SIZE;
+    if (size > SIZE_MAX - unit) {
+        if (error) *error = PAGE_ALLOC_ERROR_INVALID_SIZE;
+        return NULL;
+    }
+    size = (size + unit - 1) / unit * unit;
+
+    void *ptr = NULL;
+    mapping_kind_t kind = MAPPING_PLAIN;
+    bool populated = false;
+    if (cfg->huge == PAGE_HUGE_EXPLICIT && align == HUGE_PAGE_SIZE) {
+        // 需要先 mbind 时不能在 mmap 中预取
+        populated = cfg->prefault && cfg->numa == PAGE_NUMA_DEFAULT;
+        ptr = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                   MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (populated ? MAP_POPULATE : 0), -1, 0);
+        if (ptr == MAP_FAILED) {
+            ptr = NULL;
+            populated = false;
+        } else {
+            kind = MAPPING_HUGETLB;
+        }
+    }
+    if (!ptr) {
+        ptr = map_aligned(size, align);
+        if (!ptr) {
+            if (error) *error = PAGE_ALLOC_ERROR_ALLOCATION_FAILED;
+            return NULL;
+        }
+        if (cfg->huge != PAGE_HUGE_NONE) {
+            kind = MAPPING_THP;
+            madvise(ptr, size, MADV_HUGEPAGE);
+        }
+    }
+    if (cfg->numa != PAGE_NUMA_DEFAULT) apply_numa(ptr, size, cfg);
+    if (cfg->prefault && !populated) prefault(ptr, size);
+
+    pthread_mutex_lock(&g_map_lock);
+    bool ok = map_insert(ptr, size, kind);
+    if (ok) {
+        mapping_t m = { ptr, size, kind };
+        map_account(&m, true);
+        g_stats.total_allocated += size;
+        g_stats.allocation_count++;
+    }
+    pthread_mutex_unlock(&g_map_lock);
+    if (!ok) {
+        munmap(ptr, size);
+        if (error) *error = PAGE_ALLOC_ERROR_ALLOCATION_FAILED;
+        return NULL;
+    }
+    if (error) *error = PAGE_ALLOC_OK;
+    return ptr;
+}
+
+static bool mapped_free(void *ptr) {
+    if (__atomic_load_n(&g_map_count, __ATOMIC_RELAXED) == 0) return false;
+    mapping_t m;
+    pthread_mutex_lock(&g_map_lock);
+    bool found = map_remove(ptr, &m);
+    if (found) {
+        map_account(&m, false);
+        g_stats.free_count++;
+    }
+    pthread_mutex_unlock(&g_map_lock);
+    if (found) munmap(m.addr, m.size);
+    return found;
+}
+
+// 登记的 mmap 区域中由透明大页支撑的字节数 (smaps 的 AnonHugePages)
+static size_t thp_backed_bytes(void) {
+    FILE *f = fopen("/proc/self/smaps", "r");
+    if (!f) return 0;
+    char line[256];
+    bool tracked = false;
+    size_t total = 0;
+    while (fgets(line, sizeof(line), f)) {
+        unsigned long start, end;
+        size_t kb;
+        if (sscanf(line, "%lx-%lx ", &start, &end) == 2) {
+            tracked = false;
+            for (size_t i = 0; i < g_map_capacity && !tracked; i++) {
+                uintptr_t a = (uintptr_t)g_maps[i].addr;
+                tracked = a && g_maps[i].kind != MAPPING_HUGETLB && a < end && a + g_maps[i].size > start;
+            }
+        } else if (tracked && sscanf(line, "AnonHugePages: %zu kB", &kb) == 1) {
+            total += kb * 1024;
+        }
+    }
+    fclose(f);
+    return total;
+}
+
 void* page_alloc(size_t size) {
     return page_alloc_ex(size, NULL, NULL);
 }
@@ -51,6 +339,15 @@ void* page_alloc_ex(size_t size, const page_alloc_config_t *config, page_alloc_e
         return NULL;
     }
     
+    stats_init_once();
+    if (cfg.huge != PAGE_HUGE_NONE || cfg.prefault || cfg.numa != PAGE_NUMA_DEFAULT) {
+        if (cfg.alignment & (cfg.alignment - 1)) {
+            if (error) *error = PAGE_ALLOC_ERROR_INVALID_ALIGNMENT;
+            return NULL;
+        }
+        return mapped_alloc(size, &cfg, error);
+    }
+
     size_t page_size = page_alloc_get_page_size();
     size_t aligned_size = ((size + page_size - 1) / page_size) * page_size;
     
@@ -64,12 +361,6 @@ void* page_alloc_ex(size_t size, const page_alloc_config_t *config, page_alloc_e
         memset(ptr, 0, aligned_size);
     }
     
-    if (!g_stats_initialized) {
-        memset(&g_stats, 0, sizeof(g_stats));
-        g_stats.page_size = page_size;
-        g_stats_initialized = true;
-    }
-    
     g_stats.total_allocated += aligned_size;
     g_stats.current_allocated += aligned_size;
     g_stats.allocation_count++;
@@ -88,8 +379,10 @@ bool page_free_ex(void *ptr, page_alloc_error_t *error) {
         return false;
     }
     
-    free(ptr);
-    g_stats.free_count++;
+    if (!mapped_free(ptr)) {
+        free(ptr);
+        g_stats.free_count++;
+    }
     
     if (error) *error = PAGE_ALLOC_OK;
     return true;
@@ -168,15 +461,26 @@ bool page_alloc_get_stats(page_alloc_stats_t *stats, page_alloc_error_t *error)
         return false;
     }
     
+    pthread_mutex_lock(&g_map_lock);
     *stats = g_stats;
+    stats->page_size = page_alloc_get_page_size();
+    stats->huge_backed = stats->hugetlb_allocated;
+    if (stats->mapped_allocated > stats->hugetlb_allocated) stats->huge_backed += thp_backed_bytes();
+    pthread_mutex_unlock(&g_map_lock);
     if (error) *error = PAGE_ALLOC_OK;
     return true;
 }
 
 bool page_alloc_reset_stats(page_alloc_error_t *error) {
+    pthread_mutex_lock(&g_map_lock);
     memset(&g_stats, 0, sizeof(g_stats));
     g_stats.page_size = page_alloc_get_page_size();
     g_stats_initialized = true;
+    // 仍然存活的 mmap 区域继续计入当前用量, 释放时才能正确扣减
+    for (size_t i = 0; i < g_map_capacity; i++) {
+        if (g_maps[i].addr) map_account(&g_maps[i], true);
+    }
+    pthread_mutex_unlock(&g_map_lock);
     
     if (error) *error = PAGE_ALLOC_OK;
     return true;
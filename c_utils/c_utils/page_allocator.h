@@ -16,14 +16,39 @@ typedef enum {
     PAGE_ALLOC_ERROR_MAX               /**< 最大错误码 */
 } page_alloc_error_t;
 
+/**
+ * @brief 大页模式
+ */
+typedef enum {
+    PAGE_HUGE_NONE = 0,                /**< 普通页 */
+    PAGE_HUGE_TRANSPARENT,             /**< 透明大页: 2MB 对齐并 madvise(MADV_HUGEPAGE) */
+    PAGE_HUGE_EXPLICIT                 /**< 显式大页: MAP_HUGETLB, 大页池不足时退回透明大页 */
+} page_huge_mode_t;
+
+/**
+ * @brief NUMA 放置策略 (通过 mbind 系统调用设置, 内核不支持时忽略并计入统计)
+ */
+typedef enum {
+    PAGE_NUMA_DEFAULT = 0,             /**< 沿用进程策略 */
+    PAGE_NUMA_LOCAL,                   /**< 在首次访问的线程所在节点分配 */
+    PAGE_NUMA_BIND,                    /**< 只在 numa_node 指定的节点分配 */
+    PAGE_NUMA_INTERLEAVE               /**< 按页在所有在线节点间交错 */
+} page_numa_policy_t;
+
 /**
  * @brief 页分配器配置
+ *
+ * huge、prefault、numa 任一非默认时改用 mmap 分配, 内存由内核清零, 不再 memset
  */
 typedef struct {
     size_t alignment;                  /**< 对齐要求 (0 表示系统页大小) */
     bool zero_initialize;              /**< 是否零初始化内存 */
     size_t min_size;                   /**< 最小分配大小 */
     size_t max_size;                   /**< 最大分配大小 (0 表示无限制) */
+    page_huge_mode_t huge;             /**< 大页模式, 大页模式下大小向上取整到 2MB */
+    bool prefault;                     /**< 分配时预先缺页 (MAP_POPULATE / MADV_POPULATE_WRITE) */
+    page_numa_policy_t numa;           /**< NUMA 放置策略 */
+    int numa_node;                     /**< PAGE_NUMA_BIND 使用的节点 */
 } page_alloc_config_t;
 
 /**
@@ -35,6 +60,11 @@ typedef struct {
     size_t allocation_count;           /**< 分配次数 */
     size_t free_count;                 /**< 释放次数 */
     size_t page_size;                  /**< 系统页大小 */
+    size_t mapped_allocated;           /**< 当前通过 mmap 分配的字节数 */
+    size_t hugetlb_allocated;          /**< 其中显式大页 (MAP_HUGETLB) 的字节数 */
+    size_t thp_allocated;              /**< 其中申请了透明大页的字节数 */
+    size_t huge_backed;                /**< 实际由大页支撑的字节数 (透明大页部分读取 /proc/self/smaps) */
+    size_t numa_failures;              /**< mbind 失败次数 */
 } page_alloc_stats_t;
 
 /**
@@ -49,6 +79,12 @@ page_alloc_config_t page_alloc_default_config(void);
  */
 size_t page_alloc_get_page_size(void);
 
+/**
+ * @brief 获取大页大小 (2MB)
+ * @return 大页大小
+ */
+size_t page_alloc_get_huge_page_size(void);
+
 /**
  * @brief 页对齐分配内存
  * @param size 分配大小
@@ -118,6 +154,8 @@ bool page_is_aligned(const void *ptr, size_t alignment);
 
 /**
  * @brief 获取页分配器统计信息
+ *
+ * 大页覆盖率为 huge_backed / mapped_allocated
  * @param stats 统计信息输出
  * @param error 错误码输出
  * @return 是否成功
@@ -1,7 +1,306 @@
 #include "poly1305_tiny.h"
 #include <string.h>
 
+// 64 位分段实现 (44/44/42 位), 每 16 字节块只需 9 次 64x64->128 乘法
+#define MASK44 0xfffffffffffULL
+#define MASK42 0x3ffffffffffULL
+
+#if defined(__SIZEOF_INT128__)
+typedef unsigned __int128 u128_t;
+#define U128_MUL(a, b) ((u128_t)(a) * (b))
+#define U128_ADD(x, y) ((x) + (y))
+#define U128_ADD64(x, a) ((x) + (a))
+#define U128_SHR(x, n) ((uint64_t)((x) >> (n)))
+#define U128_LO(x) ((uint64_t)(x))
+#else
+typedef struct {
+    uint64_t lo;
+    uint64_t hi;
+} u128_t;
+
+static u128_t u128_mul(uint64_t a, uint64_t b) {
+    uint64_t a0 = (uint32_t)a, a1 = a >> 32;
+    uint64_t b0 = (uint32_t)b, b1 = b >> 32;
+    uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+    uint64_t mid = (p00 >> 32) + (uint32_t)p01 + (uint32_t)p10;
+    u128_t r;
+    r.lo = (mid << 32) | (uint32_t)p00;
+    r.hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+    return r;
+}
+
+static u128_t u128_add(u128_t x, u128_t y) {
+    u128_t r;
+    r.lo = x.lo + y.lo;
+    r.hi = x.hi + y.hi + (r.lo < x.lo);
+    return r;
+}
+
+static u128_t u128_add64(u128_t x, uint64_t a) {
+    u128_t r;
+    r.lo = x.lo + a;
+    r.hi = x.hi + (r.lo < x.lo);
+    return r;
+}
+
+#define U128_MUL(a, b) u128_mul((a), (b))
+#define U128_ADD(x, y) u128_add((x), (y))
+#define U128_ADD64(x, a) u128_add64((x), (a))
+#define U128_SHR(x, n) (((x).lo >> (n)) | ((x).hi << (64 - (n))))
+#define U128_LO(x) ((x).lo)
+#endif
+
+static uint64_t load_le64(const uint8_t *p) {
+    return (uint64_t)p[0] | ((uint64_t)p[1] << 8) | ((uint64_t)p[2] << 16) | ((uint64_t)p[3] << 24) |
+           ((uint64_t)p[4] << 32) | ((uint64_t)p[5] << 40) | ((uint64_t)p[6] << 48) | ((uint64_t)p[7] << 56);
+}
+
+static void store_le64(uint8_t *p, uint64_t v) {
+    for (int i = 0; i < 8; i++) {
+        p[i] = (uint8_t)(v >> (8 * i));
+    }
+}
+
+// 处理若干完整的 16 字节块, hibit 为 2^128 对应的位 (最后不足 16 字节的块为 0)
+static void poly1305_blocks(poly1305_ctx_t *ctx, const uint8_t *m, size_t bytes, uint64_t hibit) {
+    const uint64_t r0 = ctx->r[0], r1 = ctx->r[1], r2 = ctx->r[2];
+    const uint64_t s1 = r1 * (5 << 2), s2 = r2 * (5 << 2);
+    uint64_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2];
+
+    while (bytes >= 16) {
+        uint64_t t0 = load_le64(m);
+        uint64_t t1 = load_le64(m + 8);
+
+        h0 += t0 & MASK44;
+        h1 += ((t0 >> 44) | (t1 << 20)) & MASK44;
+        h2 += ((t1 >> 24) & MASK42) | hibit;
+
+        u128_t d0 = U128_ADD(U128_ADD(U128_MUL(h0, r0), U128_MUL(h1, s2)), U128_MUL(h2, s1));
+        u128_t d1 = U128_ADD(U128_ADD(U128_MUL(h0, r1), U128_MUL(h1, r0)), U128_MUL(h2, s2));
+        u128_t d2 = U128_ADD(U128_ADD(U128_MUL(h0, r2), U128_MUL(h1, r1)), U128_MUL(h2, r0));
+
+        uint64_t c = U128_SHR(d0, 44);
+        h0 = U128_LO(d0) & MASK44;
+        d1 = U128_ADD64(d1, c);
+        c = U128_SHR(d1, 44);
+        h1 = U128_LO(d1) & MASK44;
+        d2 = U128_ADD64(d2, c);
+        c = U128_SHR(d2, 42);
+        h2 = U128_LO(d2) & MASK42;
+        h0 += c * 5;
+        c = h0 >> 44;
+        h0 &= MASK44;
+        h1 += c;
+
+        m += 16;
+        bytes -= 16;
+    }
+
+    ctx->h[0] = h0;
+    ctx->h[1] = h1;
+    ctx->h[2] = h2;
+}
+
+poly1305_config_t poly1305_default_config(void) {
+    poly1305_config_t config;
+    config.key_size = POLY1305_KEY_SIZE;
+    config.mac_size = POLY1305_MAC_SIZE;
+    config.verify_only = false;
+    return config;
+}
+
+bool poly1305_init_ex(poly1305_ctx_t *ctx, const uint8_t *key, size_t key_len, const poly1305_config_t *config,
+                      poly1305_error_t *error) {
+    if (!ctx || !key || !config) {
+        if (error) *error = POLY1305_ERROR_NULL_PTR;
+        return false;
+    }
+    if (key_len != POLY1305_KEY_SIZE || config->key_size != POLY1305_KEY_SIZE) {
+        if (error) *error = POLY1305_ERROR_INVALID_KEY_SIZE;
+        return false;
+    }
+    if (config->mac_size == 0 || config->mac_size > POLY1305_MAC_SIZE) {
+        if (error) *error = POLY1305_ERROR_INVALID_MAC_SIZE;
+        return false;
+    }
+
+    // r 按 RFC 8439 清除指定位
+    uint64_t t0 = load_le64(key);
+    uint64_t t1 = load_le64(key + 8);
+    ctx->r[0] = t0 & 0xffc0fffffffULL;
+    ctx->r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffULL;
+    ctx->r[2] = (t1 >> 24) & 0x00ffffffc0fULL;
+    ctx->s[0] = load_le64(key + 16);
+    ctx->s[1] = load_le64(key + 24);
+    ctx->h[0] = ctx->h[1] = ctx->h[2] = 0;
+    ctx->buffer_pos = 0;
+    ctx->config = *config;
+
+    if (error) *error = POLY1305_OK;
+    return true;
+}
+
+bool poly1305_init(poly1305_ctx_t *ctx, const uint8_t *key, size_t key_len, poly1305_error_t *error) {
+    poly1305_config_t config = poly1305_default_config();
+    return poly1305_init_ex(ctx, key, key_len, &config, error);
+}
+
+bool poly1305_update(poly1305_ctx_t *ctx, const uint8_t *msg, size_t msg_len, poly1305_error_t *error) {
+    if (!ctx || (!msg && msg_len > 0)) {
+        if (error) *error = POLY1305_ERROR_NULL_PTR;
+        return false;
+    }
+
+    if (ctx->buffer_pos > 0) {
+        size_t want = 16 - ctx->buffer_pos;
+        if (want > msg_len) want = msg_len;
+        memcpy(ctx->buffer + ctx->buffer_pos, msg, want);
+        ctx->buffer_pos += want;
+        msg += want;
+        msg_len -= want;
+        if (ctx->buffer_pos < 16) {
+            if (error) *error = POLY1305_OK;
+            return true;
+        }
+        poly1305_blocks(ctx, ctx->buffer, 16, 1ULL << 40);
+        ctx->buffer_pos = 0;
+    }
+
+    size_t full = msg_len & ~(size_t)15;
+    if (full > 0) {
+        poly1305_blocks(ctx, msg, full, 1ULL << 40);
+        msg += full;
+        msg_len -= full;
+    }
+
+    if (msg_len > 0) {
+        memcpy(ctx->buffer, msg, msg_len);
+        ctx->buffer_pos = msg_len;
+    }
+
+    if (error) *error = POLY1305_OK;
+    return true;
+}
+
+bool poly1305_final(poly1305_ctx_t *ctx, uint8_t *mac, size_t mac_len, poly1305_error_t *error) {
+    if (!ctx || !mac) {
+        if (error) *error = POLY1305_ERROR_NULL_PTR;
+        return false;
+    }
+    if (mac_len < ctx->config.mac_size) {
+        if (error) *error = POLY1305_ERROR_INVALID_MAC_SIZE;
+        return false;
+    }
+
+    if (ctx->buffer_pos > 0) {
+        ctx->buffer[ctx->buffer_pos] = 1;
+        memset(ctx->buffer + ctx->buffer_pos + 1, 0, 16 - ctx->buffer_pos - 1);
+        poly1305_blocks(ctx, ctx->buffer, 16, 0);
+    }
+
+    uint64_t h0 = ctx->h[0], h1 = ctx->h[1], h2 = ctx->h[2];
+    uint64_t c;
+
+    // 完全进位
+    c = h1 >> 44; h1 &= MASK44;
+    h2 += c; c = h2 >> 42; h2 &= MASK42;
+    h0 += c * 5; c = h0 >> 44; h0 &= MASK44;
+    h1 += c; c = h1 >> 44; h1 &= MASK44;
+    h2 += c; c = h2 >> 42; h2 &= MASK42;
+    h0 += c * 5; c = h0 >> 44; h0 &= MASK44;
+    h1 += c;
+
+    // 计算 h - p, 按符号常数时间选择
+    uint64_t g0 = h0 + 5; c = g0 >> 44; g0 &= MASK44;
+    uint64_t g1 = h1 + c; c = g1 >> 44; g1 &= MASK44;
+    uint64_t g2 = h2 + c - (1ULL << 42);
+
+    uint64_t mask = (g2 >> 63) - 1;
+    g0 &= mask;
+    g1 &= mask;
+    g2 &= mask;
+    mask = ~mask;
+    h0 = (h0 & mask) | g0;
+    h1 = (h1 & mask) | g1;
+    h2 = (h2 & mask) | g2;
+
+    // h = (h + s) mod 2^128
+    uint64_t t0 = ctx->s[0], t1 = ctx->s[1];
+    h0 += t0 & MASK44; c = h0 >> 44; h0 &= MASK44;
+    h1 += (((t0 >> 44) | (t1 << 20)) & MASK44) + c; c = h1 >> 44; h1 &= MASK44;
+    h2 += ((t1 >> 24) & MASK42) + c; h2 &= MASK42;
+
+    uint8_t tag[POLY1305_MAC_SIZE];
+    store_le64(tag, h0 | (h1 << 44));
+    store_le64(tag + 8, (h1 >> 20) | (h2 << 24));
+    memcpy(mac, tag, ctx->config.mac_size);
+
+    // 清除密钥材料
+    memset(ctx->r, 0, sizeof(ctx->r));
+    memset(ctx->s, 0, sizeof(ctx->s));
+    memset(ctx->h, 0, sizeof(ctx->h));
+    memset(ctx->buffer, 0, sizeof(ctx->buffer));
+    ctx->buffer_pos = 0;
+
+    if (error) *error = POLY1305_OK;
+    return true;
+}
+
+bool poly1305_reset(poly1305_ctx_t *ctx, poly1305_error_t *error) {
+    if (!ctx) {
+        if (error) *error = POLY1305_ERROR_NULL_PTR;
+        return false;
+    }
+    ctx->h[0] = ctx->h[1] = ctx->h[2] = 0;
+    memset(ctx->buffer, 0, sizeof(ctx->buffer));
+    ctx->buffer_pos = 0;
+    if (error) *error = POLY1305_OK;
+    return true;
+}
+
+bool poly1305_tiny_ex(const uint8_t *key, size_t key_len, const uint8_t *msg, size_t msg_len, uint8_t *mac,
+                      size_t mac_len, poly1305_error_t *error) {
+    poly1305_ctx_t ctx;
+    return poly1305_init(&ctx, key, key_len, error) &&
+           poly1305_update(&ctx, msg, msg_len, error) &&
+           poly1305_final(&ctx, mac, mac_len, error);
+}
+
 void poly1305_tiny(const uint8_t *key, const uint8_t *msg, size_t len, uint8_t *mac) {
-    // 极简实现：仅演示接口
-    memset(mac, 0, 16);
+    poly1305_tiny_ex(key, POLY1305_KEY_SIZE, msg, len, mac, POLY1305_MAC_SIZE, NULL);
+}
+
+bool poly1305_verify(const uint8_t *key, size_t key_len, const uint8_t *msg, size_t msg_len,
+                     const uint8_t *expected_mac, size_t mac_len, poly1305_error_t *error) {
+    if (!expected_mac) {
+        if (error) *error = POLY1305_ERROR_NULL_PTR;
+        return false;
+    }
+    if (mac_len == 0 || mac_len > POLY1305_MAC_SIZE) {
+        if (error) *error = POLY1305_ERROR_INVALID_MAC_SIZE;
+        return false;
+    }
+
+    uint8_t mac[POLY1305_MAC_SIZE];
+    if (!poly1305_tiny_ex(key, key_len, msg, msg_len, mac, sizeof(mac), error)) {
+        return false;
+    }
+
+    // 常数时间比较
+    uint8_t diff = 0;
+    for (size_t i = 0; i < mac_len; i++) {
+        diff |= (uint8_t)(mac[i] ^ expected_mac[i]);
+    }
+    return diff == 0;
+}
+
+const char* poly1305_error_string(poly1305_error_t error) {
+    switch (error) {
+        case POLY1305_OK: return "Success";
+        case POLY1305_ERROR_NULL_PTR: return "Null pointer";
+        case POLY1305_ERROR_INVALID_KEY_SIZE: return "Invalid key size";
+        case POLY1305_ERROR_INVALID_MSG_SIZE: return "Invalid message size";
+        case POLY1305_ERROR_INVALID_MAC_SIZE: return "Invalid MAC size";
+        default: return "Unknown error";
+    }
 }
@@ -30,9 +30,9 @@ typedef struct {
  * @brief Poly1305 上下文
  */
 typedef struct {
-    uint32_t r[5];                    /**< 密钥的 r 部分 */
-    uint32_t s[4];                    /**< 密钥的 s 部分 */
-    uint32_t h[5];                    /**< 哈希状态 */
+    uint64_t r[3];                    /**< 密钥的 r 部分 (44/44/42 位三段) */
+    uint64_t s[2];                    /**< 密钥的 s 部分 */
+    uint64_t h[3];                    /**< 哈希状态 */
     uint8_t buffer[16];               /**< 消息缓冲区 */
     size_t buffer_pos;                /**< 缓冲区位置 */
     poly1305_config_t config;         /**< 配置 */
@@ -1,4 +1,5 @@
 #include "prim.h"
+#include "graph_heap_internal.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
@@ -18,7 +19,8 @@ prim_config_t prim_default_config(void) {
 
 // 创建图
 prim_graph_t* prim_graph_create(int n, const prim_config_t *config, prim_error_t *error) {
-    if (n <= 0 || n > (int)PRIM_DEFAULT_MAX_NODES) {
+    prim_config_t cfg = config ? *config : prim_default_config();
+    if (n <= 0 || (cfg.max_nodes > 0 && (size_t)n > cfg.max_nodes)) {
         if (error) *error = PRIM_ERROR_TOO_MANY_NODES;
         return NULL;
     }
@@ -31,34 +33,16 @@ prim_graph_t* prim_graph_create(int n, const prim_config_t *config, prim_error_t
     
     g->n = n;
     g->owns_memory = true;
+    g->config = cfg;
     
-    if (config) {
-        g->config = *config;
-    } else {
-        g->config = prim_default_config();
-    }
-    
-    // 分配邻接矩阵
-    g->adj = calloc((size_t)n, sizeof(int*));
+    // 邻接表按需增长, 空表不占用边存储
+    g->adj = calloc((size_t)n, sizeof(prim_adj_list_t));
     if (!g->adj) {
         free(g);
         if (error) *error = PRIM_ERROR_NULL_PTR;
         return NULL;
     }
     
-    for (int i = 0; i < n; i++) {
-        g->adj[i] = calloc((size_t)n, sizeof(int));
-        if (!g->adj[i]) {
-            for (int j = 0; j < i; j++) {
-                free(g->adj[j]);
-            }
-            free(g->adj);
-            free(g);
-            if (error) *error = PRIM_ERROR_NULL_PTR;
-            return NULL;
-        }
-    }
-    
     if (error) *error = PRIM_OK;
     return g;
 }
@@ -69,7 +53,7 @@ void prim_graph_destroy(prim_graph_t *g) {
     
     if (g->adj && g->owns_memory) {
         for (int i = 0; i < g->n; i++) {
-            free(g->adj[i]);
+            free(g->adj[i].items);
         }
         free(g->adj);
     }
@@ -77,6 +61,30 @@ void prim_graph_destroy(prim_graph_t *g) {
     free(g);
 }
 
+// 设置 src -> dest 的权重, 0 表示删除
+static bool prim_adj_set(prim_adj_list_t *list, int dest, int weight) {
+    for (size_t i = 0; i < list->count; i++) {
+        if (list->items[i].dest != dest) continue;
+        if (weight == 0) {
+            list->items[i] = list->items[--list->count];
+        } else {
+            list->items[i].weight = weight;
+        }
+        return true;
+    }
+    if (weight == 0) return true;
+    
+    if (list->count == list->capacity) {
+        size_t capacity = list->capacity ? list->capacity * 2 : 4;
+        prim_adj_entry_t *items = realloc(list->items, capacity * sizeof(prim_adj_entry_t));
+        if (!items) return false;
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = (prim_adj_entry_t){ dest, weight };
+    return true;
+}
+
 // 添加边
 bool prim_graph_add_edge(prim_graph_t *g, int src, int dest, int weight, prim_error_t *error) {
     if (!g || !g->adj) {
@@ -89,10 +97,10 @@ bool prim_graph_add_edge(prim_graph_t *g, int src, int dest, int weight, prim_er
         return false;
     }
     
-    g->adj[src][dest] = weight;
-    
-    if (!g->config.directed) {
-        g->adj[dest][src] = weight;
+    if (!prim_adj_set(&g->adj[src], dest, weight) ||
+        (!g->config.directed && src != dest && !prim_adj_set(&g->adj[dest], src, weight))) {
+        if (error) *error = PRIM_ERROR_NULL_PTR;
+        return false;
     }
     
     if (error) *error = PRIM_OK;
@@ -111,12 +119,33 @@ bool prim_graph_get_edge(const prim_graph_t *g, int src, int dest, int *weight,
         return false;
     }
     
-    *weight = g->adj[src][dest];
+    *weight = 0;
+    const prim_adj_list_t *list = &g->adj[src];
+    for (size_t i = 0; i < list->count; i++) {
+        if (list->items[i].dest == dest) {
+            *weight = list->items[i].weight;
+            break;
+        }
+    }
     
     if (error) *error = PRIM_OK;
     return true;
 }
 
+// 经边 u -> v (权重 w) 更新 v 的键值: 首次看到则入堆, 更小则原地 decrease-key
+// 堆的键为连接到树的最小边权
+static inline void prim_heap_relax(graph_heap_t *h, int *parent, int u, int v, int w) {
+    int pos = h->pos[v];
+    if (pos == GRAPH_POS_DONE) return;
+    if (pos == GRAPH_POS_NONE) {
+        parent[v] = u;
+        graph_heap_push(h, v, w);
+    } else if (w < h->key[pos]) {
+        parent[v] = u;
+        graph_heap_decrease(h, v, w);
+    }
+}
+
 // 计算最小生成树
 int prim_mst(prim_graph_t *g, prim_error_t *error) {
     if (!g) {
@@ -142,85 +171,109 @@ bool prim_mst_ex(prim_graph_t *g, prim_result_t *result, prim_error_t *error) {
         return false;
     }
     
-    int n = g->n;
-    int *parent = malloc((size_t)n * sizeof(int));
-    int *key = malloc((size_t)n * sizeof(int));
-    bool *mst_set = calloc((size_t)n, sizeof(bool));
+    size_t n = (size_t)g->n;
+    graph_heap_t heap;
+    int *parent = malloc(n * sizeof(int));
+    bool compute_edges = g->config.compute_edges;
+    result->edges = compute_edges ? malloc((n > 1 ? n - 1 : 1) * sizeof(prim_edge_t)) : NULL;
+    result->edge_count = 0;
+    result->total_weight = 0;
     
-    if (!parent || !key || !mst_set) {
+    if (!graph_heap_init(&heap, n) || !parent || (compute_edges && !result->edges)) {
+        graph_heap_free(&heap);
         free(parent);
-        free(key);
-        free(mst_set);
+        free(result->edges);
+        result->edges = NULL;
         if (error) *error = PRIM_ERROR_NULL_PTR;
         return false;
     }
     
-    // 初始化
-    for (int i = 0; i < n; i++) {
-        key[i] = g->config.infinity;
-        parent[i] = -1;
-    }
-    key[0] = 0;
-    
-    // 主循环
-    for (int count = 0; count < n - 1; count++) {
-        // 找到最小键值节点
-        int min = g->config.infinity;
-        int u = -1;
-        for (int v = 0; v < n; v++) {
-            if (!mst_set[v] && key[v] < min) {
-                min = key[v];
-                u = v;
+    // 从节点 0 生长, 权重不小于 infinity 的边视为不存在
+    size_t reached = 0;
+    parent[0] = -1;
+    graph_heap_push(&heap, 0, 0);
+    
+    while (heap.size > 0) {
+        int key = heap.key[0];
+        int u = graph_heap_pop(&heap);
+        reached++;
+        if (parent[u] >= 0) {
+            result->total_weight += key;
+            if (compute_edges) {
+                result->edges[result->edge_count++] = (prim_edge_t){ parent[u], u, key };
             }
         }
         
-        if (u == -1) break; // 图不连通
-        
-        mst_set[u] = true;
-        
-        // 更新邻接节点键值
-        for (int v = 0; v < n; v++) {
-            if (g->adj[u][v] && !mst_set[v] && 
-                g->adj[u][v] < key[v] && g->adj[u][v] != 0) {
-                parent[v] = u;
-                key[v] = g->adj[u][v];
+        const prim_adj_list_t *list = &g->adj[u];
+        for (size_t i = 0; i < list->count; i++) {
+            if (list->items[i].weight < g->config.infinity) {
+                prim_heap_relax(&heap, parent, u, list->items[i].dest, list->items[i].weight);
             }
         }
     }
     
-    // 计算总权重
+    result->connected = reached == n;
+    
+    graph_heap_free(&heap);
+    free(parent);
+    
+    if (error) *error = PRIM_OK;
+    return true;
+}
+
+// CSR 最小生成树 (森林)
+bool prim_mst_csr(const graph_csr_t *g, prim_result_t *result, prim_error_t *error) {
+    if (!g || !result) {
+        if (error) *error = PRIM_ERROR_NULL_PTR;
+        return false;
+    }
+    if (g->nodes == 0) {
+        if (error) *error = PRIM_ERROR_INVALID_GRAPH;
+        return false;
+    }
+
+    size_t n = g->nodes;
+    graph_heap_t heap;
+    int *parent = malloc(n * sizeof(int));
+    result->edges = malloc((n > 1 ? n - 1 : 1) * sizeof(prim_edge_t));
+    result->edge_count = 0;
     result->total_weight = 0;
-    for (int i = 1; i < n; i++) {
-        if (parent[i] != -1) {
-            result->total_weight += g->adj[i][parent[i]];
-        }
+    if (!graph_heap_init(&heap, n) || !parent || !result->edges) {
+        graph_heap_free(&heap);
+        free(parent);
+        free(result->edges);
+        result->edges = NULL;
+        if (error) *error = PRIM_ERROR_NULL_PTR;
+        return false;
     }
-    
-    // 填充边信息
-    if (g->config.compute_edges) {
-        result->edges = calloc((size_t)(n - 1), sizeof(prim_edge_t));
-        if (result->edges) {
-            result->edge_count = 0;
-            for (int i = 1; i < n; i++) {
-                if (parent[i] != -1) {
-                    result->edges[result->edge_count].src = parent[i];
-                    result->edges[result->edge_count].dest = i;
-                    result->edges[result->edge_count].weight = g->adj[i][parent[i]];
-                    result->edge_count++;
-                }
+
+    // 每个未访问节点作为新树的根, 得到最小生成森林
+    for (size_t root = 0; root < n; root++) {
+        if (heap.pos[root] != GRAPH_POS_NONE) continue;
+        parent[root] = -1;
+        graph_heap_push(&heap, (int)root, 0);
+
+        while (heap.size > 0) {
+            int key = heap.key[0];
+            int u = graph_heap_pop(&heap);
+            if (parent[u] >= 0) {
+                result->edges[result->edge_count++] = (prim_edge_t){ parent[u], u, key };
+                result->total_weight += key;
+            }
+
+            const int *to, *weight;
+            size_t degree = graph_csr_neighbors(g, u, &to, &weight);
+            for (size_t i = 0; i < degree; i++) {
+                prim_heap_relax(&heap, parent, u, to[i], weight[i]);
             }
         }
-    } else {
-        result->edges = NULL;
-        result->edge_count = 0;
     }
-    
-    result->connected = (result->edge_count == (size_t)(n - 1));
-    
+
+    result->connected = result->edge_count + 1 == n;
+
+    graph_heap_free(&heap);
     free(parent);
-    free(key);
-    free(mst_set);
-    
+
     if (error) *error = PRIM_OK;
     return true;
 }
@@ -249,17 +302,24 @@ bool prim_graph_is_connected(const prim_graph_t *g, prim_error_t *error) {
         return false;
     }
     
-    // BFS/DFS 检查连通性
-    int stack[g->n];
+    int *stack = malloc((size_t)g->n * sizeof(int));
+    if (!stack) {
+        free(visited);
+        if (error) *error = PRIM_ERROR_NULL_PTR;
+        return false;
+    }
+    
+    // DFS 检查连通性
     int top = 0;
     stack[top++] = 0;
     visited[0] = true;
     int visited_count = 1;
     
     while (top > 0) {
-        int u = stack[--top];
-        for (int v = 0; v < g->n; v++) {
-            if (g->adj[u][v] && !visited[v]) {
+        const prim_adj_list_t *list = &g->adj[stack[--top]];
+        for (size_t i = 0; i < list->count; i++) {
+            int v = list->items[i].dest;
+            if (!visited[v]) {
                 visited[v] = true;
                 stack[top++] = v;
                 visited_count++;
@@ -267,6 +327,7 @@ bool prim_graph_is_connected(const prim_graph_t *g, prim_error_t *error) {
         }
     }
     
+    free(stack);
     free(visited);
     
     if (error) *error = PRIM_OK;
@@ -287,10 +348,8 @@ void prim_graph_print(const prim_graph_t *g) {
     
     printf("Graph (%d nodes):\n", g->n);
     for (int i = 0; i < g->n; i++) {
-        for (int j = 0; j < g->n; j++) {
-            if (g->adj[i][j]) {
-                printf("  %d -> %d: %d\n", i, j, g->adj[i][j]);
-            }
+        for (size_t k = 0; k < g->adj[i].count; k++) {
+            printf("  %d -> %d: %d\n", i, g->adj[i].items[k].dest, g->adj[i].items[k].weight);
         }
     }
 }
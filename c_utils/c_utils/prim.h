@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include "graph_csr.h"
 
 /**
  * @brief Prim 算法错误码
@@ -46,11 +47,28 @@ typedef struct {
 } prim_result_t;
 
 /**
- * @brief 图结构
+ * @brief 邻接表项
+ */
+typedef struct {
+    int dest;                     /**< 目标节点 */
+    int weight;                   /**< 边权重 */
+} prim_adj_entry_t;
+
+/**
+ * @brief 单个节点的出边表
+ */
+typedef struct {
+    prim_adj_entry_t *items;      /**< 出边数组 */
+    size_t count;                 /**< 出边数 */
+    size_t capacity;              /**< 容量 */
+} prim_adj_list_t;
+
+/**
+ * @brief 图结构 (邻接表, 内存为 O(V + E))
  */
 typedef struct {
     int n;                        /**< 节点数 */
-    int **adj;                    /**< 邻接矩阵 */
+    prim_adj_list_t *adj;         /**< 每个节点的出边表 */
     prim_config_t config;         /**< 配置 */
     bool owns_memory;             /**< 是否拥有内存 */
 } prim_graph_t;
@@ -58,7 +76,7 @@ typedef struct {
 /**
  * @brief 默认最大节点数
  */
-#define PRIM_DEFAULT_MAX_NODES 100
+#define PRIM_DEFAULT_MAX_NODES 1000000
 
 /**
  * @brief 默认无穷大值
@@ -73,7 +91,7 @@ prim_config_t prim_default_config(void);
 
 /**
  * @brief 创建图
- * @param n 节点数
+ * @param n 节点数, 不超过 config->max_nodes (为 0 时不限制)
  * @param config 配置选项
  * @param error 错误码输出
  * @return 图结构，失败返回 NULL
@@ -87,7 +105,7 @@ prim_graph_t* prim_graph_create(int n, const prim_config_t *config, prim_error_t
 void prim_graph_destroy(prim_graph_t *g);
 
 /**
- * @brief 添加边
+ * @brief 添加边, 已存在的边更新权重, 权重为 0 时删除该边
  * @param g 图结构
  * @param src 源节点
  * @param dest 目标节点
@@ -102,7 +120,7 @@ bool prim_graph_add_edge(prim_graph_t *g, int src, int dest, int weight, prim_er
  * @param g 图结构
  * @param src 源节点
  * @param dest 目标节点
- * @param weight 权重输出
+ * @param weight 权重输出, 无边时为 0
  * @param error 错误码输出
  * @return 是否成功
  */
@@ -118,6 +136,7 @@ int prim_mst(prim_graph_t *g, prim_error_t *error);
 
 /**
  * @brief 计算最小生成树（带详细结果）
+ * 从节点 0 出发, 索引四叉堆维护到树的最小边, O(E log V); 图不连通时只包含节点 0 所在的树
  * @param g 图结构
  * @param result 结果输出
  * @param error 错误码输出
@@ -125,6 +144,15 @@ int prim_mst(prim_graph_t *g, prim_error_t *error);
  */
 bool prim_mst_ex(prim_graph_t *g, prim_result_t *result, prim_error_t *error);
 
+/**
+ * @brief CSR 图上的最小生成树 (索引四叉堆, 松弛时原地 decrease-key), O(E log V)
+ * @param g CSR 图, 无向图每条边需存两个方向
+ * @param result 结果输出, 总是包含 MST 边; 图不连通时为最小生成森林, connected 为 false
+ * @param error 错误码输出
+ * @return 是否成功
+ */
+bool prim_mst_csr(const graph_csr_t *g, prim_result_t *result, prim_error_t *error);
+
 /**
  * @brief 释放结果
  * @param result 结果结构
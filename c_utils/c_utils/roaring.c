@@ -0,0 +1,1335 @@
+#include "roaring.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define ROARING_HAVE_AVX2 1
+#endif
+
+#define RC_ARRAY 1
+#define RC_BITMAP 2
+#define RC_RUN 3
+
+#define RC_ARRAY_MAX 4096
+#define RC_WORDS 1024
+#define RC_BITMAP_BYTES (RC_WORDS * sizeof(uint64_t))
+#define RC_GALLOP_RATIO 64
+#define RC_BULK_BITMAP 512
+
+// 可移植格式常量 (RoaringFormatSpec)
+#define SERIAL_COOKIE_NO_RUN 12346
+#define SERIAL_COOKIE 12347
+#define NO_OFFSET_THRESHOLD 4
+
+// 行程: 覆盖 [start, start + len]
+typedef struct {
+    uint16_t start;
+    uint16_t len;
+} rc_run_t;
+
+// 容器: 一个 16 位块内的元素
+typedef struct {
+    uint8_t type;
+    uint32_t card;  // 元素个数 (1..65536)
+    uint32_t n;     // 数组元素数或行程数
+    uint32_t cap;   // 数组或行程的容量
+    union {
+        void *data;
+        uint16_t *array;
+        uint64_t *words;
+        rc_run_t *runs;
+    };
+} rc_t;
+
+struct roaring_s {
+    uint16_t *keys;
+    rc_t *cs;
+    size_t size;
+    size_t cap;
+};
+
+typedef enum {
+    RC_OP_AND,
+    RC_OP_OR,
+    RC_OP_XOR,
+    RC_OP_ANDNOT
+} rc_op_t;
+
+// ---------------------------------------------------------------- 位图字运算
+
+#define RC_WORDS_LOOP(expr)                                 \
+    for (int i = 0; i < RC_WORDS; i++) {                    \
+        uint64_t w = (expr);                                \
+        if (out) out[i] = w;                                \
+        card += (uint32_t)__builtin_popcountll(w);          \
+    }
+
+// out 为 NULL 时只计数; out 可以与 a 相同
+static uint32_t words_op_scalar(uint64_t *out, const uint64_t *a, const uint64_t *b, rc_op_t op) {
+    uint32_t card = 0;
+    switch (op) {
+    case RC_OP_AND: RC_WORDS_LOOP(a[i] & b[i]); break;
+    case RC_OP_OR: RC_WORDS_LOOP(a[i] | b[i]); break;
+    case RC_OP_XOR: RC_WORDS_LOOP(a[i] ^ b[i]); break;
+    case RC_OP_ANDNOT: RC_WORDS_LOOP(a[i] & ~b[i]); break;
+    }
+    return card;
+}
+
+static uint32_t words_card_scalar(const uint64_t *w, uint32_t nwords) {
+    uint32_t card = 0;
+    for (uint32_t i = 0; i < nwords; i++) card += (uint32_t)__builtin_popcountll(w[i]);
+    return card;
+}
+
+// 第 idx 个置位的位置 (idx 小于位图基数)
+static uint32_t words_select_scalar(const uint64_t *w, uint32_t idx) {
+    for (uint32_t i = 0; i < RC_WORDS; i++) {
+        uint32_t pc = (uint32_t)__builtin_popcountll(w[i]);
+        if (idx < pc) {
+            uint64_t bits = w[i];
+            while (idx--) bits &= bits - 1;
+            return i * 64 + (uint32_t)__builtin_ctzll(bits);
+        }
+        idx -= pc;
+    }
+    return 0;
+}
+
+#ifdef ROARING_HAVE_AVX2
+#define RC_AVX2_LOOP(expr)                                                              \
+    for (int i = 0; i < RC_WORDS; i += 4) {                                             \
+        __m256i x = _mm256_loadu_si256((const __m256i *)(a + i));                       \
+        __m256i y = _mm256_loadu_si256((const __m256i *)(b + i));                       \
+        __m256i w = (expr);                                                             \
+        if (out) _mm256_storeu_si256((__m256i *)(out + i), w);                          \
+        card += _mm_popcnt_u64((uint64_t)_mm256_extract_epi64(w, 0)) +                  \
+                _mm_popcnt_u64((uint64_t)_mm256_extract_epi64(w, 1)) +                  \
+                _mm_popcnt_u64((uint64_t)_mm256_extract_epi64(w, 2)) +                  \
+                _mm_popcnt_u64((uint64_t)_mm256_extract_epi64(w, 3));                   \
+    }
+
+// AVX2: 一次处理 256 位, popcnt 指令计数
+__attribute__((target("avx2,popcnt")))
+static uint32_t words_op_avx2(uint64_t *out, const uint64_t *a, const uint64_t *b, rc_op_t op) {
+    uint64_t card = 0;
+    switch (op) {
+    case RC_OP_AND: RC_AVX2_LOOP(_mm256_and_si256(x, y)); break;
+    case RC_OP_OR: RC_AVX2_LOOP(_mm256_or_si256(x, y)); break;
+    case RC_OP_XOR: RC_AVX2_LOOP(_mm256_xor_si256(x, y)); break;
+    case RC_OP_ANDNOT: RC_AVX2_LOOP(_mm256_andnot_si256(y, x)); break;
+    }
+    return (uint32_t)card;
+}
+
+__attribute__((target("popcnt")))
+static uint32_t words_card_popcnt(const uint64_t *w, uint32_t nwords) {
+    uint64_t card = 0;
+    for (uint32_t i = 0; i < nwords; i++) card += _mm_popcnt_u64(w[i]);
+    return (uint32_t)card;
+}
+
+__attribute__((target("popcnt")))
+static uint32_t words_select_popcnt(const uint64_t *w, uint32_t idx) {
+    for (uint32_t i = 0; i < RC_WORDS; i++) {
+        uint32_t pc = (uint32_t)_mm_popcnt_u64(w[i]);
+        if (idx < pc) {
+            uint64_t bits = w[i];
+            while (idx--) bits &= bits - 1;
+            return i * 64 + (uint32_t)__builtin_ctzll(bits);
+        }
+        idx -= pc;
+    }
+    return 0;
+}
+
+static inline bool use_avx2(void) {
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+}
+#endif
+
+static uint32_t words_op(uint64_t *out, const uint64_t *a, const uint64_t *b, rc_op_t op) {
+#ifdef ROARING_HAVE_AVX2
+    if (use_avx2()) return words_op_avx2(out, a, b, op);
+#endif
+    return words_op_scalar(out, a, b, op);
+}
+
+// 前 nwords 个字的置位数
+static uint32_t words_card(const uint64_t *w, uint32_t nwords) {
+#ifdef ROARING_HAVE_AVX2
+    if (use_avx2()) return words_card_popcnt(w, nwords);
+#endif
+    return words_card_scalar(w, nwords);
+}
+
+static uint32_t words_select(const uint64_t *w, uint32_t idx) {
+#ifdef ROARING_HAVE_AVX2
+    if (use_avx2()) return words_select_popcnt(w, idx);
+#endif
+    return words_select_scalar(w, idx);
+}
+
+// 置位 [lo, hi]
+static void words_set_range(uint64_t *w, uint32_t lo, uint32_t hi) {
+    uint32_t fw = lo >> 6, lw = hi >> 6;
+    uint64_t fm = ~0ull << (lo & 63), lm = ~0ull >> (63 - (hi & 63));
+    if (fw == lw) {
+        w[fw] |= fm & lm;
+        return;
+    }
+    w[fw] |= fm;
+    for (uint32_t i = fw + 1; i < lw; i++) w[i] = ~0ull;
+    w[lw] |= lm;
+}
+
+static inline bool words_test(const uint64_t *w, uint16_t v) {
+    return (w[v >> 6] >> (v & 63)) & 1;
+}
+
+// 位图中的行程数: 每个 1 前面是 0 的位置开始一个行程
+static uint32_t words_run_count(const uint64_t *w) {
+    uint32_t runs = 0;
+    uint64_t carry = 0;
+    for (int i = 0; i < RC_WORDS; i++) {
+        runs += (uint32_t)__builtin_popcountll(w[i] & ~((w[i] << 1) | carry));
+        carry = w[i] >> 63;
+    }
+    return runs;
+}
+
+// ---------------------------------------------------------------- 有序数组工具
+
+// 第一个 >= v 的位置; 无分支二分, 随机查找时避免分支预测失败
+static uint32_t array_lower_bound(const uint16_t *a, uint32_t n, uint16_t v) {
+    if (n == 0) return 0;
+    const uint16_t *base = a;
+    while (n > 1) {
+        uint32_t half = n / 2;
+        base = base[half] < v ? base + half : base;
+        n -= half;
+    }
+    return (uint32_t)(base - a) + (*base < v);
+}
+
+// 从 pos 开始倍增查找第一个 >= v 的位置
+static uint32_t array_gallop(const uint16_t *a, uint32_t n, uint32_t pos, uint16_t v) {
+    uint32_t step = 1, lo = pos, hi = pos;
+    while (hi < n && a[hi] < v) {
+        lo = hi + 1;
+        hi = pos + step;
+        step *= 2;
+    }
+    if (hi > n) hi = n;
+    return lo + array_lower_bound(a + lo, hi - lo, v);
+}
+
+// 交集, out 为 NULL 时只计数
+static uint32_t array_intersect(const uint16_t *a, uint32_t na, const uint16_t *b, uint32_t nb, uint16_t *out) {
+    uint32_t k = 0;
+    if (na > nb) {
+        const uint16_t *t = a;
+        a = b;
+        b = t;
+        uint32_t tn = na;
+        na = nb;
+        nb = tn;
+    }
+    if (na == 0) return 0;
+    if (nb / na >= RC_GALLOP_RATIO) {
+        // 两边大小悬殊时, 用小数组的每个元素在大数组里倍增查找
+        uint32_t j = 0;
+        for (uint32_t i = 0; i < na && j < nb; i++) {
+            j = array_gallop(b, nb, j, a[i]);
+            if (j < nb && b[j] == a[i]) {
+                if (out) out[k] = a[i];
+                k++;
+            }
+        }
+        return k;
+    }
+    uint32_t i = 0, j = 0;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            i++;
+        } else if (a[i] > b[j]) {
+            j++;
+        } else {
+            if (out) out[k] = a[i];
+            k++;
+            i++;
+            j++;
+        }
+    }
+    return k;
+}
+
+// 并集 / 对称差 / 差集的归并
+static uint32_t array_merge(const uint16_t *a, uint32_t na, const uint16_t *b, uint32_t nb, uint16_t *out, rc_op_t op) {
+    uint32_t i = 0, j = 0, k = 0;
+    bool keep_a = op != RC_OP_AND, keep_b = op == RC_OP_OR || op == RC_OP_XOR, keep_both = op == RC_OP_OR;
+    while (i < na && j < nb) {
+        if (a[i] < b[j]) {
+            if (keep_a) out[k++] = a[i];
+            i++;
+        } else if (a[i] > b[j]) {
+            if (keep_b) out[k++] = b[j];
+            j++;
+        } else {
+            if (keep_both) out[k++] = a[i];
+            i++;
+            j++;
+        }
+    }
+    if (keep_a) {
+        memcpy(out + k, a + i, (na - i) * sizeof(uint16_t));
+        k += na - i;
+    }
+    if (keep_b) {
+        memcpy(out + k, b + j, (nb - j) * sizeof(uint16_t));
+        k += nb - j;
+    }
+    return k;
+}
+
+// ---------------------------------------------------------------- 容器
+
+static void rc_free(rc_t *c) {
+    free(c->data);
+    c->data = NULL;
+    c->n = c->cap = c->card = 0;
+}
+
+static bool rc_reserve(rc_t *c, uint32_t need) {
+    if (need <= c->cap) return true;
+    uint32_t cap = c->cap ? c->cap : 4;
+    while (cap < need) cap *= 2;
+    size_t elem = c->type == RC_RUN ? sizeof(rc_run_t) : sizeof(uint16_t);
+    void *p = realloc(c->data, cap * elem);
+    if (!p) return false;
+    c->data = p;
+    c->cap = cap;
+    return true;
+}
+
+static bool rc_init_array(rc_t *c, uint32_t cap) {
+    memset(c, 0, sizeof(*c));
+    c->type = RC_ARRAY;
+    return rc_reserve(c, cap ? cap : 1);
+}
+
+static bool rc_init_bitmap(rc_t *c) {
+    memset(c, 0, sizeof(*c));
+    c->type = RC_BITMAP;
+    c->words = calloc(RC_WORDS, sizeof(uint64_t));
+    return c->words != NULL;
+}
+
+// 把任意容器的内容写入已清零的位图
+static void rc_fill_words(const rc_t *c, uint64_t *w) {
+    if (c->type == RC_BITMAP) {
+        memcpy(w, c->words, RC_BITMAP_BYTES);
+    } else if (c->type == RC_ARRAY) {
+        for (uint32_t i = 0; i < c->n; i++) w[c->array[i] >> 6] |= 1ull << (c->array[i] & 63);
+    } else {
+        for (uint32_t i = 0; i < c->n; i++) words_set_range(w, c->runs[i].start, c->runs[i].start + c->runs[i].len);
+    }
+}
+
+// 把任意容器的内容写入数组 (容量至少为 card)
+static void rc_fill_array(const rc_t *c, uint16_t *out) {
+    uint32_t k = 0;
+    if (c->type == RC_ARRAY) {
+        memcpy(out, c->array, c->n * sizeof(uint16_t));
+    } else if (c->type == RC_BITMAP) {
+        for (uint32_t i = 0; i < RC_WORDS; i++) {
+            uint64_t w = c->words[i];
+            while (w) {
+                out[k++] = (uint16_t)(i * 64 + (uint32_t)__builtin_ctzll(w));
+                w &= w - 1;
+            }
+        }
+    } else {
+        for (uint32_t i = 0; i < c->n; i++) {
+            for (uint32_t v = c->runs[i].start; v <= (uint32_t)c->runs[i].start + c->runs[i].len; v++) out[k++] = (uint16_t)v;
+        }
+    }
+}
+
+static bool rc_convert_bitmap(rc_t *c) {
+    uint64_t *w = calloc(RC_WORDS, sizeof(uint64_t));
+    if (!w) return false;
+    rc_fill_words(c, w);
+    free(c->data);
+    c->words = w;
+    c->type = RC_BITMAP;
+    c->n = c->cap = 0;
+    return true;
+}
+
+static bool rc_convert_array(rc_t *c) {
+    uint16_t *a = malloc((c->card ? c->card : 1) * sizeof(uint16_t));
+    if (!a) return false;
+    rc_fill_array(c, a);
+    free(c->data);
+    c->array = a;
+    c->type = RC_ARRAY;
+    c->n = c->cap = c->card;
+    return true;
+}
+
+static uint32_t rc_run_count(const rc_t *c) {
+    if (c->type == RC_RUN) return c->n;
+    if (c->type == RC_BITMAP) return words_run_count(c->words);
+    uint32_t runs = c->n ? 1 : 0;
+    for (uint32_t i = 1; i < c->n; i++) runs += c->array[i] != c->array[i - 1] + 1;
+    return runs;
+}
+
+static bool rc_convert_run(rc_t *c, uint32_t nruns) {
+    rc_run_t *runs = malloc((nruns ? nruns : 1) * sizeof(rc_run_t));
+    if (!runs) return false;
+    uint32_t k = 0;
+    if (c->type == RC_ARRAY) {
+        for (uint32_t i = 0; i < c->n; i++) {
+            if (k > 0 && c->array[i] == runs[k - 1].start + runs[k - 1].len + 1) {
+                runs[k - 1].len++;
+            } else {
+                runs[k].start = c->array[i];
+                runs[k++].len = 0;
+            }
+        }
+    } else {
+        // 逐字跳过全 0 / 全 1 的区域找行程边界
+        uint32_t i = 0;
+        uint64_t cur = c->words[0];
+        for (;;) {
+            while (cur == 0 && i + 1 < RC_WORDS) cur = c->words[++i];
+            if (cur == 0) break;
+            uint32_t start = i * 64 + (uint32_t)__builtin_ctzll(cur);
+            uint64_t ones = cur | (cur - 1);
+            while (ones == ~0ull && i + 1 < RC_WORDS) ones = c->words[++i];
+            runs[k].start = (uint16_t)start;
+            if (ones == ~0ull) {
+                runs[k++].len = (uint16_t)(65535 - start);
+                break;
+            }
+            runs[k++].len = (uint16_t)(i * 64 + (uint32_t)__builtin_ctzll(~ones) - 1 - start);
+            cur = ones & (ones + 1);
+        }
+    }
+    free(c->data);
+    c->runs = runs;
+    c->type = RC_RUN;
+    c->n = c->cap = k;
+    return true;
+}
+
+// 按序列化大小选择最小的表示
+// 返回: 转换成行程容器返回 true
+static bool rc_optimize(rc_t *c) {
+    uint32_t nruns = rc_run_count(c);
+    size_t run_bytes = 2 + 4 * (size_t)nruns;
+    size_t other_bytes = c->card <= RC_ARRAY_MAX ? 2 * (size_t)c->card : RC_BITMAP_BYTES;
+    if (run_bytes < other_bytes) {
+        if (c->type == RC_RUN) return false;
+        return rc_convert_run(c, nruns);
+    }
+    if (c->card <= RC_ARRAY_MAX) {
+        if (c->type != RC_ARRAY) rc_convert_array(c);
+    } else if (c->type != RC_BITMAP) {
+        rc_convert_bitmap(c);
+    }
+    return false;
+}
+
+// 位图元素减少到数组上限以下时转换为数组
+static void rc_normalize(rc_t *c) {
+    if (c->card == 0) {
+        rc_free(c);
+        c->type = RC_ARRAY;
+    } else if (c->type == RC_BITMAP && c->card <= RC_ARRAY_MAX) {
+        rc_convert_array(c);
+    }
+}
+
+static bool rc_clone(rc_t *dst, const rc_t *src) {
+    *dst = *src;
+    size_t bytes = src->type == RC_BITMAP ? RC_BITMAP_BYTES
+                 : src->type == RC_RUN ? src->n * sizeof(rc_run_t) : src->n * sizeof(uint16_t);
+    dst->data = malloc(bytes ? bytes : 1);
+    if (!dst->data) return false;
+    memcpy(dst->data, src->data, bytes);
+    if (src->type != RC_BITMAP) dst->cap = src->n;
+    return true;
+}
+
+// 最后一个 start <= v 的行程, 没有返回 -1
+static int32_t run_find(const rc_t *c, uint16_t v) {
+    int32_t lo = 0, hi = (int32_t)c->n - 1, ans = -1;
+    while (lo <= hi) {
+        int32_t mid = (lo + hi) / 2;
+        if (c->runs[mid].start <= v) {
+            ans = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return ans;
+}
+
+static bool rc_contains(const rc_t *c, uint16_t v) {
+    if (c->type == RC_BITMAP) return words_test(c->words, v);
+    if (c->type == RC_ARRAY) {
+        uint32_t pos = array_lower_bound(c->array, c->n, v);
+        return pos < c->n && c->array[pos] == v;
+    }
+    int32_t i = run_find(c, v);
+    return i >= 0 && v <= (uint32_t)c->runs[i].start + c->runs[i].len;
+}
+
+// 行程容器的增删可能让它不再是最小的表示
+static void rc_run_check(rc_t *c) {
+    size_t other = c->card <= RC_ARRAY_MAX ? 2 * (size_t)c->card : RC_BITMAP_BYTES;
+    if (2 + 4 * (size_t)c->n > other) rc_optimize(c);
+}
+
+// 返回: 1 新增, 0 已存在, -1 内存不足
+static int rc_add(rc_t *c, uint16_t v) {
+    if (c->type == RC_ARRAY) {
+        uint32_t pos = array_lower_bound(c->array, c->n, v);
+        if (pos < c->n && c->array[pos] == v) return 0;
+        if (c->n >= RC_ARRAY_MAX) {
+            if (!rc_convert_bitmap(c)) return -1;
+        } else {
+            if (!rc_reserve(c, c->n + 1)) return -1;
+            memmove(c->array + pos + 1, c->array + pos, (c->n - pos) * sizeof(uint16_t));
+            c->array[pos] = v;
+            c->n++;
+            c->card++;
+            return 1;
+        }
+    }
+    if (c->type == RC_BITMAP) {
+        uint64_t bit = 1ull << (v & 63);
+        if (c->words[v >> 6] & bit) return 0;
+        c->words[v >> 6] |= bit;
+        c->card++;
+        return 1;
+    }
+
+    int32_t i = run_find(c, v);
+    if (i >= 0 && v <= (uint32_t)c->runs[i].start + c->runs[i].len) return 0;
+    bool ext_prev = i >= 0 && v == (uint32_t)c->runs[i].start + c->runs[i].len + 1;
+    bool ext_next = (uint32_t)(i + 1) < c->n && v + 1u == c->runs[i + 1].start;
+    if (ext_prev && ext_next) {
+        c->runs[i].len = (uint16_t)(c->runs[i + 1].start + c->runs[i + 1].len - c->runs[i].start);
+        memmove(c->runs + i + 1, c->runs + i + 2, (c->n - (uint32_t)i - 2) * sizeof(rc_run_t));
+        c->n--;
+    } else if (ext_prev) {
+        c->runs[i].len++;
+    } else if (ext_next) {
+        c->runs[i + 1].start--;
+        c->runs[i + 1].len++;
+    } else {
+        if (!rc_reserve(c, c->n + 1)) return -1;
+        memmove(c->runs + i + 2, c->runs + i + 1, (c->n - (uint32_t)(i + 1)) * sizeof(rc_run_t));
+        c->runs[i + 1].start = v;
+        c->runs[i + 1].len = 0;
+        c->n++;
+    }
+    c->card++;
+    rc_run_check(c);
+    return 1;
+}
+
+// 返回: 1 删除, 0 不存在, -1 内存不足
+static int rc_remove(rc_t *c, uint16_t v) {
+    if (c->type == RC_ARRAY) {
+        uint32_t pos = array_lower_bound(c->array, c->n, v);
+        if (pos >= c->n || c->array[pos] != v) return 0;
+        memmove(c->array + pos, c->array + pos + 1, (c->n - pos - 1) * sizeof(uint16_t));
+        c->n--;
+        c->card--;
+        return 1;
+    }
+    if (c->type == RC_BITMAP) {
+        uint64_t bit = 1ull << (v & 63);
+        if (!(c->words[v >> 6] & bit)) return 0;
+        c->words[v >> 6] &= ~bit;
+        c->card--;
+        rc_normalize(c);
+        return 1;
+    }
+
+    int32_t i = run_find(c, v);
+    if (i < 0) return 0;
+    uint32_t start = c->runs[i].start, end = start + c->runs[i].len;
+    if (v > end) return 0;
+    if (start == end) {
+        memmove(c->runs + i, c->runs + i + 1, (c->n - (uint32_t)i - 1) * sizeof(rc_run_t));
+        c->n--;
+    } else if (v == start) {
+        c->runs[i].start++;
+        c->runs[i].len--;
+    } else if (v == end) {
+        c->runs[i].len--;
+    } else {
+        if (!rc_reserve(c, c->n + 1)) return -1;
+        memmove(c->runs + i + 2, c->runs + i + 1, (c->n - (uint32_t)i - 1) * sizeof(rc_run_t));
+        c->runs[i].len = (uint16_t)(v - 1 - start);
+        c->runs[i + 1].start = (uint16_t)(v + 1);
+        c->runs[i + 1].len = (uint16_t)(end - v - 1);
+        c->n++;
+    }
+    c->card--;
+    if (c->card > 0) rc_run_check(c);
+    return 1;
+}
+
+// 置入 [lo, hi]
+static bool rc_add_range(rc_t *c, uint32_t lo, uint32_t hi) {
+    if (lo == 0 && hi == 65535) {
+        rc_free(c);
+        c->type = RC_RUN;
+        if (!rc_reserve(c, 1)) return false;
+        c->runs[0].start = 0;
+        c->runs[0].len = 65535;
+        c->n = 1;
+        c->card = 65536;
+        return true;
+    }
+    if (c->type != RC_BITMAP && !rc_convert_bitmap(c)) return false;
+    words_set_range(c->words, lo, hi);
+    c->card = words_card(c->words, RC_WORDS);
+    rc_optimize(c);
+    return true;
+}
+
+// 小于等于 v 的元素个数
+static uint32_t rc_rank(const rc_t *c, uint16_t v) {
+    if (c->type == RC_ARRAY) {
+        uint32_t pos = array_lower_bound(c->array, c->n, v);
+        return pos + (pos < c->n && c->array[pos] == v);
+    }
+    if (c->type == RC_BITMAP) {
+        uint32_t w = v >> 6, rank = words_card(c->words, w);
+        uint64_t mask = (v & 63) == 63 ? ~0ull : (2ull << (v & 63)) - 1;
+        return rank + (uint32_t)__builtin_popcountll(c->words[w] & mask);
+    }
+    uint32_t rank = 0;
+    for (uint32_t i = 0; i < c->n && c->runs[i].start <= v; i++) {
+        uint32_t end = (uint32_t)c->runs[i].start + c->runs[i].len;
+        rank += (v < end ? v : end) - c->runs[i].start + 1;
+    }
+    return rank;
+}
+
+// 第 idx 个元素 (idx < card)
+static uint16_t rc_select(const rc_t *c, uint32_t idx) {
+    if (c->type == RC_ARRAY) return c->array[idx];
+    if (c->type == RC_BITMAP) return (uint16_t)words_select(c->words, idx);
+    for (uint32_t i = 0; i < c->n; i++) {
+        uint32_t len = (uint32_t)c->runs[i].len + 1;
+        if (idx < len) return (uint16_t)(c->runs[i].start + idx);
+        idx -= len;
+    }
+    return 0;
+}
+
+// 行程容器按基数转成临时数组或位图, 其他容器直接借用
+static bool rc_materialize(const rc_t *src, rc_t *tmp, bool *owned) {
+    *owned = false;
+    if (src->type != RC_RUN) {
+        *tmp = *src;
+        return true;
+    }
+    *owned = true;
+    if (src->card <= RC_ARRAY_MAX) {
+        if (!rc_init_array(tmp, src->card)) return false;
+        rc_fill_array(src, tmp->array);
+        tmp->n = tmp->card = src->card;
+        return true;
+    }
+    if (!rc_init_bitmap(tmp)) return false;
+    rc_fill_words(src, tmp->words);
+    tmp->card = src->card;
+    return true;
+}
+
+// 数组 op 数组
+static bool rc_op_aa(const rc_t *a, const rc_t *b, rc_op_t op, rc_t *out) {
+    uint32_t cap = op == RC_OP_AND ? (a->n < b->n ? a->n : b->n) : op == RC_OP_ANDNOT ? a->n : a->n + b->n;
+    if (!rc_init_array(out, cap)) return false;
+    if (op == RC_OP_AND) {
+        out->n = array_intersect(a->array, a->n, b->array, b->n, out->array);
+    } else {
+        out->n = array_merge(a->array, a->n, b->array, b->n, out->array, op);
+    }
+    out->card = out->n;
+    if (out->card > RC_ARRAY_MAX) return rc_convert_bitmap(out);
+    rc_normalize(out);
+    return true;
+}
+
+// 位图 op 位图
+static bool rc_op_bb(const rc_t *a, const rc_t *b, rc_op_t op, rc_t *out) {
+    if (!rc_init_bitmap(out)) return false;
+    out->card = words_op(out->words, a->words, b->words, op);
+    rc_normalize(out);
+    return true;
+}
+
+// 数组 op 位图; swapped 表示原始顺序是位图 op 数组 (只影响差集)
+static bool rc_op_ab(const rc_t *arr, const rc_t *bm, rc_op_t op, bool swapped, rc_t *out) {
+    if (op == RC_OP_AND || (op == RC_OP_ANDNOT && !swapped)) {
+        // 结果是数组的子集: 按位图过滤
+        if (!rc_init_array(out, arr->n)) return false;
+        bool want = op == RC_OP_AND;
+        for (uint32_t i = 0; i < arr->n; i++) {
+            if (words_test(bm->words, arr->array[i]) == want) out->array[out->n++] = arr->array[i];
+        }
+        out->card = out->n;
+        rc_normalize(out);
+        return true;
+    }
+    if (!rc_init_bitmap(out)) return false;
+    memcpy(out->words, bm->words, RC_BITMAP_BYTES);
+    out->card = bm->card;
+    for (uint32_t i = 0; i < arr->n; i++) {
+        uint16_t v = arr->array[i];
+        uint64_t bit = 1ull << (v & 63), *w = &out->words[v >> 6];
+        bool had = *w & bit;
+        if (op == RC_OP_OR) {
+            *w |= bit;
+            out->card += !had;
+        } else if (op == RC_OP_XOR) {
+            *w ^= bit;
+            out->card += had ? (uint32_t)-1 : 1;
+        } else {
+            *w &= ~bit;
+            out->card -= had;
+        }
+    }
+    rc_normalize(out);
+    return true;
+}
+
+static bool rc_binop(const rc_t *a, const rc_t *b, rc_op_t op, rc_t *out) {
+    rc_t ta, tb;
+    bool oa, ob, ok = false;
+    memset(out, 0, sizeof(*out));
+    if (!rc_materialize(a, &ta, &oa)) return false;
+    if (rc_materialize(b, &tb, &ob)) {
+        if (ta.type == RC_BITMAP && tb.type == RC_BITMAP) ok = rc_op_bb(&ta, &tb, op, out);
+        else if (ta.type == RC_ARRAY && tb.type == RC_ARRAY) ok = rc_op_aa(&ta, &tb, op, out);
+        else if (ta.type == RC_ARRAY) ok = rc_op_ab(&ta, &tb, op, false, out);
+        else ok = rc_op_ab(&tb, &ta, op, true, out);
+        if (ob) rc_free(&tb);
+    }
+    if (oa) rc_free(&ta);
+    // 行程输入的结果往往仍适合行程表示
+    if (ok && out->card > 0 && (a->type == RC_RUN || b->type == RC_RUN)) rc_optimize(out);
+    if (!ok) rc_free(out);
+    return ok;
+}
+
+static uint32_t rc_and_card(const rc_t *a, const rc_t *b) {
+    rc_t ta, tb;
+    bool oa, ob;
+    uint32_t card = 0;
+    if (!rc_materialize(a, &ta, &oa)) return 0;
+    if (rc_materialize(b, &tb, &ob)) {
+        if (ta.type == RC_BITMAP && tb.type == RC_BITMAP) {
+            card = words_op(NULL, ta.words, tb.words, RC_OP_AND);
+        } else if (ta.type == RC_ARRAY && tb.type == RC_ARRAY) {
+            card = array_intersect(ta.array, ta.n, tb.array, tb.n, NULL);
+        } else {
+            const rc_t *arr = ta.type == RC_ARRAY ? &ta : &tb, *bm = ta.type == RC_ARRAY ? &tb : &ta;
+            for (uint32_t i = 0; i < arr->n; i++) card += words_test(bm->words, arr->array[i]);
+        }
+        if (ob) rc_free(&tb);
+    }
+    if (oa) rc_free(&ta);
+    return card;
+}
+
+static size_t rc_serialized_bytes(const rc_t *c) {
+    if (c->type == RC_RUN) return 2 + 4 * (size_t)c->n;
+    if (c->type == RC_ARRAY) return 2 * (size_t)c->card;
+    return RC_BITMAP_BYTES;
+}
+
+// ---------------------------------------------------------------- 容器表
+
+// 找到返回下标, 否则返回 -(插入位置 + 1)
+static long key_index(const roaring_t *r, uint16_t key) {
+    uint32_t pos = array_lower_bound(r->keys, (uint32_t)r->size, key);
+    if (pos < r->size && r->keys[pos] == key) return (long)pos;
+    return -((long)pos + 1);
+}
+
+static bool table_reserve(roaring_t *r, size_t need) {
+    if (need <= r->cap) return true;
+    size_t cap = r->cap ? r->cap * 2 : 4;
+    while (cap < need) cap *= 2;
+    uint16_t *keys = realloc(r->keys, cap * sizeof(uint16_t));
+    if (!keys) return false;
+    r->keys = keys;
+    rc_t *cs = realloc(r->cs, cap * sizeof(rc_t));
+    if (!cs) return false;
+    r->cs = cs;
+    r->cap = cap;
+    return true;
+}
+
+static bool table_insert(roaring_t *r, size_t pos, uint16_t key, const rc_t *c) {
+    if (!table_reserve(r, r->size + 1)) return false;
+    memmove(r->keys + pos + 1, r->keys + pos, (r->size - pos) * sizeof(uint16_t));
+    memmove(r->cs + pos + 1, r->cs + pos, (r->size - pos) * sizeof(rc_t));
+    r->keys[pos] = key;
+    r->cs[pos] = *c;
+    r->size++;
+    return true;
+}
+
+static void table_remove(roaring_t *r, size_t pos) {
+    rc_free(&r->cs[pos]);
+    memmove(r->keys + pos, r->keys + pos + 1, (r->size - pos - 1) * sizeof(uint16_t));
+    memmove(r->cs + pos, r->cs + pos + 1, (r->size - pos - 1) * sizeof(rc_t));
+    r->size--;
+}
+
+// 追加到末尾 (键必须递增), 失败时释放容器
+static bool table_append(roaring_t *r, uint16_t key, rc_t *c) {
+    if (!table_reserve(r, r->size + 1)) {
+        rc_free(c);
+        return false;
+    }
+    r->keys[r->size] = key;
+    r->cs[r->size++] = *c;
+    return true;
+}
+
+// 取得 key 对应的容器, 不存在时创建空数组容器
+static rc_t* table_get_or_create(roaring_t *r, uint16_t key) {
+    long idx = key_index(r, key);
+    if (idx >= 0) return &r->cs[idx];
+    rc_t c;
+    if (!rc_init_array(&c, 4)) return NULL;
+    size_t pos = (size_t)(-idx - 1);
+    if (!table_insert(r, pos, key, &c)) {
+        rc_free(&c);
+        return NULL;
+    }
+    return &r->cs[pos];
+}
+
+// ---------------------------------------------------------------- 公共接口
+
+roaring_t* roaring_create(void) {
+    return calloc(1, sizeof(roaring_t));
+}
+
+void roaring_free(roaring_t *r) {
+    if (!r) return;
+    for (size_t i = 0; i < r->size; i++) rc_free(&r->cs[i]);
+    free(r->keys);
+    free(r->cs);
+    free(r);
+}
+
+roaring_t* roaring_copy(const roaring_t *r) {
+    if (!r) return NULL;
+    roaring_t *copy = roaring_create();
+    if (!copy || !table_reserve(copy, r->size)) {
+        roaring_free(copy);
+        return NULL;
+    }
+    for (size_t i = 0; i < r->size; i++) {
+        if (!rc_clone(&copy->cs[i], &r->cs[i])) {
+            roaring_free(copy);
+            return NULL;
+        }
+        copy->keys[i] = r->keys[i];
+        copy->size++;
+    }
+    return copy;
+}
+
+void roaring_clear(roaring_t *r) {
+    if (!r) return;
+    for (size_t i = 0; i < r->size; i++) rc_free(&r->cs[i]);
+    r->size = 0;
+}
+
+bool roaring_add(roaring_t *r, uint32_t value) {
+    if (!r) return false;
+    rc_t *c = table_get_or_create(r, (uint16_t)(value >> 16));
+    return c && rc_add(c, (uint16_t)value) == 1;
+}
+
+bool roaring_remove(roaring_t *r, uint32_t value) {
+    if (!r) return false;
+    long idx = key_index(r, (uint16_t)(value >> 16));
+    if (idx < 0) return false;
+    bool removed = rc_remove(&r->cs[idx], (uint16_t)value) == 1;
+    if (r->cs[idx].card == 0) table_remove(r, (size_t)idx);
+    return removed;
+}
+
+bool roaring_contains(const roaring_t *r, uint32_t value) {
+    if (!r) return false;
+    long idx = key_index(r, (uint16_t)(value >> 16));
+    return idx >= 0 && rc_contains(&r->cs[idx], (uint16_t)value);
+}
+
+bool roaring_add_many(roaring_t *r, const uint32_t *values, size_t count) {
+    if (!r || (!values && count > 0)) return false;
+    rc_t *c = NULL;
+    uint32_t cur_key = UINT32_MAX;
+    bool ok = true;
+    for (size_t i = 0; i < count && ok; i++) {
+        uint32_t key = values[i] >> 16;
+        if (key != cur_key) {
+            c = table_get_or_create(r, (uint16_t)key);
+            if (!c) return false;
+            cur_key = key;
+        }
+        // 乱序插入较大的数组要反复搬移, 批量期间先转成位图, 结束后再按基数转回
+        if (c->type == RC_ARRAY && c->n >= RC_BULK_BITMAP && c->array[c->n - 1] > (uint16_t)values[i]) {
+            ok = rc_convert_bitmap(c);
+        }
+        ok = ok && rc_add(c, (uint16_t)values[i]) >= 0;
+    }
+    for (size_t i = 0; i < r->size; i++) rc_normalize(&r->cs[i]);
+    return ok;
+}
+
+bool roaring_add_range(roaring_t *r, uint32_t start, uint64_t end) {
+    if (!r) return false;
+    if (end > (1ull << 32)) end = 1ull << 32;
+    if (end <= start) return true;
+    uint64_t last = end - 1;
+    for (uint32_t key = start >> 16; key <= (uint32_t)(last >> 16); key++) {
+        uint32_t lo = key == start >> 16 ? (start & 0xFFFF) : 0;
+        uint32_t hi = key == (uint32_t)(last >> 16) ? (uint32_t)(last & 0xFFFF) : 0xFFFF;
+        rc_t *c = table_get_or_create(r, (uint16_t)key);
+        if (!c || !rc_add_range(c, lo, hi)) return false;
+    }
+    return true;
+}
+
+uint64_t roaring_cardinality(const roaring_t *r) {
+    if (!r) return 0;
+    uint64_t card = 0;
+    for (size_t i = 0; i < r->size; i++) card += r->cs[i].card;
+    return card;
+}
+
+bool roaring_is_empty(const roaring_t *r) {
+    return !r || r->size == 0;
+}
+
+uint64_t roaring_rank(const roaring_t *r, uint32_t value) {
+    if (!r) return 0;
+    uint64_t rank = 0;
+    uint16_t key = (uint16_t)(value >> 16);
+    for (size_t i = 0; i < r->size && r->keys[i] <= key; i++) {
+        rank += r->keys[i] < key ? r->cs[i].card : rc_rank(&r->cs[i], (uint16_t)value);
+    }
+    return rank;
+}
+
+bool roaring_select(const roaring_t *r, uint64_t rank, uint32_t *value) {
+    if (!r) return false;
+    for (size_t i = 0; i < r->size; i++) {
+        if (rank < r->cs[i].card) {
+            if (value) *value = ((uint32_t)r->keys[i] << 16) | rc_select(&r->cs[i], (uint32_t)rank);
+            return true;
+        }
+        rank -= r->cs[i].card;
+    }
+    return false;
+}
+
+bool roaring_minimum(const roaring_t *r, uint32_t *value) {
+    return r && r->size > 0 && roaring_select(r, 0, value);
+}
+
+bool roaring_maximum(const roaring_t *r, uint32_t *value) {
+    if (!r || r->size == 0) return false;
+    const rc_t *c = &r->cs[r->size - 1];
+    if (value) *value = ((uint32_t)r->keys[r->size - 1] << 16) | rc_select(c, c->card - 1);
+    return true;
+}
+
+static roaring_t* roaring_binop(const roaring_t *a, const roaring_t *b, rc_op_t op) {
+    if (!a || !b) return NULL;
+    roaring_t *r = roaring_create();
+    if (!r) return NULL;
+    bool keep_a = op != RC_OP_AND, keep_b = op == RC_OP_OR || op == RC_OP_XOR;
+    size_t i = 0, j = 0;
+    while (i < a->size || j < b->size) {
+        rc_t c;
+        uint16_t key;
+        bool have = false;
+        if (j >= b->size || (i < a->size && a->keys[i] < b->keys[j])) {
+            key = a->keys[i];
+            if (keep_a) {
+                if (!rc_clone(&c, &a->cs[i])) goto fail;
+                have = true;
+            }
+            i++;
+        } else if (i >= a->size || b->keys[j] < a->keys[i]) {
+            key = b->keys[j];
+            if (keep_b) {
+                if (!rc_clone(&c, &b->cs[j])) goto fail;
+                have = true;
+            }
+            j++;
+        } else {
+            key = a->keys[i];
+            if (!rc_binop(&a->cs[i], &b->cs[j], op, &c)) goto fail;
+            have = c.card > 0;
+            if (!have) rc_free(&c);
+            i++;
+            j++;
+        }
+        if (have && !table_append(r, key, &c)) goto fail;
+        // 交集只需要走到较短一方的末尾
+        if (op == RC_OP_AND && (i >= a->size || j >= b->size)) break;
+        if (op == RC_OP_ANDNOT && i >= a->size) break;
+    }
+    return r;
+
+fail:
+    roaring_free(r);
+    return NULL;
+}
+
+roaring_t* roaring_and(const roaring_t *a, const roaring_t *b) {
+    return roaring_binop(a, b, RC_OP_AND);
+}
+
+roaring_t* roaring_or(const roaring_t *a, const roaring_t *b) {
+    return roaring_binop(a, b, RC_OP_OR);
+}
+
+roaring_t* roaring_xor(const roaring_t *a, const roaring_t *b) {
+    return roaring_binop(a, b, RC_OP_XOR);
+}
+
+roaring_t* roaring_andnot(const roaring_t *a, const roaring_t *b) {
+    return roaring_binop(a, b, RC_OP_ANDNOT);
+}
+
+uint64_t roaring_and_cardinality(const roaring_t *a, const roaring_t *b) {
+    if (!a || !b) return 0;
+    uint64_t card = 0;
+    size_t i = 0, j = 0;
+    while (i < a->size && j < b->size) {
+        if (a->keys[i] < b->keys[j]) {
+            i++;
+        } else if (a->keys[i] > b->keys[j]) {
+            j++;
+        } else {
+            card += rc_and_card(&a->cs[i++], &b->cs[j++]);
+        }
+    }
+    return card;
+}
+
+bool roaring_equals(const roaring_t *a, const roaring_t *b) {
+    if (!a || !b) return a == b;
+    if (a->size != b->size) return false;
+    uint64_t *wa = NULL, *wb = NULL;
+    bool equal = true;
+    for (size_t i = 0; i < a->size && equal; i++) {
+        const rc_t *ca = &a->cs[i], *cb = &b->cs[i];
+        if (a->keys[i] != b->keys[i] || ca->card != cb->card) {
+            equal = false;
+        } else if (ca->type == RC_ARRAY && cb->type == RC_ARRAY) {
+            equal = memcmp(ca->array, cb->array, ca->n * sizeof(uint16_t)) == 0;
+        } else {
+            // 表示不同时展开成位图比较
+            if (!wa) wa = malloc(RC_BITMAP_BYTES);
+            if (!wb) wb = malloc(RC_BITMAP_BYTES);
+            if (!wa || !wb) {
+                equal = false;
+                break;
+            }
+            memset(wa, 0, RC_BITMAP_BYTES);
+            memset(wb, 0, RC_BITMAP_BYTES);
+            rc_fill_words(ca, wa);
+            rc_fill_words(cb, wb);
+            equal = memcmp(wa, wb, RC_BITMAP_BYTES) == 0;
+        }
+    }
+    free(wa);
+    free(wb);
+    return equal;
+}
+
+size_t roaring_foreach(const roaring_t *r, roaring_iter_fn fn, void *user_data) {
+    if (!r || !fn) return 0;
+    size_t calls = 0;
+    for (size_t i = 0; i < r->size; i++) {
+        const rc_t *c = &r->cs[i];
+        uint32_t high = (uint32_t)r->keys[i] << 16;
+        if (c->type == RC_ARRAY) {
+            for (uint32_t k = 0; k < c->n; k++) {
+                calls++;
+                if (!fn(high | c->array[k], user_data)) return calls;
+            }
+        } else if (c->type == RC_BITMAP) {
+            for (uint32_t w = 0; w < RC_WORDS; w++) {
+                uint64_t bits = c->words[w];
+                while (bits) {
+                    calls++;
+                    if (!fn(high | (w * 64 + (uint32_t)__builtin_ctzll(bits)), user_data)) return calls;
+                    bits &= bits - 1;
+                }
+            }
+        } else {
+            for (uint32_t k = 0; k < c->n; k++) {
+                uint32_t end = (uint32_t)c->runs[k].start + c->runs[k].len;
+                for (uint32_t v = c->runs[k].start; v <= end; v++) {
+                    calls++;
+                    if (!fn(high | v, user_data)) return calls;
+                }
+            }
+        }
+    }
+    return calls;
+}
+
+void roaring_to_array(const roaring_t *r, uint32_t *out) {
+    if (!r || !out) return;
+    uint16_t *low = malloc(65536 * sizeof(uint16_t));
+    if (!low) return;
+    for (size_t i = 0; i < r->size; i++) {
+        const rc_t *c = &r->cs[i];
+        uint32_t high = (uint32_t)r->keys[i] << 16;
+        rc_fill_array(c, low);
+        for (uint32_t k = 0; k < c->card; k++) *out++ = high | low[k];
+    }
+    free(low);
+}
+
+bool roaring_run_optimize(roaring_t *r) {
+    if (!r) return false;
+    bool changed = false;
+    for (size_t i = 0; i < r->size; i++) changed |= rc_optimize(&r->cs[i]);
+    return changed;
+}
+
+size_t roaring_memory_usage(const roaring_t *r) {
+    if (!r) return 0;
+    size_t bytes = sizeof(roaring_t) + r->cap * (sizeof(uint16_t) + sizeof(rc_t));
+    for (size_t i = 0; i < r->size; i++) {
+        const rc_t *c = &r->cs[i];
+        bytes += c->type == RC_BITMAP ? RC_BITMAP_BYTES
+               : c->type == RC_RUN ? c->cap * sizeof(rc_run_t) : c->cap * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+size_t roaring_container_count(const roaring_t *r) {
+    return r ? r->size : 0;
+}
+
+// ---------------------------------------------------------------- 序列化
+
+static void put16(uint8_t *p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+    for (int i = 0; i < 4; i++) p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get16(const uint8_t *p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p) {
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static bool has_run_container(const roaring_t *r) {
+    for (size_t i = 0; i < r->size; i++) {
+        if (r->cs[i].type == RC_RUN) return true;
+    }
+    return false;
+}
+
+static size_t header_size(const roaring_t *r, bool has_run) {
+    size_t bytes = has_run ? 4 + (r->size + 7) / 8 : 8;
+    bytes += 4 * r->size;
+    if (!has_run || r->size >= NO_OFFSET_THRESHOLD) bytes += 4 * r->size;
+    return bytes;
+}
+
+size_t roaring_serialized_size(const roaring_t *r) {
+    if (!r) return 0;
+    size_t bytes = header_size(r, has_run_container(r));
+    for (size_t i = 0; i < r->size; i++) bytes += rc_serialized_bytes(&r->cs[i]);
+    return bytes;
+}
+
+// 布局: cookie | [行程标志位] | (键, 基数-1) * n | [偏移] * n | 容器数据
+bool roaring_serialize(const roaring_t *r, uint8_t *buf, size_t buf_size, size_t *written) {
+    if (!r || !buf) return false;
+    size_t total = roaring_serialized_size(r);
+    if (buf_size < total) return false;
+
+    bool has_run = has_run_container(r);
+    uint8_t *p = buf;
+    if (has_run) {
+        put32(p, SERIAL_COOKIE | (uint32_t)((r->size ? r->size - 1 : 0) << 16));
+        p += 4;
+        memset(p, 0, (r->size + 7) / 8);
+        for (size_t i = 0; i < r->size; i++) {
+            if (r->cs[i].type == RC_RUN) p[i / 8] |= (uint8_t)(1 << (i % 8));
+        }
+        p += (r->size + 7) / 8;
+    } else {
+        put32(p, SERIAL_COOKIE_NO_RUN);
+        put32(p + 4, (uint32_t)r->size);
+        p += 8;
+    }
+    for (size_t i = 0; i < r->size; i++) {
+        put16(p, r->keys[i]);
+        put16(p + 2, (uint16_t)(r->cs[i].card - 1));
+        p += 4;
+    }
+    size_t offset = header_size(r, has_run);
+    if (!has_run || r->size >= NO_OFFSET_THRESHOLD) {
+        for (size_t i = 0; i < r->size; i++) {
+            put32(p, (uint32_t)offset);
+            p += 4;
+            offset += rc_serialized_bytes(&r->cs[i]);
+        }
+    }
+    for (size_t i = 0; i < r->size; i++) {
+        const rc_t *c = &r->cs[i];
+        if (c->type == RC_RUN) {
+            put16(p, (uint16_t)c->n);
+            p += 2;
+            for (uint32_t k = 0; k < c->n; k++) {
+                put16(p, c->runs[k].start);
+                put16(p + 2, c->runs[k].len);
+                p += 4;
+            }
+        } else if (c->type == RC_ARRAY) {
+            for (uint32_t k = 0; k < c->n; k++) {
+                put16(p, c->array[k]);
+                p += 2;
+            }
+        } else {
+            for (uint32_t k = 0; k < RC_WORDS; k++) {
+                put32(p, (uint32_t)c->words[k]);
+                put32(p + 4, (uint32_t)(c->words[k] >> 32));
+                p += 8;
+            }
+        }
+    }
+    if (written) *written = (size_t)(p - buf);
+    return true;
+}
+
+roaring_t* roaring_deserialize(const uint8_t *buf, size_t buf_size) {
+    if (!buf || buf_size < 4) return NULL;
+    const uint8_t *p = buf, *end = buf + buf_size;
+    uint32_t cookie = get32(p);
+    size_t size;
+    const uint8_t *run_flags = NULL;
+    bool has_offsets;
+    p += 4;
+    if ((cookie & 0xFFFF) == SERIAL_COOKIE) {
+        size = (cookie >> 16) + 1;
+        if ((size_t)(end - p) < (size + 7) / 8) return NULL;
+        run_flags = p;
+        p += (size + 7) / 8;
+        has_offsets = size >= NO_OFFSET_THRESHOLD;
+    } else if (cookie == SERIAL_COOKIE_NO_RUN) {
+        if (end - p < 4) return NULL;
+        size = get32(p);
+        p += 4;
+        has_offsets = true;
+        if (size > 65536) return NULL;
+    } else {
+        return NULL;
+    }
+    if ((size_t)(end - p) < size * (has_offsets ? 8 : 4)) return NULL;
+    const uint8_t *desc = p;
+    p += size * 4 + (has_offsets ? size * 4 : 0);
+
+    roaring_t *r = roaring_create();
+    if (!r || !table_reserve(r, size)) goto fail;
+    for (size_t i = 0; i < size; i++) {
+        uint16_t key = get16(desc + 4 * i);
+        uint32_t card = (uint32_t)get16(desc + 4 * i + 2) + 1;
+        if (i > 0 && key <= r->keys[i - 1]) goto fail;
+        rc_t c;
+        memset(&c, 0, sizeof(c));
+        if (run_flags && (run_flags[i / 8] >> (i % 8)) & 1) {
+            if (end - p < 2) goto fail;
+            uint32_t n = get16(p);
+            p += 2;
+            if ((size_t)(end - p) < 4 * (size_t)n || n == 0) goto fail;
+            c.type = RC_RUN;
+            if (!rc_reserve(&c, n)) goto fail;
+            uint32_t total = 0, prev_end = 0;
+            for (uint32_t k = 0; k < n; k++) {
+                uint16_t start = get16(p), len = get16(p + 2);
+                p += 4;
+                // 行程必须有序, 不重叠, 不越过 65535
+                if ((uint32_t)start + len > 65535 || (k > 0 && start <= prev_end)) {
+                    rc_free(&c);
+                    goto fail;
+                }
+                c.runs[k].start = start;
+                c.runs[k].len = len;
+                prev_end = (uint32_t)start + len;
+                total += (uint32_t)len + 1;
+            }
+            c.n = n;
+            c.card = total;
+        } else if (card <= RC_ARRAY_MAX) {
+            if ((size_t)(end - p) < 2 * (size_t)card || !rc_init_array(&c, card)) goto fail;
+            for (uint32_t k = 0; k < card; k++) {
+                c.array[k] = get16(p);
+                p += 2;
+                if (k > 0 && c.array[k] <= c.array[k - 1]) {
+                    rc_free(&c);
+                    goto fail;
+                }
+            }
+            c.n = c.card = card;
+        } else {
+            if ((size_t)(end - p) < RC_BITMAP_BYTES || !rc_init_bitmap(&c)) goto fail;
+            for (uint32_t k = 0; k < RC_WORDS; k++) {
+                c.words[k] = (uint64_t)get32(p) | ((uint64_t)get32(p + 4) << 32);
+                p += 8;
+            }
+            c.card = words_card(c.words, RC_WORDS);
+        }
+        if (c.card != card) {
+            rc_free(&c);
+            goto fail;
+        }
+        r->keys[i] = key;
+        r->cs[i] = c;
+        r->size++;
+    }
+    return r;
+
+fail:
+    roaring_free(r);
+    return NULL;
+}
@@ -0,0 +1,80 @@
+#ifndef C_UTILS_ROARING_H
+#define C_UTILS_ROARING_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// Roaring 压缩位图: 32 位整数集合
+//
+// 按高 16 位分块, 每块一个容器, 容器按内容自动选择:
+// - 数组容器: 不超过 4096 个元素时存有序 uint16 数组
+// - 位图容器: 元素较多时存 65536 位 (8KB) 位图, 集合运算用 AVX2 + popcount
+// - 行程容器: 连续区间多时存 [起点, 长度-1] 对, 由区间插入和 roaring_run_optimize 产生
+// 序列化格式与 Roaring 的可移植格式 (RoaringFormatSpec) 一致, 可与其他语言的实现互通
+
+typedef struct roaring_s roaring_t;
+
+// 遍历回调, 返回 false 停止遍历
+typedef bool (*roaring_iter_fn)(uint32_t value, void *user_data);
+
+// 创建与销毁
+roaring_t* roaring_create(void);
+roaring_t* roaring_copy(const roaring_t *r);
+void       roaring_free(roaring_t *r);
+
+// 基本操作
+// 返回: add/remove 在集合发生变化时返回 true, 已存在/不存在或内存不足返回 false
+bool       roaring_add(roaring_t *r, uint32_t value);
+bool       roaring_remove(roaring_t *r, uint32_t value);
+bool       roaring_contains(const roaring_t *r, uint32_t value);
+void       roaring_clear(roaring_t *r);
+
+// 批量添加 (输入有序时最快)
+// 返回: 成功返回 true, 内存不足返回 false
+bool       roaring_add_many(roaring_t *r, const uint32_t *values, size_t count);
+
+// 添加区间 [start, end), end 最大为 2^32; 整块覆盖时直接生成行程容器
+// 返回: 成功返回 true, 内存不足返回 false
+bool       roaring_add_range(roaring_t *r, uint32_t start, uint64_t end);
+
+// 计数与排名
+uint64_t   roaring_cardinality(const roaring_t *r);
+bool       roaring_is_empty(const roaring_t *r);
+// 小于等于 value 的元素个数
+uint64_t   roaring_rank(const roaring_t *r, uint32_t value);
+// 第 rank 个元素 (从 0 开始), rank 越界返回 false
+bool       roaring_select(const roaring_t *r, uint64_t rank, uint32_t *value);
+bool       roaring_minimum(const roaring_t *r, uint32_t *value);
+bool       roaring_maximum(const roaring_t *r, uint32_t *value);
+
+// 集合运算, 返回新位图 (内存不足返回 NULL)
+roaring_t* roaring_and(const roaring_t *a, const roaring_t *b);
+roaring_t* roaring_or(const roaring_t *a, const roaring_t *b);
+roaring_t* roaring_xor(const roaring_t *a, const roaring_t *b);
+roaring_t* roaring_andnot(const roaring_t *a, const roaring_t *b);
+// 只计算交集大小, 不生成结果
+uint64_t   roaring_and_cardinality(const roaring_t *a, const roaring_t *b);
+bool       roaring_equals(const roaring_t *a, const roaring_t *b);
+
+// 遍历与导出
+// 返回: 回调的次数
+size_t     roaring_foreach(const roaring_t *r, roaring_iter_fn fn, void *user_data);
+// out 至少能容纳 roaring_cardinality 个元素
+void       roaring_to_array(const roaring_t *r, uint32_t *out);
+
+// 把更适合用行程表示的容器转换为行程容器
+// 返回: 有容器被转换返回 true
+bool       roaring_run_optimize(roaring_t *r);
+
+// 内存占用 (字节)
+size_t     roaring_memory_usage(const roaring_t *r);
+// 容器数量
+size_t     roaring_container_count(const roaring_t *r);
+
+// 序列化 (可移植格式, 小端)
+size_t     roaring_serialized_size(const roaring_t *r);
+bool       roaring_serialize(const roaring_t *r, uint8_t *buf, size_t buf_size, size_t *written);
+roaring_t* roaring_deserialize(const uint8_t *buf, size_t buf_size);
+
+#endif // C_UTILS_ROARING_H
@@ -4,23 +4,40 @@
 
 static skiplist_node_t* create_node(int level, void *key, void *value) {
     skiplist_node_t *n = malloc(sizeof(skiplist_node_t) + level * sizeof(skiplist_node_t*));
+    if (!n) return NULL;
     n->key = key;
     n->value = value;
     return n;
 }
 
+// 每线程 xorshift64, 不经过 rand() 的全局锁
 static int random_level() {
+    static _Thread_local uint64_t state;
+    if (state == 0) state = (uint64_t)(uintptr_t)&state * 0x9E3779B97F4A7C15ull | 1;
+    uint64_t x = state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    state = x;
     int level = 1;
-    while ((rand() & 0xFFFF) < (0.5 * 0xFFFF) && level < SKIPLIST_MAX_LEVEL) level++;
+    while ((x & 1) && level < SKIPLIST_MAX_LEVEL) {
+        level++;
+        x >>= 1;
+    }
     return level;
 }
 
 skiplist_t* skiplist_create(int (*compar)(const void *, const void *)) {
     skiplist_t *sl = malloc(sizeof(skiplist_t));
+    if (!sl) return NULL;
     sl->level = 1;
     sl->size = 0;
     sl->compar = compar;
     sl->header = create_node(SKIPLIST_MAX_LEVEL, NULL, NULL);
+    if (!sl->header) {
+        free(sl);
+        return NULL;
+    }
     for (int i = 0; i < SKIPLIST_MAX_LEVEL; i++) sl->header->forward[i] = NULL;
     return sl;
 }
@@ -43,6 +60,7 @@ void skiplist_insert(skiplist_t *sl, void *key, void *value) {
         sl->level = level;
     }
     p = create_node(level, key, value);
+    if (!p) return;
     for (int i = 0; i < level; i++) {
         p->forward[i] = update[i]->forward[i];
         update[i]->forward[i] = p;
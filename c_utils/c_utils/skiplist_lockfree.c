@@ -0,0 +1,418 @@
+#include "skiplist_lockfree.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+
+#define LF_DEFAULT_CHUNK_SIZE (64 * 1024)
+#define LF_MARK ((uintptr_t)1)
+
+// 删除者取走值后留在节点中的哨兵, 写入后不再改变; 并发写入者看到它时改为插入新节点
+static char lf_dead_sentinel;
+#define LF_DEAD ((void *)&lf_dead_sentinel)
+
+// arena 块; 普通块由 current 串成链, 超过块大小 1/4 的分配单独成块挂在 large 链上
+typedef struct lf_chunk_s {
+    struct lf_chunk_s *next;
+    size_t size;
+    atomic_size_t used;
+    _Alignas(16) uint8_t data[];
+} lf_chunk_t;
+
+// 节点: 值、键长、层高, 之后是各层后继指针 (最低位为删除标记) 和键
+struct skiplist_lf_node_s {
+    _Atomic(void *) value;
+    uint32_t key_len;
+    uint32_t level;
+    _Atomic uintptr_t next[];
+};
+
+struct skiplist_lf_s {
+    skiplist_lf_compare_fn compare;
+    size_t chunk_size;
+    _Atomic(lf_chunk_t *) current;
+    _Atomic(lf_chunk_t *) large;
+    atomic_size_t memory;
+    atomic_size_t size;
+    skiplist_lf_node_t *head;
+};
+
+static inline bool is_marked(uintptr_t p) {
+    return (p & LF_MARK) != 0;
+}
+
+static inline skiplist_lf_node_t* to_node(uintptr_t p) {
+    return (skiplist_lf_node_t *)(p & ~LF_MARK);
+}
+
+static inline const uint8_t* node_key(const skiplist_lf_node_t *node) {
+    return (const uint8_t *)&node->next[node->level];
+}
+
+static inline int compare_key(const skiplist_lf_t *sl, const skiplist_lf_node_t *node, const void *key,
+                              size_t key_len) {
+    if (sl->compare) return sl->compare(node_key(node), node->key_len, key, key_len);
+    size_t n = node->key_len < key_len ? node->key_len : key_len;
+    int c = n ? memcmp(node_key(node), key, n) : 0;
+    if (c) return c;
+    return (node->key_len > key_len) - (node->key_len < key_len);
+}
+
+// ---------------- 无锁 arena ----------------
+
+void* skiplist_lf_alloc(skiplist_lf_t *sl, size_t size) {
+    if (!sl) return NULL;
+    size = (size + 7) & ~(size_t)7;
+    if (size == 0) size = 8;
+    atomic_fetch_add_explicit(&sl->memory, size, memory_order_relaxed);
+
+    if (size > sl->chunk_size / 4) {
+        lf_chunk_t *chunk = malloc(sizeof(lf_chunk_t) + size);
+        if (!chunk) return NULL;
+        chunk->size = size;
+        atomic_init(&chunk->used, size);
+        chunk->next = atomic_load_explicit(&sl->large, memory_order_relaxed);
+        while (!atomic_compare_exchange_weak_explicit(&sl->large, &chunk->next, chunk, memory_order_release,
+                                                      memory_order_relaxed)) {
+        }
+        return chunk->data;
+    }
+
+    for (;;) {
+        lf_chunk_t *chunk = atomic_load_explicit(&sl->current, memory_order_acquire);
+        if (chunk) {
+            size_t offset = atomic_fetch_add_explicit(&chunk->used, size, memory_order_relaxed);
+            if (offset + size <= chunk->size) return chunk->data + offset;
+        }
+        // 当前块用尽: 装入新块, 竞争失败的线程释放自己的块后重试
+        lf_chunk_t *fresh = malloc(sizeof(lf_chunk_t) + sl->chunk_size);
+        if (!fresh) return NULL;
+        fresh->size = sl->chunk_size;
+        fresh->next = chunk;
+        atomic_init(&fresh->used, size);
+        if (atomic_compare_exchange_strong_explicit(&sl->current, &chunk, fresh, memory_order_acq_rel,
+                                                    memory_order_acquire)) {
+            return fresh->data;
+        }
+        free(fresh);
+    }
+}
+
+static void free_chunks(lf_chunk_t *chunk) {
+    while (chunk) {
+        lf_chunk_t *next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+}
+
+// ---------------- 层高 ----------------
+
+// 每线程 xorshift64, 种子取自线程局部变量的地址和全局计数
+static int random_level(void) {
+    static _Thread_local uint64_t state;
+    static atomic_uint_fast64_t seed_counter;
+    if (state == 0) {
+        uint64_t seed = (uint64_t)(uintptr_t)&state ^
+                        (atomic_fetch_add_explicit(&seed_counter, 1, memory_order_relaxed) * 0x9E3779B97F4A7C15ull);
+        state = seed ? seed : 0x2545F4914F6CDD1Dull;
+    }
+    uint64_t x = state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    state = x;
+
+    int level = 1;
+    while ((x & 3) == 0 && level < SKIPLIST_LF_MAX_LEVEL) {
+        level++;
+        x >>= 2;
+    }
+    return level;
+}
+
+static skiplist_lf_node_t* node_create(skiplist_lf_t *sl, int level, const void *key, size_t key_len, void *value) {
+    skiplist_lf_node_t *node =
+        skiplist_lf_alloc(sl, sizeof(skiplist_lf_node_t) + (size_t)level * sizeof(uintptr_t) + key_len);
+    if (!node) return NULL;
+    atomic_init(&node->value, value);
+    node->key_len = (uint32_t)key_len;
+    node->level = (uint32_t)level;
+    for (int i = 0; i < level; i++) atomic_init(&node->next[i], 0);
+    if (key_len) memcpy((uint8_t *)node_key(node), key, key_len);
+    return node;
+}
+
+// ---------------- 查找 ----------------
+
+// 定位每层的前驱与后继, 顺路摘除已标记删除的节点
+// 返回: 第 0 层后继的键等于 key 时返回 true
+static bool find(skiplist_lf_t *sl, const void *key, size_t key_len, skiplist_lf_node_t **preds,
+                 skiplist_lf_node_t **succs) {
+retry:;
+    skiplist_lf_node_t *pred = sl->head;
+    for (int level = SKIPLIST_LF_MAX_LEVEL - 1; level >= 0; level--) {
+        skiplist_lf_node_t *curr = to_node(atomic_load_explicit(&pred->next[level], memory_order_acquire));
+        while (curr) {
+            uintptr_t succ = atomic_load_explicit(&curr->next[level], memory_order_acquire);
+            while (is_marked(succ)) {
+                uintptr_t expected = (uintptr_t)curr;
+                if (!atomic_compare_exchange_strong_explicit(&pred->next[level], &expected, succ & ~LF_MARK,
+                                                             memory_order_acq_rel, memory_order_acquire)) {
+                    goto retry;
+                }
+                curr = to_node(succ);
+                if (!curr) break;
+                succ = atomic_load_explicit(&curr->next[level], memory_order_acquire);
+            }
+            if (!curr || compare_key(sl, curr, key, key_len) >= 0) break;
+            pred = curr;
+            curr = to_node(succ);
+        }
+        preds[level] = pred;
+        succs[level] = curr;
+    }
+    return succs[0] && compare_key(sl, succs[0], key, key_len) == 0;
+}
+
+// 只读查找第一个大于等于 key 的未删除节点, 跳过但不摘除已标记的节点
+static const skiplist_lf_node_t* lower_bound(const skiplist_lf_t *sl, const void *key, size_t key_len) {
+    const skiplist_lf_node_t *pred = sl->head;
+    const skiplist_lf_node_t *curr = NULL;
+    for (int level = SKIPLIST_LF_MAX_LEVEL - 1; level >= 0; level--) {
+        curr = to_node(atomic_load_explicit(&pred->next[level], memory_order_acquire));
+        while (curr) {
+            uintptr_t succ = atomic_load_explicit(&curr->next[level], memory_order_acquire);
+            if (is_marked(succ)) {
+                curr = to_node(succ);
+                continue;
+            }
+            if (compare_key(sl, curr, key, key_len) >= 0) break;
+            pred = curr;
+            curr = to_node(succ);
+        }
+    }
+    return curr;
+}
+
+// ---------------- 公共接口 ----------------
+
+skiplist_lf_t* skiplist_lf_create(skiplist_lf_compare_fn compare, size_t chunk_size) {
+    skiplist_lf_t *sl = calloc(1, sizeof(skiplist_lf_t));
+    if (!sl) return NULL;
+    sl->compare = compare;
+    sl->chunk_size = chunk_size ? chunk_size : LF_DEFAULT_CHUNK_SIZE;
+    size_t head_size = sizeof(skiplist_lf_node_t) + SKIPLIST_LF_MAX_LEVEL * sizeof(uintptr_t);
+    if (sl->chunk_size < head_size * 4) sl->chunk_size = head_size * 4;
+    atomic_init(&sl->current, NULL);
+    atomic_init(&sl->large, NULL);
+    atomic_init(&sl->memory, 0);
+    atomic_init(&sl->size, 0);
+    sl->head = node_create(sl, SKIPLIST_LF_MAX_LEVEL, NULL, 0, NULL);
+    if (!sl->head) {
+        free(sl);
+        return NULL;
+    }
+    return sl;
+}
+
+void skiplist_lf_free(skiplist_lf_t *sl, void (*value_free)(void *value)) {
+    if (!sl) return;
+    if (value_free) {
+        uintptr_t p = atomic_load_explicit(&sl->head->next[0], memory_order_acquire);
+        while (to_node(p)) {
+            skiplist_lf_node_t *node = to_node(p);
+            p = atomic_load_explicit(&node->next[0], memory_order_acquire);
+            void *value = atomic_load_explicit(&node->value, memory_order_acquire);
+            if (!is_marked(p) && value != LF_DEAD) value_free(value);
+        }
+    }
+    free_chunks(atomic_load(&sl->current));
+    free_chunks(atomic_load(&sl->large));
+    free(sl);
+}
+
+static bool lf_put(skiplist_lf_t *sl, const void *key, size_t key_len, void *value, void **replaced,
+                   bool only_if_absent) {
+    skiplist_lf_node_t *preds[SKIPLIST_LF_MAX_LEVEL];
+    skiplist_lf_node_t *succs[SKIPLIST_LF_MAX_LEVEL];
+    skiplist_lf_node_t *node = NULL;
+    if (replaced) *replaced = NULL;
+
+    for (;;) {
+        if (find(sl, key, key_len, preds, succs)) {
+            if (only_if_absent) return false;
+            // 只在值不是哨兵时替换: 哨兵一旦写入就不再改变, 不会覆盖其他写入者的值
+            void *old = atomic_load_explicit(&succs[0]->value, memory_order_acquire);
+            while (old != LF_DEAD &&
+                   !atomic_compare_exchange_weak_explicit(&succs[0]->value, &old, value, memory_order_acq_rel,
+                                                          memory_order_acquire)) {
+            }
+            if (old != LF_DEAD) {
+                if (replaced) *replaced = old;
+                return true;
+            }
+            // 节点已被删除者取走值 (第 0 层已标记), 重新查找时顺带摘除它, 再插入新节点
+            continue;
+        }
+
+        // 重试时复用已分配的节点
+        if (!node) {
+            node = node_create(sl, random_level(), key, key_len, value);
+            if (!node) return false;
+        }
+        for (uint32_t i = 0; i < node->level; i++) {
+            atomic_store_explicit(&node->next[i], (uintptr_t)succs[i], memory_order_relaxed);
+        }
+        uintptr_t expected = (uintptr_t)succs[0];
+        if (!atomic_compare_exchange_strong_explicit(&preds[0]->next[0], &expected, (uintptr_t)node,
+                                                     memory_order_acq_rel, memory_order_acquire)) {
+            continue;
+        }
+        atomic_fetch_add_explicit(&sl->size, 1, memory_order_relaxed);
+
+        // 第 0 层链入即已插入, 其余各层尽力链入; 节点被并发删除时停止
+        for (uint32_t level = 1; level < node->level; level++) {
+            for (;;) {
+                uintptr_t next = atomic_load_explicit(&node->next[level], memory_order_acquire);
+                if (is_marked(next)) return true;
+                if (to_node(next) != succs[level] &&
+                    !atomic_compare_exchange_strong_explicit(&node->next[level], &next, (uintptr_t)succs[level],
+                                                             memory_order_acq_rel, memory_order_acquire)) {
+                    return true;
+                }
+                expected = (uintptr_t)succs[level];
+                if (atomic_compare_exchange_strong_explicit(&preds[level]->next[level], &expected, (uintptr_t)node,
+                                                            memory_order_acq_rel, memory_order_acquire)) {
+                    break;
+                }
+                if (!find(sl, key, key_len, preds, succs) || succs[0] != node) return true;
+            }
+        }
+        return true;
+    }
+}
+
+bool skiplist_lf_put(skiplist_lf_t *sl, const void *key, size_t key_len, void *value, void **replaced) {
+    if (!sl || (!key && key_len) || key_len > UINT32_MAX || value == LF_DEAD) return false;
+    return lf_put(sl, key, key_len, value, replaced, false);
+}
+
+bool skiplist_lf_insert(skiplist_lf_t *sl, const void *key, size_t key_len, void *value) {
+    if (!sl || (!key && key_len) || key_len > UINT32_MAX || value == LF_DEAD) return false;
+    return lf_put(sl, key, key_len, value, NULL, true);
+}
+
+bool skiplist_lf_get(const skiplist_lf_t *sl, const void *key, size_t key_len, void **value) {
+    if (!sl || (!key && key_len)) return false;
+    const skiplist_lf_node_t *node = lower_bound(sl, key, key_len);
+    if (!node || compare_key(sl, node, key, key_len) != 0) return false;
+    void *v = atomic_load_explicit(&((skiplist_lf_node_t *)node)->value, memory_order_acquire);
+    if (v == LF_DEAD) return false;
+    if (value) *value = v;
+    return true;
+}
+
+bool skiplist_lf_remove(skiplist_lf_t *sl, const void *key, size_t key_len, void **value) {
+    skiplist_lf_node_t *preds[SKIPLIST_LF_MAX_LEVEL];
+    skiplist_lf_node_t *succs[SKIPLIST_LF_MAX_LEVEL];
+    if (!sl || (!key && key_len)) return false;
+    if (!find(sl, key, key_len, preds, succs)) return false;
+    skiplist_lf_node_t *node = succs[0];
+
+    // 自顶向下标记各层, 第 0 层标记成功的线程完成删除
+    for (int level = (int)node->level - 1; level >= 1; level--) {
+        uintptr_t next = atomic_load_explicit(&node->next[level], memory_order_acquire);
+        while (!is_marked(next) &&
+               !atomic_compare_exchange_weak_explicit(&node->next[level], &next, next | LF_MARK, memory_order_acq_rel,
+                                                      memory_order_acquire)) {
+        }
+    }
+    uintptr_t next = atomic_load_explicit(&node->next[0], memory_order_acquire);
+    for (;;) {
+        if (is_marked(next)) return false;
+        if (atomic_compare_exchange_weak_explicit(&node->next[0], &next, next | LF_MARK, memory_order_acq_rel,
+                                                  memory_order_acquire)) {
+            break;
+        }
+    }
+    void *old = atomic_exchange_explicit(&node->value, LF_DEAD, memory_order_acq_rel);
+    atomic_fetch_sub_explicit(&sl->size, 1, memory_order_relaxed);
+    if (value) *value = old;
+    find(sl, key, key_len, preds, succs);
+    return true;
+}
+
+size_t skiplist_lf_size(const skiplist_lf_t *sl) {
+    return sl ? atomic_load_explicit(&((skiplist_lf_t *)sl)->size, memory_order_relaxed) : 0;
+}
+
+size_t skiplist_lf_memory_usage(const skiplist_lf_t *sl) {
+    return sl ? atomic_load_explicit(&((skiplist_lf_t *)sl)->memory, memory_order_relaxed) : 0;
+}
+
+// ---------------- 迭代 ----------------
+
+// 从 node (含) 开始找第一个未删除的节点
+static const skiplist_lf_node_t* skip_deleted(const skiplist_lf_node_t *node) {
+    while (node) {
+        uintptr_t next = atomic_load_explicit(&((skiplist_lf_node_t *)node)->next[0], memory_order_acquire);
+        if (!is_marked(next)) return node;
+        node = to_node(next);
+    }
+    return NULL;
+}
+
+void skiplist_lf_iter_first(skiplist_lf_iter_t *it, const skiplist_lf_t *sl) {
+    if (!it) return;
+    it->sl = sl;
+    it->node = sl ? skip_deleted(to_node(atomic_load_explicit(&sl->head->next[0], memory_order_acquire))) : NULL;
+}
+
+void skiplist_lf_iter_seek(skiplist_lf_iter_t *it, const skiplist_lf_t *sl, const void *key, size_t key_len) {
+    if (!it) return;
+    it->sl = sl;
+    it->node = sl && (key || !key_len) ? lower_bound(sl, key, key_len) : NULL;
+}
+
+bool skiplist_lf_iter_valid(const skiplist_lf_iter_t *it) {
+    return it && it->node;
+}
+
+void skiplist_lf_iter_next(skiplist_lf_iter_t *it) {
+    if (!it || !it->node) return;
+    uintptr_t next = atomic_load_explicit(&((skiplist_lf_node_t *)it->node)->next[0], memory_order_acquire);
+    it->node = skip_deleted(to_node(next));
+}
+
+const void* skiplist_lf_iter_key(const skiplist_lf_iter_t *it, size_t *key_len) {
+    if (!it || !it->node) return NULL;
+    if (key_len) *key_len = it->node->key_len;
+    return node_key(it->node);
+}
+
+void* skiplist_lf_iter_value(const skiplist_lf_iter_t *it) {
+    if (!it || !it->node) return NULL;
+    void *value = atomic_load_explicit(&((skiplist_lf_node_t *)it->node)->value, memory_order_acquire);
+    return value == LF_DEAD ? NULL : value;
+}
+
+size_t skiplist_lf_range(const skiplist_lf_t *sl, const void *start, size_t start_len, const void *end,
+                         size_t end_len, skiplist_lf_range_cb callback, void *user_data) {
+    if (!sl || !callback) return 0;
+    skiplist_lf_iter_t it;
+    if (start) {
+        skiplist_lf_iter_seek(&it, sl, start, start_len);
+    } else {
+        skiplist_lf_iter_first(&it, sl);
+    }
+
+    size_t visited = 0;
+    for (; skiplist_lf_iter_valid(&it); skiplist_lf_iter_next(&it)) {
+        if (end && compare_key(sl, it.node, end, end_len) >= 0) break;
+        void *value = atomic_load_explicit(&((skiplist_lf_node_t *)it.node)->value, memory_order_acquire);
+        if (value == LF_DEAD) continue;
+        visited++;
+        if (!callback(node_key(it.node), it.node->key_len, value, user_data)) break;
+    }
+    return visited;
+}
@@ -0,0 +1,99 @@
+#ifndef C_UTILS_SKIPLIST_LOCKFREE_H
+#define C_UTILS_SKIPLIST_LOCKFREE_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+// 无锁并发跳表: 字节串键, 指针值
+//
+// 并发约定:
+// - put/get/remove/迭代/范围扫描都可以被任意多个线程同时调用, 全部基于 CAS, 不加锁
+// - 删除先在节点的后继指针上打标记 (逻辑删除), 再由删除者或之后经过的线程摘链
+// - 节点 (连同键) 从跳表自带的无锁 arena 中分配, 摘链后不单独释放, 随 skiplist_lf_free 一起回收,
+//   因此并发读者不需要危险指针或纪元回收; 代价是删除不归还内存, 适合内存表这类整体丢弃的场景
+// - 层高由每线程的 xorshift 生成器产生 (概率 1/4), 不经过 rand() 的全局锁
+// - 迭代器是弱一致的: 遍历期间并发插入或删除的键可能看到也可能看不到, 但键始终严格递增
+
+#define SKIPLIST_LF_MAX_LEVEL 20
+
+typedef struct skiplist_lf_s skiplist_lf_t;
+typedef struct skiplist_lf_node_s skiplist_lf_node_t;
+
+// 键比较函数, NULL 时按字节序比较 (memcmp, 短键在前)
+typedef int (*skiplist_lf_compare_fn)(const void *a, size_t a_len, const void *b, size_t b_len);
+
+// 范围扫描回调, 返回 false 停止扫描
+typedef bool (*skiplist_lf_range_cb)(const void *key, size_t key_len, void *value, void *user_data);
+
+// 迭代器, 只保存当前节点, 不需要释放
+typedef struct {
+    const skiplist_lf_t *sl;
+    const skiplist_lf_node_t *node;
+} skiplist_lf_iter_t;
+
+// 创建跳表
+// compare: 键比较函数, NULL 使用字节序
+// chunk_size: arena 块大小, 0 使用默认值 (64KB)
+// 返回: 成功返回跳表指针，失败返回 NULL
+skiplist_lf_t* skiplist_lf_create(skiplist_lf_compare_fn compare, size_t chunk_size);
+
+// 释放跳表与 arena 中的全部节点和键 (不能与其他操作并发)
+// value_free: 非 NULL 时对每个未删除的值调用
+void skiplist_lf_free(skiplist_lf_t *sl, void (*value_free)(void *value));
+
+// 写入键值对, 键复制到 arena 中; 键已存在时原子替换值
+// replaced: 非 NULL 时输出被替换的旧值 (键不存在时为 NULL)
+// 返回: 成功返回 true, 内存不足返回 false
+bool skiplist_lf_put(skiplist_lf_t *sl, const void *key, size_t key_len, void *value, void **replaced);
+
+// 仅在键不存在时插入
+// 返回: 插入返回 true, 键已存在或内存不足返回 false
+bool skiplist_lf_insert(skiplist_lf_t *sl, const void *key, size_t key_len, void *value);
+
+// 查找值
+// value: 输出值
+// 返回: 找到返回 true
+bool skiplist_lf_get(const skiplist_lf_t *sl, const void *key, size_t key_len, void **value);
+
+// 删除键
+// value: 非 NULL 时输出被删除的值
+// 返回: 删除返回 true, 键不存在 (或被并发删除) 返回 false
+bool skiplist_lf_remove(skiplist_lf_t *sl, const void *key, size_t key_len, void **value);
+
+// 获取元素数量 (并发修改时为近似值)
+size_t skiplist_lf_size(const skiplist_lf_t *sl);
+
+// 获取 arena 已分配的字节数
+size_t skiplist_lf_memory_usage(const skiplist_lf_t *sl);
+
+// 从 arena 分配与跳表同生命周期的内存 (8 字节对齐, 线程安全), 例如内存表中值指向的记录
+// 返回: 成功返回指针, 失败返回 NULL
+void* skiplist_lf_alloc(skiplist_lf_t *sl, size_t size);
+
+// 迭代器定位到第一个键
+void skiplist_lf_iter_first(skiplist_lf_iter_t *it, const skiplist_lf_t *sl);
+
+// 迭代器定位到第一个大于等于 key 的键
+void skiplist_lf_iter_seek(skiplist_lf_iter_t *it, const skiplist_lf_t *sl, const void *key, size_t key_len);
+
+// 迭代器是否指向有效元素
+bool skiplist_lf_iter_valid(const skiplist_lf_iter_t *it);
+
+// 前进到下一个未删除的键
+void skiplist_lf_iter_next(skiplist_lf_iter_t *it);
+
+// 当前键
+const void* skiplist_lf_iter_key(const skiplist_lf_iter_t *it, size_t *key_len);
+
+// 当前值
+void* skiplist_lf_iter_value(const skiplist_lf_iter_t *it);
+
+// 按序扫描 [start, end) 范围内的键
+// start: 起始键, NULL 表示从头开始
+// end: 结束键 (不含), NULL 表示扫描到末尾
+// 返回: 回调的次数
+size_t skiplist_lf_range(const skiplist_lf_t *sl, const void *start, size_t start_len, const void *end,
+                         size_t end_len, skiplist_lf_range_cb callback, void *user_data);
+
+#endif // C_UTILS_SKIPLIST_LOCKFREE_H
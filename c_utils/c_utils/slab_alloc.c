@@ -0,0 +1,363 @@
+#include "slab_alloc.h"
+#include "page_allocator.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#define SPAN_SIZE (64 * 1024)
+#define SPAN_HEADER 64
+#define SPAN_MAGIC 0x534C4142u
+#define CLASS_LARGE UINT32_MAX
+
+// 每批对象约 4KB, 至少 4 个, 至多 64 个; 线程缓存超过两批时归还一批
+#define BATCH_BYTES 4096
+#define BATCH_MIN 4
+#define BATCH_MAX 64
+
+// 仓库栈顶: 低 48 位为指针, 高 16 位为版本号, 防止 ABA
+#define TAG_SHIFT 48
+#define PTR_MASK ((UINT64_C(1) << TAG_SHIFT) - 1)
+
+// span 头, 位于 64KB 对齐的 span 起始处
+typedef struct {
+    uint32_t magic;
+    uint32_t class_idx;
+    size_t size;             // 小对象为对象大小, 大对象为请求大小
+} span_header_t;
+
+// 空闲对象: next 串起同一批/同一线程缓存中的对象, 批首对象的 next_batch 串起仓库中的批
+typedef struct free_obj_s {
+    struct free_obj_s *next;
+    struct free_obj_s *next_batch;
+} free_obj_t;
+
+typedef struct {
+    _Alignas(64) _Atomic uint64_t depot;
+    pthread_mutex_t lock;    // 保护以下切分状态与零散链表
+    char *bump;
+    char *bump_end;
+    free_obj_t *partial;     // 线程退出时不足一批的对象
+    size_t partial_count;
+    uint32_t size;
+    uint32_t batch;
+    atomic_size_t spans;
+    atomic_size_t refills;
+    atomic_size_t flushes;
+} size_class_t;
+
+typedef struct {
+    free_obj_t *head[SLAB_CLASS_COUNT];
+    uint32_t count[SLAB_CLASS_COUNT];
+    bool registered;
+} thread_cache_t;
+
+static size_class_t g_classes[SLAB_CLASS_COUNT];
+static pthread_once_t g_once = PTHREAD_ONCE_INIT;
+static pthread_key_t g_key;
+// 页分配器的统计不是线程安全的, 所有 page_alloc/page_free 调用都在这把锁下
+static pthread_mutex_t g_page_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static atomic_size_t g_span_bytes;
+static atomic_size_t g_large_allocs;
+static atomic_size_t g_large_bytes;
+static _Atomic(slab_hook_fn) g_hook;
+static void *_Atomic g_hook_data;
+
+static __thread thread_cache_t t_cache;
+
+static void thread_cache_destroy(void *arg);
+
+// ---------------------------------------------------------------- 大小分级
+
+// 16..128 每 16 字节一级 (0..7), 之后 (2^e, 2^(e+1)] 按 2^(e-2) 分 4 级
+static inline unsigned size_class(size_t size) {
+    if (size <= 128) return size ? (unsigned)((size + 15) >> 4) - 1 : 0;
+    size_t s = size - 1;
+    unsigned e = 63 - (unsigned)__builtin_clzll((unsigned long long)s);
+    return 8 + (e - 7) * 4 + (unsigned)((s >> (e - 2)) & 3);
+}
+
+static inline uint32_t class_size(unsigned c) {
+    if (c < 8) return (c + 1) * 16;
+    unsigned g = (c - 8) / 4, r = (c - 8) % 4;
+    return (5 + r) * (32u << g);
+}
+
+static void slab_init(void) {
+    for (unsigned c = 0; c < SLAB_CLASS_COUNT; c++) {
+        size_class_t *sc = &g_classes[c];
+        pthread_mutex_init(&sc->lock, NULL);
+        sc->size = class_size(c);
+        uint32_t batch = BATCH_BYTES / sc->size;
+        sc->batch = batch < BATCH_MIN ? BATCH_MIN : batch > BATCH_MAX ? BATCH_MAX : batch;
+    }
+    pthread_key_create(&g_key, thread_cache_destroy);
+}
+
+static inline span_header_t* span_of(const void *ptr) {
+    return (span_header_t *)((uintptr_t)ptr & ~(uintptr_t)(SPAN_SIZE - 1));
+}
+
+static void emit(slab_event_t event, size_t size) {
+    slab_hook_fn fn = atomic_load_explicit(&g_hook, memory_order_acquire);
+    if (fn) fn(event, size, atomic_load_explicit(&g_hook_data, memory_order_relaxed));
+}
+
+// 向页分配器申请 size 字节, 按 span 大小对齐, 不清零
+static void* span_map(size_t size) {
+    page_alloc_config_t cfg = page_alloc_default_config();
+    cfg.alignment = SPAN_SIZE;
+    cfg.zero_initialize = false;
+    pthread_mutex_lock(&g_page_lock);
+    void *mem = page_alloc_ex(size, &cfg, NULL);
+    pthread_mutex_unlock(&g_page_lock);
+    return mem;
+}
+
+// ---------------------------------------------------------------- 中心仓库
+
+static void depot_push(size_class_t *sc, free_obj_t *batch) {
+    uint64_t old = atomic_load_explicit(&sc->depot, memory_order_relaxed), next;
+    do {
+        batch->next_batch = (free_obj_t *)(uintptr_t)(old & PTR_MASK);
+        next = (uint64_t)(uintptr_t)batch | ((old & ~PTR_MASK) + (UINT64_C(1) << TAG_SHIFT));
+    } while (!atomic_compare_exchange_weak_explicit(&sc->depot, &old, next, memory_order_release,
+                                                    memory_order_relaxed));
+}
+
+// 弹出的批首可能已被其他线程取走并改写, 但 span 不会释放, 读到的旧值只会让 CAS 因版本号不同而失败
+static free_obj_t* depot_pop(size_class_t *sc) {
+    uint64_t old = atomic_load_explicit(&sc->depot, memory_order_acquire), next;
+    free_obj_t *batch;
+    do {
+        batch = (free_obj_t *)(uintptr_t)(old & PTR_MASK);
+        if (!batch) return NULL;
+        next = (uint64_t)(uintptr_t)batch->next_batch | ((old & ~PTR_MASK) + (UINT64_C(1) << TAG_SHIFT));
+    } while (!atomic_compare_exchange_weak_explicit(&sc->depot, &old, next, memory_order_acquire,
+                                                    memory_order_acquire));
+    return batch;
+}
+
+// 仓库为空时: 先取零散对象, 否则从 span 切出一批. 返回链表, 数量写入 count
+static free_obj_t* carve(unsigned c, size_t *count) {
+    size_class_t *sc = &g_classes[c];
+    pthread_mutex_lock(&sc->lock);
+    if (sc->partial) {
+        free_obj_t *list = sc->partial;
+        *count = sc->partial_count;
+        sc->partial = NULL;
+        sc->partial_count = 0;
+        pthread_mutex_unlock(&sc->lock);
+        return list;
+    }
+
+    free_obj_t *head = NULL, **tail = &head;
+    size_t n = 0, new_spans = 0;
+    while (n < sc->batch) {
+        if (sc->bump + sc->size > sc->bump_end) {
+            char *span = span_map(SPAN_SIZE);
+            if (!span) break;
+            span_header_t *h = (span_header_t *)span;
+            h->magic = SPAN_MAGIC;
+            h->class_idx = c;
+            h->size = sc->size;
+            sc->bump = span + SPAN_HEADER;
+            sc->bump_end = span + SPAN_SIZE;
+            atomic_fetch_add_explicit(&sc->spans, 1, memory_order_relaxed);
+            atomic_fetch_add_explicit(&g_span_bytes, SPAN_SIZE, memory_order_relaxed);
+            new_spans++;
+        }
+        free_obj_t *obj = (free_obj_t *)sc->bump;
+        sc->bump += sc->size;
+        *tail = obj;
+        tail = &obj->next;
+        n++;
+    }
+    *tail = NULL;
+    pthread_mutex_unlock(&sc->lock);
+    // 钩子在锁外调用, 钩子内部也可以分配
+    while (new_spans--) emit(SLAB_EVENT_SPAN, SPAN_SIZE);
+    *count = n;
+    return head;
+}
+
+// ---------------------------------------------------------------- 线程缓存
+
+static void register_thread(thread_cache_t *tc) {
+    pthread_once(&g_once, slab_init);
+    pthread_setspecific(g_key, tc);
+    tc->registered = true;
+}
+
+// 从线程缓存头部摘下一整批归还仓库
+static void flush_batch(thread_cache_t *tc, unsigned c) {
+    size_class_t *sc = &g_classes[c];
+    free_obj_t *batch = tc->head[c], *last = batch;
+    for (uint32_t i = 1; i < sc->batch; i++) last = last->next;
+    tc->head[c] = last->next;
+    tc->count[c] -= sc->batch;
+    last->next = NULL;
+    depot_push(sc, batch);
+    atomic_fetch_add_explicit(&sc->flushes, 1, memory_order_relaxed);
+    emit(SLAB_EVENT_FLUSH, sc->size);
+}
+
+static void flush_all(thread_cache_t *tc) {
+    if (!tc->registered) return;
+    for (unsigned c = 0; c < SLAB_CLASS_COUNT; c++) {
+        size_class_t *sc = &g_classes[c];
+        while (tc->count[c] >= sc->batch) flush_batch(tc, c);
+        if (!tc->count[c]) continue;
+
+        free_obj_t *last = tc->head[c];
+        while (last->next) last = last->next;
+        pthread_mutex_lock(&sc->lock);
+        last->next = sc->partial;
+        sc->partial = tc->head[c];
+        sc->partial_count += tc->count[c];
+        pthread_mutex_unlock(&sc->lock);
+        tc->head[c] = NULL;
+        tc->count[c] = 0;
+    }
+}
+
+// 线程退出时归还缓存并清除注册标记: 之后其他 TLS 析构函数里的 slab_free/slab_alloc 会重新注册,
+// 线程库在下一轮析构中再次归还, 对象不会留在无人回收的缓存里
+static void thread_cache_destroy(void *arg) {
+    thread_cache_t *tc = arg;
+    flush_all(tc);
+    tc->registered = false;
+}
+
+static void* alloc_slow(thread_cache_t *tc, unsigned c) {
+    if (!tc->registered) register_thread(tc);
+    size_class_t *sc = &g_classes[c];
+    size_t n = sc->batch;
+    free_obj_t *list = depot_pop(sc);
+    if (!list) {
+        list = carve(c, &n);
+        if (!list) return NULL;
+    }
+    atomic_fetch_add_explicit(&sc->refills, 1, memory_order_relaxed);
+    emit(SLAB_EVENT_REFILL, sc->size);
+    tc->head[c] = list->next;
+    tc->count[c] = (uint32_t)n - 1;
+    return list;
+}
+
+// ---------------------------------------------------------------- 大对象
+
+static void* large_alloc(size_t size) {
+    if (size > SIZE_MAX - SPAN_HEADER) return NULL;
+    char *mem = span_map(size + SPAN_HEADER);
+    if (!mem) return NULL;
+    span_header_t *h = (span_header_t *)mem;
+    h->magic = SPAN_MAGIC;
+    h->class_idx = CLASS_LARGE;
+    h->size = size;
+    atomic_fetch_add_explicit(&g_large_allocs, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&g_large_bytes, size, memory_order_relaxed);
+    emit(SLAB_EVENT_LARGE_ALLOC, size);
+    return mem + SPAN_HEADER;
+}
+
+static void large_free(span_header_t *h) {
+    atomic_fetch_sub_explicit(&g_large_allocs, 1, memory_order_relaxed);
+    atomic_fetch_sub_explicit(&g_large_bytes, h->size, memory_order_relaxed);
+    emit(SLAB_EVENT_LARGE_FREE, h->size);
+    h->magic = 0;
+    pthread_mutex_lock(&g_page_lock);
+    page_free(h);
+    pthread_mutex_unlock(&g_page_lock);
+}
+
+// ---------------------------------------------------------------- 公共接口
+
+void* slab_alloc(size_t size) {
+    if (size > SLAB_MAX_SMALL) return large_alloc(size);
+    unsigned c = size_class(size);
+    thread_cache_t *tc = &t_cache;
+    free_obj_t *obj = tc->head[c];
+    if (obj) {
+        tc->head[c] = obj->next;
+        tc->count[c]--;
+        return obj;
+    }
+    return alloc_slow(tc, c);
+}
+
+void* slab_calloc(size_t count, size_t size) {
+    if (size && count > SIZE_MAX / size) return NULL;
+    void *ptr = slab_alloc(count * size);
+    if (ptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void slab_free(void *ptr) {
+    if (!ptr) return;
+    span_header_t *h = span_of(ptr);
+    if (h->class_idx == CLASS_LARGE) {
+        large_free(h);
+        return;
+    }
+    unsigned c = h->class_idx;
+    thread_cache_t *tc = &t_cache;
+    if (!tc->registered) register_thread(tc);
+    free_obj_t *obj = ptr;
+    obj->next = tc->head[c];
+    tc->head[c] = obj;
+    if (++tc->count[c] > 2 * g_classes[c].batch) flush_batch(tc, c);
+}
+
+size_t slab_usable_size(const void *ptr) {
+    return ptr ? span_of(ptr)->size : 0;
+}
+
+void* slab_realloc(void *ptr, size_t size) {
+    if (!ptr) return slab_alloc(size);
+    if (size == 0) {
+        slab_free(ptr);
+        return NULL;
+    }
+    // 小对象新大小仍落在同一级时原地返回; 大对象缩小不超过一半时也不搬移
+    span_header_t *h = span_of(ptr);
+    size_t usable = h->size;
+    if (h->class_idx != CLASS_LARGE) {
+        if (size <= SLAB_MAX_SMALL && size_class(size) == h->class_idx) return ptr;
+    } else if (size <= usable && size > usable / 2) {
+        return ptr;
+    }
+    void *fresh = slab_alloc(size);
+    if (!fresh) return NULL;
+    memcpy(fresh, ptr, usable < size ? usable : size);
+    slab_free(ptr);
+    return fresh;
+}
+
+void slab_thread_flush(void) {
+    flush_all(&t_cache);
+}
+
+void slab_get_stats(slab_stats_t *stats) {
+    if (!stats) return;
+    pthread_once(&g_once, slab_init);
+    memset(stats, 0, sizeof(*stats));
+    stats->span_bytes = atomic_load_explicit(&g_span_bytes, memory_order_relaxed);
+    stats->large_allocs = atomic_load_explicit(&g_large_allocs, memory_order_relaxed);
+    stats->large_bytes = atomic_load_explicit(&g_large_bytes, memory_order_relaxed);
+    for (unsigned c = 0; c < SLAB_CLASS_COUNT; c++) {
+        size_class_t *sc = &g_classes[c];
+        stats->classes[c].size = sc->size;
+        stats->classes[c].batch = sc->batch;
+        stats->classes[c].spans = atomic_load_explicit(&sc->spans, memory_order_relaxed);
+        stats->classes[c].refills = atomic_load_explicit(&sc->refills, memory_order_relaxed);
+        stats->classes[c].flushes = atomic_load_explicit(&sc->flushes, memory_order_relaxed);
+    }
+}
+
+void slab_set_hook(slab_hook_fn fn, void *user_data) {
+    atomic_store_explicit(&g_hook_data, user_data, memory_order_relaxed);
+    atomic_store_explicit(&g_hook, fn, memory_order_release);
+}
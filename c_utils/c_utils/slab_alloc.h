@@ -0,0 +1,63 @@
+#ifndef C_UTILS_SLAB_ALLOC_H
+#define C_UTILS_SLAB_ALLOC_H
+
+#include <stddef.h>
+#include <stdbool.h>
+
+// 通用小对象分配器 (全局单例, 线程安全)
+//
+// - 大小分级: 16..128 每 16 字节一级, 之后每个 2 的幂区间再分 4 级, 最大 8KB, 共 32 级
+// - 内存来源: 向页分配器申请 64KB 对齐的 span, 按级切分; span 头记录级别, 释放时按地址掩码找到
+// - 线程缓存: 每线程每级一个空闲链表, 分配/释放的快路径不加锁也不做原子操作
+// - 中心仓库: 线程缓存空了按批补充, 超过上限按批归还; 仓库是无锁的批次栈
+// - 超过 8KB 的对象直接向页分配器申请
+// 所有返回的指针都按 16 字节对齐; 小对象占用的 span 不会归还给系统
+// 线程退出时缓存自动归还, 也可以调用 slab_thread_flush 主动归还
+
+#define SLAB_CLASS_COUNT 32
+#define SLAB_MAX_SMALL 8192
+
+// 慢路径事件, 用于统计钩子
+typedef enum {
+    SLAB_EVENT_SPAN,         // 新申请一个 span (size 为 span 字节数)
+    SLAB_EVENT_REFILL,       // 线程缓存从中心仓库补充一批 (size 为对象大小)
+    SLAB_EVENT_FLUSH,        // 线程缓存向中心仓库归还一批 (size 为对象大小)
+    SLAB_EVENT_LARGE_ALLOC,  // 大对象分配 (size 为请求大小)
+    SLAB_EVENT_LARGE_FREE    // 大对象释放
+} slab_event_t;
+
+// 钩子在慢路径上调用, 可能来自任意线程
+typedef void (*slab_hook_fn)(slab_event_t event, size_t size, void *user_data);
+
+typedef struct {
+    size_t size;             // 对象大小
+    size_t batch;            // 每批对象数
+    size_t spans;            // 已切分的 span 数
+    size_t refills;          // 批量补充次数
+    size_t flushes;          // 批量归还次数
+} slab_class_stats_t;
+
+typedef struct {
+    size_t span_bytes;       // 小对象 span 占用的总字节数
+    size_t large_allocs;     // 当前存活的大对象数
+    size_t large_bytes;      // 当前存活的大对象字节数
+    slab_class_stats_t classes[SLAB_CLASS_COUNT];
+} slab_stats_t;
+
+// 分配与释放 (与 malloc/calloc/realloc/free 语义相同)
+void*  slab_alloc(size_t size);
+void*  slab_calloc(size_t count, size_t size);
+void*  slab_realloc(void *ptr, size_t size);
+void   slab_free(void *ptr);
+
+// 实际可用字节数 (不小于请求大小)
+size_t slab_usable_size(const void *ptr);
+
+// 把当前线程缓存的对象全部归还中心仓库
+void   slab_thread_flush(void);
+
+// 统计与钩子
+void   slab_get_stats(slab_stats_t *stats);
+void   slab_set_hook(slab_hook_fn fn, void *user_data);
+
+#endif // C_UTILS_SLAB_ALLOC_H
@@ -1,23 +1,304 @@
 #include "stats.h"
 #include <math.h>
 #include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+// add_array 每块的样本数: 块内两遍求均值和偏差平方和, 块间按 Chan 公式合并
+#define STATS_ACCUM_BLOCK 256
 
 stats_t stats_compute(const double *data, size_t n) {
-    stats_t s = {DBL_MAX, -DBL_MAX, 0, 0, 0};
-    if (n == 0) return s;
-    double sum = 0;
-    for (size_t i = 0; i < n; i++) {
-        if (data[i] < s.min) s.min = data[i];
-        if (data[i] > s.max) s.max = data[i];
-        sum += data[i];
-    }
-    s.mean = sum / n;
-    double sum_sq_diff = 0;
-    for (size_t i = 0; i < n; i++) {
-        double diff = data[i] - s.mean;
-        sum_sq_diff += diff * diff;
-    }
-    s.variance = sum_sq_diff / n;
+    stats_accum_t acc;
+    stats_accum_init(&acc);
+    if (data) stats_accum_add_array(&acc, data, n);
+    return stats_accum_result(&acc);
+}
+
+/* ---------- 流式累加器 ---------- */
+
+void stats_accum_init(stats_accum_t *acc) {
+    if (!acc) return;
+    memset(acc, 0, sizeof(*acc));
+    acc->min = DBL_MAX;
+    acc->max = -DBL_MAX;
+}
+
+// Neumaier 补偿: 丢掉的低位累积到 comp, 结果为 sum + comp
+static void stats_kahan_add(double *sum, double *comp, double x) {
+    double t = *sum + x;
+    if (fabs(*sum) >= fabs(x)) {
+        *comp += (*sum - t) + x;
+    } else {
+        *comp += (x - t) + *sum;
+    }
+    *sum = t;
+}
+
+// 合并两组 (count, mean, m2)
+static void stats_merge_moments(stats_accum_t *dst, uint64_t count, double mean, double m2) {
+    if (count == 0) return;
+    if (dst->count == 0) {
+        dst->count = count;
+        dst->mean = mean;
+        dst->m2 = m2;
+        return;
+    }
+    double na = (double)dst->count, nb = (double)count, n = na + nb;
+    double delta = mean - dst->mean;
+    dst->mean += delta * (nb / n);
+    dst->m2 += m2 + delta * delta * (na * nb / n);
+    dst->count += count;
+}
+
+void stats_accum_add(stats_accum_t *acc, double x) {
+    if (!acc) return;
+    if (x < acc->min) acc->min = x;
+    if (x > acc->max) acc->max = x;
+    acc->count++;
+    double delta = x - acc->mean;
+    acc->mean += delta / (double)acc->count;
+    acc->m2 += delta * (x - acc->mean);
+    stats_kahan_add(&acc->sum, &acc->sum_comp, x);
+}
+
+void stats_accum_add_array(stats_accum_t *acc, const double *data, size_t n) {
+    if (!acc || !data) return;
+    for (size_t base = 0; base < n; base += STATS_ACCUM_BLOCK) {
+        size_t len = n - base < STATS_ACCUM_BLOCK ? n - base : STATS_ACCUM_BLOCK;
+        const double *blk = data + base;
+        double block_sum = 0.0;
+        for (size_t i = 0; i < len; i++) {
+            double x = blk[i];
+            if (x < acc->min) acc->min = x;
+            if (x > acc->max) acc->max = x;
+            block_sum += x;
+            stats_kahan_add(&acc->sum, &acc->sum_comp, x);
+        }
+        double mean = block_sum / (double)len;
+        double m2 = 0.0, corr = 0.0;
+        for (size_t i = 0; i < len; i++) {
+            double d = blk[i] - mean;
+            m2 += d * d;
+            corr += d;
+        }
+        // 修正块均值的舍入误差 (corrected two-pass)
+        m2 -= corr * corr / (double)len;
+        stats_merge_moments(acc, len, mean + corr / (double)len, m2 > 0.0 ? m2 : 0.0);
+    }
+}
+
+void stats_accum_merge(stats_accum_t *dst, const stats_accum_t *src) {
+    if (!dst || !src || src->count == 0) return;
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    stats_merge_moments(dst, src->count, src->mean, src->m2);
+    stats_kahan_add(&dst->sum, &dst->sum_comp, src->sum);
+    stats_kahan_add(&dst->sum, &dst->sum_comp, src->sum_comp);
+}
+
+stats_t stats_accum_result(const stats_accum_t *acc) {
+    stats_t s = {0, 0, 0, 0, 0};
+    if (!acc || acc->count == 0) return s;
+    s.min = acc->min;
+    s.max = acc->max;
+    // 报告的均值取补偿求和的结果, 比 Welford 递推的均值少一层舍入累积
+    s.mean = (acc->sum + acc->sum_comp) / (double)acc->count;
+    s.variance = acc->m2 / (double)acc->count;
     s.stddev = sqrt(s.variance);
     return s;
 }
+
+double stats_accum_sum(const stats_accum_t *acc) {
+    if (!acc) return 0.0;
+    return acc->sum + acc->sum_comp;
+}
+
+/* ---------- HDR 直方图 ---------- */
+
+// 值 v 的桶号 b 由最高位决定, 桶内按 v >> b 线性细分为 sub_bucket_count 格;
+// 桶 0 覆盖 [0, sub_bucket_count), 之后每个桶只用后半格, 范围翻倍而格数不变
+struct stats_histogram {
+    uint64_t highest_value;
+    int significant_digits;
+    int sub_bucket_half_count_magnitude;
+    uint64_t sub_bucket_count;
+    uint64_t sub_bucket_half_count;
+    uint64_t sub_bucket_mask;
+    int bucket_count;
+    size_t counts_len;
+    uint64_t total_count;
+    uint64_t min;
+    uint64_t max;
+    uint64_t *counts;
+};
+
+static int hist_bucket_index(const stats_histogram_t *h, uint64_t value) {
+    int pow2ceiling = 64 - __builtin_clzll(value | h->sub_bucket_mask);
+    return pow2ceiling - (h->sub_bucket_half_count_magnitude + 1);
+}
+
+static size_t hist_counts_index(const stats_histogram_t *h, uint64_t value) {
+    int bucket = hist_bucket_index(h, value);
+    uint64_t sub = value >> bucket;
+    return ((size_t)(bucket + 1) << h->sub_bucket_half_count_magnitude) + (size_t)(sub - h->sub_bucket_half_count);
+}
+
+// 计数下标对应桶格的下界
+static uint64_t hist_value_at_index(const stats_histogram_t *h, size_t index) {
+    int bucket = (int)(index >> h->sub_bucket_half_count_magnitude) - 1;
+    uint64_t sub = (index & (h->sub_bucket_half_count - 1)) + h->sub_bucket_half_count;
+    if (bucket < 0) {
+        sub -= h->sub_bucket_half_count;
+        bucket = 0;
+    }
+    return sub << bucket;
+}
+
+// 与 value 落在同一格的值的个数
+static uint64_t hist_equivalent_range(const stats_histogram_t *h, uint64_t value) {
+    return (uint64_t)1 << hist_bucket_index(h, value);
+}
+
+stats_histogram_t* stats_histogram_create(uint64_t highest_value, int significant_digits) {
+    if (significant_digits < 1 || significant_digits > 5 || highest_value < 2) return NULL;
+
+    uint64_t single_unit = 2;
+    for (int i = 0; i < significant_digits; i++) single_unit *= 10;
+    int count_magnitude = 0;
+    while (((uint64_t)1 << count_magnitude) < single_unit) count_magnitude++;
+
+    stats_histogram_t *h = calloc(1, sizeof(stats_histogram_t));
+    if (!h) return NULL;
+    h->highest_value = highest_value;
+    h->significant_digits = significant_digits;
+    h->sub_bucket_half_count_magnitude = count_magnitude - 1;
+    h->sub_bucket_count = (uint64_t)1 << count_magnitude;
+    h->sub_bucket_half_count = h->sub_bucket_count / 2;
+    h->sub_bucket_mask = h->sub_bucket_count - 1;
+
+    // 每多一个桶, 可表示的范围翻倍
+    int buckets = 1;
+    uint64_t smallest_untrackable = h->sub_bucket_count;
+    while (smallest_untrackable <= highest_value) {
+        if (smallest_untrackable > UINT64_MAX / 2) {
+            buckets++;
+            break;
+        }
+        smallest_untrackable <<= 1;
+        buckets++;
+    }
+    h->bucket_count = buckets;
+    h->counts_len = (size_t)(buckets + 1) * (size_t)h->sub_bucket_half_count;
+    h->counts = calloc(h->counts_len, sizeof(uint64_t));
+    if (!h->counts) {
+        free(h);
+        return NULL;
+    }
+    h->min = UINT64_MAX;
+    return h;
+}
+
+void stats_histogram_free(stats_histogram_t *h) {
+    if (!h) return;
+    free(h->counts);
+    free(h);
+}
+
+void stats_histogram_reset(stats_histogram_t *h) {
+    if (!h) return;
+    memset(h->counts, 0, h->counts_len * sizeof(uint64_t));
+    h->total_count = 0;
+    h->min = UINT64_MAX;
+    h->max = 0;
+}
+
+bool stats_histogram_record_n(stats_histogram_t *h, uint64_t value, uint64_t count) {
+    if (!h || value > h->highest_value) return false;
+    if (count == 0) return true;
+    size_t index = hist_counts_index(h, value);
+    if (index >= h->counts_len) return false;
+    h->counts[index] += count;
+    h->total_count += count;
+    if (value < h->min) h->min = value;
+    if (value > h->max) h->max = value;
+    return true;
+}
+
+bool stats_histogram_record(stats_histogram_t *h, uint64_t value) {
+    return stats_histogram_record_n(h, value, 1);
+}
+
+bool stats_histogram_merge(stats_histogram_t *dst, const stats_histogram_t *src) {
+    if (!dst || !src) return false;
+    if (src->total_count == 0) return true;
+    if (src->max > dst->highest_value) return false;
+
+    if (src->sub_bucket_count == dst->sub_bucket_count) {
+        // 同精度时桶布局一致, src->max 不超过 dst 范围就保证下标在 dst 内
+        size_t len = src->counts_len < dst->counts_len ? src->counts_len : dst->counts_len;
+        for (size_t i = 0; i < len; i++) dst->counts[i] += src->counts[i];
+        dst->total_count += src->total_count;
+        if (src->min < dst->min) dst->min = src->min;
+        if (src->max > dst->max) dst->max = src->max;
+        return true;
+    }
+    for (size_t i = 0; i < src->counts_len; i++) {
+        if (src->counts[i] == 0) continue;
+        uint64_t value = hist_value_at_index(src, i);
+        if (value < src->min) value = src->min;
+        stats_histogram_record_n(dst, value, src->counts[i]);
+    }
+    // 重新记录只保留了桶的代表值, 极值按原值修正
+    if (src->min < dst->min) dst->min = src->min;
+    if (src->max > dst->max) dst->max = src->max;
+    return true;
+}
+
+uint64_t stats_histogram_percentile(const stats_histogram_t *h, double percentile) {
+    if (!h || h->total_count == 0) return 0;
+    if (percentile < 0.0) percentile = 0.0;
+    if (percentile > 100.0) percentile = 100.0;
+
+    uint64_t target = (uint64_t)(percentile / 100.0 * (double)h->total_count + 0.5);
+    if (target < 1) target = 1;
+    uint64_t seen = 0;
+    for (size_t i = 0; i < h->counts_len; i++) {
+        seen += h->counts[i];
+        if (seen >= target) {
+            uint64_t low = hist_value_at_index(h, i);
+            uint64_t value = low + hist_equivalent_range(h, low) - 1;
+            if (value > h->max) value = h->max;
+            if (value < h->min) value = h->min;
+            return value;
+        }
+    }
+    return h->max;
+}
+
+uint64_t stats_histogram_count(const stats_histogram_t *h) {
+    return h ? h->total_count : 0;
+}
+
+uint64_t stats_histogram_min(const stats_histogram_t *h) {
+    return h && h->total_count ? h->min : 0;
+}
+
+uint64_t stats_histogram_max(const stats_histogram_t *h) {
+    return h ? h->max : 0;
+}
+
+double stats_histogram_mean(const stats_histogram_t *h) {
+    if (!h || h->total_count == 0) return 0.0;
+    double sum = 0.0;
+    for (size_t i = 0; i < h->counts_len; i++) {
+        if (h->counts[i] == 0) continue;
+        uint64_t low = hist_value_at_index(h, i);
+        double mid = (double)low + (double)(hist_equivalent_range(h, low) - 1) / 2.0;
+        sum += mid * (double)h->counts[i];
+    }
+    return sum / (double)h->total_count;
+}
+
+size_t stats_histogram_memory(const stats_histogram_t *h) {
+    return h ? h->counts_len * sizeof(uint64_t) : 0;
+}
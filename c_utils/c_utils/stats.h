@@ -72,7 +72,7 @@ typedef struct {
 } stats_extended_t;
 
 /**
- * @brief 计算基本统计信息
+ * @brief 计算基本统计信息 (单遍, 方差为总体方差; n 为 0 时全为 0)
  * @param data 数据数组
  * @param n 数据大小
  * @return 统计结果
@@ -280,4 +280,156 @@ void stats_config_init(stats_config_t *config);
  */
 void stats_state_init(stats_state_t *state);
 
+/**
+ * @brief 单遍流式统计累加器
+ * 均值和偏差平方和用 Welford 递推, 总和用 Kahan-Neumaier 补偿求和;
+ * 不保存样本, 多个累加器可按 Chan 公式合并 (例如每线程一个, 最后合并)
+ */
+typedef struct {
+    uint64_t count;
+    double min;
+    double max;
+    double mean;
+    double m2;          // 与均值偏差的平方和
+    double sum;         // 补偿求和的主值
+    double sum_comp;    // 补偿项
+} stats_accum_t;
+
+/**
+ * @brief HDR 直方图 (对数-线性分桶的分位数草图)
+ * 记录 [0, highest_value] 内的非负整数 (如纳秒延迟), 按有效数字保持相对精度,
+ * 内存只与范围和精度有关, 与样本数无关; 同配置的直方图可精确合并
+ */
+typedef struct stats_histogram stats_histogram_t;
+
+/**
+ * @brief 初始化累加器
+ * @param acc 累加器
+ */
+void stats_accum_init(stats_accum_t *acc);
+
+/**
+ * @brief 累加一个样本
+ * @param acc 累加器
+ * @param x 样本值
+ */
+void stats_accum_add(stats_accum_t *acc, double x);
+
+/**
+ * @brief 累加一段数据 (分块两遍后合并, 比逐个累加更快且同样稳定)
+ * @param acc 累加器
+ * @param data 数据数组
+ * @param n 数据大小
+ */
+void stats_accum_add_array(stats_accum_t *acc, const double *data, size_t n);
+
+/**
+ * @brief 把 src 合并进 dst
+ * @param dst 目标累加器
+ * @param src 源累加器
+ */
+void stats_accum_merge(stats_accum_t *dst, const stats_accum_t *src);
+
+/**
+ * @brief 取出统计结果 (方差为总体方差), 没有样本时全为 0
+ * @param acc 累加器
+ * @return 统计结果
+ */
+stats_t stats_accum_result(const stats_accum_t *acc);
+
+/**
+ * @brief 补偿求和得到的总和
+ * @param acc 累加器
+ * @return 总和
+ */
+double stats_accum_sum(const stats_accum_t *acc);
+
+/**
+ * @brief 创建 HDR 直方图
+ * @param highest_value 可记录的最大值 (至少为 2)
+ * @param significant_digits 有效数字位数 (1-5), 3 位时相对误差不超过 0.1%
+ * @return 直方图, 参数非法或内存不足返回 NULL
+ */
+stats_histogram_t* stats_histogram_create(uint64_t highest_value, int significant_digits);
+
+/**
+ * @brief 销毁直方图
+ * @param h 直方图
+ */
+void stats_histogram_free(stats_histogram_t *h);
+
+/**
+ * @brief 清空计数, 保留配置
+ * @param h 直方图
+ */
+void stats_histogram_reset(stats_histogram_t *h);
+
+/**
+ * @brief 记录一个值
+ * @param h 直方图
+ * @param value 值
+ * @return 超出 highest_value 返回 false
+ */
+bool stats_histogram_record(stats_histogram_t *h, uint64_t value);
+
+/**
+ * @brief 记录同一个值 count 次
+ * @param h 直方图
+ * @param value 值
+ * @param count 次数
+ * @return 超出 highest_value 返回 false
+ */
+bool stats_histogram_record_n(stats_histogram_t *h, uint64_t value, uint64_t count);
+
+/**
+ * @brief 把 src 合并进 dst; 精度相同时按桶相加, 否则按桶的代表值重新记录
+ * @param dst 目标直方图
+ * @param src 源直方图
+ * @return src 中有超出 dst 范围的值返回 false (此时 dst 不变)
+ */
+bool stats_histogram_merge(stats_histogram_t *dst, const stats_histogram_t *src);
+
+/**
+ * @brief 分位数
+ * @param h 直方图
+ * @param percentile 百分位 (0-100)
+ * @return 至少有 percentile% 的样本不大于的值 (取所在桶的上界, 限制在记录到的最小/最大值之间), 空直方图返回 0
+ */
+uint64_t stats_histogram_percentile(const stats_histogram_t *h, double percentile);
+
+/**
+ * @brief 样本数
+ * @param h 直方图
+ * @return 样本数
+ */
+uint64_t stats_histogram_count(const stats_histogram_t *h);
+
+/**
+ * @brief 记录到的最小值, 空直方图返回 0
+ * @param h 直方图
+ * @return 最小值
+ */
+uint64_t stats_histogram_min(const stats_histogram_t *h);
+
+/**
+ * @brief 记录到的最大值, 空直方图返回 0
+ * @param h 直方图
+ * @return 最大值
+ */
+uint64_t stats_histogram_max(const stats_histogram_t *h);
+
+/**
+ * @brief 按各桶中点估计的均值
+ * @param h 直方图
+ * @return 均值, 空直方图返回 0
+ */
+double stats_histogram_mean(const stats_histogram_t *h);
+
+/**
+ * @brief 计数数组占用的字节数
+ * @param h 直方图
+ * @return 字节数
+ */
+size_t stats_histogram_memory(const stats_histogram_t *h);
+
 #endif // C_UTILS_STATS_H
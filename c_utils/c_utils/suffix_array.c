@@ -1,47 +1,283 @@
 #include "suffix_array.h"
 #include <string.h>
 #include <stdlib.h>
+#include <limits.h>
 
-typedef struct { int index; int rank[2]; } suffix_t;
+// SA-IS (Nong, Zhang & Chan): 按 S/L 类型找出 LMS 子串, 诱导排序后命名,
+// 若有重名则对缩减串递归, 最后由有序的 LMS 后缀再诱导一次得到完整后缀数组。
+// 串尾视为一个虚拟哨兵 (比所有字符都小, 唯一的 LMS 且不占 sa 的位置)。
 
-static int compare(const void *a, const void *b) {
-    suffix_t *s1 = (suffix_t*)a;
-    suffix_t *s2 = (suffix_t*)b;
-    if (s1->rank[0] != s2->rank[0]) return s1->rank[0] - s2->rank[0];
-    return s1->rank[1] - s2->rank[1];
+#define SAIS_EMPTY (-1)
+
+// cs 为 1 时按字节读取, 否则按 int 读取 (递归层的缩减串)
+static inline int sais_chr(const void *s, int cs, int i) {
+    return cs == 1 ? ((const uint8_t *)s)[i] : ((const int *)s)[i];
 }
 
-void suffix_array_build(const char *s, int *sa) {
-    int n = (int)strlen(s);
-    suffix_t *suffixes = malloc(n * sizeof(suffix_t));
+// 类型位图: 1 为 S 型, 0 为 L 型
+static inline bool sais_is_s(const uint8_t *t, int i) {
+    return (t[i >> 3] >> (i & 7)) & 1;
+}
+
+static inline void sais_set_s(uint8_t *t, int i) {
+    t[i >> 3] |= (uint8_t)(1u << (i & 7));
+}
+
+// 位置 n 的虚拟哨兵由调用方单独处理
+static inline bool sais_is_lms(const uint8_t *t, int i) {
+    return i > 0 && sais_is_s(t, i) && !sais_is_s(t, i - 1);
+}
+
+// end 为 true 时得到各桶的尾后位置, 否则得到桶头
+static void sais_buckets(const void *s, int cs, int n, int k, int *bkt, bool end) {
+    memset(bkt, 0, (size_t)k * sizeof(int));
+    for (int i = 0; i < n; i++) bkt[sais_chr(s, cs, i)]++;
+    int sum = 0;
+    for (int c = 0; c < k; c++) {
+        sum += bkt[c];
+        bkt[c] = end ? sum : sum - bkt[c];
+    }
+}
+
+static void sais_induce_l(const void *s, int cs, const uint8_t *t, int *sa, int n, int k, int *bkt) {
+    sais_buckets(s, cs, n, k, bkt, false);
+    // 虚拟哨兵排在最前, 它前面的 n-1 一定是 L 型
+    sa[bkt[sais_chr(s, cs, n - 1)]++] = n - 1;
+    for (int i = 0; i < n; i++) {
+        int j = sa[i] - 1;
+        if (j >= 0 && !sais_is_s(t, j)) sa[bkt[sais_chr(s, cs, j)]++] = j;
+    }
+}
+
+static void sais_induce_s(const void *s, int cs, const uint8_t *t, int *sa, int n, int k, int *bkt) {
+    sais_buckets(s, cs, n, k, bkt, true);
+    for (int i = n - 1; i >= 0; i--) {
+        int j = sa[i] - 1;
+        if (j >= 0 && sais_is_s(t, j)) sa[--bkt[sais_chr(s, cs, j)]] = j;
+    }
+}
+
+// work/work_len: 上一层 sa 中未使用的区间, 桶数组放得下时借用, 避免再分配
+static bool sais_core(const void *s, int cs, int *sa, int n, int k, int *work, int work_len) {
+    uint8_t *t = calloc((size_t)n / 8 + 1, 1);
+    if (!t) return false;
+    int *bkt = k <= work_len ? work : malloc((size_t)k * sizeof(int));
+    if (!bkt) {
+        free(t);
+        return false;
+    }
+
+    // 末字符大于哨兵, 为 L 型
+    for (int i = n - 2; i >= 0; i--) {
+        int a = sais_chr(s, cs, i), b = sais_chr(s, cs, i + 1);
+        if (a < b || (a == b && sais_is_s(t, i + 1))) sais_set_s(t, i);
+    }
+
+    // 阶段 1: LMS 位置放到各桶尾部, 诱导排序得到有序的 LMS 子串
+    sais_buckets(s, cs, n, k, bkt, true);
+    for (int i = 0; i < n; i++) sa[i] = SAIS_EMPTY;
+    for (int i = 1; i < n; i++) {
+        if (sais_is_lms(t, i)) sa[--bkt[sais_chr(s, cs, i)]] = i;
+    }
+    sais_induce_l(s, cs, t, sa, n, k, bkt);
+    sais_induce_s(s, cs, t, sa, n, k, bkt);
+
+    // 有序的 LMS 子串压到前 n1 个位置
+    int n1 = 0;
     for (int i = 0; i < n; i++) {
-        suffixes[i].index = i;
-        suffixes[i].rank[0] = s[i] - 'a';
-        suffixes[i].rank[1] = ((i + 1) < n) ? (s[i + 1] - 'a') : -1;
-    }
-    qsort(suffixes, n, sizeof(suffix_t), compare);
-    int *ind = malloc(n * sizeof(int));
-    for (int k = 4; k < 2 * n; k = k * 2) {
-        int rank = 0;
-        int prev_rank = suffixes[0].rank[0];
-        suffixes[0].rank[0] = rank;
-        ind[suffixes[0].index] = 0;
-        for (int i = 1; i < n; i++) {
-            if (suffixes[i].rank[0] == prev_rank && suffixes[i].rank[1] == suffixes[i - 1].rank[1]) {
-                prev_rank = suffixes[i].rank[0];
-                suffixes[i].rank[0] = rank;
-            } else {
-                prev_rank = suffixes[i].rank[0];
-                suffixes[i].rank[0] = ++rank;
+        if (sais_is_lms(t, sa[i])) sa[n1++] = sa[i];
+    }
+
+    // 命名: 相邻两个 LMS 子串逐字符比较字符和类型; 名字按位置存到 sa[n1 + pos/2]
+    // (LMS 位置至少相隔 2 且不超过 n-2, 所以不会冲突也不会越界)
+    for (int i = n1; i < n; i++) sa[i] = SAIS_EMPTY;
+    int name = 0, prev = -1;
+    for (int i = 0; i < n1; i++) {
+        int pos = sa[i];
+        bool diff = false;
+        for (int d = 0;; d++) {
+            // 到达哨兵的子串是唯一的
+            if (prev == -1 || pos + d == n || prev + d == n ||
+                sais_chr(s, cs, pos + d) != sais_chr(s, cs, prev + d) ||
+                sais_is_s(t, pos + d) != sais_is_s(t, prev + d)) {
+                diff = true;
+                break;
             }
-            ind[suffixes[i].index] = i;
+            if (d > 0 && (sais_is_lms(t, pos + d) || sais_is_lms(t, prev + d))) break;
         }
-        for (int i = 0; i < n; i++) {
-            int nextindex = suffixes[i].index + k / 2;
-            suffixes[i].rank[1] = (nextindex < n) ? suffixes[ind[nextindex]].rank[0] : -1;
+        if (diff) {
+            name++;
+            prev = pos;
         }
-        qsort(suffixes, n, sizeof(suffix_t), compare);
+        sa[n1 + pos / 2] = name - 1;
+    }
+    for (int i = n - 1, j = n - 1; i >= n1; i--) {
+        if (sa[i] >= 0) sa[j--] = sa[i];
+    }
+
+    // 阶段 2: 缩减串放在 sa 尾部, 其后缀数组写到 sa 头部; 名字全不同时直接得到
+    int *sa1 = sa, *s1 = sa + n - n1;
+    if (bkt != work) free(bkt);
+    bkt = NULL;
+    if (name < n1) {
+        if (!sais_core(s1, (int)sizeof(int), sa1, n1, name, sa + n1, n - 2 * n1)) {
+            free(t);
+            return false;
+        }
+    } else {
+        for (int i = 0; i < n1; i++) sa1[s1[i]] = i;
+    }
+
+    // 阶段 3: 有序的 LMS 后缀按逆序放回各桶尾部, 再诱导一次
+    bkt = k <= work_len ? work : malloc((size_t)k * sizeof(int));
+    if (!bkt) {
+        free(t);
+        return false;
+    }
+    for (int i = 1, j = 0; i < n; i++) {
+        if (sais_is_lms(t, i)) s1[j++] = i;
+    }
+    for (int i = 0; i < n1; i++) sa1[i] = s1[sa1[i]];
+    for (int i = n1; i < n; i++) sa[i] = SAIS_EMPTY;
+    sais_buckets(s, cs, n, k, bkt, true);
+    for (int i = n1 - 1; i >= 0; i--) {
+        int j = sa[i];
+        sa[i] = SAIS_EMPTY;
+        sa[--bkt[sais_chr(s, cs, j)]] = j;
     }
-    for (int i = 0; i < n; i++) sa[i] = suffixes[i].index;
-    free(suffixes); free(ind);
+    sais_induce_l(s, cs, t, sa, n, k, bkt);
+    sais_induce_s(s, cs, t, sa, n, k, bkt);
+
+    if (bkt != work) free(bkt);
+    free(t);
+    return true;
+}
+
+suffix_array_error_t suffix_array_sais(const uint8_t *s, size_t n, int *sa) {
+    if (n == 0) return SUFFIX_ARRAY_OK;
+    if (!s || !sa) return SUFFIX_ARRAY_ERROR_INVALID_PARAMS;
+    if (n > (size_t)INT_MAX) return SUFFIX_ARRAY_ERROR_STRING_TOO_LONG;
+    return sais_core(s, 1, sa, (int)n, 256, NULL, 0) ? SUFFIX_ARRAY_OK : SUFFIX_ARRAY_ERROR_MEMORY;
+}
+
+suffix_array_error_t suffix_array_sais_int(const int *s, size_t n, int alphabet, int *sa) {
+    if (n == 0) return SUFFIX_ARRAY_OK;
+    if (!s || !sa || alphabet <= 0) return SUFFIX_ARRAY_ERROR_INVALID_PARAMS;
+    if (n > (size_t)INT_MAX) return SUFFIX_ARRAY_ERROR_STRING_TOO_LONG;
+    for (size_t i = 0; i < n; i++) {
+        if (s[i] < 0 || s[i] >= alphabet) return SUFFIX_ARRAY_ERROR_INVALID_PARAMS;
+    }
+    return sais_core(s, (int)sizeof(int), sa, (int)n, alphabet, NULL, 0) ? SUFFIX_ARRAY_OK
+                                                                            : SUFFIX_ARRAY_ERROR_MEMORY;
+}
+
+void suffix_array_build(const char *s, int *sa) {
+    if (!s) return;
+    suffix_array_sais((const uint8_t *)s, strlen(s), sa);
+}
+
+static suffix_array_error_t sa_result(suffix_array_state_t *state, suffix_array_error_t err) {
+    if (state) state->last_error = err;
+    return err;
+}
+
+suffix_array_error_t suffix_array_build_rank(const int *sa, int *rank, size_t n, suffix_array_state_t *state) {
+    if (n > 0 && (!sa || !rank)) return sa_result(state, SUFFIX_ARRAY_ERROR_INVALID_PARAMS);
+    for (size_t i = 0; i < n; i++) rank[sa[i]] = (int)i;
+    return sa_result(state, SUFFIX_ARRAY_OK);
+}
+
+suffix_array_error_t suffix_array_build_lcp(const char *s, const int *sa, const int *rank,
+                                            int *lcp, size_t n, suffix_array_state_t *state) {
+    if (n == 0) return sa_result(state, SUFFIX_ARRAY_OK);
+    if (!s || !sa || !lcp) return sa_result(state, SUFFIX_ARRAY_ERROR_INVALID_PARAMS);
+    int *own = NULL;
+    if (!rank) {
+        own = malloc(n * sizeof(int));
+        if (!own) return sa_result(state, SUFFIX_ARRAY_ERROR_MEMORY);
+        suffix_array_build_rank(sa, own, n, NULL);
+        rank = own;
+    }
+
+    // 按文本顺序处理后缀: 后缀 i 与前驱的公共前缀至少是后缀 i-1 的减一
+    const uint8_t *u = (const uint8_t *)s;
+    size_t h = 0;
+    lcp[0] = 0;
+    for (size_t i = 0; i < n; i++) {
+        int r = rank[i];
+        if (r == 0) {
+            h = 0;
+            continue;
+        }
+        size_t j = (size_t)sa[r - 1];
+        while (i + h < n && j + h < n && u[i + h] == u[j + h]) h++;
+        lcp[r] = (int)h;
+        if (h > 0) h--;
+    }
+    free(own);
+    return sa_result(state, SUFFIX_ARRAY_OK);
+}
+
+// 从已知的公共前缀 *k 开始比较后缀 pos 与模式的前 m 个字节, 并更新 *k
+// 返回: 后缀小于模式为负, 以模式为前缀为 0, 大于为正
+static int sa_compare(const uint8_t *s, size_t n, size_t pos, const uint8_t *p, size_t m, size_t *k) {
+    size_t i = *k;
+    while (i < m && pos + i < n && s[pos + i] == p[i]) i++;
+    *k = i;
+    if (i == m) return 0;
+    if (pos + i == n) return -1;
+    return s[pos + i] < p[i] ? -1 : 1;
+}
+
+// 在 sa[lo, hi) 中二分: upper 为 false 时求第一个不小于模式的位置, 为 true 时求第一个大于模式的位置
+// lo_lcp/hi_lcp 为模式与区间两侧后缀的公共前缀, 区间内的后缀至少共享两者的较小值
+static size_t sa_bound(const uint8_t *s, size_t n, const int *sa, size_t lo, size_t hi, size_t lo_lcp,
+                       const uint8_t *p, size_t m, bool upper) {
+    size_t hi_lcp = 0;
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        size_t k = lo_lcp < hi_lcp ? lo_lcp : hi_lcp;
+        int c = sa_compare(s, n, (size_t)sa[mid], p, m, &k);
+        if (c < 0 || (upper && c == 0)) {
+            lo = mid + 1;
+            lo_lcp = k;
+        } else {
+            hi = mid;
+            hi_lcp = k;
+        }
+    }
+    return lo;
+}
+
+suffix_array_error_t suffix_array_search_n(const char *s, const int *sa, size_t n,
+                                           const char *pattern, size_t m,
+                                           size_t *start, size_t *end,
+                                           suffix_array_state_t *state) {
+    if (!s || !sa || !pattern || !start || !end) return sa_result(state, SUFFIX_ARRAY_ERROR_INVALID_PARAMS);
+    if (m == 0) return sa_result(state, SUFFIX_ARRAY_ERROR_PATTERN_EMPTY);
+    const uint8_t *u = (const uint8_t *)s, *p = (const uint8_t *)pattern;
+    *start = sa_bound(u, n, sa, 0, n, 0, p, m, false);
+    *end = *start;
+    if (*start < n) {
+        size_t k = 0;
+        if (sa_compare(u, n, (size_t)sa[*start], p, m, &k) == 0) {
+            // 上界只需在 start 之后找, 且左侧后缀与模式完全匹配
+            *end = sa_bound(u, n, sa, *start + 1, n, m, p, m, true);
+        }
+    }
+    if (state) state->queries++;
+    return sa_result(state, SUFFIX_ARRAY_OK);
+}
+
+suffix_array_error_t suffix_array_search(const char *s, const int *sa, size_t n,
+                                         const char *pattern, size_t *start, size_t *end,
+                                         suffix_array_state_t *state) {
+    if (!pattern) return sa_result(state, SUFFIX_ARRAY_ERROR_INVALID_PARAMS);
+    return suffix_array_search_n(s, sa, n, pattern, strlen(pattern), start, end, state);
+}
+
+size_t suffix_array_count(const char *s, const int *sa, size_t n, const char *pattern, size_t m) {
+    size_t start, end;
+    if (suffix_array_search_n(s, sa, n, pattern, m, &start, &end, NULL) != SUFFIX_ARRAY_OK) return 0;
+    return end - start;
 }
@@ -64,12 +64,35 @@ typedef struct {
 } suffix_array_t;
 
 /**
- * @brief 极简后缀数组构建 (倍增法简化版)
- * @param s 输入字符串
- * @param sa 输出后缀数组
+ * @brief 后缀数组构建 (SA-IS, 线性时间)
+ * @param s 输入字符串 (以 '\0' 结尾, 长度取 strlen)
+ * @param sa 输出后缀数组, 至少 strlen(s) 个元素
  */
 void suffix_array_build(const char *s, int *sa);
 
+/**
+ * @brief SA-IS 构建任意字节串的后缀数组 (可含 '\0')
+ * 末尾视为一个比所有字节都小的虚拟哨兵, 不占 sa 的位置
+ * 内存: sa 之外每层递归一个 n/8 字节的类型位图, 合计不超过 n/4 字节;
+ * 递归层的桶数组优先放在 sa 中间的空闲区, 放不下时另外分配 (最坏约 2n 字节)
+ * 1GB 输入的峰值约为 4GB (sa) + 256MB
+ * @param s 输入字节串
+ * @param n 长度, 不超过 INT_MAX
+ * @param sa 输出后缀数组, n 个元素
+ * @return 错误码
+ */
+suffix_array_error_t suffix_array_sais(const uint8_t *s, size_t n, int *sa);
+
+/**
+ * @brief SA-IS 构建整数串的后缀数组
+ * @param s 输入整数串, 每个值在 [0, alphabet) 内
+ * @param n 长度, 不超过 INT_MAX
+ * @param alphabet 字母表大小 (另需 alphabet 个 int 的桶数组)
+ * @param sa 输出后缀数组, n 个元素
+ * @return 错误码, 值越界返回 SUFFIX_ARRAY_ERROR_INVALID_PARAMS
+ */
+suffix_array_error_t suffix_array_sais_int(const int *s, size_t n, int alphabet, int *sa);
+
 /**
  * @brief 增强版后缀数组构建
  * @param s 输入字符串
@@ -101,11 +124,12 @@ suffix_array_error_t suffix_array_create(const char *s,
 suffix_array_error_t suffix_array_free(suffix_array_t *sa);
 
 /**
- * @brief 构建LCP数组
- * @param s 输入字符串
+ * @brief 构建LCP数组 (Kasai 算法, 线性时间)
+ * lcp[i] 为后缀 sa[i-1] 与 sa[i] 的最长公共前缀长度, lcp[0] 为 0
+ * @param s 输入字符串 (按 n 个字节处理, 可含 '\0')
  * @param sa 后缀数组
- * @param rank rank数组
- * @param lcp 输出LCP数组
+ * @param rank rank数组, 为 NULL 时内部临时分配 4n 字节
+ * @param lcp 输出LCP数组, n 个元素
  * @param n 字符串长度
  * @param state 状态输出
  * @return 错误码
@@ -132,6 +156,8 @@ suffix_array_error_t suffix_array_build_rank(const int *sa,
 
 /**
  * @brief 二分查找模式
+ * 以模式为前缀的后缀在 sa 中连续, 输出其区间 [start, end), 未出现时 start == end;
+ * 二分时记录模式与上下界的公共前缀, 每次比较从两者较小值处开始
  * @param s 输入字符串
  * @param sa 后缀数组
  * @param n 字符串长度
@@ -149,6 +175,38 @@ suffix_array_error_t suffix_array_search(const char *s,
                                         size_t *end,
                                         suffix_array_state_t *state);
 
+/**
+ * @brief 二分查找任意字节模式 (显式长度, 可含 '\0')
+ * @param s 输入字符串
+ * @param sa 后缀数组
+ * @param n 字符串长度
+ * @param pattern 模式
+ * @param m 模式长度
+ * @param start 输出起始位置
+ * @param end 输出结束位置
+ * @param state 状态输出
+ * @return 错误码
+ */
+suffix_array_error_t suffix_array_search_n(const char *s,
+                                          const int *sa,
+                                          size_t n,
+                                          const char *pattern,
+                                          size_t m,
+                                          size_t *start,
+                                          size_t *end,
+                                          suffix_array_state_t *state);
+
+/**
+ * @brief 统计模式出现次数
+ * @param s 输入字符串
+ * @param sa 后缀数组
+ * @param n 字符串长度
+ * @param pattern 模式
+ * @param m 模式长度
+ * @return 出现次数, 参数非法或模式为空返回 0
+ */
+size_t suffix_array_count(const char *s, const int *sa, size_t n, const char *pattern, size_t m);
+
 /**
  * @brief 获取最长公共前缀
  * @param s 输入字符串
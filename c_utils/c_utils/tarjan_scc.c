@@ -1,5 +1,6 @@
 #include "tarjan_scc.h"
 #include <stdbool.h>
+#include <stdlib.h>
 
 static int disc[TARJAN_MAX_NODES], low[TARJAN_MAX_NODES], stack[TARJAN_MAX_NODES];
 static bool on_stack[TARJAN_MAX_NODES];
@@ -35,3 +36,79 @@ int tarjan_scc(tarjan_graph_t *g, int *scc_map) {
     for (int i = 0; i < g->n; i++) { if (disc[i] == -1) find_scc(i, g, scc_map); }
     return scc_count;
 }
+
+// 显式调用栈: 每层记录节点和下一条待处理出边的位置
+int tarjan_scc_csr(const graph_csr_t *g, int *scc_map) {
+    if (!g || !scc_map) return -1;
+    size_t n = g->nodes;
+    int *index = malloc(n * sizeof(int));
+    int *lowlink = malloc(n * sizeof(int));
+    int *scc_stack = malloc(n * sizeof(int));
+    int *call_node = malloc(n * sizeof(int));
+    size_t *call_edge = malloc(n * sizeof(size_t));
+    if (!index || !lowlink || !scc_stack || !call_node || !call_edge) {
+        free(index);
+        free(lowlink);
+        free(scc_stack);
+        free(call_node);
+        free(call_edge);
+        return -1;
+    }
+
+    // scc_map 兼作 "在栈上" 标记: -1 未完成, >= 0 已归入分量
+    for (size_t i = 0; i < n; i++) {
+        index[i] = -1;
+        scc_map[i] = -1;
+    }
+
+    int counter = 0, count = 0;
+    size_t stack_top = 0;
+    for (size_t root = 0; root < n; root++) {
+        if (index[root] != -1) continue;
+        size_t depth = 0;
+        call_node[0] = (int)root;
+        call_edge[0] = g->offsets[root];
+        index[root] = lowlink[root] = counter++;
+        scc_stack[stack_top++] = (int)root;
+
+        while (true) {
+            int u = call_node[depth];
+            size_t e = call_edge[depth];
+            if (e < g->offsets[u + 1]) {
+                call_edge[depth] = e + 1;
+                int v = g->targets[e];
+                if (index[v] == -1) {
+                    index[v] = lowlink[v] = counter++;
+                    scc_stack[stack_top++] = v;
+                    depth++;
+                    call_node[depth] = v;
+                    call_edge[depth] = g->offsets[v];
+                } else if (scc_map[v] == -1 && index[v] < lowlink[u]) {
+                    lowlink[u] = index[v];
+                }
+                continue;
+            }
+
+            // u 的出边处理完毕
+            if (lowlink[u] == index[u]) {
+                int v;
+                do {
+                    v = scc_stack[--stack_top];
+                    scc_map[v] = count;
+                } while (v != u);
+                count++;
+            }
+            if (depth == 0) break;
+            depth--;
+            int p = call_node[depth];
+            if (lowlink[u] < lowlink[p]) lowlink[p] = lowlink[u];
+        }
+    }
+
+    free(index);
+    free(lowlink);
+    free(scc_stack);
+    free(call_node);
+    free(call_edge);
+    return count;
+}
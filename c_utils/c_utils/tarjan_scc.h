@@ -4,6 +4,7 @@
 #include <stddef.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include "graph_csr.h"
 
 #define TARJAN_MAX_NODES 100
 
@@ -71,6 +72,14 @@ typedef struct {
  */
 int tarjan_scc(tarjan_graph_t *g, int *scc_map);
 
+/**
+ * @brief CSR 图上的 SCC (迭代实现, 不受递归深度和 TARJAN_MAX_NODES 限制)
+ * @param g CSR 图
+ * @param scc_map 输出每个节点的分量编号, 按分量完成顺序编号 (即分量图的逆拓扑序)
+ * @return SCC数量，参数错误或内存不足返回-1
+ */
+int tarjan_scc_csr(const graph_csr_t *g, int *scc_map);
+
 /**
  * @brief 增强版SCC计算
  * @param g 图结构体
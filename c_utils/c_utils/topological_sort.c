@@ -1,4 +1,5 @@
 #include "topological_sort.h"
+#include <stdlib.h>
 
 bool topological_sort(int n, int adj[10][10], int result[10]) {
     int in_degree[10] = {0};
@@ -18,3 +19,28 @@ bool topological_sort(int n, int adj[10][10], int result[10]) {
     }
     return count == n;
 }
+
+// 结果数组同时作为队列使用
+topological_sort_error_t topological_sort_csr(const graph_csr_t* g, int* result, size_t* size) {
+    if (!g || !result || !size) return TOPOLOGICAL_SORT_INVALID_PARAMS;
+    size_t n = g->nodes;
+    int* in_degree = calloc(n ? n : 1, sizeof(int));
+    if (!in_degree) return TOPOLOGICAL_SORT_MEMORY_ERROR;
+
+    for (size_t i = 0; i < g->edges; i++) in_degree[g->targets[i]]++;
+    size_t tail = 0;
+    for (size_t v = 0; v < n; v++) {
+        if (in_degree[v] == 0) result[tail++] = (int)v;
+    }
+    for (size_t head = 0; head < tail; head++) {
+        const int* to;
+        size_t degree = graph_csr_neighbors(g, result[head], &to, NULL);
+        for (size_t i = 0; i < degree; i++) {
+            if (--in_degree[to[i]] == 0) result[tail++] = to[i];
+        }
+    }
+
+    free(in_degree);
+    *size = tail;
+    return tail == n ? TOPOLOGICAL_SORT_OK : TOPOLOGICAL_SORT_CYCLE_DETECTED;
+}
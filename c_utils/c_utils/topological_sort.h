@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include "graph_csr.h"
 
 // 拓扑排序错误码
 typedef enum {
@@ -61,6 +62,11 @@ topological_sort_error_t topological_sort_execute(topological_sort_ctx_t* ctx, i
 // 如果返回 false 表示失败
 bool topological_sort(int n, int adj[10][10], int result[10]);
 
+// CSR 图上的拓扑排序 (Kahn 算法)
+// result 至少 g->nodes 项, size 输出已排序的节点数; 存在环时返回 TOPOLOGICAL_SORT_CYCLE_DETECTED,
+// 此时 result 中是不在环上也不依赖环的节点
+topological_sort_error_t topological_sort_csr(const graph_csr_t* g, int* result, size_t* size);
+
 // 获取最后一次错误信息
 const char* topological_sort_strerror(topological_sort_error_t error);
 
@@ -1,29 +1,659 @@
 #include "trie.h"
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <ctype.h>
 
-// 创建新节点
-static trie_node_t* trie_node_create(void) {
-    trie_node_t *node = calloc(1, sizeof(trie_node_t));
-    return node;
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRIE_HAVE_SSE2 1
+#endif
+
+// 自适应基数树 (ART)
+//
+// 键在内部以 '\0' 结尾参与比较, 因此任何键都不是另一个键的前缀, 叶子只出现在树的末端.
+// 节点前缀最多内联保存 ART_MAX_PREFIX 字节, 更长的前缀在查找时乐观跳过,
+// 最终由叶子中的完整键确认; 插入/删除需要完整前缀时从子树最小叶子中恢复.
+#define ART_MAX_PREFIX 9
+
+enum {
+    ART_NODE4 = 1,
+    ART_NODE16,
+    ART_NODE48,
+    ART_NODE256
+};
+
+struct trie_node_s {
+    uint32_t partial_len;
+    uint16_t num_children;
+    uint8_t type;
+    uint8_t partial[ART_MAX_PREFIX];
+};
+
+typedef struct {
+    trie_node_t n;
+    uint8_t keys[4];
+    trie_node_t *children[4];
+} art_node4_t;
+
+typedef struct {
+    trie_node_t n;
+    uint8_t keys[16];
+    trie_node_t *children[16];
+} art_node16_t;
+
+// child_index 保存 children 下标 + 1, 0 表示不存在
+typedef struct {
+    trie_node_t n;
+    uint8_t child_index[256];
+    trie_node_t *children[48];
+} art_node48_t;
+
+typedef struct {
+    trie_node_t n;
+    trie_node_t *children[256];
+} art_node256_t;
+
+// 叶子: key_len 包含结尾的 '\0'
+typedef struct {
+    void *value;
+    size_t key_len;
+    char key[];
+} art_leaf_t;
+
+// 叶子指针最低位置 1 与内部节点区分
+#define ART_IS_LEAF(x) (((uintptr_t)(x)) & 1)
+#define ART_SET_LEAF(x) ((trie_node_t *)((uintptr_t)(x) | 1))
+#define ART_LEAF_RAW(x) ((art_leaf_t *)((uintptr_t)(x) & ~(uintptr_t)1))
+
+#define ART_MIN(a, b) ((a) < (b) ? (a) : (b))
+
+// 调用方传入的键, 大小写不敏感时转换到小写副本
+typedef struct {
+    const unsigned char *bytes;
+    size_t len;
+    unsigned char *heap;
+    unsigned char stack[128];
+} trie_key_t;
+
+static bool trie_key_init(const trie_t *t, const char *key, trie_key_t *k) {
+    size_t len = strlen(key) + 1;
+    k->heap = NULL;
+    k->len = len;
+    if (t->config.case_sensitive) {
+        k->bytes = (const unsigned char *)key;
+        return true;
+    }
+
+    unsigned char *buf = k->stack;
+    if (len > sizeof(k->stack)) {
+        buf = k->heap = malloc(len);
+        if (!buf) return false;
+    }
+    for (size_t i = 0; i < len; i++) {
+        buf[i] = (unsigned char)tolower((unsigned char)key[i]);
+    }
+    k->bytes = buf;
+    return true;
+}
+
+static void trie_key_release(trie_key_t *k) {
+    free(k->heap);
+}
+
+static size_t art_node_size(uint8_t type) {
+    switch (type) {
+        case ART_NODE4: return sizeof(art_node4_t);
+        case ART_NODE16: return sizeof(art_node16_t);
+        case ART_NODE48: return sizeof(art_node48_t);
+        default: return sizeof(art_node256_t);
+    }
+}
+
+static trie_node_t *art_alloc_node(trie_t *t, uint8_t type) {
+    size_t size = art_node_size(type);
+    trie_node_t *n = calloc(1, size);
+    if (!n) return NULL;
+    n->type = type;
+    t->memory_usage += size;
+    return n;
+}
+
+static void art_release_node(trie_t *t, trie_node_t *n) {
+    t->memory_usage -= art_node_size(n->type);
+    free(n);
+}
+
+static art_leaf_t *art_make_leaf(trie_t *t, const unsigned char *key, size_t len, void *value) {
+    art_leaf_t *l = malloc(sizeof(art_leaf_t) + len);
+    if (!l) return NULL;
+    l->value = value;
+    l->key_len = len;
+    memcpy(l->key, key, len);
+    t->memory_usage += sizeof(art_leaf_t) + len;
+    return l;
+}
+
+static void art_release_leaf(trie_t *t, art_leaf_t *l) {
+    t->memory_usage -= sizeof(art_leaf_t) + l->key_len;
+    free(l);
+}
+
+static bool art_leaf_matches(const art_leaf_t *l, const unsigned char *key, size_t len) {
+    return l->key_len == len && memcmp(l->key, key, len) == 0;
 }
 
-// 递归释放节点
-static void trie_node_free(trie_node_t *node, void (*value_free)(void*)) {
-    if (!node) return;
-    
+static void art_copy_header(trie_node_t *dest, const trie_node_t *src) {
+    dest->num_children = src->num_children;
+    dest->partial_len = src->partial_len;
+    memcpy(dest->partial, src->partial, ART_MIN(src->partial_len, ART_MAX_PREFIX));
+}
+
+static trie_node_t **art_find_child(trie_node_t *n, unsigned char c) {
+    switch (n->type) {
+        case ART_NODE4: {
+            art_node4_t *p = (art_node4_t *)n;
+            for (int i = 0; i < n->num_children; i++) {
+                if (p->keys[i] == c) return &p->children[i];
+            }
+            break;
+        }
+        case ART_NODE16: {
+            art_node16_t *p = (art_node16_t *)n;
+#ifdef TRIE_HAVE_SSE2
+            // 16 个键一次比较, 掩码去掉未使用的槽位
+            __m128i cmp = _mm_cmpeq_epi8(_mm_set1_epi8((char)c), _mm_loadu_si128((const __m128i *)p->keys));
+            unsigned int mask = (unsigned int)_mm_movemask_epi8(cmp) & ((1u << n->num_children) - 1);
+            if (mask) return &p->children[__builtin_ctz(mask)];
+#else
+            for (int i = 0; i < n->num_children; i++) {
+                if (p->keys[i] == c) return &p->children[i];
+            }
+#endif
+            break;
+        }
+        case ART_NODE48: {
+            art_node48_t *p = (art_node48_t *)n;
+            if (p->child_index[c]) return &p->children[p->child_index[c] - 1];
+            break;
+        }
+        default: {
+            art_node256_t *p = (art_node256_t *)n;
+            if (p->children[c]) return &p->children[c];
+            break;
+        }
+    }
+    return NULL;
+}
+
+// 子树中键最小的叶子
+static art_leaf_t *art_minimum(const trie_node_t *n) {
+    while (n && !ART_IS_LEAF(n)) {
+        switch (n->type) {
+            case ART_NODE4:
+                n = ((const art_node4_t *)n)->children[0];
+                break;
+            case ART_NODE16:
+                n = ((const art_node16_t *)n)->children[0];
+                break;
+            case ART_NODE48: {
+                const art_node48_t *p = (const art_node48_t *)n;
+                int i = 0;
+                while (!p->child_index[i]) i++;
+                n = p->children[p->child_index[i] - 1];
+                break;
+            }
+            default: {
+                const art_node256_t *p = (const art_node256_t *)n;
+                int i = 0;
+                while (!p->children[i]) i++;
+                n = p->children[i];
+                break;
+            }
+        }
+    }
+    return n ? ART_LEAF_RAW(n) : NULL;
+}
+
+// 比较内联前缀, 返回匹配的字节数
+static size_t art_check_prefix(const trie_node_t *n, const unsigned char *key, size_t len, size_t depth) {
+    size_t max_cmp = ART_MIN(ART_MIN(n->partial_len, ART_MAX_PREFIX), len - depth);
+    size_t idx;
+    for (idx = 0; idx < max_cmp; idx++) {
+        if (n->partial[idx] != key[depth + idx]) return idx;
+    }
+    return idx;
+}
+
+// 与完整前缀比较, 超出内联部分时借助最小叶子
+static size_t art_prefix_mismatch(const trie_node_t *n, const unsigned char *key, size_t len, size_t depth) {
+    size_t idx = art_check_prefix(n, key, len, depth);
+    if (idx < ART_MIN(n->partial_len, ART_MAX_PREFIX) || n->partial_len <= ART_MAX_PREFIX) {
+        return idx;
+    }
+    const art_leaf_t *l = art_minimum(n);
+    size_t max_cmp = ART_MIN(l->key_len, len) - depth;
+    for (; idx < max_cmp; idx++) {
+        if ((unsigned char)l->key[depth + idx] != key[depth + idx]) return idx;
+    }
+    return idx;
+}
+
+static void art_add_child256(art_node256_t *n, unsigned char c, trie_node_t *child) {
+    n->n.num_children++;
+    n->children[c] = child;
+}
+
+static trie_error_t art_add_child48(trie_t *t, art_node48_t *n, trie_node_t **ref, unsigned char c, trie_node_t *child) {
+    if (n->n.num_children < 48) {
+        int pos = 0;
+        while (n->children[pos]) pos++;
+        n->children[pos] = child;
+        n->child_index[c] = (uint8_t)(pos + 1);
+        n->n.num_children++;
+        return TRIE_OK;
+    }
+
+    art_node256_t *grown = (art_node256_t *)art_alloc_node(t, ART_NODE256);
+    if (!grown) return TRIE_MEMORY_ERROR;
     for (int i = 0; i < 256; i++) {
-        if (node->children[i]) {
-            trie_node_free(node->children[i], value_free);
+        if (n->child_index[i]) grown->children[i] = n->children[n->child_index[i] - 1];
+    }
+    art_copy_header(&grown->n, &n->n);
+    *ref = &grown->n;
+    art_release_node(t, &n->n);
+    art_add_child256(grown, c, child);
+    return TRIE_OK;
+}
+
+static trie_error_t art_add_child16(trie_t *t, art_node16_t *n, trie_node_t **ref, unsigned char c, trie_node_t *child) {
+    if (n->n.num_children < 16) {
+        int idx = 0;
+        while (idx < n->n.num_children && n->keys[idx] < c) idx++;
+        memmove(n->keys + idx + 1, n->keys + idx, (size_t)(n->n.num_children - idx));
+        memmove(n->children + idx + 1, n->children + idx, (size_t)(n->n.num_children - idx) * sizeof(trie_node_t *));
+        n->keys[idx] = c;
+        n->children[idx] = child;
+        n->n.num_children++;
+        return TRIE_OK;
+    }
+
+    art_node48_t *grown = (art_node48_t *)art_alloc_node(t, ART_NODE48);
+    if (!grown) return TRIE_MEMORY_ERROR;
+    memcpy(grown->children, n->children, sizeof(n->children));
+    for (int i = 0; i < 16; i++) {
+        grown->child_index[n->keys[i]] = (uint8_t)(i + 1);
+    }
+    art_copy_header(&grown->n, &n->n);
+    *ref = &grown->n;
+    art_release_node(t, &n->n);
+    return art_add_child48(t, grown, ref, c, child);
+}
+
+static trie_error_t art_add_child4(trie_t *t, art_node4_t *n, trie_node_t **ref, unsigned char c, trie_node_t *child) {
+    if (n->n.num_children < 4) {
+        int idx = 0;
+        while (idx < n->n.num_children && n->keys[idx] < c) idx++;
+        memmove(n->keys + idx + 1, n->keys + idx, (size_t)(n->n.num_children - idx));
+        memmove(n->children + idx + 1, n->children + idx, (size_t)(n->n.num_children - idx) * sizeof(trie_node_t *));
+        n->keys[idx] = c;
+        n->children[idx] = child;
+        n->n.num_children++;
+        return TRIE_OK;
+    }
+
+    art_node16_t *grown = (art_node16_t *)art_alloc_node(t, ART_NODE16);
+    if (!grown) return TRIE_MEMORY_ERROR;
+    memcpy(grown->children, n->children, sizeof(n->children));
+    memcpy(grown->keys, n->keys, sizeof(n->keys));
+    art_copy_header(&grown->n, &n->n);
+    *ref = &grown->n;
+    art_release_node(t, &n->n);
+    return art_add_child16(t, grown, ref, c, child);
+}
+
+static trie_error_t art_add_child(trie_t *t, trie_node_t *n, trie_node_t **ref, unsigned char c, trie_node_t *child) {
+    switch (n->type) {
+        case ART_NODE4: return art_add_child4(t, (art_node4_t *)n, ref, c, child);
+        case ART_NODE16: return art_add_child16(t, (art_node16_t *)n, ref, c, child);
+        case ART_NODE48: return art_add_child48(t, (art_node48_t *)n, ref, c, child);
+        default:
+            art_add_child256((art_node256_t *)n, c, child);
+            return TRIE_OK;
+    }
+}
+
+// max_children 按原语义只限制字符分支, 结尾的 '\0' 分支不计入
+static bool trie_child_limit_reached(const trie_t *t, trie_node_t *n, unsigned char c) {
+    if (t->config.max_children == 0 || c == 0) return false;
+    size_t count = n->num_children;
+    if (art_find_child(n, 0)) count--;
+    return count >= t->config.max_children;
+}
+
+static bool trie_split_allowed(const trie_t *t, unsigned char a, unsigned char b) {
+    return t->config.max_children != 1 || a == 0 || b == 0;
+}
+
+// 插入新叶子; 键已存在时不修改树, 通过 existing 返回已有叶子
+static trie_error_t art_insert(trie_t *t, trie_node_t *n, trie_node_t **ref, const unsigned char *key, size_t len,
+                               void *value, size_t depth, art_leaf_t **existing) {
+    if (!n) {
+        art_leaf_t *leaf = art_make_leaf(t, key, len, value);
+        if (!leaf) return TRIE_MEMORY_ERROR;
+        *ref = ART_SET_LEAF(leaf);
+        return TRIE_OK;
+    }
+
+    if (ART_IS_LEAF(n)) {
+        art_leaf_t *l = ART_LEAF_RAW(n);
+        if (art_leaf_matches(l, key, len)) {
+            *existing = l;
+            return TRIE_OK;
+        }
+
+        // 两个叶子分叉: 新建 Node4, 公共部分作为前缀
+        size_t lcp = 0;
+        size_t max_cmp = ART_MIN(l->key_len, len) - depth;
+        while (lcp < max_cmp && (unsigned char)l->key[depth + lcp] == key[depth + lcp]) lcp++;
+        if (!trie_split_allowed(t, (unsigned char)l->key[depth + lcp], key[depth + lcp])) {
+            return TRIE_INVALID_PARAMS;
+        }
+
+        art_node4_t *node = (art_node4_t *)art_alloc_node(t, ART_NODE4);
+        art_leaf_t *leaf = node ? art_make_leaf(t, key, len, value) : NULL;
+        if (!leaf) {
+            if (node) art_release_node(t, &node->n);
+            return TRIE_MEMORY_ERROR;
         }
+        node->n.partial_len = (uint32_t)lcp;
+        memcpy(node->n.partial, key + depth, ART_MIN(lcp, ART_MAX_PREFIX));
+        *ref = &node->n;
+        art_add_child4(t, node, ref, (unsigned char)l->key[depth + lcp], n);
+        art_add_child4(t, node, ref, key[depth + lcp], ART_SET_LEAF(leaf));
+        return TRIE_OK;
     }
-    
-    if (value_free && node->value) {
-        value_free(node->value);
+
+    if (n->partial_len) {
+        size_t diff = art_prefix_mismatch(n, key, len, depth);
+        if (diff < n->partial_len) {
+            // 前缀中途分叉: 在分叉点插入 Node4, 原节点缩短前缀
+            const art_leaf_t *min_leaf = n->partial_len > ART_MAX_PREFIX ? art_minimum(n) : NULL;
+            unsigned char old_byte = min_leaf ? (unsigned char)min_leaf->key[depth + diff] : n->partial[diff];
+            if (!trie_split_allowed(t, old_byte, key[depth + diff])) {
+                return TRIE_INVALID_PARAMS;
+            }
+
+            art_node4_t *node = (art_node4_t *)art_alloc_node(t, ART_NODE4);
+            art_leaf_t *leaf = node ? art_make_leaf(t, key, len, value) : NULL;
+            if (!leaf) {
+                if (node) art_release_node(t, &node->n);
+                return TRIE_MEMORY_ERROR;
+            }
+            node->n.partial_len = (uint32_t)diff;
+            memcpy(node->n.partial, n->partial, ART_MIN(diff, ART_MAX_PREFIX));
+            *ref = &node->n;
+
+            n->partial_len -= (uint32_t)(diff + 1);
+            if (min_leaf) {
+                memcpy(n->partial, min_leaf->key + depth + diff + 1, ART_MIN(n->partial_len, ART_MAX_PREFIX));
+            } else {
+                memmove(n->partial, n->partial + diff + 1, ART_MIN(n->partial_len, ART_MAX_PREFIX));
+            }
+            art_add_child4(t, node, ref, old_byte, n);
+            art_add_child4(t, node, ref, key[depth + diff], ART_SET_LEAF(leaf));
+            return TRIE_OK;
+        }
+        depth += n->partial_len;
     }
-    
-    free(node);
+
+    if (depth >= len) return TRIE_INVALID_PARAMS;
+
+    trie_node_t **child = art_find_child(n, key[depth]);
+    if (child) {
+        return art_insert(t, *child, child, key, len, value, depth + 1, existing);
+    }
+
+    if (trie_child_limit_reached(t, n, key[depth])) {
+        return TRIE_INVALID_PARAMS;
+    }
+    art_leaf_t *leaf = art_make_leaf(t, key, len, value);
+    if (!leaf) return TRIE_MEMORY_ERROR;
+    trie_error_t err = art_add_child(t, n, ref, key[depth], ART_SET_LEAF(leaf));
+    if (err != TRIE_OK) art_release_leaf(t, leaf);
+    return err;
+}
+
+static art_leaf_t *art_search(const trie_t *t, const unsigned char *key, size_t len) {
+    trie_node_t *n = t->root;
+    size_t depth = 0;
+
+    while (n) {
+        if (ART_IS_LEAF(n)) {
+            art_leaf_t *l = ART_LEAF_RAW(n);
+            return art_leaf_matches(l, key, len) ? l : NULL;
+        }
+        if (n->partial_len) {
+            if (art_check_prefix(n, key, len, depth) != ART_MIN(n->partial_len, ART_MAX_PREFIX)) {
+                return NULL;
+            }
+            depth += n->partial_len;
+        }
+        if (depth >= len) return NULL;
+        trie_node_t **child = art_find_child(n, key[depth]);
+        n = child ? *child : NULL;
+        depth++;
+    }
+    return NULL;
+}
+
+static void art_remove_child256(trie_t *t, art_node256_t *n, trie_node_t **ref, unsigned char c) {
+    n->children[c] = NULL;
+    n->n.num_children--;
+
+    // 子节点降到 37 时收缩为 Node48, 留出余量避免在边界反复伸缩
+    if (n->n.num_children == 37) {
+        art_node48_t *shrunk = (art_node48_t *)art_alloc_node(t, ART_NODE48);
+        if (!shrunk) return;
+        art_copy_header(&shrunk->n, &n->n);
+        int pos = 0;
+        for (int i = 0; i < 256; i++) {
+            if (n->children[i]) {
+                shrunk->children[pos] = n->children[i];
+                shrunk->child_index[i] = (uint8_t)(pos + 1);
+                pos++;
+            }
+        }
+        *ref = &shrunk->n;
+        art_release_node(t, &n->n);
+    }
+}
+
+static void art_remove_child48(trie_t *t, art_node48_t *n, trie_node_t **ref, unsigned char c) {
+    int pos = n->child_index[c];
+    n->child_index[c] = 0;
+    n->children[pos - 1] = NULL;
+    n->n.num_children--;
+
+    if (n->n.num_children == 12) {
+        art_node16_t *shrunk = (art_node16_t *)art_alloc_node(t, ART_NODE16);
+        if (!shrunk) return;
+        art_copy_header(&shrunk->n, &n->n);
+        int child = 0;
+        for (int i = 0; i < 256; i++) {
+            pos = n->child_index[i];
+            if (pos) {
+                shrunk->keys[child] = (uint8_t)i;
+                shrunk->children[child] = n->children[pos - 1];
+                child++;
+            }
+        }
+        *ref = &shrunk->n;
+        art_release_node(t, &n->n);
+    }
+}
+
+static void art_remove_child16(trie_t *t, art_node16_t *n, trie_node_t **ref, trie_node_t **slot) {
+    int pos = (int)(slot - n->children);
+    memmove(n->keys + pos, n->keys + pos + 1, (size_t)(n->n.num_children - 1 - pos));
+    memmove(n->children + pos, n->children + pos + 1, (size_t)(n->n.num_children - 1 - pos) * sizeof(trie_node_t *));
+    n->n.num_children--;
+
+    if (n->n.num_children == 3) {
+        art_node4_t *shrunk = (art_node4_t *)art_alloc_node(t, ART_NODE4);
+        if (!shrunk) return;
+        art_copy_header(&shrunk->n, &n->n);
+        memcpy(shrunk->keys, n->keys, 3);
+        memcpy(shrunk->children, n->children, 3 * sizeof(trie_node_t *));
+        *ref = &shrunk->n;
+        art_release_node(t, &n->n);
+    }
+}
+
+static void art_remove_child4(trie_t *t, art_node4_t *n, trie_node_t **ref, trie_node_t **slot) {
+    int pos = (int)(slot - n->children);
+    memmove(n->keys + pos, n->keys + pos + 1, (size_t)(n->n.num_children - 1 - pos));
+    memmove(n->children + pos, n->children + pos + 1, (size_t)(n->n.num_children - 1 - pos) * sizeof(trie_node_t *));
+    n->n.num_children--;
+
+    // 只剩一个子节点时与子节点合并, 前缀拼接为 父前缀 + 分支字节 + 子前缀
+    if (n->n.num_children == 1) {
+        trie_node_t *child = n->children[0];
+        if (!ART_IS_LEAF(child)) {
+            size_t prefix = n->n.partial_len;
+            if (prefix < ART_MAX_PREFIX) {
+                n->n.partial[prefix] = n->keys[0];
+                prefix++;
+            }
+            if (prefix < ART_MAX_PREFIX) {
+                size_t sub = ART_MIN(child->partial_len, ART_MAX_PREFIX - prefix);
+                memcpy(n->n.partial + prefix, child->partial, sub);
+                prefix += sub;
+            }
+            memcpy(child->partial, n->n.partial, ART_MIN(prefix, ART_MAX_PREFIX));
+            child->partial_len += n->n.partial_len + 1;
+        }
+        *ref = child;
+        art_release_node(t, &n->n);
+    }
+}
+
+static void art_remove_child(trie_t *t, trie_node_t *n, trie_node_t **ref, unsigned char c, trie_node_t **slot) {
+    switch (n->type) {
+        case ART_NODE4: art_remove_child4(t, (art_node4_t *)n, ref, slot); break;
+        case ART_NODE16: art_remove_child16(t, (art_node16_t *)n, ref, slot); break;
+        case ART_NODE48: art_remove_child48(t, (art_node48_t *)n, ref, c); break;
+        default: art_remove_child256(t, (art_node256_t *)n, ref, c); break;
+    }
+}
+
+// 从树中摘下匹配的叶子并返回, 叶子由调用方释放
+static art_leaf_t *art_delete(trie_t *t, trie_node_t *n, trie_node_t **ref, const unsigned char *key, size_t len,
+                              size_t depth) {
+    if (!n) return NULL;
+
+    if (ART_IS_LEAF(n)) {
+        art_leaf_t *l = ART_LEAF_RAW(n);
+        if (!art_leaf_matches(l, key, len)) return NULL;
+        *ref = NULL;
+        return l;
+    }
+
+    if (n->partial_len) {
+        if (art_check_prefix(n, key, len, depth) != ART_MIN(n->partial_len, ART_MAX_PREFIX)) {
+            return NULL;
+        }
+        depth += n->partial_len;
+    }
+    if (depth >= len) return NULL;
+
+    trie_node_t **child = art_find_child(n, key[depth]);
+    if (!child) return NULL;
+
+    if (ART_IS_LEAF(*child)) {
+        art_leaf_t *l = ART_LEAF_RAW(*child);
+        if (!art_leaf_matches(l, key, len)) return NULL;
+        art_remove_child(t, n, ref, key[depth], child);
+        return l;
+    }
+    return art_delete(t, *child, child, key, len, depth + 1);
+}
+
+typedef bool (*art_leaf_cb)(art_leaf_t *leaf, void *data);
+
+// 按字节序遍历子树, 回调返回 false 时停止并返回 false
+static bool art_iterate(trie_node_t *n, art_leaf_cb cb, void *data) {
+    if (!n) return true;
+    if (ART_IS_LEAF(n)) return cb(ART_LEAF_RAW(n), data);
+
+    switch (n->type) {
+        case ART_NODE4: {
+            art_node4_t *p = (art_node4_t *)n;
+            for (int i = 0; i < n->num_children; i++) {
+                if (!art_iterate(p->children[i], cb, data)) return false;
+            }
+            break;
+        }
+        case ART_NODE16: {
+            art_node16_t *p = (art_node16_t *)n;
+            for (int i = 0; i < n->num_children; i++) {
+                if (!art_iterate(p->children[i], cb, data)) return false;
+            }
+            break;
+        }
+        case ART_NODE48: {
+            art_node48_t *p = (art_node48_t *)n;
+            for (int i = 0; i < 256; i++) {
+                if (p->child_index[i] && !art_iterate(p->children[p->child_index[i] - 1], cb, data)) return false;
+            }
+            break;
+        }
+        default: {
+            art_node256_t *p = (art_node256_t *)n;
+            for (int i = 0; i < 256; i++) {
+                if (p->children[i] && !art_iterate(p->children[i], cb, data)) return false;
+            }
+            break;
+        }
+    }
+    return true;
+}
+
+// 递归释放子树
+static void art_free_tree(trie_t *t, trie_node_t *n) {
+    if (!n) return;
+    if (ART_IS_LEAF(n)) {
+        art_leaf_t *l = ART_LEAF_RAW(n);
+        if (t->config.value_free && l->value) {
+            t->config.value_free(l->value);
+        }
+        art_release_leaf(t, l);
+        return;
+    }
+
+    switch (n->type) {
+        case ART_NODE4: {
+            art_node4_t *p = (art_node4_t *)n;
+            for (int i = 0; i < n->num_children; i++) art_free_tree(t, p->children[i]);
+            break;
+        }
+        case ART_NODE16: {
+            art_node16_t *p = (art_node16_t *)n;
+            for (int i = 0; i < n->num_children; i++) art_free_tree(t, p->children[i]);
+            break;
+        }
+        case ART_NODE48: {
+            art_node48_t *p = (art_node48_t *)n;
+            for (int i = 0; i < 48; i++) art_free_tree(t, p->children[i]);
+            break;
+        }
+        default: {
+            art_node256_t *p = (art_node256_t *)n;
+            for (int i = 0; i < 256; i++) art_free_tree(t, p->children[i]);
+            break;
+        }
+    }
+    art_release_node(t, n);
 }
 
 // 默认配置
@@ -47,35 +677,22 @@ trie_t* trie_create(void) {
 trie_t* trie_create_with_config(const trie_config_t *config) {
     trie_t *t = malloc(sizeof(trie_t));
     if (!t) return NULL;
-    
-    t->root = trie_node_create();
-    if (!t->root) {
-        free(t);
-        return NULL;
-    }
-    
+
+    t->root = NULL;
     t->size = 0;
     t->config = config ? *config : trie_default_config();
     t->last_error = TRIE_OK;
-    t->memory_usage = sizeof(trie_t) + sizeof(trie_node_t);
-    
+    t->memory_usage = sizeof(trie_t);
+
     return t;
 }
 
 // 销毁 Trie
 void trie_free(trie_t *t) {
     if (!t) return;
-    
-    trie_node_free(t->root, t->config.value_free);
-    free(t);
-}
 
-// 字符转换（处理大小写不敏感）
-static unsigned char trie_char_convert(trie_t *t, unsigned char c) {
-    if (!t->config.case_sensitive) {
-        return (unsigned char)tolower(c);
-    }
-    return c;
+    art_free_tree(t, t->root);
+    free(t);
 }
 
 // 插入键值对
@@ -84,81 +701,52 @@ trie_error_t trie_insert(trie_t *t, const char *key, void *value) {
         if (t) t->last_error = TRIE_INVALID_PARAMS;
         return TRIE_INVALID_PARAMS;
     }
-    
+
     if (*key == '\0') {
         t->last_error = TRIE_EMPTY_KEY;
         return TRIE_EMPTY_KEY;
     }
-    
-    trie_node_t *current = t->root;
-    const char *p = key;
-    size_t depth = 0;
-    
-    while (*p) {
-        if (t->config.max_depth > 0 && depth >= t->config.max_depth) {
-            t->last_error = TRIE_INVALID_PARAMS;
-            return TRIE_INVALID_PARAMS;
-        }
-        
-        unsigned char c = trie_char_convert(t, (unsigned char)*p);
-        
-        if (!current->children[c]) {
-            // 检查子节点数限制
-            if (t->config.max_children > 0 && current->child_count >= t->config.max_children) {
-                t->last_error = TRIE_INVALID_PARAMS;
-                return TRIE_INVALID_PARAMS;
-            }
-            
-            current->children[c] = trie_node_create();
-            if (!current->children[c]) {
-                t->last_error = TRIE_MEMORY_ERROR;
-                return TRIE_MEMORY_ERROR;
+
+    trie_key_t k;
+    if (!trie_key_init(t, key, &k)) {
+        t->last_error = TRIE_MEMORY_ERROR;
+        return TRIE_MEMORY_ERROR;
+    }
+
+    if (t->config.max_depth > 0 && k.len - 1 > t->config.max_depth) {
+        trie_key_release(&k);
+        t->last_error = TRIE_INVALID_PARAMS;
+        return TRIE_INVALID_PARAMS;
+    }
+
+    art_leaf_t *existing = NULL;
+    trie_error_t err = art_insert(t, t->root, &t->root, k.bytes, k.len, value, 0, &existing);
+    trie_key_release(&k);
+
+    if (err == TRIE_OK && existing) {
+        // 允许重复时覆盖旧值, 键数不变
+        if (!t->config.allow_duplicates) {
+            err = TRIE_DUPLICATE_KEY;
+        } else {
+            if (t->config.value_free && existing->value && existing->value != value) {
+                t->config.value_free(existing->value);
             }
-            current->child_count++;
-            t->memory_usage += sizeof(trie_node_t);
+            existing->value = value;
         }
-        
-        current = current->children[c];
-        p++;
-        depth++;
-    }
-    
-    // 检查是否允许重复
-    if (current->is_end && !t->config.allow_duplicates) {
-        t->last_error = TRIE_DUPLICATE_KEY;
-        return TRIE_DUPLICATE_KEY;
-    }
-    
-    // 释放旧值
-    if (current->is_end && t->config.value_free && current->value) {
-        t->config.value_free(current->value);
-    }
-    
-    current->is_end = true;
-    current->value = value;
-    
-    if (!current->is_end || t->config.allow_duplicates) {
+    } else if (err == TRIE_OK) {
         t->size++;
     }
-    
-    t->last_error = TRIE_OK;
-    return TRIE_OK;
+
+    t->last_error = err;
+    return err;
 }
 
-// 查找节点
-static trie_node_t* trie_find_node(trie_t *t, const char *key) {
-    if (!t || !key || !t->root) return NULL;
-    
-    trie_node_t *current = t->root;
-    const char *p = key;
-    
-    while (*p && current) {
-        unsigned char c = trie_char_convert(t, (unsigned char)*p);
-        current = current->children[c];
-        p++;
-    }
-    
-    return current;
+static art_leaf_t *trie_lookup(trie_t *t, const char *key) {
+    trie_key_t k;
+    if (!trie_key_init(t, key, &k)) return NULL;
+    art_leaf_t *l = art_search(t, k.bytes, k.len);
+    trie_key_release(&k);
+    return l;
 }
 
 // 获取键对应的值
@@ -167,16 +755,15 @@ void* trie_get(trie_t *t, const char *key) {
         if (t) t->last_error = TRIE_INVALID_PARAMS;
         return NULL;
     }
-    
-    trie_node_t *node = trie_find_node(t, key);
-    
-    if (!node || !node->is_end) {
+
+    art_leaf_t *l = trie_lookup(t, key);
+    if (!l) {
         t->last_error = TRIE_KEY_NOT_FOUND;
         return NULL;
     }
-    
+
     t->last_error = TRIE_OK;
-    return node->value;
+    return l->value;
 }
 
 // 检查键是否存在
@@ -185,100 +772,75 @@ bool trie_contains(trie_t *t, const char *key) {
         if (t) t->last_error = TRIE_INVALID_PARAMS;
         return false;
     }
-    
-    trie_node_t *node = trie_find_node(t, key);
-    bool exists = (node && node->is_end);
+
+    bool exists = trie_lookup(t, key) != NULL;
     t->last_error = TRIE_OK;
     return exists;
 }
 
-// 递归删除节点
-static bool trie_node_remove(trie_node_t *node, const char *key, void (*value_free)(void*), size_t *freed_count) {
-    if (!node || !key) return false;
-    
-    if (*key == '\0') {
-        if (!node->is_end) return false;
-        
-        // 释放值
-        if (value_free && node->value) {
-            value_free(node->value);
-        }
-        
-        node->is_end = false;
-        node->value = NULL;
-        (*freed_count)++;
-        
-        // 检查是否可以删除此节点
-        for (int i = 0; i < 256; i++) {
-            if (node->children[i]) return false;
-        }
-        
-        return true;
-    }
-    
-    unsigned char c = (unsigned char)*key;
-    trie_node_t *child = node->children[c];
-    
-    if (!child) return false;
-    
-    bool can_delete_child = trie_node_remove(child, key + 1, value_free, freed_count);
-    
-    if (can_delete_child) {
-        free(child);
-        node->children[c] = NULL;
-        node->child_count--;
-        
-        // 检查当前节点是否可以删除
-        if (!node->is_end) {
-            for (int i = 0; i < 256; i++) {
-                if (node->children[i]) return false;
-            }
-            return true;
-        }
-    }
-    
-    return false;
-}
-
 // 删除键
 bool trie_remove(trie_t *t, const char *key) {
-    if (!t || !key || !t->root) {
+    if (!t || !key) {
         if (t) t->last_error = TRIE_INVALID_PARAMS;
         return false;
     }
-    
-    size_t freed_count = 0;
-    bool result = trie_node_remove(t->root, key, t->config.value_free, &freed_count);
-    
-    if (result) {
-        t->size -= freed_count;
-        t->last_error = TRIE_OK;
-    } else {
+
+    trie_key_t k;
+    if (!trie_key_init(t, key, &k)) {
+        t->last_error = TRIE_MEMORY_ERROR;
+        return false;
+    }
+    art_leaf_t *l = art_delete(t, t->root, &t->root, k.bytes, k.len, 0);
+    trie_key_release(&k);
+
+    if (!l) {
         t->last_error = TRIE_KEY_NOT_FOUND;
+        return false;
+    }
+
+    if (t->config.value_free && l->value) {
+        t->config.value_free(l->value);
     }
-    
-    return result;
-}
-
-// 递归收集前缀匹配的键
-static void trie_collect_prefix(trie_node_t *node, char *prefix, size_t prefix_len, 
-                                 char **keys, void **values, size_t *count, size_t max_results) {
-    if (!node || *count >= max_results) return;
-    
-    if (node->is_end) {
-        keys[*count] = strdup(prefix);
-        values[*count] = node->value;
-        (*count)++;
-    }
-    
-    for (int i = 0; i < 256 && *count < max_results; i++) {
-        if (node->children[i]) {
-            prefix[prefix_len] = (char)i;
-            prefix[prefix_len + 1] = '\0';
-            trie_collect_prefix(node->children[i], prefix, prefix_len + 1, 
-                               keys, values, count, max_results);
+    art_release_leaf(t, l);
+    t->size--;
+    t->last_error = TRIE_OK;
+    return true;
+}
+
+typedef struct {
+    char **keys;
+    void **values;
+    size_t count;
+    size_t max_results;
+    const char *prefix;
+    size_t prefix_len;
+} trie_collect_ctx_t;
+
+static bool trie_collect_leaf(art_leaf_t *leaf, void *data) {
+    trie_collect_ctx_t *ctx = (trie_collect_ctx_t *)data;
+    if (strncmp(leaf->key, ctx->prefix, ctx->prefix_len) != 0) return true;
+    ctx->keys[ctx->count] = strdup(leaf->key);
+    ctx->values[ctx->count] = leaf->value;
+    ctx->count++;
+    return ctx->count < ctx->max_results;
+}
+
+// 找到覆盖整个前缀的子树, 前缀在节点压缩路径中途结束时返回该节点
+static trie_node_t *art_find_prefix_root(trie_node_t *n, const unsigned char *prefix, size_t len) {
+    size_t depth = 0;
+    while (n && !ART_IS_LEAF(n)) {
+        if (depth == len) return n;
+        if (n->partial_len) {
+            size_t matched = art_prefix_mismatch(n, prefix, len, depth);
+            if (depth + matched == len) return n;
+            if (matched < n->partial_len) return NULL;
+            depth += n->partial_len;
         }
+        trie_node_t **child = art_find_child(n, prefix[depth]);
+        n = child ? *child : NULL;
+        depth++;
     }
+    return n;
 }
 
 // 获取前缀匹配的所有键值对
@@ -287,55 +849,42 @@ size_t trie_prefix_search(trie_t *t, const char *prefix, char **keys, void **val
         if (t) t->last_error = TRIE_INVALID_PARAMS;
         return 0;
     }
-    
-    trie_node_t *node = trie_find_node(t, prefix);
-    if (!node) {
-        t->last_error = TRIE_OK;
+
+    trie_key_t k;
+    if (!trie_key_init(t, prefix, &k)) {
+        t->last_error = TRIE_MEMORY_ERROR;
         return 0;
     }
-    
-    size_t count = 0;
-    char buffer[1024];
-    strncpy(buffer, prefix, sizeof(buffer) - 1);
-    buffer[sizeof(buffer) - 1] = '\0';
-    
-    trie_collect_prefix(node, buffer, strlen(prefix), keys, values, &count, max_results);
-    
+
+    // 前缀不含结尾 '\0'; 子树中的叶子仍需逐一确认前缀
+    trie_collect_ctx_t ctx = { keys, values, 0, max_results, (const char *)k.bytes, k.len - 1 };
+    trie_node_t *subtree = art_find_prefix_root(t->root, k.bytes, k.len - 1);
+    art_iterate(subtree, trie_collect_leaf, &ctx);
+    trie_key_release(&k);
+
     t->last_error = TRIE_OK;
-    return count;
-}
-
-// 递归遍历
-static void trie_node_traverse(trie_node_t *node, char *prefix, size_t prefix_len,
-                                trie_traverse_cb cb, void *user_data, bool *stop) {
-    if (!node || *stop) return;
-    
-    if (node->is_end) {
-        prefix[prefix_len] = '\0';
-        if (!cb(prefix, node->value, user_data)) {
-            *stop = true;
-            return;
-        }
-    }
-    
-    for (int i = 0; i < 256 && !*stop; i++) {
-        if (node->children[i]) {
-            prefix[prefix_len] = (char)i;
-            trie_node_traverse(node->children[i], prefix, prefix_len + 1, cb, user_data, stop);
-        }
-    }
+    return ctx.count;
+}
+
+typedef struct {
+    trie_traverse_cb cb;
+    void *user_data;
+} trie_traverse_ctx_t;
+
+static bool trie_traverse_leaf(art_leaf_t *leaf, void *data) {
+    trie_traverse_ctx_t *ctx = (trie_traverse_ctx_t *)data;
+    return ctx->cb(leaf->key, leaf->value, ctx->user_data);
 }
 
 // 遍历 Trie
 void trie_traverse(trie_t *t, trie_traverse_cb cb, void *user_data) {
-    if (!t || !cb || !t->root) {
+    if (!t || !cb) {
         if (t) t->last_error = TRIE_INVALID_PARAMS;
         return;
     }
-    
-    char prefix[1024];
-    bool stop = false;
-    trie_node_traverse(t->root, prefix, 0, cb, user_data, &stop);
+
+    trie_traverse_ctx_t ctx = { cb, user_data };
+    art_iterate(t->root, trie_traverse_leaf, &ctx);
     t->last_error = TRIE_OK;
 }
 
@@ -370,33 +919,13 @@ const char* trie_strerror(trie_error_t error) {
     }
 }
 
-// 递归清空节点
-static void trie_node_clear(trie_node_t *node, void (*value_free)(void*)) {
-    if (!node) return;
-    
-    for (int i = 0; i < 256; i++) {
-        if (node->children[i]) {
-            trie_node_clear(node->children[i], value_free);
-            free(node->children[i]);
-            node->children[i] = NULL;
-        }
-    }
-    
-    if (value_free && node->value) {
-        value_free(node->value);
-    }
-    
-    node->is_end = false;
-    node->value = NULL;
-    node->child_count = 0;
-}
-
 // 清空 Trie
 void trie_clear(trie_t *t) {
-    if (!t || !t->root) return;
-    
-    trie_node_clear(t->root, t->config.value_free);
+    if (!t) return;
+
+    art_free_tree(t, t->root);
+    t->root = NULL;
     t->size = 0;
-    t->memory_usage = sizeof(trie_t) + sizeof(trie_node_t);
+    t->memory_usage = sizeof(trie_t);
     t->last_error = TRIE_OK;
 }
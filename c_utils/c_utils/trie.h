@@ -23,13 +23,10 @@ typedef struct {
     void (*value_free)(void*); // 值释放函数
 } trie_config_t;
 
-// Trie 节点
-typedef struct trie_node_s {
-    struct trie_node_s *children[256];
-    bool is_end;
-    void *value;
-    size_t child_count;
-} trie_node_t;
+// Trie 节点 (自适应基数树内部节点, 定义在 trie.c 中)
+// 内部节点按子节点数在 Node4/16/48/256 之间自动伸缩, 单分支路径压缩进节点前缀,
+// 叶子保存完整键和值. 键按字节序有序, 遍历与前缀查询按字典序输出
+typedef struct trie_node_s trie_node_t;
 
 // Trie 结构体
 typedef struct {
@@ -37,7 +34,7 @@ typedef struct {
     size_t size;
     trie_config_t config;
     trie_error_t last_error;
-    size_t memory_usage;
+    size_t memory_usage;      // 节点与叶子占用的字节数
 } trie_t;
 
 // Trie 遍历回调函数类型
@@ -1,4 +1,5 @@
 #include "zip_wrapper.h"
+#include "miniz.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -13,52 +14,15 @@
 
 #define DEFAULT_BUFFER_SIZE 65536
 
-static const uint32_t crc32_table[256] = {
-    0x00000000, 0x77073096, 0xee0e612c, 0x990951ba, 0x076dc419, 0x706af48f, 0xe963a535, 0x9e6495a3,
-    0x0edb8832, 0x79dcb8a4, 0xe0d5e91e, 0x97d2d988, 0x09b64c2b, 0x7eb17cbd, 0xe7b82d07, 0x90bf1d91,
-    0x1db71064, 0x6ab020f2, 0xf3b97148, 0x84be41de, 0x1adad47d, 0x6ddde4eb, 0xf4d4b551, 0x83d385c7,
-    0x136c9856, 0x646ba8c0, 0xfd62f97a, 0x8a65c9ec, 0x14015c4f, 0x63066cd9, 0xfa0f3d63, 0x8d080df5,
-    0x3b6e20c8, 0x4c69105e, 0xd56041e4, 0xa2677172, 0x3c03e4d1, 0x4b04d447, 0xd20d85fd, 0xa50ab56b,
-    0x35b5a8fa, 0x42b2986c, 0xdbbbc9d6, 0xacbcf940, 0x32d86ce3, 0x45df5c75, 0xdcd60dcf, 0xabd13d59,
-    0x26d930ac, 0x51de003a, 0xc8d75180, 0xbfd06116, 0x21b4f4b5, 0x56b3c423, 0xcfba9599, 0xb8bda50f,
-    0x2802b89e, 0x5f058808, 0xc60cd9b2, 0xb10be924, 0x2f6f7c87, 0x58684c11, 0xc1611dab, 0xb6662d3d,
-    0x76dc4190, 0x01db7106, 0x98d220bc, 0xefd5102a, 0x71b18589, 0x06b6b51f, 0x9fbfe4a5, 0xe8b8d433,
-    0x7807c9a2, 0x0f00f934, 0x9609a88e, 0xe10e9818, 0x7f6a0dbb, 0x086d3d2d, 0x91646c97, 0xe6635c01,
-    0x6b6b51f4, 0x1c6c6162, 0x856530d8, 0xf262004e, 0x6c0695ed, 0x1b01a57b, 0x8208f4c1, 0xf50fc457,
-    0x65b0d9c6, 0x12b7e950, 0x8bbeb8ea, 0xfcb9887c, 0x62dd1ddf, 0x15da2d49, 0x8cd37cf3, 0xfbd44c65,
-    0x4db26158, 0x3ab551ce, 0xa3bc0074, 0xd4bb30e2, 0x4adfa541, 0x3dd895d7, 0xa4d1c46d, 0xd3d6f4fb,
-    0x4369e96a, 0x346ed9fc, 0xad678846, 0xda60b8d0, 0x44042d73, 0x33031de5, 0xaa0a4c5f, 0xdd0d7cc9,
-    0x5005713c, 0x270241aa, 0xbe0b1010, 0xc90c2086, 0x5768b525, 0x206f85b3, 0xb966d409, 0xce61e49f,
-    0x5edef90e, 0x29d9c998, 0xb0d09822, 0xc7d7a8b4, 0x59b33d17, 0x2eb40d81, 0xb7bd5c3b, 0xc0ba6cad,
-    0xedb88320, 0x9abfb3b6, 0x03b6e20c, 0x74b1d29a, 0xead54739, 0x9dd277af, 0x04db2615, 0x73dc1683,
-    0xe3630b12, 0x94643b84, 0x0d6d6a3e, 0x7a6a5aa8, 0xe40ecf0b, 0x9309ff9d, 0x0a00ae27, 0x7d079eb1,
-    0xf00f9344, 0x8708a3d2, 0x1e01f268, 0x6906c2fe, 0xf762575d, 0x806567cb, 0x196c3671, 0x6e6b06e7,
-    0xfed41b76, 0x89d32be0, 0x10da7a5a, 0x67dd4acc, 0xf9b9df6f, 0x8ebeeff9, 0x17b7be43, 0x60b08ed5,
-    0xd6d6a3e8, 0xa1d1937e, 0x38d8c2c4, 0x4fdff252, 0xd1bb67f1, 0xa6bc5767, 0x3fb506dd, 0x48b2364b,
-    0xd80d2bda, 0xaf0a1b4c, 0x36034af6, 0x41047a60, 0xdf60efc3, 0xa867df55, 0x316e8eef, 0x4669be79,
-    0xcb61b38c, 0xbc66831a, 0x256fd2a0, 0x5268e236, 0xcc0c7795, 0xbb0b4703, 0x220216b9, 0x5505262f,
-    0xc5ba3bbe, 0xb2bd0b28, 0x2bb45a92, 0x5cb36a04, 0xc2d7ffa7, 0xb5d0cf31, 0x2cd99e8b, 0x5bdeae1d,
-    0x9b64c2b0, 0xec63f226, 0x756aa39c, 0x026d930a, 0x9c0906a9, 0xeb0e363f, 0x72076785, 0x05005713,
-    0x95bf4a82, 0xe2b87a14, 0x7bb12bae, 0x0cb61b38, 0x92d28e9b, 0xe5d5be0d, 0x7cdcefb7, 0x0bdbdf21,
-    0x86d3d2d4, 0xf1d4e242, 0x68ddb3f8, 0x1fda836e, 0x81be16cd, 0xf6b9265b, 0x6fb077e1, 0x18b74777,
-    0x88085ae6, 0xff0f6a70, 0x66063bca, 0x11010b5c, 0x8f659eff, 0xf862ae69, 0x616bffd3, 0x166ccf45,
-    0xa00ae278, 0xd70dd2ee, 0x4e048354, 0x3903b3c2, 0xa7672661, 0xd06016f7, 0x4969474d, 0x3e6e77db,
-    0xaed16a4a, 0xd9d65adc, 0x40df0b66, 0x37d83bf0, 0xa9bcae53, 0xdede86c5, 0x47d7927a, 0x30d0e6ec,
-    0xbdc21c28, 0xcac5a8be, 0x53c2d904, 0x24c5e916, 0xbac89a3b, 0xcdbf78cd, 0x54b62931, 0x23b1569d,
-    0xc30c8ea1, 0xb40bbe37, 0x2d0a3c6d, 0x5b0d1a0f, 0xc6dcb7c8, 0xb1bdb5a5, 0x28b20d8b, 0x5eb55e79
-};
+/* 使用 miniz 的 CRC32 实现, 与 zlib 的 crc32(crc, buf, len) 约定一致 */
+static uint32_t crc32_update(uint32_t crc, const void* data, size_t size) {
+    return (uint32_t)mz_crc32(crc, (const unsigned char*)data, size);
+}
 
 uint32_t zip_crc32(const void* data, size_t size) {
     if (!data || size == 0) return 0;
     
-    uint32_t crc = 0xFFFFFFFF;
-    const uint8_t* ptr = (const uint8_t*)data;
-    
-    for (size_t i = 0; i < size; i++) {
-        crc = (crc >> 8) ^ crc32_table[(crc ^ ptr[i]) & 0xFF];
-    }
-    
-    return crc ^ 0xFFFFFFFF;
+    return crc32_update(0, data, size);
 }
 
 const char* zip_error_string(zip_error_t error) {
@@ -271,16 +235,137 @@ static size_t get_current_offset(zip_writer_t* writer) {
     }
 }
 
-zip_error_t zip_writer_add_data(zip_writer_t* writer, const char* entry_name,
-                                 const void* data, size_t size, zip_compress_level_t level) {
-    if (!writer || !entry_name || (!data && size > 0)) {
-        return ZIP_ERR_NULL_PTR;
+typedef int (*zip_sink_fn)(void* ctx, const void* data, size_t size);
+
+typedef struct {
+    uint8_t* data;
+    size_t size;
+    size_t capacity;
+} zip_buffer_t;
+
+static int buffer_sink(void* ctx, const void* data, size_t size) {
+    zip_buffer_t* buf = (zip_buffer_t*)ctx;
+    if (buf->size + size > buf->capacity) {
+        size_t new_capacity = buf->capacity ? buf->capacity * 2 : DEFAULT_BUFFER_SIZE;
+        while (new_capacity < buf->size + size) {
+            new_capacity *= 2;
+        }
+        uint8_t* new_data = (uint8_t*)realloc(buf->data, new_capacity);
+        if (!new_data) {
+            return -1;
+        }
+        buf->data = new_data;
+        buf->capacity = new_capacity;
     }
-    
-    if (writer->finished) {
-        return ZIP_ERR_ALREADY_FINISHED;
+    memcpy(buf->data + buf->size, data, size);
+    buf->size += size;
+    return 0;
+}
+
+static int writer_sink(void* ctx, const void* data, size_t size) {
+    return write_data((zip_writer_t*)ctx, data, size);
+}
+
+typedef struct {
+    zip_sink_fn sink;
+    void* ctx;
+    size_t written;
+} deflate_output_t;
+
+static mz_bool deflate_output_put(const void* buf, int len, void* user) {
+    deflate_output_t* out = (deflate_output_t*)user;
+    if (out->sink(out->ctx, buf, (size_t)len) != 0) {
+        return MZ_FALSE;
     }
-    
+    out->written += (size_t)len;
+    return MZ_TRUE;
+}
+
+/* 从文件(file 非空)或内存块读取原始数据, 按 level 编码后送入 sink。
+ * 以 DEFAULT_BUFFER_SIZE 为单位分块处理, 不会整体缓冲输入。 */
+static zip_error_t encode_stream(FILE* file, const uint8_t* data, size_t size, int level,
+                                 zip_sink_fn sink, void* ctx,
+                                 uint32_t* crc, size_t* uncompressed_size, size_t* compressed_size) {
+    zip_error_t result = ZIP_OK;
+    uint8_t* chunk = NULL;
+    tdefl_compressor* comp = NULL;
+    deflate_output_t out = { sink, ctx, 0 };
+    size_t consumed = 0;
+
+    *crc = 0;
+    *uncompressed_size = 0;
+
+    if (file) {
+        chunk = (uint8_t*)malloc(DEFAULT_BUFFER_SIZE);
+        if (!chunk) {
+            return ZIP_ERR_MEMORY;
+        }
+    }
+
+    if (level != ZIP_COMPRESS_NONE) {
+        comp = (tdefl_compressor*)malloc(sizeof(tdefl_compressor));
+        if (!comp) {
+            free(chunk);
+            return ZIP_ERR_MEMORY;
+        }
+        mz_uint flags = tdefl_create_comp_flags_from_zip_params(level, -MZ_DEFAULT_WINDOW_BITS,
+                                                                MZ_DEFAULT_STRATEGY);
+        if (tdefl_init(comp, deflate_output_put, &out, (int)flags) != TDEFL_STATUS_OKAY) {
+            free(comp);
+            free(chunk);
+            return ZIP_ERR_COMPRESS_FAILED;
+        }
+    }
+
+    for (;;) {
+        const uint8_t* piece;
+        size_t piece_size;
+
+        if (file) {
+            piece_size = fread(chunk, 1, DEFAULT_BUFFER_SIZE, file);
+            if (piece_size == 0 && ferror(file)) {
+                result = ZIP_ERR_READ_FAILED;
+                break;
+            }
+            piece = chunk;
+        } else {
+            piece_size = size - consumed;
+            if (piece_size > DEFAULT_BUFFER_SIZE) piece_size = DEFAULT_BUFFER_SIZE;
+            piece = data + consumed;
+            consumed += piece_size;
+        }
+
+        if (piece_size == 0) {
+            break;
+        }
+
+        *crc = crc32_update(*crc, piece, piece_size);
+        *uncompressed_size += piece_size;
+
+        if (comp) {
+            if (tdefl_compress_buffer(comp, piece, piece_size, TDEFL_NO_FLUSH) != TDEFL_STATUS_OKAY) {
+                result = ZIP_ERR_COMPRESS_FAILED;
+                break;
+            }
+        } else if (deflate_output_put(piece, (int)piece_size, &out) != MZ_TRUE) {
+            result = ZIP_ERR_WRITE_FAILED;
+            break;
+        }
+    }
+
+    if (result == ZIP_OK && comp) {
+        if (tdefl_compress_buffer(comp, NULL, 0, TDEFL_FINISH) != TDEFL_STATUS_DONE) {
+            result = ZIP_ERR_COMPRESS_FAILED;
+        }
+    }
+
+    *compressed_size = out.written;
+    free(comp);
+    free(chunk);
+    return result;
+}
+
+static zip_error_t begin_entry(zip_writer_t* writer, const char* entry_name, zip_entry_t** out) {
     if (writer->entry_count >= writer->entry_capacity) {
         size_t new_capacity = writer->entry_capacity * 2;
         zip_entry_t* new_entries = (zip_entry_t*)realloc(writer->entries, 
@@ -303,23 +388,25 @@ zip_error_t zip_writer_add_data(zip_writer_t* writer, const char* entry_name,
     get_dos_datetime(now, &dos_time, &dos_date);
     entry->modified_time = dos_time;
     entry->modified_date = dos_date;
-    
-    entry->crc32 = zip_crc32(data, size);
-    entry->uncompressed_size = size;
     entry->local_header_offset = get_current_offset(writer);
     
+    *out = entry;
+    return ZIP_OK;
+}
+
+static zip_error_t write_local_header(zip_writer_t* writer, const zip_entry_t* entry) {
     size_t filename_len = strlen(entry->filename);
     uint8_t local_header[30];
     
     write_u32_le(local_header + 0, LOCAL_FILE_HEADER_SIG);
     write_u16_le(local_header + 4, ZIP_VERSION);
     write_u16_le(local_header + 6, 0);
-    write_u16_le(local_header + 8, ZIP_METHOD_STORE);
-    write_u16_le(local_header + 10, dos_time);
-    write_u16_le(local_header + 12, dos_date);
+    write_u16_le(local_header + 8, entry->compression_method);
+    write_u16_le(local_header + 10, (uint16_t)entry->modified_time);
+    write_u16_le(local_header + 12, (uint16_t)entry->modified_date);
     write_u32_le(local_header + 14, entry->crc32);
-    write_u32_le(local_header + 18, (uint32_t)size);
-    write_u32_le(local_header + 22, (uint32_t)size);
+    write_u32_le(local_header + 18, (uint32_t)entry->compressed_size);
+    write_u32_le(local_header + 22, (uint32_t)entry->uncompressed_size);
     write_u16_le(local_header + 26, (uint16_t)filename_len);
     write_u16_le(local_header + 28, 0);
     
@@ -331,67 +418,246 @@ zip_error_t zip_writer_add_data(zip_writer_t* writer, const char* entry_name,
         return ZIP_ERR_WRITE_FAILED;
     }
     
-    if (size > 0 && data) {
-        if (write_data(writer, data, size) != 0) {
-            return ZIP_ERR_WRITE_FAILED;
-        }
+    return ZIP_OK;
+}
+
+/* 流式写入时 CRC 与长度在数据写完后才知道, 回填本地文件头中的对应字段 */
+static zip_error_t patch_local_header(zip_writer_t* writer, const zip_entry_t* entry) {
+    uint8_t fields[12];
+    write_u32_le(fields + 0, entry->crc32);
+    write_u32_le(fields + 4, (uint32_t)entry->compressed_size);
+    write_u32_le(fields + 8, (uint32_t)entry->uncompressed_size);
+    
+    if (writer->is_memory) {
+        memcpy(writer->buffer + entry->local_header_offset + 14, fields, sizeof(fields));
+        return ZIP_OK;
     }
     
-    entry->compressed_size = size;
-    entry->compression_method = ZIP_METHOD_STORE;
-    writer->entry_count++;
+    long end = ftell(writer->file);
+    if (end < 0 ||
+        fseek(writer->file, (long)entry->local_header_offset + 14, SEEK_SET) != 0 ||
+        fwrite(fields, 1, sizeof(fields), writer->file) != sizeof(fields) ||
+        fseek(writer->file, end, SEEK_SET) != 0) {
+        return ZIP_ERR_WRITE_FAILED;
+    }
     
     return ZIP_OK;
 }
 
+static zip_error_t write_encoded_entry(zip_writer_t* writer, const char* entry_name,
+                                       uint16_t method, uint32_t crc, size_t uncompressed_size,
+                                       const void* data, size_t compressed_size) {
+    zip_entry_t* entry;
+    zip_error_t error = begin_entry(writer, entry_name, &entry);
+    if (error != ZIP_OK) {
+        return error;
+    }
+    
+    entry->compression_method = method;
+    entry->crc32 = crc;
+    entry->uncompressed_size = uncompressed_size;
+    entry->compressed_size = compressed_size;
+    
+    error = write_local_header(writer, entry);
+    if (error != ZIP_OK) {
+        return error;
+    }
+    
+    if (compressed_size > 0 && write_data(writer, data, compressed_size) != 0) {
+        return ZIP_ERR_WRITE_FAILED;
+    }
+    
+    writer->entry_count++;
+    return ZIP_OK;
+}
+
+zip_error_t zip_writer_add_data(zip_writer_t* writer, const char* entry_name,
+                                 const void* data, size_t size, zip_compress_level_t level) {
+    if (!writer || !entry_name || (!data && size > 0)) {
+        return ZIP_ERR_NULL_PTR;
+    }
+    
+    if (writer->finished) {
+        return ZIP_ERR_ALREADY_FINISHED;
+    }
+    
+    uint32_t crc = zip_crc32(data, size);
+    
+    if (level != ZIP_COMPRESS_NONE && size > 0) {
+        zip_buffer_t packed = { NULL, 0, 0 };
+        uint32_t packed_crc;
+        size_t packed_raw, packed_size;
+        zip_error_t error = encode_stream(NULL, (const uint8_t*)data, size, level, buffer_sink,
+                                          &packed, &packed_crc, &packed_raw, &packed_size);
+        if (error != ZIP_OK) {
+            free(packed.data);
+            return error;
+        }
+        
+        /* 不可压缩的数据退回 STORE, 避免条目膨胀 */
+        if (packed_size < size) {
+            error = write_encoded_entry(writer, entry_name, ZIP_METHOD_DEFLATE, crc, size,
+                                        packed.data, packed_size);
+            free(packed.data);
+            return error;
+        }
+        free(packed.data);
+    }
+    
+    return write_encoded_entry(writer, entry_name, ZIP_METHOD_STORE, crc, size, data, size);
+}
+
+static const char* entry_basename(const char* name) {
+    const char* basename = strrchr(name, '/');
+    if (!basename) basename = strrchr(name, '\\');
+    return basename ? basename + 1 : name;
+}
+
 zip_error_t zip_writer_add_file(zip_writer_t* writer, const char* filename, 
                                  const char* entry_name, zip_compress_level_t level) {
     if (!writer || !filename) {
         return ZIP_ERR_NULL_PTR;
     }
     
+    if (writer->finished) {
+        return ZIP_ERR_ALREADY_FINISHED;
+    }
+    
     FILE* file = fopen(filename, "rb");
     if (!file) {
         return ZIP_ERR_FILE_NOT_FOUND;
     }
     
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-    
-    if (file_size < 0) {
+    zip_entry_t* entry;
+    zip_error_t error = begin_entry(writer, entry_basename(entry_name ? entry_name : filename), &entry);
+    if (error != ZIP_OK) {
         fclose(file);
-        return ZIP_ERR_READ_FAILED;
+        return error;
     }
     
-    void* data = NULL;
-    size_t size = (size_t)file_size;
+    entry->compression_method = level == ZIP_COMPRESS_NONE ? ZIP_METHOD_STORE : ZIP_METHOD_DEFLATE;
     
-    if (size > 0) {
-        data = malloc(size);
-        if (!data) {
-            fclose(file);
-            return ZIP_ERR_MEMORY;
+    error = write_local_header(writer, entry);
+    if (error == ZIP_OK) {
+        error = encode_stream(file, NULL, 0, level, writer_sink, writer, &entry->crc32,
+                              &entry->uncompressed_size, &entry->compressed_size);
+    }
+    fclose(file);
+    
+    if (error == ZIP_OK) {
+        error = patch_local_header(writer, entry);
+    }
+    
+    if (error == ZIP_OK) {
+        writer->entry_count++;
+    }
+    return error;
+}
+
+typedef struct {
+    const char* filename;
+    int level;
+    zip_buffer_t output;
+    uint32_t crc32;
+    size_t uncompressed_size;
+    zip_error_t error;
+} zip_parallel_job_t;
+
+static void parallel_compress_task(void* arg) {
+    zip_parallel_job_t* job = (zip_parallel_job_t*)arg;
+    FILE* file = fopen(job->filename, "rb");
+    if (!file) {
+        job->error = ZIP_ERR_FILE_NOT_FOUND;
+        return;
+    }
+    
+    size_t compressed_size;
+    job->error = encode_stream(file, NULL, 0, job->level, buffer_sink, &job->output,
+                               &job->crc32, &job->uncompressed_size, &compressed_size);
+    fclose(file);
+}
+
+zip_error_t zip_writer_add_files_parallel(zip_writer_t* writer, const char* const* filenames,
+                                           const char* const* entry_names, size_t count,
+                                           zip_compress_level_t level, threadpool_t* pool) {
+    if (!writer || (!filenames && count > 0)) {
+        return ZIP_ERR_NULL_PTR;
+    }
+    
+    if (writer->finished) {
+        return ZIP_ERR_ALREADY_FINISHED;
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        if (!filenames[i]) {
+            return ZIP_ERR_NULL_PTR;
         }
-        
-        if (fread(data, 1, size, file) != size) {
-            free(data);
-            fclose(file);
-            return ZIP_ERR_READ_FAILED;
+    }
+    
+    if (count == 0) {
+        return ZIP_OK;
+    }
+    
+    threadpool_t* own_pool = NULL;
+    if (!pool) {
+        own_pool = threadpool_create(0);
+        if (!own_pool) {
+            return ZIP_ERR_MEMORY;
         }
+        pool = own_pool;
     }
     
-    fclose(file);
+    /* 每批提交线程数两倍的条目, 压缩结果在内存中的驻留量与条目总数无关 */
+    size_t window = (size_t)threadpool_get_thread_count(pool) * 2;
+    if (window == 0) window = 1;
+    if (window > count) window = count;
     
-    const char* name = entry_name ? entry_name : filename;
-    const char* basename = strrchr(name, '/');
-    if (!basename) basename = strrchr(name, '\\');
-    if (basename) basename++;
-    else basename = name;
+    zip_parallel_job_t* jobs = (zip_parallel_job_t*)calloc(window, sizeof(zip_parallel_job_t));
+    int* task_ids = (int*)calloc(window, sizeof(int));
+    zip_error_t error = (jobs && task_ids) ? ZIP_OK : ZIP_ERR_MEMORY;
     
-    zip_error_t error = zip_writer_add_data(writer, basename, data, size, level);
+    for (size_t base = 0; error == ZIP_OK && base < count; base += window) {
+        size_t batch = count - base < window ? count - base : window;
+        
+        for (size_t i = 0; i < batch; i++) {
+            memset(&jobs[i], 0, sizeof(zip_parallel_job_t));
+            jobs[i].filename = filenames[base + i];
+            jobs[i].level = level;
+            task_ids[i] = threadpool_add_task(pool, parallel_compress_task, &jobs[i]);
+            if (task_ids[i] == 0) {
+                parallel_compress_task(&jobs[i]);
+            }
+        }
+        
+        for (size_t i = 0; i < batch; i++) {
+            if (task_ids[i] != 0) {
+                threadpool_wait_task(pool, task_ids[i], -1);
+            }
+        }
+        
+        for (size_t i = 0; i < batch; i++) {
+            zip_parallel_job_t* job = &jobs[i];
+            if (error == ZIP_OK) {
+                error = job->error;
+            }
+            if (error == ZIP_OK) {
+                const char* name = entry_names && entry_names[base + i] ? entry_names[base + i]
+                                                                        : job->filename;
+                error = write_encoded_entry(writer, entry_basename(name),
+                                            level == ZIP_COMPRESS_NONE ? ZIP_METHOD_STORE
+                                                                       : ZIP_METHOD_DEFLATE,
+                                            job->crc32, job->uncompressed_size,
+                                            job->output.data, job->output.size);
+            }
+            free(job->output.data);
+        }
+    }
     
-    if (data) free(data);
+    free(task_ids);
+    free(jobs);
+    if (own_pool) {
+        threadpool_destroy(own_pool);
+    }
     return error;
 }
 
@@ -703,17 +969,111 @@ int zip_reader_find_entry(zip_reader_t* reader, const char* entry_name) {
     return -1;
 }
 
-static zip_error_t read_entry_data(zip_reader_t* reader, size_t index, void* buffer, size_t* size) {
-    if (index >= reader->entry_count) {
-        return ZIP_ERR_ENTRY_NOT_FOUND;
+typedef struct {
+    uint8_t* data;
+    size_t capacity;
+    size_t size;
+} memory_sink_t;
+
+static int memory_sink(void* ctx, const void* data, size_t size) {
+    memory_sink_t* out = (memory_sink_t*)ctx;
+    if (out->size + size > out->capacity) {
+        return -1;
+    }
+    memcpy(out->data + out->size, data, size);
+    out->size += size;
+    return 0;
+}
+
+static int file_sink(void* ctx, const void* data, size_t size) {
+    return fwrite(data, 1, size, (FILE*)ctx) == size ? 0 : -1;
+}
+
+/* 条目压缩数据的输入源: 内存模式直接引用原始缓冲区, 文件模式按块读取 */
+typedef struct {
+    zip_reader_t* reader;
+    const uint8_t* next;
+    size_t avail;
+    size_t remaining;
+    uint8_t* chunk;
+} entry_input_t;
+
+static zip_error_t entry_input_fill(entry_input_t* in) {
+    if (in->avail > 0 || in->remaining == 0) {
+        return ZIP_OK;
     }
     
-    zip_entry_t* entry = &reader->entries[index];
+    size_t want = in->remaining < DEFAULT_BUFFER_SIZE ? in->remaining : DEFAULT_BUFFER_SIZE;
+    if (fread(in->chunk, 1, want, in->reader->file) != want) {
+        return ZIP_ERR_READ_FAILED;
+    }
+    in->next = in->chunk;
+    in->avail = want;
+    in->remaining -= want;
+    return ZIP_OK;
+}
+
+static zip_error_t inflate_entry(entry_input_t* in, zip_sink_fn sink, void* ctx,
+                                 uint32_t* crc, size_t* total) {
+    tinfl_decompressor* inflator = (tinfl_decompressor*)malloc(sizeof(tinfl_decompressor));
+    uint8_t* dict = (uint8_t*)malloc(TINFL_LZ_DICT_SIZE);
+    zip_error_t result = ZIP_OK;
+    size_t dict_ofs = 0;
     
-    if (buffer && size && *size < entry->uncompressed_size) {
-        return ZIP_ERR_BUFFER_TOO_SMALL;
+    if (!inflator || !dict) {
+        free(inflator);
+        free(dict);
+        return ZIP_ERR_MEMORY;
     }
     
+    tinfl_init(inflator);
+    
+    for (;;) {
+        result = entry_input_fill(in);
+        if (result != ZIP_OK) {
+            break;
+        }
+        
+        size_t in_bytes = in->avail;
+        size_t out_bytes = TINFL_LZ_DICT_SIZE - dict_ofs;
+        mz_uint32 flags = in->remaining > 0 ? TINFL_FLAG_HAS_MORE_INPUT : 0;
+        tinfl_status status = tinfl_decompress(inflator, in->next, &in_bytes, dict,
+                                               dict + dict_ofs, &out_bytes, flags);
+        in->next += in_bytes;
+        in->avail -= in_bytes;
+        
+        if (out_bytes > 0) {
+            *crc = crc32_update(*crc, dict + dict_ofs, out_bytes);
+            *total += out_bytes;
+            if (sink(ctx, dict + dict_ofs, out_bytes) != 0) {
+                result = ZIP_ERR_WRITE_FAILED;
+                break;
+            }
+            dict_ofs = (dict_ofs + out_bytes) & (TINFL_LZ_DICT_SIZE - 1);
+        }
+        
+        if (status == TINFL_STATUS_DONE) {
+            break;
+        }
+        if (status < 0 ||
+            (status == TINFL_STATUS_NEEDS_MORE_INPUT && in->avail == 0 && in->remaining == 0)) {
+            result = ZIP_ERR_DECOMPRESS_FAILED;
+            break;
+        }
+    }
+    
+    free(dict);
+    free(inflator);
+    return result;
+}
+
+/* 按条目的压缩方法解码数据并逐块送入 sink, 结束后校验长度与 CRC32 */
+static zip_error_t stream_entry_data(zip_reader_t* reader, size_t index, zip_sink_fn sink, void* ctx) {
+    if (index >= reader->entry_count) {
+        return ZIP_ERR_ENTRY_NOT_FOUND;
+    }
+    
+    zip_entry_t* entry = &reader->entries[index];
     size_t local_header_offset = entry->local_header_offset;
     
     uint8_t local_header[30];
@@ -734,37 +1094,70 @@ static zip_error_t read_entry_data(zip_reader_t* reader, size_t index, void* buf
         return ZIP_ERR_INVALID_ZIP;
     }
     
+    if (entry->compression_method != ZIP_METHOD_STORE &&
+        entry->compression_method != ZIP_METHOD_DEFLATE) {
+        return ZIP_ERR_DECOMPRESS_FAILED;
+    }
+    
     uint16_t filename_len = read_u16_le(local_header + 26);
     uint16_t extra_len = read_u16_le(local_header + 28);
     
     size_t data_offset = local_header_offset + 30 + filename_len + extra_len;
     
-    if (entry->compression_method == ZIP_METHOD_STORE) {
-        if (buffer) {
-            if (reader->is_memory) {
-                if (data_offset + entry->compressed_size > reader->memory_size) {
-                    return ZIP_ERR_INVALID_ZIP;
-                }
-                memcpy(buffer, reader->memory_data + data_offset, entry->compressed_size);
-            } else {
-                fseek(reader->file, data_offset, SEEK_SET);
-                if (fread(buffer, 1, entry->compressed_size, reader->file) != entry->compressed_size) {
-                    return ZIP_ERR_READ_FAILED;
-                }
-            }
+    entry_input_t in;
+    memset(&in, 0, sizeof(in));
+    in.reader = reader;
+    
+    if (reader->is_memory) {
+        if (data_offset + entry->compressed_size > reader->memory_size) {
+            return ZIP_ERR_INVALID_ZIP;
         }
-        if (size) *size = entry->uncompressed_size;
+        in.next = reader->memory_data + data_offset;
+        in.avail = entry->compressed_size;
     } else {
-        return ZIP_ERR_DECOMPRESS_FAILED;
+        if (fseek(reader->file, data_offset, SEEK_SET) != 0) {
+            return ZIP_ERR_READ_FAILED;
+        }
+        in.remaining = entry->compressed_size;
+        in.chunk = (uint8_t*)malloc(DEFAULT_BUFFER_SIZE);
+        if (!in.chunk) {
+            return ZIP_ERR_MEMORY;
+        }
     }
     
-    if (buffer) {
-        uint32_t calculated_crc = zip_crc32(buffer, entry->uncompressed_size);
-        if (calculated_crc != entry->crc32) {
-            return ZIP_ERR_CRC_MISMATCH;
+    uint32_t crc = 0;
+    size_t total = 0;
+    zip_error_t error = ZIP_OK;
+    
+    if (entry->compression_method == ZIP_METHOD_DEFLATE) {
+        error = inflate_entry(&in, sink, ctx, &crc, &total);
+    } else {
+        while (error == ZIP_OK && (in.avail > 0 || in.remaining > 0)) {
+            error = entry_input_fill(&in);
+            if (error != ZIP_OK) {
+                break;
+            }
+            crc = crc32_update(crc, in.next, in.avail);
+            total += in.avail;
+            if (sink(ctx, in.next, in.avail) != 0) {
+                error = ZIP_ERR_WRITE_FAILED;
+            }
+            in.avail = 0;
         }
     }
     
+    free(in.chunk);
+    
+    if (error != ZIP_OK) {
+        return error;
+    }
+    if (total != entry->uncompressed_size) {
+        return ZIP_ERR_DECOMPRESS_FAILED;
+    }
+    if (crc != entry->crc32) {
+        return ZIP_ERR_CRC_MISMATCH;
+    }
+    
     return ZIP_OK;
 }
 
@@ -774,7 +1167,20 @@ zip_error_t zip_reader_extract_to_memory(zip_reader_t* reader, size_t index,
         return ZIP_ERR_NULL_PTR;
     }
     
-    return read_entry_data(reader, index, buffer, size);
+    if (index >= reader->entry_count) {
+        return ZIP_ERR_ENTRY_NOT_FOUND;
+    }
+    
+    if (*size < reader->entries[index].uncompressed_size) {
+        return ZIP_ERR_BUFFER_TOO_SMALL;
+    }
+    
+    memory_sink_t out = { (uint8_t*)buffer, *size, 0 };
+    zip_error_t error = stream_entry_data(reader, index, memory_sink, &out);
+    if (error == ZIP_OK) {
+        *size = out.size;
+    }
+    return error;
 }
 
 static int create_parent_dirs(const char* filepath) {
@@ -811,41 +1217,20 @@ zip_error_t zip_reader_extract_to_file(zip_reader_t* reader, size_t index, const
     
     create_parent_dirs(filename);
     
-    zip_entry_t* entry = &reader->entries[index];
-    
-    void* buffer = NULL;
-    if (entry->uncompressed_size > 0) {
-        buffer = malloc(entry->uncompressed_size);
-        if (!buffer) {
-            return ZIP_ERR_MEMORY;
-        }
-    }
-    
-    size_t size = entry->uncompressed_size;
-    zip_error_t error = read_entry_data(reader, index, buffer, &size);
-    
-    if (error != ZIP_OK) {
-        if (buffer) free(buffer);
-        return error;
-    }
-    
     FILE* file = fopen(filename, "wb");
     if (!file) {
-        if (buffer) free(buffer);
         return ZIP_ERR_WRITE_FAILED;
     }
     
-    if (buffer && size > 0) {
-        if (fwrite(buffer, 1, size, file) != size) {
-            fclose(file);
-            free(buffer);
-            return ZIP_ERR_WRITE_FAILED;
-        }
-    }
+    zip_error_t error = stream_entry_data(reader, index, file_sink, file);
     
-    fclose(file);
-    if (buffer) free(buffer);
-    return ZIP_OK;
+    if (fclose(file) != 0 && error == ZIP_OK) {
+        error = ZIP_ERR_WRITE_FAILED;
+    }
+    if (error != ZIP_OK) {
+        remove(filename);
+    }
+    return error;
 }
 
 zip_error_t zip_reader_extract_all(zip_reader_t* reader, const char* dest_dir) {
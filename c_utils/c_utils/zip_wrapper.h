@@ -3,6 +3,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include "threadpool.h"
 
 #define ZIP_MAX_FILENAME 256
 #define ZIP_MAX_COMMENT 256
@@ -55,10 +56,17 @@ const char* zip_error_string(zip_error_t error);
 zip_writer_t* zip_writer_create(const char* filename, zip_error_t* error);
 zip_writer_t* zip_writer_create_memory(zip_error_t* error);
 void zip_writer_destroy(zip_writer_t* writer);
+// level 为 ZIP_COMPRESS_NONE 时以 STORE 写入, 其余级别 (1-9) 使用 DEFLATE
+// add_file 分块读取并压缩, 不会把整个文件读入内存
 zip_error_t zip_writer_add_file(zip_writer_t* writer, const char* filename, 
                                  const char* entry_name, zip_compress_level_t level);
 zip_error_t zip_writer_add_data(zip_writer_t* writer, const char* entry_name,
                                  const void* data, size_t size, zip_compress_level_t level);
+// 在线程池上并行压缩多个互相独立的文件, 再按传入顺序写入归档
+// entry_names 可为 NULL (使用文件名); pool 为 NULL 时临时创建一个 CPU 核心数大小的线程池
+zip_error_t zip_writer_add_files_parallel(zip_writer_t* writer, const char* const* filenames,
+                                           const char* const* entry_names, size_t count,
+                                           zip_compress_level_t level, threadpool_t* pool);
 const void* zip_writer_get_buffer(zip_writer_t* writer, size_t* size);
 zip_error_t zip_writer_finish(zip_writer_t* writer);
 
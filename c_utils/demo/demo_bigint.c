@@ -41,7 +41,7 @@ static void demo_from_string(void) {
         bigint_t* b = bigint_from_str(numbers[i]);
         if (b) {
             print_bigint("大整数: ", b);
-            printf("位数: %zu\n\n", b->len);
+            printf("limb 数: %zu\n\n", b->len);
             bigint_free(b);
         } else {
             printf("创建失败!\n\n");
@@ -59,8 +59,8 @@ static void demo_constants(void) {
     print_bigint("零: ", zero);
     print_bigint("一: ", one);
 
-    printf("\n零的位数: %zu\n", zero->len);
-    printf("一的位数: %zu\n", one->len);
+    printf("\n零的 limb 数: %zu\n", zero->len);
+    printf("一的 limb 数: %zu\n", one->len);
 
     bigint_free(zero);
     bigint_free(one);
@@ -217,10 +217,10 @@ static void demo_copy(void) {
 
             // 验证是深拷贝
             printf("\n验证深拷贝:\n");
-            printf("  原始值地址: %p\n", (void*)original->digits);
-            printf("  复制值地址: %p\n", (void*)copy->digits);
+            printf("  原始值地址: %p\n", (void*)original->limbs);
+            printf("  复制值地址: %p\n", (void*)copy->limbs);
             printf("  地址不同: %s\n",
-                   original->digits != copy->digits ? "是" : "否");
+                   original->limbs != copy->limbs ? "是" : "否");
 
             bigint_free(copy);
         }
@@ -8,15 +8,44 @@
 #include <unistd.h>
 #include <math.h>
 #include <ctype.h>
+#include <dirent.h>
+#include <pthread.h>
 
-#include "stopwatch.h"
 #include "stats.h"
 #include "terminal.h"
 #include "json.h"
+#include "lzw.h"
+#include "huffman.h"
+#include "frame_compress.h"
+#include "threadpool.h"
+#include "chacha20_tiny.h"
+#include "trie.h"
+#include "bplus_tree.h"
+#include "kv_store.h"
+#include "skiplist.h"
+#include "bloom.h"
+#include "roaring.h"
+#include "bitset_compressed.h"
+#include "skiplist_lockfree.h"
+#include "bitset.h"
+#include "slab_alloc.h"
+#include "dijkstra.h"
+#include "bellman_ford.h"
+#include "kruskal.h"
+#include "floyd_warshall.h"
+#include "prim.h"
+#include "astar.h"
+#include "fast_fourier_transform.h"
+#include "bigint.h"
+#include "matrix.h"
+#include "suffix_array.h"
+#include "levenshtein.h"
 
 #define MAX_BENCHMARK_NAME 128
 #define MAX_RESULTS 1000
-#define MAX_SAMPLES 10000
+// 单次迭代可记录的最长耗时 (1 小时, 纳秒) 和分位数的有效数字
+#define LATENCY_HIGHEST_NS (3600ULL * 1000000000ULL)
+#define LATENCY_SIGNIFICANT_DIGITS 3
 #define DEFAULT_WARMUP_ITERATIONS 3
 #define DEFAULT_TEST_ITERATIONS 10
 
@@ -32,9 +61,8 @@ typedef enum {
 
 typedef struct {
     char name[MAX_BENCHMARK_NAME];
-    double *samples;
-    size_t sample_count;
-    size_t sample_capacity;
+    stats_accum_t accum;          // 单遍均值/方差 (毫秒)
+    stats_histogram_t *latency;   // 纳秒直方图, 算出分位数后释放
     
     double min;
     double max;
@@ -94,9 +122,9 @@ static benchmark_result_t* result_create(const char *name) {
     if (!result) return NULL;
     
     strncpy(result->name, name, MAX_BENCHMARK_NAME - 1);
-    result->sample_capacity = MAX_SAMPLES;
-    result->samples = malloc(result->sample_capacity * sizeof(double));
-    if (!result->samples) {
+    stats_accum_init(&result->accum);
+    result->latency = stats_histogram_create(LATENCY_HIGHEST_NS, LATENCY_SIGNIFICANT_DIGITS);
+    if (!result->latency) {
         free(result);
         return NULL;
     }
@@ -107,243 +135,3115 @@ static benchmark_result_t* result_create(const char *name) {
 
 static void result_free(benchmark_result_t *result) {
     if (result) {
-        free(result->samples);
+        stats_histogram_free(result->latency);
         free(result);
     }
 }
 
-static void result_add_sample(benchmark_result_t *result, double sample) {
-    if (result->sample_count >= result->sample_capacity) {
-        size_t new_capacity = result->sample_capacity * 2;
-        double *new_samples = realloc(result->samples, new_capacity * sizeof(double));
-        if (!new_samples) return;
-        result->samples = new_samples;
-        result->sample_capacity = new_capacity;
+// 样本不再保存, 内存与迭代次数无关
+static void result_add_sample(benchmark_result_t *result, uint64_t elapsed_ns) {
+    stats_accum_add(&result->accum, (double)elapsed_ns / 1e6);
+    if (elapsed_ns > LATENCY_HIGHEST_NS) elapsed_ns = LATENCY_HIGHEST_NS;
+    stats_histogram_record(result->latency, elapsed_ns);
+}
+
+static void result_compute_stats(benchmark_result_t *result) {
+    if (result->accum.count == 0) return;
+    
+    stats_t s = stats_accum_result(&result->accum);
+    result->min = s.min;
+    result->max = s.max;
+    result->mean = s.mean;
+    result->variance = s.variance;
+    result->stddev = s.stddev;
+    
+    result->p50 = (double)stats_histogram_percentile(result->latency, 50.0) / 1e6;
+    result->p75 = (double)stats_histogram_percentile(result->latency, 75.0) / 1e6;
+    result->p90 = (double)stats_histogram_percentile(result->latency, 90.0) / 1e6;
+    result->p95 = (double)stats_histogram_percentile(result->latency, 95.0) / 1e6;
+    result->p99 = (double)stats_histogram_percentile(result->latency, 99.0) / 1e6;
+    result->median = result->p50;
+    stats_histogram_free(result->latency);
+    result->latency = NULL;
+    
+    if (result->total_time_ms > 0) {
+        result->ops_per_second = (double)result->total_iterations / (result->total_time_ms / 1000.0);
+    }
+}
+
+static benchmark_suite_t* suite_create(void) {
+    benchmark_suite_t *suite = calloc(1, sizeof(benchmark_suite_t));
+    if (!suite) return NULL;
+    
+    suite->capacity = MAX_RESULTS;
+    suite->results = malloc(suite->capacity * sizeof(benchmark_result_t*));
+    if (!suite->results) {
+        free(suite);
+        return NULL;
+    }
+    
+    return suite;
+}
+
+static void suite_free(benchmark_suite_t *suite) {
+    if (suite) {
+        for (size_t i = 0; i < suite->count; i++) {
+            result_free(suite->results[i]);
+        }
+        free(suite->results);
+        free(suite->json_output);
+        free(suite);
+    }
+}
+
+static void suite_add_result(benchmark_suite_t *suite, benchmark_result_t *result) {
+    if (suite->count >= suite->capacity) {
+        size_t new_capacity = suite->capacity * 2;
+        benchmark_result_t **new_results = realloc(suite->results, 
+                                                    new_capacity * sizeof(benchmark_result_t*));
+        if (!new_results) return;
+        suite->results = new_results;
+        suite->capacity = new_capacity;
+    }
+    suite->results[suite->count++] = result;
+}
+
+static benchmark_result_t* run_benchmark(const char *name, benchmark_func_t func, 
+                                         void *data, size_t iterations, size_t warmup) {
+    benchmark_result_t *result = result_create(name);
+    if (!result) return NULL;
+    
+    result->memory_before = get_memory_usage();
+    result->total_iterations = iterations;
+    
+    for (size_t w = 0; w < warmup; w++) {
+        func(data);
+    }
+    
+    for (size_t i = 0; i < iterations; i++) {
+        uint64_t start = get_time_ns();
+        
+        func(data);
+        
+        uint64_t elapsed_ns = get_time_ns() - start;
+        result_add_sample(result, elapsed_ns);
+        result->total_time_ms += (double)elapsed_ns / 1e6;
+        
+        size_t current_mem = get_memory_usage();
+        if (current_mem > result->memory_peak) {
+            result->memory_peak = current_mem;
+        }
+    }
+    
+    result->memory_after = get_memory_usage();
+    result_compute_stats(result);
+    
+    return result;
+}
+
+static void bench_cpu_intensive(void *data) {
+    volatile double result = 0;
+    size_t n = data ? *(size_t*)data : 10000;
+    
+    for (size_t i = 0; i < n; i++) {
+        result += sqrt((double)i) * sin((double)i) * cos((double)i);
+    }
+}
+
+static void bench_memory_alloc(void *data) {
+    size_t block_size = data ? *(size_t*)data : 1024;
+    size_t count = 100;
+    
+    void **ptrs = malloc(count * sizeof(void*));
+    if (!ptrs) return;
+    
+    for (size_t i = 0; i < count; i++) {
+        ptrs[i] = malloc(block_size);
+        if (ptrs[i]) {
+            memset(ptrs[i], 0, block_size);
+        }
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        free(ptrs[i]);
+    }
+    
+    free(ptrs);
+}
+
+static void bench_math_operations(void *data) {
+    size_t n = data ? *(size_t*)data : 10000;
+    volatile double result = 0;
+    
+    for (size_t i = 1; i <= n; i++) {
+        result += log((double)i);
+        result += exp((double)i / 1000.0);
+        result += pow((double)i, 0.5);
+    }
+}
+
+static void bench_string_operations(void *data) {
+    size_t n = data ? *(size_t*)data : 1000;
+    char buf[256];
+    
+    for (size_t i = 0; i < n; i++) {
+        snprintf(buf, sizeof(buf), "test_string_%zu_value_%zu", i, i * 2);
+        size_t len = strlen(buf);
+        for (size_t j = 0; j < len; j++) {
+            buf[j] = toupper(buf[j]);
+        }
+    }
+}
+
+static void bench_file_io(void *data) {
+    const char *filename = data ? (const char*)data : "/tmp/benchmark_test.tmp";
+    
+    FILE *fp = fopen(filename, "wb");
+    if (!fp) return;
+    
+    char buffer[4096];
+    memset(buffer, 'A', sizeof(buffer));
+    
+    for (int i = 0; i < 10; i++) {
+        fwrite(buffer, 1, sizeof(buffer), fp);
+    }
+    fclose(fp);
+    
+    fp = fopen(filename, "rb");
+    if (fp) {
+        while (fread(buffer, 1, sizeof(buffer), fp) > 0);
+        fclose(fp);
+    }
+    
+    remove(filename);
+}
+
+static void run_builtin_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    size_t cpu_n = 50000;
+    size_t mem_size = 4096;
+    size_t math_n = 10000;
+    size_t str_n = 5000;
+    
+    printf("运行内置基准测试...\n\n");
+    
+    printf("[1/4] CPU密集型操作...\n");
+    benchmark_result_t *cpu_result = run_benchmark("CPU密集型", bench_cpu_intensive, 
+                                                    &cpu_n, iterations, warmup);
+    if (cpu_result) suite_add_result(suite, cpu_result);
+    
+    printf("[2/4] 内存分配操作...\n");
+    benchmark_result_t *mem_result = run_benchmark("内存分配", bench_memory_alloc, 
+                                                    &mem_size, iterations, warmup);
+    if (mem_result) suite_add_result(suite, mem_result);
+    
+    printf("[3/4] 数学运算操作...\n");
+    benchmark_result_t *math_result = run_benchmark("数学运算", bench_math_operations, 
+                                                     &math_n, iterations, warmup);
+    if (math_result) suite_add_result(suite, math_result);
+    
+    printf("[4/4] 字符串操作...\n");
+    benchmark_result_t *str_result = run_benchmark("字符串操作", bench_string_operations, 
+                                                    &str_n, iterations, warmup);
+    if (str_result) suite_add_result(suite, str_result);
+}
+
+// ---------------------------------------------------------------------------
+// 模块基准测试
+// ---------------------------------------------------------------------------
+
+// 生成带重复结构的日志文本, 近似真实日志归档的可压缩性
+static unsigned char* make_log_corpus(size_t size) {
+    static const char *levels[] = { "INFO", "WARN", "DEBUG", "ERROR" };
+    static const char *paths[] = { "/api/users", "/api/orders", "/static/app.js", "/health" };
+    unsigned char *buf = malloc(size);
+    if (!buf) return NULL;
+    
+    size_t pos = 0;
+    unsigned int seed = 2024;
+    while (pos < size) {
+        char line[160];
+        seed = seed * 1103515245 + 12345;
+        int n = snprintf(line, sizeof(line),
+                         "2024-03-%02u 10:%02u:%02u [%s] GET %s status=%u latency=%ums\n",
+                         (seed >> 8) % 28 + 1, (seed >> 12) % 60, (seed >> 16) % 60,
+                         levels[(seed >> 20) % 4], paths[(seed >> 22) % 4],
+                         (seed >> 24) % 2 ? 200 : 404, (seed >> 4) % 500);
+        for (int i = 0; i < n && pos < size; i++) {
+            buf[pos++] = (unsigned char)line[i];
+        }
+    }
+    return buf;
+}
+
+typedef struct {
+    unsigned char *input;
+    size_t input_len;
+    unsigned char *encoded;
+    size_t encoded_cap;
+    size_t encoded_len;
+    unsigned char *decoded;
+} lzw_bench_data_t;
+
+// 改造前 lzw_encode_ex 的查找方式: 每个 (prefix, byte) 线性扫描整个字典, 逐位写出码字
+static size_t lzw_linear_scan_encode(const unsigned char *in, size_t len, unsigned char *out, size_t cap) {
+    enum { DICT_SIZE = 4096, FIRST_CODE = 258 };
+    static unsigned short prefix[DICT_SIZE];
+    static unsigned char suffix[DICT_SIZE];
+    size_t next_code = FIRST_CODE;
+    size_t code_size = 9;
+    size_t bit_pos = 0;
+    
+    memset(out, 0, cap);
+    unsigned short current = in[0];
+    for (size_t i = 1; i <= len; i++) {
+        bool found = false;
+        if (i < len) {
+            for (size_t j = FIRST_CODE; j < next_code; j++) {
+                if (prefix[j] == current && suffix[j] == in[i]) {
+                    current = (unsigned short)j;
+                    found = true;
+                    break;
+                }
+            }
+        }
+        if (found) continue;
+        
+        for (size_t b = 0; b < code_size && bit_pos / 8 < cap; b++, bit_pos++) {
+            unsigned int bit = (current >> (code_size - b - 1)) & 1;
+            out[bit_pos / 8] |= (unsigned char)(bit << (7 - bit_pos % 8));
+        }
+        if (i == len) break;
+        
+        if (next_code < DICT_SIZE) {
+            prefix[next_code] = current;
+            suffix[next_code] = in[i];
+            next_code++;
+            if (next_code > (1u << code_size) && code_size < 12) code_size++;
+        } else {
+            next_code = FIRST_CODE;
+            code_size = 9;
+        }
+        current = in[i];
+    }
+    return (bit_pos + 7) / 8;
+}
+
+static void bench_lzw_encode(void *data) {
+    lzw_bench_data_t *d = data;
+    lzw_config_t config;
+    lzw_get_default_config(&config);
+    lzw_encode_ex(d->input, d->input_len, d->encoded, d->encoded_cap, &d->encoded_len, &config);
+}
+
+static void bench_lzw_encode_linear(void *data) {
+    lzw_bench_data_t *d = data;
+    lzw_linear_scan_encode(d->input, d->input_len, d->encoded, d->encoded_cap);
+}
+
+static void bench_lzw_decode(void *data) {
+    lzw_bench_data_t *d = data;
+    size_t out_len;
+    lzw_decode(d->encoded, d->encoded_len, d->decoded, d->input_len, &out_len);
+}
+
+static void run_lzw_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    lzw_bench_data_t d;
+    d.input_len = 4 * 1024 * 1024;
+    d.input = make_log_corpus(d.input_len);
+    d.encoded_cap = d.input_len + d.input_len / 2 + 100;
+    d.encoded = malloc(d.encoded_cap);
+    d.decoded = malloc(d.input_len);
+    d.encoded_len = 0;
+    if (!d.input || !d.encoded || !d.decoded) {
+        free(d.input);
+        free(d.encoded);
+        free(d.decoded);
+        return;
+    }
+    
+    printf("[lzw] 哈希字典编码 (4MB)...\n");
+    benchmark_result_t *r = run_benchmark("LZW编码(哈希)", bench_lzw_encode, &d, iterations, warmup);
+    if (r) suite_add_result(suite, r);
+    
+    printf("[lzw] 解码 (4MB)...\n");
+    r = run_benchmark("LZW解码", bench_lzw_decode, &d, iterations, warmup);
+    if (r) {
+        r->passed = memcmp(d.input, d.decoded, d.input_len) == 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "解码结果不一致");
+        suite_add_result(suite, r);
+    }
+    
+    printf("[lzw] 线性扫描字典编码基线 (4MB, 较慢)...\n");
+    r = run_benchmark("LZW编码(线性扫描)", bench_lzw_encode_linear, &d, 1, 0);
+    if (r) suite_add_result(suite, r);
+    
+    free(d.input);
+    free(d.encoded);
+    free(d.decoded);
+}
+
+typedef struct {
+    unsigned char *input;
+    size_t input_len;
+    unsigned char *encoded;
+    size_t encoded_len;
+    unsigned char *decoded;
+    huffman_node_t *tree;
+    huffman_decoder_t *decoder;
+} huffman_bench_data_t;
+
+static void bench_huffman_decode_tree(void *data) {
+    huffman_bench_data_t *d = data;
+    huffman_error_t error;
+    huffman_decode(d->encoded, d->encoded_len, d->decoded, d->input_len, d->tree, &error);
+}
+
+static void bench_huffman_decode_table(void *data) {
+    huffman_bench_data_t *d = data;
+    huffman_error_t error;
+    huffman_decode_table(d->decoder, d->encoded, d->encoded_len, d->decoded, d->input_len, &error);
+}
+
+static void run_huffman_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    huffman_bench_data_t d;
+    memset(&d, 0, sizeof(d));
+    d.input_len = 4 * 1024 * 1024;
+    d.input = make_log_corpus(d.input_len);
+    d.encoded = malloc(huffman_compress_bound(d.input_len));
+    d.decoded = malloc(d.input_len);
+    d.decoder = malloc(sizeof(huffman_decoder_t));
+    if (!d.input || !d.encoded || !d.decoded || !d.decoder) goto cleanup;
+    
+    // 两种解码器使用同一份规范码位流: 树由相同码长重建, 只比较解码方式本身
+    size_t freq[256];
+    unsigned char lengths[256];
+    huffman_code_t table[256];
+    huffman_error_t error;
+    huffman_stats(d.input, d.input_len, freq);
+    if (huffman_build_lengths(freq, HUFFMAN_MAX_CODE_LEN, lengths) != HUFFMAN_OK ||
+        huffman_build_canonical_table(lengths, table) != HUFFMAN_OK ||
+        huffman_decoder_init(d.decoder, lengths) != HUFFMAN_OK) goto cleanup;
+    
+    d.encoded_len = huffman_encode(d.input, d.input_len, d.encoded,
+                                   huffman_compress_bound(d.input_len), table, &error);
+    
+    d.tree = calloc(1, sizeof(huffman_node_t));
+    for (int s = 0; s < 256 && d.tree; s++) {
+        if (!table[s].code_len) continue;
+        huffman_node_t *node = d.tree;
+        for (size_t b = table[s].code_len; b-- > 0;) {
+            huffman_node_t **next = ((table[s].code >> b) & 1) ? &node->right : &node->left;
+            if (!*next) *next = calloc(1, sizeof(huffman_node_t));
+            node = *next;
+        }
+        node->symbol = (unsigned char)s;
+    }
+    
+    printf("[huffman] 编码 %zu 字节 -> %zu 字节\n", d.input_len, d.encoded_len);
+    
+    printf("[huffman] 查找表解码 (4MB)...\n");
+    benchmark_result_t *r = run_benchmark("Huffman解码(查表)", bench_huffman_decode_table, &d, iterations, warmup);
+    if (r) {
+        r->passed = memcmp(d.input, d.decoded, d.input_len) == 0;
+        suite_add_result(suite, r);
+    }
+    
+    printf("[huffman] 指针树逐位解码 (4MB)...\n");
+    r = run_benchmark("Huffman解码(树)", bench_huffman_decode_tree, &d, iterations, warmup);
+    if (r) {
+        r->passed = memcmp(d.input, d.decoded, d.input_len) == 0;
+        suite_add_result(suite, r);
+    }
+    
+cleanup:
+    huffman_free_tree(d.tree);
+    free(d.decoder);
+    free(d.input);
+    free(d.encoded);
+    free(d.decoded);
+}
+
+typedef struct {
+    unsigned char *input;
+    size_t input_len;
+    unsigned char *packed;
+    size_t packed_cap;
+    size_t packed_len;
+    unsigned char *decoded;
+    frame_config_t config;
+} frame_bench_data_t;
+
+static void bench_frame_compress(void *data) {
+    frame_bench_data_t *d = data;
+    frame_compress_buffer(d->input, d->input_len, d->packed, d->packed_cap, &d->packed_len, &d->config, NULL);
+}
+
+static void bench_frame_decompress(void *data) {
+    frame_bench_data_t *d = data;
+    size_t out_len;
+    frame_decompress_buffer(d->packed, d->packed_len, d->decoded, d->input_len, &out_len, &d->config, NULL);
+}
+
+static void run_frame_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    frame_bench_data_t d;
+    memset(&d, 0, sizeof(d));
+    d.input_len = 32u << 20;
+    d.input = make_log_corpus(d.input_len);
+    d.packed_cap = frame_compress_bound(d.input_len, FRAME_DEFAULT_BLOCK_SIZE);
+    d.packed = malloc(d.packed_cap);
+    d.decoded = malloc(d.input_len);
+    threadpool_t *single = threadpool_create(1);
+    threadpool_t *pool = threadpool_create(0);
+    if (!d.input || !d.packed || !d.decoded || !single || !pool) goto cleanup;
+    
+    d.config = frame_default_config();
+    d.config.level = 1;
+    
+    threadpool_t *pools[] = { single, pool };
+    const char *compress_names[] = { "帧压缩(1线程)", "帧压缩(全部核心)" };
+    const char *decompress_names[] = { "帧解压(1线程)", "帧解压(全部核心)" };
+    for (int i = 0; i < 2; i++) {
+        d.config.pool = pools[i];
+        printf("[frame] DEFLATE 分块压缩 32MB, %d 线程...\n", threadpool_get_thread_count(pools[i]));
+        benchmark_result_t *r = run_benchmark(compress_names[i], bench_frame_compress, &d, iterations, warmup);
+        if (r) {
+            r->passed = d.packed_len > 0 && d.packed_len < d.input_len;
+            suite_add_result(suite, r);
+        }
+        
+        printf("[frame] 分块解压 32MB, %d 线程...\n", threadpool_get_thread_count(pools[i]));
+        r = run_benchmark(decompress_names[i], bench_frame_decompress, &d, iterations, warmup);
+        if (r) {
+            r->passed = memcmp(d.input, d.decoded, d.input_len) == 0;
+            suite_add_result(suite, r);
+        }
+    }
+    printf("[frame] 压缩后 %zu 字节\n", d.packed_len);
+    
+cleanup:
+    threadpool_destroy(single);
+    threadpool_destroy(pool);
+    free(d.input);
+    free(d.packed);
+    free(d.decoded);
+}
+
+typedef struct {
+    uint8_t key[32];
+    uint8_t nonce[12];
+    uint8_t *input;
+    uint8_t *output;
+    size_t len;
+    size_t message_size;
+    uint8_t tag[16];
+} aead_bench_data_t;
+
+static void bench_chacha20_stream(void *data) {
+    aead_bench_data_t *d = data;
+    chacha20_encrypt(d->key, d->nonce, 1, d->input, d->output, d->len);
+}
+
+static void bench_poly1305_mac(void *data) {
+    aead_bench_data_t *d = data;
+    poly1305_tiny(d->key, d->input, d->len, d->tag);
+}
+
+static void bench_aead_encrypt(void *data) {
+    aead_bench_data_t *d = data;
+    chacha20_poly1305_encrypt(d->key, d->nonce, NULL, 0, d->input, d->output, d->len, d->tag);
+}
+
+// 模拟消息队列负载: 大量固定长度小消息, 每条独立加密并带 AAD
+static void bench_aead_messages(void *data) {
+    aead_bench_data_t *d = data;
+    uint8_t aad[16] = {0};
+    for (size_t off = 0; off + d->message_size <= d->len; off += d->message_size) {
+        memcpy(d->nonce, &off, sizeof(off) < 12 ? sizeof(off) : 12);
+        chacha20_poly1305_encrypt(d->key, d->nonce, aad, sizeof(aad), d->input + off, d->output + off,
+                                  d->message_size, d->tag);
+    }
+}
+
+static void run_chacha20_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    aead_bench_data_t d;
+    memset(&d, 0, sizeof(d));
+    d.len = 16u << 20;
+    d.message_size = 1024;
+    d.input = malloc(d.len);
+    d.output = malloc(d.len);
+    if (!d.input || !d.output) goto cleanup;
+    for (size_t i = 0; i < d.len; i++) d.input[i] = (uint8_t)(i * 131);
+    for (int i = 0; i < 32; i++) d.key[i] = (uint8_t)(i + 1);
+    
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+    } cases[] = {
+        { "ChaCha20(16MB)", "ChaCha20 多块密钥流加密", bench_chacha20_stream },
+        { "Poly1305(16MB)", "Poly1305 64 位分段 MAC", bench_poly1305_mac },
+        { "AEAD加密(16MB)", "ChaCha20-Poly1305 单条大消息", bench_aead_encrypt },
+        { "AEAD加密(1KB消息)", "ChaCha20-Poly1305 16384 条 1KB 消息", bench_aead_messages },
+    };
+    
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[chacha20] %s...\n", cases[i].label);
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = chacha20_validate_test_vectors();
+        if (r->mean > 0) {
+            printf("[chacha20] %s: %.0f MB/s\n", cases[i].name, (double)d.len / (1 << 20) / (r->mean / 1000.0));
+        }
+        suite_add_result(suite, r);
+    }
+    
+cleanup:
+    free(d.input);
+    free(d.output);
+}
+
+// 改造前 trie 的节点布局: 每个节点固定 256 个子指针, 逐字节下降
+typedef struct legacy_trie_node_s {
+    struct legacy_trie_node_s *children[256];
+    void *value;
+    bool is_end;
+} legacy_trie_node_t;
+
+static legacy_trie_node_t *legacy_trie_insert(legacy_trie_node_t *root, const char *key, void *value,
+                                              size_t *memory) {
+    if (!root) {
+        root = calloc(1, sizeof(legacy_trie_node_t));
+        if (!root) return NULL;
+        *memory += sizeof(legacy_trie_node_t);
+    }
+    legacy_trie_node_t *node = root;
+    for (const unsigned char *p = (const unsigned char *)key; *p; p++) {
+        if (!node->children[*p]) {
+            node->children[*p] = calloc(1, sizeof(legacy_trie_node_t));
+            if (!node->children[*p]) return root;
+            *memory += sizeof(legacy_trie_node_t);
+        }
+        node = node->children[*p];
+    }
+    node->value = value;
+    node->is_end = true;
+    return root;
+}
+
+static void *legacy_trie_get(const legacy_trie_node_t *node, const char *key) {
+    for (const unsigned char *p = (const unsigned char *)key; node && *p; p++) {
+        node = node->children[*p];
+    }
+    return node && node->is_end ? node->value : NULL;
+}
+
+static void legacy_trie_free(legacy_trie_node_t *node) {
+    if (!node) return;
+    for (int i = 0; i < 256; i++) legacy_trie_free(node->children[i]);
+    free(node);
+}
+
+typedef struct {
+    char **keys;
+    size_t count;
+    trie_t *art;
+    legacy_trie_node_t *legacy;
+    size_t hits;
+} trie_bench_data_t;
+
+static void bench_trie_art_lookup(void *data) {
+    trie_bench_data_t *d = data;
+    size_t hits = 0;
+    for (size_t i = 0; i < d->count; i++) {
+        if (trie_get(d->art, d->keys[i])) hits++;
+    }
+    d->hits = hits;
+}
+
+static void bench_trie_legacy_lookup(void *data) {
+    trie_bench_data_t *d = data;
+    size_t hits = 0;
+    for (size_t i = 0; i < d->count; i++) {
+        if (legacy_trie_get(d->legacy, d->keys[i])) hits++;
+    }
+    d->hits = hits;
+}
+
+static void bench_trie_art_build(void *data) {
+    trie_bench_data_t *d = data;
+    trie_t *t = trie_create();
+    for (size_t i = 0; i < d->count; i++) trie_insert(t, d->keys[i], d->keys[i]);
+    trie_free(t);
+}
+
+static void run_trie_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    static const char *hosts[] = { "api.example.com", "static.example.com", "cdn.example.net", "internal.svc" };
+    static const char *sections[] = { "users", "orders", "products", "search", "assets", "reports" };
+    trie_bench_data_t d;
+    memset(&d, 0, sizeof(d));
+    d.count = 100000;
+    d.keys = calloc(d.count, sizeof(char *));
+    if (!d.keys) return;
+
+    // URL / 路径形态的键: 长公共前缀, 中段分叉少, 末段编号分叉多
+    for (size_t i = 0; i < d.count; i++) {
+        char buf[128];
+        snprintf(buf, sizeof(buf), "https://%s/v%zu/%s/%zu/item-%zu", hosts[i % 4], 1 + i % 3,
+                 sections[(i / 4) % 6], (i * 2654435761u) % 5000, i);
+        d.keys[i] = strdup(buf);
+    }
+
+    size_t legacy_memory = 0;
+    d.art = trie_create();
+    for (size_t i = 0; i < d.count; i++) {
+        trie_insert(d.art, d.keys[i], d.keys[i]);
+        d.legacy = legacy_trie_insert(d.legacy, d.keys[i], d.keys[i], &legacy_memory);
+    }
+    printf("[trie] %zu 个键: ART %.1f MB, 256 指针节点 %.1f MB\n", d.count,
+           trie_memory_usage(d.art) / 1048576.0, legacy_memory / 1048576.0);
+
+    printf("[trie] ART 查找...\n");
+    benchmark_result_t *r = run_benchmark("Trie查找(ART)", bench_trie_art_lookup, &d, iterations, warmup);
+    if (r) {
+        r->passed = d.hits == d.count && trie_size(d.art) == d.count;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "命中数不一致");
+        suite_add_result(suite, r);
+    }
+
+    printf("[trie] 256 指针节点查找基线...\n");
+    r = run_benchmark("Trie查找(256指针)", bench_trie_legacy_lookup, &d, iterations, warmup);
+    if (r) {
+        r->passed = d.hits == d.count;
+        suite_add_result(suite, r);
+    }
+
+    printf("[trie] ART 构建...\n");
+    r = run_benchmark("Trie构建(ART)", bench_trie_art_build, &d, iterations, warmup);
+    if (r) suite_add_result(suite, r);
+
+    trie_free(d.art);
+    legacy_trie_free(d.legacy);
+    for (size_t i = 0; i < d.count; i++) free(d.keys[i]);
+    free(d.keys);
+}
+
+typedef struct {
+    size_t count;
+    uint64_t *keys;          // 有序键
+    uint64_t *probes;        // 乱序查找序列
+    bplus_tree_t *u64_tree;
+    bplus_tree_t *ptr_tree;
+    size_t hits;
+} bplus_bench_data_t;
+
+static int bench_u64_compare(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void bench_bplus_insert_random(void *data) {
+    bplus_bench_data_t *d = data;
+    bplus_tree_t *tree = bplus_tree_create_u64();
+    for (size_t i = 0; i < d->count; i++) bplus_tree_insert_u64(tree, d->probes[i], NULL);
+    bplus_tree_free(tree);
+}
+
+static void bench_bplus_bulk_load(void *data) {
+    bplus_bench_data_t *d = data;
+    bplus_tree_t *tree = bplus_tree_create_u64();
+    bplus_tree_bulk_load_u64(tree, d->keys, NULL, d->count);
+    bplus_tree_free(tree);
+}
+
+static void bench_bplus_get_u64(void *data) {
+    bplus_bench_data_t *d = data;
+    size_t hits = 0;
+    for (size_t i = 0; i < d->count; i++) {
+        bool found;
+        bplus_tree_get_u64(d->u64_tree, d->probes[i], &found);
+        hits += found;
+    }
+    d->hits = hits;
+}
+
+static void bench_bplus_get_ptr(void *data) {
+    bplus_bench_data_t *d = data;
+    size_t hits = 0;
+    for (size_t i = 0; i < d->count; i++) {
+        hits += bplus_tree_get(d->ptr_tree, &d->probes[i]) != NULL;
+    }
+    d->hits = hits;
+}
+
+static bool bench_bplus_count(uint64_t key, void *value, void *user_data) {
+    (void)key;
+    (void)value;
+    (*(size_t *)user_data)++;
+    return true;
+}
+
+static void bench_bplus_range_scan(void *data) {
+    bplus_bench_data_t *d = data;
+    size_t n = 0;
+    bplus_tree_range_query_u64(d->u64_tree, 0, UINT64_MAX, bench_bplus_count, &n);
+    d->hits = n;
+}
+
+static void run_bplus_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    bplus_bench_data_t d;
+    memset(&d, 0, sizeof(d));
+    d.count = 1000000;
+    d.keys = malloc(d.count * sizeof(uint64_t));
+    d.probes = malloc(d.count * sizeof(uint64_t));
+    const void **ptr_keys = malloc(d.count * sizeof(void *));
+    if (!d.keys || !d.probes || !ptr_keys) goto cleanup;
+
+    for (size_t i = 0; i < d.count; i++) {
+        d.keys[i] = i * 7 + 3;
+        d.probes[i] = d.keys[i];
+        ptr_keys[i] = &d.keys[i];
+    }
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (size_t i = d.count - 1; i > 0; i--) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t j = seed % (i + 1);
+        uint64_t tmp = d.probes[i];
+        d.probes[i] = d.probes[j];
+        d.probes[j] = tmp;
+    }
+
+    d.u64_tree = bplus_tree_create_u64();
+    d.ptr_tree = bplus_tree_create(bench_u64_compare);
+    bplus_tree_bulk_load_u64(d.u64_tree, d.keys, NULL, d.count);
+    bplus_tree_bulk_load(d.ptr_tree, ptr_keys, (void *const *)ptr_keys, d.count);
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+        size_t expected_hits;
+    } cases[] = {
+        { "B+树乱序插入(1M)", "整数键乱序插入", bench_bplus_insert_random, 0 },
+        { "B+树批量构建(1M)", "有序数据批量构建", bench_bplus_bulk_load, 0 },
+        { "B+树查找(内联整数键)", "内联整数键无分支查找", bench_bplus_get_u64, d.count },
+        { "B+树查找(比较函数)", "键指针 + 比较函数查找基线", bench_bplus_get_ptr, d.count },
+        { "B+树范围扫描(1M)", "叶子链表全量范围扫描", bench_bplus_range_scan, d.count },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[bplus] %s...\n", cases[i].label);
+        d.hits = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = cases[i].expected_hits == 0 || d.hits == cases[i].expected_hits;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "命中数不一致");
+        suite_add_result(suite, r);
+    }
+
+    bplus_tree_free(d.u64_tree);
+    bplus_tree_free(d.ptr_tree);
+cleanup:
+    free(d.keys);
+    free(d.probes);
+    free(ptr_keys);
+}
+
+// kv_store 基准: 旧版 "key=value" 文本文件每次查找都要扫描整个文件, 作为基线保留在这里
+#define KV_BENCH_COUNT 20000
+#define KV_BENCH_FILE_LOOKUPS 200
+
+typedef struct {
+    char keys[KV_BENCH_COUNT][24];
+    char values[KV_BENCH_COUNT][40];
+    size_t probes[KV_BENCH_COUNT];
+    const char *text_path;
+    const char *store_path;
+    const char *scratch_path;
+    const char *lsm_path;
+    const char *lsm_scratch_path;
+    kv_store_t *store;
+    kv_store_t *lsm_store;
+    size_t hits;
+} kv_bench_data_t;
+
+static bool legacy_text_lookup(const char *path, const char *key, char *out, size_t out_size) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return false;
+    char line[4096];
+    size_t key_len = strlen(key);
+    bool found = false;
+    while (fgets(line, sizeof(line), fp)) {
+        if (strncmp(line, key, key_len) == 0 && line[key_len] == '=') {
+            snprintf(out, out_size, "%s", line + key_len + 1);
+            out[strcspn(out, "\r\n")] = '\0';
+            found = true;
+            break;
+        }
+    }
+    fclose(fp);
+    return found;
+}
+
+static void bench_kv_text_lookup(void *data) {
+    kv_bench_data_t *d = data;
+    char value[64];
+    for (size_t i = 0; i < KV_BENCH_FILE_LOOKUPS; i++) {
+        d->hits += legacy_text_lookup(d->text_path, d->keys[d->probes[i]], value, sizeof(value));
+    }
+}
+
+static void bench_kv_file_lookup(void *data) {
+    kv_bench_data_t *d = data;
+    char value[64];
+    size_t len;
+    for (size_t i = 0; i < KV_BENCH_FILE_LOOKUPS; i++) {
+        d->hits += kv_load_ex(d->store_path, d->keys[d->probes[i]], value, sizeof(value), &len) == KV_OK;
+    }
+}
+
+static void bench_kv_handle_lookup(void *data) {
+    kv_bench_data_t *d = data;
+    char value[64];
+    size_t len;
+    for (size_t i = 0; i < KV_BENCH_COUNT; i++) {
+        d->hits += kv_store_get(d->store, d->keys[d->probes[i]], value, sizeof(value), &len) == KV_OK;
+    }
+}
+
+static kv_store_t* kv_bench_open_scratch(kv_bench_data_t *d) {
+    kv_config_t config;
+    kv_get_default_config(&config);
+    config.sync_on_commit = false;
+    unlink(d->scratch_path);
+    return kv_store_open(d->scratch_path, &config, NULL);
+}
+
+static void bench_kv_batch_put(void *data) {
+    kv_bench_data_t *d = data;
+    kv_entry_t *entries = malloc(KV_BENCH_COUNT * sizeof(kv_entry_t));
+    kv_store_t *store = kv_bench_open_scratch(d);
+    if (entries && store) {
+        for (size_t i = 0; i < KV_BENCH_COUNT; i++) {
+            entries[i].key = d->keys[d->probes[i]];
+            entries[i].value = d->values[d->probes[i]];
+        }
+        kv_store_put_batch(store, entries, KV_BENCH_COUNT);
+        d->hits += kv_store_count(store);
+    }
+    kv_store_close(store);
+    free(entries);
+}
+
+static void bench_kv_single_put(void *data) {
+    kv_bench_data_t *d = data;
+    kv_store_t *store = kv_bench_open_scratch(d);
+    if (!store) return;
+    for (size_t i = 0; i < KV_BENCH_COUNT / 10; i++) {
+        const char *value = d->values[d->probes[i]];
+        d->hits += kv_store_put(store, d->keys[d->probes[i]], value, strlen(value)) == KV_OK;
+    }
+    kv_store_close(store);
+}
+
+static void kv_bench_remove_dir(const char *path) {
+    DIR *dir = opendir(path);
+    if (!dir) return;
+    struct dirent *ent;
+    char file[512];
+    while ((ent = readdir(dir)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+        snprintf(file, sizeof(file), "%s/%s", path, ent->d_name);
+        unlink(file);
+    }
+    closedir(dir);
+    rmdir(path);
+}
+
+static kv_store_t* kv_bench_open_lsm(const char *path) {
+    kv_config_t config;
+    kv_get_default_config(&config);
+    config.engine = KV_ENGINE_LSM;
+    config.sync_on_commit = false;
+    config.memtable_size = 256 * 1024;
+    kv_bench_remove_dir(path);
+    return kv_store_open(path, &config, NULL);
+}
+
+// 随机顺序的单条写入: B+ 树每条一个写时复制事务, LSM 只追加日志并插入内存表
+static void bench_kv_btree_random_put(void *data) {
+    kv_bench_data_t *d = data;
+    kv_store_t *store = kv_bench_open_scratch(d);
+    if (!store) return;
+    for (size_t i = 0; i < KV_BENCH_COUNT; i++) {
+        const char *value = d->values[d->probes[i]];
+        d->hits += kv_store_put(store, d->keys[d->probes[i]], value, strlen(value)) == KV_OK;
+    }
+    kv_store_close(store);
+}
+
+static void bench_kv_lsm_random_put(void *data) {
+    kv_bench_data_t *d = data;
+    kv_store_t *store = kv_bench_open_lsm(d->lsm_scratch_path);
+    if (!store) return;
+    for (size_t i = 0; i < KV_BENCH_COUNT; i++) {
+        const char *value = d->values[d->probes[i]];
+        d->hits += kv_store_put(store, d->keys[d->probes[i]], value, strlen(value)) == KV_OK;
+    }
+    kv_store_flush(store);
+    kv_store_close(store);
+}
+
+static void bench_kv_lsm_lookup(void *data) {
+    kv_bench_data_t *d = data;
+    char value[64];
+    size_t len;
+    for (size_t i = 0; i < KV_BENCH_COUNT; i++) {
+        d->hits += kv_store_get(d->lsm_store, d->keys[d->probes[i]], value, sizeof(value), &len) == KV_OK;
+    }
+}
+
+static void run_kv_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    kv_bench_data_t *d = calloc(1, sizeof(kv_bench_data_t));
+    if (!d) return;
+    d->text_path = "/tmp/benchmark_kv_legacy.txt";
+    d->store_path = "/tmp/benchmark_kv_store.kv";
+    d->scratch_path = "/tmp/benchmark_kv_scratch.kv";
+    d->lsm_path = "/tmp/benchmark_kv_lsm";
+    d->lsm_scratch_path = "/tmp/benchmark_kv_lsm_scratch";
+
+    // 同样的数据写成两份旧版文本文件, 其中一份在打开时迁移为页式文件
+    FILE *text = fopen(d->text_path, "w");
+    FILE *legacy = fopen(d->store_path, "w");
+    for (size_t i = 0; text && legacy && i < KV_BENCH_COUNT; i++) {
+        snprintf(d->keys[i], sizeof(d->keys[i]), "user:%08zu", i * 2654435761u % 100000000);
+        snprintf(d->values[i], sizeof(d->values[i]), "session-%zu-%zu", i, i * 31);
+        fprintf(text, "%s=%s\n", d->keys[i], d->values[i]);
+        fprintf(legacy, "%s=%s\n", d->keys[i], d->values[i]);
+        d->probes[i] = i;
+    }
+    if (text) fclose(text);
+    if (legacy) fclose(legacy);
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (size_t i = KV_BENCH_COUNT - 1; i > 0; i--) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        size_t j = seed % (i + 1);
+        size_t tmp = d->probes[i];
+        d->probes[i] = d->probes[j];
+        d->probes[j] = tmp;
+    }
+
+    if (text && legacy) d->store = kv_store_open(d->store_path, NULL, NULL);
+    if (!d->store) {
+        unlink(d->text_path);
+        unlink(d->store_path);
+        free(d);
+        return;
+    }
+
+    // LSM 查找基准: 写入后落盘, 数据分布在压缩后的各层表中
+    d->lsm_store = kv_bench_open_lsm(d->lsm_path);
+    for (size_t i = 0; d->lsm_store && i < KV_BENCH_COUNT; i++) {
+        kv_store_put(d->lsm_store, d->keys[d->probes[i]], d->values[d->probes[i]], strlen(d->values[d->probes[i]]));
+    }
+    if (d->lsm_store) kv_store_flush(d->lsm_store);
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+        size_t expected_hits;
+    } cases[] = {
+        { "KV文本扫描查找(200)", "旧版文本文件逐行扫描查找基线", bench_kv_text_lookup, KV_BENCH_FILE_LOOKUPS },
+        { "KV页式文件查找(200)", "按文件名打开页式文件并查找", bench_kv_file_lookup, KV_BENCH_FILE_LOOKUPS },
+        { "KV句柄查找(20K)", "打开的句柄上 B+ 树点查询", bench_kv_handle_lookup, KV_BENCH_COUNT },
+        { "KV批量写入(20K)", "单事务批量写入", bench_kv_batch_put, KV_BENCH_COUNT },
+        { "KV单条提交(2K)", "每条写入一个写时复制事务 (不 fsync)", bench_kv_single_put, KV_BENCH_COUNT / 10 },
+        { "KV B+树随机写(20K)", "B+ 树引擎随机顺序单条写入 (不 fsync)", bench_kv_btree_random_put, KV_BENCH_COUNT },
+        { "KV LSM随机写(20K)", "LSM 引擎随机顺序单条写入并落盘 (不 fsync)", bench_kv_lsm_random_put, KV_BENCH_COUNT },
+        { "KV LSM句柄查找(20K)", "LSM 引擎布隆过滤器 + 块索引点查询", bench_kv_lsm_lookup, KV_BENCH_COUNT },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        if (cases[i].func == bench_kv_lsm_lookup && !d->lsm_store) continue;
+        printf("[kv] %s...\n", cases[i].label);
+        d->hits = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, d, iterations, warmup);
+        if (!r) continue;
+        size_t runs = iterations + warmup;
+        r->passed = d->hits == cases[i].expected_hits * runs;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "命中数不一致");
+        suite_add_result(suite, r);
+    }
+
+    kv_store_close(d->store);
+    kv_store_close(d->lsm_store);
+    unlink(d->text_path);
+    unlink(d->store_path);
+    unlink(d->scratch_path);
+    kv_bench_remove_dir(d->lsm_path);
+    kv_bench_remove_dir(d->lsm_scratch_path);
+    free(d);
+}
+
+
+// 跳表基准: 原版跳表 (单线程或外加互斥锁) 与无锁跳表的插入/查找对比
+#define SKIPLIST_BENCH_COUNT 200000
+#define SKIPLIST_BENCH_THREADS 4
+
+typedef struct {
+    uint64_t keys[SKIPLIST_BENCH_COUNT];       // 大端序, 字节序与数值序一致
+    skiplist_t *locked_list;
+    skiplist_lf_t *lf_list;
+    pthread_mutex_t lock;
+    size_t hits;
+} skiplist_bench_data_t;
+
+typedef struct {
+    skiplist_bench_data_t *d;
+    size_t begin;
+    size_t end;
+    size_t hits;
+} skiplist_bench_part_t;
+
+static int skiplist_bench_compare(const void *a, const void *b) {
+    return memcmp(a, b, sizeof(uint64_t));
+}
+
+static void skiplist_bench_parallel(skiplist_bench_data_t *d, void *(*func)(void *)) {
+    pthread_t threads[SKIPLIST_BENCH_THREADS];
+    skiplist_bench_part_t parts[SKIPLIST_BENCH_THREADS];
+    size_t step = SKIPLIST_BENCH_COUNT / SKIPLIST_BENCH_THREADS;
+    for (int i = 0; i < SKIPLIST_BENCH_THREADS; i++) {
+        parts[i].d = d;
+        parts[i].begin = i * step;
+        parts[i].end = i == SKIPLIST_BENCH_THREADS - 1 ? SKIPLIST_BENCH_COUNT : (i + 1) * step;
+        parts[i].hits = 0;
+        pthread_create(&threads[i], NULL, func, &parts[i]);
+    }
+    for (int i = 0; i < SKIPLIST_BENCH_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        d->hits += parts[i].hits;
+    }
+}
+
+static void bench_skiplist_insert(void *data) {
+    skiplist_bench_data_t *d = data;
+    skiplist_t *sl = skiplist_create(skiplist_bench_compare);
+    for (size_t i = 0; sl && i < SKIPLIST_BENCH_COUNT; i++) skiplist_insert(sl, &d->keys[i], &d->keys[i]);
+    d->hits += sl ? sl->size : 0;
+    skiplist_free(sl);
+}
+
+static void bench_skiplist_lf_insert(void *data) {
+    skiplist_bench_data_t *d = data;
+    skiplist_lf_t *sl = skiplist_lf_create(NULL, 0);
+    for (size_t i = 0; sl && i < SKIPLIST_BENCH_COUNT; i++) {
+        skiplist_lf_insert(sl, &d->keys[i], sizeof(uint64_t), &d->keys[i]);
+    }
+    d->hits += skiplist_lf_size(sl);
+    skiplist_lf_free(sl, NULL);
+}
+
+static void* skiplist_locked_insert_part(void *arg) {
+    skiplist_bench_part_t *p = arg;
+    for (size_t i = p->begin; i < p->end; i++) {
+        pthread_mutex_lock(&p->d->lock);
+        skiplist_insert(p->d->locked_list, &p->d->keys[i], &p->d->keys[i]);
+        pthread_mutex_unlock(&p->d->lock);
+    }
+    return NULL;
+}
+
+static void* skiplist_lf_insert_part(void *arg) {
+    skiplist_bench_part_t *p = arg;
+    for (size_t i = p->begin; i < p->end; i++) {
+        p->hits += skiplist_lf_insert(p->d->lf_list, &p->d->keys[i], sizeof(uint64_t), &p->d->keys[i]);
+    }
+    return NULL;
+}
+
+static void bench_skiplist_locked_insert_mt(void *data) {
+    skiplist_bench_data_t *d = data;
+    d->locked_list = skiplist_create(skiplist_bench_compare);
+    if (!d->locked_list) return;
+    skiplist_bench_parallel(d, skiplist_locked_insert_part);
+    d->hits += d->locked_list->size;
+    skiplist_free(d->locked_list);
+    d->locked_list = NULL;
+}
+
+static void bench_skiplist_lf_insert_mt(void *data) {
+    skiplist_bench_data_t *d = data;
+    skiplist_lf_t *saved = d->lf_list;
+    d->lf_list = skiplist_lf_create(NULL, 0);
+    if (d->lf_list) skiplist_bench_parallel(d, skiplist_lf_insert_part);
+    skiplist_lf_free(d->lf_list, NULL);
+    d->lf_list = saved;
+}
+
+static void* skiplist_locked_get_part(void *arg) {
+    skiplist_bench_part_t *p = arg;
+    for (size_t i = p->begin; i < p->end; i++) {
+        pthread_mutex_lock(&p->d->lock);
+        p->hits += skiplist_get(p->d->locked_list, &p->d->keys[i]) != NULL;
+        pthread_mutex_unlock(&p->d->lock);
+    }
+    return NULL;
+}
+
+static void* skiplist_lf_get_part(void *arg) {
+    skiplist_bench_part_t *p = arg;
+    for (size_t i = p->begin; i < p->end; i++) {
+        p->hits += skiplist_lf_get(p->d->lf_list, &p->d->keys[i], sizeof(uint64_t), NULL);
+    }
+    return NULL;
+}
+
+static void bench_skiplist_locked_get_mt(void *data) {
+    skiplist_bench_parallel(data, skiplist_locked_get_part);
+}
+
+static void bench_skiplist_lf_get_mt(void *data) {
+    skiplist_bench_parallel(data, skiplist_lf_get_part);
+}
+
+static void run_skiplist_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    skiplist_bench_data_t *d = calloc(1, sizeof(skiplist_bench_data_t));
+    if (!d) return;
+    pthread_mutex_init(&d->lock, NULL);
+    uint64_t seed = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < SKIPLIST_BENCH_COUNT; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        uint64_t key = seed;
+        for (int b = 0; b < 8; b++) ((uint8_t *)&d->keys[i])[b] = (uint8_t)(key >> (56 - 8 * b));
+    }
+
+    // 查找用的两份预先建好的跳表
+    skiplist_t *lookup_list = skiplist_create(skiplist_bench_compare);
+    d->lf_list = skiplist_lf_create(NULL, 0);
+    for (size_t i = 0; lookup_list && d->lf_list && i < SKIPLIST_BENCH_COUNT; i++) {
+        skiplist_insert(lookup_list, &d->keys[i], &d->keys[i]);
+        skiplist_lf_insert(d->lf_list, &d->keys[i], sizeof(uint64_t), &d->keys[i]);
+    }
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+        bool uses_lookup_list;
+    } cases[] = {
+        { "跳表插入(原版,200K)", "原版跳表单线程插入", bench_skiplist_insert, false },
+        { "跳表插入(无锁,200K)", "无锁跳表单线程插入 (arena 分配)", bench_skiplist_lf_insert, false },
+        { "跳表插入(加锁原版,4线程)", "原版跳表外加互斥锁, 4 线程插入", bench_skiplist_locked_insert_mt, false },
+        { "跳表插入(无锁,4线程)", "无锁跳表 4 线程 CAS 插入", bench_skiplist_lf_insert_mt, false },
+        { "跳表查找(加锁原版,4线程)", "原版跳表外加互斥锁, 4 线程查找", bench_skiplist_locked_get_mt, true },
+        { "跳表查找(无锁,4线程)", "无锁跳表 4 线程查找", bench_skiplist_lf_get_mt, false },
+    };
+
+    for (size_t i = 0; lookup_list && d->lf_list && i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[skiplist] %s...\n", cases[i].label);
+        d->locked_list = cases[i].uses_lookup_list ? lookup_list : NULL;
+        d->hits = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d->hits == (size_t)SKIPLIST_BENCH_COUNT * (iterations + warmup);
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "元素数不一致");
+        suite_add_result(suite, r);
+    }
+
+    skiplist_free(lookup_list);
+    skiplist_lf_free(d->lf_list, NULL);
+    pthread_mutex_destroy(&d->lock);
+    free(d);
+}
+
+// 布隆过滤器基准: 旧版 (逐字节哈希, k 次探测分散在整个位数组) 与分块布局的否定查找对比
+#define BLOOM_BENCH_KEYS (4u << 20)
+#define BLOOM_BENCH_PROBES (1u << 20)
+
+typedef struct {
+    uint64_t *keys;
+    uint64_t *probes;
+    const void **probe_ptrs;
+    size_t *probe_lens;
+    bloom_t *legacy;
+    bloom_t *blocked;
+    size_t hits;
+} bloom_bench_data_t;
+
+// 通过旧格式反序列化构造一个与旧实现同尺寸的过滤器
+static bloom_t* bloom_bench_legacy_create(size_t n, double p) {
+    size_t header[4];
+    header[0] = (size_t)(-(double)n * log(p) / (log(2) * log(2)));
+    header[1] = (size_t)((double)header[0] / (double)n * log(2));
+    header[2] = n;
+    header[3] = 0;
+    size_t size = sizeof(header) + sizeof(double) + (header[0] + 7) / 8;
+    uint8_t *buf = calloc(1, size);
+    if (!buf) return NULL;
+    memcpy(buf, header, sizeof(header));
+    memcpy(buf + sizeof(header), &p, sizeof(double));
+    bloom_t *b = bloom_deserialize(buf, size);
+    free(buf);
+    return b;
+}
+
+static void bench_bloom_legacy_check(void *data) {
+    bloom_bench_data_t *d = data;
+    for (size_t i = 0; i < BLOOM_BENCH_PROBES; i++) d->hits += bloom_check(d->legacy, &d->probes[i], sizeof(uint64_t));
+}
+
+static void bench_bloom_blocked_check(void *data) {
+    bloom_bench_data_t *d = data;
+    for (size_t i = 0; i < BLOOM_BENCH_PROBES; i++) d->hits += bloom_check(d->blocked, &d->probes[i], sizeof(uint64_t));
+}
+
+static void bench_bloom_blocked_check_many(void *data) {
+    bloom_bench_data_t *d = data;
+    d->hits += bloom_check_many(d->blocked, d->probe_ptrs, d->probe_lens, BLOOM_BENCH_PROBES, NULL);
+}
+
+static void bench_bloom_legacy_add(void *data) {
+    bloom_bench_data_t *d = data;
+    for (size_t i = 0; i < BLOOM_BENCH_PROBES; i++) bloom_add(d->legacy, &d->keys[i], sizeof(uint64_t));
+}
+
+static void bench_bloom_blocked_add(void *data) {
+    bloom_bench_data_t *d = data;
+    for (size_t i = 0; i < BLOOM_BENCH_PROBES; i++) bloom_add(d->blocked, &d->keys[i], sizeof(uint64_t));
+}
+
+static void run_bloom_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    bloom_bench_data_t d = { 0 };
+    d.keys = malloc(BLOOM_BENCH_KEYS * sizeof(uint64_t));
+    d.probes = malloc(BLOOM_BENCH_PROBES * sizeof(uint64_t));
+    d.probe_ptrs = malloc(BLOOM_BENCH_PROBES * sizeof(void *));
+    d.probe_lens = malloc(BLOOM_BENCH_PROBES * sizeof(size_t));
+    d.legacy = bloom_bench_legacy_create(BLOOM_BENCH_KEYS, 0.01);
+    d.blocked = bloom_create(BLOOM_BENCH_KEYS, 0.01);
+    if (!d.keys || !d.probes || !d.probe_ptrs || !d.probe_lens || !d.legacy || !d.blocked) goto done;
+
+    for (size_t i = 0; i < BLOOM_BENCH_KEYS; i++) {
+        d.keys[i] = i * 0x9E3779B97F4A7C15ull;
+        bloom_add(d.legacy, &d.keys[i], sizeof(uint64_t));
+        bloom_add(d.blocked, &d.keys[i], sizeof(uint64_t));
+    }
+    // 查找的都是不存在的键, 即 LSM 跳过磁盘读的路径
+    for (size_t i = 0; i < BLOOM_BENCH_PROBES; i++) {
+        d.probes[i] = (i + BLOOM_BENCH_KEYS) * 0x9E3779B97F4A7C15ull;
+        d.probe_ptrs[i] = &d.probes[i];
+        d.probe_lens[i] = sizeof(uint64_t);
+    }
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+        bool negative;
+    } cases[] = {
+        { "布隆否定查找(旧版,1M)", "旧版过滤器否定查找", bench_bloom_legacy_check, true },
+        { "布隆否定查找(分块,1M)", "分块过滤器否定查找", bench_bloom_blocked_check, true },
+        { "布隆批量查找(分块,1M)", "分块过滤器批量查找 (预取)", bench_bloom_blocked_check_many, true },
+        { "布隆插入(旧版,1M)", "旧版过滤器插入", bench_bloom_legacy_add, false },
+        { "布隆插入(分块,1M)", "分块过滤器插入", bench_bloom_blocked_add, false },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[bloom] %s...\n", cases[i].label);
+        d.hits = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        // 假阳性率目标 1%, 超过 2% 视为失败
+        r->passed = !cases[i].negative || d.hits < (size_t)BLOOM_BENCH_PROBES * (iterations + warmup) / 50;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "假阳性率过高");
+        suite_add_result(suite, r);
+    }
+
+done:
+    bloom_free(d.legacy);
+    bloom_free(d.blocked);
+    free(d.probe_lens);
+    free(d.probe_ptrs);
+    free(d.probes);
+    free(d.keys);
+}
+
+// Roaring 基准: 与旧版行程压缩位图对比随机稀疏集合, 以及千万级 ID 集合的构建与集合运算
+#define ROARING_BENCH_SMALL 20000
+#define ROARING_BENCH_LARGE 10000000
+#define ROARING_BENCH_UNIVERSE (1u << 25)
+
+typedef struct {
+    uint32_t *small_ids;
+    uint32_t *large_ids;
+    roaring_t *a;
+    roaring_t *b;
+    uint64_t result;
+} roaring_bench_data_t;
+
+static void bench_bitset_comp_small(void *data) {
+    roaring_bench_data_t *d = data;
+    bitset_compressed_t *bc = bitset_comp_create(16);
+    for (size_t i = 0; bc && i < ROARING_BENCH_SMALL; i++) bitset_comp_set(bc, d->small_ids[i]);
+    for (size_t i = 0; bc && i < ROARING_BENCH_SMALL; i++) d->result += bitset_comp_test(bc, d->small_ids[i]);
+    bitset_comp_free(bc);
+}
+
+static void bench_roaring_small(void *data) {
+    roaring_bench_data_t *d = data;
+    roaring_t *r = roaring_create();
+    for (size_t i = 0; r && i < ROARING_BENCH_SMALL; i++) roaring_add(r, d->small_ids[i]);
+    for (size_t i = 0; r && i < ROARING_BENCH_SMALL; i++) d->result += roaring_contains(r, d->small_ids[i]);
+    roaring_free(r);
+}
+
+static void bench_roaring_build(void *data) {
+    roaring_bench_data_t *d = data;
+    roaring_t *r = roaring_create();
+    if (r && roaring_add_many(r, d->large_ids, ROARING_BENCH_LARGE)) d->result += roaring_cardinality(r);
+    roaring_free(r);
+}
+
+static void bench_roaring_contains(void *data) {
+    roaring_bench_data_t *d = data;
+    for (size_t i = 0; i < ROARING_BENCH_LARGE; i++) d->result += roaring_contains(d->a, d->large_ids[i]);
+}
+
+static void bench_roaring_and(void *data) {
+    roaring_bench_data_t *d = data;
+    roaring_t *r = roaring_and(d->a, d->b);
+    d->result += roaring_cardinality(r);
+    roaring_free(r);
+}
+
+static void bench_roaring_or(void *data) {
+    roaring_bench_data_t *d = data;
+    roaring_t *r = roaring_or(d->a, d->b);
+    d->result += roaring_cardinality(r);
+    roaring_free(r);
+}
+
+static void bench_roaring_and_card(void *data) {
+    roaring_bench_data_t *d = data;
+    d->result += roaring_and_cardinality(d->a, d->b);
+}
+
+static void bench_roaring_select(void *data) {
+    roaring_bench_data_t *d = data;
+    uint64_t card = roaring_cardinality(d->a);
+    for (uint64_t i = 0; i < 100000; i++) {
+        uint32_t v = 0;
+        roaring_select(d->a, (i * 7919) % card, &v);
+        d->result += roaring_rank(d->a, v) > 0;
+    }
+}
+
+static void run_roaring_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    roaring_bench_data_t d = { 0 };
+    d.small_ids = malloc(ROARING_BENCH_SMALL * sizeof(uint32_t));
+    d.large_ids = malloc(ROARING_BENCH_LARGE * sizeof(uint32_t));
+    d.a = roaring_create();
+    d.b = roaring_create();
+    if (!d.small_ids || !d.large_ids || !d.a || !d.b) goto done;
+
+    uint32_t seed = 2463534242u;
+    for (size_t i = 0; i < ROARING_BENCH_SMALL; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        d.small_ids[i] = seed % 100000000u;
+    }
+    for (size_t i = 0; i < ROARING_BENCH_LARGE; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        d.large_ids[i] = seed % ROARING_BENCH_UNIVERSE;
+    }
+    roaring_add_many(d.a, d.large_ids, ROARING_BENCH_LARGE);
+    for (uint32_t v = 0; v < ROARING_BENCH_UNIVERSE; v += 3) roaring_add(d.b, v);
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+    } cases[] = {
+        { "压缩位图随机插入+查找(旧版,20K)", "旧版行程压缩位图, 随机稀疏 ID", bench_bitset_comp_small },
+        { "Roaring随机插入+查找(20K)", "Roaring, 随机稀疏 ID", bench_roaring_small },
+        { "Roaring构建(10M)", "Roaring 批量添加 1000 万个 ID", bench_roaring_build },
+        { "Roaring查找(10M)", "Roaring 查找 1000 万次", bench_roaring_contains },
+        { "Roaring AND", "两个千万级集合求交集", bench_roaring_and },
+        { "Roaring OR", "两个千万级集合求并集", bench_roaring_or },
+        { "Roaring交集基数", "只计算交集大小", bench_roaring_and_card },
+        { "Roaring rank/select(100K)", "随机 select 后 rank", bench_roaring_select },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[roaring] %s...\n", cases[i].label);
+        d.result = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d.result > 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果为空");
+        suite_add_result(suite, r);
+    }
+    printf("[roaring] 1000 万个 ID 占用 %.1f MB, 序列化 %.1f MB\n", roaring_memory_usage(d.a) / 1048576.0,
+           roaring_serialized_size(d.a) / 1048576.0);
+
+done:
+    roaring_free(d.a);
+    roaring_free(d.b);
+    free(d.large_ids);
+    free(d.small_ids);
+}
+
+// 稠密位集基准: 6400 万位 (8MB) 的计数、集合运算、区间操作、逐位查找与排名/选择
+#define BITSET_BENCH_BITS (64u << 20)
+#define BITSET_BENCH_RANGES 100000
+#define BITSET_BENCH_QUERIES 1000000
+
+typedef struct {
+    bitset_t *a;
+    bitset_t *b;
+    uint32_t *starts;
+    uint32_t *lens;
+    size_t result;
+} bitset_bench_data_t;
+
+static void bench_bitset_count(void *data) {
+    bitset_bench_data_t *d = data;
+    for (int i = 0; i < 10; i++) d->result += bitset_count(d->a);
+}
+
+static void bench_bitset_and(void *data) {
+    bitset_bench_data_t *d = data;
+    bitset_t *r = bitset_and(d->a, d->b);
+    d->result += bitset_size(r);
+    bitset_free(r);
+}
+
+static void bench_bitset_xor(void *data) {
+    bitset_bench_data_t *d = data;
+    bitset_t *r = bitset_xor(d->a, d->b);
+    d->result += bitset_size(r);
+    bitset_free(r);
+}
+
+static void bench_bitset_ranges(void *data) {
+    bitset_bench_data_t *d = data;
+    bitset_t *bs = bitset_create(BITSET_BENCH_BITS);
+    for (size_t i = 0; bs && i < BITSET_BENCH_RANGES; i++) {
+        size_t lo = d->starts[i], hi = lo + d->lens[i];
+        if (i % 3 == 0) bitset_clear_range(bs, lo, hi);
+        else if (i % 3 == 1) bitset_flip_range(bs, lo, hi);
+        else bitset_set_range(bs, lo, hi);
+    }
+    d->result += bitset_count_range(bs, 0, BITSET_BENCH_BITS / 2) + 1;
+    bitset_free(bs);
+}
+
+static void bench_bitset_scan(void *data) {
+    bitset_bench_data_t *d = data;
+    for (size_t i = bitset_find_first_set(d->b, 0); i != (size_t)-1; i = bitset_find_first_set(d->b, i + 1)) {
+        d->result++;
+    }
+}
+
+static void bench_bitset_rank_select(void *data) {
+    bitset_bench_data_t *d = data;
+    size_t card = bitset_count(d->a);
+    for (size_t i = 0; i < BITSET_BENCH_QUERIES; i++) {
+        size_t pos = bitset_select(d->a, (i * 7919) % card);
+        d->result += bitset_rank(d->a, pos) > 0;
+    }
+}
+
+static void run_bitset_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    bitset_bench_data_t d = { 0 };
+    d.a = bitset_create(BITSET_BENCH_BITS);
+    d.b = bitset_create(BITSET_BENCH_BITS);
+    d.starts = malloc(BITSET_BENCH_RANGES * sizeof(uint32_t));
+    d.lens = malloc(BITSET_BENCH_RANGES * sizeof(uint32_t));
+    if (!d.a || !d.b || !d.starts || !d.lens) goto done;
+
+    // a: 约一半置位; b: 约 1/1000 置位, 用于逐位查找
+    uint32_t seed = 2463534242u;
+    for (size_t i = 0; i < BITSET_BENCH_BITS; i += 32) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        for (int j = 0; j < 32; j++) {
+            if ((seed >> j) & 1) bitset_set(d.a, i + j);
+        }
+        if (seed % 31 == 0) bitset_set(d.b, i + seed % 32);
+    }
+    for (size_t i = 0; i < BITSET_BENCH_RANGES; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        d.starts[i] = seed % BITSET_BENCH_BITS;
+        d.lens[i] = seed % 5000;
+    }
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+        bool indexed;
+    } cases[] = {
+        { "位集计数(64M位x10)", "整集计数 10 次", bench_bitset_count, false },
+        { "位集AND(64M位)", "两个 6400 万位集合求与", bench_bitset_and, false },
+        { "位集XOR(64M位)", "两个 6400 万位集合求异或", bench_bitset_xor, false },
+        { "位集区间操作(100K)", "随机区间置位/清零/翻转, 平均长度 2500", bench_bitset_ranges, false },
+        { "位集查找下一置位", "逐个遍历稀疏集合的置位", bench_bitset_scan, false },
+        { "位集rank/select(1M)", "建立排名目录后随机 select 再 rank", bench_bitset_rank_select, true },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[bitset] %s...\n", cases[i].label);
+        if (cases[i].indexed) bitset_build_rank_index(d.a);
+        d.result = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d.result > 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果为空");
+        suite_add_result(suite, r);
+    }
+
+done:
+    free(d.lens);
+    free(d.starts);
+    bitset_free(d.b);
+    bitset_free(d.a);
+}
+
+// 小对象分配器基准: 与 glibc malloc 对比单线程/多线程随机分配释放, 以及跨线程释放 (生产者-消费者)
+#define SLAB_BENCH_THREADS 4
+#define SLAB_BENCH_OPS 2000000
+#define SLAB_BENCH_SLOTS 1024
+#define SLAB_BENCH_ROUNDS 200
+#define SLAB_BENCH_HANDOFF 2048
+
+typedef struct {
+    void *(*alloc)(size_t);
+    void (*release)(void *);
+    int threads;
+    size_t result;
+} slab_bench_data_t;
+
+typedef struct {
+    slab_bench_data_t *d;
+    int id;
+    void **handoff[SLAB_BENCH_THREADS];
+    pthread_barrier_t *barrier;
+    size_t result;
+} slab_bench_part_t;
+
+static void* slab_bench_churn_worker(void *arg) {
+    slab_bench_part_t *p = arg;
+    void *slots[SLAB_BENCH_SLOTS] = { 0 };
+    uint32_t seed = 2463534242u + (uint32_t)p->id * 7919u;
+    size_t ops = SLAB_BENCH_OPS / (size_t)p->d->threads;
+    for (size_t i = 0; i < ops; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        size_t s = seed % SLAB_BENCH_SLOTS;
+        if (slots[s]) {
+            p->d->release(slots[s]);
+            slots[s] = NULL;
+        } else {
+            slots[s] = p->d->alloc(16 + (seed >> 16) % 496);
+            if (slots[s]) {
+                *(uint32_t *)slots[s] = seed;
+                p->result++;
+            }
+        }
+    }
+    for (size_t s = 0; s < SLAB_BENCH_SLOTS; s++) p->d->release(slots[s]);
+    return NULL;
+}
+
+// 每轮每个线程分配一批消息大小的对象, 交给下一个线程释放
+static void* slab_bench_handoff_worker(void *arg) {
+    slab_bench_part_t *p = arg;
+    int next = (p->id + 1) % p->d->threads;
+    for (int round = 0; round < SLAB_BENCH_ROUNDS; round++) {
+        void **mine = p->handoff[p->id];
+        for (size_t i = 0; i < SLAB_BENCH_HANDOFF; i++) {
+            mine[i] = p->d->alloc(64 + (i * 37) % 192);
+            if (mine[i]) p->result++;
+        }
+        pthread_barrier_wait(p->barrier);
+        void **theirs = p->handoff[next];
+        for (size_t i = 0; i < SLAB_BENCH_HANDOFF; i++) p->d->release(theirs[i]);
+        pthread_barrier_wait(p->barrier);
+    }
+    return NULL;
+}
+
+static void slab_bench_run(slab_bench_data_t *d, void *(*func)(void *)) {
+    pthread_t threads[SLAB_BENCH_THREADS];
+    slab_bench_part_t parts[SLAB_BENCH_THREADS];
+    void **handoff[SLAB_BENCH_THREADS] = { 0 };
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, (unsigned)d->threads);
+    for (int i = 0; i < d->threads; i++) handoff[i] = malloc(SLAB_BENCH_HANDOFF * sizeof(void *));
+    for (int i = 0; i < d->threads; i++) {
+        parts[i] = (slab_bench_part_t){ .d = d, .id = i, .barrier = &barrier };
+        memcpy(parts[i].handoff, handoff, sizeof(handoff));
+        pthread_create(&threads[i], NULL, func, &parts[i]);
+    }
+    for (int i = 0; i < d->threads; i++) {
+        pthread_join(threads[i], NULL);
+        d->result += parts[i].result;
+    }
+    for (int i = 0; i < d->threads; i++) free(handoff[i]);
+    pthread_barrier_destroy(&barrier);
+}
+
+static void bench_slab_churn(void *data) {
+    slab_bench_run(data, slab_bench_churn_worker);
+}
+
+static void bench_slab_handoff(void *data) {
+    slab_bench_run(data, slab_bench_handoff_worker);
+}
+
+static void run_slab_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+        bool use_slab;
+        int threads;
+    } cases[] = {
+        { "malloc随机分配释放(1线程)", "glibc malloc, 单线程随机分配/释放 16..512 字节", bench_slab_churn, false, 1 },
+        { "slab随机分配释放(1线程)", "slab 分配器, 单线程随机分配/释放", bench_slab_churn, true, 1 },
+        { "malloc随机分配释放(4线程)", "glibc malloc, 4 线程随机分配/释放", bench_slab_churn, false, SLAB_BENCH_THREADS },
+        { "slab随机分配释放(4线程)", "slab 分配器, 4 线程随机分配/释放", bench_slab_churn, true, SLAB_BENCH_THREADS },
+        { "malloc跨线程释放(4线程)", "glibc malloc, 对象交给下一个线程释放", bench_slab_handoff, false, SLAB_BENCH_THREADS },
+        { "slab跨线程释放(4线程)", "slab 分配器, 对象交给下一个线程释放", bench_slab_handoff, true, SLAB_BENCH_THREADS },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[slab] %s...\n", cases[i].label);
+        slab_bench_data_t d = { cases[i].use_slab ? slab_alloc : malloc, cases[i].use_slab ? slab_free : free,
+                                cases[i].threads, 0 };
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d.result > 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果为空");
+        suite_add_result(suite, r);
+    }
+
+    slab_stats_t stats;
+    slab_get_stats(&stats);
+    printf("[slab] span 占用 %.1f MB\n", stats.span_bytes / 1048576.0);
+}
+
+/* ---------- Dijkstra 最短路 ---------- */
+
+#define DIJKSTRA_BENCH_SIDE 1000             // 1000x1000 网格, 百万节点
+#define DIJKSTRA_BENCH_QUERIES 16
+#define DIJKSTRA_BENCH_M2M 16
+
+typedef struct {
+    dijkstra_graph_t *list;
+    graph_csr_t *csr;
+    threadpool_t *pool;
+    int *dist;
+    int *pred;
+    int *out;
+    int sources[DIJKSTRA_BENCH_M2M];
+    int targets[DIJKSTRA_BENCH_M2M];
+    long long result;
+} dijkstra_bench_data_t;
+
+// 四邻接网格, 边权 1..100, 近似道路网的稀疏度
+static bool dijkstra_bench_build(dijkstra_bench_data_t *d) {
+    int side = DIJKSTRA_BENCH_SIDE;
+    size_t nodes = (size_t)side * side;
+    d->list = dijkstra_graph_create(nodes, NULL);
+    graph_csr_builder_t *b = graph_csr_builder_create(nodes);
+    if (!d->list || !b) {
+        graph_csr_builder_free(b);
+        return false;
+    }
+    uint32_t seed = 88172645u;
+    for (int y = 0; y < side; y++) {
+        for (int x = 0; x < side; x++) {
+            int u = y * side + x;
+            int nb[4] = { x > 0 ? u - 1 : -1, x + 1 < side ? u + 1 : -1,
+                          y > 0 ? u - side : -1, y + 1 < side ? u + side : -1 };
+            for (int k = 0; k < 4; k++) {
+                if (nb[k] < 0) continue;
+                seed ^= seed << 13;
+                seed ^= seed >> 17;
+                seed ^= seed << 5;
+                int w = 1 + (int)(seed % 100);
+                dijkstra_graph_add_edge(d->list, u, nb[k], w, NULL);
+                graph_csr_builder_add_edge(b, u, nb[k], w);
+            }
+        }
+    }
+    d->csr = graph_csr_builder_build(b);
+    graph_csr_builder_free(b);
+    d->dist = malloc(nodes * sizeof(int));
+    d->pred = malloc(nodes * sizeof(int));
+    d->out = malloc(DIJKSTRA_BENCH_M2M * DIJKSTRA_BENCH_M2M * sizeof(int));
+    for (int i = 0; i < DIJKSTRA_BENCH_M2M; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        d->sources[i] = (int)(seed % nodes);
+        d->targets[i] = (int)((seed >> 7) % nodes);
+    }
+    return d->csr && d->dist && d->pred && d->out;
+}
+
+static void bench_dijkstra_list(void *data) {
+    dijkstra_bench_data_t *d = data;
+    if (dijkstra(d->list, 0, d->dist, d->pred, NULL)) d->result += d->dist[DIJKSTRA_BENCH_SIDE * DIJKSTRA_BENCH_SIDE - 1];
+}
+
+static void bench_dijkstra_csr(void *data) {
+    dijkstra_bench_data_t *d = data;
+    if (dijkstra_csr(d->csr, 0, -1, d->dist, d->pred, NULL)) d->result += d->dist[DIJKSTRA_BENCH_SIDE * DIJKSTRA_BENCH_SIDE - 1];
+}
+
+// 点到点查询, 目标出堆即结束
+static void bench_dijkstra_p2p(void *data) {
+    dijkstra_bench_data_t *d = data;
+    for (int i = 0; i < DIJKSTRA_BENCH_QUERIES; i++) {
+        int t = d->targets[i];
+        if (dijkstra_csr(d->csr, d->sources[i], t, d->dist, NULL, NULL)) d->result += d->dist[t];
+    }
+}
+
+static void bench_dijkstra_m2m_serial(void *data) {
+    dijkstra_bench_data_t *d = data;
+    for (int i = 0; i < DIJKSTRA_BENCH_M2M; i++) {
+        if (!dijkstra_csr(d->csr, d->sources[i], -1, d->dist, NULL, NULL)) continue;
+        for (int j = 0; j < DIJKSTRA_BENCH_M2M; j++) d->result += d->dist[d->targets[j]];
+    }
+}
+
+static void bench_dijkstra_m2m(void *data) {
+    dijkstra_bench_data_t *d = data;
+    if (!dijkstra_many_to_many(d->csr, d->sources, DIJKSTRA_BENCH_M2M, d->targets, DIJKSTRA_BENCH_M2M,
+                               d->out, d->pool, NULL)) return;
+    for (int i = 0; i < DIJKSTRA_BENCH_M2M * DIJKSTRA_BENCH_M2M; i++) d->result += d->out[i];
+}
+
+static void run_dijkstra_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    dijkstra_bench_data_t d = { 0 };
+    printf("[dijkstra] 构建 %dx%d 网格图...\n", DIJKSTRA_BENCH_SIDE, DIJKSTRA_BENCH_SIDE);
+    if (!dijkstra_bench_build(&d)) {
+        printf("[dijkstra] 构建失败\n");
+        goto cleanup;
+    }
+    d.pool = threadpool_create(0);
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+    } cases[] = {
+        { "邻接表单源全图", "dijkstra(): 邻接表转换为 CSR 后求全部节点", bench_dijkstra_list },
+        { "CSR单源全图", "dijkstra_csr: 索引四叉堆求全部节点", bench_dijkstra_csr },
+        { "CSR点到点x16", "dijkstra_csr: 16 个随机点对, 目标出堆即结束", bench_dijkstra_p2p },
+        { "多对多串行16x16", "逐个源点全图搜索后取 16 个目标", bench_dijkstra_m2m_serial },
+        { "多对多线程池16x16", "dijkstra_many_to_many: 线程池并行, 目标全部出堆即结束", bench_dijkstra_m2m },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[dijkstra] %s...\n", cases[i].label);
+        d.result = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d.result > 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果为空");
+        suite_add_result(suite, r);
+    }
+
+cleanup:
+    if (d.pool) threadpool_destroy(d.pool);
+    dijkstra_graph_free(d.list);
+    graph_csr_free(d.csr);
+    free(d.dist);
+    free(d.pred);
+    free(d.out);
+}
+
+// 图算法: 随机无向图 (环 + 随机边), 比较同一 CSR 上的串行与并行实现
+#define GRAPH_BENCH_NODES 500000
+#define GRAPH_BENCH_EDGES 2000000
+
+typedef struct {
+    graph_csr_t *csr;
+    threadpool_t *pool;
+    int *dist;
+    int *pred;
+    long long result;
+} graph_bench_data_t;
+
+static bool graph_bench_build(graph_bench_data_t *d) {
+    graph_csr_builder_t *b = graph_csr_builder_create(GRAPH_BENCH_NODES);
+    if (!b) return false;
+    uint32_t seed = 2024;
+    bool ok = true;
+    for (int i = 0; ok && i < GRAPH_BENCH_EDGES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int u = i < GRAPH_BENCH_NODES ? i : (int)((seed >> 4) % GRAPH_BENCH_NODES);
+        seed = seed * 1103515245u + 12345u;
+        int v = i < GRAPH_BENCH_NODES ? (i + 1) % GRAPH_BENCH_NODES : (int)((seed >> 4) % GRAPH_BENCH_NODES);
+        int w = 1 + (int)((seed >> 16) % 1000);
+        ok = graph_csr_builder_add_edge(b, u, v, w) && graph_csr_builder_add_edge(b, v, u, w);
+    }
+    d->csr = ok ? graph_csr_builder_build(b) : NULL;
+    graph_csr_builder_free(b);
+    d->dist = malloc(GRAPH_BENCH_NODES * sizeof(int));
+    d->pred = malloc(GRAPH_BENCH_NODES * sizeof(int));
+    return d->csr && d->dist && d->pred;
+}
+
+static void bench_graph_bfs_top_down(void *data) {
+    graph_bench_data_t *d = data;
+    d->result += (long long)graph_csr_bfs(d->csr, NULL, 0, d->pred, d->dist, d->pool);
+}
+
+static void bench_graph_bfs(void *data) {
+    graph_bench_data_t *d = data;
+    d->result += (long long)graph_csr_bfs(d->csr, d->csr, 0, d->pred, d->dist, d->pool);
+}
+
+static void bench_graph_dijkstra(void *data) {
+    graph_bench_data_t *d = data;
+    if (dijkstra_csr(d->csr, 0, -1, d->dist, d->pred, NULL)) d->result += d->dist[GRAPH_BENCH_NODES / 2];
+}
+
+static void bench_graph_delta_stepping(void *data) {
+    graph_bench_data_t *d = data;
+    if (dijkstra_delta_stepping(d->csr, 0, 0, d->dist, d->pred, d->pool, NULL)) d->result += d->dist[GRAPH_BENCH_NODES / 2];
+}
+
+static void bench_graph_bellman_ford(void *data) {
+    graph_bench_data_t *d = data;
+    if (!bellman_ford_csr(d->csr, 0, d->dist, d->pred, d->pool)) d->result += d->dist[GRAPH_BENCH_NODES / 2];
+}
+
+static void bench_graph_kruskal(void *data) {
+    graph_bench_data_t *d = data;
+    kruskal_result_t *r = kruskal_mst_csr(d->csr, NULL);
+    if (r) d->result += r->total_weight;
+    kruskal_free_result(r);
+}
+
+static void bench_graph_boruvka(void *data) {
+    graph_bench_data_t *d = data;
+    kruskal_result_t *r = kruskal_boruvka_csr(d->csr, d->pool, NULL);
+    if (r) d->result += r->total_weight;
+    kruskal_free_result(r);
+}
+
+static void run_graph_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    graph_bench_data_t d = { 0 };
+    printf("[graph] 构建 %d 节点 / %d 条无向边的随机图...\n", GRAPH_BENCH_NODES, GRAPH_BENCH_EDGES);
+    if (!graph_bench_build(&d)) {
+        printf("[graph] 构建失败\n");
+        goto cleanup;
+    }
+    d.pool = threadpool_create(0);
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+    } cases[] = {
+        { "BFS自顶向下", "graph_csr_bfs: 不传入边图, 每层只扩展出边", bench_graph_bfs_top_down },
+        { "BFS方向优化", "graph_csr_bfs: 前沿较大时自底向上", bench_graph_bfs },
+        { "Dijkstra四叉堆", "dijkstra_csr: 串行单源全图", bench_graph_dijkstra },
+        { "Delta-stepping", "dijkstra_delta_stepping: 线程池并行按桶松弛", bench_graph_delta_stepping },
+        { "Bellman-Ford前沿", "bellman_ford_csr: 线程池并行, 只松弛上一轮改进的节点", bench_graph_bellman_ford },
+        { "Kruskal排序", "kruskal_mst_csr: 排序后并查集", bench_graph_kruskal },
+        { "Boruvka并行", "kruskal_boruvka_csr: 线程池并行选最小出边", bench_graph_boruvka },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[graph] %s...\n", cases[i].label);
+        d.result = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d.result > 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果为空");
+        suite_add_result(suite, r);
+    }
+
+cleanup:
+    if (d.pool) threadpool_destroy(d.pool);
+    graph_csr_free(d.csr);
+    free(d.dist);
+    free(d.pred);
+}
+
+// 全源最短路径: 随机稠密图上比较原始三重循环与分块实现; Prim: 稀疏图上邻接表堆实现
+#define FLOYD_BENCH_NODES 1024
+#define PRIM_BENCH_NODES 200000
+
+typedef struct {
+    int **adj;
+    int **work;
+    threadpool_t *pool;
+    prim_graph_t *prim;
+    long long result;
+} floyd_bench_data_t;
+
+static bool floyd_bench_build(floyd_bench_data_t *d) {
+    size_t n = FLOYD_BENCH_NODES;
+    d->adj = calloc(n, sizeof(int*));
+    d->work = calloc(n, sizeof(int*));
+    if (!d->adj || !d->work) return false;
+    uint32_t seed = 42;
+    for (size_t i = 0; i < n; i++) {
+        d->adj[i] = malloc(n * sizeof(int));
+        d->work[i] = malloc(n * sizeof(int));
+        if (!d->adj[i] || !d->work[i]) return false;
+        for (size_t j = 0; j < n; j++) {
+            seed = seed * 1103515245u + 12345u;
+            d->adj[i][j] = i == j ? 0 : (seed >> 8) % 100 < 10 ? 1 + (int)((seed >> 4) % 1000) : FLOYD_INF;
+        }
+    }
+
+    d->prim = prim_graph_create(PRIM_BENCH_NODES, NULL, NULL);
+    if (!d->prim) return false;
+    for (int i = 1; i < PRIM_BENCH_NODES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        prim_graph_add_edge(d->prim, i, (int)((seed >> 8) % (uint32_t)i), 1 + (int)((seed >> 4) % 1000), NULL);
+        seed = seed * 1103515245u + 12345u;
+        prim_graph_add_edge(d->prim, i, (int)((seed >> 8) % PRIM_BENCH_NODES), 1 + (int)((seed >> 4) % 1000), NULL);
+    }
+    return true;
+}
+
+// 改造前的实现: 逐个 k 扫描整个矩阵
+static void bench_floyd_naive(void *data) {
+    floyd_bench_data_t *d = data;
+    size_t n = FLOYD_BENCH_NODES;
+    for (size_t i = 0; i < n; i++) memcpy(d->work[i], d->adj[i], n * sizeof(int));
+    for (size_t k = 0; k < n; k++) {
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                if (d->work[i][k] != FLOYD_INF && d->work[k][j] != FLOYD_INF &&
+                    d->work[i][k] + d->work[k][j] < d->work[i][j]) {
+                    d->work[i][j] = d->work[i][k] + d->work[k][j];
+                }
+            }
+        }
+    }
+    d->result += d->work[n - 1][0];
+}
+
+static void floyd_bench_run(floyd_bench_data_t *d, threadpool_t *pool) {
+    floyd_result_t result;
+    if (floyd_warshall_parallel(FLOYD_BENCH_NODES, (const int **)d->adj, &result, pool, NULL)) {
+        d->result += result.dist[FLOYD_BENCH_NODES - 1][0];
+        floyd_warshall_free(&result);
+    }
+}
+
+static void bench_floyd_blocked(void *data) {
+    floyd_bench_run(data, NULL);
+}
+
+static void bench_floyd_parallel(void *data) {
+    floyd_bench_data_t *d = data;
+    floyd_bench_run(d, d->pool);
+}
+
+static void bench_prim_list(void *data) {
+    floyd_bench_data_t *d = data;
+    d->result += prim_mst(d->prim, NULL);
+}
+
+static void run_floyd_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    floyd_bench_data_t d = { 0 };
+    printf("[floyd] 构建 %d 节点稠密图与 %d 节点稀疏图...\n", FLOYD_BENCH_NODES, PRIM_BENCH_NODES);
+    if (!floyd_bench_build(&d)) {
+        printf("[floyd] 构建失败\n");
+        goto cleanup;
+    }
+    d.pool = threadpool_create(0);
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+    } cases[] = {
+        { "Floyd三重循环", "改造前的三重循环 (只算距离, 不维护后继矩阵)", bench_floyd_naive },
+        { "Floyd分块", "floyd_warshall: 64x64 分块, AVX2 行松弛", bench_floyd_blocked },
+        { "Floyd分块线程池", "floyd_warshall_parallel: 分块阶段在线程池上并行", bench_floyd_parallel },
+        { "Prim邻接表堆", "prim_mst: 邻接表 + 索引四叉堆", bench_prim_list },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[floyd] %s...\n", cases[i].label);
+        d.result = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d.result > 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果为空");
+        suite_add_result(suite, r);
+    }
+
+cleanup:
+    if (d.pool) threadpool_destroy(d.pool);
+    for (size_t i = 0; d.adj && i < FLOYD_BENCH_NODES; i++) free(d.adj[i]);
+    for (size_t i = 0; d.work && i < FLOYD_BENCH_NODES; i++) free(d.work[i]);
+    free(d.adj);
+    free(d.work);
+    prim_graph_destroy(d.prim);
+}
+
+// 网格寻路: 随机矩形障碍的网格上, 比较回调版 A*、网格 A* 与 JPS
+#define ASTAR_BENCH_SIZE 512
+#define ASTAR_BENCH_QUERIES 4
+
+typedef struct {
+    astar_grid_t *grid;
+    astar_result_t result;
+    point_t starts[ASTAR_BENCH_QUERIES];
+    point_t goals[ASTAR_BENCH_QUERIES];
+    long long result_sum;
+} astar_bench_data_t;
+
+static bool astar_bench_walkable(void *world, point_t pos) {
+    return astar_grid_is_walkable(world, pos.x, pos.y);
+}
+
+static bool astar_bench_build(astar_bench_data_t *d) {
+    int n = ASTAR_BENCH_SIZE;
+    d->grid = astar_grid_create(n, n, ASTAR_GRID_8);
+    if (!d->grid) return false;
+    // 随机摆放 3..18 格见方的矩形障碍, 约占三分之一面积
+    uint32_t seed = 7;
+    for (int b = 0; b < n * n / 600; b++) {
+        seed = seed * 1103515245u + 12345u;
+        int x0 = (int)((seed >> 8) % (uint32_t)n);
+        int w = 3 + (int)((seed >> 4) % 16);
+        seed = seed * 1103515245u + 12345u;
+        int y0 = (int)((seed >> 8) % (uint32_t)n);
+        int h = 3 + (int)((seed >> 4) % 16);
+        for (int y = y0; y < y0 + h && y < n; y++) {
+            for (int x = x0; x < x0 + w && x < n; x++) astar_grid_set_cost(d->grid, x, y, 0);
+        }
+    }
+    // 起点在左侧, 终点在右侧, 周围清出空地
+    for (int q = 0; q < ASTAR_BENCH_QUERIES; q++) {
+        d->starts[q] = (point_t){ 4 + q * 7 % (n / 16), 4 + q * 97 % (n - 8) };
+        d->goals[q] = (point_t){ n - 5 - q * 11 % (n / 16), 4 + (q * 389 + n / 2) % (n - 8) };
+        for (int dy = -4; dy <= 4; dy++) {
+            for (int dx = -4; dx <= 4; dx++) {
+                astar_grid_set_cost(d->grid, d->starts[q].x + dx, d->starts[q].y + dy, 1);
+                astar_grid_set_cost(d->grid, d->goals[q].x + dx, d->goals[q].y + dy, 1);
+            }
+        }
+    }
+    return true;
+}
+
+// 改造前的实现: 回调判断可通行, 哈希表逐个 malloc 节点
+static void bench_astar_callback(void *data) {
+    astar_bench_data_t *d = data;
+    for (int q = 0; q < ASTAR_BENCH_QUERIES; q++) {
+        astar_result_t r = astar_search(d->grid, d->starts[q], d->goals[q], astar_bench_walkable,
+                                        NULL, ASTAR_DIAGONAL, ASTAR_BENCH_SIZE * ASTAR_BENCH_SIZE);
+        if (r.found) d->result_sum += r.cost;
+        free(r.path);
+    }
+}
+
+static void astar_bench_grid(astar_bench_data_t *d, astar_grid_mode_t mode) {
+    for (int q = 0; q < ASTAR_BENCH_QUERIES; q++) {
+        if (astar_grid_search(d->grid, d->starts[q], d->goals[q], mode, &d->result)) {
+            d->result_sum += d->result.cost;
+        }
+    }
+}
+
+static void bench_astar_grid(void *data) {
+    astar_bench_grid(data, ASTAR_GRID_ASTAR);
+}
+
+static void bench_astar_jps(void *data) {
+    astar_bench_grid(data, ASTAR_GRID_JPS);
+}
+
+static void run_astar_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    astar_bench_data_t d = { 0 };
+    printf("[astar] 构建 %dx%d 网格, %d 次查询...\n", ASTAR_BENCH_SIZE, ASTAR_BENCH_SIZE, ASTAR_BENCH_QUERIES);
+    if (!astar_bench_build(&d)) {
+        printf("[astar] 构建失败\n");
+        goto cleanup;
+    }
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+    } cases[] = {
+        { "A*回调版", "astar_search: 回调判断可通行, 节点逐个分配", bench_astar_callback },
+        { "A*网格", "astar_grid_search: 预分配数组, 位图关闭集, 索引四叉堆", bench_astar_grid },
+        { "A*网格JPS", "astar_grid_search: 跳点搜索", bench_astar_jps },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[astar] %s...\n", cases[i].label);
+        d.result_sum = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d.result_sum > 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果为空");
+        suite_add_result(suite, r);
+    }
+
+cleanup:
+    free(d.result.path);
+    astar_grid_free(d.grid);
+}
+
+// FFT: 2^10 .. 2^22 点, 每次迭代把 FFT_BENCH_POINTS 个点按长度切成若干段, 每段变换一次
+#define FFT_BENCH_POINTS ((size_t)1 << 22)
+#define FFT_BENCH_BATCH_LOG2 14
+
+typedef struct {
+    size_t n;
+    double _Complex *data;
+    double *real;
+    double _Complex *spectrum;
+    fft_plan_t *plan;
+    fft_ctx_t *ctx;
+    double _Complex **arrays;
+    size_t *sizes;
+    size_t batch_count;
+    long long result;
+} fft_bench_data_t;
+
+// 改造前的实现: 递归, 每层 malloc 奇偶两半, 每个蝶形调用 cos/sin
+static void fft_bench_recursive(double *a, size_t n) {
+    if (n <= 1) return;
+    size_t h = n / 2;
+    double *even = malloc(h * 2 * sizeof(double));
+    double *odd = malloc(h * 2 * sizeof(double));
+    for (size_t i = 0; i < h; i++) {
+        even[2 * i] = a[4 * i];
+        even[2 * i + 1] = a[4 * i + 1];
+        odd[2 * i] = a[4 * i + 2];
+        odd[2 * i + 1] = a[4 * i + 3];
+    }
+    fft_bench_recursive(even, h);
+    fft_bench_recursive(odd, h);
+    for (size_t k = 0; k < h; k++) {
+        double angle = -2.0 * M_PI * (double)k / (double)n;
+        double wr = cos(angle), wi = sin(angle);
+        double tr = wr * odd[2 * k] - wi * odd[2 * k + 1];
+        double ti = wr * odd[2 * k + 1] + wi * odd[2 * k];
+        a[2 * k] = even[2 * k] + tr;
+        a[2 * k + 1] = even[2 * k + 1] + ti;
+        a[2 * (k + h)] = even[2 * k] - tr;
+        a[2 * (k + h) + 1] = even[2 * k + 1] - ti;
+    }
+    free(even);
+    free(odd);
+}
+
+static void bench_fft_recursive(void *data) {
+    fft_bench_data_t *d = data;
+    for (size_t done = 0; done < FFT_BENCH_POINTS; done += d->n) {
+        fft_bench_recursive((double *)(d->data + done), d->n);
+        d->result += 1;
+    }
+}
+
+static void bench_fft_plan(void *data) {
+    fft_bench_data_t *d = data;
+    for (size_t done = 0; done < FFT_BENCH_POINTS; done += d->n) {
+        fft_plan_forward(d->plan, d->data + done);
+        d->result += 1;
+    }
+}
+
+static void bench_fft_real(void *data) {
+    fft_bench_data_t *d = data;
+    for (size_t done = 0; done < FFT_BENCH_POINTS; done += d->n) {
+        fft_plan_real_forward(d->plan, d->real + done, d->spectrum);
+        d->result += 1;
+    }
+}
+
+static void bench_fft_batch(void *data) {
+    fft_bench_data_t *d = data;
+    if (fft_compute_batch(d->ctx, d->arrays, d->sizes, d->batch_count) == FFT_OK) {
+        d->result += (long long)d->batch_count;
+    }
+}
+
+static void run_fft_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    fft_bench_data_t d = { 0 };
+    char name[64];
+    d.data = malloc(FFT_BENCH_POINTS * sizeof(double _Complex));
+    d.real = malloc(FFT_BENCH_POINTS * sizeof(double));
+    d.spectrum = malloc((FFT_BENCH_POINTS / 2 + 1) * sizeof(double _Complex));
+    if (!d.data || !d.real || !d.spectrum) {
+        printf("[fft] 内存不足\n");
+        goto cleanup;
+    }
+    uint32_t seed = 1;
+    for (size_t i = 0; i < FFT_BENCH_POINTS; i++) {
+        seed = seed * 1103515245u + 12345u;
+        d.real[i] = (double)(seed >> 8) / (double)(1u << 24) - 0.5;
+    }
+
+    for (int log2n = 10; log2n <= 22; log2n += 4) {
+        d.n = (size_t)1 << log2n;
+        d.plan = fft_plan_create(d.n);
+        if (!d.plan) continue;
+
+        struct {
+            const char *tag;
+            const char *label;
+            void (*func)(void *);
+        } cases[] = {
+            { "递归", "改造前的递归实现 (每层分配, 逐个计算 cos/sin)", bench_fft_recursive },
+            { "计划", "fft_plan_forward: 预计算旋转因子, 迭代基 4, AVX2 蝶形", bench_fft_plan },
+            { "实数", "fft_plan_real_forward: 半长复数 FFT + 拆分", bench_fft_real },
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            printf("[fft] 2^%d 点 %s...\n", log2n, cases[i].label);
+            for (size_t k = 0; k < FFT_BENCH_POINTS; k++) d.data[k] = d.real[k];
+            d.result = 0;
+            snprintf(name, sizeof(name), "FFT 2^%d %s", log2n, cases[i].tag);
+            benchmark_result_t *r = run_benchmark(name, cases[i].func, &d, iterations, warmup);
+            if (!r) continue;
+            r->passed = d.result > 0;
+            if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果异常");
+            suite_add_result(suite, r);
+        }
+        fft_plan_destroy(d.plan);
+        d.plan = NULL;
+    }
+
+    // 批量: 2^22 个点分成 2^8 个 2^14 点数组, 在线程池上并行
+    d.batch_count = FFT_BENCH_POINTS >> FFT_BENCH_BATCH_LOG2;
+    d.arrays = calloc(d.batch_count, sizeof(double _Complex *));
+    d.sizes = calloc(d.batch_count, sizeof(size_t));
+    fft_config_t config = { .use_optimized = true, .check_size = true, .use_cached_windows = true,
+                            .max_batch_size = d.batch_count, .pool = threadpool_create(0) };
+    if (d.arrays && d.sizes && fft_create(&d.ctx, &config) == FFT_OK) {
+        for (size_t i = 0; i < d.batch_count; i++) {
+            d.arrays[i] = d.data + (i << FFT_BENCH_BATCH_LOG2);
+            d.sizes[i] = (size_t)1 << FFT_BENCH_BATCH_LOG2;
+        }
+        for (size_t k = 0; k < FFT_BENCH_POINTS; k++) d.data[k] = d.real[k];
+        printf("[fft] fft_compute_batch: %zu 个 2^%d 点数组...\n", d.batch_count, FFT_BENCH_BATCH_LOG2);
+        d.result = 0;
+        benchmark_result_t *r = run_benchmark("FFT 批量线程池", bench_fft_batch, &d, iterations, warmup);
+        if (r) {
+            r->passed = d.result > 0;
+            if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果异常");
+            suite_add_result(suite, r);
+        }
+    }
+    fft_destroy(d.ctx);
+    if (config.pool) threadpool_destroy(config.pool);
+
+cleanup:
+    free(d.arrays);
+    free(d.sizes);
+    free(d.data);
+    free(d.real);
+    free(d.spectrum);
+}
+
+// 大整数: 1000 .. 100000 位十进制数的乘法、除法和十进制转换, 以及 2048 位模幂
+typedef struct {
+    size_t digits;
+    char *a_str;
+    char *b_str;
+    bigint_t *a;
+    bigint_t *b;
+    bigint_t *prod;
+    long long result;
+} bigint_bench_data_t;
+
+// 改造前的实现: 每个 uint32_t 存一位十进制数, schoolbook 乘法逐位 % 10 和 / 10
+static void bench_bigint_decimal(void *data) {
+    bigint_bench_data_t *d = data;
+    size_t n = d->digits;
+    uint32_t *x = malloc(n * sizeof(uint32_t));
+    uint32_t *y = malloc(n * sizeof(uint32_t));
+    uint32_t *z = calloc(2 * n, sizeof(uint32_t));
+    if (!x || !y || !z) goto done;
+    for (size_t i = 0; i < n; i++) {
+        x[i] = (uint32_t)(d->a_str[n - 1 - i] - '0');
+        y[i] = (uint32_t)(d->b_str[n - 1 - i] - '0');
+    }
+    for (size_t i = 0; i < n; i++) {
+        uint32_t carry = 0;
+        for (size_t j = 0; j < n || carry; j++) {
+            uint64_t val = z[i + j] + (uint64_t)x[i] * (j < n ? y[j] : 0) + carry;
+            z[i + j] = (uint32_t)(val % 10);
+            carry = (uint32_t)(val / 10);
+        }
+    }
+    d->result += z[2 * n - 1] + z[2 * n - 2] + 1;
+done:
+    free(x);
+    free(y);
+    free(z);
+}
+
+static void bench_bigint_mul(void *data) {
+    bigint_bench_data_t *d = data;
+    bigint_t *p = bigint_mul(d->a, d->b);
+    if (p && bigint_compare(p, d->prod) == 0) d->result++;
+    bigint_free(p);
+}
+
+static void bench_bigint_div(void *data) {
+    bigint_bench_data_t *d = data;
+    bigint_t *q, *r;
+    if (bigint_divmod(d->prod, d->b, &q, &r)) {
+        if (bigint_compare(q, d->a) == 0 && bigint_is_zero(r)) d->result++;
+        bigint_free(q);
+        bigint_free(r);
+    }
+}
+
+static void bench_bigint_str(void *data) {
+    bigint_bench_data_t *d = data;
+    char *str = bigint_to_str(d->a);
+    bigint_t *back = str ? bigint_from_str(str) : NULL;
+    if (back && bigint_compare(back, d->a) == 0) d->result++;
+    bigint_free(back);
+    free(str);
+}
+
+// 2048 位奇数模数和指数, 每次迭代 8 次模幂
+static void bench_bigint_powmod(void *data) {
+    bigint_bench_data_t *d = data;
+    for (int i = 0; i < 8; i++) {
+        bigint_t *r = bigint_powmod(d->a, d->b, d->prod);
+        if (r && !bigint_is_zero(r)) d->result++;
+        bigint_free(r);
+    }
+}
+
+static char* bigint_bench_digits(size_t n, uint32_t *seed) {
+    char *s = malloc(n + 1);
+    if (!s) return NULL;
+    for (size_t i = 0; i < n; i++) {
+        *seed = *seed * 1103515245u + 12345u;
+        s[i] = (char)('0' + (*seed >> 16) % 10);
     }
-    result->samples[result->sample_count++] = sample;
+    s[0] = (char)('1' + s[0] % 9);
+    s[n] = '\0';
+    return s;
 }
 
-static int compare_doubles(const void *a, const void *b) {
-    double da = *(const double*)a;
-    double db = *(const double*)b;
-    return (da > db) - (da < db);
+static void bigint_bench_reset(bigint_bench_data_t *d) {
+    free(d->a_str);
+    free(d->b_str);
+    bigint_free(d->a);
+    bigint_free(d->b);
+    bigint_free(d->prod);
+    d->a_str = d->b_str = NULL;
+    d->a = d->b = d->prod = NULL;
 }
 
-static void result_compute_stats(benchmark_result_t *result) {
-    if (result->sample_count == 0) return;
-    
-    qsort(result->samples, result->sample_count, sizeof(double), compare_doubles);
-    
-    double sum = 0;
-    result->min = result->samples[0];
-    result->max = result->samples[result->sample_count - 1];
-    
-    for (size_t i = 0; i < result->sample_count; i++) {
-        sum += result->samples[i];
+static void run_bigint_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    bigint_bench_data_t d = { 0 };
+    char name[64];
+    uint32_t seed = 1;
+    size_t sizes[] = { 1000, 10000, 100000 };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        d.digits = sizes[s];
+        d.a_str = bigint_bench_digits(d.digits, &seed);
+        d.b_str = bigint_bench_digits(d.digits, &seed);
+        d.a = d.a_str ? bigint_from_str(d.a_str) : NULL;
+        d.b = d.b_str ? bigint_from_str(d.b_str) : NULL;
+        d.prod = bigint_mul(d.a, d.b);
+        if (!d.prod) {
+            printf("[bigint] 内存不足\n");
+            bigint_bench_reset(&d);
+            continue;
+        }
+
+        struct {
+            const char *tag;
+            const char *label;
+            void (*func)(void *);
+        } cases[] = {
+            { "十进制", "改造前的逐位十进制 schoolbook 乘法", bench_bigint_decimal },
+            { "乘法", "bigint_mul: 64 位 limb, Karatsuba/Toom-3/NTT", bench_bigint_mul },
+            { "除法", "bigint_divmod: 2n 位除以 n 位", bench_bigint_div },
+            { "转换", "bigint_to_str + bigint_from_str 分治转换", bench_bigint_str },
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            // 旧实现是 O(n^2) 且每步做除法, 10 万位需要数十秒, 只测较小规模
+            if (cases[i].func == bench_bigint_decimal && d.digits > 10000) continue;
+            printf("[bigint] %zu 位 %s...\n", d.digits, cases[i].label);
+            d.result = 0;
+            snprintf(name, sizeof(name), "大整数 %zu 位 %s", d.digits, cases[i].tag);
+            benchmark_result_t *r = run_benchmark(name, cases[i].func, &d, iterations, warmup);
+            if (!r) continue;
+            r->passed = d.result > 0;
+            if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果异常");
+            suite_add_result(suite, r);
+        }
+        bigint_bench_reset(&d);
     }
-    
-    result->mean = sum / result->sample_count;
-    
-    double sq_sum = 0;
-    for (size_t i = 0; i < result->sample_count; i++) {
-        double diff = result->samples[i] - result->mean;
-        sq_sum += diff * diff;
+
+    // 模幂: 底数、指数、模数均为 617 位十进制数 (约 2048 位), 模数取奇数走 Montgomery
+    d.a_str = bigint_bench_digits(617, &seed);
+    d.b_str = bigint_bench_digits(617, &seed);
+    char *m_str = bigint_bench_digits(617, &seed);
+    if (m_str) m_str[616] = '7';
+    d.a = d.a_str ? bigint_from_str(d.a_str) : NULL;
+    d.b = d.b_str ? bigint_from_str(d.b_str) : NULL;
+    d.prod = m_str ? bigint_from_str(m_str) : NULL;
+    free(m_str);
+    if (d.a && d.b && d.prod) {
+        printf("[bigint] 2048 位模幂...\n");
+        d.result = 0;
+        benchmark_result_t *r = run_benchmark("大整数 2048 位模幂 x8", bench_bigint_powmod, &d, iterations, warmup);
+        if (r) {
+            r->passed = d.result > 0;
+            if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果异常");
+            suite_add_result(suite, r);
+        }
     }
-    
-    result->variance = sq_sum / result->sample_count;
-    result->stddev = sqrt(result->variance);
-    
-    result->median = result->samples[result->sample_count / 2];
-    
-    result->p50 = result->median;
-    result->p75 = result->samples[(size_t)(result->sample_count * 0.75)];
-    result->p90 = result->samples[(size_t)(result->sample_count * 0.90)];
-    result->p95 = result->samples[(size_t)(result->sample_count * 0.95)];
-    result->p99 = result->samples[(size_t)(result->sample_count * 0.99)];
-    
-    if (result->total_time_ms > 0) {
-        result->ops_per_second = (double)result->total_iterations / (result->total_time_ms / 1000.0);
+    bigint_bench_reset(&d);
+}
+
+// 矩阵: 朴素 i-j-k 乘法与分块 GEMM (单线程/线程池), 以及 LU 和 Cholesky 分解
+typedef struct {
+    size_t n;
+    matrix_t *a;
+    matrix_t *b;
+    matrix_t *c;
+    matrix_t *spd;
+    matrix_t *work;
+    size_t *perm;
+    threadpool_t *pool;
+    long long result;
+} matrix_bench_data_t;
+
+// 改造前的 matrix_mul: i-j-k 三重循环, 每个元素经 matrix_get/matrix_set
+static void bench_matrix_naive(void *data) {
+    matrix_bench_data_t *d = data;
+    size_t n = d->n;
+    for (size_t i = 0; i < n; i++) {
+        for (size_t j = 0; j < n; j++) {
+            double sum = 0.0;
+            for (size_t k = 0; k < n; k++) sum += matrix_get(d->a, i, k) * matrix_get(d->b, k, j);
+            matrix_set(d->c, i, j, sum);
+        }
     }
+    if (matrix_get(d->c, n - 1, n - 1) != 0.0) d->result++;
 }
 
-static benchmark_suite_t* suite_create(void) {
-    benchmark_suite_t *suite = calloc(1, sizeof(benchmark_suite_t));
-    if (!suite) return NULL;
-    
-    suite->capacity = MAX_RESULTS;
-    suite->results = malloc(suite->capacity * sizeof(benchmark_result_t*));
-    if (!suite->results) {
-        free(suite);
-        return NULL;
+static void bench_matrix_gemm(void *data) {
+    matrix_bench_data_t *d = data;
+    if (matrix_gemm(1.0, d->a, d->b, 0.0, d->c, NULL) && matrix_get(d->c, d->n - 1, d->n - 1) != 0.0) d->result++;
+}
+
+static void bench_matrix_gemm_pool(void *data) {
+    matrix_bench_data_t *d = data;
+    if (matrix_gemm(1.0, d->a, d->b, 0.0, d->c, d->pool) && matrix_get(d->c, d->n - 1, d->n - 1) != 0.0) d->result++;
+}
+
+static void bench_matrix_lu(void *data) {
+    matrix_bench_data_t *d = data;
+    memcpy(d->work->data, d->a->data, d->n * d->n * sizeof(double));
+    if (matrix_lu(d->work, d->perm, d->pool)) d->result++;
+}
+
+static void bench_matrix_cholesky(void *data) {
+    matrix_bench_data_t *d = data;
+    memcpy(d->work->data, d->spd->data, d->n * d->n * sizeof(double));
+    if (matrix_cholesky(d->work, d->pool)) d->result++;
+}
+
+static void matrix_bench_reset(matrix_bench_data_t *d) {
+    matrix_free(d->a);
+    matrix_free(d->b);
+    matrix_free(d->c);
+    matrix_free(d->spd);
+    matrix_free(d->work);
+    free(d->perm);
+    d->a = d->b = d->c = d->spd = d->work = NULL;
+    d->perm = NULL;
+}
+
+static bool matrix_bench_build(matrix_bench_data_t *d, size_t n) {
+    uint32_t seed = (uint32_t)n;
+    d->n = n;
+    d->a = matrix_create(n, n);
+    d->b = matrix_create(n, n);
+    d->c = matrix_create(n, n);
+    d->spd = matrix_create(n, n);
+    d->work = matrix_create(n, n);
+    d->perm = malloc(n * sizeof(size_t));
+    if (!d->a || !d->b || !d->c || !d->spd || !d->work || !d->perm) return false;
+    for (size_t i = 0; i < n * n; i++) {
+        seed = seed * 1103515245u + 12345u;
+        d->a->data[i] = (double)((seed >> 16) % 2001) / 1000.0 - 1.0;
+        seed = seed * 1103515245u + 12345u;
+        d->b->data[i] = (double)((seed >> 16) % 2001) / 1000.0 - 1.0;
     }
-    
-    return suite;
+    // A^T A + n I 对称正定
+    if (!matrix_dgemm(true, false, n, n, n, 1.0, d->a->data, n, d->a->data, n, 0.0, d->spd->data, n, NULL)) return false;
+    for (size_t i = 0; i < n; i++) d->spd->data[i * n + i] += (double)n;
+    return true;
 }
 
-static void suite_free(benchmark_suite_t *suite) {
-    if (suite) {
-        for (size_t i = 0; i < suite->count; i++) {
-            result_free(suite->results[i]);
+static void run_matrix_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    matrix_bench_data_t d = { 0 };
+    char name[64];
+    size_t sizes[] = { 512, 1024 };
+    d.pool = threadpool_create(0);
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        if (!matrix_bench_build(&d, sizes[s])) {
+            printf("[matrix] 内存不足\n");
+            matrix_bench_reset(&d);
+            continue;
         }
-        free(suite->results);
-        free(suite->json_output);
-        free(suite);
+        double n = (double)d.n;
+
+        struct {
+            const char *tag;
+            const char *label;
+            void (*func)(void *);
+            double flops;
+        } cases[] = {
+            { "朴素乘法", "改造前的 i-j-k 乘法, 逐元素 get/set", bench_matrix_naive, 2.0 * n * n * n },
+            { "GEMM单线程", "matrix_gemm: 打包分块 + 6x8 微内核", bench_matrix_gemm, 2.0 * n * n * n },
+            { "GEMM线程池", "matrix_gemm: 行面板在线程池上并行", bench_matrix_gemm_pool, 2.0 * n * n * n },
+            { "LU", "matrix_lu: 分块部分主元, 尾部更新走 GEMM", bench_matrix_lu, 2.0 / 3.0 * n * n * n },
+            { "Cholesky", "matrix_cholesky: 分块, 尾部只更新下三角", bench_matrix_cholesky, 1.0 / 3.0 * n * n * n },
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            // 旧实现 1024 阶单次要数秒, 只测 512 阶
+            if (cases[i].func == bench_matrix_naive && d.n > 512) continue;
+            if (cases[i].func == bench_matrix_gemm_pool && !d.pool) continue;
+            printf("[matrix] %zu 阶 %s...\n", d.n, cases[i].label);
+            d.result = 0;
+            snprintf(name, sizeof(name), "矩阵 %zu 阶 %s", d.n, cases[i].tag);
+            benchmark_result_t *r = run_benchmark(name, cases[i].func, &d, iterations, warmup);
+            if (!r) continue;
+            r->passed = d.result > 0;
+            if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果异常");
+            if (r->mean > 0) printf("[matrix] %s: %.2f GFLOPS\n", name, cases[i].flops / (r->mean / 1000.0) / 1e9);
+            suite_add_result(suite, r);
+        }
+        matrix_bench_reset(&d);
     }
+    if (d.pool) threadpool_destroy(d.pool);
 }
 
-static void suite_add_result(benchmark_suite_t *suite, benchmark_result_t *result) {
-    if (suite->count >= suite->capacity) {
-        size_t new_capacity = suite->capacity * 2;
-        benchmark_result_t **new_results = realloc(suite->results, 
-                                                    new_capacity * sizeof(benchmark_result_t*));
-        if (!new_results) return;
-        suite->results = new_results;
-        suite->capacity = new_capacity;
+// 统计: 1000 万个模拟延迟样本, 保存数组排序取分位数 vs 单遍累加器 + HDR 直方图
+#define STATS_BENCH_SAMPLES 10000000
+
+typedef struct {
+    uint64_t *samples;
+    double *values;
+    stats_histogram_t *parts[4];
+    long long result;
+} stats_bench_data_t;
+
+static int stats_bench_compare(const void *a, const void *b) {
+    double da = *(const double *)a, db = *(const double *)b;
+    return (da > db) - (da < db);
+}
+
+// 改造前 benchmark 的做法: 样本存数组, 两遍求均值方差, qsort 后按下标取分位数
+static void bench_stats_sort(void *data) {
+    stats_bench_data_t *d = data;
+    for (size_t i = 0; i < STATS_BENCH_SAMPLES; i++) d->values[i] = (double)d->samples[i];
+    stats_t s = stats_compute(d->values, STATS_BENCH_SAMPLES);
+    qsort(d->values, STATS_BENCH_SAMPLES, sizeof(double), stats_bench_compare);
+    double p99 = d->values[(size_t)(STATS_BENCH_SAMPLES * 0.99)];
+    if (p99 > s.mean) d->result++;
+}
+
+static void bench_stats_stream(void *data) {
+    stats_bench_data_t *d = data;
+    stats_accum_t acc;
+    stats_accum_init(&acc);
+    stats_histogram_t *h = stats_histogram_create(LATENCY_HIGHEST_NS, LATENCY_SIGNIFICANT_DIGITS);
+    if (!h) return;
+    for (size_t i = 0; i < STATS_BENCH_SAMPLES; i++) {
+        stats_accum_add(&acc, (double)d->samples[i]);
+        stats_histogram_record(h, d->samples[i]);
     }
-    suite->results[suite->count++] = result;
+    stats_t s = stats_accum_result(&acc);
+    if ((double)stats_histogram_percentile(h, 99.0) > s.mean) d->result++;
+    stats_histogram_free(h);
 }
 
-static benchmark_result_t* run_benchmark(const char *name, benchmark_func_t func, 
-                                         void *data, size_t iterations, size_t warmup) {
-    benchmark_result_t *result = result_create(name);
-    if (!result) return NULL;
-    
-    result->memory_before = get_memory_usage();
-    result->total_iterations = iterations;
-    
-    for (size_t w = 0; w < warmup; w++) {
-        func(data);
+// 四段分别记录 (模拟四个线程各自的直方图) 后合并
+static void bench_stats_merge(void *data) {
+    stats_bench_data_t *d = data;
+    const size_t quarter = STATS_BENCH_SAMPLES / 4;
+    for (int p = 0; p < 4; p++) {
+        stats_histogram_reset(d->parts[p]);
+        for (size_t i = p * quarter; i < (p + 1) * quarter; i++) stats_histogram_record(d->parts[p], d->samples[i]);
     }
-    
-    stopwatch_t sw;
-    
-    for (size_t i = 0; i < iterations; i++) {
-        stopwatch_reset(&sw);
-        stopwatch_start(&sw);
-        
-        func(data);
-        
-        stopwatch_stop(&sw);
-        double elapsed_ms = (double)stopwatch_elapsed_ms(&sw);
-        result_add_sample(result, elapsed_ms);
-        result->total_time_ms += elapsed_ms;
-        
-        size_t current_mem = get_memory_usage();
-        if (current_mem > result->memory_peak) {
-            result->memory_peak = current_mem;
+    for (int p = 1; p < 4; p++) stats_histogram_merge(d->parts[0], d->parts[p]);
+    if (stats_histogram_count(d->parts[0]) == 4 * quarter) d->result++;
+}
+
+static void run_stats_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    stats_bench_data_t d = { 0 };
+    d.samples = malloc(STATS_BENCH_SAMPLES * sizeof(uint64_t));
+    d.values = malloc(STATS_BENCH_SAMPLES * sizeof(double));
+    bool ok = d.samples && d.values;
+    for (int p = 0; p < 4; p++) {
+        d.parts[p] = stats_histogram_create(LATENCY_HIGHEST_NS, LATENCY_SIGNIFICANT_DIGITS);
+        ok = ok && d.parts[p];
+    }
+    if (!ok) {
+        printf("[stats] 内存不足\n");
+        goto cleanup;
+    }
+    // 约 50us 的基线, 1% 的样本带 10-100 倍的长尾
+    uint32_t seed = 99;
+    for (size_t i = 0; i < STATS_BENCH_SAMPLES; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint64_t v = 40000 + (seed >> 8) % 20000;
+        if ((seed >> 4) % 100 == 0) v *= 10 + (seed >> 12) % 90;
+        d.samples[i] = v;
+    }
+
+    struct {
+        const char *name;
+        const char *label;
+        void (*func)(void *);
+    } cases[] = {
+        { "统计排序1000万", "保存全部样本, qsort 取分位数", bench_stats_sort },
+        { "统计流式1000万", "stats_accum + HDR 直方图单遍记录", bench_stats_stream },
+        { "直方图合并4x250万", "四个直方图分别记录后合并", bench_stats_merge },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        printf("[stats] %s...\n", cases[i].label);
+        d.result = 0;
+        benchmark_result_t *r = run_benchmark(cases[i].name, cases[i].func, &d, iterations, warmup);
+        if (!r) continue;
+        r->passed = d.result > 0;
+        if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果异常");
+        suite_add_result(suite, r);
+    }
+    printf("[stats] 排序需要 %zu KB 样本数组, 直方图 %zu KB 与样本数无关\n",
+           STATS_BENCH_SAMPLES * sizeof(double) / 1024, stats_histogram_memory(d.parts[0]) / 1024);
+
+cleanup:
+    for (int p = 0; p < 4; p++) stats_histogram_free(d.parts[p]);
+    free(d.samples);
+    free(d.values);
+}
+
+// 后缀数组: 模拟日志文本上的构建、LCP 和模式查找; 1MB 时对照改造前的倍增 + qsort 实现
+#define SA_BENCH_QUERIES 10000
+
+typedef struct {
+    size_t n;
+    char *text;
+    int *sa;
+    int *lcp;
+    long long result;
+} sa_bench_data_t;
+
+typedef struct {
+    int index;
+    int rank[2];
+} sa_bench_suffix_t;
+
+static int sa_bench_compare(const void *a, const void *b) {
+    const sa_bench_suffix_t *x = a, *y = b;
+    if (x->rank[0] != y->rank[0]) return x->rank[0] - y->rank[0];
+    return x->rank[1] - y->rank[1];
+}
+
+// 改造前的 suffix_array_build: 每轮倍增都 qsort 一次, O(n log^2 n)
+static void bench_sa_doubling(void *data) {
+    sa_bench_data_t *d = data;
+    int n = (int)d->n;
+    sa_bench_suffix_t *suf = malloc((size_t)n * sizeof(sa_bench_suffix_t));
+    int *ind = malloc((size_t)n * sizeof(int));
+    if (!suf || !ind) goto done;
+    for (int i = 0; i < n; i++) {
+        suf[i].index = i;
+        suf[i].rank[0] = (unsigned char)d->text[i];
+        suf[i].rank[1] = i + 1 < n ? (unsigned char)d->text[i + 1] : -1;
+    }
+    qsort(suf, (size_t)n, sizeof(sa_bench_suffix_t), sa_bench_compare);
+    for (int k = 4; k < 2 * n; k *= 2) {
+        int rank = 0, prev = suf[0].rank[0];
+        suf[0].rank[0] = 0;
+        ind[suf[0].index] = 0;
+        for (int i = 1; i < n; i++) {
+            if (suf[i].rank[0] == prev && suf[i].rank[1] == suf[i - 1].rank[1]) {
+                prev = suf[i].rank[0];
+                suf[i].rank[0] = rank;
+            } else {
+                prev = suf[i].rank[0];
+                suf[i].rank[0] = ++rank;
+            }
+            ind[suf[i].index] = i;
+        }
+        for (int i = 0; i < n; i++) {
+            int next = suf[i].index + k / 2;
+            suf[i].rank[1] = next < n ? suf[ind[next]].rank[0] : -1;
         }
+        qsort(suf, (size_t)n, sizeof(sa_bench_suffix_t), sa_bench_compare);
     }
-    
-    result->memory_after = get_memory_usage();
-    result_compute_stats(result);
-    
-    return result;
+    d->result += suf[n - 1].index + 1;
+done:
+    free(suf);
+    free(ind);
 }
 
-static void bench_cpu_intensive(void *data) {
-    volatile double result = 0;
-    size_t n = data ? *(size_t*)data : 10000;
-    
-    for (size_t i = 0; i < n; i++) {
-        result += sqrt((double)i) * sin((double)i) * cos((double)i);
+static void bench_sa_sais(void *data) {
+    sa_bench_data_t *d = data;
+    if (suffix_array_sais((const uint8_t *)d->text, d->n, d->sa) == SUFFIX_ARRAY_OK) d->result += d->sa[0] + 1;
+}
+
+static void bench_sa_lcp(void *data) {
+    sa_bench_data_t *d = data;
+    if (suffix_array_build_lcp(d->text, d->sa, NULL, d->lcp, d->n, NULL) == SUFFIX_ARRAY_OK) d->result += d->lcp[d->n - 1] + 1;
+}
+
+// 模式取自文本中的随机位置, 长度 4-19
+static void bench_sa_search(void *data) {
+    sa_bench_data_t *d = data;
+    uint32_t seed = 17;
+    for (int q = 0; q < SA_BENCH_QUERIES; q++) {
+        seed = seed * 1103515245u + 12345u;
+        size_t m = 4 + (seed >> 8) % 16;
+        size_t pos = (size_t)(seed >> 4) % (d->n - m);
+        d->result += (long long)suffix_array_count(d->text, d->sa, d->n, d->text + pos, m);
     }
 }
 
-static void bench_memory_alloc(void *data) {
-    size_t block_size = data ? *(size_t*)data : 1024;
-    size_t count = 100;
-    
-    void **ptrs = malloc(count * sizeof(void*));
-    if (!ptrs) return;
-    
-    for (size_t i = 0; i < count; i++) {
-        ptrs[i] = malloc(block_size);
-        if (ptrs[i]) {
-            memset(ptrs[i], 0, block_size);
+static void sa_bench_fill(char *text, size_t n, uint32_t *seed) {
+    static const char *words[] = {
+        "INFO ", "WARN ", "ERROR ", "request ", "user=", "GET /api/v1/items ", "POST /login ",
+        "status=200 ", "status=500 ", "latency_ms=", "timeout ", "\n",
+    };
+    size_t p = 0;
+    while (p < n) {
+        *seed = *seed * 1103515245u + 12345u;
+        const char *w = words[(*seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+        size_t l = strlen(w);
+        if (l > n - p) l = n - p;
+        memcpy(text + p, w, l);
+        p += l;
+        for (int digits = (*seed >> 8) % 4; digits > 0 && p < n; digits--) {
+            *seed = *seed * 1103515245u + 12345u;
+            text[p++] = (char)('0' + (*seed >> 16) % 10);
         }
     }
-    
-    for (size_t i = 0; i < count; i++) {
-        free(ptrs[i]);
+}
+
+static void run_suffix_array_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    sa_bench_data_t d = { 0 };
+    char name[64];
+    uint32_t seed = 7;
+    size_t sizes[] = { 1 << 20, 32 << 20 };
+
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        d.n = sizes[s];
+        d.text = malloc(d.n);
+        d.sa = malloc(d.n * sizeof(int));
+        d.lcp = malloc(d.n * sizeof(int));
+        if (!d.text || !d.sa || !d.lcp) {
+            printf("[suffix_array] 内存不足\n");
+            goto next;
+        }
+        sa_bench_fill(d.text, d.n, &seed);
+        if (suffix_array_sais((const uint8_t *)d.text, d.n, d.sa) != SUFFIX_ARRAY_OK) goto next;
+
+        struct {
+            const char *tag;
+            const char *label;
+            void (*func)(void *);
+        } cases[] = {
+            { "倍增", "改造前的倍增 + qsort 构建", bench_sa_doubling },
+            { "SA-IS", "suffix_array_sais 线性时间构建", bench_sa_sais },
+            { "LCP", "Kasai 算法构建 LCP", bench_sa_lcp },
+            { "查找x10000", "suffix_array_count 1 万次模式计数", bench_sa_search },
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            // 旧实现在 32MB 上需要一分钟以上, 只测 1MB
+            if (cases[i].func == bench_sa_doubling && d.n > (1 << 20)) continue;
+            printf("[suffix_array] %zuMB %s...\n", d.n >> 20, cases[i].label);
+            d.result = 0;
+            snprintf(name, sizeof(name), "后缀数组 %zuMB %s", d.n >> 20, cases[i].tag);
+            benchmark_result_t *r = run_benchmark(name, cases[i].func, &d, iterations, warmup);
+            if (!r) continue;
+            r->passed = d.result > 0;
+            if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果异常");
+            suite_add_result(suite, r);
+        }
+    next:
+        free(d.text);
+        free(d.sa);
+        free(d.lcp);
+        d.text = NULL;
+        d.sa = d.lcp = NULL;
     }
-    
-    free(ptrs);
 }
 
-static void bench_math_operations(void *data) {
-    size_t n = data ? *(size_t*)data : 10000;
-    volatile double result = 0;
-    
+#define LEV_BENCH_WORDS 100000
+
+typedef struct {
+    const char **words;
+    size_t *lens;
+    size_t *distances;
+    size_t count;
+    const char *query;
+    size_t query_len;
+    size_t max_k;
+    long long result;
+} lev_bench_data_t;
+
+// 改造前的 levenshtein_naive: (n+1)x(m+1) 矩阵, 每行一次 malloc
+static size_t lev_bench_naive(const char *s1, size_t n, const char *s2, size_t m) {
+    size_t **dp = malloc((n + 1) * sizeof(size_t *));
+    if (!dp) return (size_t)-1;
+    for (size_t i = 0; i <= n; i++) {
+        dp[i] = malloc((m + 1) * sizeof(size_t));
+        if (!dp[i]) {
+            for (size_t j = 0; j < i; j++) free(dp[j]);
+            free(dp);
+            return (size_t)-1;
+        }
+    }
+    for (size_t i = 0; i <= n; i++) dp[i][0] = i;
+    for (size_t j = 0; j <= m; j++) dp[0][j] = j;
     for (size_t i = 1; i <= n; i++) {
-        result += log((double)i);
-        result += exp((double)i / 1000.0);
-        result += pow((double)i, 0.5);
+        for (size_t j = 1; j <= m; j++) {
+            size_t cost = s1[i - 1] == s2[j - 1] ? 0 : 1;
+            size_t v = dp[i - 1][j - 1] + cost;
+            if (dp[i - 1][j] + 1 < v) v = dp[i - 1][j] + 1;
+            if (dp[i][j - 1] + 1 < v) v = dp[i][j - 1] + 1;
+            dp[i][j] = v;
+        }
     }
+    size_t result = dp[n][m];
+    for (size_t i = 0; i <= n; i++) free(dp[i]);
+    free(dp);
+    return result;
 }
 
-static void bench_string_operations(void *data) {
-    size_t n = data ? *(size_t*)data : 1000;
-    char buf[256];
-    
-    for (size_t i = 0; i < n; i++) {
-        snprintf(buf, sizeof(buf), "test_string_%zu_value_%zu", i, i * 2);
-        size_t len = strlen(buf);
-        for (size_t j = 0; j < len; j++) {
-            buf[j] = toupper(buf[j]);
-        }
+// 结果为距离不超过阈值的候选数加一, 各实现应一致
+static void bench_lev_naive(void *data) {
+    lev_bench_data_t *d = data;
+    long long hits = 1;
+    for (size_t i = 0; i < d->count; i++) {
+        if (lev_bench_naive(d->query, d->query_len, d->words[i], d->lens[i]) <= d->max_k) hits++;
     }
+    d->result += hits;
 }
 
-static void bench_file_io(void *data) {
-    const char *filename = data ? (const char*)data : "/tmp/benchmark_test.tmp";
-    
-    FILE *fp = fopen(filename, "wb");
-    if (!fp) return;
-    
-    char buffer[4096];
-    memset(buffer, 'A', sizeof(buffer));
-    
-    for (int i = 0; i < 10; i++) {
-        fwrite(buffer, 1, sizeof(buffer), fp);
+static void bench_lev_myers(void *data) {
+    lev_bench_data_t *d = data;
+    long long hits = 1;
+    for (size_t i = 0; i < d->count; i++) {
+        if (levenshtein_distance_bounded(d->query, d->query_len, d->words[i], d->lens[i], 0) <= d->max_k) hits++;
     }
-    fclose(fp);
-    
-    fp = fopen(filename, "rb");
-    if (fp) {
-        while (fread(buffer, 1, sizeof(buffer), fp) > 0);
-        fclose(fp);
+    d->result += hits;
+}
+
+static void bench_lev_bounded(void *data) {
+    lev_bench_data_t *d = data;
+    long long hits = 1;
+    for (size_t i = 0; i < d->count; i++) {
+        if (levenshtein_distance_bounded(d->query, d->query_len, d->words[i], d->lens[i], d->max_k) <= d->max_k) hits++;
     }
-    
-    remove(filename);
+    d->result += hits;
 }
 
-static void run_builtin_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
-    size_t cpu_n = 50000;
-    size_t mem_size = 4096;
-    size_t math_n = 10000;
-    size_t str_n = 5000;
-    
-    printf("运行内置基准测试...\n\n");
-    
-    printf("[1/4] CPU密集型操作...\n");
-    benchmark_result_t *cpu_result = run_benchmark("CPU密集型", bench_cpu_intensive, 
-                                                    &cpu_n, iterations, warmup);
-    if (cpu_result) suite_add_result(suite, cpu_result);
-    
-    printf("[2/4] 内存分配操作...\n");
-    benchmark_result_t *mem_result = run_benchmark("内存分配", bench_memory_alloc, 
-                                                    &mem_size, iterations, warmup);
-    if (mem_result) suite_add_result(suite, mem_result);
-    
-    printf("[3/4] 数学运算操作...\n");
-    benchmark_result_t *math_result = run_benchmark("数学运算", bench_math_operations, 
-                                                     &math_n, iterations, warmup);
-    if (math_result) suite_add_result(suite, math_result);
-    
-    printf("[4/4] 字符串操作...\n");
-    benchmark_result_t *str_result = run_benchmark("字符串操作", bench_string_operations, 
-                                                    &str_n, iterations, warmup);
-    if (str_result) suite_add_result(suite, str_result);
+static void bench_lev_matcher(void *data) {
+    lev_bench_data_t *d = data;
+    levenshtein_matcher_t *matcher = levenshtein_matcher_create(d->query, d->query_len, true);
+    if (!matcher) return;
+    long long hits = 1;
+    levenshtein_matcher_batch(matcher, d->words, d->lens, d->count, d->max_k, d->distances);
+    for (size_t i = 0; i < d->count; i++) {
+        if (d->distances[i] <= d->max_k) hits++;
+    }
+    levenshtein_matcher_free(matcher);
+    d->result += hits;
+}
+
+static void run_levenshtein_benchmarks(benchmark_suite_t *suite, size_t iterations, size_t warmup) {
+    lev_bench_data_t d = { 0 };
+    char name[64];
+    uint32_t seed = 11;
+    // 短词: 10 万个 4-15 字符的随机词, 阈值 2
+    // 长串: 1000 个由同一个 1000 字符基串随机编辑 0-60 次得到的近似串, 阈值 30 (多字 Myers)
+    struct {
+        const char *tag;
+        size_t count;
+        size_t len;
+        size_t max_k;
+    } sets[] = {
+        { "短词x10万", LEV_BENCH_WORDS, 0, 2 },
+        { "长串x1000", 1000, 1000, 30 },
+    };
+
+    for (size_t s = 0; s < sizeof(sets) / sizeof(sets[0]); s++) {
+        d.count = sets[s].count;
+        d.max_k = sets[s].max_k;
+        d.words = calloc(d.count, sizeof(char *));
+        d.lens = malloc(d.count * sizeof(size_t));
+        d.distances = malloc(d.count * sizeof(size_t));
+        char *base = malloc(sets[s].len + 1);
+        if (!d.words || !d.lens || !d.distances || !base) {
+            printf("[levenshtein] 内存不足\n");
+            free(base);
+            goto next;
+        }
+        for (size_t j = 0; j < sets[s].len; j++) {
+            seed = seed * 1103515245u + 12345u;
+            base[j] = (char)('a' + (seed >> 16) % 8);
+        }
+        for (size_t i = 0; i < d.count; i++) {
+            seed = seed * 1103515245u + 12345u;
+            size_t len = sets[s].len ? sets[s].len : 4 + (seed >> 8) % 12;
+            size_t edits = sets[s].len ? (seed >> 4) % 61 : len;
+            // 预留插入的空间
+            char *w = malloc(len + edits + 1);
+            if (!w) {
+                free(base);
+                goto next;
+            }
+            if (sets[s].len) {
+                memcpy(w, base, len);
+            }
+            for (size_t e = 0; e < edits; e++) {
+                seed = seed * 1103515245u + 12345u;
+                size_t pos = (seed >> 8) % len;
+                char c = (char)('a' + (seed >> 20) % 8);
+                if (!sets[s].len) {
+                    // 短词直接逐位随机
+                    w[e] = c;
+                } else if ((seed >> 4) % 3 == 0) {
+                    w[pos] = c;
+                } else if ((seed >> 4) % 3 == 1 && len > 1) {
+                    memmove(w + pos, w + pos + 1, len - pos - 1);
+                    len--;
+                } else {
+                    memmove(w + pos + 1, w + pos, len - pos);
+                    w[pos] = c;
+                    len++;
+                }
+            }
+            w[len] = '\0';
+            d.words[i] = w;
+            d.lens[i] = len;
+        }
+        free(base);
+        // 查询取自词表中的一个词, 保证至少一个命中
+        d.query = d.words[d.count / 2];
+        d.query_len = d.lens[d.count / 2];
+
+        struct {
+            const char *tag;
+            const char *label;
+            void (*func)(void *);
+        } cases[] = {
+            { "朴素DP", "改造前的逐行 malloc 矩阵 DP", bench_lev_naive },
+            { "Myers", "levenshtein_distance_bounded 位并行 (无阈值)", bench_lev_myers },
+            { "Myers 阈值", "levenshtein_distance_bounded 超过阈值提前结束", bench_lev_bounded },
+            { "批量 阈值", "levenshtein_matcher_batch 一对多 (短模式 AVX2 4 路)", bench_lev_matcher },
+        };
+        for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+            printf("[levenshtein] %s %s...\n", sets[s].tag, cases[i].label);
+            d.result = 0;
+            snprintf(name, sizeof(name), "编辑距离 %s %s", sets[s].tag, cases[i].tag);
+            benchmark_result_t *r = run_benchmark(name, cases[i].func, &d, iterations, warmup);
+            if (!r) continue;
+            r->passed = d.result > 0;
+            if (!r->passed) snprintf(r->error_msg, sizeof(r->error_msg), "结果异常");
+            suite_add_result(suite, r);
+        }
+    next:
+        if (d.words) {
+            for (size_t i = 0; i < d.count; i++) free((char *)d.words[i]);
+        }
+        free(d.words);
+        free(d.lens);
+        free(d.distances);
+        d.words = NULL;
+        d.lens = d.distances = NULL;
+    }
+}
+
+typedef struct {
+    const char *name;
+    const char *description;
+    void (*run)(benchmark_suite_t *suite, size_t iterations, size_t warmup);
+} module_benchmark_t;
+
+static const module_benchmark_t module_benchmarks[] = {
+    { "lzw", "LZW 哈希字典编码/解码与线性扫描基线对比", run_lzw_benchmarks },
+    { "huffman", "规范哈夫曼查表解码与指针树逐位解码对比", run_huffman_benchmarks },
+    { "frame", "分块压缩容器单线程与线程池并行压缩/解压对比", run_frame_benchmarks },
+    { "chacha20", "ChaCha20/Poly1305/AEAD 吞吐量 (大消息与 1KB 消息)", run_chacha20_benchmarks },
+    { "trie", "自适应基数树与 256 指针节点 trie 的内存与查找对比", run_trie_benchmarks },
+    { "bplus", "页大小节点 B+ 树: 插入、批量构建、内联键与比较函数查找、范围扫描", run_bplus_benchmarks },
+    { "kv", "页式 B+ 树、LSM 引擎与旧版文本文件扫描的查找/写入对比", run_kv_benchmarks },
+    { "bloom", "分块布隆过滤器与旧版布局的否定查找/批量查找/插入对比", run_bloom_benchmarks },
+    { "roaring", "Roaring 位图与旧版行程压缩位图对比, 千万级 ID 集合的构建/查找/集合运算", run_roaring_benchmarks },
+    { "bitset", "64 位字稠密位集: 计数、集合运算、区间操作、ctz 查找与排名/选择", run_bitset_benchmarks },
+    { "slab", "分级小对象分配器与 glibc malloc 对比: 单线程/多线程随机分配释放与跨线程释放", run_slab_benchmarks },
+    { "dijkstra", "百万节点网格上的 CSR 堆 Dijkstra: 单源全图、点到点提前结束与线程池多对多查询", run_dijkstra_benchmarks },
+    { "graph", "五十万节点随机图: 方向优化 BFS、并行 Bellman-Ford、Delta-stepping 与 Boruvka", run_graph_benchmarks },
+    { "floyd", "千节点稠密图上的分块 SIMD Floyd-Warshall 与邻接表堆 Prim", run_floyd_benchmarks },
+    { "astar", "512x512 网格寻路: 回调版 A*、预分配数组的网格 A* 与跳点搜索", run_astar_benchmarks },
+    { "fft", "2^10 到 2^22 点 FFT: 递归实现、预计算计划的迭代基 4 SIMD 实现、实数半长技巧与批量并行", run_fft_benchmarks },
+    { "bigint", "1000 到 100000 位十进制数乘法、除法和十进制转换 (对照逐位十进制实现), 2048 位模幂", run_bigint_benchmarks },
+    { "matrix", "矩阵乘法 GFLOPS (朴素/分块 GEMM/线程池) 与 LU、Cholesky 分解", run_matrix_benchmarks },
+    { "stats", "1000 万延迟样本: 排序取分位数 vs 流式累加器 + HDR 直方图, 以及直方图合并", run_stats_benchmarks },
+    { "suffix_array", "后缀数组: SA-IS 构建 (对照倍增 + qsort)、Kasai LCP 与模式计数", run_suffix_array_benchmarks },
+    { "levenshtein", "Myers 位并行编辑距离: 单次、阈值提前结束与一对多批量 (对照逐行 malloc 的矩阵 DP)", run_levenshtein_benchmarks },
+    { "skiplist", "无锁跳表与原版跳表 (单线程/互斥锁) 的插入与多线程查找对比", run_skiplist_benchmarks },
+};
+
+#define MODULE_BENCHMARK_COUNT (sizeof(module_benchmarks) / sizeof(module_benchmarks[0]))
+
+static bool run_module_benchmarks(benchmark_suite_t *suite, const char *module,
+                                  size_t iterations, size_t warmup) {
+    bool matched = false;
+    for (size_t i = 0; i < MODULE_BENCHMARK_COUNT; i++) {
+        if (strcmp(module, "all") == 0 || strcmp(module, module_benchmarks[i].name) == 0) {
+            printf("运行模块基准测试: %s\n\n", module_benchmarks[i].name);
+            module_benchmarks[i].run(suite, iterations, warmup);
+            matched = true;
+        }
+    }
+    return matched;
 }
 
 static void print_result_table(benchmark_suite_t *suite) {
@@ -515,6 +3415,7 @@ static void print_help(const char *prog) {
     printf("  -o, --output <file>      输出JSON报告文件\n");
     printf("  -v, --verbose            详细输出模式\n");
     printf("  -s, --system             显示系统信息\n");
+    printf("  -m, --module <name>      运行模块基准测试 (all 表示全部)\n");
     printf("  -h, --help               显示帮助信息\n");
     
     printf("\n内置基准测试:\n");
@@ -523,11 +3424,17 @@ static void print_help(const char *prog) {
     printf("  数学运算     - 对数、指数、幂运算\n");
     printf("  字符串操作   - 字符串格式化和处理\n");
     
+    printf("\n模块基准测试:\n");
+    for (size_t i = 0; i < MODULE_BENCHMARK_COUNT; i++) {
+        printf("  %-12s - %s\n", module_benchmarks[i].name, module_benchmarks[i].description);
+    }
+    
     printf("\n示例:\n");
     printf("  %s                          # 运行默认基准测试\n", prog);
     printf("  %s -i 100 -w 5              # 100次迭代，5次预热\n", prog);
     printf("  %s -o report.json           # 输出JSON报告\n", prog);
     printf("  %s -v                       # 详细输出\n", prog);
+    printf("  %s -m lzw -i 3              # 运行 LZW 模块基准测试\n", prog);
 }
 
 int main(int argc, char **argv) {
@@ -536,6 +3443,7 @@ int main(int argc, char **argv) {
     const char *output_file = NULL;
     bool verbose = false;
     bool show_system = false;
+    const char *module = NULL;
     
     for (int i = 1; i < argc; i++) {
         if (strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--iterations") == 0) {
@@ -553,6 +3461,10 @@ int main(int argc, char **argv) {
             }
         } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
             verbose = true;
+        } else if (strcmp(argv[i], "-m") == 0 || strcmp(argv[i], "--module") == 0) {
+            if (i + 1 < argc) {
+                module = argv[++i];
+            }
         } else if (strcmp(argv[i], "-s") == 0 || strcmp(argv[i], "--system") == 0) {
             show_system = true;
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
@@ -588,7 +3500,15 @@ int main(int argc, char **argv) {
         return 1;
     }
     
-    run_builtin_benchmarks(suite, iterations, warmup);
+    if (module) {
+        if (!run_module_benchmarks(suite, module, iterations, warmup)) {
+            fprintf(stderr, "错误: 未知模块 '%s'\n", module);
+            suite_free(suite);
+            return 1;
+        }
+    } else {
+        run_builtin_benchmarks(suite, iterations, warmup);
+    }
     
     print_result_table(suite);
     
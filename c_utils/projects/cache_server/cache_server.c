@@ -16,6 +16,7 @@
 #include "timer.h"
 #include "terminal.h"
 #include "argparse.h"
+#include "slab_alloc.h"
 
 #define DEFAULT_PORT "6379"
 #define DEFAULT_CAPACITY 10000
@@ -53,6 +54,14 @@ typedef struct {
     char client_ip[INET6_ADDRSTRLEN];
 } client_context_t;
 
+// 值与连接上下文由各工作线程频繁创建/释放, 走 slab 分配器的线程缓存
+static char* slab_strdup(const char *s) {
+    size_t len = strlen(s) + 1;
+    char *copy = slab_alloc(len);
+    if (copy) memcpy(copy, s, len);
+    return copy;
+}
+
 static uint64_t get_current_time_ms(void) {
     struct timespec ts;
     clock_gettime(CLOCK_REALTIME, &ts);
@@ -151,7 +160,7 @@ static void handle_set(client_context_t *ctx, char *args) {
         return;
     }
     
-    char *value_copy = strdup(value);
+    char *value_copy = slab_strdup(value);
     if (!value_copy) {
         send_response(ctx->client_fd, "-ERR out of memory\r\n");
         return;
@@ -199,19 +208,18 @@ static void handle_get(client_context_t *ctx, char *args) {
         return;
     }
     
+    // 值在被覆盖或淘汰时由缓存释放, 响应要在锁内生成
     char *value = lru_cache_get(g_server.cache, key);
+    char response[BUFFER_SIZE];
+    if (value) {
+        snprintf(response, sizeof(response), "$%zu\r\n%s\r\n", strlen(value), value);
+    }
     
     g_server.commands_processed++;
     
     pthread_mutex_unlock(&g_server.lock);
     
-    if (value) {
-        char response[BUFFER_SIZE];
-        snprintf(response, sizeof(response), "$%zu\r\n%s\r\n", strlen(value), value);
-        send_response(ctx->client_fd, response);
-    } else {
-        send_response(ctx->client_fd, "$-1\r\n");
-    }
+    send_response(ctx->client_fd, value ? response : "$-1\r\n");
 }
 
 static void handle_del(client_context_t *ctx, char *args) {
@@ -364,7 +372,7 @@ static void handle_incr(client_context_t *ctx, char *args) {
     char *value = lru_cache_get(g_server.cache, key);
     
     if (!value) {
-        char *new_value = strdup("1");
+        char *new_value = slab_strdup("1");
         if (!new_value) {
             pthread_mutex_unlock(&g_server.lock);
             send_response(ctx->client_fd, "-ERR out of memory\r\n");
@@ -389,7 +397,7 @@ static void handle_incr(client_context_t *ctx, char *args) {
     char new_value[64];
     snprintf(new_value, sizeof(new_value), "%lld", num);
     
-    char *value_copy = strdup(new_value);
+    char *value_copy = slab_strdup(new_value);
     if (!value_copy) {
         pthread_mutex_unlock(&g_server.lock);
         send_response(ctx->client_fd, "-ERR out of memory\r\n");
@@ -420,7 +428,7 @@ static void handle_decr(client_context_t *ctx, char *args) {
     char *value = lru_cache_get(g_server.cache, key);
     
     if (!value) {
-        char *new_value = strdup("-1");
+        char *new_value = slab_strdup("-1");
         if (!new_value) {
             pthread_mutex_unlock(&g_server.lock);
             send_response(ctx->client_fd, "-ERR out of memory\r\n");
@@ -445,7 +453,7 @@ static void handle_decr(client_context_t *ctx, char *args) {
     char new_value[64];
     snprintf(new_value, sizeof(new_value), "%lld", num);
     
-    char *value_copy = strdup(new_value);
+    char *value_copy = slab_strdup(new_value);
     if (!value_copy) {
         pthread_mutex_unlock(&g_server.lock);
         send_response(ctx->client_fd, "-ERR out of memory\r\n");
@@ -651,7 +659,7 @@ cleanup:
     
     net_close(ctx->client_fd);
     printf("Client disconnected from %s\n", ctx->client_ip);
-    free(ctx);
+    slab_free(ctx);
 }
 
 static void signal_handler(int sig) {
@@ -735,7 +743,11 @@ int main(int argc, char *argv[]) {
         return 1;
     }
     
-    g_server.cache = lru_cache_create(capacity);
+    lru_cache_config_t cache_config;
+    lru_cache_get_default_config(&cache_config);
+    cache_config.capacity = capacity;
+    cache_config.value_free = slab_free;
+    g_server.cache = lru_cache_create_ex(&cache_config, NULL);
     if (!g_server.cache) {
         fprintf(stderr, "Failed to create cache\n");
         free(g_server.expire_list);
@@ -794,7 +806,7 @@ int main(int argc, char *argv[]) {
             continue;
         }
         
-        client_context_t *ctx = malloc(sizeof(client_context_t));
+        client_context_t *ctx = slab_alloc(sizeof(client_context_t));
         if (!ctx) {
             net_close(client_fd);
             continue;
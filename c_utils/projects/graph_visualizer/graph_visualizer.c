@@ -6,77 +6,89 @@
 #include <ctype.h>
 #include <limits.h>
 
+#include "graph_csr.h"
 #include "dijkstra.h"
+#include "bellman_ford.h"
 #include "kruskal.h"
 #include "prim.h"
 #include "tarjan_scc.h"
+#include "hashmap.h"
+#include "threadpool.h"
 #include "terminal.h"
 #include "json.h"
 #include "argparse.h"
 
-#define MAX_NODES 50
-#define MAX_EDGES 500
 #define MAX_NAME_LEN 32
-#define INFINITY_VAL 1000000
+#define PRINT_LIMIT 50              // 大图只打印前若干节点/边/分量
 
 typedef struct {
     char name[MAX_NAME_LEN];
     int x, y;
 } graph_node_t;
 
+// 节点名只在 JSON 图中存在; 边列表文件的节点直接用编号显示
+// 边在加载时进入构建器, 加载完成后统一转换为 CSR, 无向图每条边存两个方向
 typedef struct {
-    int from;
-    int to;
-    int weight;
-} graph_edge_t;
-
-typedef struct {
-    graph_node_t nodes[MAX_NODES];
+    graph_node_t *nodes;
     int node_count;
-    graph_edge_t edges[MAX_EDGES];
-    int edge_count;
+    int node_capacity;
+    hashmap_t *names;
+    graph_csr_builder_t *builder;
+    graph_csr_t *csr;
+    size_t edge_count;
     bool directed;
 } graph_t;
 
-typedef struct {
-    int step;
-    char description[256];
-    int visited[MAX_NODES];
-    int visited_count;
-    int current_node;
-    int path[MAX_NODES];
-    int path_count;
-    int distances[MAX_NODES];
-    int highlight_edge_from;
-    int highlight_edge_to;
-} algorithm_step_t;
-
-typedef struct {
-    algorithm_step_t *steps;
-    int step_count;
-    int step_capacity;
-} algorithm_history_t;
-
 static void graph_init(graph_t *g) {
     memset(g, 0, sizeof(graph_t));
     g->directed = false;
 }
 
-static int graph_find_node(graph_t *g, const char *name) {
-    for (int i = 0; i < g->node_count; i++) {
-        if (strcmp(g->nodes[i].name, name) == 0) {
-            return i;
-        }
-    }
-    return -1;
+static void graph_free(graph_t *g) {
+    free(g->nodes);
+    if (g->names) hashmap_free(g->names);
+    graph_csr_builder_free(g->builder);
+    graph_csr_free(g->csr);
+    memset(g, 0, sizeof(graph_t));
+}
+
+static const char* graph_node_name(const graph_t *g, int i) {
+    static char buffers[4][16];
+    static int next;
+    if (g->nodes) return g->nodes[i].name;
+    char *buf = buffers[next++ & 3];
+    snprintf(buf, sizeof(buffers[0]), "%d", i);
+    return buf;
+}
+
+static int graph_find_node(const graph_t *g, const char *name) {
+    if (g->names) {
+        void *idx = hashmap_get(g->names, name);
+        return idx ? (int)((intptr_t)idx - 1) : -1;
+    }
+    // 边列表图按编号查找
+    char *end;
+    long idx = strtol(name, &end, 10);
+    if (*name == '\0' || *end != '\0' || idx < 0 || idx >= g->node_count) return -1;
+    return (int)idx;
 }
 
 static int graph_add_node(graph_t *g, const char *name) {
-    if (g->node_count >= MAX_NODES) return -1;
+    if (!g->names && !(g->names = hashmap_create())) return -1;
     if (graph_find_node(g, name) >= 0) return -1;
-    
-    int idx = g->node_count++;
+    if (g->node_count == g->node_capacity) {
+        int capacity = g->node_capacity ? g->node_capacity * 2 : 64;
+        graph_node_t *nodes = realloc(g->nodes, (size_t)capacity * sizeof(graph_node_t));
+        if (!nodes) return -1;
+        g->nodes = nodes;
+        g->node_capacity = capacity;
+    }
+
+    int idx = g->node_count;
+    memset(&g->nodes[idx], 0, sizeof(graph_node_t));
     strncpy(g->nodes[idx].name, name, MAX_NAME_LEN - 1);
+    if (!hashmap_set(g->names, g->nodes[idx].name, (void *)(intptr_t)(idx + 1))) return -1;
+    g->node_count++;
     g->nodes[idx].x = idx % 5;
     g->nodes[idx].y = idx / 5;
     return idx;
@@ -86,15 +98,44 @@ static bool graph_add_edge(graph_t *g, int from, int to, int weight) {
     if (from < 0 || from >= g->node_count || to < 0 || to >= g->node_count) {
         return false;
     }
-    if (g->edge_count >= MAX_EDGES) return false;
-    
-    g->edges[g->edge_count].from = from;
-    g->edges[g->edge_count].to = to;
-    g->edges[g->edge_count].weight = weight;
+    if (!g->builder && !(g->builder = graph_csr_builder_create((size_t)g->node_count))) return false;
+    if (!graph_csr_builder_add_edge(g->builder, from, to, weight)) return false;
+    if (!g->directed && from != to && !graph_csr_builder_add_edge(g->builder, to, from, weight)) return false;
     g->edge_count++;
     return true;
 }
 
+// 加载完成: 构建 CSR 并释放构建器
+static bool graph_finish(graph_t *g) {
+    if (!g->builder && !(g->builder = graph_csr_builder_create((size_t)g->node_count))) return false;
+    g->csr = graph_csr_builder_build(g->builder);
+    graph_csr_builder_free(g->builder);
+    g->builder = NULL;
+    if (!g->csr) return false;
+    // 构建器节点数至少为 node_count, 只有孤立的 JSON 节点时仍以 node_count 为准
+    if ((int)g->csr->nodes > g->node_count) g->node_count = (int)g->csr->nodes;
+    return true;
+}
+
+// 流式加载文本边列表, 节点按编号命名
+static bool graph_load_edge_list(graph_t *g, const char *filename, bool directed) {
+    graph_init(g);
+    g->directed = directed;
+    g->csr = graph_csr_load_edge_list(filename, !directed);
+    if (!g->csr) return false;
+    if (g->csr->nodes > INT_MAX) {
+        graph_free(g);
+        return false;
+    }
+    g->node_count = (int)g->csr->nodes;
+    size_t self_loops = 0;
+    for (size_t u = 0; u < g->csr->nodes; u++) {
+        for (size_t i = g->csr->offsets[u]; i < g->csr->offsets[u + 1]; i++) self_loops += (size_t)g->csr->targets[i] == u;
+    }
+    g->edge_count = directed ? g->csr->edges : (g->csr->edges - self_loops) / 2 + self_loops;
+    return true;
+}
+
 static bool graph_load_json(graph_t *g, const char *filename) {
     FILE *fp = fopen(filename, "r");
     if (!fp) return false;
@@ -182,17 +223,19 @@ static bool graph_load_json(graph_t *g, const char *filename) {
     }
     
     json_free(json);
-    return true;
+    return graph_finish(g);
 }
 
 static void print_graph_ascii(graph_t *g, int *highlight_nodes, int highlight_count,
                               int highlight_edge_from, int highlight_edge_to) {
     printf("\n");
-    term_printf(TERM_ANSI_CYAN, "图结构 (%s):\n", g->directed ? "有向图" : "无向图");
+    term_printf(TERM_ANSI_CYAN, "图结构 (%s, %d 个节点, %zu 条边):\n",
+                g->directed ? "有向图" : "无向图", g->node_count, g->edge_count);
     term_printf(TERM_ANSI_CYAN, "────────────────────────────────────────────────────────────────\n");
     
     printf("节点: ");
-    for (int i = 0; i < g->node_count; i++) {
+    int shown = g->node_count < PRINT_LIMIT ? g->node_count : PRINT_LIMIT;
+    for (int i = 0; i < shown; i++) {
         bool highlighted = false;
         for (int j = 0; j < highlight_count; j++) {
             if (highlight_nodes[j] == i) {
@@ -201,63 +244,81 @@ static void print_graph_ascii(graph_t *g, int *highlight_nodes, int highlight_co
             }
         }
         if (highlighted) {
-            term_printf(TERM_ANSI_GREEN, "[%s] ", g->nodes[i].name);
+            term_printf(TERM_ANSI_GREEN, "[%s] ", graph_node_name(g, i));
         } else {
-            printf("%s ", g->nodes[i].name);
+            printf("%s ", graph_node_name(g, i));
         }
     }
+    if (shown < g->node_count) printf("... (其余 %d 个省略)", g->node_count - shown);
     printf("\n\n边:\n");
     
-    for (int i = 0; i < g->edge_count; i++) {
-        graph_edge_t *e = &g->edges[i];
-        bool highlight = (e->from == highlight_edge_from && e->to == highlight_edge_to) ||
-                        (!g->directed && e->from == highlight_edge_to && e->to == highlight_edge_from);
-        
-        if (highlight) {
-            term_printf(TERM_ANSI_YELLOW, "  %s --%d--> %s\n", 
-                       g->nodes[e->from].name, e->weight, g->nodes[e->to].name);
-        } else {
-            printf("  %s --%d--> %s\n", 
-                   g->nodes[e->from].name, e->weight, g->nodes[e->to].name);
+    // 无向图每条边存了两个方向, 只打印 from <= to 的一份
+    int printed = 0;
+    for (int u = 0; u < g->node_count && printed < PRINT_LIMIT; u++) {
+        const int *to, *weight;
+        size_t degree = graph_csr_neighbors(g->csr, u, &to, &weight);
+        for (size_t k = 0; k < degree && printed < PRINT_LIMIT; k++) {
+            int v = to[k];
+            if (!g->directed && v < u) continue;
+            bool highlight = (u == highlight_edge_from && v == highlight_edge_to) ||
+                            (!g->directed && u == highlight_edge_to && v == highlight_edge_from);
+            
+            if (highlight) {
+                term_printf(TERM_ANSI_YELLOW, "  %s --%d--> %s\n", 
+                           graph_node_name(g, u), weight[k], graph_node_name(g, v));
+            } else {
+                printf("  %s --%d--> %s\n", 
+                       graph_node_name(g, u), weight[k], graph_node_name(g, v));
+            }
+            printed++;
         }
     }
+    if ((size_t)printed < g->edge_count) printf("  ... (其余 %zu 条省略)\n", g->edge_count - (size_t)printed);
     printf("\n");
 }
 
 static void print_distances(graph_t *g, int *dist, int src) {
-    printf("\n距离表 (从 %s 出发):\n", g->nodes[src].name);
+    printf("\n距离表 (从 %s 出发):\n", graph_node_name(g, src));
     printf("────────────────────────────────────────────────────────────────\n");
-    for (int i = 0; i < g->node_count; i++) {
-        if (dist[i] == INFINITY_VAL) {
-            printf("  %s: ∞\n", g->nodes[i].name);
+    int shown = g->node_count < PRINT_LIMIT ? g->node_count : PRINT_LIMIT;
+    for (int i = 0; i < shown; i++) {
+        if (dist[i] == INT_MAX) {
+            printf("  %s: ∞\n", graph_node_name(g, i));
         } else {
-            printf("  %s: %d\n", g->nodes[i].name, dist[i]);
+            printf("  %s: %d\n", graph_node_name(g, i), dist[i]);
         }
     }
+    if (shown < g->node_count) printf("  ... (其余 %d 个省略)\n", g->node_count - shown);
 }
 
 static void print_path(graph_t *g, int *prev, int src, int dst) {
     if (prev[dst] == -1 && src != dst) {
-        printf("无法到达 %s\n", g->nodes[dst].name);
+        printf("无法到达 %s\n", graph_node_name(g, dst));
         return;
     }
     
-    int path[MAX_NODES];
+    int *path = malloc((size_t)g->node_count * sizeof(int));
+    if (!path) return;
     int path_len = 0;
     int current = dst;
     
-    while (current != -1) {
+    while (current != -1 && path_len < g->node_count) {
         path[path_len++] = current;
         if (current == src) break;
         current = prev[current];
     }
     
-    printf("路径: ");
+    printf("路径 (%d 个节点): ", path_len);
     for (int i = path_len - 1; i >= 0; i--) {
-        term_printf(TERM_ANSI_GREEN, "%s", g->nodes[path[i]].name);
+        if (path_len > PRINT_LIMIT && i == path_len - PRINT_LIMIT / 2 - 1) {
+            printf("... -> ");
+            i = PRINT_LIMIT / 2;
+        }
+        term_printf(TERM_ANSI_GREEN, "%s", graph_node_name(g, path[i]));
         if (i > 0) printf(" -> ");
     }
     printf("\n");
+    free(path);
 }
 
 static void run_dijkstra(graph_t *g, int src, int dst, bool verbose) {
@@ -266,63 +327,21 @@ static void run_dijkstra(graph_t *g, int src, int dst, bool verbose) {
     term_printf(TERM_ANSI_CYAN, "                    Dijkstra 最短路径算法                         \n");
     term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
     
-    int dist[MAX_NODES];
-    int prev[MAX_NODES];
-    bool visited[MAX_NODES] = {false};
-    
-    for (int i = 0; i < g->node_count; i++) {
-        dist[i] = INFINITY_VAL;
-        prev[i] = -1;
-    }
-    dist[src] = 0;
+    int *dist = malloc((size_t)g->node_count * sizeof(int));
+    int *prev = malloc((size_t)g->node_count * sizeof(int));
+    dijkstra_error_t error = DIJKSTRA_ERROR_MEMORY_ALLOC;
     
     if (verbose) {
         printf("\n初始化:\n");
-        printf("  起点: %s, 终点: %s\n", g->nodes[src].name, g->nodes[dst].name);
-        printf("  初始距离: %s = 0, 其他 = ∞\n", g->nodes[src].name);
+        printf("  起点: %s, 终点: %s\n", graph_node_name(g, src), graph_node_name(g, dst));
     }
     
-    for (int count = 0; count < g->node_count; count++) {
-        int min_dist = INFINITY_VAL;
-        int u = -1;
-        
-        for (int i = 0; i < g->node_count; i++) {
-            if (!visited[i] && dist[i] < min_dist) {
-                min_dist = dist[i];
-                u = i;
-            }
-        }
-        
-        if (u == -1) break;
-        visited[u] = true;
-        
-        if (verbose) {
-            printf("\n步骤 %d: 选择节点 %s (距离: %d)\n", 
-                   count + 1, g->nodes[u].name, dist[u]);
-        }
-        
-        for (int e = 0; e < g->edge_count; e++) {
-            graph_edge_t *edge = &g->edges[e];
-            int v = -1;
-            
-            if (edge->from == u) v = edge->to;
-            else if (!g->directed && edge->to == u) v = edge->from;
-            
-            if (v >= 0 && !visited[v]) {
-                int new_dist = dist[u] + edge->weight;
-                if (new_dist < dist[v]) {
-                    dist[v] = new_dist;
-                    prev[v] = u;
-                    
-                    if (verbose) {
-                        printf("  更新 %s: %d -> %d (通过 %s)\n", 
-                               g->nodes[v].name, 
-                               new_dist - edge->weight, new_dist, 
-                               g->nodes[u].name);
-                    }
-                }
-            }
-        }
+    // 详细模式需要完整距离表, 否则到达终点即停止
+    if (!dist || !prev || !dijkstra_csr(g->csr, src, verbose ? -1 : dst, dist, prev, &error)) {
+        term_printf(TERM_ANSI_RED, "算法执行失败: %s\n", dijkstra_strerror(error));
+        free(dist);
+        free(prev);
+        return;
     }
     
     printf("\n结果:\n");
@@ -332,8 +351,8 @@ static void run_dijkstra(graph_t *g, int src, int dst, bool verbose) {
         print_distances(g, dist, src);
     }
     
-    printf("\n从 %s 到 %s:\n", g->nodes[src].name, g->nodes[dst].name);
-    if (dist[dst] == INFINITY_VAL) {
+    printf("\n从 %s 到 %s:\n", graph_node_name(g, src), graph_node_name(g, dst));
+    if (dist[dst] == INT_MAX) {
         term_printf(TERM_ANSI_RED, "无法到达\n");
     } else {
         printf("  最短距离: ");
@@ -344,40 +363,122 @@ static void run_dijkstra(graph_t *g, int src, int dst, bool verbose) {
     
     int highlight_nodes[2] = {src, dst};
     print_graph_ascii(g, highlight_nodes, 2, -1, -1);
+    free(dist);
+    free(prev);
 }
 
-static void run_kruskal(graph_t *g, bool verbose) {
+static void run_bellman_ford(graph_t *g, int src, int dst, threadpool_t *pool, bool verbose) {
     printf("\n");
     term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
-    term_printf(TERM_ANSI_CYAN, "                    Kruskal 最小生成树算法                        \n");
+    term_printf(TERM_ANSI_CYAN, "                    Bellman-Ford 最短路径算法                     \n");
     term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
     
-    kruskal_edge_t *edges = malloc(g->edge_count * sizeof(kruskal_edge_t));
-    if (!edges) {
+    int *dist = malloc((size_t)g->node_count * sizeof(int));
+    int *prev = malloc((size_t)g->node_count * sizeof(int));
+    if (!dist || !prev) {
         term_printf(TERM_ANSI_RED, "内存分配失败\n");
+        free(dist);
+        free(prev);
         return;
     }
     
-    for (int i = 0; i < g->edge_count; i++) {
-        edges[i].u = g->edges[i].from;
-        edges[i].v = g->edges[i].to;
-        edges[i].w = g->edges[i].weight;
+    if (bellman_ford_csr(g->csr, src, dist, prev, pool)) {
+        term_printf(TERM_ANSI_RED, "检测到从 %s 可达的负权环\n", graph_node_name(g, src));
+    } else {
+        if (verbose) {
+            print_distances(g, dist, src);
+        }
+        printf("\n从 %s 到 %s:\n", graph_node_name(g, src), graph_node_name(g, dst));
+        if (dist[dst] == INT_MAX) {
+            term_printf(TERM_ANSI_RED, "无法到达\n");
+        } else {
+            printf("  最短距离: ");
+            term_printf(TERM_ANSI_GREEN, "%d\n", dist[dst]);
+            printf("  ");
+            print_path(g, prev, src, dst);
+        }
     }
+    free(dist);
+    free(prev);
+}
+
+static void run_bfs(graph_t *g, int src, int dst, threadpool_t *pool, bool verbose) {
+    printf("\n");
+    term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
+    term_printf(TERM_ANSI_CYAN, "                    方向优化广度优先搜索                          \n");
+    term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
     
-    int total_weight = kruskal_mst(g->node_count, g->edge_count, edges);
-    free(edges);
+    int *parent = malloc((size_t)g->node_count * sizeof(int));
+    int *depth = malloc((size_t)g->node_count * sizeof(int));
+    graph_csr_t *reverse = g->directed ? graph_csr_transpose(g->csr) : NULL;
+    size_t reached = 0;
+    if (parent && depth && (!g->directed || reverse)) {
+        reached = graph_csr_bfs(g->csr, g->directed ? reverse : g->csr, src, parent, depth, pool);
+    }
+    if (reached == 0) {
+        term_printf(TERM_ANSI_RED, "算法执行失败\n");
+    } else {
+        int levels = 0;
+        for (int i = 0; i < g->node_count; i++) {
+            if (depth[i] > levels) levels = depth[i];
+        }
+        printf("\n从 %s 可达节点: ", graph_node_name(g, src));
+        term_printf(TERM_ANSI_GREEN, "%zu / %d\n", reached, g->node_count);
+        printf("  层数: %d\n", levels + 1);
+        if (verbose) {
+            print_distances(g, depth, src);
+        }
+        printf("\n到 %s: ", graph_node_name(g, dst));
+        if (depth[dst] < 0) {
+            term_printf(TERM_ANSI_RED, "无法到达\n");
+        } else {
+            printf("%d 跳\n  ", depth[dst]);
+            parent[src] = -1;
+            print_path(g, parent, src, dst);
+        }
+    }
+    graph_csr_free(reverse);
+    free(parent);
+    free(depth);
+}
+
+static void print_mst_edges(graph_t *g, const kruskal_edge_t *edges, size_t count) {
+    printf("\nMST边:\n");
+    size_t shown = count < PRINT_LIMIT ? count : PRINT_LIMIT;
+    for (size_t i = 0; i < shown; i++) {
+        printf("  %s --%d--> %s\n",
+               graph_node_name(g, edges[i].u), edges[i].w, graph_node_name(g, edges[i].v));
+    }
+    if (shown < count) printf("  ... (其余 %zu 条省略)\n", count - shown);
+}
+
+// 边数较多时用线程池上的 Boruvka, 小图用排序 Kruskal
+static void run_kruskal(graph_t *g, threadpool_t *pool, bool verbose) {
+    printf("\n");
+    term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
+    term_printf(TERM_ANSI_CYAN, "                    Kruskal 最小生成树算法                        \n");
+    term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
     
-    if (total_weight < 0) {
-        term_printf(TERM_ANSI_RED, "算法执行失败: 图可能不连通\n");
+    kruskal_error_t error;
+    kruskal_result_t *result = g->csr->edges > 100000 ? kruskal_boruvka_csr(g->csr, pool, &error)
+                                                      : kruskal_mst_csr(g->csr, &error);
+    if (!result) {
+        term_printf(TERM_ANSI_RED, "算法执行失败\n");
         return;
     }
     
     printf("\n最小生成树:\n");
     printf("────────────────────────────────────────────────────────────────\n");
     printf("  总权重: ");
-    term_printf(TERM_ANSI_GREEN, "%d\n", total_weight);
-    
-    print_graph_ascii(g, NULL, 0, -1, -1);
+    term_printf(TERM_ANSI_GREEN, "%d\n", result->total_weight);
+    printf("  边数: %zu\n", result->edge_count);
+    if (result->has_error) {
+        term_printf(TERM_ANSI_YELLOW, "  图不连通, 结果为最小生成森林\n");
+    }
+    if (verbose) {
+        print_mst_edges(g, result->edges, result->edge_count);
+    }
+    kruskal_free_result(result);
 }
 
 static void run_prim(graph_t *g, bool verbose) {
@@ -387,26 +488,8 @@ static void run_prim(graph_t *g, bool verbose) {
     term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
     
     prim_error_t error;
-    prim_config_t config = prim_default_config();
-    config.compute_edges = true;
-    
-    prim_graph_t *pg = prim_graph_create(g->node_count, &config, &error);
-    if (!pg) {
-        term_printf(TERM_ANSI_RED, "创建图失败\n");
-        return;
-    }
-    
-    for (int i = 0; i < g->edge_count; i++) {
-        prim_graph_add_edge(pg, g->edges[i].from, g->edges[i].to, 
-                           g->edges[i].weight, &error);
-        if (!g->directed) {
-            prim_graph_add_edge(pg, g->edges[i].to, g->edges[i].from, 
-                               g->edges[i].weight, &error);
-        }
-    }
-    
     prim_result_t result;
-    if (prim_mst_ex(pg, &result, &error)) {
+    if (prim_mst_csr(g->csr, &result, &error)) {
         printf("\n最小生成树:\n");
         printf("────────────────────────────────────────────────────────────────\n");
         printf("  总权重: ");
@@ -415,18 +498,19 @@ static void run_prim(graph_t *g, bool verbose) {
         printf("  连通性: %s\n", result.connected ? "连通" : "不连通");
         
         printf("\nMST边:\n");
-        for (size_t i = 0; i < result.edge_count; i++) {
+        size_t shown = verbose || result.edge_count <= PRINT_LIMIT ? result.edge_count : PRINT_LIMIT;
+        if (shown > PRINT_LIMIT) shown = PRINT_LIMIT;
+        for (size_t i = 0; i < shown; i++) {
             prim_edge_t *e = &result.edges[i];
             printf("  %s --%d--> %s\n", 
-                   g->nodes[e->src].name, e->weight, g->nodes[e->dest].name);
+                   graph_node_name(g, e->src), e->weight, graph_node_name(g, e->dest));
         }
+        if (shown < result.edge_count) printf("  ... (其余 %zu 条省略)\n", result.edge_count - shown);
         
         prim_result_free(&result);
     } else {
         term_printf(TERM_ANSI_RED, "算法执行失败\n");
     }
-    
-    prim_graph_destroy(pg);
 }
 
 static void run_tarjan(graph_t *g, bool verbose) {
@@ -435,32 +519,44 @@ static void run_tarjan(graph_t *g, bool verbose) {
     term_printf(TERM_ANSI_CYAN, "                    Tarjan 强连通分量算法                         \n");
     term_printf(TERM_ANSI_CYAN, "════════════════════════════════════════════════════════════════\n");
     
-    tarjan_graph_t tg;
-    memset(&tg, 0, sizeof(tg));
-    tg.n = g->node_count;
-    
-    for (int i = 0; i < g->edge_count; i++) {
-        int from = g->edges[i].from;
-        int to = g->edges[i].to;
-        tg.adj[from][tg.adj_size[from]++] = to;
+    int *scc_map = malloc((size_t)g->node_count * sizeof(int));
+    int scc_count = scc_map ? tarjan_scc_csr(g->csr, scc_map) : -1;
+    if (scc_count < 0) {
+        term_printf(TERM_ANSI_RED, "算法执行失败\n");
+        free(scc_map);
+        return;
     }
     
-    int scc_map[MAX_NODES];
-    int scc_count = tarjan_scc(&tg, scc_map);
-    
     printf("\n强连通分量数量: ");
     term_printf(TERM_ANSI_GREEN, "%d\n", scc_count);
     printf("────────────────────────────────────────────────────────────────\n");
     
-    for (int scc = 0; scc < scc_count; scc++) {
-        printf("\nSCC %d: ", scc + 1);
-        for (int i = 0; i < g->node_count; i++) {
-            if (scc_map[i] == scc) {
-                term_printf(TERM_ANSI_GREEN, "%s ", g->nodes[i].name);
+    // 按分量计数排序, 每个分量的成员连续存放
+    int *start = calloc((size_t)scc_count + 1, sizeof(int));
+    int *members = malloc((size_t)g->node_count * sizeof(int));
+    if (start && members) {
+        for (int i = 0; i < g->node_count; i++) start[scc_map[i] + 1]++;
+        for (int c = 0; c < scc_count; c++) start[c + 1] += start[c];
+        for (int i = 0; i < g->node_count; i++) members[start[scc_map[i]]++] = i;
+        for (int c = scc_count; c > 0; c--) start[c] = start[c - 1];
+        start[0] = 0;
+        
+        int shown = verbose || scc_count <= PRINT_LIMIT ? scc_count : PRINT_LIMIT;
+        if (shown > PRINT_LIMIT) shown = PRINT_LIMIT;
+        for (int scc = 0; scc < shown; scc++) {
+            int size = start[scc + 1] - start[scc];
+            printf("\nSCC %d (%d 个节点): ", scc + 1, size);
+            for (int k = 0; k < size && k < PRINT_LIMIT; k++) {
+                term_printf(TERM_ANSI_GREEN, "%s ", graph_node_name(g, members[start[scc] + k]));
             }
+            if (size > PRINT_LIMIT) printf("...");
         }
         printf("\n");
+        if (shown < scc_count) printf("... (其余 %d 个分量省略)\n", scc_count - shown);
     }
+    free(start);
+    free(members);
+    free(scc_map);
     
     if (scc_count == 1) {
         printf("\n");
@@ -485,6 +581,7 @@ static void create_demo_graph(graph_t *g) {
     graph_add_edge(g, 3, 4, 2);
     graph_add_edge(g, 3, 5, 6);
     graph_add_edge(g, 4, 5, 3);
+    graph_finish(g);
 }
 
 static void print_help(const char *prog) {
@@ -499,10 +596,13 @@ static void print_help(const char *prog) {
     printf("  info        显示图信息\n\n");
     
     printf("选项:\n");
-    printf("  -a, --algorithm <name>   算法名称 (dijkstra, kruskal, prim, tarjan)\n");
+    printf("  -a, --algorithm <name>   算法名称 (dijkstra, bellman_ford, bfs, kruskal, prim, tarjan)\n");
     printf("  -s, --start <node>       起始节点 (用于Dijkstra)\n");
     printf("  -e, --end <node>         目标节点 (用于Dijkstra)\n");
     printf("  -f, --file <path>        图文件路径 (JSON格式)\n");
+    printf("  -l, --edges <path>       文本边列表文件 (每行 \"src dst [weight]\", 节点按编号命名)\n");
+    printf("  -d, --directed           边列表按有向图加载\n");
+    printf("  -j, --threads <n>        并行算法的线程数 (默认 CPU 核心数)\n");
     printf("  -v, --verbose            详细输出\n");
     printf("  -h, --help               显示帮助信息\n\n");
     
@@ -511,6 +611,7 @@ static void print_help(const char *prog) {
     printf("  %s run -a dijkstra -s A -e E      # 运行Dijkstra算法\n", prog);
     printf("  %s run -a kruskal                 # 运行Kruskal算法\n", prog);
     printf("  %s run -f graph.json -a prim      # 从文件加载图并运行Prim算法\n", prog);
+    printf("  %s run -l roads.txt -a bfs -s 0 -e 9999  # 大规模边列表上的并行BFS\n", prog);
 }
 
 int main(int argc, char **argv) {
@@ -530,6 +631,9 @@ int main(int argc, char **argv) {
     const char *start_node = "A";
     const char *end_node = "E";
     const char *graph_file = NULL;
+    const char *edge_file = NULL;
+    bool directed = false;
+    int threads = 0;
     bool verbose = false;
     
     for (int i = 2; i < argc; i++) {
@@ -541,6 +645,12 @@ int main(int argc, char **argv) {
             if (i + 1 < argc) end_node = argv[++i];
         } else if (strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--file") == 0) {
             if (i + 1 < argc) graph_file = argv[++i];
+        } else if (strcmp(argv[i], "-l") == 0 || strcmp(argv[i], "--edges") == 0) {
+            if (i + 1 < argc) edge_file = argv[++i];
+        } else if (strcmp(argv[i], "-d") == 0 || strcmp(argv[i], "--directed") == 0) {
+            directed = true;
+        } else if (strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--threads") == 0) {
+            if (i + 1 < argc) threads = atoi(argv[++i]);
         } else if (strcmp(argv[i], "-v") == 0 || strcmp(argv[i], "--verbose") == 0) {
             verbose = true;
         }
@@ -548,7 +658,15 @@ int main(int argc, char **argv) {
     
     graph_t graph;
     
-    if (graph_file) {
+    if (edge_file) {
+        if (!graph_load_edge_list(&graph, edge_file, directed)) {
+            fprintf(stderr, "错误: 无法加载边列表 %s\n", edge_file);
+            return 1;
+        }
+        printf("已加载边列表: %s\n", edge_file);
+        if (strcmp(start_node, "A") == 0) start_node = "0";
+        if (strcmp(end_node, "E") == 0) end_node = "1";
+    } else if (graph_file) {
         if (!graph_load_json(&graph, graph_file)) {
             fprintf(stderr, "错误: 无法加载图文件 %s\n", graph_file);
             return 1;
@@ -566,6 +684,9 @@ int main(int argc, char **argv) {
     
     print_graph_ascii(&graph, NULL, 0, -1, -1);
     
+    threadpool_t *pool = threadpool_create(threads);
+    int status = 0;
+    
     if (strcmp(command, "demo") == 0) {
         int src = graph_find_node(&graph, start_node);
         int dst = graph_find_node(&graph, end_node);
@@ -573,33 +694,35 @@ int main(int argc, char **argv) {
         if (src >= 0 && dst >= 0) {
             run_dijkstra(&graph, src, dst, verbose);
         }
-        run_kruskal(&graph, verbose);
+        run_kruskal(&graph, pool, verbose);
         run_prim(&graph, verbose);
         run_tarjan(&graph, verbose);
         
     } else if (strcmp(command, "run") == 0) {
         if (!algorithm) {
             fprintf(stderr, "错误: 请指定算法名称 (-a)\n");
-            return 1;
-        }
-        
-        if (strcmp(algorithm, "dijkstra") == 0) {
+            status = 1;
+        } else if (strcmp(algorithm, "dijkstra") == 0 || strcmp(algorithm, "bellman_ford") == 0 ||
+                   strcmp(algorithm, "bfs") == 0) {
             int src = graph_find_node(&graph, start_node);
             int dst = graph_find_node(&graph, end_node);
             
             if (src < 0) {
                 fprintf(stderr, "错误: 找不到起始节点 %s\n", start_node);
-                return 1;
-            }
-            if (dst < 0) {
+                status = 1;
+            } else if (dst < 0) {
                 fprintf(stderr, "错误: 找不到目标节点 %s\n", end_node);
-                return 1;
+                status = 1;
+            } else if (strcmp(algorithm, "dijkstra") == 0) {
+                run_dijkstra(&graph, src, dst, verbose);
+            } else if (strcmp(algorithm, "bellman_ford") == 0) {
+                run_bellman_ford(&graph, src, dst, pool, verbose);
+            } else {
+                run_bfs(&graph, src, dst, pool, verbose);
             }
             
-            run_dijkstra(&graph, src, dst, verbose);
-            
         } else if (strcmp(algorithm, "kruskal") == 0) {
-            run_kruskal(&graph, verbose);
+            run_kruskal(&graph, pool, verbose);
             
         } else if (strcmp(algorithm, "prim") == 0) {
             run_prim(&graph, verbose);
@@ -609,7 +732,7 @@ int main(int argc, char **argv) {
             
         } else {
             fprintf(stderr, "错误: 未知算法 '%s'\n", algorithm);
-            return 1;
+            status = 1;
         }
         
     } else if (strcmp(command, "info") == 0) {
@@ -617,13 +740,15 @@ int main(int argc, char **argv) {
         printf("────────────────────────────────────────────────────────────────\n");
         printf("  类型: %s\n", graph.directed ? "有向图" : "无向图");
         printf("  节点数: %d\n", graph.node_count);
-        printf("  边数: %d\n", graph.edge_count);
+        printf("  边数: %zu\n", graph.edge_count);
         
     } else {
         fprintf(stderr, "错误: 未知命令 '%s'\n", command);
         print_help(argv[0]);
-        return 1;
+        status = 1;
     }
     
-    return 0;
+    if (pool) threadpool_destroy(pool);
+    graph_free(&graph);
+    return status;
 }
@@ -15,6 +15,7 @@
 #include "terminal.h"
 #include "json.h"
 #include "fs_utils.h"
+#include "slab_alloc.h"
 
 #define DEFAULT_PORT "5672"
 #define MAX_QUEUE_NAME 128
@@ -110,8 +111,8 @@ static uint64_t get_current_time_ms(void) {
 static void free_message(void *data) {
     if (data) {
         message_t *msg = (message_t*)data;
-        if (msg->body) free(msg->body);
-        free(msg);
+        slab_free(msg->body);
+        slab_free(msg);
     }
 }
 
@@ -188,15 +189,16 @@ static int compare_message_priority(const void *a, const void *b) {
 static message_t* create_message(const char *queue_name, const char *body, size_t body_len,
                                  uint8_t priority, uint32_t ttl, const char *content_type,
                                  const char *correlation_id, const char *reply_to) {
-    message_t *msg = calloc(1, sizeof(message_t));
+    // 消息与消息体由各工作线程频繁创建/释放, 走 slab 分配器的线程缓存
+    message_t *msg = slab_calloc(1, sizeof(message_t));
     if (!msg) return NULL;
     
     msg->id = __sync_fetch_and_add(&g_mq.next_message_id, 1);
     strncpy(msg->queue_name, queue_name, MAX_QUEUE_NAME - 1);
     
-    msg->body = malloc(body_len + 1);
+    msg->body = slab_alloc(body_len + 1);
     if (!msg->body) {
-        free(msg);
+        slab_free(msg);
         return NULL;
     }
     memcpy(msg->body, body, body_len);
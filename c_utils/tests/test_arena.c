@@ -192,6 +192,39 @@ void test_arena_edge_case_zero_size() {
     arena_destroy(arena);
 }
 
+void test_arena_huge_pages() {
+    TEST(Arena_HugePages);
+    arena_config_t config = arena_default_config();
+    config.huge_pages = true;
+    config.prefault = true;
+    arena_t* arena = arena_create_ex(&config);
+    EXPECT_TRUE(arena != NULL);
+
+    // 块按 2MB 取整: 小块请求也得到接近 2MB 的可用空间
+    size_t huge = page_alloc_get_huge_page_size();
+    for (int i = 0; i < 1000; i++) {
+        char* p = arena_alloc(arena, 1024);
+        EXPECT_TRUE(p != NULL);
+        memset(p, i & 0xFF, 1024);
+    }
+    EXPECT_EQ(arena_chunk_count(arena), (size_t)1);
+
+    // 超过一块的分配单独成块
+    char* big = arena_alloc(arena, 3 * huge);
+    EXPECT_TRUE(big != NULL);
+    memset(big, 1, 3 * huge);
+    EXPECT_EQ(arena_chunk_count(arena), (size_t)2);
+    EXPECT_TRUE(arena_contains(arena, big + 3 * huge - 1));
+
+    arena_reset(arena);
+    EXPECT_EQ(arena_chunk_count(arena), (size_t)1);
+    arena_destroy(arena);
+
+    page_alloc_stats_t stats;
+    page_alloc_get_stats(&stats, NULL);
+    EXPECT_EQ(stats.mapped_allocated, (size_t)0);
+}
+
 int main() {
     test_arena_create();
     test_arena_create_default();
@@ -208,6 +241,7 @@ int main() {
     test_arena_stress_many_allocations();
     test_arena_destroy_null();
     test_arena_edge_case_zero_size();
+    test_arena_huge_pages();
 
     return 0;
 }
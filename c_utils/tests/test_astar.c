@@ -1,8 +1,10 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/astar.h"
+#include "../c_utils/dijkstra.h"
 
 static bool simple_is_walkable(void *world, point_t pos) {
     (void)world;
@@ -67,6 +69,207 @@ void test_astar_search_simple() {
     }
 }
 
+void test_astar_grid_open() {
+    TEST(Astar_GridOpen);
+    astar_grid_t *grid8 = astar_grid_create(20, 20, ASTAR_GRID_8);
+    astar_grid_t *grid4 = astar_grid_create(20, 20, ASTAR_GRID_4);
+    astar_result_t result = {0};
+    point_t start = {0, 0};
+    point_t goal = {5, 8};
+
+    EXPECT_TRUE(astar_grid_search(grid8, start, goal, ASTAR_GRID_ASTAR, &result));
+    EXPECT_EQ(result.cost, 5 * 14 + 3 * 10);
+    EXPECT_EQ((int)result.path_len, 9);
+    EXPECT_TRUE(result.path[0].x == 0 && result.path[0].y == 0);
+    EXPECT_TRUE(result.path[8].x == 5 && result.path[8].y == 8);
+
+    EXPECT_TRUE(astar_grid_search(grid8, start, goal, ASTAR_GRID_JPS, &result));
+    EXPECT_EQ(result.cost, 5 * 14 + 3 * 10);
+    EXPECT_EQ((int)result.path_len, 9);
+
+    EXPECT_TRUE(astar_grid_search(grid4, start, goal, ASTAR_GRID_ASTAR, &result));
+    EXPECT_EQ(result.cost, 13 * 10);
+    EXPECT_EQ((int)result.path_len, 14);
+
+    // 起点即终点
+    EXPECT_TRUE(astar_grid_search(grid8, goal, goal, ASTAR_GRID_JPS, &result));
+    EXPECT_EQ(result.cost, 0);
+    EXPECT_EQ((int)result.path_len, 1);
+
+    // 越界、障碍
+    EXPECT_FALSE(astar_grid_set_cost(grid8, 20, 0, 1));
+    EXPECT_FALSE(astar_grid_set_cost(grid8, 0, 0, 256));
+    EXPECT_TRUE(astar_grid_set_cost(grid8, 5, 8, 0));
+    EXPECT_FALSE(astar_grid_is_walkable(grid8, 5, 8));
+    EXPECT_FALSE(astar_grid_search(grid8, start, goal, ASTAR_GRID_ASTAR, &result));
+    EXPECT_FALSE(result.found);
+
+    free(result.path);
+    astar_grid_free(grid8);
+    astar_grid_free(grid4);
+}
+
+void test_astar_grid_wall() {
+    TEST(Astar_GridWall);
+    // 竖墙只在底部留一个口, 且八方向不允许从墙角斜穿
+    astar_grid_t *grid = astar_grid_create(10, 10, ASTAR_GRID_8);
+    for (int y = 0; y < 9; y++) astar_grid_set_cost(grid, 5, y, 0);
+    astar_result_t result = {0};
+    point_t start = {0, 0};
+    point_t goal = {9, 0};
+
+    EXPECT_TRUE(astar_grid_search(grid, start, goal, ASTAR_GRID_JPS, &result));
+    int jps_cost = result.cost;
+    EXPECT_TRUE(astar_grid_search(grid, start, goal, ASTAR_GRID_ASTAR, &result));
+    EXPECT_EQ(result.cost, jps_cost);
+    bool through_gap = false;
+    for (size_t i = 0; i < result.path_len; i++) {
+        if (result.path[i].x == 5) through_gap = result.path[i].y == 9;
+    }
+    EXPECT_TRUE(through_gap);
+
+    // 完全封死
+    astar_grid_set_cost(grid, 5, 9, 0);
+    EXPECT_FALSE(astar_grid_search(grid, start, goal, ASTAR_GRID_JPS, &result));
+    EXPECT_FALSE(astar_grid_search(grid, start, goal, ASTAR_GRID_ASTAR, &result));
+
+    free(result.path);
+    astar_grid_free(grid);
+}
+
+// 检查路径逐格相邻、不切角, 并按移动规则累加代价
+static int grid_path_cost(const astar_grid_t *grid, const astar_result_t *result, bool eight) {
+    int total = 0;
+    for (size_t i = 1; i < result->path_len; i++) {
+        point_t a = result->path[i - 1];
+        point_t b = result->path[i];
+        int ddx = abs(a.x - b.x);
+        int ddy = abs(a.y - b.y);
+        if (ddx > 1 || ddy > 1 || ddx + ddy == 0) return -1;
+        if (!astar_grid_is_walkable(grid, b.x, b.y)) return -1;
+        if (ddx + ddy == 2) {
+            if (!eight || !astar_grid_is_walkable(grid, a.x, b.y) || !astar_grid_is_walkable(grid, b.x, a.y)) return -1;
+            total += 14 * astar_grid_get_cost(grid, b.x, b.y);
+        } else {
+            total += 10 * astar_grid_get_cost(grid, b.x, b.y);
+        }
+    }
+    return total;
+}
+
+// 随机网格上与 CSR Dijkstra 的结果对比
+static void check_random_grid(int W, int H, astar_grid_moves_t moves, bool weighted, unsigned seed) {
+    enum { QUERIES = 40 };
+    astar_grid_t *grid = astar_grid_create(W, H, moves);
+    int density = seed & 1 ? 28 : 10;
+    srand(seed);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            int r = rand() % 100;
+            astar_grid_set_cost(grid, x, y, r < density ? 0 : (weighted ? 1 + r % 5 : 1));
+        }
+    }
+
+    bool eight = moves == ASTAR_GRID_8;
+    graph_csr_builder_t *b = graph_csr_builder_create(W * H);
+    for (int y = 0; y < H; y++) {
+        for (int x = 0; x < W; x++) {
+            if (!astar_grid_is_walkable(grid, x, y)) continue;
+            for (int ny = y - 1; ny <= y + 1; ny++) {
+                for (int nx = x - 1; nx <= x + 1; nx++) {
+                    bool diagonal = nx != x && ny != y;
+                    if ((nx == x && ny == y) || !astar_grid_is_walkable(grid, nx, ny)) continue;
+                    if (diagonal && (!eight || !astar_grid_is_walkable(grid, nx, y) || !astar_grid_is_walkable(grid, x, ny))) continue;
+                    graph_csr_builder_add_edge(b, y * W + x, ny * W + nx,
+                                               (diagonal ? 14 : 10) * astar_grid_get_cost(grid, nx, ny));
+                }
+            }
+        }
+    }
+    graph_csr_t *g = graph_csr_builder_build(b);
+    int *dist = malloc(W * H * sizeof(int));
+
+    astar_result_t result = {0};
+    bool ok = true;
+    int found = 0;
+    int astar_expanded = 0;
+    int jps_expanded = 0;
+    for (int q = 0; q < QUERIES; q++) {
+        point_t s, t;
+        do {
+            s = (point_t){ rand() % W, rand() % H };
+        } while (!astar_grid_is_walkable(grid, s.x, s.y));
+        do {
+            t = (point_t){ rand() % W, rand() % H };
+        } while (!astar_grid_is_walkable(grid, t.x, t.y));
+        dijkstra_csr(g, s.y * W + s.x, -1, dist, NULL, NULL);
+        int expect = dist[t.y * W + t.x];
+
+        bool has = astar_grid_search(grid, s, t, ASTAR_GRID_ASTAR, &result);
+        int astar_cost = result.cost;
+        astar_expanded += result.nodes_expanded;
+        if (has) {
+            found++;
+            ok = ok && grid_path_cost(grid, &result, eight) == astar_cost;
+        }
+        ok = ok && has == (expect != INT_MAX) && (!has || astar_cost == expect);
+
+        has = astar_grid_search(grid, s, t, ASTAR_GRID_JPS, &result);
+        jps_expanded += result.nodes_expanded;
+        ok = ok && has == (expect != INT_MAX) && (!has || result.cost == expect);
+        if (has) ok = ok && grid_path_cost(grid, &result, eight) == result.cost;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(found > 0);
+    if (eight && !weighted) EXPECT_TRUE(jps_expanded < astar_expanded);
+
+    free(dist);
+    free(result.path);
+    graph_csr_free(g);
+    graph_csr_builder_free(b);
+    astar_grid_free(grid);
+}
+
+void test_astar_grid_random() {
+    TEST(Astar_GridRandom);
+    check_random_grid(60, 45, ASTAR_GRID_8, false, 1);
+    // 宽高跨过多个 64 位字, JPS 按字扫描时要处理字边界
+    check_random_grid(150, 130, ASTAR_GRID_8, false, 2);
+    check_random_grid(128, 64, ASTAR_GRID_8, false, 3);
+    check_random_grid(60, 45, ASTAR_GRID_4, false, 4);
+    // 有代价倍数时 JPS 退化为普通 A*
+    check_random_grid(60, 45, ASTAR_GRID_8, true, 5);
+    check_random_grid(60, 45, ASTAR_GRID_4, true, 6);
+}
+
+void test_astar_grid_reuse() {
+    TEST(Astar_GridReuse);
+    astar_grid_t *grid = astar_grid_create(64, 64, ASTAR_GRID_8);
+    astar_result_t result = {0};
+    EXPECT_TRUE(astar_grid_search(grid, (point_t){0, 0}, (point_t){63, 63}, ASTAR_GRID_ASTAR, &result));
+    point_t *buffer = result.path;
+    size_t capacity = result.path_capacity;
+    EXPECT_EQ((int)result.path_len, 64);
+
+    // 较短的查询复用同一块缓冲区, 也不会读到上次查询残留的 g 值
+    bool ok = true;
+    for (int i = 0; i < 300; i++) {
+        point_t s = { i % 64, (i * 7) % 64 };
+        point_t t = { (i * 13) % 64, (i * 29) % 64 };
+        astar_grid_mode_t mode = (i & 1) ? ASTAR_GRID_JPS : ASTAR_GRID_ASTAR;
+        ok = ok && astar_grid_search(grid, s, t, mode, &result);
+        int ddx = abs(s.x - t.x), ddy = abs(s.y - t.y);
+        int lo = ddx < ddy ? ddx : ddy, hi = ddx < ddy ? ddy : ddx;
+        ok = ok && result.cost == lo * 14 + (hi - lo) * 10;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(result.path == buffer);
+    EXPECT_EQ((int)result.path_capacity, (int)capacity);
+
+    free(result.path);
+    astar_grid_free(grid);
+}
+
 int main() {
     test_astar_heuristic_manhattan();
     test_astar_heuristic_euclidean();
@@ -74,6 +277,10 @@ int main() {
     test_astar_heuristic_chebyshev();
     test_astar_result_create_free();
     test_astar_search_simple();
+    test_astar_grid_open();
+    test_astar_grid_wall();
+    test_astar_grid_random();
+    test_astar_grid_reuse();
 
     return 0;
 }
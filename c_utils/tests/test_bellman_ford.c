@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/bellman_ford.h"
 
@@ -86,12 +87,63 @@ void test_bellman_ford_reconstruct_path() {
     EXPECT_TRUE(path_len > 0);
 }
 
+void test_bellman_ford_csr() {
+    TEST(BellmanFord_Csr);
+    enum { N = 500, M = 3000 };
+    bf_edge_t *edges = malloc(M * sizeof(bf_edge_t));
+    int src[M], dst[M], w[M];
+    unsigned seed = 31;
+    for (int i = 0; i < M; i++) {
+        seed = seed * 1103515245u + 12345u;
+        src[i] = (int)((seed >> 8) % N);
+        seed = seed * 1103515245u + 12345u;
+        dst[i] = (int)((seed >> 8) % N);
+        // 只有 src < dst 的边可以为负, 反向边权足够大, 不会形成负环
+        w[i] = src[i] < dst[i] ? (int)((seed >> 4) % 100) - 30 : 100000 + (int)((seed >> 4) % 100);
+        edges[i] = (bf_edge_t){ src[i], dst[i], w[i] };
+    }
+    graph_csr_t *g = graph_csr_from_edges(N, src, dst, w, M);
+    int ref[N], dist[N], pred[N];
+    EXPECT_FALSE(bellman_ford(N, M, edges, 0, ref));
+
+    threadpool_t *pool = threadpool_create(4);
+    bool ok = true;
+    for (int round = 0; round < 2; round++) {
+        ok = ok && !bellman_ford_csr(g, 0, dist, pred, round ? pool : NULL);
+        for (int v = 0; v < N; v++) {
+            ok = ok && dist[v] == ref[v];
+            // 前驱边与距离一致
+            if (v != 0 && dist[v] != INT_MAX) {
+                bool found = false;
+                for (int i = 0; i < M; i++) found = found || (src[i] == pred[v] && dst[i] == v && dist[pred[v]] + w[i] == dist[v]);
+                ok = ok && found;
+            }
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    // 加入一条从源点可达的负环
+    int csrc[] = { 0, 1, 2, 3 };
+    int cdst[] = { 1, 2, 3, 1 };
+    int cw[]   = { 4, 1, -3, 1 };
+    graph_csr_t *cyc = graph_csr_from_edges(5, csrc, cdst, cw, 4);
+    EXPECT_TRUE(bellman_ford_csr(cyc, 0, dist, NULL, pool));
+    EXPECT_FALSE(bellman_ford_csr(cyc, 4, dist, NULL, pool));
+    EXPECT_TRUE(dist[4] == 0 && dist[1] == INT_MAX);
+
+    threadpool_destroy(pool);
+    graph_csr_free(cyc);
+    graph_csr_free(g);
+    free(edges);
+}
+
 int main() {
     test_bellman_ford_basic();
     test_bellman_ford_negative_cycle();
     test_bellman_ford_validate_input();
     test_bellman_ford_with_path();
     test_bellman_ford_reconstruct_path();
+    test_bellman_ford_csr();
 
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/bigint.h"
 
@@ -213,6 +214,244 @@ void test_bigint_stress_operations() {
     bigint_free(a);
 }
 
+void test_bigint_negative() {
+    TEST(Bigint_Negative);
+    bigint_t* a = bigint_from_str("-12345678901234567890123");
+    bigint_t* b = bigint_from_str("1000");
+    EXPECT_TRUE(a != NULL && bigint_sign(a) < 0);
+
+    char* str = bigint_to_str(a);
+    EXPECT_TRUE(strcmp(str, "-12345678901234567890123") == 0);
+    free(str);
+
+    bigint_t* c = bigint_add(a, b);
+    str = bigint_to_str(c);
+    EXPECT_TRUE(strcmp(str, "-12345678901234567889123") == 0);
+    free(str);
+
+    // bigint_sub 保持 a < b 返回 NULL 的约定, bigint_sub_signed 给出负数
+    bigint_t* d = bigint_sub(b, c);
+    EXPECT_TRUE(d != NULL);
+    bigint_free(d);
+    d = bigint_sub(c, b);
+    EXPECT_TRUE(d == NULL);
+    d = bigint_sub_signed(b, a);
+    str = bigint_to_str(d);
+    EXPECT_TRUE(strcmp(str, "12345678901234567891123") == 0);
+    free(str);
+
+    EXPECT_TRUE(bigint_compare(a, b) < 0);
+    EXPECT_TRUE(bigint_compare(a, c) < 0);
+    bigint_t* e = bigint_from_str("-0");
+    EXPECT_TRUE(bigint_is_zero(e) && bigint_sign(e) == 0);
+    EXPECT_TRUE(bigint_from_str("-") == NULL);
+    EXPECT_TRUE(bigint_from_str("12a") == NULL);
+
+    bigint_free(a);
+    bigint_free(b);
+    bigint_free(c);
+    bigint_free(d);
+    bigint_free(e);
+}
+
+// n 个 limb 的伪随机数, 最高位为 1
+static bigint_t* random_bigint(size_t n, uint64_t seed) {
+    bigint_t* one = bigint_one();
+    bigint_t* r = bigint_shl(one, 64 * n - 1);
+    bigint_free(one);
+    uint64_t x = seed * 0x9E3779B97F4A7C15ULL + 1;
+    for (size_t i = 0; i < n; i++) {
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        r->limbs[i] ^= x;
+    }
+    r->limbs[n - 1] |= 1ULL << 63;
+    return r;
+}
+
+// (10^n - 1)^2 = 99..9800..01, 覆盖 schoolbook、Karatsuba、Toom-3 和 NTT 以及十进制分治转换
+void test_bigint_mul_algorithms() {
+    TEST(Bigint_MulAlgorithms);
+    size_t sizes[] = { 30, 700, 3000, 12000, 80000 };
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        size_t n = sizes[k];
+        char* nines = malloc(n + 1);
+        memset(nines, '9', n);
+        nines[n] = '\0';
+        bigint_t* a = bigint_from_str(nines);
+        bigint_t* sq = bigint_mul(a, a);
+        char* str = bigint_to_str(sq);
+
+        char* expect = malloc(2 * n + 1);
+        memset(expect, '9', n - 1);
+        expect[n - 1] = '8';
+        memset(expect + n, '0', n - 1);
+        expect[2 * n - 1] = '1';
+        expect[2 * n] = '\0';
+        EXPECT_TRUE(str != NULL && strcmp(str, expect) == 0);
+
+        free(nines);
+        free(expect);
+        free(str);
+        bigint_free(a);
+        bigint_free(sq);
+    }
+
+    // 不等长和随机操作数: (a + 1) * b - a * b == b
+    size_t shapes[][2] = { { 40, 33 }, { 500, 170 }, { 2000, 2000 }, { 9000, 3600 }, { 5000, 7 } };
+    for (size_t k = 0; k < sizeof(shapes) / sizeof(shapes[0]); k++) {
+        bigint_t* a = random_bigint(shapes[k][0], k);
+        bigint_t* b = random_bigint(shapes[k][1], k + 100);
+        bigint_t* one = bigint_one();
+        bigint_t* a1 = bigint_add(a, one);
+        bigint_t* p = bigint_mul(a, b);
+        bigint_t* p1 = bigint_mul(a1, b);
+        bigint_t* d = bigint_sub(p1, p);
+        EXPECT_TRUE(d != NULL && bigint_compare(d, b) == 0);
+        EXPECT_EQ((int)bigint_bit_length(p) >= (int)(64 * (shapes[k][0] + shapes[k][1]) - 1), 1);
+        bigint_free(a);
+        bigint_free(b);
+        bigint_free(one);
+        bigint_free(a1);
+        bigint_free(p);
+        bigint_free(p1);
+        bigint_free(d);
+    }
+}
+
+// a == q * b + r, |r| < |b|, r 与 a 同号; 覆盖 Knuth 和 Burnikel-Ziegler 两条路径
+void test_bigint_divmod() {
+    TEST(Bigint_Divmod);
+    size_t shapes[][2] = { { 3, 1 }, { 5, 2 }, { 40, 17 }, { 900, 300 }, { 3000, 1000 }, { 2500, 2400 } };
+    bool ok = true;
+    for (size_t k = 0; k < sizeof(shapes) / sizeof(shapes[0]); k++) {
+        for (int signs = 0; signs < 4; signs++) {
+            bigint_t* a = random_bigint(shapes[k][0], 7 * k + 1);
+            bigint_t* b = random_bigint(shapes[k][1], 7 * k + 2);
+            // 除数高位偏小, 使估商经常需要修正
+            b->limbs[b->len - 1] >>= 17 * (k % 3);
+            a->neg = signs & 1;
+            b->neg = (signs >> 1) & 1;
+            bigint_t *q, *r;
+            ok = ok && bigint_divmod(a, b, &q, &r);
+            bigint_t* qb = bigint_mul(q, b);
+            bigint_t* back = bigint_add(qb, r);
+            ok = ok && bigint_compare(back, a) == 0;
+            bigint_t* rabs = bigint_copy(r);
+            bigint_t* babs = bigint_copy(b);
+            rabs->neg = babs->neg = false;
+            ok = ok && bigint_compare(rabs, babs) < 0;
+            ok = ok && (bigint_is_zero(r) || r->neg == a->neg);
+            bigint_free(a);
+            bigint_free(b);
+            bigint_free(q);
+            bigint_free(r);
+            bigint_free(qb);
+            bigint_free(back);
+            bigint_free(rabs);
+            bigint_free(babs);
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    bigint_t* a = bigint_from_str("100");
+    bigint_t* b = bigint_from_str("-7");
+    bigint_t* q = bigint_div(a, b);
+    bigint_t* r = bigint_mod(a, b);
+    char* qs = bigint_to_str(q);
+    char* rs = bigint_to_str(r);
+    EXPECT_TRUE(strcmp(qs, "-14") == 0 && strcmp(rs, "2") == 0);
+    bigint_free(q);
+    bigint_t* zero = bigint_zero();
+    q = bigint_div(zero, b);
+    EXPECT_TRUE(bigint_is_zero(q));
+    bigint_free(q);
+    EXPECT_FALSE(bigint_divmod(a, zero, &q, NULL));
+    EXPECT_TRUE(q == NULL);
+    free(qs);
+    free(rs);
+    bigint_free(a);
+    bigint_free(b);
+    bigint_free(r);
+    bigint_free(zero);
+}
+
+void test_bigint_powmod() {
+    TEST(Bigint_Powmod);
+    bigint_t* base = bigint_from_str("4");
+    bigint_t* e = bigint_from_str("13");
+    bigint_t* m = bigint_from_str("497");
+    bigint_t* r = bigint_powmod(base, e, m);
+    char* str = bigint_to_str(r);
+    EXPECT_TRUE(strcmp(str, "445") == 0);
+    free(str);
+    bigint_free(r);
+
+    // 费马小定理: p = 2^521 - 1 是素数, a^(p-1) mod p == 1
+    bigint_t* one = bigint_one();
+    bigint_t* p = bigint_shl(one, 521);
+    bigint_t* p_1 = bigint_sub(p, one);
+    bigint_free(p);
+    p = p_1;
+    bigint_t* pm1 = bigint_sub(p, one);
+    bigint_t* a = bigint_from_str("-123456789123456789123456789");
+    r = bigint_powmod(a, pm1, p);
+    EXPECT_TRUE(r != NULL && bigint_compare(r, one) == 0);
+    bigint_free(r);
+
+    // 偶数模数与 64 位整数运算对照: 3^1000 mod 2^64
+    bigint_t* three = bigint_from_u64(3);
+    bigint_t* thousand = bigint_from_u64(1000);
+    bigint_t* two64 = bigint_shl(one, 64);
+    r = bigint_powmod(three, thousand, two64);
+    uint64_t expect = 1;
+    for (int i = 0; i < 1000; i++) expect *= 3;
+    EXPECT_TRUE(r != NULL && r->len == 1 && r->limbs[0] == expect);
+    bigint_free(r);
+
+    // 非法参数
+    bigint_t* neg = bigint_from_i64(-5);
+    EXPECT_TRUE(bigint_powmod(base, neg, m) == NULL);
+    EXPECT_TRUE(bigint_powmod(base, e, neg) == NULL);
+
+    bigint_free(base);
+    bigint_free(e);
+    bigint_free(m);
+    bigint_free(one);
+    bigint_free(p);
+    bigint_free(pm1);
+    bigint_free(a);
+    bigint_free(three);
+    bigint_free(thousand);
+    bigint_free(two64);
+    bigint_free(neg);
+}
+
+void test_bigint_shift_and_str() {
+    TEST(Bigint_ShiftAndStr);
+    bigint_t* a = random_bigint(3000, 99);
+    char* str = bigint_to_str(a);
+    bigint_t* b = bigint_from_str(str);
+    EXPECT_TRUE(b != NULL && bigint_compare(a, b) == 0);
+    bigint_t* c = bigint_shl(a, 1000);
+    bigint_t* d = bigint_shr(c, 1000);
+    EXPECT_TRUE(bigint_compare(a, d) == 0);
+    EXPECT_EQ((int)bigint_bit_length(c), (int)bigint_bit_length(a) + 1000);
+
+    bigint_t* m = bigint_from_i64(INT64_MIN);
+    char* ms = bigint_to_str(m);
+    EXPECT_TRUE(strcmp(ms, "-9223372036854775808") == 0);
+
+    free(str);
+    free(ms);
+    bigint_free(a);
+    bigint_free(b);
+    bigint_free(c);
+    bigint_free(d);
+    bigint_free(m);
+}
+
 int main() {
     test_bigint_from_str();
     test_bigint_from_str_large();
@@ -229,6 +468,11 @@ int main() {
     test_bigint_is_zero();
     test_bigint_free_null();
     test_bigint_stress_operations();
+    test_bigint_negative();
+    test_bigint_mul_algorithms();
+    test_bigint_divmod();
+    test_bigint_powmod();
+    test_bigint_shift_and_str();
 
     return 0;
 }
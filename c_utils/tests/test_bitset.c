@@ -369,6 +369,178 @@ void test_bitset_free_null() {
     bitset_free(NULL);
 }
 
+// 参照模型: 每位一个 bool
+static uint32_t rng_state = 2463534242u;
+
+static uint32_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool matches_ref(const bitset_t *bs, const bool *ref, size_t n) {
+    size_t count = 0;
+    for (size_t i = 0; i < n; i++) {
+        if (bitset_test(bs, i) != ref[i]) return false;
+        count += ref[i];
+    }
+    return bitset_size(bs) == n && bitset_count(bs) == count;
+}
+
+void test_bitset_word_ranges() {
+    TEST(Bitset_WordRanges);
+    const size_t n = 1000;
+    bitset_t *bs = bitset_create(n);
+    bool ref[1000] = {0};
+    bool ok = true;
+
+    // 跨字与字内区间混合, 包括恰好落在字边界上的区间
+    for (int round = 0; round < 2000 && ok; round++) {
+        size_t a = next_rand() % n, b = next_rand() % n;
+        if (round % 7 == 0) a &= ~(size_t)63;
+        if (round % 5 == 0) b |= 63;
+        size_t lo = a < b ? a : b, hi = a < b ? b : a;
+        int op = (int)(next_rand() % 3);
+        if (op == 0) bitset_set_range(bs, lo, hi);
+        else if (op == 1) bitset_clear_range(bs, lo, hi);
+        else bitset_flip_range(bs, lo, hi);
+        for (size_t i = lo; i <= hi && i < n; i++) ref[i] = op == 0 ? true : op == 1 ? false : !ref[i];
+
+        size_t expected = 0;
+        for (size_t i = lo; i <= hi && i < n; i++) expected += ref[i];
+        ok = matches_ref(bs, ref, n) && bitset_count_range(bs, lo, hi) == expected;
+    }
+    EXPECT_TRUE(ok);
+
+    // 超出末尾的位不计入
+    bitset_t *odd = bitset_create(70);
+    bitset_flip_all(odd);
+    EXPECT_EQ(bitset_count(odd), (size_t)70);
+    EXPECT_TRUE(bitset_is_all_set(odd));
+    bitset_t *inv = bitset_not(odd);
+    EXPECT_TRUE(bitset_is_empty(inv));
+    EXPECT_EQ(bitset_find_first_clear(odd, 0), (size_t)-1);
+    EXPECT_TRUE(bitset_resize(odd, 200));
+    EXPECT_EQ(bitset_count(odd), (size_t)70);
+    EXPECT_EQ(bitset_find_first_clear(odd, 0), (size_t)70);
+    EXPECT_TRUE(bitset_resize(odd, 10));
+    EXPECT_TRUE(bitset_resize(odd, 100));
+    EXPECT_EQ(bitset_count(odd), (size_t)10);
+
+    bitset_free(inv);
+    bitset_free(odd);
+    bitset_free(bs);
+}
+
+void test_bitset_find_next() {
+    TEST(Bitset_FindNext);
+    const size_t n = 5000;
+    bitset_t *bs = bitset_create(n);
+    bool ref[5000] = {0};
+    for (int i = 0; i < 60; i++) {
+        size_t v = next_rand() % n;
+        bitset_set(bs, v);
+        ref[v] = true;
+    }
+    bitset_set_range(bs, 3000, 3300);
+    for (size_t i = 3000; i <= 3300; i++) ref[i] = true;
+
+    bool ok = true;
+    size_t last = (size_t)-1;
+    for (size_t start = 0; start < n && ok; start++) {
+        size_t next_set = (size_t)-1, next_clear = (size_t)-1;
+        for (size_t i = start; i < n; i++) {
+            if (ref[i] && next_set == (size_t)-1) next_set = i;
+            if (!ref[i] && next_clear == (size_t)-1) next_clear = i;
+        }
+        ok = bitset_find_first_set(bs, start) == next_set && bitset_find_first_clear(bs, start) == next_clear;
+        if (ref[start]) last = start;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(bitset_find_last_set(bs), last);
+    EXPECT_EQ(bitset_find_first_set(bs, n), (size_t)-1);
+
+    bitset_clear_all(bs);
+    EXPECT_EQ(bitset_find_first_set(bs, 0), (size_t)-1);
+    EXPECT_EQ(bitset_find_last_set(bs), (size_t)-1);
+    bitset_free(bs);
+}
+
+void test_bitset_rank_select() {
+    TEST(Bitset_RankSelect);
+    const size_t n = 100003;
+    bitset_t *bs = bitset_create(n);
+    bool *ref = calloc(n, sizeof(bool));
+    for (size_t i = 0; i < n; i++) {
+        // 前半段稀疏, 后半段稠密
+        if (next_rand() % (i < n / 2 ? 50 : 2) == 0) {
+            bitset_set(bs, i);
+            ref[i] = true;
+        }
+    }
+
+    for (int indexed = 0; indexed < 2; indexed++) {
+        if (indexed) EXPECT_TRUE(bitset_build_rank_index(bs));
+        bool ok = true;
+        size_t rank = 0;
+        for (size_t i = 0; i < n && ok; i++) {
+            if (i % 37 == 0) ok = bitset_rank(bs, i) == rank;
+            if (ref[i]) {
+                ok = ok && bitset_select(bs, rank) == i;
+                rank++;
+            }
+        }
+        EXPECT_TRUE(ok);
+        EXPECT_EQ(bitset_rank(bs, n), rank);
+        EXPECT_EQ(bitset_rank(bs, n + 100), rank);
+        EXPECT_EQ(bitset_count(bs), rank);
+        EXPECT_EQ(bitset_select(bs, rank), (size_t)-1);
+    }
+
+    // 修改后目录失效, 结果仍然正确
+    size_t before = bitset_rank(bs, n);
+    bitset_clear_range(bs, 0, 999);
+    size_t removed = 0;
+    for (size_t i = 0; i < 1000; i++) removed += ref[i];
+    EXPECT_EQ(bitset_rank(bs, n), before - removed);
+    EXPECT_EQ(bitset_select(bs, 0), bitset_find_first_set(bs, 0));
+
+    free(ref);
+    bitset_free(bs);
+}
+
+void test_bitset_ops_unequal() {
+    TEST(Bitset_OpsUnequal);
+    bitset_t *a = bitset_create(300);
+    bitset_t *b = bitset_create(130);
+    bitset_set_range(a, 100, 299);
+    bitset_set_range(b, 0, 129);
+
+    bitset_t *x = bitset_xor(a, b);
+    bitset_t *o = bitset_or(b, a);
+    bitset_t *n = bitset_and(a, b);
+    EXPECT_EQ(bitset_size(x), (size_t)300);
+    EXPECT_EQ(bitset_count(x), (size_t)(100 + 170));
+    EXPECT_EQ(bitset_count(o), (size_t)300);
+    EXPECT_EQ(bitset_size(n), (size_t)130);
+    EXPECT_EQ(bitset_count(n), (size_t)30);
+
+    // 字节序列化与位号一一对应
+    uint8_t bytes[38];
+    EXPECT_TRUE(bitset_to_bytes(a, bytes, sizeof(bytes)));
+    EXPECT_TRUE(bytes[12] == 0xF0 && bytes[11] == 0 && bytes[37] == 0x0F);
+    bitset_t *back = bitset_create_from_bytes(bytes, sizeof(bytes), 300);
+    EXPECT_TRUE(bitset_equals(a, back));
+
+    bitset_free(back);
+    bitset_free(n);
+    bitset_free(o);
+    bitset_free(x);
+    bitset_free(b);
+    bitset_free(a);
+}
+
 int main() {
     test_bitset_create();
     test_bitset_create_zero();
@@ -396,6 +568,10 @@ int main() {
     test_bitset_to_bytes();
     test_bitset_create_from_bytes();
     test_bitset_free_null();
+    test_bitset_word_ranges();
+    test_bitset_find_next();
+    test_bitset_rank_select();
+    test_bitset_ops_unequal();
 
     return 0;
 }
@@ -223,6 +223,103 @@ void test_bloom_edge_case_empty_key() {
     bloom_free(bloom);
 }
 
+void test_bloom_false_positive_rate() {
+    TEST(Bloom_FalsePositiveRate);
+    bloom_t* bloom = bloom_create(20000, 0.01);
+    char key[32];
+    for (int i = 0; i < 20000; i++) {
+        snprintf(key, sizeof(key), "member_%d", i);
+        bloom_add(bloom, key, strlen(key));
+    }
+
+    int false_positives = 0;
+    for (int i = 0; i < 100000; i++) {
+        snprintf(key, sizeof(key), "absent_%d", i);
+        false_positives += bloom_check(bloom, key, strlen(key));
+    }
+    // 目标 1%, 分块布局不应明显劣化
+    EXPECT_TRUE(false_positives < 1500);
+
+    bloom_free(bloom);
+}
+
+void test_bloom_check_many() {
+    TEST(Bloom_CheckMany);
+    bloom_t* bloom = bloom_create(1000, 0.001);
+    char storage[100][16];
+    const void* keys[100];
+    size_t lens[100];
+    bool results[100];
+    for (int i = 0; i < 100; i++) {
+        snprintf(storage[i], sizeof(storage[i]), "%s%d", i % 2 ? "in" : "out", i);
+        keys[i] = storage[i];
+        lens[i] = strlen(storage[i]);
+        if (i % 2) bloom_add(bloom, keys[i], lens[i]);
+    }
+
+    size_t hits = bloom_check_many(bloom, keys, lens, 100, results);
+    bool consistent = true;
+    for (int i = 0; i < 100; i++) {
+        consistent = consistent && results[i] == bloom_check(bloom, keys[i], lens[i]);
+        if (i % 2) consistent = consistent && results[i];
+    }
+    EXPECT_TRUE(consistent);
+    EXPECT_TRUE(hits >= 50 && hits < 55);
+    EXPECT_EQ((int)bloom_check_many(bloom, keys, lens, 100, NULL), (int)hits);
+
+    bloom_free(bloom);
+}
+
+void test_bloom_legacy_format() {
+    TEST(Bloom_LegacyFormat);
+    // 旧格式: nbits, nhash, nexpected, nadded (size_t), fp_rate (double), 位数组
+    size_t header[4] = { 64, 3, 10, 0 };
+    double fp = 0.01;
+    uint8_t buf[sizeof(header) + sizeof(double) + 8];
+    memcpy(buf, header, sizeof(header));
+    memcpy(buf + sizeof(header), &fp, sizeof(fp));
+    memset(buf + sizeof(header) + sizeof(double), 0, 8);
+
+    bloom_t* bloom = bloom_deserialize(buf, sizeof(buf));
+    EXPECT_TRUE(bloom != NULL);
+    EXPECT_FALSE(bloom_check(bloom, "legacy", 6));
+    bloom_add(bloom, "legacy", 6);
+    EXPECT_TRUE(bloom_check(bloom, "legacy", 6));
+
+    // 旧版过滤器按旧格式写回
+    uint8_t out[128];
+    size_t written = 0;
+    EXPECT_TRUE(bloom_serialize(bloom, out, sizeof(out), &written));
+    EXPECT_EQ((int)written, (int)sizeof(buf));
+    bloom_t* again = bloom_deserialize(out, written);
+    EXPECT_TRUE(again != NULL && bloom_check(again, "legacy", 6));
+
+    // 截断的数据被拒绝
+    EXPECT_TRUE(bloom_deserialize(out, written - 1) == NULL);
+
+    bloom_free(again);
+    bloom_free(bloom);
+}
+
+void test_bloom_hash64() {
+    TEST(Bloom_Hash64);
+    EXPECT_TRUE(bloom_hash64("abc", 3, 0) == bloom_hash64("abc", 3, 0));
+    EXPECT_TRUE(bloom_hash64("abc", 3, 0) != bloom_hash64("abc", 3, 1));
+    EXPECT_TRUE(bloom_hash64("abc", 3, 0) != bloom_hash64("abd", 3, 0));
+
+    // 各种长度 (覆盖短键与 48 字节循环) 的单比特变化都要改变大约一半的输出位
+    uint8_t data[100] = { 0 };
+    bool avalanche = true;
+    for (size_t len = 1; len <= sizeof(data); len += 7) {
+        uint64_t before = bloom_hash64(data, len, 0);
+        data[len / 2] ^= 1;
+        int diff = __builtin_popcountll(before ^ bloom_hash64(data, len, 0));
+        data[len / 2] ^= 1;
+        avalanche = avalanche && diff > 12 && diff < 52;
+    }
+    EXPECT_TRUE(avalanche);
+}
+
 int main() {
     test_bloom_create();
     test_bloom_create_invalid_params();
@@ -239,6 +336,10 @@ int main() {
     test_bloom_stress_many_elements();
     test_bloom_edge_case_single_element();
     test_bloom_edge_case_empty_key();
+    test_bloom_false_positive_rate();
+    test_bloom_check_many();
+    test_bloom_legacy_format();
+    test_bloom_hash64();
 
     return 0;
 }
@@ -70,12 +70,103 @@ void test_bloom_counting_reset() {
     bloom_counting_free(bf);
 }
 
+void test_bloom_counting_remove_clears() {
+    TEST(BloomCounting_RemoveClears);
+    bloom_counting_t* bf = bloom_counting_create(4096, 4, 15);
+    char key[32];
+    for (int i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        bloom_counting_add(bf, key, strlen(key));
+    }
+    for (int i = 0; i < 100; i += 2) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        bloom_counting_remove(bf, key, strlen(key));
+    }
+
+    int present = 0, removed_present = 0;
+    for (int i = 0; i < 100; i++) {
+        snprintf(key, sizeof(key), "key_%d", i);
+        bool exists = bloom_counting_check(bf, key, strlen(key));
+        if (i % 2) present += exists;
+        else removed_present += exists;
+    }
+    EXPECT_EQ(present, 50);
+    EXPECT_TRUE(removed_present < 5);
+
+    bloom_counting_free(bf);
+}
+
+void test_bloom_counting_check_many() {
+    TEST(BloomCounting_CheckMany);
+    bloom_counting_t* bf = bloom_counting_create(8192, 6, 15);
+    char storage[40][16];
+    const void* keys[40];
+    size_t lens[40];
+    bool results[40];
+    for (int i = 0; i < 40; i++) {
+        snprintf(storage[i], sizeof(storage[i]), "k%d", i);
+        keys[i] = storage[i];
+        lens[i] = strlen(storage[i]);
+        if (i < 20) bloom_counting_add(bf, keys[i], lens[i]);
+    }
+
+    bloom_counting_check_many(bf, keys, lens, 40, results);
+    bool consistent = true;
+    for (int i = 0; i < 40; i++) {
+        consistent = consistent && results[i] == bloom_counting_check(bf, keys[i], lens[i]);
+        if (i < 20) consistent = consistent && results[i];
+    }
+    EXPECT_TRUE(consistent);
+
+    bloom_counting_free(bf);
+}
+
+void test_bloom_counting_serialize() {
+    TEST(BloomCounting_Serialize);
+    bloom_counting_t* bf = bloom_counting_create(1000, 3, 15);
+    bloom_counting_add(bf, "alpha", 5);
+    bloom_counting_add(bf, "alpha", 5);
+    bloom_counting_add(bf, "beta", 4);
+
+    uint8_t buf[2048];
+    size_t written = 0;
+    EXPECT_TRUE(bloom_counting_serialize(bf, buf, sizeof(buf), &written));
+    bloom_counting_t* copy = bloom_counting_deserialize(buf, written);
+    EXPECT_TRUE(copy != NULL);
+    EXPECT_TRUE(bloom_counting_check(copy, "beta", 4));
+    EXPECT_TRUE(bloom_counting_estimate(copy, "alpha", 5) >= 2);
+    EXPECT_TRUE(bloom_counting_deserialize(buf, written - 1) == NULL);
+
+    // 旧格式: size (size_t), num_hashes (int), max_count (uint8_t), 计数器
+    size_t size = 16;
+    int num_hashes = 2;
+    uint8_t legacy[sizeof(size_t) + sizeof(int) + 1 + 16];
+    memcpy(legacy, &size, sizeof(size));
+    memcpy(legacy + sizeof(size_t), &num_hashes, sizeof(num_hashes));
+    legacy[sizeof(size_t) + sizeof(int)] = 15;
+    memset(legacy + sizeof(size_t) + sizeof(int) + 1, 0, 16);
+    bloom_counting_t* old = bloom_counting_deserialize(legacy, sizeof(legacy));
+    EXPECT_TRUE(old != NULL);
+    EXPECT_FALSE(bloom_counting_check(old, "gamma", 5));
+    bloom_counting_add(old, "gamma", 5);
+    EXPECT_TRUE(bloom_counting_check(old, "gamma", 5));
+    EXPECT_TRUE(bloom_counting_serialize(old, buf, sizeof(buf), &written));
+    EXPECT_EQ((int)written, (int)sizeof(legacy));
+
+    bloom_counting_free(old);
+    bloom_counting_free(copy);
+    bloom_counting_free(bf);
+}
+
 int main() {
     test_bloom_counting_create_free();
     test_bloom_counting_add_check();
     test_bloom_counting_remove();
     test_bloom_counting_estimate();
     test_bloom_counting_reset();
+    test_bloom_counting_remove_clears();
+    test_bloom_counting_check_many();
+    test_bloom_counting_serialize();
 
     return 0;
 }
@@ -3,6 +3,9 @@
 #include <string.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/bplus_tree.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <stdatomic.h>
 
 static int int_compare(const void *a, const void *b) {
     return (*(int*)a - *(int*)b);
@@ -98,12 +101,263 @@ void test_bplus_tree_iterator() {
     bplus_tree_free(tree);
 }
 
+static int keys_buf[20000];
+
+void test_bplus_tree_many_keys() {
+    TEST(BplusTree_ManyKeys);
+    bplus_tree_t* tree = bplus_tree_create(int_compare);
+    int n = 20000;
+
+    /* 乱序插入, 触发多层分裂 */
+    for (int i = 0; i < n; i++) {
+        keys_buf[i] = (int)(((unsigned)i * 7919u) % (unsigned)n);
+        EXPECT_TRUE(bplus_tree_insert(tree, &keys_buf[i], &keys_buf[i]));
+    }
+    EXPECT_EQ(bplus_tree_size(tree), (size_t)n);
+    EXPECT_TRUE(bplus_tree_validate(tree));
+
+    int probe = 12345;
+    int *found = bplus_tree_get(tree, &probe);
+    EXPECT_TRUE(found != NULL && *found == probe);
+    probe = n;
+    EXPECT_TRUE(bplus_tree_get(tree, &probe) == NULL);
+
+    bplus_iterator_t* iter = bplus_iterator_create(tree);
+    const void* k;
+    int expected = 0;
+    bool ordered = true;
+    while (bplus_iterator_next(iter, &k, NULL)) {
+        if (*(const int*)k != expected++) ordered = false;
+    }
+    EXPECT_TRUE(ordered);
+    EXPECT_EQ(expected, n);
+    bplus_iterator_free(iter);
+
+    const void *min_key, *max_key;
+    EXPECT_TRUE(bplus_tree_min(tree, &min_key, NULL));
+    EXPECT_TRUE(bplus_tree_max(tree, &max_key, NULL));
+    EXPECT_EQ(*(const int*)min_key, 0);
+    EXPECT_EQ(*(const int*)max_key, n - 1);
+
+    /* 删除偶数键, 再删除剩余键直到清空 */
+    for (int i = 0; i < n; i += 2) {
+        EXPECT_TRUE(bplus_tree_delete(tree, &i));
+    }
+    EXPECT_EQ(bplus_tree_size(tree), (size_t)(n / 2));
+    EXPECT_TRUE(bplus_tree_validate(tree));
+    probe = 100;
+    EXPECT_TRUE(bplus_tree_get(tree, &probe) == NULL);
+    probe = 101;
+    EXPECT_TRUE(bplus_tree_get(tree, &probe) != NULL);
+
+    for (int i = 1; i < n; i += 2) {
+        EXPECT_TRUE(bplus_tree_delete(tree, &i));
+    }
+    EXPECT_TRUE(bplus_tree_is_empty(tree));
+    EXPECT_TRUE(bplus_tree_validate(tree));
+    EXPECT_FALSE(bplus_tree_min(tree, &min_key, NULL));
+
+    bplus_tree_free(tree);
+}
+
+static bool sum_range(const void *key, void *value, void *user_data) {
+    (void)value;
+    *(long *)user_data += *(const int *)key;
+    return true;
+}
+
+static bool stop_after_three(const void *key, void *value, void *user_data) {
+    (void)key;
+    (void)value;
+    return ++*(int *)user_data < 3;
+}
+
+void test_bplus_tree_bulk_load_range() {
+    TEST(BplusTree_BulkLoadRange);
+    int n = 10000;
+    const void **keys = malloc(n * sizeof(void *));
+    for (int i = 0; i < n; i++) {
+        keys_buf[i] = i * 2;
+        keys[i] = &keys_buf[i];
+    }
+
+    bplus_tree_t* tree = bplus_tree_create(int_compare);
+    EXPECT_TRUE(bplus_tree_bulk_load(tree, keys, (void *const *)keys, n));
+    EXPECT_EQ(bplus_tree_size(tree), (size_t)n);
+    EXPECT_TRUE(bplus_tree_validate(tree));
+    EXPECT_FALSE(bplus_tree_bulk_load(tree, keys, (void *const *)keys, n));
+
+    /* [101, 199] 内的偶数 102..198 */
+    int start = 101, end = 199;
+    long sum = 0;
+    EXPECT_EQ(bplus_tree_range_query(tree, &start, &end, sum_range, &sum), (size_t)49);
+    EXPECT_EQ(sum, 49L * 150);
+
+    int calls = 0;
+    EXPECT_EQ(bplus_tree_range_query(tree, NULL, NULL, stop_after_three, &calls), (size_t)2);
+    sum = 0;
+    EXPECT_EQ(bplus_tree_range_query(tree, NULL, NULL, sum_range, &sum), (size_t)n);
+
+    /* 批量构建后继续插入与删除 */
+    int odd = 777;
+    EXPECT_TRUE(bplus_tree_insert(tree, &odd, NULL));
+    EXPECT_TRUE(bplus_tree_delete(tree, &keys_buf[5000]));
+    EXPECT_TRUE(bplus_tree_validate(tree));
+    bplus_tree_free(tree);
+
+    /* 未排序输入被拒绝 */
+    tree = bplus_tree_create(int_compare);
+    keys[10] = &keys_buf[3];
+    EXPECT_FALSE(bplus_tree_bulk_load(tree, keys, NULL, n));
+    EXPECT_TRUE(bplus_tree_is_empty(tree));
+    bplus_tree_free(tree);
+    free(keys);
+}
+
+static bool count_u64(uint64_t key, void *value, void *user_data) {
+    (void)value;
+    uint64_t *state = user_data;
+    if (key != state[1]) state[2] = 1;
+    state[1] = key + 3;
+    state[0]++;
+    return true;
+}
+
+void test_bplus_tree_u64() {
+    TEST(BplusTree_U64);
+    bplus_tree_t* tree = bplus_tree_create_u64();
+    for (uint64_t i = 0; i < 100000; i++) {
+        EXPECT_TRUE(bplus_tree_insert_u64(tree, i * 3, (void *)(uintptr_t)(i + 1)));
+    }
+    EXPECT_TRUE(bplus_tree_validate(tree));
+    bool found = false;
+    EXPECT_EQ((uintptr_t)bplus_tree_get_u64(tree, 300, &found), (uintptr_t)101);
+    EXPECT_TRUE(found);
+    bplus_tree_get_u64(tree, 301, &found);
+    EXPECT_FALSE(found);
+
+    /* 值为 NULL 的键也能查到 */
+    EXPECT_TRUE(bplus_tree_insert_u64(tree, 1, NULL));
+    EXPECT_TRUE(bplus_tree_get_u64(tree, 1, &found) == NULL);
+    EXPECT_TRUE(found);
+    EXPECT_TRUE(bplus_tree_delete_u64(tree, 1));
+    EXPECT_FALSE(bplus_tree_delete_u64(tree, 1));
+
+    uint64_t state[3] = {0, 30, 0};
+    EXPECT_EQ(bplus_tree_range_query_u64(tree, 29, 3000, count_u64, state), (size_t)991);
+    EXPECT_EQ(state[0], 991);
+    EXPECT_EQ(state[2], 0);
+
+    uint64_t key = 42;
+    EXPECT_TRUE(bplus_tree_get(tree, &key) != NULL);
+    bplus_tree_free(tree);
+
+    tree = bplus_tree_create_u64();
+    uint64_t *keys = malloc(50000 * sizeof(uint64_t));
+    for (size_t i = 0; i < 50000; i++) keys[i] = i * 10;
+    EXPECT_TRUE(bplus_tree_bulk_load_u64(tree, keys, NULL, 50000));
+    EXPECT_TRUE(bplus_tree_validate(tree));
+    bplus_tree_get_u64(tree, 499990, &found);
+    EXPECT_TRUE(found);
+    free(keys);
+    bplus_tree_free(tree);
+}
+
+static uint64_t prefix_of_string(const void *key) {
+    const unsigned char *s = key;
+    uint64_t prefix = 0;
+    for (int i = 0; i < 8; i++) {
+        prefix <<= 8;
+        if (*s) prefix |= *s++;
+    }
+    return prefix;
+}
+
+static int str_compare(const void *a, const void *b) {
+    return strcmp(a, b);
+}
+
+void test_bplus_tree_prefix_keys() {
+    TEST(BplusTree_PrefixKeys);
+    bplus_tree_t* tree = bplus_tree_create_with_prefix(str_compare, prefix_of_string);
+    static char words[3000][24];
+    for (int i = 0; i < 3000; i++) {
+        /* 前 8 字节大量重复, 需要回退到比较函数 */
+        snprintf(words[i], sizeof(words[i]), "user:%s:%05d", i % 2 ? "alpha" : "beta", (i * 37) % 3000);
+        EXPECT_TRUE(bplus_tree_insert(tree, words[i], words[i]));
+    }
+    EXPECT_TRUE(bplus_tree_validate(tree));
+    EXPECT_EQ(bplus_tree_size(tree), (size_t)3000);
+    EXPECT_TRUE(bplus_tree_get(tree, "user:beta:00074") != NULL);
+    EXPECT_TRUE(bplus_tree_get(tree, "user:beta:00075") == NULL);
+    EXPECT_TRUE(bplus_tree_delete(tree, "user:alpha:00037"));
+    EXPECT_TRUE(bplus_tree_validate(tree));
+    bplus_tree_free(tree);
+}
+
+typedef struct {
+    bplus_tree_t *tree;
+    atomic_int stop;
+    atomic_int errors;
+} concurrent_ctx_t;
+
+/* 读者: 偶数键在整个测试期间始终存在, 范围扫描必须有序 */
+static void *concurrent_reader(void *arg) {
+    concurrent_ctx_t *ctx = arg;
+    uint64_t seed = 88172645463325252ull;
+    while (!atomic_load(&ctx->stop)) {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+        uint64_t key = (seed % 50000) * 2;
+        bool found = false;
+        void *value = bplus_tree_get_u64(ctx->tree, key, &found);
+        if (!found || (uintptr_t)value != key + 1) atomic_fetch_add(&ctx->errors, 1);
+
+        uint64_t state[3] = {0, 0, 0};
+        bplus_tree_range_query_u64(ctx->tree, key, key + 200, count_u64, state);
+    }
+    return NULL;
+}
+
+void test_bplus_tree_concurrent_readers() {
+    TEST(BplusTree_ConcurrentReaders);
+    concurrent_ctx_t ctx;
+    ctx.tree = bplus_tree_create_u64();
+    atomic_init(&ctx.stop, 0);
+    atomic_init(&ctx.errors, 0);
+    for (uint64_t i = 0; i < 100000; i += 2) {
+        bplus_tree_insert_u64(ctx.tree, i, (void *)(uintptr_t)(i + 1));
+    }
+
+    pthread_t readers[3];
+    for (int i = 0; i < 3; i++) pthread_create(&readers[i], NULL, concurrent_reader, &ctx);
+
+    /* 写者反复插入和删除奇数键, 引发分裂和叶子回收 */
+    for (int round = 0; round < 3; round++) {
+        for (uint64_t i = 1; i < 100000; i += 2) bplus_tree_insert_u64(ctx.tree, i, (void *)(uintptr_t)(i + 1));
+        for (uint64_t i = 1; i < 100000; i += 2) bplus_tree_delete_u64(ctx.tree, i);
+    }
+    atomic_store(&ctx.stop, 1);
+    for (int i = 0; i < 3; i++) pthread_join(readers[i], NULL);
+
+    EXPECT_EQ(atomic_load(&ctx.errors), 0);
+    EXPECT_EQ(bplus_tree_size(ctx.tree), (size_t)50000);
+    EXPECT_TRUE(bplus_tree_validate(ctx.tree));
+    bplus_tree_free(ctx.tree);
+}
+
 int main() {
+    UTEST_BEGIN();
     test_bplus_tree_create_free();
     test_bplus_tree_insert_get();
     test_bplus_tree_delete();
     test_bplus_tree_size();
     test_bplus_tree_iterator();
-
-    return 0;
+    test_bplus_tree_many_keys();
+    test_bplus_tree_bulk_load_range();
+    test_bplus_tree_u64();
+    test_bplus_tree_prefix_keys();
+    test_bplus_tree_concurrent_readers();
+    UTEST_END();
 }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/chacha20_tiny.h"
 
@@ -60,12 +61,175 @@ void test_chacha20_tiny_large_output() {
     EXPECT_TRUE(true);
 }
 
+void test_chacha20_rfc8439_block() {
+    TEST(ChaCha20_Rfc8439Block);
+    EXPECT_TRUE(chacha20_validate_test_vectors());
+}
+
+void test_chacha20_streaming_matches_oneshot() {
+    TEST(ChaCha20_StreamingMatchesOneshot);
+    uint8_t key[32], nonce[12];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 7);
+    for (int i = 0; i < 12; i++) nonce[i] = (uint8_t)(i + 1);
+
+    size_t len = 3000;
+    uint8_t *in = malloc(len), *expected = malloc(len), *out = malloc(len);
+    for (size_t i = 0; i < len; i++) in[i] = (uint8_t)(i * 31);
+
+    EXPECT_EQ(chacha20_encrypt(key, nonce, 5, in, expected, len), CHACHA20_OK);
+
+    // 不规则分段覆盖缓冲密钥流、标量、SSE2 与 AVX2 路径
+    const size_t pieces[] = {1, 63, 64, 5, 600, 1000, 7, len};
+    chacha20_context_t ctx;
+    EXPECT_EQ(chacha20_init(&ctx, key, nonce, 5), CHACHA20_OK);
+    size_t pos = 0;
+    for (size_t i = 0; pos < len; i++) {
+        size_t n = pieces[i] < len - pos ? pieces[i] : len - pos;
+        EXPECT_EQ(chacha20_update(&ctx, in + pos, out + pos, n), CHACHA20_OK);
+        pos += n;
+    }
+    EXPECT_TRUE(memcmp(out, expected, len) == 0);
+
+    // 再次加密即解密
+    EXPECT_EQ(chacha20_encrypt(key, nonce, 5, expected, out, len), CHACHA20_OK);
+    EXPECT_TRUE(memcmp(out, in, len) == 0);
+
+    free(in);
+    free(expected);
+    free(out);
+}
+
+void test_chacha20_poly1305_rfc8439() {
+    TEST(ChaCha20Poly1305_Rfc8439);
+    const char *plaintext = "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+                            "for the future, sunscreen would be it.";
+    uint8_t key[32];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(0x80 + i);
+    const uint8_t nonce[12] = {0x07, 0, 0, 0, 0x40, 0x41, 0x42, 0x43, 0x44, 0x45, 0x46, 0x47};
+    const uint8_t aad[12] = {0x50, 0x51, 0x52, 0x53, 0xc0, 0xc1, 0xc2, 0xc3, 0xc4, 0xc5, 0xc6, 0xc7};
+    const uint8_t expected_ct[16] = {0xd3, 0x1a, 0x8d, 0x34, 0x64, 0x8e, 0x60, 0xdb,
+                                     0x7b, 0x86, 0xaf, 0xbc, 0x53, 0xef, 0x7e, 0xc2};
+    const uint8_t expected_tag[16] = {0x1a, 0xe1, 0x0b, 0x59, 0x4f, 0x09, 0xe2, 0x6a,
+                                      0x7e, 0x90, 0x2e, 0xcb, 0xd0, 0x60, 0x06, 0x91};
+    size_t len = strlen(plaintext);
+    uint8_t ct[128], pt[128], tag[16];
+
+    EXPECT_EQ(chacha20_poly1305_encrypt(key, nonce, aad, sizeof(aad), (const uint8_t *)plaintext, ct, len, tag),
+              CHACHA20_OK);
+    EXPECT_TRUE(memcmp(ct, expected_ct, sizeof(expected_ct)) == 0);
+    EXPECT_TRUE(memcmp(tag, expected_tag, sizeof(expected_tag)) == 0);
+
+    EXPECT_EQ(chacha20_poly1305_decrypt(key, nonce, aad, sizeof(aad), ct, pt, len, tag), CHACHA20_OK);
+    EXPECT_TRUE(memcmp(pt, plaintext, len) == 0);
+
+    // 篡改密文、AAD 或标签都必须失败, 且不输出明文
+    memset(pt, 0, sizeof(pt));
+    ct[10] ^= 1;
+    EXPECT_EQ(chacha20_poly1305_decrypt(key, nonce, aad, sizeof(aad), ct, pt, len, tag), CHACHA20_ERROR_AUTH_FAILED);
+    ct[10] ^= 1;
+    EXPECT_EQ(chacha20_poly1305_decrypt(key, nonce, aad, sizeof(aad) - 1, ct, pt, len, tag),
+              CHACHA20_ERROR_AUTH_FAILED);
+    tag[15] ^= 0x80;
+    EXPECT_EQ(chacha20_poly1305_decrypt(key, nonce, aad, sizeof(aad), ct, pt, len, tag), CHACHA20_ERROR_AUTH_FAILED);
+    EXPECT_EQ(pt[0], 0);
+}
+
+void test_chacha20_poly1305_streaming() {
+    TEST(ChaCha20Poly1305_Streaming);
+    uint8_t key[32] = {1}, nonce[12] = {2};
+    uint8_t aad[40];
+    for (int i = 0; i < 40; i++) aad[i] = (uint8_t)i;
+    size_t len = 5000;
+    uint8_t *in = malloc(len), *ct = malloc(len), *stream_ct = malloc(len);
+    for (size_t i = 0; i < len; i++) in[i] = (uint8_t)(i ^ (i >> 8));
+
+    uint8_t tag[16], stream_tag[16];
+    EXPECT_EQ(chacha20_poly1305_encrypt(key, nonce, aad, sizeof(aad), in, ct, len, tag), CHACHA20_OK);
+
+    chacha20_poly1305_ctx_t ctx;
+    EXPECT_EQ(chacha20_poly1305_init(&ctx, key, nonce), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_update_aad(&ctx, aad, 13), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_update_aad(&ctx, aad + 13, sizeof(aad) - 13), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_encrypt_update(&ctx, in, stream_ct, 17), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_update_aad(&ctx, aad, 1), CHACHA20_ERROR_INVALID_STATE);
+    EXPECT_EQ(chacha20_poly1305_encrypt_update(&ctx, in + 17, stream_ct + 17, len - 17), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_encrypt_final(&ctx, stream_tag), CHACHA20_OK);
+    EXPECT_TRUE(memcmp(ct, stream_ct, len) == 0);
+    EXPECT_TRUE(memcmp(tag, stream_tag, sizeof(tag)) == 0);
+
+    // 原地流式解密
+    EXPECT_EQ(chacha20_poly1305_init(&ctx, key, nonce), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_update_aad(&ctx, aad, sizeof(aad)), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_decrypt_update(&ctx, stream_ct, stream_ct, 4000), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_decrypt_update(&ctx, stream_ct + 4000, stream_ct + 4000, len - 4000), CHACHA20_OK);
+    EXPECT_EQ(chacha20_poly1305_decrypt_final(&ctx, tag), CHACHA20_OK);
+    EXPECT_TRUE(memcmp(stream_ct, in, len) == 0);
+
+    free(in);
+    free(ct);
+    free(stream_ct);
+}
+
+void test_chacha20_counter_overflow() {
+    TEST(ChaCha20_CounterOverflow);
+    uint8_t key[32], nonce[12], in[1100], out[1100], ks[64];
+    for (int i = 0; i < 32; i++) key[i] = (uint8_t)(i * 5);
+    for (int i = 0; i < 12; i++) nonce[i] = (uint8_t)(i + 9);
+    for (int i = 0; i < 1100; i++) in[i] = (uint8_t)(i * 13);
+
+    // 计数器 0xFFFFFFFF 只剩一个块: 64 字节可以, 多 1 字节就会回绕到 0
+    memset(out, 0xAA, sizeof(out));
+    EXPECT_EQ(chacha20_encrypt(key, nonce, 0xFFFFFFFFu, in, out, 65), CHACHA20_ERROR_INVALID_COUNTER);
+    bool untouched = true;
+    for (int i = 0; i < 65; i++) {
+        if (out[i] != 0xAA) untouched = false;
+    }
+    EXPECT_TRUE(untouched);
+
+    EXPECT_EQ(chacha20_encrypt(key, nonce, 0xFFFFFFFFu, in, out, 64), CHACHA20_OK);
+    chacha20_tiny(key, nonce, 0xFFFFFFFFu, ks, 64);
+    bool match = true;
+    for (int i = 0; i < 64; i++) {
+        if (out[i] != (uint8_t)(in[i] ^ ks[i])) match = false;
+    }
+    EXPECT_TRUE(match);
+
+    // 超出范围时 chacha20_tiny 不写入
+    memset(out, 0xAA, sizeof(out));
+    chacha20_tiny(key, nonce, 0xFFFFFFFFu, out, 65);
+    EXPECT_EQ(out[0], 0xAA);
+
+    // 流式: 缓冲区里剩余的密钥流仍可用, 需要新块时拒绝
+    chacha20_context_t ctx;
+    EXPECT_EQ(chacha20_init(&ctx, key, nonce, 0xFFFFFFFFu), CHACHA20_OK);
+    EXPECT_EQ(chacha20_update(&ctx, in, out, 10), CHACHA20_OK);
+    EXPECT_EQ(chacha20_update(&ctx, in + 10, out + 10, 54), CHACHA20_OK);
+    EXPECT_EQ(chacha20_update(&ctx, in + 64, out + 64, 1), CHACHA20_ERROR_INVALID_COUNTER);
+
+    // 多块并行路径: 从 0xFFFFFFF0 开始正好 16 块
+    EXPECT_EQ(chacha20_encrypt(key, nonce, 0xFFFFFFF0u, in, out, 16 * 64), CHACHA20_OK);
+    EXPECT_EQ(chacha20_encrypt(key, nonce, 0xFFFFFFF0u, in, out, 16 * 64 + 1), CHACHA20_ERROR_INVALID_COUNTER);
+
+    // AEAD: 剩余块数不足时整段拒绝
+    chacha20_poly1305_ctx_t aead;
+    EXPECT_EQ(chacha20_poly1305_init(&aead, key, nonce), CHACHA20_OK);
+    aead.cipher.blocks_left = 1;
+    EXPECT_EQ(chacha20_poly1305_encrypt_update(&aead, in, out, 65), CHACHA20_ERROR_INVALID_COUNTER);
+    EXPECT_EQ(chacha20_poly1305_decrypt_update(&aead, in, out, 65), CHACHA20_ERROR_INVALID_COUNTER);
+    EXPECT_EQ(chacha20_poly1305_encrypt_update(&aead, in, out, 64), CHACHA20_OK);
+}
+
 int main() {
     test_chacha20_tiny_basic();
     test_chacha20_tiny_empty();
     test_chacha20_tiny_with_key();
     test_chacha20_tiny_different_counters();
     test_chacha20_tiny_large_output();
+    test_chacha20_rfc8439_block();
+    test_chacha20_streaming_matches_oneshot();
+    test_chacha20_poly1305_rfc8439();
+    test_chacha20_poly1305_streaming();
+    test_chacha20_counter_overflow();
 
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/dijkstra.h"
 
@@ -76,12 +77,186 @@ void test_dijkstra_strerror() {
     EXPECT_TRUE(msg != NULL);
 }
 
+// 随机稀疏图, 用 Bellman-Ford 作为参照
+static graph_csr_t* random_graph(int n, int m, unsigned seed, int **src_out, int **dst_out, int **w_out) {
+    int *src = malloc(m * sizeof(int));
+    int *dst = malloc(m * sizeof(int));
+    int *w = malloc(m * sizeof(int));
+    for (int i = 0; i < m; i++) {
+        seed = seed * 1103515245u + 12345u;
+        src[i] = (int)((seed >> 8) % (unsigned)n);
+        seed = seed * 1103515245u + 12345u;
+        dst[i] = (int)((seed >> 8) % (unsigned)n);
+        seed = seed * 1103515245u + 12345u;
+        w[i] = (int)((seed >> 8) % 100);
+    }
+    graph_csr_t *g = graph_csr_from_edges((size_t)n, src, dst, w, (size_t)m);
+    *src_out = src;
+    *dst_out = dst;
+    *w_out = w;
+    return g;
+}
+
+static void bellman_ford_ref(int n, int m, const int *src, const int *dst, const int *w, int start, int *dist) {
+    for (int i = 0; i < n; i++) dist[i] = INT_MAX;
+    dist[start] = 0;
+    for (int round = 0; round < n; round++) {
+        bool changed = false;
+        for (int i = 0; i < m; i++) {
+            if (dist[src[i]] != INT_MAX && dist[src[i]] + w[i] < dist[dst[i]]) {
+                dist[dst[i]] = dist[src[i]] + w[i];
+                changed = true;
+            }
+        }
+        if (!changed) break;
+    }
+}
+
+void test_dijkstra_csr_random() {
+    TEST(Dijkstra_CsrRandom);
+    enum { N = 300, M = 1500 };
+    int *src, *dst, *w;
+    graph_csr_t *g = random_graph(N, M, 7, &src, &dst, &w);
+    EXPECT_TRUE(g != NULL);
+
+    int dist[N], pred[N], ref[N];
+    dijkstra_error_t error;
+    bool ok = true;
+    for (int s = 0; s < N; s += 37) {
+        ok = ok && dijkstra_csr(g, s, -1, dist, pred, &error);
+        bellman_ford_ref(N, M, src, dst, w, s, ref);
+        for (int v = 0; v < N; v++) {
+            ok = ok && dist[v] == ref[v];
+            // 前驱链上的边权之和等于距离
+            if (v != s && dist[v] != INT_MAX) {
+                int u = pred[v], best = INT_MAX;
+                for (int i = 0; i < M; i++) {
+                    if (src[i] == u && dst[i] == v && w[i] < best) best = w[i];
+                }
+                ok = ok && u >= 0 && dist[u] + best == dist[v];
+            }
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    // 提前结束: 目标距离与完整搜索一致
+    for (int t = 0; t < N; t += 13) {
+        ok = ok && dijkstra_csr(g, 1, t, dist, NULL, &error);
+        bellman_ford_ref(N, M, src, dst, w, 1, ref);
+        ok = ok && dist[t] == ref[t];
+    }
+    EXPECT_TRUE(ok);
+
+    EXPECT_FALSE(dijkstra_csr(g, N, -1, dist, NULL, &error));
+    EXPECT_EQ(error, DIJKSTRA_ERROR_INVALID_NODE);
+    graph_csr_free(g);
+    free(src);
+    free(dst);
+    free(w);
+}
+
+void test_dijkstra_csr_negative() {
+    TEST(Dijkstra_CsrNegative);
+    int src[] = { 0, 1 };
+    int dst[] = { 1, 2 };
+    int w[]   = { 2, -1 };
+    graph_csr_t *g = graph_csr_from_edges(3, src, dst, w, 2);
+    int dist[3];
+    dijkstra_error_t error;
+    EXPECT_FALSE(dijkstra_csr(g, 0, -1, dist, NULL, &error));
+    EXPECT_EQ(error, DIJKSTRA_ERROR_NEGATIVE_WEIGHT);
+    // 负权边不可达时不影响结果
+    EXPECT_TRUE(dijkstra_csr(g, 2, -1, dist, NULL, &error));
+    EXPECT_TRUE(dist[2] == 0 && dist[0] == INT_MAX);
+    graph_csr_free(g);
+}
+
+void test_dijkstra_many_to_many() {
+    TEST(Dijkstra_ManyToMany);
+    enum { N = 400, M = 2400, S = 9, T = 6 };
+    int *src, *dst, *w;
+    graph_csr_t *g = random_graph(N, M, 99, &src, &dst, &w);
+    int sources[S] = { 0, 5, 17, 42, 99, 150, 151, 299, 5 };
+    int targets[T] = { 3, 3, 77, 0, 398, 200 };
+    int out[S * T];
+    int ref[N];
+    dijkstra_error_t error;
+
+    threadpool_t *pool = threadpool_create(3);
+    bool ok = true;
+    for (int round = 0; round < 2; round++) {
+        memset(out, 0, sizeof(out));
+        ok = ok && dijkstra_many_to_many(g, sources, S, targets, T, out, round ? NULL : pool, &error);
+        for (int i = 0; i < S; i++) {
+            bellman_ford_ref(N, M, src, dst, w, sources[i], ref);
+            for (int j = 0; j < T; j++) ok = ok && out[i * T + j] == ref[targets[j]];
+        }
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(error, DIJKSTRA_OK);
+    threadpool_destroy(pool);
+
+    int bad[] = { N };
+    EXPECT_FALSE(dijkstra_many_to_many(g, bad, 1, targets, T, out, NULL, &error));
+    EXPECT_EQ(error, DIJKSTRA_ERROR_INVALID_NODE);
+    graph_csr_free(g);
+    free(src);
+    free(dst);
+    free(w);
+}
+
+void test_dijkstra_delta_stepping() {
+    TEST(Dijkstra_DeltaStepping);
+    enum { N = 3000, M = 20000 };
+    int *src, *dst, *w;
+    graph_csr_t *g = random_graph(N, M, 4242, &src, &dst, &w);
+    int *ref = malloc(N * sizeof(int)), *dist = malloc(N * sizeof(int)), *pred = malloc(N * sizeof(int));
+    dijkstra_error_t error;
+    EXPECT_TRUE(dijkstra_csr(g, 3, -1, ref, NULL, &error));
+
+    threadpool_t *pool = threadpool_create(4);
+    int deltas[] = { 0, 1, 7, 1000 };
+    bool ok = true;
+    for (int d = 0; d < 4; d++) {
+        for (int p = 0; p < 2; p++) {
+            ok = ok && dijkstra_delta_stepping(g, 3, deltas[d], dist, pred, p ? pool : NULL, &error);
+            for (int v = 0; v < N && ok; v++) {
+                ok = dist[v] == ref[v];
+                if (ok && v != 3 && dist[v] != INT_MAX) {
+                    bool found = false;
+                    for (int i = 0; i < M; i++) found = found || (src[i] == pred[v] && dst[i] == v && dist[pred[v]] + w[i] == dist[v]);
+                    ok = found;
+                }
+            }
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    w[0] = -1;
+    graph_csr_t *neg = graph_csr_from_edges(N, src, dst, w, M);
+    EXPECT_FALSE(dijkstra_delta_stepping(neg, 0, 0, dist, NULL, pool, &error));
+    EXPECT_EQ(error, DIJKSTRA_ERROR_NEGATIVE_WEIGHT);
+    threadpool_destroy(pool);
+    graph_csr_free(neg);
+    graph_csr_free(g);
+    free(ref);
+    free(dist);
+    free(pred);
+    free(src);
+    free(dst);
+    free(w);
+}
+
 int main() {
     test_dijkstra_graph_create();
     test_dijkstra_graph_create_zero();
     test_dijkstra_add_edge();
     test_dijkstra_basic();
     test_dijkstra_strerror();
+    test_dijkstra_csr_random();
+    test_dijkstra_csr_negative();
+    test_dijkstra_many_to_many();
+    test_dijkstra_delta_stepping();
 
     return 0;
 }
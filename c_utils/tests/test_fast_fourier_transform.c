@@ -1,7 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <complex.h>
+#include <math.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/fast_fourier_transform.h"
 
@@ -82,12 +82,219 @@ void test_fft_inverse_basic() {
     }
 }
 
+// 复数数组按交错的实部/虚部访问 (头文件目录里的 complex.h 会遮住系统的 <complex.h>)
+#define RE(a, i) (((double *)(a))[2 * (i)])
+#define IM(a, i) (((double *)(a))[2 * (i) + 1])
+
+// 直接按定义计算 DFT 作为参考
+static void reference_dft(const double _Complex *in, double _Complex *out, size_t n) {
+    for (size_t k = 0; k < n; k++) {
+        long double sr = 0, si = 0;
+        for (size_t j = 0; j < n; j++) {
+            long double angle = -2.0L * 3.14159265358979323846264338327950288L * (long double)((j * k) % n) / (long double)n;
+            long double c = cosl(angle), s = sinl(angle);
+            sr += RE(in, j) * c - IM(in, j) * s;
+            si += RE(in, j) * s + IM(in, j) * c;
+        }
+        RE(out, k) = (double)sr;
+        IM(out, k) = (double)si;
+    }
+}
+
+static double max_error(const double _Complex *a, const double _Complex *b, size_t n) {
+    double err = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        double d = hypot(RE(a, i) - RE(b, i), IM(a, i) - IM(b, i));
+        if (d > err) err = d;
+    }
+    return err;
+}
+
+static void fill_random(double _Complex *a, size_t n, unsigned seed) {
+    srand(seed);
+    for (size_t i = 0; i < n; i++) {
+        RE(a, i) = rand() / (double)RAND_MAX - 0.5;
+        IM(a, i) = rand() / (double)RAND_MAX - 0.5;
+    }
+}
+
+void test_fft_plan_matches_dft() {
+    TEST(FFT_PlanMatchesDft);
+    bool ok = true;
+    for (size_t n = 1; n <= 1024; n *= 2) {
+        double _Complex *a = malloc(n * sizeof(double _Complex));
+        double _Complex *ref = malloc(n * sizeof(double _Complex));
+        fill_random(a, n, (unsigned)n);
+        reference_dft(a, ref, n);
+
+        fft_plan_t *plan = fft_plan_create(n);
+        ok = ok && plan != NULL && fft_plan_size(plan) == n;
+        fft_plan_forward(plan, a);
+        ok = ok && max_error(a, ref, n) < 1e-9 * (double)n;
+
+        // 标量路径 (use_optimized = false) 与 SIMD 路径结果一致
+        fft_config_t config = { .use_optimized = false, .check_size = true, .use_cached_windows = false };
+        fft_ctx_t *ctx = NULL;
+        fft_create(&ctx, &config);
+        fill_random(a, n, (unsigned)n);
+        ok = ok && fft_compute_safe(ctx, a, n) == FFT_OK;
+        ok = ok && max_error(a, ref, n) < 1e-9 * (double)n;
+        fft_destroy(ctx);
+
+        // 逆变换还原
+        fft_plan_inverse(plan, ref);
+        fill_random(a, n, (unsigned)n);
+        ok = ok && max_error(a, ref, n) < 1e-12 * (double)n;
+
+        fft_plan_destroy(plan);
+        free(a);
+        free(ref);
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(fft_plan_create(0) == NULL);
+    EXPECT_TRUE(fft_plan_create(12) == NULL);
+}
+
+void test_fft_large_roundtrip() {
+    TEST(FFT_LargeRoundtrip);
+    size_t n = 1 << 18;
+    double _Complex *a = malloc(n * sizeof(double _Complex));
+    double _Complex *orig = malloc(n * sizeof(double _Complex));
+    fill_random(orig, n, 7);
+    memcpy(a, orig, n * sizeof(double _Complex));
+
+    // 单频信号的能量集中在一个频点上
+    fft_plan_t *plan = fft_plan_create(n);
+    for (size_t i = 0; i < n; i++) {
+        double angle = 2.0 * M_PI * (double)(1234 * i % n) / (double)n;
+        RE(a, i) = cos(angle);
+        IM(a, i) = sin(angle);
+    }
+    fft_plan_forward(plan, a);
+    EXPECT_TRUE(hypot(RE(a, 1234) - (double)n, IM(a, 1234)) < 1e-6);
+    double leak = 0.0;
+    for (size_t i = 0; i < n; i++) if (i != 1234 && hypot(RE(a, i), IM(a, i)) > leak) leak = hypot(RE(a, i), IM(a, i));
+    EXPECT_TRUE(leak < 1e-6);
+
+    memcpy(a, orig, n * sizeof(double _Complex));
+    fft_plan_forward(plan, a);
+    fft_plan_inverse(plan, a);
+    EXPECT_TRUE(max_error(a, orig, n) < 1e-12);
+    fft_plan_destroy(plan);
+    free(a);
+    free(orig);
+}
+
+void test_fft_real() {
+    TEST(FFT_Real);
+    bool ok = true;
+    for (size_t n = 1; n <= 4096; n *= 2) {
+        double *x = malloc(n * sizeof(double));
+        double *back = malloc(n * sizeof(double));
+        double _Complex *full = malloc(n * sizeof(double _Complex));
+        double _Complex *half = malloc((n / 2 + 1) * sizeof(double _Complex));
+        srand((unsigned)n + 100);
+        for (size_t i = 0; i < n; i++) {
+            x[i] = rand() / (double)RAND_MAX - 0.5;
+            RE(full, i) = x[i];
+            IM(full, i) = 0.0;
+        }
+        fft_plan_t *plan = fft_plan_create(n);
+        fft_plan_forward(plan, full);
+        fft_plan_real_forward(plan, x, half);
+        ok = ok && max_error(half, full, n / 2 + 1) < 1e-10 * (double)n;
+
+        fft_plan_real_inverse(plan, half, back);
+        for (size_t i = 0; i < n; i++) ok = ok && fabs(back[i] - x[i]) < 1e-12 * (double)n;
+
+        // 上下文接口输出完整频谱
+        fft_ctx_t *ctx = NULL;
+        fft_create(&ctx, NULL);
+        double _Complex *out = malloc(n * sizeof(double _Complex));
+        ok = ok && fft_compute_real(ctx, x, n, out) == FFT_OK;
+        ok = ok && max_error(out, full, n) < 1e-10 * (double)n;
+        fft_destroy(ctx);
+
+        fft_plan_destroy(plan);
+        free(out);
+        free(x);
+        free(back);
+        free(full);
+        free(half);
+    }
+    EXPECT_TRUE(ok);
+}
+
+void test_fft_batch() {
+    TEST(FFT_Batch);
+    enum { COUNT = 24 };
+    double _Complex *arrays[COUNT];
+    double _Complex *expect[COUNT];
+    size_t sizes[COUNT];
+    threadpool_t *pool = threadpool_create(4);
+    fft_config_t config = { .use_optimized = true, .check_size = true, .use_cached_windows = true,
+                            .max_fft_size = 1 << 16, .max_batch_size = COUNT, .pool = pool };
+    fft_ctx_t *ctx = NULL;
+    fft_create(&ctx, &config);
+    for (int i = 0; i < COUNT; i++) {
+        sizes[i] = (size_t)1 << (4 + i % 13);
+        arrays[i] = malloc(sizes[i] * sizeof(double _Complex));
+        expect[i] = malloc(sizes[i] * sizeof(double _Complex));
+        fill_random(arrays[i], sizes[i], (unsigned)i);
+        memcpy(expect[i], arrays[i], sizes[i] * sizeof(double _Complex));
+        fft_compute(expect[i], sizes[i]);
+    }
+    EXPECT_EQ(fft_compute_batch(ctx, arrays, sizes, COUNT), FFT_OK);
+    bool ok = true;
+    for (int i = 0; i < COUNT; i++) ok = ok && max_error(arrays[i], expect[i], sizes[i]) < 1e-12;
+    EXPECT_TRUE(ok);
+    EXPECT_EQ((int)ctx->compute_count, COUNT);
+
+    // 任一长度不合法时整批不计算
+    sizes[3] = 100;
+    memcpy(arrays[0], expect[0], sizes[0] * sizeof(double _Complex));
+    EXPECT_EQ(fft_compute_batch(ctx, arrays, sizes, COUNT), FFT_UNSUPPORTED_SIZE);
+    EXPECT_TRUE(max_error(arrays[0], expect[0], sizes[0]) == 0.0);
+
+    for (int i = 0; i < COUNT; i++) {
+        free(arrays[i]);
+        free(expect[i]);
+    }
+    fft_destroy(ctx);
+    threadpool_destroy(pool);
+}
+
+void test_fft_odd_size() {
+    TEST(FFT_OddSize);
+    size_t n = 12;
+    double _Complex a[12], ref[12];
+    fill_random(a, n, 3);
+    reference_dft(a, ref, n);
+
+    fft_ctx_t *ctx = NULL;
+    fft_create(&ctx, NULL);
+    EXPECT_EQ(fft_compute_safe(ctx, a, n), FFT_UNSUPPORTED_SIZE);
+    EXPECT_EQ(fft_get_last_error(ctx), FFT_UNSUPPORTED_SIZE);
+    ctx->config.allow_odd_size = true;
+    EXPECT_EQ(fft_compute_safe(ctx, a, n), FFT_OK);
+    EXPECT_TRUE(max_error(a, ref, n) < 1e-12);
+    EXPECT_EQ(fft_inverse(ctx, a, n), FFT_OK);
+    fill_random(ref, n, 3);
+    EXPECT_TRUE(max_error(a, ref, n) < 1e-12);
+    fft_destroy(ctx);
+}
+
 int main() {
     test_fft_create_destroy();
     test_fft_create_null_config();
     test_fft_strerror();
     test_fft_compute_basic();
     test_fft_inverse_basic();
+    test_fft_plan_matches_dft();
+    test_fft_large_roundtrip();
+    test_fft_real();
+    test_fft_batch();
+    test_fft_odd_size();
 
     return 0;
 }
@@ -43,12 +43,127 @@ void test_floyd_warshall_free_null() {
     EXPECT_TRUE(true);
 }
 
+void test_floyd_warshall_csr() {
+    TEST(FloydWarshall_Csr);
+    // 0->1 有两条重边, 取较小权重
+    int src[] = { 0, 0, 1, 2, 0 };
+    int dst[] = { 1, 1, 2, 3, 3 };
+    int w[]   = { 9, 2, 3, -1, 10 };
+    graph_csr_t *g = graph_csr_from_edges(4, src, dst, w, 5);
+    floyd_result_t result;
+    floyd_error_t error;
+    EXPECT_TRUE(floyd_warshall_csr(g, &result, NULL, &error));
+    EXPECT_EQ(floyd_warshall_get_distance(&result, 0, 1, &error), 2);
+    EXPECT_EQ(floyd_warshall_get_distance(&result, 0, 3, &error), 4);
+    EXPECT_EQ(floyd_warshall_get_distance(&result, 3, 0, &error), FLOYD_INF);
+    size_t path[4], len = 0;
+    EXPECT_TRUE(floyd_warshall_reconstruct_path(&result, 0, 3, path, &len, 4, &error));
+    EXPECT_TRUE(len == 4 && path[1] == 1 && path[2] == 2);
+    floyd_warshall_free(&result);
+    graph_csr_free(g);
+}
+
+// 原始三重循环, 作为分块版本的参照
+static void floyd_reference(size_t n, int **d) {
+    for (size_t k = 0; k < n; k++) {
+        for (size_t i = 0; i < n; i++) {
+            for (size_t j = 0; j < n; j++) {
+                if (d[i][k] != FLOYD_INF && d[k][j] != FLOYD_INF && d[i][k] + d[k][j] < d[i][j]) {
+                    d[i][j] = d[i][k] + d[k][j];
+                }
+            }
+        }
+    }
+}
+
+// 随机稠密矩阵: 只有从小编号指向大编号的边可以为负 (至多 -2), 反向边权重不小于 1000,
+// 节点数不超过 500 时任何环的权重都非负
+static int** random_matrix(size_t n, unsigned seed, int density, bool negative_cycle) {
+    int **adj = malloc(n * sizeof(int*));
+    for (size_t i = 0; i < n; i++) {
+        adj[i] = malloc(n * sizeof(int));
+        for (size_t j = 0; j < n; j++) {
+            seed = seed * 1103515245u + 12345u;
+            int r = (int)((seed >> 8) % 100);
+            if (i == j) {
+                adj[i][j] = 0;
+            } else if (r >= density) {
+                adj[i][j] = FLOYD_INF;
+            } else {
+                adj[i][j] = i < j ? (int)((seed >> 4) % 5) - 2 : 1000 + (int)((seed >> 4) % 90);
+            }
+        }
+    }
+    if (negative_cycle) {
+        adj[n / 3][n / 2] = 1;
+        adj[n / 2][n / 3] = -1500;
+    }
+    return adj;
+}
+
+static void free_matrix(size_t n, int **adj) {
+    for (size_t i = 0; i < n; i++) free(adj[i]);
+    free(adj);
+}
+
+void test_floyd_warshall_blocked() {
+    TEST(FloydWarshall_Blocked);
+    threadpool_t *pool = threadpool_create(4);
+    // 节点数不是块大小的整数倍, 覆盖边缘块
+    size_t sizes[] = { 1, 5, 64, 130, 201 };
+    bool ok = true;
+    for (size_t t = 0; t < sizeof(sizes) / sizeof(sizes[0]); t++) {
+        size_t n = sizes[t];
+        int **adj = random_matrix(n, 7u + (unsigned)t, 20, false);
+        int **ref = random_matrix(n, 7u + (unsigned)t, 20, false);
+        floyd_reference(n, ref);
+        for (int use_pool = 0; use_pool < 2; use_pool++) {
+            floyd_result_t result;
+            floyd_error_t error;
+            ok = ok && floyd_warshall_parallel(n, (const int **)adj, &result, use_pool ? pool : NULL, &error);
+            ok = ok && error == FLOYD_OK && !result.has_negative_cycle;
+            for (size_t i = 0; ok && i < n; i++) {
+                for (size_t j = 0; j < n; j++) ok = ok && result.dist[i][j] == ref[i][j];
+            }
+            // 后继矩阵重建的路径权重之和等于最短距离
+            size_t *path = malloc(n * sizeof(size_t));
+            for (size_t i = 0; ok && i < n; i += 7) {
+                for (size_t j = 0; ok && j < n; j += 3) {
+                    size_t len = 0;
+                    if (ref[i][j] == FLOYD_INF) continue;
+                    ok = floyd_warshall_reconstruct_path(&result, i, j, path, &len, n, &error);
+                    int sum = 0;
+                    for (size_t p = 0; ok && p + 1 < len; p++) sum += adj[path[p]][path[p + 1]];
+                    ok = ok && path[0] == i && path[len - 1] == j && sum == ref[i][j];
+                }
+            }
+            free(path);
+            floyd_warshall_free(&result);
+        }
+        free_matrix(n, adj);
+        free_matrix(n, ref);
+    }
+    EXPECT_TRUE(ok);
+
+    // 负权环仍能检测到
+    int **adj = random_matrix(150, 99u, 20, true);
+    floyd_result_t result;
+    floyd_error_t error;
+    EXPECT_TRUE(floyd_warshall_parallel(150, (const int **)adj, &result, pool, &error));
+    EXPECT_TRUE(result.has_negative_cycle && error == FLOYD_ERROR_NEGATIVE_CYCLE);
+    floyd_warshall_free(&result);
+    free_matrix(150, adj);
+    threadpool_destroy(pool);
+}
+
 int main() {
     test_floyd_warshall_types();
     test_floyd_warshall_error_values();
     test_floyd_inf_value();
     test_floyd_warshall_result_fields();
     test_floyd_warshall_free_null();
+    test_floyd_warshall_csr();
+    test_floyd_warshall_blocked();
 
     return 0;
 }
@@ -0,0 +1,267 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../c_utils/utest.h"
+#include "../c_utils/frame_compress.h"
+
+#define TEST_BLOCK 4096
+
+static unsigned char *make_sample(size_t len) {
+    unsigned char *data = (unsigned char *)malloc(len);
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < len; i++) {
+        if ((i / 1000) % 3 == 0) {
+            seed = seed * 1103515245u + 12345u;
+            data[i] = (unsigned char)(seed >> 16);
+        } else if ((i / 1000) % 3 == 1) {
+            data[i] = (unsigned char)('a' + (i / 37) % 4);
+        } else {
+            data[i] = "log line: user=42 status=ok\n"[i % 28];
+        }
+    }
+    return data;
+}
+
+static void roundtrip_codec(frame_codec_t codec, threadpool_t *pool) {
+    size_t len = 300000;
+    unsigned char *input = make_sample(len);
+    size_t bound = frame_compress_bound(len, TEST_BLOCK);
+    unsigned char *packed = (unsigned char *)malloc(bound);
+    unsigned char *output = (unsigned char *)malloc(len);
+
+    frame_config_t config = frame_default_config();
+    config.codec = codec;
+    config.block_size = TEST_BLOCK;
+    config.pool = pool;
+
+    size_t packed_len = 0;
+    frame_stats_t stats;
+    EXPECT_EQ(frame_compress_buffer(input, len, packed, bound, &packed_len, &config, &stats), FRAME_OK);
+    EXPECT_EQ(stats.block_count, (len + TEST_BLOCK - 1) / TEST_BLOCK);
+    EXPECT_EQ(stats.compressed_size, packed_len);
+    EXPECT_TRUE(packed_len <= bound);
+
+    uint64_t size = 0;
+    EXPECT_EQ(frame_get_decompressed_size(packed, packed_len, &size), FRAME_OK);
+    EXPECT_EQ(size, len);
+
+    size_t out_len = 0;
+    EXPECT_EQ(frame_decompress_buffer(packed, packed_len, output, len, &out_len, &config, NULL), FRAME_OK);
+    EXPECT_EQ(out_len, len);
+    EXPECT_TRUE(memcmp(input, output, len) == 0);
+
+    free(input);
+    free(packed);
+    free(output);
+}
+
+void test_frame_roundtrip_codecs() {
+    TEST(Frame_RoundtripCodecs);
+    threadpool_t *pool = threadpool_create(4);
+    roundtrip_codec(FRAME_CODEC_STORE, pool);
+    roundtrip_codec(FRAME_CODEC_RLE, pool);
+    roundtrip_codec(FRAME_CODEC_LZW, pool);
+    roundtrip_codec(FRAME_CODEC_HUFFMAN, pool);
+    roundtrip_codec(FRAME_CODEC_DEFLATE, pool);
+    roundtrip_codec(FRAME_CODEC_DEFLATE, NULL);
+    threadpool_destroy(pool);
+}
+
+void test_frame_empty_input() {
+    TEST(Frame_EmptyInput);
+    unsigned char packed[128];
+    size_t packed_len = 0;
+    EXPECT_EQ(frame_compress_buffer(NULL, 0, packed, sizeof(packed), &packed_len, NULL, NULL), FRAME_OK);
+    EXPECT_EQ(packed_len, frame_compress_bound(0, 0));
+
+    size_t out_len = 1;
+    EXPECT_EQ(frame_decompress_buffer(packed, packed_len, NULL, 0, &out_len, NULL, NULL), FRAME_OK);
+    EXPECT_EQ(out_len, 0);
+}
+
+void test_frame_incompressible_blocks_stored() {
+    TEST(Frame_IncompressibleBlocksStored);
+    size_t len = TEST_BLOCK * 3;
+    unsigned char *input = (unsigned char *)malloc(len);
+    unsigned int seed = 7;
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245u + 12345u;
+        input[i] = (unsigned char)(seed >> 16);
+    }
+    size_t bound = frame_compress_bound(len, TEST_BLOCK);
+    unsigned char *packed = (unsigned char *)malloc(bound);
+
+    frame_config_t config = frame_default_config();
+    config.block_size = TEST_BLOCK;
+    size_t packed_len;
+    frame_stats_t stats;
+    EXPECT_EQ(frame_compress_buffer(input, len, packed, bound, &packed_len, &config, &stats), FRAME_OK);
+    EXPECT_EQ(stats.stored_blocks, 3);
+    EXPECT_EQ(packed_len, bound);
+
+    free(input);
+    free(packed);
+}
+
+void test_frame_corruption_detected() {
+    TEST(Frame_CorruptionDetected);
+    size_t len = 50000;
+    unsigned char *input = make_sample(len);
+    size_t bound = frame_compress_bound(len, TEST_BLOCK);
+    unsigned char *packed = (unsigned char *)malloc(bound);
+    unsigned char *output = (unsigned char *)malloc(len);
+
+    frame_config_t config = frame_default_config();
+    config.codec = FRAME_CODEC_STORE;
+    config.block_size = TEST_BLOCK;
+    size_t packed_len, out_len;
+    EXPECT_EQ(frame_compress_buffer(input, len, packed, bound, &packed_len, &config, NULL), FRAME_OK);
+
+    /* 第二块的数据被篡改 */
+    size_t pos = FRAME_HEADER_SIZE + FRAME_BLOCK_HEADER_SIZE + TEST_BLOCK + FRAME_BLOCK_HEADER_SIZE + 10;
+    packed[pos] ^= 0x55;
+    EXPECT_EQ(frame_decompress_buffer(packed, packed_len, output, len, &out_len, NULL, NULL),
+              FRAME_ERROR_CHECKSUM);
+    packed[pos] ^= 0x55;
+
+    /* 索引被篡改 */
+    packed[packed_len - FRAME_FOOTER_SIZE - 6] ^= 1;
+    EXPECT_EQ(frame_get_decompressed_size(packed, packed_len, &(uint64_t){0}), FRAME_ERROR_CHECKSUM);
+    packed[packed_len - FRAME_FOOTER_SIZE - 6] ^= 1;
+
+    EXPECT_EQ(frame_decompress_buffer(packed, packed_len - 1, output, len, &out_len, NULL, NULL),
+              FRAME_ERROR_INVALID_FORMAT);
+    EXPECT_EQ(frame_decompress_buffer(packed, packed_len, output, len - 1, &out_len, NULL, NULL),
+              FRAME_ERROR_BUFFER_TOO_SMALL);
+    EXPECT_EQ(frame_decompress_buffer(packed, packed_len, output, len, &out_len, NULL, NULL), FRAME_OK);
+
+    free(input);
+    free(packed);
+    free(output);
+}
+
+void test_frame_invalid_config() {
+    TEST(Frame_InvalidConfig);
+    unsigned char input[16] = {0};
+    unsigned char packed[256];
+    size_t packed_len;
+    frame_config_t config = frame_default_config();
+    config.block_size = 100;
+    EXPECT_EQ(frame_compress_buffer(input, sizeof(input), packed, sizeof(packed), &packed_len, &config, NULL),
+              FRAME_ERROR_INVALID_ARGS);
+    config = frame_default_config();
+    config.level = 0;
+    EXPECT_EQ(frame_compress_buffer(input, sizeof(input), packed, sizeof(packed), &packed_len, &config, NULL),
+              FRAME_ERROR_INVALID_ARGS);
+    config = frame_default_config();
+    EXPECT_EQ(frame_compress_buffer(input, sizeof(input), packed, 20, &packed_len, &config, NULL),
+              FRAME_ERROR_BUFFER_TOO_SMALL);
+}
+
+void test_frame_file_and_random_access() {
+    TEST(Frame_FileAndRandomAccess);
+    const char *raw_path = "/tmp/test_frame_raw.bin";
+    const char *packed_path = "/tmp/test_frame_packed.cuf";
+    const char *out_path = "/tmp/test_frame_out.bin";
+    size_t len = 200000;
+    unsigned char *input = make_sample(len);
+
+    FILE *fp = fopen(raw_path, "wb");
+    fwrite(input, 1, len, fp);
+    fclose(fp);
+
+    frame_config_t config = frame_default_config();
+    config.block_size = TEST_BLOCK;
+    config.max_inflight = 3;
+    frame_stats_t stats;
+    EXPECT_EQ(frame_compress_file(raw_path, packed_path, &config, &stats), FRAME_OK);
+    EXPECT_EQ(stats.raw_size, len);
+    EXPECT_TRUE(stats.compressed_size < len);
+
+    EXPECT_EQ(frame_decompress_file(packed_path, out_path, NULL, &stats), FRAME_OK);
+    EXPECT_EQ(stats.raw_size, len);
+    unsigned char *output = (unsigned char *)malloc(len);
+    fp = fopen(out_path, "rb");
+    EXPECT_EQ(fread(output, 1, len, fp), len);
+    fclose(fp);
+    EXPECT_TRUE(memcmp(input, output, len) == 0);
+
+    frame_error_t error;
+    frame_reader_t *reader = frame_reader_open(packed_path, &error);
+    EXPECT_TRUE(reader != NULL);
+    EXPECT_EQ(frame_reader_get_size(reader), len);
+    EXPECT_EQ(frame_reader_get_block_count(reader), (len + TEST_BLOCK - 1) / TEST_BLOCK);
+
+    /* 跨块读取、块内读取和读到末尾 */
+    const uint64_t offsets[] = {0, TEST_BLOCK - 5, 123457, len - 100};
+    unsigned char buf[10000];
+    for (size_t i = 0; i < sizeof(offsets) / sizeof(offsets[0]); i++) {
+        size_t got = 0;
+        EXPECT_EQ(frame_reader_read(reader, offsets[i], buf, sizeof(buf), &got), FRAME_OK);
+        size_t expected = len - offsets[i] < sizeof(buf) ? len - offsets[i] : sizeof(buf);
+        EXPECT_EQ(got, expected);
+        EXPECT_TRUE(memcmp(buf, input + offsets[i], got) == 0);
+    }
+    size_t got = 1;
+    EXPECT_EQ(frame_reader_read(reader, len, buf, 10, &got), FRAME_OK);
+    EXPECT_EQ(got, 0);
+    EXPECT_EQ(frame_reader_read(reader, len + 1, buf, 10, &got), FRAME_ERROR_OUT_OF_RANGE);
+    frame_reader_close(reader);
+
+    EXPECT_TRUE(frame_reader_open(raw_path, &error) == NULL);
+    EXPECT_EQ(error, FRAME_ERROR_INVALID_FORMAT);
+
+    remove(raw_path);
+    remove(packed_path);
+    remove(out_path);
+    free(input);
+    free(output);
+}
+
+void test_frame_huffman_long_codes() {
+    TEST(Frame_HuffmanLongCodes);
+    // 几何递减的频率让大部分字节得到 13-15 位的长码, 且长码在块内连续出现
+    size_t block = (size_t)1 << 20;
+    size_t len = 0;
+    unsigned char *input = (unsigned char *)malloc(block);
+    for (int i = 0; i < 14; i++) {
+        for (size_t k = 0; k < ((size_t)1 << (18 - i)); k++) input[len++] = (unsigned char)i;
+    }
+    for (int rep = 0; rep < 2; rep++) {
+        for (int s = 14; s < 256; s++) input[len++] = (unsigned char)s;
+    }
+    size_t bound = frame_compress_bound(len, block);
+    unsigned char *packed = (unsigned char *)malloc(bound);
+    unsigned char *output = (unsigned char *)malloc(len);
+
+    frame_config_t config = frame_default_config();
+    config.codec = FRAME_CODEC_HUFFMAN;
+    config.block_size = block;
+    size_t packed_len = 0;
+    frame_stats_t stats;
+    EXPECT_EQ(frame_compress_buffer(input, len, packed, bound, &packed_len, &config, &stats), FRAME_OK);
+    // 数据高度可压缩, 块应当以 Huffman 编码写出而不是退回存储
+    EXPECT_EQ(stats.stored_blocks, 0);
+    EXPECT_TRUE(packed_len < len / 2);
+
+    size_t out_len = 0;
+    EXPECT_EQ(frame_decompress_buffer(packed, packed_len, output, len, &out_len, &config, NULL), FRAME_OK);
+    EXPECT_EQ(out_len, len);
+    EXPECT_TRUE(memcmp(input, output, len) == 0);
+
+    free(input);
+    free(packed);
+    free(output);
+}
+
+int main() {
+    test_frame_roundtrip_codecs();
+    test_frame_huffman_long_codes();
+    test_frame_empty_input();
+    test_frame_incompressible_blocks_stored();
+    test_frame_corruption_detected();
+    test_frame_invalid_config();
+    test_frame_file_and_random_access();
+
+    return 0;
+}
@@ -0,0 +1,245 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <string.h>
+#include "../c_utils/utest.h"
+#include "../c_utils/graph_csr.h"
+
+void test_graph_csr_from_edges() {
+    TEST(GraphCsr_FromEdges);
+    int src[] = { 2, 0, 1, 0, 2 };
+    int dst[] = { 0, 1, 2, 2, 1 };
+    int w[]   = { 7, 1, 3, 4, 5 };
+    graph_csr_t *g = graph_csr_from_edges(4, src, dst, w, 5);
+    EXPECT_TRUE(g != NULL);
+    EXPECT_EQ((int)g->nodes, 4);
+    EXPECT_EQ((int)g->edges, 5);
+
+    // 同一起点的边保持输入顺序
+    const int *to, *weight;
+    EXPECT_EQ((int)graph_csr_neighbors(g, 0, &to, &weight), 2);
+    EXPECT_TRUE(to[0] == 1 && weight[0] == 1 && to[1] == 2 && weight[1] == 4);
+    EXPECT_EQ((int)graph_csr_neighbors(g, 2, &to, &weight), 2);
+    EXPECT_TRUE(to[0] == 0 && weight[0] == 7 && to[1] == 1 && weight[1] == 5);
+    EXPECT_EQ((int)graph_csr_degree(g, 1), 1);
+    EXPECT_EQ((int)graph_csr_degree(g, 3), 0);
+    graph_csr_free(g);
+
+    // 越界节点与无权图
+    EXPECT_TRUE(graph_csr_from_edges(2, src, dst, w, 5) == NULL);
+    g = graph_csr_from_edges(3, src, dst, NULL, 5);
+    EXPECT_TRUE(g != NULL && g->weights[0] == 1);
+    graph_csr_free(g);
+    g = graph_csr_from_edges(3, NULL, NULL, NULL, 0);
+    EXPECT_TRUE(g != NULL && g->edges == 0 && graph_csr_degree(g, 2) == 0);
+    graph_csr_free(g);
+}
+
+void test_graph_csr_builder() {
+    TEST(GraphCsr_Builder);
+    graph_csr_builder_t *b = graph_csr_builder_create(0);
+    EXPECT_TRUE(b != NULL);
+    EXPECT_FALSE(graph_csr_builder_add_edge(b, -1, 0, 1));
+
+    // 环形图, 每个节点两条出边, 节点数随边自动扩大
+    enum { N = 5000 };
+    bool ok = true;
+    for (int i = 0; i < N; i++) {
+        ok = ok && graph_csr_builder_add_edge(b, i, (i + 1) % N, i);
+        ok = ok && graph_csr_builder_add_edge(b, i, (i + N - 1) % N, -i);
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ((int)graph_csr_builder_edge_count(b), 2 * N);
+
+    graph_csr_t *g = graph_csr_builder_build(b);
+    graph_csr_builder_free(b);
+    EXPECT_TRUE(g != NULL);
+    EXPECT_EQ((int)g->nodes, N);
+    for (int i = 0; i < N && ok; i++) {
+        const int *to, *weight;
+        ok = graph_csr_neighbors(g, i, &to, &weight) == 2 &&
+             to[0] == (i + 1) % N && weight[0] == i &&
+             to[1] == (i + N - 1) % N && weight[1] == -i;
+    }
+    EXPECT_TRUE(ok);
+    graph_csr_free(g);
+}
+
+void test_graph_csr_edge_list() {
+    TEST(GraphCsr_EdgeList);
+    FILE *fp = tmpfile();
+    EXPECT_TRUE(fp != NULL);
+    if (!fp) return;
+    fputs("# comment\n% another\n0 1 5\n\n1\t2\n  2 0 -3  \r\n3 3 7", fp);
+    rewind(fp);
+    graph_csr_t *g = graph_csr_read_edge_list(fp, true);
+    EXPECT_TRUE(g != NULL);
+    if (g) {
+        // 无向图每条边两个方向, 自环只存一次
+        EXPECT_EQ((int)g->nodes, 4);
+        EXPECT_EQ((int)g->edges, 7);
+        const int *to, *weight;
+        EXPECT_EQ((int)graph_csr_neighbors(g, 0, &to, &weight), 2);
+        EXPECT_TRUE(to[0] == 1 && weight[0] == 5 && to[1] == 2 && weight[1] == -3);
+        EXPECT_EQ((int)graph_csr_neighbors(g, 1, &to, &weight), 2);
+        EXPECT_TRUE(to[0] == 0 && to[1] == 2 && weight[1] == 1);
+        EXPECT_EQ((int)graph_csr_degree(g, 3), 1);
+        graph_csr_free(g);
+    }
+
+    // 跨越读取块边界的大文件
+    rewind(fp);
+    EXPECT_EQ(ftruncate(fileno(fp), 0), 0);
+    for (int i = 0; i < 30000; i++) fprintf(fp, "%d %d %d\n", i, (i * 7 + 1) % 30000, i % 13);
+    rewind(fp);
+    g = graph_csr_read_edge_list(fp, false);
+    bool ok = g != NULL && g->edges == 30000;
+    for (int i = 0; ok && i < 30000; i++) {
+        const int *to, *weight;
+        ok = graph_csr_neighbors(g, i, &to, &weight) == 1 && to[0] == (i * 7 + 1) % 30000 && weight[0] == i % 13;
+    }
+    EXPECT_TRUE(ok);
+    graph_csr_free(g);
+
+    // 格式错误
+    rewind(fp);
+    EXPECT_EQ(ftruncate(fileno(fp), 0), 0);
+    fputs("0 1\n1 x\n", fp);
+    rewind(fp);
+    EXPECT_TRUE(graph_csr_read_edge_list(fp, false) == NULL);
+    fclose(fp);
+    EXPECT_TRUE(graph_csr_load_edge_list("/nonexistent/edges.txt", false) == NULL);
+}
+
+void test_graph_csr_transpose() {
+    TEST(GraphCsr_Transpose);
+    int src[] = { 0, 0, 1, 2, 2 };
+    int dst[] = { 1, 2, 2, 0, 1 };
+    int w[]   = { 1, 2, 3, 4, 5 };
+    graph_csr_t *g = graph_csr_from_edges(3, src, dst, w, 5);
+    graph_csr_t *t = graph_csr_transpose(g);
+    EXPECT_TRUE(t != NULL && t->edges == 5);
+    const int *to, *weight;
+    EXPECT_EQ((int)graph_csr_neighbors(t, 2, &to, &weight), 2);
+    EXPECT_TRUE(to[0] == 0 && weight[0] == 2 && to[1] == 1 && weight[1] == 3);
+    EXPECT_EQ((int)graph_csr_neighbors(t, 1, &to, &weight), 2);
+    EXPECT_TRUE(to[0] == 0 && weight[0] == 1 && to[1] == 2 && weight[1] == 5);
+    graph_csr_free(t);
+    graph_csr_free(g);
+}
+
+// 参照实现: 普通队列 BFS
+static void bfs_reference(const graph_csr_t *g, int source, int *depth) {
+    int *queue = malloc(g->nodes * sizeof(int));
+    for (size_t i = 0; i < g->nodes; i++) depth[i] = -1;
+    size_t head = 0, tail = 0;
+    depth[source] = 0;
+    queue[tail++] = source;
+    while (head < tail) {
+        int u = queue[head++];
+        const int *to;
+        size_t degree = graph_csr_neighbors(g, u, &to, NULL);
+        for (size_t i = 0; i < degree; i++) {
+            if (depth[to[i]] == -1) {
+                depth[to[i]] = depth[u] + 1;
+                queue[tail++] = to[i];
+            }
+        }
+    }
+    free(queue);
+}
+
+void test_graph_csr_bfs() {
+    TEST(GraphCsr_Bfs);
+    // 随机有向图: 平均出度 8, 足以触发自底向上
+    enum { N = 20000, M = 160000 };
+    int *src = malloc(M * sizeof(int)), *dst = malloc(M * sizeof(int));
+    uint32_t seed = 2024;
+    for (int i = 0; i < M; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        src[i] = (int)(seed % N);
+        seed = seed * 1664525u + 1013904223u;
+        dst[i] = (int)(seed % N);
+    }
+    graph_csr_t *g = graph_csr_from_edges(N, src, dst, NULL, M);
+    graph_csr_t *rev = graph_csr_transpose(g);
+    int *ref = malloc(N * sizeof(int)), *depth = malloc(N * sizeof(int)), *parent = malloc(N * sizeof(int));
+    bfs_reference(g, 0, ref);
+    size_t expected = 0;
+    for (int i = 0; i < N; i++) expected += ref[i] >= 0;
+
+    threadpool_t *pool = threadpool_create(4);
+    bool ok = true;
+    for (int mode = 0; mode < 4; mode++) {
+        const graph_csr_t *r = (mode & 1) ? rev : NULL;
+        size_t reached = graph_csr_bfs(g, r, 0, parent, depth, (mode & 2) ? pool : NULL);
+        ok = ok && reached == expected;
+        for (int v = 0; v < N && ok; v++) {
+            ok = depth[v] == ref[v];
+            // 父节点在上一层且有边指向 v
+            if (ok && depth[v] > 0) {
+                int p = parent[v];
+                const int *to;
+                size_t degree = graph_csr_neighbors(g, p, &to, NULL);
+                bool has_edge = false;
+                for (size_t k = 0; k < degree; k++) has_edge = has_edge || to[k] == v;
+                ok = depth[p] == depth[v] - 1 && has_edge;
+            } else if (ok) {
+                ok = parent[v] == (depth[v] == 0 ? 0 : -1);
+            }
+        }
+    }
+    EXPECT_TRUE(ok);
+    bfs_reference(g, 5, ref);
+    expected = 0;
+    for (int i = 0; i < N; i++) expected += ref[i] >= 0;
+    EXPECT_EQ((int)graph_csr_bfs(g, rev, 5, NULL, NULL, pool), (int)expected);
+    EXPECT_EQ((int)graph_csr_bfs(g, NULL, N, NULL, NULL, NULL), 0);
+    threadpool_destroy(pool);
+
+    free(ref);
+    free(depth);
+    free(parent);
+    free(src);
+    free(dst);
+    graph_csr_free(rev);
+    graph_csr_free(g);
+}
+
+typedef struct {
+    int *hits;
+} pfor_check_t;
+
+static void pfor_mark(void *ctx, size_t begin, size_t end, int worker) {
+    (void)worker;
+    pfor_check_t *c = ctx;
+    for (size_t i = begin; i < end; i++) __atomic_fetch_add(&c->hits[i], 1, __ATOMIC_RELAXED);
+}
+
+void test_graph_csr_parallel_for() {
+    TEST(GraphCsr_ParallelFor);
+    enum { COUNT = 100003 };
+    pfor_check_t c = { calloc(COUNT, sizeof(int)) };
+    threadpool_t *pool = threadpool_create(3);
+    EXPECT_EQ(graph_csr_worker_count(pool), 3);
+    EXPECT_EQ(graph_csr_worker_count(NULL), 1);
+    graph_csr_parallel_for(pool, COUNT, 1000, pfor_mark, &c);
+    graph_csr_parallel_for(NULL, COUNT, 1000, pfor_mark, &c);
+    bool ok = true;
+    for (int i = 0; i < COUNT; i++) ok = ok && c.hits[i] == 2;
+    EXPECT_TRUE(ok);
+    threadpool_destroy(pool);
+    free(c.hits);
+}
+
+int main() {
+    UTEST_BEGIN();
+    test_graph_csr_from_edges();
+    test_graph_csr_builder();
+    test_graph_csr_edge_list();
+    test_graph_csr_transpose();
+    test_graph_csr_bfs();
+    test_graph_csr_parallel_for();
+    UTEST_END();
+}
@@ -54,12 +54,193 @@ void test_huffman_stats_single() {
     EXPECT_EQ(freq['a'], (size_t)1);
 }
 
+void test_huffman_tree_roundtrip() {
+    TEST(Huffman_TreeRoundtrip);
+    const char *text = "abracadabra alakazam";
+    size_t len = strlen(text);
+    size_t freq[256];
+    huffman_stats((const unsigned char*)text, len, freq);
+
+    huffman_error_t error;
+    huffman_node_t *root = huffman_create_tree(freq, &error);
+    EXPECT_TRUE(root != NULL);
+
+    huffman_code_t table[256];
+    EXPECT_EQ(huffman_build_code_table(root, table, &error), 0);
+
+    unsigned char encoded[64];
+    unsigned char decoded[64];
+    size_t enc_len = huffman_encode((const unsigned char*)text, len, encoded, sizeof(encoded), table, &error);
+    EXPECT_EQ(error, HUFFMAN_OK);
+    size_t dec_len = huffman_decode(encoded, enc_len, decoded, len, root, &error);
+    EXPECT_EQ(dec_len, len);
+    EXPECT_TRUE(memcmp(text, decoded, len) == 0);
+
+    huffman_free_tree(root);
+}
+
+void test_huffman_length_limit() {
+    TEST(Huffman_LengthLimit);
+    // 斐波那契频率会产生很深的最优树, 码长必须被限制在上限内
+    size_t freq[256] = {0};
+    size_t a = 1, b = 1;
+    for (int i = 0; i < 40; i++) {
+        freq[i] = a;
+        size_t c = a + b;
+        a = b;
+        b = c;
+    }
+
+    unsigned char lengths[256];
+    EXPECT_EQ(huffman_build_lengths(freq, HUFFMAN_MAX_CODE_LEN, lengths), HUFFMAN_OK);
+
+    unsigned int kraft = 0;
+    for (int i = 0; i < 256; i++) {
+        EXPECT_TRUE(lengths[i] <= HUFFMAN_MAX_CODE_LEN);
+        EXPECT_EQ(lengths[i] > 0, freq[i] > 0);
+        if (lengths[i]) kraft += 1u << (HUFFMAN_MAX_CODE_LEN - lengths[i]);
+    }
+    EXPECT_TRUE(kraft <= (1u << HUFFMAN_MAX_CODE_LEN));
+}
+
+void test_huffman_canonical_codes() {
+    TEST(Huffman_CanonicalCodes);
+    unsigned char lengths[256] = {0};
+    lengths['a'] = 1;
+    lengths['b'] = 2;
+    lengths['c'] = 3;
+    lengths['d'] = 3;
+
+    huffman_code_t table[256];
+    EXPECT_EQ(huffman_build_canonical_table(lengths, table), HUFFMAN_OK);
+    EXPECT_EQ(table['a'].code, 0u);
+    EXPECT_EQ(table['b'].code, 2u);
+    EXPECT_EQ(table['c'].code, 6u);
+    EXPECT_EQ(table['d'].code, 7u);
+
+    // 超额订阅的码长集合无法构成前缀码
+    lengths['e'] = 1;
+    EXPECT_EQ(huffman_build_canonical_table(lengths, table), HUFFMAN_TREE_ERROR);
+}
+
+void test_huffman_lengths_serialization() {
+    TEST(Huffman_LengthsSerialization);
+    unsigned char lengths[256];
+    for (int i = 0; i < 256; i++) lengths[i] = (unsigned char)(i % 16);
+
+    unsigned char buf[HUFFMAN_LENGTHS_SIZE];
+    unsigned char restored[256];
+    EXPECT_EQ(huffman_write_lengths(lengths, buf, sizeof(buf)), (size_t)HUFFMAN_LENGTHS_SIZE);
+    EXPECT_EQ(huffman_read_lengths(buf, sizeof(buf), restored), (size_t)HUFFMAN_LENGTHS_SIZE);
+    EXPECT_TRUE(memcmp(lengths, restored, 256) == 0);
+    EXPECT_EQ(huffman_write_lengths(lengths, buf, 10), (size_t)0);
+}
+
+void test_huffman_compress_roundtrip() {
+    TEST(Huffman_CompressRoundtrip);
+    size_t len = 300000;
+    unsigned char *input = malloc(len);
+    unsigned int seed = 42;
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        unsigned int r = (seed >> 16) & 0xFF;
+        // 偏斜分布: 大部分是少数字符, 偶尔出现稀有字节以产生长码
+        input[i] = r < 200 ? (unsigned char)('a' + r % 6) : (unsigned char)r;
+    }
+
+    size_t cap = huffman_compress_bound(len);
+    unsigned char *packed = malloc(cap);
+    unsigned char *output = malloc(len);
+    huffman_error_t error;
+
+    size_t packed_len = huffman_compress(input, len, packed, cap, &error);
+    EXPECT_EQ(error, HUFFMAN_OK);
+    EXPECT_TRUE(packed_len > 0 && packed_len < len);
+
+    size_t out_len = huffman_decompress(packed, packed_len, output, len, &error);
+    EXPECT_EQ(error, HUFFMAN_OK);
+    EXPECT_EQ(out_len, len);
+    EXPECT_TRUE(memcmp(input, output, len) == 0);
+
+    // 截断的位流必须报错, 而不是把补齐的 0 当作数据
+    huffman_decompress(packed, packed_len - 16, output, len, &error);
+    EXPECT_EQ(error, HUFFMAN_DECODE_ERROR);
+
+    free(input);
+    free(packed);
+    free(output);
+}
+
+void test_huffman_compress_single_symbol() {
+    TEST(Huffman_CompressSingleSymbol);
+    unsigned char input[100];
+    memset(input, 'z', sizeof(input));
+
+    unsigned char packed[512];
+    unsigned char output[100];
+    huffman_error_t error;
+
+    size_t packed_len = huffman_compress(input, sizeof(input), packed, sizeof(packed), &error);
+    EXPECT_EQ(error, HUFFMAN_OK);
+    size_t out_len = huffman_decompress(packed, packed_len, output, sizeof(output), &error);
+    EXPECT_EQ(error, HUFFMAN_OK);
+    EXPECT_EQ(out_len, sizeof(input));
+    EXPECT_TRUE(memcmp(input, output, sizeof(input)) == 0);
+}
+
+void test_huffman_long_codes_roundtrip() {
+    TEST(Huffman_LongCodesRoundtrip);
+    // 几何递减的频率把其余 242 个只出现两次的字节压到 13-15 位的长码,
+    // 它们在数据里连续出现, 一次补充的 56 位不够连续 4 个慢速解码
+    size_t len = 0;
+    unsigned char *input = malloc((size_t)1 << 20);
+    for (int i = 0; i < 14; i++) {
+        for (size_t k = 0; k < ((size_t)1 << (18 - i)); k++) input[len++] = (unsigned char)i;
+    }
+    for (int rep = 0; rep < 2; rep++) {
+        for (int s = 14; s < 256; s++) input[len++] = (unsigned char)s;
+    }
+
+    size_t freq[256] = {0};
+    unsigned char lengths[256];
+    huffman_stats(input, len, freq);
+    EXPECT_EQ(huffman_build_lengths(freq, HUFFMAN_MAX_CODE_LEN, lengths), HUFFMAN_OK);
+    int long_codes = 0;
+    for (int i = 0; i < 256; i++) {
+        if (lengths[i] > HUFFMAN_LOOKUP_BITS) long_codes++;
+    }
+    EXPECT_TRUE(long_codes >= 200);
+
+    size_t cap = huffman_compress_bound(len);
+    unsigned char *packed = malloc(cap);
+    unsigned char *output = malloc(len);
+    huffman_error_t error;
+
+    size_t packed_len = huffman_compress(input, len, packed, cap, &error);
+    EXPECT_EQ(error, HUFFMAN_OK);
+    size_t out_len = huffman_decompress(packed, packed_len, output, len, &error);
+    EXPECT_EQ(error, HUFFMAN_OK);
+    EXPECT_EQ(out_len, len);
+    EXPECT_TRUE(memcmp(input, output, len) == 0);
+
+    free(input);
+    free(packed);
+    free(output);
+}
+
 int main() {
     test_huffman_stats();
     test_huffman_create_free_tree();
     test_huffman_get_default_config();
     test_huffman_stats_empty();
     test_huffman_stats_single();
+    test_huffman_tree_roundtrip();
+    test_huffman_length_limit();
+    test_huffman_canonical_codes();
+    test_huffman_lengths_serialization();
+    test_huffman_compress_roundtrip();
+    test_huffman_compress_single_symbol();
+    test_huffman_long_codes_roundtrip();
 
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/kruskal.h"
 
@@ -48,12 +49,86 @@ void test_kruskal_result() {
     EXPECT_TRUE(sizeof(result) > 0);
 }
 
+// 随机无向图 (两个方向), 返回 CSR
+static graph_csr_t* random_undirected(int n, int m, unsigned seed, bool connect) {
+    graph_csr_builder_t *b = graph_csr_builder_create((size_t)n);
+    if (connect) {
+        for (int i = 1; i < n; i++) {
+            seed = seed * 1103515245u + 12345u;
+            int p = (int)((seed >> 8) % (unsigned)i);
+            int w = (int)((seed >> 4) % 50);
+            graph_csr_builder_add_edge(b, i, p, w);
+            graph_csr_builder_add_edge(b, p, i, w);
+        }
+    }
+    for (int i = 0; i < m; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int u = (int)((seed >> 8) % (unsigned)n);
+        seed = seed * 1103515245u + 12345u;
+        int v = (int)((seed >> 8) % (unsigned)n);
+        int w = (int)((seed >> 4) % 50);
+        graph_csr_builder_add_edge(b, u, v, w);
+        graph_csr_builder_add_edge(b, v, u, w);
+    }
+    graph_csr_t *g = graph_csr_builder_build(b);
+    graph_csr_builder_free(b);
+    return g;
+}
+
+void test_kruskal_csr_and_boruvka() {
+    TEST(Kruskal_CsrAndBoruvka);
+    threadpool_t *pool = threadpool_create(4);
+    kruskal_error_t error;
+    bool ok = true;
+    for (int trial = 0; trial < 3; trial++) {
+        graph_csr_t *g = random_undirected(2000 + trial * 500, 8000, 17u + (unsigned)trial, true);
+        kruskal_result_t *k = kruskal_mst_csr(g, &error);
+        ok = ok && k && error == KRUSKAL_OK && k->edge_count + 1 == g->nodes;
+
+        // 与原 Kruskal 接口结果一致
+        size_t m = 0;
+        kruskal_edge_t *edges = malloc(g->edges * sizeof(kruskal_edge_t));
+        for (size_t u = 0; u < g->nodes; u++) {
+            for (size_t i = g->offsets[u]; i < g->offsets[u + 1]; i++) {
+                if ((size_t)g->targets[i] > u) edges[m++] = (kruskal_edge_t){ (int)u, g->targets[i], g->weights[i] };
+            }
+        }
+        ok = ok && kruskal_mst((int)g->nodes, (int)m, edges) == k->total_weight;
+        free(edges);
+
+        for (int p = 0; p < 2; p++) {
+            kruskal_result_t *b = kruskal_boruvka_csr(g, p ? pool : NULL, &error);
+            ok = ok && b && error == KRUSKAL_OK && b->total_weight == k->total_weight && b->edge_count == k->edge_count;
+            kruskal_free_result(b);
+        }
+        kruskal_free_result(k);
+        graph_csr_free(g);
+    }
+    EXPECT_TRUE(ok);
+
+    // 不连通图得到最小生成森林
+    int src[] = { 0, 1, 2, 3 };
+    int dst[] = { 1, 0, 3, 2 };
+    int w[]   = { 5, 5, 7, 7 };
+    graph_csr_t *g = graph_csr_from_edges(5, src, dst, w, 4);
+    kruskal_result_t *k = kruskal_mst_csr(g, &error);
+    kruskal_result_t *b = kruskal_boruvka_csr(g, pool, &error);
+    EXPECT_EQ(error, KRUSKAL_DISCONNECTED);
+    EXPECT_TRUE(k && b && k->has_error && b->has_error);
+    EXPECT_TRUE(k && b && k->total_weight == 12 && b->total_weight == 12 && b->edge_count == 2);
+    kruskal_free_result(k);
+    kruskal_free_result(b);
+    graph_csr_free(g);
+    threadpool_destroy(pool);
+}
+
 int main() {
     test_kruskal_types();
     test_kruskal_error_values();
     test_kruskal_default_config();
     test_kruskal_edge_fields();
     test_kruskal_result();
+    test_kruskal_csr_and_boruvka();
 
     return 0;
 }
@@ -3,6 +3,12 @@
 #include <string.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/kv_store.h"
+#include "../c_utils/kv_pager.h"
+#include "../c_utils/kv_lsm.h"
+#include <unistd.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
 
 void test_kv_types() {
     TEST(KV_Types);
@@ -50,12 +56,529 @@ void test_kv_exists() {
     EXPECT_FALSE(exists);
 }
 
+static kv_store_t* open_fresh(const char *path) {
+    kv_config_t config;
+    kv_get_default_config(&config);
+    config.max_value_length = 0;
+    config.sync_on_commit = false;
+    unlink(path);
+    return kv_store_open(path, &config, NULL);
+}
+
+void test_kv_store_many_keys() {
+    TEST(KV_StoreManyKeys);
+    const char *path = "/tmp/test_kv_store_many.kv";
+    kv_store_t *store = open_fresh(path);
+    EXPECT_TRUE(store != NULL);
+
+    char key[32], value[64], buffer[64];
+    bool ok = true;
+    for (int i = 0; i < 5000; i++) {
+        snprintf(key, sizeof(key), "key%05d", (i * 7919) % 5000);
+        snprintf(value, sizeof(value), "value-%d", (i * 7919) % 5000);
+        ok = ok && kv_store_put(store, key, value, strlen(value)) == KV_OK;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ((int)kv_store_count(store), 5000);
+
+    for (int i = 0; i < 5000 && ok; i++) {
+        size_t len;
+        snprintf(key, sizeof(key), "key%05d", i);
+        snprintf(value, sizeof(value), "value-%d", i);
+        ok = kv_store_get(store, key, buffer, sizeof(buffer), &len) == KV_OK && len == strlen(value) &&
+             memcmp(buffer, value, len) == 0;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_FALSE(kv_store_exists(store, "key99999"));
+
+    kv_store_close(store);
+    unlink(path);
+}
+
+static bool check_order(const char *key, const char *value, size_t value_len, void *user_data) {
+    char *prev = (char *)user_data;
+    (void)value;
+    (void)value_len;
+    if (prev[0] && strcmp(prev, key) >= 0) {
+        prev[0] = '!';
+        return false;
+    }
+    strcpy(prev, key);
+    return true;
+}
+
+void test_kv_store_overwrite_delete() {
+    TEST(KV_StoreOverwriteDelete);
+    const char *path = "/tmp/test_kv_store_delete.kv";
+    kv_store_t *store = open_fresh(path);
+    EXPECT_TRUE(store != NULL);
+
+    char key[32];
+    for (int i = 0; i < 3000; i++) {
+        snprintf(key, sizeof(key), "k%04d", i);
+        kv_store_put(store, key, "a", 1);
+    }
+    EXPECT_EQ(kv_store_put(store, "k0001", "bb", 2), KV_OK);
+    EXPECT_EQ((int)kv_store_count(store), 3000);
+
+    char buffer[8];
+    size_t len = 0;
+    EXPECT_EQ(kv_store_get(store, "k0001", buffer, 1, &len), KV_BUFFER_TOO_SMALL);
+    EXPECT_EQ((int)len, 2);
+
+    bool ok = true;
+    for (int i = 0; i < 3000; i += 2) {
+        snprintf(key, sizeof(key), "k%04d", i);
+        ok = ok && kv_store_delete(store, key) == KV_OK;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(kv_store_delete(store, "k0000"), KV_KEY_NOT_FOUND);
+    EXPECT_EQ((int)kv_store_count(store), 1500);
+    EXPECT_TRUE(kv_store_exists(store, "k0001"));
+    EXPECT_FALSE(kv_store_exists(store, "k0002"));
+
+    char prev[64] = "";
+    EXPECT_EQ(kv_store_foreach(store, check_order, prev), KV_OK);
+    EXPECT_TRUE(strcmp(prev, "k2999") == 0);
+
+    // 删空后空闲页被复用, 重新写入同样的数据不会增长文件
+    for (int i = 1; i < 3000; i += 2) {
+        snprintf(key, sizeof(key), "k%04d", i);
+        kv_store_delete(store, key);
+    }
+    EXPECT_EQ((int)kv_store_count(store), 0);
+    kv_store_close(store);
+
+    size_t stats_count = 0, size_before = 0, size_after = 0;
+    kv_get_stats(path, &stats_count, &size_before);
+    store = kv_store_open(path, NULL, NULL);
+    for (int i = 0; i < 3000; i++) {
+        snprintf(key, sizeof(key), "k%04d", i);
+        kv_store_put(store, key, "a", 1);
+    }
+    kv_store_close(store);
+    kv_get_stats(path, &stats_count, &size_after);
+    EXPECT_EQ((int)stats_count, 3000);
+    EXPECT_TRUE(size_after <= size_before);
+    unlink(path);
+}
+
+void test_kv_store_large_values() {
+    TEST(KV_StoreLargeValues);
+    const char *path = "/tmp/test_kv_store_large.kv";
+    kv_store_t *store = open_fresh(path);
+    EXPECT_TRUE(store != NULL);
+
+    size_t size = 100000;
+    char *value = malloc(size);
+    char *out = malloc(size);
+    for (size_t i = 0; i < size; i++) value[i] = (char)('a' + i % 26);
+
+    EXPECT_EQ(kv_store_put(store, "big", value, size), KV_OK);
+    EXPECT_EQ(kv_store_put(store, "small", "x", 1), KV_OK);
+    size_t len = 0;
+    EXPECT_EQ(kv_store_get(store, "big", out, size, &len), KV_OK);
+    EXPECT_TRUE(len == size && memcmp(out, value, size) == 0);
+
+    // 替换与删除时回收溢出页
+    value[0] = 'Z';
+    EXPECT_EQ(kv_store_put(store, "big", value, size / 2), KV_OK);
+    EXPECT_EQ(kv_store_get(store, "big", out, size, &len), KV_OK);
+    EXPECT_TRUE(len == size / 2 && out[0] == 'Z');
+    EXPECT_EQ(kv_store_delete(store, "big"), KV_OK);
+    EXPECT_EQ(kv_store_put(store, "big", value, size / 2), KV_OK);
+    EXPECT_EQ(kv_store_get(store, "big", out, size, &len), KV_OK);
+    EXPECT_TRUE(len == size / 2 && memcmp(out, value, len) == 0);
+
+    kv_store_close(store);
+    free(value);
+    free(out);
+    unlink(path);
+}
+
+void test_kv_store_persistence() {
+    TEST(KV_StorePersistence);
+    const char *path = "/tmp/test_kv_store_persist.kv";
+    unlink(path);
+
+    kv_entry_t entries[] = { { "alpha", "1" }, { "beta", "2" }, { "gamma", "3" } };
+    EXPECT_EQ(kv_save_batch(path, entries, 3), KV_OK);
+    EXPECT_TRUE(kv_save(path, "delta", "4"));
+    EXPECT_TRUE(kv_pager_is_page_file(path));
+
+    char *value = kv_load(path, "beta");
+    EXPECT_TRUE(value && strcmp(value, "2") == 0);
+    free(value);
+
+    kv_error_t error;
+    kv_entry_t *all = NULL;
+    size_t count = kv_get_all(path, &all, &error);
+    EXPECT_EQ(error, KV_OK);
+    EXPECT_EQ((int)count, 4);
+    EXPECT_TRUE(count == 4 && strcmp(all[0].key, "alpha") == 0 && strcmp(all[3].key, "gamma") == 0);
+    kv_free_entries(all, count);
+
+    size_t entry_count = 0, file_size = 0;
+    EXPECT_EQ(kv_get_stats(path, &entry_count, &file_size), KV_OK);
+    EXPECT_EQ((int)entry_count, 4);
+    EXPECT_TRUE(file_size >= 3 * KV_PAGE_SIZE);
+
+    EXPECT_EQ(kv_clear(path), KV_OK);
+    EXPECT_FALSE(kv_exists(path, "alpha"));
+    unlink(path);
+}
+
+void test_kv_store_migrate_text() {
+    TEST(KV_StoreMigrateText);
+    const char *path = "/tmp/test_kv_store_legacy.txt";
+    FILE *fp = fopen(path, "w");
+    EXPECT_TRUE(fp != NULL);
+    fprintf(fp, "name=demo\nport=8080\nbroken line\n");
+    fclose(fp);
+
+    char buffer[32];
+    size_t len = 0;
+    EXPECT_EQ(kv_load_ex(path, "port", buffer, sizeof(buffer), &len), KV_OK);
+    EXPECT_TRUE(strcmp(buffer, "8080") == 0);
+    EXPECT_TRUE(kv_pager_is_page_file(path));
+    EXPECT_TRUE(kv_exists(path, "name"));
+
+    size_t entry_count = 0, file_size = 0;
+    kv_get_stats(path, &entry_count, &file_size);
+    EXPECT_EQ((int)entry_count, 2);
+    unlink(path);
+}
+
+void test_kv_store_crash_recovery() {
+    TEST(KV_StoreCrashRecovery);
+    const char *path = "/tmp/test_kv_store_crash.kv";
+    kv_store_t *store = open_fresh(path);
+    EXPECT_TRUE(store != NULL);
+    EXPECT_EQ(kv_store_put(store, "a", "old", 3), KV_OK);
+    EXPECT_EQ(kv_store_put(store, "a", "new", 3), KV_OK);
+    kv_store_close(store);
+
+    // 模拟最后一次提交的元数据页写坏 (事务号位于元数据页偏移 16)
+    FILE *fp = fopen(path, "r+b");
+    EXPECT_TRUE(fp != NULL);
+    unsigned char meta[2][64];
+    fread(meta[0], 1, sizeof(meta[0]), fp);
+    fseek(fp, KV_PAGE_SIZE, SEEK_SET);
+    fread(meta[1], 1, sizeof(meta[1]), fp);
+    uint64_t tx0, tx1;
+    memcpy(&tx0, meta[0] + 16, sizeof(tx0));
+    memcpy(&tx1, meta[1] + 16, sizeof(tx1));
+    fseek(fp, tx0 > tx1 ? 20 : KV_PAGE_SIZE + 20, SEEK_SET);
+    fputc(0xFF, fp);
+    fclose(fp);
+
+    char buffer[8];
+    size_t len = 0;
+    store = kv_store_open(path, NULL, NULL);
+    EXPECT_TRUE(store != NULL);
+    EXPECT_EQ(kv_store_get(store, "a", buffer, sizeof(buffer), &len), KV_OK);
+    EXPECT_TRUE(len == 3 && memcmp(buffer, "old", 3) == 0);
+
+    // 回退后继续写入
+    EXPECT_EQ(kv_store_put(store, "b", "1", 1), KV_OK);
+    kv_store_close(store);
+    EXPECT_TRUE(kv_exists(path, "b"));
+    unlink(path);
+}
+
+static void remove_dir(const char *path) {
+    DIR *dir = opendir(path);
+    if (!dir) return;
+    struct dirent *ent;
+    char file[512];
+    while ((ent = readdir(dir)) != NULL) {
+        if (strcmp(ent->d_name, ".") == 0 || strcmp(ent->d_name, "..") == 0) continue;
+        snprintf(file, sizeof(file), "%s/%s", path, ent->d_name);
+        unlink(file);
+    }
+    closedir(dir);
+    rmdir(path);
+}
+
+static kv_lsm_t* open_lsm_small(const char *path) {
+    kv_lsm_config_t config;
+    kv_lsm_default_config(&config);
+    config.memtable_size = 16 * 1024;
+    config.block_size = 512;
+    config.table_size = 16 * 1024;
+    config.level0_tables = 2;
+    config.level_base_size = 64 * 1024;
+    config.level_ratio = 4;
+    config.sync = false;
+    return kv_lsm_open(path, &config, NULL);
+}
+
+static bool count_entries(const char *key, const char *value, size_t value_len, void *user_data) {
+    (void)key;
+    (void)value;
+    (void)value_len;
+    (*(int *)user_data)++;
+    return true;
+}
+
+void test_kv_lsm_compaction() {
+    TEST(KV_LsmCompaction);
+    const char *path = "/tmp/test_kv_lsm_compact";
+    remove_dir(path);
+    kv_lsm_t *lsm = open_lsm_small(path);
+    EXPECT_TRUE(lsm != NULL);
+
+    char key[32], value[64], buffer[64];
+    bool ok = true;
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < 20000; i++) {
+            int k = (i * 7919) % 20000;
+            snprintf(key, sizeof(key), "key%05d", k);
+            snprintf(value, sizeof(value), "value-%d-%d", k, round);
+            ok = ok && kv_lsm_put(lsm, key, strlen(key), value, strlen(value)) == KV_OK;
+        }
+    }
+    for (int i = 0; i < 20000; i += 3) {
+        snprintf(key, sizeof(key), "key%05d", i);
+        ok = ok && kv_lsm_delete(lsm, key, strlen(key)) == KV_OK;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(kv_lsm_flush(lsm), KV_OK);
+
+    // 压缩后第 0 层低于阈值, 数据下沉到更深的层
+    EXPECT_TRUE(kv_lsm_level_tables(lsm, 0) < 2);
+    size_t deeper = 0;
+    for (int level = 1; level < KV_LSM_MAX_LEVELS; level++) deeper += kv_lsm_level_tables(lsm, level);
+    EXPECT_TRUE(deeper > 1);
+
+    for (int i = 0; i < 20000 && ok; i++) {
+        size_t len = 0;
+        snprintf(key, sizeof(key), "key%05d", i);
+        kv_error_t err = kv_lsm_get(lsm, key, strlen(key), buffer, sizeof(buffer), &len);
+        if (i % 3 == 0) {
+            ok = err == KV_KEY_NOT_FOUND;
+        } else {
+            snprintf(value, sizeof(value), "value-%d-1", i);
+            ok = err == KV_OK && len == strlen(value) && memcmp(buffer, value, len) == 0;
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    int count = 0;
+    char prev[64] = "";
+    EXPECT_EQ(kv_lsm_foreach(lsm, count_entries, &count), KV_OK);
+    EXPECT_EQ(count, 20000 - 6667);
+    EXPECT_EQ(kv_lsm_foreach(lsm, check_order, prev), KV_OK);
+    EXPECT_TRUE(strcmp(prev, "key19999") == 0);
+
+    kv_lsm_close(lsm);
+    remove_dir(path);
+}
+
+void test_kv_lsm_recovery() {
+    TEST(KV_LsmRecovery);
+    const char *path = "/tmp/test_kv_lsm_recover";
+    remove_dir(path);
+    kv_lsm_t *lsm = open_lsm_small(path);
+    EXPECT_TRUE(lsm != NULL);
+
+    char key[32];
+    for (int i = 0; i < 3000; i++) {
+        snprintf(key, sizeof(key), "k%04d", i);
+        kv_lsm_put(lsm, key, strlen(key), "v1", 2);
+    }
+    kv_entry_t entries[] = { { "batch-a", "1" }, { "batch-b", "2" } };
+    EXPECT_EQ(kv_lsm_put_batch(lsm, entries, 2), KV_OK);
+    EXPECT_EQ(kv_lsm_delete(lsm, "k0000", 5), KV_OK);
+    kv_lsm_close(lsm);
+
+    // 模拟崩溃时写了一半的日志尾部
+    DIR *dir = opendir(path);
+    struct dirent *ent;
+    char wal[512] = "";
+    while (dir && (ent = readdir(dir)) != NULL) {
+        if (strstr(ent->d_name, ".wal")) snprintf(wal, sizeof(wal), "%s/%s", path, ent->d_name);
+    }
+    if (dir) closedir(dir);
+    FILE *fp = fopen(wal, "ab");
+    EXPECT_TRUE(fp != NULL);
+    if (fp) {
+        fwrite("\x12\x34\x56\x78\xff\x00", 1, 6, fp);
+        fclose(fp);
+    }
+
+    char buffer[8];
+    size_t len = 0;
+    lsm = open_lsm_small(path);
+    EXPECT_TRUE(lsm != NULL);
+    EXPECT_EQ(kv_lsm_get(lsm, "k2999", 5, buffer, sizeof(buffer), &len), KV_OK);
+    EXPECT_TRUE(len == 2 && memcmp(buffer, "v1", 2) == 0);
+    EXPECT_EQ(kv_lsm_get(lsm, "batch-b", 7, buffer, sizeof(buffer), &len), KV_OK);
+    EXPECT_EQ(kv_lsm_get(lsm, "k0000", 5, buffer, sizeof(buffer), &len), KV_KEY_NOT_FOUND);
+
+    // 截掉坏尾部后继续追加
+    EXPECT_EQ(kv_lsm_put(lsm, "after", 5, "x", 1), KV_OK);
+    kv_lsm_close(lsm);
+    lsm = open_lsm_small(path);
+    EXPECT_EQ(kv_lsm_get(lsm, "after", 5, buffer, sizeof(buffer), &len), KV_OK);
+    int count = 0;
+    kv_lsm_foreach(lsm, count_entries, &count);
+    EXPECT_EQ(count, 3000 - 1 + 2 + 1);
+
+    EXPECT_EQ(kv_lsm_clear(lsm), KV_OK);
+    EXPECT_EQ(kv_lsm_get(lsm, "after", 5, buffer, sizeof(buffer), &len), KV_KEY_NOT_FOUND);
+    kv_lsm_close(lsm);
+    lsm = open_lsm_small(path);
+    count = 0;
+    kv_lsm_foreach(lsm, count_entries, &count);
+    EXPECT_EQ(count, 0);
+    kv_lsm_close(lsm);
+    remove_dir(path);
+}
+
+#define LSM_BATCH_KEYS 8
+#define LSM_BATCH_ROUNDS 3000
+
+typedef struct {
+    kv_lsm_t *lsm;
+    atomic_bool done;
+    atomic_int torn;
+} lsm_batch_ctx_t;
+
+typedef struct {
+    int rounds[LSM_BATCH_KEYS];
+    int count;
+} lsm_batch_view_t;
+
+static bool collect_rounds(const char *key, const char *value, size_t value_len, void *user_data) {
+    (void)value_len;
+    lsm_batch_view_t *view = user_data;
+    if (view->count < LSM_BATCH_KEYS && strncmp(key, "batch", 5) == 0) view->rounds[view->count++] = atoi(value);
+    return true;
+}
+
+static void *lsm_batch_reader(void *arg) {
+    lsm_batch_ctx_t *ctx = arg;
+    char buffer[16];
+    while (!atomic_load(&ctx->done)) {
+        // 遍历快照中同一批次的键必须来自同一轮
+        lsm_batch_view_t view = { {0}, 0 };
+        kv_lsm_foreach(ctx->lsm, collect_rounds, &view);
+        for (int i = 1; i < view.count; i++) {
+            if (view.rounds[i] != view.rounds[0]) atomic_fetch_add(&ctx->torn, 1);
+        }
+        // 批次按键序插入, 先读第一个键再读最后一个键时, 后者的轮次不能更旧
+        size_t len = 0;
+        int first = -1, last = -1;
+        if (kv_lsm_get(ctx->lsm, "batch0", 6, buffer, sizeof(buffer) - 1, &len) == KV_OK) {
+            buffer[len] = '\0';
+            first = atoi(buffer);
+        }
+        if (kv_lsm_get(ctx->lsm, "batch7", 6, buffer, sizeof(buffer) - 1, &len) == KV_OK) {
+            buffer[len] = '\0';
+            last = atoi(buffer);
+        }
+        if (last < first) atomic_fetch_add(&ctx->torn, 1);
+    }
+    return NULL;
+}
+
+void test_kv_lsm_batch_atomic() {
+    TEST(KV_LsmBatchAtomic);
+    const char *path = "/tmp/test_kv_lsm_batch";
+    remove_dir(path);
+    lsm_batch_ctx_t ctx;
+    ctx.lsm = open_lsm_small(path);
+    EXPECT_TRUE(ctx.lsm != NULL);
+    atomic_init(&ctx.done, false);
+    atomic_init(&ctx.torn, 0);
+
+    pthread_t readers[2];
+    for (int i = 0; i < 2; i++) pthread_create(&readers[i], NULL, lsm_batch_reader, &ctx);
+
+    char keys[LSM_BATCH_KEYS][16], value[16];
+    kv_entry_t entries[LSM_BATCH_KEYS];
+    bool ok = true;
+    for (int i = 0; i < LSM_BATCH_KEYS; i++) snprintf(keys[i], sizeof(keys[i]), "batch%d", i);
+    for (int round = 1; round <= LSM_BATCH_ROUNDS && ok; round++) {
+        snprintf(value, sizeof(value), "%d", round);
+        for (int i = 0; i < LSM_BATCH_KEYS; i++) {
+            entries[i].key = keys[i];
+            entries[i].value = value;
+        }
+        ok = kv_lsm_put_batch(ctx.lsm, entries, LSM_BATCH_KEYS) == KV_OK;
+    }
+    atomic_store(&ctx.done, true);
+    for (int i = 0; i < 2; i++) pthread_join(readers[i], NULL);
+    EXPECT_TRUE(ok);
+    EXPECT_EQ(atomic_load(&ctx.torn), 0);
+
+    char buffer[16];
+    size_t len = 0;
+    EXPECT_EQ(kv_lsm_get(ctx.lsm, "batch3", 6, buffer, sizeof(buffer), &len), KV_OK);
+    snprintf(value, sizeof(value), "%d", LSM_BATCH_ROUNDS);
+    EXPECT_TRUE(len == strlen(value) && memcmp(buffer, value, len) == 0);
+    kv_lsm_close(ctx.lsm);
+    remove_dir(path);
+}
+
+void test_kv_store_lsm_engine() {
+    TEST(KV_StoreLsmEngine);
+    const char *path = "/tmp/test_kv_store_lsm";
+    remove_dir(path);
+    kv_config_t config;
+    kv_get_default_config(&config);
+    config.engine = KV_ENGINE_LSM;
+    config.sync_on_commit = false;
+    kv_store_t *store = kv_store_open(path, &config, NULL);
+    EXPECT_TRUE(store != NULL);
+    EXPECT_TRUE(kv_lsm_is_store(path));
+
+    EXPECT_EQ(kv_store_put(store, "a", "1", 1), KV_OK);
+    EXPECT_EQ(kv_store_put(store, "b", "2", 1), KV_OK);
+    EXPECT_EQ(kv_store_delete(store, "a"), KV_OK);
+    EXPECT_EQ(kv_store_delete(store, "a"), KV_KEY_NOT_FOUND);
+    EXPECT_EQ(kv_store_put(store, "", "x", 1), KV_INVALID_INPUT);
+    EXPECT_EQ(kv_store_flush(store), KV_OK);
+    EXPECT_EQ((int)kv_store_count(store), 1);
+    kv_store_close(store);
+
+    // 按文件名操作的接口自动识别 LSM 目录
+    EXPECT_TRUE(kv_save(path, "c", "3"));
+    char *value = kv_load(path, "b");
+    EXPECT_TRUE(value && strcmp(value, "2") == 0);
+    free(value);
+    kv_entry_t *all = NULL;
+    size_t count = kv_get_all(path, &all, NULL);
+    EXPECT_TRUE(count == 2 && strcmp(all[0].key, "b") == 0 && strcmp(all[1].key, "c") == 0);
+    kv_free_entries(all, count);
+
+    size_t entry_count = 0, disk_size = 0;
+    EXPECT_EQ(kv_get_stats(path, &entry_count, &disk_size), KV_OK);
+    EXPECT_EQ((int)entry_count, 2);
+    EXPECT_TRUE(disk_size > 0);
+    EXPECT_EQ(kv_clear(path), KV_OK);
+    EXPECT_FALSE(kv_exists(path, "b"));
+    remove_dir(path);
+}
+
 int main() {
+    UTEST_BEGIN();
     test_kv_types();
     test_kv_error_values();
     test_kv_config_fields();
     test_kv_default_config();
     test_kv_exists();
+    test_kv_store_many_keys();
+    test_kv_store_overwrite_delete();
+    test_kv_store_large_values();
+    test_kv_store_persistence();
+    test_kv_store_migrate_text();
+    test_kv_store_crash_recovery();
+    test_kv_lsm_compaction();
+    test_kv_lsm_recovery();
+    test_kv_lsm_batch_atomic();
+    test_kv_store_lsm_engine();
 
-    return 0;
+    UTEST_END();
 }
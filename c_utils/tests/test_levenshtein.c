@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/levenshtein.h"
 
@@ -42,12 +43,213 @@ void test_levenshtein_get_default_config() {
     EXPECT_TRUE(config.case_sensitive || !config.case_sensitive);
 }
 
+// 参考实现: 完整矩阵动态规划
+static size_t ref_distance(const char *a, size_t n, const char *b, size_t m, bool case_sensitive) {
+    size_t *d = malloc((n + 1) * (m + 1) * sizeof(size_t));
+    for (size_t i = 0; i <= n; i++) d[i * (m + 1)] = i;
+    for (size_t j = 0; j <= m; j++) d[j] = j;
+    for (size_t i = 1; i <= n; i++) {
+        for (size_t j = 1; j <= m; j++) {
+            char x = a[i - 1], y = b[j - 1];
+            if (!case_sensitive) {
+                if (x >= 'A' && x <= 'Z') x += 'a' - 'A';
+                if (y >= 'A' && y <= 'Z') y += 'a' - 'A';
+            }
+            size_t v = d[(i - 1) * (m + 1) + j - 1] + (x != y);
+            if (d[(i - 1) * (m + 1) + j] + 1 < v) v = d[(i - 1) * (m + 1) + j] + 1;
+            if (d[i * (m + 1) + j - 1] + 1 < v) v = d[i * (m + 1) + j - 1] + 1;
+            d[i * (m + 1) + j] = v;
+        }
+    }
+    size_t r = d[n * (m + 1) + m];
+    free(d);
+    return r;
+}
+
+// 小字母表的随机串, 保证距离分布较广
+static void random_string(char *buf, size_t len, const char *alphabet) {
+    size_t k = strlen(alphabet);
+    for (size_t i = 0; i < len; i++) buf[i] = alphabet[rand() % k];
+    buf[len] = '\0';
+}
+
+void test_levenshtein_known_values() {
+    TEST(Levenshtein_KnownValues);
+    EXPECT_EQ(levenshtein_distance("kitten", "sitting"), (size_t)3);
+    EXPECT_EQ(levenshtein_distance("flaw", "lawn"), (size_t)2);
+    EXPECT_EQ(levenshtein_distance("", ""), (size_t)0);
+    EXPECT_EQ(levenshtein_distance("abc", "cba"), (size_t)2);
+}
+
+void test_levenshtein_myers_random() {
+    TEST(Levenshtein_MyersRandom);
+    static char a[300], b[300];
+    bool ok = true;
+    srand(12345);
+    for (int iter = 0; iter < 400 && ok; iter++) {
+        size_t n = (size_t)(rand() % 260), m = (size_t)(rand() % 260);
+        random_string(a, n, iter % 2 ? "acgt" : "abcdefghij");
+        random_string(b, m, iter % 2 ? "acgt" : "abcdefghij");
+        size_t expected = ref_distance(a, n, b, m, true);
+        if (levenshtein_distance(a, b) != expected) ok = false;
+        // 阈值模式: 超过阈值返回 k + 1
+        size_t k = (size_t)(rand() % 80) + 1;
+        size_t bounded = levenshtein_distance_bounded(a, n, b, m, k);
+        if (bounded != (expected > k ? k + 1 : expected)) ok = false;
+    }
+    EXPECT_TRUE(ok);
+}
+
+void test_levenshtein_word_boundaries() {
+    TEST(Levenshtein_WordBoundaries);
+    static char a[200], b[200];
+    bool ok = true;
+    size_t lens[] = { 1, 63, 64, 65, 127, 128, 129, 192 };
+    srand(7);
+    for (size_t i = 0; i < sizeof(lens) / sizeof(lens[0]); i++) {
+        for (size_t j = 0; j < sizeof(lens) / sizeof(lens[0]); j++) {
+            random_string(a, lens[i], "ab");
+            random_string(b, lens[j], "ab");
+            size_t expected = ref_distance(a, lens[i], b, lens[j], true);
+            if (levenshtein_distance(a, b) != expected) ok = false;
+        }
+    }
+    EXPECT_TRUE(ok);
+}
+
+void test_levenshtein_case_insensitive() {
+    TEST(Levenshtein_CaseInsensitive);
+    levenshtein_config_t config;
+    levenshtein_get_default_config(&config);
+    config.case_sensitive = false;
+    size_t dist = 0;
+    EXPECT_EQ(levenshtein_distance_ex("Hello", 5, "hELLO", 5, &dist, &config), LEVENSHTEIN_OK);
+    EXPECT_EQ(dist, (size_t)0);
+
+    static char a[150], b[150];
+    bool ok = true;
+    srand(99);
+    for (int iter = 0; iter < 100; iter++) {
+        size_t n = (size_t)(rand() % 140), m = (size_t)(rand() % 140);
+        random_string(a, n, "aAbBcC");
+        random_string(b, m, "aAbBcC");
+        levenshtein_distance_ex(a, n, b, m, &dist, &config);
+        if (dist != ref_distance(a, n, b, m, false)) ok = false;
+    }
+    EXPECT_TRUE(ok);
+}
+
+void test_levenshtein_max_distance_config() {
+    TEST(Levenshtein_MaxDistanceConfig);
+    levenshtein_config_t config;
+    levenshtein_get_default_config(&config);
+    config.max_distance = 2;
+    size_t dist = 0;
+    levenshtein_distance_ex("kitten", 6, "sitting", 7, &dist, &config);
+    EXPECT_EQ(dist, (size_t)3);
+    levenshtein_distance_ex("kitten", 6, "mitten", 6, &dist, &config);
+    EXPECT_EQ(dist, (size_t)1);
+    // 长度差超过阈值
+    EXPECT_EQ(levenshtein_distance_bounded("a", 1, "abcdef", 6, 3), (size_t)4);
+    // 早期列上较大但最终距离在阈值内
+    EXPECT_EQ(levenshtein_distance_bounded("xabcdefgh", 9, "abcdefghx", 9, 2), (size_t)2);
+}
+
+void test_levenshtein_disabled_operations() {
+    TEST(Levenshtein_DisabledOperations);
+    levenshtein_config_t config;
+    levenshtein_get_default_config(&config);
+    config.include_substitution = false;
+    size_t dist = 0;
+    // 不允许替换时, 一次替换需要删除加插入
+    EXPECT_EQ(levenshtein_distance_ex("kitten", 6, "sitting", 7, &dist, &config), LEVENSHTEIN_OK);
+    EXPECT_EQ(dist, (size_t)5);
+
+    config.max_distance = 3;
+    levenshtein_distance_ex("kitten", 6, "sitting", 7, &dist, &config);
+    EXPECT_EQ(dist, (size_t)4);
+}
+
+void test_levenshtein_matcher() {
+    TEST(Levenshtein_Matcher);
+    static char pattern[200], texts_buf[40][200];
+    const char *texts[41];
+    size_t lens[41], single[41], batch[41], batch_nolen[41];
+    bool ok = true;
+    size_t pattern_lens[] = { 0, 1, 20, 64, 65, 150 };
+    srand(2024);
+    for (size_t p = 0; p < sizeof(pattern_lens) / sizeof(pattern_lens[0]); p++) {
+        size_t m = pattern_lens[p];
+        random_string(pattern, m, "abcd");
+        levenshtein_matcher_t *matcher = levenshtein_matcher_create(pattern, m, true);
+        EXPECT_TRUE(matcher != NULL);
+        for (size_t k = 0; k <= 20; k += 10) {
+            for (size_t i = 0; i < 40; i++) {
+                size_t n = (size_t)(rand() % (m + 20));
+                random_string(texts_buf[i], n, "abcd");
+                texts[i] = texts_buf[i];
+                lens[i] = n;
+            }
+            // 空指针项
+            texts[40] = NULL;
+            lens[40] = 0;
+            size_t done = levenshtein_matcher_batch(matcher, texts, lens, 41, k, batch);
+            levenshtein_matcher_batch(matcher, texts, NULL, 41, k, batch_nolen);
+            if (done != 40 || batch[40] != (size_t)-1) ok = false;
+            for (size_t i = 0; i < 40; i++) {
+                size_t expected = ref_distance(pattern, m, texts[i], lens[i], true);
+                if (k > 0 && expected > k) expected = k + 1;
+                single[i] = levenshtein_matcher_distance(matcher, texts[i], lens[i], k);
+                if (single[i] != expected || batch[i] != expected || batch_nolen[i] != expected) ok = false;
+            }
+        }
+        levenshtein_matcher_free(matcher);
+    }
+    EXPECT_TRUE(ok);
+
+    // 下界恰好等于阈值时不能提前结束: 前 16 列的得分减去剩余列数正好为 16
+    const char *pat = "abcdefghijklmnopqrstuvwxyz012345";
+    const char *tight[] = { "################qrstuvwxyz012345" };
+    size_t tight_dist = 0;
+    size_t tight_expected = ref_distance(pat, 32, tight[0], 32, true);
+    levenshtein_matcher_t *tight_matcher = levenshtein_matcher_create(pat, 32, true);
+    levenshtein_matcher_batch(tight_matcher, tight, NULL, 1, tight_expected, &tight_dist);
+    EXPECT_EQ(tight_dist, tight_expected);
+    levenshtein_matcher_free(tight_matcher);
+
+    levenshtein_matcher_t *matcher = levenshtein_matcher_create("Hello", 5, false);
+    EXPECT_EQ(levenshtein_matcher_distance(matcher, "HELLO!", 6, 0), (size_t)1);
+    levenshtein_matcher_free(matcher);
+}
+
+void test_levenshtein_distance_batch() {
+    TEST(Levenshtein_DistanceBatch);
+    const char *strings[] = { "sitting", "kitten", NULL, "", "kitchen", "smitten" };
+    size_t distances[6];
+    size_t done = levenshtein_distance_batch("kitten", strings, 6, distances);
+    EXPECT_EQ(done, (size_t)5);
+    EXPECT_EQ(distances[0], (size_t)3);
+    EXPECT_EQ(distances[1], (size_t)0);
+    EXPECT_EQ(distances[2], (size_t)-1);
+    EXPECT_EQ(distances[3], (size_t)6);
+    EXPECT_EQ(distances[4], (size_t)2);
+    EXPECT_EQ(distances[5], (size_t)2);
+}
+
 int main() {
     test_levenshtein_distance_same();
     test_levenshtein_distance_different();
     test_levenshtein_distance_empty();
     test_levenshtein_similarity();
     test_levenshtein_get_default_config();
+    test_levenshtein_known_values();
+    test_levenshtein_myers_random();
+    test_levenshtein_word_boundaries();
+    test_levenshtein_case_insensitive();
+    test_levenshtein_max_distance_config();
+    test_levenshtein_disabled_operations();
+    test_levenshtein_matcher();
+    test_levenshtein_distance_batch();
 
     return 0;
 }
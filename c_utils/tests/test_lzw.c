@@ -48,12 +48,126 @@ void test_lzw_encode_single() {
     EXPECT_TRUE(enc_len > 0);
 }
 
+static void lzw_roundtrip(const unsigned char *in, size_t len, const lzw_config_t *config) {
+    size_t cap = len + len / 2 + 100;
+    unsigned char *encoded = malloc(cap);
+    unsigned char *decoded = malloc(len);
+    size_t enc_len = 0;
+    size_t dec_len = 0;
+
+    EXPECT_EQ(lzw_encode_ex(in, len, encoded, cap, &enc_len, config), LZW_OK);
+    EXPECT_EQ(lzw_decode_ex(encoded, enc_len, decoded, len, &dec_len, config), LZW_OK);
+    EXPECT_EQ(dec_len, len);
+    EXPECT_TRUE(memcmp(in, decoded, len) == 0);
+
+    free(encoded);
+    free(decoded);
+}
+
+void test_lzw_roundtrip_content() {
+    TEST(Lzw_RoundtripContent);
+    const char *in = "TOBEORNOTTOBEORTOBEORNOT";
+    unsigned char encoded[256];
+    unsigned char decoded[64];
+    size_t enc_len = lzw_encode((const unsigned char *)in, strlen(in), encoded);
+    size_t dec_len = 0;
+
+    EXPECT_TRUE(enc_len > 0);
+    EXPECT_EQ(lzw_decode(encoded, enc_len, decoded, sizeof(decoded), &dec_len), LZW_OK);
+    EXPECT_EQ(dec_len, strlen(in));
+    EXPECT_TRUE(memcmp(in, decoded, dec_len) == 0);
+}
+
+void test_lzw_roundtrip_kwkwk() {
+    TEST(Lzw_RoundtripKwKwK);
+    unsigned char in[5000];
+    memset(in, 'a', sizeof(in));
+
+    lzw_config_t config;
+    lzw_get_default_config(&config);
+    lzw_roundtrip(in, sizeof(in), &config);
+}
+
+void test_lzw_roundtrip_large() {
+    TEST(Lzw_RoundtripLarge);
+    size_t len = 1 << 20;
+    unsigned char *in = malloc(len);
+    unsigned int seed = 7;
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        in[i] = (i % 3 == 0) ? (unsigned char)('a' + (seed >> 16) % 8) : (unsigned char)(i % 61);
+    }
+
+    lzw_config_t config;
+    lzw_get_default_config(&config);
+    lzw_roundtrip(in, len, &config);
+
+    // 字典写满后不再重置, 码宽固定在最大值
+    config.enable_reset = false;
+    lzw_roundtrip(in, len, &config);
+
+    // 更大的字典 (16 位码宽)
+    lzw_get_default_config(&config);
+    config.max_code_size = 16;
+    config.max_dictionary_size = 65536;
+    lzw_roundtrip(in, len, &config);
+
+    free(in);
+}
+
+void test_lzw_random_bytes() {
+    TEST(Lzw_RandomBytes);
+    size_t len = 200000;
+    unsigned char *in = malloc(len);
+    unsigned int seed = 99;
+    for (size_t i = 0; i < len; i++) {
+        seed = seed * 1103515245 + 12345;
+        in[i] = (unsigned char)(seed >> 16);
+    }
+
+    lzw_config_t config;
+    lzw_get_default_config(&config);
+    lzw_roundtrip(in, len, &config);
+    free(in);
+}
+
+void test_lzw_decode_truncated() {
+    TEST(Lzw_DecodeTruncated);
+    const char *in = "abcabcabcabcabcabcabcabc";
+    unsigned char encoded[256];
+    unsigned char decoded[64];
+    size_t enc_len = lzw_encode((const unsigned char *)in, strlen(in), encoded);
+    size_t dec_len = 0;
+
+    EXPECT_TRUE(enc_len > 2);
+    EXPECT_NE(lzw_decode(encoded, enc_len - 2, decoded, sizeof(decoded), &dec_len), LZW_OK);
+    EXPECT_EQ(lzw_decode(encoded, enc_len, decoded, 4, &dec_len), LZW_BUFFER_TOO_SMALL);
+}
+
+void test_lzw_invalid_config() {
+    TEST(Lzw_InvalidConfig);
+    unsigned char in[] = "abc";
+    unsigned char out[256];
+    size_t out_len = 0;
+    lzw_config_t config;
+    lzw_get_default_config(&config);
+    config.initial_code_size = 8;
+
+    EXPECT_EQ(lzw_encode_ex(in, 3, out, sizeof(out), &out_len, &config), LZW_BIT_WIDTH_ERROR);
+}
+
 int main() {
     test_lzw_encode_decode();
     test_lzw_get_default_config();
     test_lzw_calculate_ratio();
     test_lzw_encode_empty();
     test_lzw_encode_single();
+    test_lzw_roundtrip_content();
+    test_lzw_roundtrip_kwkwk();
+    test_lzw_roundtrip_large();
+    test_lzw_random_bytes();
+    test_lzw_decode_truncated();
+    test_lzw_invalid_config();
 
     return 0;
 }
@@ -287,6 +287,210 @@ void test_matrix_free_null() {
     matrix_free(NULL);
 }
 
+static void fill_random(matrix_t *m, unsigned *seed) {
+    for (size_t i = 0; i < m->rows * m->cols; i++) {
+        *seed = *seed * 1103515245u + 12345u;
+        m->data[i] = (double)((*seed >> 16) % 2001) / 1000.0 - 1.0;
+    }
+}
+
+// 朴素参考实现: C = alpha * op(A) * op(B) + beta * C
+static void naive_gemm(bool ta, bool tb, size_t m, size_t n, size_t k, double alpha,
+                       const double *a, const double *b, double beta, double *c) {
+    for (size_t i = 0; i < m; i++) {
+        for (size_t j = 0; j < n; j++) {
+            double s = 0.0;
+            for (size_t p = 0; p < k; p++) {
+                double av = ta ? a[p * m + i] : a[i * k + p];
+                double bv = tb ? b[j * k + p] : b[p * n + j];
+                s += av * bv;
+            }
+            c[i * n + j] = alpha * s + beta * c[i * n + j];
+        }
+    }
+}
+
+static bool gemm_matches(size_t m, size_t n, size_t k, bool ta, bool tb, threadpool_t *pool) {
+    unsigned seed = (unsigned)(m * 131 + n * 17 + k);
+    matrix_t *a = matrix_create(m, k), *b = matrix_create(k, n);
+    matrix_t *c = matrix_create(m, n), *ref = matrix_create(m, n);
+    fill_random(a, &seed);
+    fill_random(b, &seed);
+    fill_random(c, &seed);
+    memcpy(ref->data, c->data, m * n * sizeof(double));
+    naive_gemm(ta, tb, m, n, k, 1.5, a->data, b->data, -0.5, ref->data);
+    bool ok = matrix_dgemm(ta, tb, m, n, k, 1.5, a->data, ta ? m : k, b->data, tb ? k : n,
+                           -0.5, c->data, n, pool);
+    ok = ok && matrix_equal(c, ref, 1e-9 * (double)(k + 1));
+    matrix_free(a);
+    matrix_free(b);
+    matrix_free(c);
+    matrix_free(ref);
+    return ok;
+}
+
+void test_matrix_gemm() {
+    TEST(Matrix_Gemm);
+    // 覆盖小矩阵路径、MR/NR 边缘块和跨 KC 的分块
+    const size_t sizes[][3] = { { 3, 5, 7 }, { 37, 41, 43 }, { 97, 13, 300 }, { 130, 250, 61 } };
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+        for (int t = 0; t < 4; t++) {
+            EXPECT_TRUE(gemm_matches(sizes[s][0], sizes[s][1], sizes[s][2], t & 1, (t >> 1) & 1, NULL));
+        }
+    }
+
+    // beta = 0 时不读 C 的旧值
+    matrix_t *a = matrix_identity(40), *c = matrix_create(40, 40);
+    matrix_fill(c, NAN);
+    EXPECT_TRUE(matrix_gemm(2.0, a, a, 0.0, c, NULL));
+    EXPECT_EQ(matrix_get(c, 39, 39), 2.0);
+    EXPECT_EQ(matrix_get(c, 0, 39), 0.0);
+    EXPECT_FALSE(matrix_gemm(1.0, a, a, 0.0, a, NULL));
+    matrix_free(a);
+    matrix_free(c);
+}
+
+void test_matrix_gemm_threaded() {
+    TEST(Matrix_GemmThreaded);
+    threadpool_t *pool = threadpool_create(3);
+    EXPECT_TRUE(pool != NULL);
+    EXPECT_TRUE(gemm_matches(200, 150, 270, false, false, pool));
+    EXPECT_TRUE(gemm_matches(61, 300, 90, true, true, pool));
+    threadpool_destroy(pool);
+}
+
+void test_matrix_into() {
+    TEST(Matrix_Into);
+    matrix_t *a = matrix_create(3, 2), *b = matrix_create(2, 3);
+    for (size_t i = 0; i < 6; i++) {
+        a->data[i] = (double)i + 1;
+        b->data[i] = (double)i - 2;
+    }
+    matrix_t *c = matrix_create(3, 3);
+    EXPECT_TRUE(matrix_mul_into(c, a, b));
+    matrix_t *ref = matrix_mul(a, b);
+    EXPECT_TRUE(matrix_equal(c, ref, 1e-12));
+    EXPECT_FALSE(matrix_mul_into(c, a, a));
+
+    // 原地加法
+    EXPECT_TRUE(matrix_add_into(c, c, ref));
+    EXPECT_EQ(matrix_get(c, 2, 2), 2.0 * matrix_get(ref, 2, 2));
+    EXPECT_TRUE(matrix_sub_into(c, c, ref));
+    EXPECT_TRUE(matrix_equal(c, ref, 1e-12));
+    EXPECT_FALSE(matrix_add_into(c, a, a));
+
+    // 跨越多个转置分块
+    matrix_t *big = matrix_create(70, 45), *bt = matrix_create(45, 70);
+    unsigned seed = 7;
+    fill_random(big, &seed);
+    EXPECT_TRUE(matrix_transpose_into(bt, big));
+    EXPECT_EQ(matrix_get(bt, 44, 69), matrix_get(big, 69, 44));
+    EXPECT_EQ(matrix_get(bt, 33, 0), matrix_get(big, 0, 33));
+    EXPECT_FALSE(matrix_transpose_into(big, big));
+
+    matrix_free(a);
+    matrix_free(b);
+    matrix_free(c);
+    matrix_free(ref);
+    matrix_free(big);
+    matrix_free(bt);
+}
+
+void test_matrix_lu_solve() {
+    TEST(Matrix_LUSolve);
+    const size_t n = 150, nrhs = 3;
+    unsigned seed = 11;
+    matrix_t *a = matrix_create(n, n), *b = matrix_create(n, nrhs);
+    fill_random(a, &seed);
+    fill_random(b, &seed);
+    matrix_t *x = matrix_solve(a, b);
+    EXPECT_TRUE(x != NULL);
+    if (x) {
+        matrix_t *ax = matrix_mul(a, x);
+        EXPECT_TRUE(matrix_equal(ax, b, 1e-8));
+        matrix_free(ax);
+        matrix_free(x);
+    }
+
+    // 第一列为零需要换行
+    matrix_t *p = matrix_create(2, 2), *rhs = matrix_create(2, 1);
+    matrix_set(p, 0, 1, 2.0);
+    matrix_set(p, 1, 0, 4.0);
+    matrix_set(rhs, 0, 0, 6.0);
+    matrix_set(rhs, 1, 0, 8.0);
+    x = matrix_solve(p, rhs);
+    EXPECT_TRUE(x != NULL);
+    if (x) {
+        EXPECT_EQ(matrix_get(x, 0, 0), 2.0);
+        EXPECT_EQ(matrix_get(x, 1, 0), 3.0);
+        matrix_free(x);
+    }
+
+    // 奇异矩阵
+    matrix_t *s = matrix_create(3, 3);
+    matrix_fill(s, 1.0);
+    size_t perm[3];
+    EXPECT_FALSE(matrix_lu(s, perm, NULL));
+    EXPECT_TRUE(matrix_solve(s, rhs) == NULL);
+
+    matrix_free(a);
+    matrix_free(b);
+    matrix_free(p);
+    matrix_free(rhs);
+    matrix_free(s);
+}
+
+void test_matrix_cholesky() {
+    TEST(Matrix_Cholesky);
+    const size_t n = 140;
+    unsigned seed = 23;
+    matrix_t *m = matrix_create(n, n), *a = matrix_create(n, n);
+    fill_random(m, &seed);
+    // A = M^T M + n I 对称正定
+    EXPECT_TRUE(matrix_dgemm(true, false, n, n, n, 1.0, m->data, n, m->data, n, 0.0, a->data, n, NULL));
+    for (size_t i = 0; i < n; i++) a->data[i * n + i] += (double)n;
+
+    threadpool_t *pool = threadpool_create(2);
+    matrix_t *l = matrix_copy(a);
+    EXPECT_TRUE(matrix_cholesky(l, pool));
+    EXPECT_EQ(matrix_get(l, 0, n - 1), 0.0);
+    matrix_t *llt = matrix_create(n, n);
+    EXPECT_TRUE(matrix_dgemm(false, true, n, n, n, 1.0, l->data, n, l->data, n, 0.0, llt->data, n, NULL));
+    EXPECT_TRUE(matrix_equal(llt, a, 1e-9));
+
+    matrix_t *b = matrix_create(n, 2);
+    fill_random(b, &seed);
+    matrix_t *x = matrix_copy(b);
+    EXPECT_TRUE(matrix_cholesky_solve(l, x));
+    matrix_t *ax = matrix_mul(a, x);
+    EXPECT_TRUE(matrix_equal(ax, b, 1e-9));
+
+    // 与 LU 的结果一致
+    matrix_t *lu = matrix_copy(a), *y = matrix_copy(b);
+    size_t *perm = malloc(n * sizeof(size_t));
+    EXPECT_TRUE(matrix_lu(lu, perm, pool));
+    EXPECT_TRUE(matrix_lu_solve(lu, perm, y));
+    EXPECT_TRUE(matrix_equal(x, y, 1e-9));
+
+    // 非正定
+    matrix_t *np = matrix_identity(3);
+    matrix_set(np, 2, 2, -1.0);
+    EXPECT_FALSE(matrix_cholesky(np, NULL));
+
+    threadpool_destroy(pool);
+    free(perm);
+    matrix_free(m);
+    matrix_free(a);
+    matrix_free(l);
+    matrix_free(llt);
+    matrix_free(b);
+    matrix_free(x);
+    matrix_free(ax);
+    matrix_free(lu);
+    matrix_free(y);
+    matrix_free(np);
+}
+
 int main() {
     test_matrix_create();
     test_matrix_create_zero_size();
@@ -304,6 +508,11 @@ int main() {
     test_matrix_is_square();
     test_matrix_trace();
     test_matrix_free_null();
+    test_matrix_gemm();
+    test_matrix_gemm_threaded();
+    test_matrix_into();
+    test_matrix_lu_solve();
+    test_matrix_cholesky();
 
     return 0;
 }
@@ -189,6 +189,66 @@ void test_page_alloc_error_string() {
     EXPECT_STREQ(msg, "Unknown error");
 }
 
+void test_page_alloc_huge_pages() {
+    TEST(PageAlloc_HugePages);
+    size_t huge = page_alloc_get_huge_page_size();
+    page_alloc_reset_stats(NULL);
+
+    // 显式大页池为空时退回透明大页, 两种情况都应得到 2MB 对齐、已清零的内存
+    page_huge_mode_t modes[] = { PAGE_HUGE_TRANSPARENT, PAGE_HUGE_EXPLICIT };
+    for (int m = 0; m < 2; m++) {
+        page_alloc_config_t config = page_alloc_default_config();
+        config.huge = modes[m];
+        config.prefault = true;
+        page_alloc_error_t error;
+        char *ptr = page_alloc_ex(huge + 1, &config, &error);
+        EXPECT_TRUE(ptr != NULL);
+        EXPECT_EQ(error, PAGE_ALLOC_OK);
+        EXPECT_TRUE(page_is_aligned(ptr, huge));
+        EXPECT_TRUE(ptr[0] == 0 && ptr[2 * huge - 1] == 0);
+        memset(ptr, 0x5A, 2 * huge);
+
+        page_alloc_stats_t stats;
+        page_alloc_get_stats(&stats, NULL);
+        EXPECT_EQ(stats.mapped_allocated, 2 * huge);
+        EXPECT_EQ(stats.hugetlb_allocated + stats.thp_allocated, 2 * huge);
+        EXPECT_TRUE(stats.huge_backed <= stats.mapped_allocated);
+        page_free(ptr);
+        page_alloc_get_stats(&stats, NULL);
+        EXPECT_EQ(stats.mapped_allocated, (size_t)0);
+    }
+}
+
+void test_page_alloc_prefault_numa() {
+    TEST(PageAlloc_PrefaultNuma);
+    page_numa_policy_t policies[] = { PAGE_NUMA_LOCAL, PAGE_NUMA_BIND, PAGE_NUMA_INTERLEAVE };
+    void *ptrs[3];
+    for (int i = 0; i < 3; i++) {
+        page_alloc_config_t config = page_alloc_default_config();
+        config.prefault = i == 0;
+        config.numa = policies[i];
+        config.numa_node = 0;
+        ptrs[i] = page_alloc_ex(100000, &config, NULL);
+        EXPECT_TRUE(ptrs[i] != NULL && page_is_aligned(ptrs[i], 0));
+        memset(ptrs[i], i, 100000);
+    }
+    // 对齐要求大于页大小时同样满足
+    page_alloc_config_t config = page_alloc_default_config();
+    config.prefault = true;
+    config.alignment = 1 << 20;
+    void *aligned = page_alloc_ex(5000, &config, NULL);
+    EXPECT_TRUE(page_is_aligned(aligned, 1 << 20));
+
+    // mmap 分配与普通分配混合释放
+    void *plain = page_alloc(1024);
+    page_free(aligned);
+    for (int i = 0; i < 3; i++) EXPECT_TRUE(page_free_ex(ptrs[i], NULL));
+    page_free(plain);
+    page_alloc_stats_t stats;
+    page_alloc_get_stats(&stats, NULL);
+    EXPECT_EQ(stats.mapped_allocated, (size_t)0);
+}
+
 int main() {
     test_page_alloc_default_config();
     test_page_alloc_get_page_size();
@@ -210,5 +270,7 @@ int main() {
     test_page_alloc_reset_stats();
     test_page_alloc_error_string();
 
+    test_page_alloc_huge_pages();
+    test_page_alloc_prefault_numa();
     return 0;
 }
@@ -52,12 +52,64 @@ void test_poly1305_ctx_fields() {
     EXPECT_EQ(ctx.buffer_pos, 0);
 }
 
+static const uint8_t rfc_key[32] = {
+    0x85, 0xd6, 0xbe, 0x78, 0x57, 0x55, 0x6d, 0x33, 0x7f, 0x44, 0x52, 0xfe, 0x42, 0xd5, 0x06, 0xa8,
+    0x01, 0x03, 0x80, 0x8a, 0xfb, 0x0d, 0xb2, 0xfd, 0x4a, 0xbf, 0xf6, 0xaf, 0x41, 0x49, 0xf5, 0x1b
+};
+static const uint8_t rfc_tag[16] = {
+    0xa8, 0x06, 0x1d, 0xc1, 0x30, 0x51, 0x36, 0xc6, 0xc2, 0x2b, 0x8b, 0xaf, 0x0c, 0x01, 0x27, 0xa9
+};
+static const char *rfc_msg = "Cryptographic Forum Research Group";
+
+void test_poly1305_rfc8439_vector() {
+    TEST(Poly1305_Rfc8439Vector);
+    uint8_t mac[16];
+    poly1305_tiny(rfc_key, (const uint8_t *)rfc_msg, strlen(rfc_msg), mac);
+    EXPECT_TRUE(memcmp(mac, rfc_tag, sizeof(mac)) == 0);
+
+    poly1305_error_t error;
+    EXPECT_TRUE(poly1305_verify(rfc_key, 32, (const uint8_t *)rfc_msg, strlen(rfc_msg), rfc_tag, 16, &error));
+    EXPECT_FALSE(poly1305_verify(rfc_key, 32, (const uint8_t *)rfc_msg, strlen(rfc_msg) - 1, rfc_tag, 16, &error));
+}
+
+void test_poly1305_streaming() {
+    TEST(Poly1305_Streaming);
+    poly1305_ctx_t ctx;
+    poly1305_error_t error;
+    const uint8_t *msg = (const uint8_t *)rfc_msg;
+    size_t len = strlen(rfc_msg);
+
+    EXPECT_TRUE(poly1305_init(&ctx, rfc_key, sizeof(rfc_key), &error));
+    EXPECT_TRUE(poly1305_update(&ctx, msg, 3, &error));
+    EXPECT_TRUE(poly1305_update(&ctx, msg + 3, 16, &error));
+    EXPECT_TRUE(poly1305_update(&ctx, msg + 19, len - 19, &error));
+    uint8_t mac[16];
+    EXPECT_TRUE(poly1305_final(&ctx, mac, sizeof(mac), &error));
+    EXPECT_TRUE(memcmp(mac, rfc_tag, sizeof(mac)) == 0);
+}
+
+void test_poly1305_invalid_args() {
+    TEST(Poly1305_InvalidArgs);
+    poly1305_ctx_t ctx;
+    poly1305_error_t error;
+    uint8_t mac[16];
+    EXPECT_FALSE(poly1305_init(&ctx, rfc_key, 16, &error));
+    EXPECT_EQ(error, POLY1305_ERROR_INVALID_KEY_SIZE);
+    EXPECT_FALSE(poly1305_tiny_ex(rfc_key, 32, NULL, 4, mac, 16, &error));
+    EXPECT_EQ(error, POLY1305_ERROR_NULL_PTR);
+    EXPECT_FALSE(poly1305_tiny_ex(rfc_key, 32, (const uint8_t *)"", 0, mac, 8, &error));
+    EXPECT_EQ(error, POLY1305_ERROR_INVALID_MAC_SIZE);
+}
+
 int main() {
     test_poly1305_types();
     test_poly1305_error_values();
     test_poly1305_constants();
     test_poly1305_config_fields();
     test_poly1305_ctx_fields();
+    test_poly1305_rfc8439_vector();
+    test_poly1305_streaming();
+    test_poly1305_invalid_args();
 
     return 0;
 }
@@ -66,12 +66,130 @@ void test_prim_result_fields() {
     EXPECT_EQ(result.edge_count, 5);
 }
 
+// 随机无向图 (两个方向), 返回 CSR
+static graph_csr_t* random_undirected(int n, int m, unsigned seed, bool connect) {
+    graph_csr_builder_t *b = graph_csr_builder_create((size_t)n);
+    if (connect) {
+        for (int i = 1; i < n; i++) {
+            seed = seed * 1103515245u + 12345u;
+            int p = (int)((seed >> 8) % (unsigned)i);
+            int w = (int)((seed >> 4) % 50);
+            graph_csr_builder_add_edge(b, i, p, w);
+            graph_csr_builder_add_edge(b, p, i, w);
+        }
+    }
+    for (int i = 0; i < m; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int u = (int)((seed >> 8) % (unsigned)n);
+        seed = seed * 1103515245u + 12345u;
+        int v = (int)((seed >> 8) % (unsigned)n);
+        int w = (int)((seed >> 4) % 50);
+        graph_csr_builder_add_edge(b, u, v, w);
+        graph_csr_builder_add_edge(b, v, u, w);
+    }
+    graph_csr_t *g = graph_csr_builder_build(b);
+    graph_csr_builder_free(b);
+    return g;
+}
+
+void test_prim_csr() {
+    TEST(Prim_Csr);
+    // 与邻接矩阵版本比较 (边权 >= 1, 矩阵中 0 表示无边)
+    enum { N = 90 };
+    prim_error_t error;
+    bool ok = true;
+    for (int trial = 0; trial < 3; trial++) {
+        graph_csr_t *g = random_undirected(N, 300, 5u + (unsigned)trial, true);
+        prim_graph_t *pg = prim_graph_create(N, NULL, &error);
+        for (size_t u = 0; u < g->nodes; u++) {
+            for (size_t i = g->offsets[u]; i < g->offsets[u + 1]; i++) g->weights[i] += 1;
+        }
+        // 重边取最小权重, 和 CSR 版本看到的图一致
+        for (size_t u = 0; u < g->nodes; u++) {
+            for (size_t i = g->offsets[u]; i < g->offsets[u + 1]; i++) {
+                int cur = 0;
+                prim_graph_get_edge(pg, (int)u, g->targets[i], &cur, &error);
+                if (cur == 0 || g->weights[i] < cur) prim_graph_add_edge(pg, (int)u, g->targets[i], g->weights[i], &error);
+            }
+        }
+        prim_result_t result;
+        ok = ok && prim_mst_csr(g, &result, &error) && result.connected && result.edge_count == N - 1;
+        ok = ok && result.total_weight == prim_mst(pg, &error);
+        prim_result_free(&result);
+        prim_graph_destroy(pg);
+        graph_csr_free(g);
+    }
+    EXPECT_TRUE(ok);
+
+    // 两个分量
+    int src[] = { 0, 1, 2, 3 };
+    int dst[] = { 1, 0, 3, 2 };
+    int w[]   = { 3, 3, 4, 4 };
+    graph_csr_t *g = graph_csr_from_edges(4, src, dst, w, 4);
+    prim_result_t result;
+    EXPECT_TRUE(prim_mst_csr(g, &result, &error));
+    EXPECT_TRUE(!result.connected && result.edge_count == 2 && result.total_weight == 7);
+    prim_result_free(&result);
+    graph_csr_free(g);
+}
+
+void test_prim_adjacency_list() {
+    TEST(Prim_AdjacencyList);
+    prim_error_t error;
+    prim_graph_t *pg = prim_graph_create(4, NULL, &error);
+    int w = -1;
+    // 重复添加更新权重, 权重 0 删除边
+    EXPECT_TRUE(prim_graph_add_edge(pg, 0, 1, 5, &error));
+    EXPECT_TRUE(prim_graph_add_edge(pg, 1, 0, 2, &error));
+    EXPECT_TRUE(prim_graph_get_edge(pg, 0, 1, &w, &error) && w == 2);
+    EXPECT_TRUE(prim_graph_add_edge(pg, 1, 2, 3, &error));
+    EXPECT_TRUE(prim_graph_add_edge(pg, 2, 3, 4, &error));
+    EXPECT_TRUE(prim_graph_is_connected(pg, &error));
+    EXPECT_EQ(prim_mst(pg, &error), 9);
+    EXPECT_TRUE(prim_graph_add_edge(pg, 2, 3, 0, &error));
+    EXPECT_TRUE(prim_graph_get_edge(pg, 3, 2, &w, &error) && w == 0);
+    EXPECT_FALSE(prim_graph_is_connected(pg, &error));
+    prim_result_t result;
+    EXPECT_TRUE(prim_mst_ex(pg, &result, &error));
+    EXPECT_TRUE(!result.connected && result.edge_count == 2 && result.total_weight == 5);
+    prim_result_free(&result);
+    prim_graph_destroy(pg);
+
+    // 不再受 100 个节点的邻接矩阵限制, 与 CSR 版本结果一致
+    enum { N = 20000 };
+    graph_csr_t *g = random_undirected(N, 60000, 17u, true);
+    pg = prim_graph_create(N, NULL, &error);
+    EXPECT_TRUE(pg != NULL);
+    bool ok = pg != NULL;
+    for (size_t u = 0; ok && u < g->nodes; u++) {
+        for (size_t i = g->offsets[u]; i < g->offsets[u + 1]; i++) {
+            g->weights[i] += 1;
+            int cur = 0;
+            prim_graph_get_edge(pg, (int)u, g->targets[i], &cur, &error);
+            if (cur == 0 || g->weights[i] < cur) ok = prim_graph_add_edge(pg, (int)u, g->targets[i], g->weights[i], &error);
+        }
+    }
+    prim_result_t csr_result;
+    ok = ok && prim_mst_ex(pg, &result, &error) && prim_mst_csr(g, &csr_result, &error);
+    EXPECT_TRUE(ok);
+    if (ok) {
+        EXPECT_TRUE(result.connected && result.edge_count == N - 1);
+        EXPECT_EQ(result.total_weight, csr_result.total_weight);
+        prim_result_free(&result);
+        prim_result_free(&csr_result);
+    }
+    prim_graph_destroy(pg);
+    graph_csr_free(g);
+}
+
 int main() {
     test_prim_types();
     test_prim_error_values();
     test_prim_config_fields();
     test_prim_edge_fields();
     test_prim_result_fields();
+    test_prim_csr();
+    test_prim_adjacency_list();
 
     return 0;
 }
@@ -0,0 +1,270 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../c_utils/utest.h"
+#include "../c_utils/roaring.h"
+
+// 参照模型: 覆盖 [0, 2^20) 的普通位数组
+#define REF_BITS (1u << 20)
+
+static uint32_t rng_state = 12345;
+
+static uint32_t next_rand(void) {
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+static bool ref_test(const uint8_t *ref, uint32_t v) {
+    return (ref[v >> 3] >> (v & 7)) & 1;
+}
+
+static void ref_set(uint8_t *ref, uint32_t v, bool on) {
+    if (on) ref[v >> 3] |= (uint8_t)(1 << (v & 7));
+    else ref[v >> 3] &= (uint8_t)~(1 << (v & 7));
+}
+
+// 按参照模型生成一个位图: 稀疏点、稠密块与长区间混合, 覆盖三种容器
+static roaring_t* random_bitmap(uint8_t *ref) {
+    roaring_t *r = roaring_create();
+    memset(ref, 0, REF_BITS / 8);
+    for (int i = 0; i < 3000; i++) {
+        uint32_t v = next_rand() % REF_BITS;
+        roaring_add(r, v);
+        ref_set(ref, v, true);
+    }
+    uint32_t dense = (next_rand() % 16) << 16;
+    for (int i = 0; i < 20000; i++) {
+        uint32_t v = dense | (next_rand() & 0xFFFF);
+        roaring_add(r, v);
+        ref_set(ref, v, true);
+    }
+    for (int i = 0; i < 4; i++) {
+        uint32_t start = next_rand() % REF_BITS, len = next_rand() % 100000;
+        if (start + len > REF_BITS) len = REF_BITS - start;
+        roaring_add_range(r, start, (uint64_t)start + len);
+        for (uint32_t v = start; v < start + len; v++) ref_set(ref, v, true);
+    }
+    return r;
+}
+
+static bool matches_ref(const roaring_t *r, const uint8_t *ref) {
+    uint64_t card = 0;
+    for (uint32_t v = 0; v < REF_BITS; v++) {
+        bool in = ref_test(ref, v);
+        card += in;
+        if (roaring_contains(r, v) != in) return false;
+    }
+    return roaring_cardinality(r) == card;
+}
+
+void test_roaring_basic() {
+    TEST(Roaring_Basic);
+    roaring_t *r = roaring_create();
+    EXPECT_TRUE(r != NULL);
+    EXPECT_TRUE(roaring_is_empty(r));
+
+    EXPECT_TRUE(roaring_add(r, 7));
+    EXPECT_FALSE(roaring_add(r, 7));
+    EXPECT_TRUE(roaring_add(r, 0xFFFFFFFFu));
+    EXPECT_TRUE(roaring_add(r, 1u << 20));
+    EXPECT_TRUE(roaring_contains(r, 7));
+    EXPECT_FALSE(roaring_contains(r, 8));
+    EXPECT_EQ((int)roaring_cardinality(r), 3);
+    EXPECT_EQ((int)roaring_container_count(r), 3);
+
+    uint32_t v = 0;
+    EXPECT_TRUE(roaring_minimum(r, &v) && v == 7);
+    EXPECT_TRUE(roaring_maximum(r, &v) && v == 0xFFFFFFFFu);
+
+    EXPECT_TRUE(roaring_remove(r, 7));
+    EXPECT_FALSE(roaring_remove(r, 7));
+    EXPECT_EQ((int)roaring_container_count(r), 2);
+    roaring_clear(r);
+    EXPECT_TRUE(roaring_is_empty(r));
+    roaring_free(r);
+    roaring_free(NULL);
+}
+
+void test_roaring_containers() {
+    TEST(Roaring_Containers);
+    roaring_t *r = roaring_create();
+
+    // 超过 4096 个元素后转为位图, 删回去后转回数组, 内容始终一致
+    for (uint32_t i = 0; i < 10000; i++) roaring_add(r, i * 3);
+    EXPECT_EQ((int)roaring_cardinality(r), 10000);
+    size_t bitmap_bytes = roaring_memory_usage(r);
+    for (uint32_t i = 0; i < 10000; i += 2) roaring_remove(r, i * 3);
+    EXPECT_EQ((int)roaring_cardinality(r), 5000);
+    bool ok = true;
+    for (uint32_t i = 0; i < 10000; i++) ok = ok && roaring_contains(r, i * 3) == (i % 2 == 1);
+    EXPECT_TRUE(ok);
+
+    // 整块区间直接生成行程容器, 占用远小于位图
+    roaring_t *range = roaring_create();
+    EXPECT_TRUE(roaring_add_range(range, 100, 5000000));
+    EXPECT_EQ((int)roaring_cardinality(range), 5000000 - 100);
+    EXPECT_TRUE(roaring_memory_usage(range) < bitmap_bytes);
+    EXPECT_TRUE(roaring_contains(range, 100) && roaring_contains(range, 4999999));
+    EXPECT_FALSE(roaring_contains(range, 99) || roaring_contains(range, 5000000));
+
+    // 在行程中间删除会拆分行程
+    EXPECT_TRUE(roaring_remove(range, 70000));
+    EXPECT_FALSE(roaring_contains(range, 70000));
+    EXPECT_TRUE(roaring_contains(range, 69999) && roaring_contains(range, 70001));
+    EXPECT_TRUE(roaring_add(range, 70000));
+    EXPECT_EQ((int)roaring_cardinality(range), 5000000 - 100);
+
+    // 连续数组经 run_optimize 转为行程
+    roaring_t *seq = roaring_create();
+    for (uint32_t i = 0; i < 3000; i++) roaring_add(seq, 200000 + i);
+    size_t before = roaring_memory_usage(seq);
+    EXPECT_TRUE(roaring_run_optimize(seq));
+    EXPECT_TRUE(roaring_memory_usage(seq) < before);
+    EXPECT_EQ((int)roaring_cardinality(seq), 3000);
+
+    roaring_free(seq);
+    roaring_free(range);
+    roaring_free(r);
+}
+
+void test_roaring_rank_select() {
+    TEST(Roaring_RankSelect);
+    uint8_t *ref = malloc(REF_BITS / 8);
+    roaring_t *r = random_bitmap(ref);
+    uint64_t card = roaring_cardinality(r);
+
+    bool ok = true;
+    uint64_t rank = 0;
+    for (uint32_t v = 0; v < REF_BITS && ok; v++) {
+        if (ref_test(ref, v)) {
+            uint32_t sel = 0;
+            ok = roaring_select(r, rank, &sel) && sel == v;
+            rank++;
+        }
+        if (v % 997 == 0) ok = ok && roaring_rank(r, v) == rank;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(rank == card);
+    EXPECT_FALSE(roaring_select(r, card, NULL));
+
+    uint32_t *values = malloc(card * sizeof(uint32_t));
+    roaring_to_array(r, values);
+    ok = true;
+    for (uint64_t i = 0; i < card; i++) ok = ok && ref_test(ref, values[i]) && (i == 0 || values[i] > values[i - 1]);
+    EXPECT_TRUE(ok);
+
+    free(values);
+    roaring_free(r);
+    free(ref);
+}
+
+void test_roaring_set_ops() {
+    TEST(Roaring_SetOps);
+    uint8_t *ra = malloc(REF_BITS / 8), *rb = malloc(REF_BITS / 8), *rr = malloc(REF_BITS / 8);
+    bool ok = true;
+    for (int round = 0; round < 3; round++) {
+        roaring_t *a = random_bitmap(ra);
+        roaring_t *b = random_bitmap(rb);
+        if (round == 2) roaring_run_optimize(a);
+
+        roaring_t *results[4] = {
+            roaring_and(a, b), roaring_or(a, b), roaring_xor(a, b), roaring_andnot(a, b)
+        };
+        for (int op = 0; op < 4; op++) {
+            for (uint32_t i = 0; i < REF_BITS / 8; i++) {
+                rr[i] = op == 0 ? ra[i] & rb[i] : op == 1 ? ra[i] | rb[i] : op == 2 ? ra[i] ^ rb[i] : ra[i] & ~rb[i];
+            }
+            ok = ok && results[op] && matches_ref(results[op], rr);
+        }
+        ok = ok && roaring_and_cardinality(a, b) == roaring_cardinality(results[0]);
+
+        // 集合恒等式: (a ^ b) | (a & b) == a | b
+        roaring_t *lhs = roaring_or(results[2], results[0]);
+        ok = ok && roaring_equals(lhs, results[1]);
+        roaring_free(lhs);
+
+        for (int op = 0; op < 4; op++) roaring_free(results[op]);
+        roaring_free(a);
+        roaring_free(b);
+    }
+    EXPECT_TRUE(ok);
+    free(ra);
+    free(rb);
+    free(rr);
+}
+
+void test_roaring_serialize() {
+    TEST(Roaring_Serialize);
+    uint8_t *ref = malloc(REF_BITS / 8);
+    roaring_t *r = random_bitmap(ref);
+    roaring_run_optimize(r);
+
+    size_t size = roaring_serialized_size(r);
+    uint8_t *buf = malloc(size);
+    size_t written = 0;
+    EXPECT_TRUE(roaring_serialize(r, buf, size, &written));
+    EXPECT_EQ((int)written, (int)size);
+    EXPECT_FALSE(roaring_serialize(r, buf, size - 1, NULL));
+
+    roaring_t *copy = roaring_deserialize(buf, written);
+    EXPECT_TRUE(copy != NULL);
+    EXPECT_TRUE(roaring_equals(r, copy));
+    EXPECT_TRUE(roaring_deserialize(buf, written - 1) == NULL);
+
+    // 规范中的无行程格式示例: {1, 2, 3, 1000} 位于同一块
+    roaring_t *small = roaring_create();
+    roaring_add(small, 1000);
+    roaring_add(small, 1);
+    roaring_add(small, 2);
+    roaring_add(small, 3);
+    uint8_t expected[] = {
+        0x3A, 0x30, 0, 0, 1, 0, 0, 0,   // cookie 12346, 1 个容器
+        0, 0, 3, 0,                     // 键 0, 基数 - 1 = 3
+        16, 0, 0, 0,                    // 偏移
+        1, 0, 2, 0, 3, 0, 0xE8, 0x03    // 数组容器
+    };
+    uint8_t out[sizeof(expected)];
+    EXPECT_TRUE(roaring_serialize(small, out, sizeof(out), &written));
+    EXPECT_TRUE(written == sizeof(expected) && memcmp(out, expected, sizeof(expected)) == 0);
+
+    roaring_free(small);
+    roaring_free(copy);
+    free(buf);
+    roaring_free(r);
+    free(ref);
+}
+
+static bool count_until(uint32_t value, void *user_data) {
+    (void)value;
+    size_t *left = user_data;
+    return --*left > 0;
+}
+
+void test_roaring_foreach() {
+    TEST(Roaring_Foreach);
+    roaring_t *r = roaring_create();
+    roaring_add_range(r, 10, 20);
+    roaring_add(r, 1u << 30);
+    size_t left = 100;
+    EXPECT_EQ((int)roaring_foreach(r, count_until, &left), 11);
+    left = 5;
+    EXPECT_EQ((int)roaring_foreach(r, count_until, &left), 5);
+
+    uint32_t values[11];
+    roaring_to_array(r, values);
+    EXPECT_TRUE(values[0] == 10 && values[9] == 19 && values[10] == 1u << 30);
+    roaring_free(r);
+}
+
+int main() {
+    UTEST_BEGIN();
+    test_roaring_basic();
+    test_roaring_containers();
+    test_roaring_rank_select();
+    test_roaring_set_ops();
+    test_roaring_serialize();
+    test_roaring_foreach();
+    UTEST_END();
+}
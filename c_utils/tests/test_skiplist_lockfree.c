@@ -0,0 +1,293 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include "../c_utils/utest.h"
+#include "../c_utils/skiplist_lockfree.h"
+
+#define LF_THREADS 8
+#define LF_PER_THREAD 5000
+
+static int u32_compare(const void *a, size_t a_len, const void *b, size_t b_len) {
+    uint32_t x, y;
+    (void)a_len;
+    (void)b_len;
+    memcpy(&x, a, sizeof(x));
+    memcpy(&y, b, sizeof(y));
+    return (x > y) - (x < y);
+}
+
+void test_skiplist_lf_basic() {
+    TEST(SkiplistLF_Basic);
+    skiplist_lf_t *sl = skiplist_lf_create(NULL, 0);
+    EXPECT_TRUE(sl != NULL);
+
+    int a = 1, b = 2, c = 3;
+    void *value = NULL;
+    EXPECT_TRUE(skiplist_lf_put(sl, "beta", 4, &b, &value));
+    EXPECT_TRUE(value == NULL);
+    EXPECT_TRUE(skiplist_lf_put(sl, "alpha", 5, &a, NULL));
+    EXPECT_TRUE(skiplist_lf_insert(sl, "gamma", 5, &c));
+    EXPECT_FALSE(skiplist_lf_insert(sl, "gamma", 5, &a));
+    EXPECT_EQ((int)skiplist_lf_size(sl), 3);
+
+    EXPECT_TRUE(skiplist_lf_get(sl, "beta", 4, &value));
+    EXPECT_TRUE(value == &b);
+    EXPECT_FALSE(skiplist_lf_get(sl, "bet", 3, &value));
+
+    // 替换返回旧值
+    EXPECT_TRUE(skiplist_lf_put(sl, "beta", 4, &c, &value));
+    EXPECT_TRUE(value == &b);
+    EXPECT_EQ((int)skiplist_lf_size(sl), 3);
+
+    EXPECT_TRUE(skiplist_lf_remove(sl, "alpha", 5, &value));
+    EXPECT_TRUE(value == &a);
+    EXPECT_FALSE(skiplist_lf_remove(sl, "alpha", 5, NULL));
+    EXPECT_FALSE(skiplist_lf_get(sl, "alpha", 5, NULL));
+    EXPECT_EQ((int)skiplist_lf_size(sl), 2);
+
+    // 删除后可以重新插入
+    EXPECT_TRUE(skiplist_lf_insert(sl, "alpha", 5, &a));
+    EXPECT_TRUE(skiplist_lf_get(sl, "alpha", 5, &value));
+    EXPECT_TRUE(value == &a);
+    EXPECT_TRUE(skiplist_lf_memory_usage(sl) > 0);
+    skiplist_lf_free(sl, NULL);
+}
+
+static bool collect_range(const void *key, size_t key_len, void *value, void *user_data) {
+    uint32_t k;
+    (void)key_len;
+    (void)value;
+    memcpy(&k, key, sizeof(k));
+    uint32_t *out = user_data;
+    out[out[0] + 1] = k;
+    out[0]++;
+    return out[0] < 5;
+}
+
+void test_skiplist_lf_order_range() {
+    TEST(SkiplistLF_OrderRange);
+    skiplist_lf_t *sl = skiplist_lf_create(u32_compare, 4096);
+    EXPECT_TRUE(sl != NULL);
+
+    bool ok = true;
+    for (uint32_t i = 0; i < 2000; i++) {
+        uint32_t k = (i * 7919u) % 2000u * 2u;  // 0..3998 的偶数
+        ok = ok && skiplist_lf_put(sl, &k, sizeof(k), (void *)(uintptr_t)(k + 1), NULL);
+    }
+    EXPECT_TRUE(ok);
+
+    skiplist_lf_iter_t it;
+    uint32_t expected = 0;
+    for (skiplist_lf_iter_first(&it, sl); skiplist_lf_iter_valid(&it); skiplist_lf_iter_next(&it)) {
+        uint32_t k;
+        size_t len;
+        memcpy(&k, skiplist_lf_iter_key(&it, &len), sizeof(k));
+        ok = ok && len == sizeof(k) && k == expected && (uintptr_t)skiplist_lf_iter_value(&it) == k + 1;
+        expected += 2;
+    }
+    EXPECT_TRUE(ok);
+    EXPECT_EQ((int)expected, 4000);
+
+    // 定位到第一个大于等于 101 的键
+    uint32_t probe = 101;
+    skiplist_lf_iter_seek(&it, sl, &probe, sizeof(probe));
+    EXPECT_TRUE(skiplist_lf_iter_valid(&it));
+    uint32_t k = 0;
+    memcpy(&k, skiplist_lf_iter_key(&it, NULL), sizeof(k));
+    EXPECT_EQ((int)k, 102);
+
+    // [100, 110) 内有 5 个键, 回调在第 5 个后停止
+    uint32_t start = 100, end = 110, out[8] = { 0 };
+    EXPECT_EQ((int)skiplist_lf_range(sl, &start, sizeof(start), &end, sizeof(end), collect_range, out), 5);
+    EXPECT_TRUE(out[0] == 5 && out[1] == 100 && out[5] == 108);
+
+    uint32_t top = 3998;
+    EXPECT_TRUE(skiplist_lf_remove(sl, &top, sizeof(top), NULL));
+    memset(out, 0, sizeof(out));
+    start = 3990;
+    EXPECT_EQ((int)skiplist_lf_range(sl, &start, sizeof(start), NULL, 0, collect_range, out), 4);
+    EXPECT_TRUE(out[4] == 3996);
+    skiplist_lf_free(sl, NULL);
+}
+
+typedef struct {
+    skiplist_lf_t *sl;
+    int id;
+    bool ok;
+} lf_worker_t;
+
+static void* lf_writer(void *arg) {
+    lf_worker_t *w = arg;
+    char key[32];
+    w->ok = true;
+    for (int i = 0; i < LF_PER_THREAD; i++) {
+        snprintf(key, sizeof(key), "t%02d-%06d", w->id, i);
+        w->ok = w->ok && skiplist_lf_insert(w->sl, key, strlen(key), (void *)(intptr_t)(i + 1));
+    }
+    for (int i = 0; i < LF_PER_THREAD; i += 2) {
+        void *value = NULL;
+        snprintf(key, sizeof(key), "t%02d-%06d", w->id, i);
+        w->ok = w->ok && skiplist_lf_remove(w->sl, key, strlen(key), &value) && (intptr_t)value == i + 1;
+    }
+    // 所有线程争用同一组键
+    for (int i = 0; i < LF_PER_THREAD; i++) {
+        snprintf(key, sizeof(key), "shared-%03d", (i * 31 + w->id) % 200);
+        if ((i + w->id) % 3) {
+            skiplist_lf_put(w->sl, key, strlen(key), (void *)(intptr_t)1, NULL);
+        } else {
+            skiplist_lf_remove(w->sl, key, strlen(key), NULL);
+        }
+    }
+    return NULL;
+}
+
+static void* lf_scanner(void *arg) {
+    lf_worker_t *w = arg;
+    w->ok = true;
+    for (int round = 0; round < 20; round++) {
+        skiplist_lf_iter_t it;
+        char prev[32] = "";
+        for (skiplist_lf_iter_first(&it, w->sl); skiplist_lf_iter_valid(&it); skiplist_lf_iter_next(&it)) {
+            size_t len;
+            const char *key = skiplist_lf_iter_key(&it, &len);
+            char cur[32];
+            memcpy(cur, key, len);
+            cur[len] = '\0';
+            if (prev[0] && strcmp(prev, cur) >= 0) w->ok = false;
+            strcpy(prev, cur);
+        }
+    }
+    return NULL;
+}
+
+void test_skiplist_lf_concurrent() {
+    TEST(SkiplistLF_Concurrent);
+    skiplist_lf_t *sl = skiplist_lf_create(NULL, 0);
+    EXPECT_TRUE(sl != NULL);
+
+    pthread_t threads[LF_THREADS + 1];
+    lf_worker_t workers[LF_THREADS + 1];
+    for (int i = 0; i <= LF_THREADS; i++) {
+        workers[i].sl = sl;
+        workers[i].id = i;
+        pthread_create(&threads[i], NULL, i < LF_THREADS ? lf_writer : lf_scanner, &workers[i]);
+    }
+    bool ok = true;
+    for (int i = 0; i <= LF_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        ok = ok && workers[i].ok;
+    }
+    EXPECT_TRUE(ok);
+
+    char key[32];
+    for (int t = 0; t < LF_THREADS && ok; t++) {
+        for (int i = 0; i < LF_PER_THREAD && ok; i++) {
+            void *value = NULL;
+            snprintf(key, sizeof(key), "t%02d-%06d", t, i);
+            bool found = skiplist_lf_get(sl, key, strlen(key), &value);
+            ok = found == (i % 2 == 1) && (!found || (intptr_t)value == i + 1);
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    size_t count = 0;
+    skiplist_lf_iter_t it;
+    for (skiplist_lf_iter_first(&it, sl); skiplist_lf_iter_valid(&it); skiplist_lf_iter_next(&it)) count++;
+    EXPECT_EQ((int)count, (int)skiplist_lf_size(sl));
+    EXPECT_TRUE(count >= LF_THREADS * LF_PER_THREAD / 2);
+    skiplist_lf_free(sl, NULL);
+}
+
+#define LF_SAME_KEY_OPS 20000
+
+typedef struct {
+    skiplist_lf_t *sl;
+    int id;
+    int *owned;    // owned[v]: 值 v 被 put 的 replaced 或 remove 交还的次数
+} lf_same_key_worker_t;
+
+static void* lf_same_key_worker(void *arg) {
+    lf_same_key_worker_t *w = arg;
+    for (int i = 0; i < LF_SAME_KEY_OPS; i++) {
+        void *old = NULL;
+        if (i % 3 == 2) {
+            if (!skiplist_lf_remove(w->sl, "k", 1, &old)) old = NULL;
+        } else {
+            // 每个值只写入一次, 编号从 1 开始
+            intptr_t v = (intptr_t)w->id * LF_SAME_KEY_OPS + i + 1;
+            skiplist_lf_put(w->sl, "k", 1, (void *)v, &old);
+        }
+        if (old) __atomic_fetch_add(&w->owned[(intptr_t)old], 1, __ATOMIC_RELAXED);
+    }
+    return NULL;
+}
+
+void test_skiplist_lf_same_key_put_remove() {
+    TEST(SkiplistLF_SameKeyPutRemove);
+    // 并发 put/remove 同一个键: 每个写入的值最终恰好交还一次 (被替换、被删除或仍在表中),
+    // 既不能丢失, 也不能在仍可见时作为 replaced 交给调用者
+    skiplist_lf_t *sl = skiplist_lf_create(NULL, 0);
+    int *owned = calloc((size_t)LF_THREADS * LF_SAME_KEY_OPS + 1, sizeof(int));
+    pthread_t threads[LF_THREADS];
+    lf_same_key_worker_t workers[LF_THREADS];
+    for (int i = 0; i < LF_THREADS; i++) {
+        workers[i].sl = sl;
+        workers[i].id = i;
+        workers[i].owned = owned;
+        pthread_create(&threads[i], NULL, lf_same_key_worker, &workers[i]);
+    }
+    for (int i = 0; i < LF_THREADS; i++) pthread_join(threads[i], NULL);
+
+    void *last = NULL;
+    if (skiplist_lf_get(sl, "k", 1, &last)) owned[(intptr_t)last]++;
+    EXPECT_TRUE(skiplist_lf_size(sl) <= 1);
+
+    bool ok = owned[0] == 0;
+    for (int t = 0; t < LF_THREADS; t++) {
+        for (int i = 0; i < LF_SAME_KEY_OPS; i++) {
+            if (i % 3 == 2) continue;
+            if (owned[(size_t)t * LF_SAME_KEY_OPS + i + 1] != 1) ok = false;
+        }
+    }
+    EXPECT_TRUE(ok);
+    free(owned);
+    skiplist_lf_free(sl, NULL);
+}
+
+static int freed_values;
+
+static void count_free(void *value) {
+    (void)value;
+    freed_values++;
+}
+
+void test_skiplist_lf_free_values() {
+    TEST(SkiplistLF_FreeValues);
+    skiplist_lf_t *sl = skiplist_lf_create(NULL, 0);
+    int values[4];
+    skiplist_lf_put(sl, "a", 1, &values[0], NULL);
+    skiplist_lf_put(sl, "b", 1, &values[1], NULL);
+    skiplist_lf_put(sl, "c", 1, &values[2], NULL);
+    skiplist_lf_remove(sl, "b", 1, NULL);
+
+    // arena 分配的内存随跳表释放
+    char *scratch = skiplist_lf_alloc(sl, 100000);
+    EXPECT_TRUE(scratch != NULL);
+    memset(scratch, 0, 100000);
+
+    freed_values = 0;
+    skiplist_lf_free(sl, count_free);
+    EXPECT_EQ(freed_values, 2);
+    skiplist_lf_free(NULL, NULL);
+}
+
+int main() {
+    UTEST_BEGIN();
+    test_skiplist_lf_basic();
+    test_skiplist_lf_order_range();
+    test_skiplist_lf_concurrent();
+    test_skiplist_lf_same_key_put_remove();
+    test_skiplist_lf_free_values();
+    UTEST_END();
+}
@@ -0,0 +1,242 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <pthread.h>
+#include "../c_utils/utest.h"
+#include "../c_utils/slab_alloc.h"
+
+void test_slab_size_classes() {
+    TEST(Slab_SizeClasses);
+    bool ok = true;
+    size_t last_usable = 0;
+    for (size_t size = 0; size <= SLAB_MAX_SMALL + 100; size += (size < 300 ? 1 : 37)) {
+        void *p = slab_alloc(size);
+        size_t usable = slab_usable_size(p);
+        ok = ok && p && ((uintptr_t)p & 15) == 0 && usable >= size && usable >= last_usable;
+        // 级别间距不超过 25%, 内部碎片有界
+        if (size > 128) ok = ok && usable <= size + size / 4 + 1;
+        last_usable = usable;
+        memset(p, 0xAB, size);
+        slab_free(p);
+    }
+    EXPECT_TRUE(ok);
+
+    slab_stats_t stats;
+    slab_get_stats(&stats);
+    EXPECT_EQ((int)stats.classes[0].size, 16);
+    EXPECT_EQ((int)stats.classes[SLAB_CLASS_COUNT - 1].size, SLAB_MAX_SMALL);
+    slab_free(NULL);
+}
+
+void test_slab_no_overlap() {
+    TEST(Slab_NoOverlap);
+    enum { N = 20000 };
+    void **ptrs = malloc(N * sizeof(void *));
+    size_t *sizes = malloc(N * sizeof(size_t));
+    uint32_t seed = 12345;
+    for (int i = 0; i < N; i++) {
+        seed = seed * 1103515245u + 12345u;
+        sizes[i] = 1 + (seed >> 8) % 600;
+        ptrs[i] = slab_alloc(sizes[i]);
+        memset(ptrs[i], i & 0xFF, sizes[i]);
+    }
+    // 每个对象的内容都没有被其他对象覆盖
+    bool ok = true;
+    for (int i = 0; i < N && ok; i++) {
+        const uint8_t *b = ptrs[i];
+        for (size_t j = 0; j < sizes[i]; j++) ok = ok && b[j] == (uint8_t)(i & 0xFF);
+    }
+    EXPECT_TRUE(ok);
+    for (int i = 0; i < N; i += 2) slab_free(ptrs[i]);
+    for (int i = 0; i < N; i += 2) {
+        ptrs[i] = slab_alloc(sizes[i]);
+        memset(ptrs[i], 0x5A, sizes[i]);
+    }
+    for (int i = 1; i < N && ok; i += 2) {
+        const uint8_t *b = ptrs[i];
+        for (size_t j = 0; j < sizes[i]; j++) ok = ok && b[j] == (uint8_t)(i & 0xFF);
+    }
+    EXPECT_TRUE(ok);
+    for (int i = 0; i < N; i++) slab_free(ptrs[i]);
+    free(sizes);
+    free(ptrs);
+}
+
+void test_slab_large_and_realloc() {
+    TEST(Slab_LargeAndRealloc);
+    slab_stats_t before, after;
+    slab_get_stats(&before);
+    char *big = slab_alloc(100000);
+    EXPECT_TRUE(big != NULL && ((uintptr_t)big & 15) == 0);
+    EXPECT_EQ((int)slab_usable_size(big), 100000);
+    memset(big, 1, 100000);
+    slab_get_stats(&after);
+    EXPECT_EQ((int)(after.large_allocs - before.large_allocs), 1);
+    slab_free(big);
+    slab_get_stats(&after);
+    EXPECT_EQ((int)after.large_allocs, (int)before.large_allocs);
+
+    // 同一级内原地扩展, 跨级搬移并保留内容
+    char *p = slab_alloc(20);
+    strcpy(p, "hello slab");
+    EXPECT_TRUE(slab_realloc(p, 30) == p);
+    p = slab_realloc(p, 5000);
+    EXPECT_TRUE(p != NULL && strcmp(p, "hello slab") == 0);
+    p = slab_realloc(p, 50000);
+    EXPECT_TRUE(p != NULL && strcmp(p, "hello slab") == 0);
+    p = slab_realloc(p, 16);
+    EXPECT_TRUE(p != NULL && strcmp(p, "hello slab") == 0);
+    EXPECT_TRUE(slab_realloc(p, 0) == NULL);
+
+    int *zeros = slab_calloc(100, sizeof(int));
+    bool ok = zeros != NULL;
+    for (int i = 0; ok && i < 100; i++) ok = zeros[i] == 0;
+    EXPECT_TRUE(ok);
+    slab_free(zeros);
+    EXPECT_TRUE(slab_calloc(SIZE_MAX / 2, 4) == NULL);
+}
+
+// 多线程: 各自分配, 一半对象交给下一个线程释放
+#define CHURN_THREADS 4
+#define CHURN_OPS 200000
+#define CHURN_SLOTS 512
+
+typedef struct {
+    int id;
+    void **handoff;          // 本线程交出去的对象
+    void **incoming;         // 上一个线程交过来的对象
+    pthread_barrier_t *barrier;
+    bool ok;
+} churn_arg_t;
+
+static void* churn_worker(void *arg) {
+    churn_arg_t *a = arg;
+    void *slots[CHURN_SLOTS] = {0};
+    uint32_t seed = (uint32_t)a->id * 2654435761u + 1;
+    a->ok = true;
+    for (int i = 0; i < CHURN_OPS; i++) {
+        seed ^= seed << 13;
+        seed ^= seed >> 17;
+        seed ^= seed << 5;
+        int s = (int)(seed % CHURN_SLOTS);
+        if (slots[s]) {
+            uint8_t *b = slots[s];
+            size_t n = slab_usable_size(b);
+            if (b[0] != (uint8_t)a->id || b[n - 1] != (uint8_t)a->id) a->ok = false;
+            slab_free(b);
+            slots[s] = NULL;
+        } else {
+            size_t n = 8 + (seed >> 20) % 1024;
+            uint8_t *b = slab_alloc(n);
+            if (!b) {
+                a->ok = false;
+                continue;
+            }
+            memset(b, a->id, slab_usable_size(b));
+            slots[s] = b;
+        }
+    }
+    for (int s = 0; s < CHURN_SLOTS; s++) a->handoff[s] = slots[s];
+    pthread_barrier_wait(a->barrier);
+    for (int s = 0; s < CHURN_SLOTS; s++) slab_free(a->incoming[s]);
+    return NULL;
+}
+
+static size_t g_refills;
+static size_t g_flushes;
+
+static void count_events(slab_event_t event, size_t size, void *user_data) {
+    (void)size;
+    (void)user_data;
+    if (event == SLAB_EVENT_REFILL) __atomic_fetch_add(&g_refills, 1, __ATOMIC_RELAXED);
+    if (event == SLAB_EVENT_FLUSH) __atomic_fetch_add(&g_flushes, 1, __ATOMIC_RELAXED);
+}
+
+void test_slab_threads() {
+    TEST(Slab_Threads);
+    slab_set_hook(count_events, NULL);
+    pthread_t threads[CHURN_THREADS];
+    churn_arg_t args[CHURN_THREADS];
+    void *handoff[CHURN_THREADS][CHURN_SLOTS];
+    pthread_barrier_t barrier;
+    pthread_barrier_init(&barrier, NULL, CHURN_THREADS);
+    for (int i = 0; i < CHURN_THREADS; i++) {
+        args[i] = (churn_arg_t){ .id = i + 1, .handoff = handoff[i],
+                                 .incoming = handoff[(i + CHURN_THREADS - 1) % CHURN_THREADS], .barrier = &barrier };
+        pthread_create(&threads[i], NULL, churn_worker, &args[i]);
+    }
+    bool ok = true;
+    for (int i = 0; i < CHURN_THREADS; i++) {
+        pthread_join(threads[i], NULL);
+        ok = ok && args[i].ok;
+    }
+    pthread_barrier_destroy(&barrier);
+    slab_set_hook(NULL, NULL);
+    EXPECT_TRUE(ok);
+    EXPECT_TRUE(g_refills > 0 && g_flushes > 0);
+
+    // 线程退出时缓存已归还, 再分配不需要新的 span
+    slab_stats_t before, after;
+    slab_get_stats(&before);
+    void *again[CHURN_SLOTS];
+    for (int i = 0; i < CHURN_SLOTS; i++) again[i] = slab_alloc(64);
+    slab_get_stats(&after);
+    EXPECT_EQ((int)after.span_bytes, (int)before.span_bytes);
+    for (int i = 0; i < CHURN_SLOTS; i++) slab_free(again[i]);
+    slab_thread_flush();
+}
+
+// 线程退出时, 在本模块之后运行的 TLS 析构函数中释放的对象也要回到仓库
+#define LATE_FREE_COUNT 100
+#define LATE_FREE_SIZE 4000
+
+static pthread_key_t g_late_key;
+static void *g_late_objs[LATE_FREE_COUNT];
+
+static void late_free(void *arg) {
+    void **objs = arg;
+    for (int i = 0; i < LATE_FREE_COUNT; i++) slab_free(objs[i]);
+}
+
+static void* late_free_worker(void *arg) {
+    (void)arg;
+    for (int i = 0; i < LATE_FREE_COUNT; i++) g_late_objs[i] = slab_alloc(LATE_FREE_SIZE);
+    pthread_setspecific(g_late_key, g_late_objs);
+    return NULL;
+}
+
+void test_slab_free_in_tls_destructor() {
+    TEST(Slab_FreeInTlsDestructor);
+    // 本模块的键已在前面的用例中创建, 这里的键排在其后析构
+    pthread_key_create(&g_late_key, late_free);
+    slab_thread_flush();
+    pthread_t thread;
+    pthread_create(&thread, NULL, late_free_worker, NULL);
+    pthread_join(thread, NULL);
+
+    // 主线程缓存为空, 先取尽仓库中的对象再切新 span, 退出线程释放的对象应全部重新分配出来
+    enum { EXTRA = 256 };
+    void *again[LATE_FREE_COUNT + EXTRA];
+    int found = 0;
+    for (int i = 0; i < LATE_FREE_COUNT + EXTRA; i++) {
+        again[i] = slab_alloc(LATE_FREE_SIZE);
+        for (int j = 0; j < LATE_FREE_COUNT; j++) {
+            if (again[i] == g_late_objs[j]) found++;
+        }
+    }
+    EXPECT_EQ(found, LATE_FREE_COUNT);
+    for (int i = 0; i < LATE_FREE_COUNT + EXTRA; i++) slab_free(again[i]);
+    slab_thread_flush();
+    pthread_key_delete(g_late_key);
+}
+
+int main() {
+    UTEST_BEGIN();
+    test_slab_size_classes();
+    test_slab_no_overlap();
+    test_slab_large_and_realloc();
+    test_slab_threads();
+    test_slab_free_in_tls_destructor();
+    UTEST_END();
+}
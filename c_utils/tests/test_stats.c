@@ -56,12 +56,166 @@ void test_stats_compute_empty() {
     EXPECT_TRUE(isnan(result.min) || result.min == 0);
 }
 
+void test_stats_accum_stability() {
+    TEST(Stats_AccumStability);
+    // 大偏移下的小方差: 朴素的 E[x^2] - E[x]^2 会完全丢失精度
+    const double base = 1e9;
+    const double offsets[] = {4.0, 7.0, 13.0, 16.0};
+    double data[4000];
+    stats_accum_t acc;
+    stats_accum_init(&acc);
+    for (size_t i = 0; i < 4000; i++) {
+        data[i] = base + offsets[i % 4];
+        stats_accum_add(&acc, data[i]);
+    }
+    stats_t s = stats_accum_result(&acc);
+    EXPECT_TRUE(fabs(s.mean - (base + 10.0)) < 1e-6);
+    EXPECT_TRUE(fabs(s.variance - 22.5) < 1e-6);
+    EXPECT_EQ(acc.count, (uint64_t)4000);
+
+    stats_t batch = stats_compute(data, 4000);
+    EXPECT_TRUE(fabs(batch.variance - 22.5) < 1e-6);
+    EXPECT_TRUE(fabs(batch.mean - s.mean) < 1e-6);
+    EXPECT_EQ(batch.min, base + 4.0);
+    EXPECT_EQ(batch.max, base + 16.0);
+}
+
+void test_stats_accum_kahan() {
+    TEST(Stats_AccumKahan);
+    stats_accum_t acc;
+    stats_accum_init(&acc);
+    stats_accum_add(&acc, 1e16);
+    for (int i = 0; i < 1000; i++) stats_accum_add(&acc, 1.0);
+    stats_accum_add(&acc, -1e16);
+    // 逐个相加时每个 1.0 都会被 1e16 吞掉
+    EXPECT_EQ(stats_accum_sum(&acc), 1000.0);
+}
+
+void test_stats_accum_merge() {
+    TEST(Stats_AccumMerge);
+    double data[1000];
+    unsigned seed = 42;
+    for (size_t i = 0; i < 1000; i++) {
+        seed = seed * 1103515245u + 12345u;
+        data[i] = (double)((seed >> 16) % 10000) / 100.0 - 30.0;
+    }
+    stats_accum_t whole, parts[3], merged;
+    stats_accum_init(&whole);
+    stats_accum_add_array(&whole, data, 1000);
+    // 三段分别累加 (模拟三个线程), 再合并
+    const size_t cuts[] = {0, 137, 700, 1000};
+    stats_accum_init(&merged);
+    for (int p = 0; p < 3; p++) {
+        stats_accum_init(&parts[p]);
+        for (size_t i = cuts[p]; i < cuts[p + 1]; i++) stats_accum_add(&parts[p], data[i]);
+        stats_accum_merge(&merged, &parts[p]);
+    }
+    stats_t a = stats_accum_result(&whole), b = stats_accum_result(&merged);
+    EXPECT_EQ(merged.count, (uint64_t)1000);
+    EXPECT_TRUE(fabs(a.mean - b.mean) < 1e-9);
+    EXPECT_TRUE(fabs(a.variance - b.variance) < 1e-9);
+    EXPECT_EQ(a.min, b.min);
+    EXPECT_EQ(a.max, b.max);
+    EXPECT_TRUE(fabs(stats_accum_sum(&whole) - stats_accum_sum(&merged)) < 1e-9);
+
+    // 合并空累加器不改变结果
+    stats_accum_t empty;
+    stats_accum_init(&empty);
+    stats_accum_merge(&merged, &empty);
+    EXPECT_EQ(merged.count, (uint64_t)1000);
+    stats_t e = stats_accum_result(&empty);
+    EXPECT_EQ(e.min, 0.0);
+}
+
+void test_stats_histogram_small() {
+    TEST(Stats_HistogramSmall);
+    stats_histogram_t *h = stats_histogram_create(1000000, 3);
+    EXPECT_TRUE(h != NULL);
+    EXPECT_EQ(stats_histogram_percentile(h, 50.0), (uint64_t)0);
+    // 小于 2048 的值在 3 位精度下精确记录
+    for (uint64_t v = 1; v <= 100; v++) EXPECT_TRUE(stats_histogram_record(h, v));
+    EXPECT_EQ(stats_histogram_count(h), (uint64_t)100);
+    EXPECT_EQ(stats_histogram_percentile(h, 50.0), (uint64_t)50);
+    EXPECT_EQ(stats_histogram_percentile(h, 99.0), (uint64_t)99);
+    EXPECT_EQ(stats_histogram_percentile(h, 100.0), (uint64_t)100);
+    EXPECT_EQ(stats_histogram_percentile(h, 0.0), (uint64_t)1);
+    EXPECT_EQ(stats_histogram_min(h), (uint64_t)1);
+    EXPECT_EQ(stats_histogram_max(h), (uint64_t)100);
+    EXPECT_TRUE(fabs(stats_histogram_mean(h) - 50.5) < 1e-9);
+    EXPECT_FALSE(stats_histogram_record(h, 1000001));
+    EXPECT_TRUE(stats_histogram_record(h, 0));
+    EXPECT_EQ(stats_histogram_min(h), (uint64_t)0);
+
+    stats_histogram_reset(h);
+    EXPECT_EQ(stats_histogram_count(h), (uint64_t)0);
+    EXPECT_TRUE(stats_histogram_create(10, 0) == NULL);
+    EXPECT_TRUE(stats_histogram_create(1, 3) == NULL);
+    stats_histogram_free(h);
+}
+
+static bool within_relative(uint64_t got, double want, double rel) {
+    return fabs((double)got - want) <= want * rel;
+}
+
+void test_stats_histogram_tail() {
+    TEST(Stats_HistogramTail);
+    const uint64_t highest = 3600ULL * 1000000000ULL;
+    stats_histogram_t *h = stats_histogram_create(highest, 3);
+    stats_histogram_t *lo = stats_histogram_create(highest, 3);
+    stats_histogram_t *hi = stats_histogram_create(highest, 3);
+    stats_histogram_t *coarse = stats_histogram_create(highest, 2);
+    size_t mem = stats_histogram_memory(h);
+    // 1..1000000 各一次, 值乘以 1000 模拟纳秒延迟
+    for (uint64_t v = 1; v <= 1000000; v++) {
+        EXPECT_TRUE(stats_histogram_record(h, v * 1000));
+        stats_histogram_record(v <= 500000 ? lo : hi, v * 1000);
+    }
+    EXPECT_EQ(stats_histogram_memory(h), mem);
+    EXPECT_EQ(stats_histogram_count(h), (uint64_t)1000000);
+    EXPECT_TRUE(within_relative(stats_histogram_percentile(h, 50.0), 500000000.0, 1e-3));
+    EXPECT_TRUE(within_relative(stats_histogram_percentile(h, 99.0), 990000000.0, 1e-3));
+    EXPECT_TRUE(within_relative(stats_histogram_percentile(h, 99.99), 999900000.0, 1e-3));
+    EXPECT_EQ(stats_histogram_percentile(h, 100.0), (uint64_t)1000000000);
+    EXPECT_TRUE(within_relative((uint64_t)stats_histogram_mean(h), 500000500.0, 1e-3));
+
+    // 同精度合并与整体记录完全一致
+    EXPECT_TRUE(stats_histogram_merge(lo, hi));
+    EXPECT_EQ(stats_histogram_count(lo), (uint64_t)1000000);
+    const double ps[] = {0.0, 25.0, 50.0, 90.0, 99.0, 99.9, 100.0};
+    for (size_t i = 0; i < sizeof(ps) / sizeof(ps[0]); i++) {
+        EXPECT_EQ(stats_histogram_percentile(lo, ps[i]), stats_histogram_percentile(h, ps[i]));
+    }
+
+    // 不同精度合并: 结果落在较低精度的误差内
+    EXPECT_TRUE(stats_histogram_merge(coarse, h));
+    EXPECT_EQ(stats_histogram_count(coarse), (uint64_t)1000000);
+    EXPECT_TRUE(within_relative(stats_histogram_percentile(coarse, 99.0), 990000000.0, 1e-2));
+    EXPECT_EQ(stats_histogram_max(coarse), (uint64_t)1000000000);
+
+    // 超出目标范围的合并被拒绝且不修改目标
+    stats_histogram_t *tiny = stats_histogram_create(1000, 3);
+    EXPECT_TRUE(stats_histogram_record(tiny, 10));
+    EXPECT_FALSE(stats_histogram_merge(tiny, h));
+    EXPECT_EQ(stats_histogram_count(tiny), (uint64_t)1);
+
+    stats_histogram_free(h);
+    stats_histogram_free(lo);
+    stats_histogram_free(hi);
+    stats_histogram_free(coarse);
+    stats_histogram_free(tiny);
+}
+
 int main() {
     test_stats_compute();
     test_stats_compute_single();
     test_stats_compute_negative();
     test_stats_compute_variance();
     test_stats_compute_empty();
+    test_stats_accum_stability();
+    test_stats_accum_kahan();
+    test_stats_accum_merge();
+    test_stats_histogram_small();
+    test_stats_histogram_tail();
 
     return 0;
 }
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include "../c_utils/utest.h"
 #include "../c_utils/suffix_array.h"
 
@@ -54,12 +55,190 @@ void test_suffix_array_repeated() {
     EXPECT_TRUE(sa[0] >= 0 && sa[0] < 4);
 }
 
+// 相邻后缀严格递增且 sa 是一个排列
+static bool sa_is_valid(const uint8_t *s, size_t n, const int *sa) {
+    char *seen = calloc(n + 1, 1);
+    bool ok = seen != NULL;
+    for (size_t i = 0; ok && i < n; i++) {
+        if (sa[i] < 0 || (size_t)sa[i] >= n || seen[sa[i]]) ok = false;
+        else seen[sa[i]] = 1;
+    }
+    for (size_t i = 1; ok && i < n; i++) {
+        size_t a = (size_t)sa[i - 1], b = (size_t)sa[i];
+        size_t la = n - a, lb = n - b, l = la < lb ? la : lb;
+        int c = memcmp(s + a, s + b, l);
+        if (c > 0 || (c == 0 && la > lb)) ok = false;
+    }
+    free(seen);
+    return ok;
+}
+
+static void random_bytes(uint8_t *buf, size_t n, int alphabet, unsigned *seed) {
+    for (size_t i = 0; i < n; i++) {
+        *seed = *seed * 1103515245u + 12345u;
+        buf[i] = (uint8_t)((*seed >> 16) % (unsigned)alphabet);
+    }
+}
+
+void test_suffix_array_banana() {
+    TEST(SuffixArray_Banana);
+    int sa[6];
+    suffix_array_build("banana", sa);
+    const int expected[] = {5, 3, 1, 0, 4, 2};
+    for (int i = 0; i < 6; i++) EXPECT_EQ(sa[i], expected[i]);
+
+    int lcp[6];
+    EXPECT_EQ(suffix_array_build_lcp("banana", sa, NULL, lcp, 6, NULL), SUFFIX_ARRAY_OK);
+    const int expected_lcp[] = {0, 1, 3, 0, 0, 2};
+    for (int i = 0; i < 6; i++) EXPECT_EQ(lcp[i], expected_lcp[i]);
+}
+
+void test_suffix_array_sais_random() {
+    TEST(SuffixArray_SAISRandom);
+    unsigned seed = 1;
+    uint8_t buf[3000];
+    int sa[3000];
+    // 小字母表产生大量重复, 覆盖多层递归; 256 覆盖 '\0' 和高位字节
+    const int alphabets[] = {1, 2, 3, 4, 26, 256};
+    const size_t lens[] = {1, 2, 3, 7, 64, 1000, 3000};
+    for (size_t a = 0; a < sizeof(alphabets) / sizeof(alphabets[0]); a++) {
+        for (size_t l = 0; l < sizeof(lens) / sizeof(lens[0]); l++) {
+            random_bytes(buf, lens[l], alphabets[a], &seed);
+            EXPECT_EQ(suffix_array_sais(buf, lens[l], sa), SUFFIX_ARRAY_OK);
+            EXPECT_TRUE(sa_is_valid(buf, lens[l], sa));
+        }
+    }
+
+    // 周期串和 Fibonacci 串是 SA-IS 递归最深的情形
+    for (size_t i = 0; i < 3000; i++) buf[i] = (uint8_t)("abcab"[i % 5]);
+    EXPECT_EQ(suffix_array_sais(buf, 3000, sa), SUFFIX_ARRAY_OK);
+    EXPECT_TRUE(sa_is_valid(buf, 3000, sa));
+    size_t fa = 1, fb = 1;
+    buf[0] = 'b';
+    buf[1] = 'a';
+    while (fa + fb <= 3000) {
+        memcpy(buf + fb, buf, fa);
+        size_t t = fa + fb;
+        fa = fb;
+        fb = t;
+    }
+    EXPECT_EQ(suffix_array_sais(buf, fb, sa), SUFFIX_ARRAY_OK);
+    EXPECT_TRUE(sa_is_valid(buf, fb, sa));
+
+    EXPECT_EQ(suffix_array_sais(NULL, 0, NULL), SUFFIX_ARRAY_OK);
+    EXPECT_EQ(suffix_array_sais(NULL, 5, sa), SUFFIX_ARRAY_ERROR_INVALID_PARAMS);
+}
+
+void test_suffix_array_sais_int() {
+    TEST(SuffixArray_SAISInt);
+    int s[500], sa[500];
+    uint8_t bytes[500];
+    unsigned seed = 5;
+    // 字母表小于 256 时与按字节构建的结果相同
+    random_bytes(bytes, 500, 7, &seed);
+    for (int i = 0; i < 500; i++) s[i] = bytes[i];
+    EXPECT_EQ(suffix_array_sais_int(s, 500, 7, sa), SUFFIX_ARRAY_OK);
+    EXPECT_TRUE(sa_is_valid(bytes, 500, sa));
+
+    // 大字母表
+    for (int i = 0; i < 500; i++) {
+        seed = seed * 1103515245u + 12345u;
+        s[i] = (int)((seed >> 8) % 100000);
+    }
+    EXPECT_EQ(suffix_array_sais_int(s, 500, 100000, sa), SUFFIX_ARRAY_OK);
+    bool sorted = true;
+    for (int i = 1; i < 500; i++) {
+        int a = sa[i - 1], b = sa[i];
+        while (a < 500 && b < 500 && s[a] == s[b]) {
+            a++;
+            b++;
+        }
+        if (b == 500 || (a < 500 && s[a] > s[b])) sorted = false;
+    }
+    EXPECT_TRUE(sorted);
+    s[3] = 100000;
+    EXPECT_EQ(suffix_array_sais_int(s, 500, 100000, sa), SUFFIX_ARRAY_ERROR_INVALID_PARAMS);
+}
+
+void test_suffix_array_lcp() {
+    TEST(SuffixArray_LCP);
+    uint8_t buf[2000];
+    int sa[2000], rank[2000], lcp[2000];
+    unsigned seed = 9;
+    random_bytes(buf, 2000, 3, &seed);
+    buf[100] = 0;
+    EXPECT_EQ(suffix_array_sais(buf, 2000, sa), SUFFIX_ARRAY_OK);
+    EXPECT_EQ(suffix_array_build_rank(sa, rank, 2000, NULL), SUFFIX_ARRAY_OK);
+    EXPECT_EQ(suffix_array_build_lcp((const char *)buf, sa, rank, lcp, 2000, NULL), SUFFIX_ARRAY_OK);
+    bool ok = lcp[0] == 0;
+    for (int i = 1; i < 2000; i++) {
+        int a = sa[i - 1], b = sa[i], h = 0;
+        while (a + h < 2000 && b + h < 2000 && buf[a + h] == buf[b + h]) h++;
+        if (lcp[i] != h) ok = false;
+        if (rank[sa[i]] != i) ok = false;
+    }
+    EXPECT_TRUE(ok);
+}
+
+void test_suffix_array_search() {
+    TEST(SuffixArray_Search);
+    uint8_t buf[4000];
+    int sa[4000];
+    unsigned seed = 77;
+    random_bytes(buf, 4000, 4, &seed);
+    EXPECT_EQ(suffix_array_sais(buf, 4000, sa), SUFFIX_ARRAY_OK);
+    const char *text = (const char *)buf;
+
+    // 与逐位置比较的结果一致, 模式取文本中的子串和随机串
+    bool ok = true;
+    for (int q = 0; q < 200; q++) {
+        uint8_t pat[12];
+        seed = seed * 1103515245u + 12345u;
+        size_t m = 1 + (seed >> 16) % 10;
+        if (q % 2 == 0) {
+            memcpy(pat, buf + (seed >> 4) % (4000 - m), m);
+        } else {
+            random_bytes(pat, m, 4, &seed);
+        }
+        size_t naive = 0;
+        for (size_t i = 0; i + m <= 4000; i++) naive += memcmp(buf + i, pat, m) == 0;
+        size_t start, end;
+        if (suffix_array_search_n(text, sa, 4000, (const char *)pat, m, &start, &end, NULL) != SUFFIX_ARRAY_OK) ok = false;
+        if (end - start != naive || suffix_array_count(text, sa, 4000, (const char *)pat, m) != naive) ok = false;
+        for (size_t i = start; i < end; i++) {
+            if ((size_t)sa[i] + m > 4000 || memcmp(buf + sa[i], pat, m) != 0) ok = false;
+        }
+    }
+    EXPECT_TRUE(ok);
+
+    int sb[11];
+    const char *s = "mississippi";
+    suffix_array_build(s, sb);
+    size_t start, end;
+    suffix_array_state_t state = {0};
+    EXPECT_EQ(suffix_array_search(s, sb, 11, "ssi", &start, &end, &state), SUFFIX_ARRAY_OK);
+    EXPECT_EQ(end - start, (size_t)2);
+    EXPECT_EQ(state.queries, (size_t)1);
+    EXPECT_EQ(suffix_array_search(s, sb, 11, "ssp", &start, &end, NULL), SUFFIX_ARRAY_OK);
+    EXPECT_EQ(end - start, (size_t)0);
+    // 模式比文本末尾的后缀长
+    EXPECT_EQ(suffix_array_count(s, sb, 11, "ippix", 5), (size_t)0);
+    EXPECT_EQ(suffix_array_count(s, sb, 11, "i", 1), (size_t)4);
+    EXPECT_EQ(suffix_array_search(s, sb, 11, "", &start, &end, &state), SUFFIX_ARRAY_ERROR_PATTERN_EMPTY);
+    EXPECT_EQ(state.last_error, SUFFIX_ARRAY_ERROR_PATTERN_EMPTY);
+}
+
 int main() {
     test_suffix_array_build();
     test_suffix_array_build_sorted();
     test_suffix_array_single_char();
     test_suffix_array_empty();
     test_suffix_array_repeated();
+    test_suffix_array_banana();
+    test_suffix_array_sais_random();
+    test_suffix_array_sais_int();
+    test_suffix_array_lcp();
+    test_suffix_array_search();
 
     return 0;
 }
@@ -56,12 +56,58 @@ void test_tarjan_state_fields() {
     EXPECT_TRUE(state.is_initialized);
 }
 
+void test_tarjan_scc_csr() {
+    TEST(Tarjan_SccCsr);
+    // 与递归版本比较分量划分
+    enum { N = 90, M = 150 };
+    static tarjan_graph_t tg;
+    int src[M], dst[M];
+    unsigned seed = 77;
+    memset(&tg, 0, sizeof(tg));
+    tg.n = N;
+    for (int i = 0; i < M; i++) {
+        seed = seed * 1103515245u + 12345u;
+        src[i] = (int)((seed >> 8) % N);
+        seed = seed * 1103515245u + 12345u;
+        dst[i] = (int)((seed >> 8) % N);
+        tg.adj[src[i]][tg.adj_size[src[i]]++] = dst[i];
+    }
+    graph_csr_t *g = graph_csr_from_edges(N, src, dst, NULL, M);
+    int ref[N], map[N];
+    int ref_count = tarjan_scc(&tg, ref);
+    int count = tarjan_scc_csr(g, map);
+    EXPECT_EQ(count, ref_count);
+    bool ok = true;
+    for (int u = 0; u < N; u++) {
+        for (int v = 0; v < N; v++) ok = ok && ((ref[u] == ref[v]) == (map[u] == map[v]));
+    }
+    // 分量按逆拓扑序编号: 边只能指向编号不大于自己的分量
+    for (int i = 0; i < M; i++) ok = ok && map[src[i]] >= map[dst[i]];
+    EXPECT_TRUE(ok);
+    graph_csr_free(g);
+
+    // 20 万节点的长环, 递归实现会栈溢出
+    enum { RING = 200000 };
+    int *rs = malloc(RING * sizeof(int)), *rd = malloc(RING * sizeof(int)), *rmap = malloc(RING * sizeof(int));
+    for (int i = 0; i < RING; i++) {
+        rs[i] = i;
+        rd[i] = (i + 1) % RING;
+    }
+    g = graph_csr_from_edges(RING, rs, rd, NULL, RING);
+    EXPECT_EQ(tarjan_scc_csr(g, rmap), 1);
+    graph_csr_free(g);
+    free(rs);
+    free(rd);
+    free(rmap);
+}
+
 int main() {
     test_tarjan_types();
     test_tarjan_error_values();
     test_tarjan_graph_size();
     test_tarjan_config_fields();
     test_tarjan_state_fields();
+    test_tarjan_scc_csr();
 
     return 0;
 }
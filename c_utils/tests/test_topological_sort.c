@@ -63,12 +63,55 @@ void test_topological_sort_disconnected() {
     EXPECT_TRUE(success);
 }
 
+void test_topological_sort_csr() {
+    TEST(TopologicalSort_Csr);
+    // 随机 DAG: 只有小编号指向大编号的边, 再打乱节点编号
+    enum { N = 1000, M = 5000 };
+    int perm[N], src[M], dst[M], order[N], pos[N];
+    unsigned seed = 11;
+    for (int i = 0; i < N; i++) perm[i] = i;
+    for (int i = N - 1; i > 0; i--) {
+        seed = seed * 1103515245u + 12345u;
+        int j = (int)((seed >> 8) % (unsigned)(i + 1));
+        int t = perm[i];
+        perm[i] = perm[j];
+        perm[j] = t;
+    }
+    for (int i = 0; i < M; i++) {
+        seed = seed * 1103515245u + 12345u;
+        int a = (int)((seed >> 8) % N);
+        seed = seed * 1103515245u + 12345u;
+        int b = (int)((seed >> 8) % N);
+        if (a == b) b = (b + 1) % N;
+        src[i] = perm[a < b ? a : b];
+        dst[i] = perm[a < b ? b : a];
+    }
+    graph_csr_t *g = graph_csr_from_edges(N, src, dst, NULL, M);
+    size_t size = 0;
+    EXPECT_EQ(topological_sort_csr(g, order, &size), TOPOLOGICAL_SORT_OK);
+    EXPECT_EQ((int)size, N);
+    for (int i = 0; i < N; i++) pos[order[i]] = i;
+    bool ok = true;
+    for (int i = 0; i < M; i++) ok = ok && pos[src[i]] < pos[dst[i]];
+    EXPECT_TRUE(ok);
+    graph_csr_free(g);
+
+    // 0 -> 1 -> 2 -> 1 有环, 3 独立
+    int cs[] = { 0, 1, 2 };
+    int cd[] = { 1, 2, 1 };
+    g = graph_csr_from_edges(4, cs, cd, NULL, 3);
+    EXPECT_EQ(topological_sort_csr(g, order, &size), TOPOLOGICAL_SORT_CYCLE_DETECTED);
+    EXPECT_EQ((int)size, 2);
+    graph_csr_free(g);
+}
+
 int main() {
     test_topological_sort_simple();
     test_topological_sort_single();
     test_topological_sort_linear();
     test_topological_sort_cycle();
     test_topological_sort_disconnected();
+    test_topological_sort_csr();
 
     return 0;
 }
@@ -1,6 +1,9 @@
 #include "../c_utils/utest.h"
 #include "../c_utils/trie.h"
 #include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
 
 void test_trie_create() {
     TEST(Trie_Create);
@@ -78,6 +81,153 @@ void test_trie_clear() {
     trie_free(t);
 }
 
+static bool collect_keys(const char *key, void *value, void *user_data) {
+    (void)value;
+    char *out = (char *)user_data;
+    strcat(out, key);
+    strcat(out, ",");
+    return true;
+}
+
+void test_trie_ordered_traverse() {
+    TEST(Trie_OrderedTraverse);
+    trie_t* t = trie_create();
+    const char *words[] = {"pear", "apple", "app", "banana", "application", "ban", "b"};
+    for (size_t i = 0; i < sizeof(words) / sizeof(words[0]); i++) {
+        EXPECT_EQ(trie_insert(t, words[i], NULL), TRIE_OK);
+    }
+    EXPECT_EQ(trie_size(t), 7);
+    EXPECT_EQ(trie_insert(t, "apple", NULL), TRIE_DUPLICATE_KEY);
+    EXPECT_EQ(trie_size(t), 7);
+
+    char out[256] = {0};
+    trie_traverse(t, collect_keys, out);
+    EXPECT_STREQ(out, "app,apple,application,b,ban,banana,pear,");
+
+    char *keys[8];
+    void *values[8];
+    size_t n = trie_prefix_search(t, "app", keys, values, 8);
+    EXPECT_EQ(n, 3);
+    EXPECT_STREQ(keys[0], "app");
+    EXPECT_STREQ(keys[2], "application");
+    for (size_t i = 0; i < n; i++) free(keys[i]);
+
+    n = trie_prefix_search(t, "appl", keys, values, 1);
+    EXPECT_EQ(n, 1);
+    EXPECT_STREQ(keys[0], "apple");
+    free(keys[0]);
+    EXPECT_EQ(trie_prefix_search(t, "apx", keys, values, 8), 0);
+    EXPECT_EQ(trie_prefix_search(t, "bananas", keys, values, 8), 0);
+
+    trie_free(t);
+}
+
+void test_trie_node_growth_and_remove() {
+    TEST(Trie_NodeGrowthAndRemove);
+    trie_t* t = trie_create();
+    size_t empty = trie_memory_usage(t);
+    static int values[512];
+    char key[16];
+
+    /* 同一父节点下 256 个分支, 依次经过 Node4/16/48/256 */
+    for (int i = 0; i < 512; i++) {
+        values[i] = i;
+        snprintf(key, sizeof(key), "k%c%d", (char)(1 + i % 255), i / 255);
+        EXPECT_EQ(trie_insert(t, key, &values[i]), TRIE_OK);
+    }
+    EXPECT_EQ(trie_size(t), 512);
+    for (int i = 0; i < 512; i++) {
+        snprintf(key, sizeof(key), "k%c%d", (char)(1 + i % 255), i / 255);
+        int *found = (int *)trie_get(t, key);
+        EXPECT_TRUE(found != NULL && *found == i);
+    }
+
+    /* 删除过程中节点逐级收缩, 剩余键必须仍可访问 */
+    for (int i = 0; i < 512; i += 2) {
+        snprintf(key, sizeof(key), "k%c%d", (char)(1 + i % 255), i / 255);
+        EXPECT_TRUE(trie_remove(t, key));
+        EXPECT_FALSE(trie_remove(t, key));
+    }
+    EXPECT_EQ(trie_size(t), 256);
+    for (int i = 1; i < 512; i += 2) {
+        snprintf(key, sizeof(key), "k%c%d", (char)(1 + i % 255), i / 255);
+        EXPECT_TRUE(trie_get(t, key) == &values[i]);
+    }
+    for (int i = 1; i < 512; i += 2) {
+        snprintf(key, sizeof(key), "k%c%d", (char)(1 + i % 255), i / 255);
+        EXPECT_TRUE(trie_remove(t, key));
+    }
+    EXPECT_EQ(trie_size(t), 0);
+    EXPECT_EQ(trie_memory_usage(t), empty);
+
+    trie_free(t);
+}
+
+void test_trie_long_shared_prefix() {
+    TEST(Trie_LongSharedPrefix);
+    trie_t* t = trie_create();
+    char key[128];
+
+    /* 公共前缀远长于节点内联前缀, 插入时需要在前缀中途分裂 */
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "https://example.com/api/v1/users/%d/profile/%d", i % 37, i);
+        EXPECT_EQ(trie_insert(t, key, (void *)(intptr_t)(i + 1)), TRIE_OK);
+    }
+    EXPECT_EQ(trie_insert(t, "https://example.com/api/v1/", (void *)(intptr_t)5000), TRIE_OK);
+    EXPECT_EQ(trie_insert(t, "https://example.org", (void *)(intptr_t)5001), TRIE_OK);
+    EXPECT_EQ(trie_size(t), 1002);
+
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "https://example.com/api/v1/users/%d/profile/%d", i % 37, i);
+        EXPECT_EQ((intptr_t)trie_get(t, key), i + 1);
+    }
+    EXPECT_TRUE(trie_get(t, "https://example.com/api/v2/") == NULL);
+    EXPECT_TRUE(trie_get(t, "https://example.com/api/v1") == NULL);
+
+    char *keys[64];
+    void *values[64];
+    size_t n = trie_prefix_search(t, "https://example.com/api/v1/users/3/", keys, values, 64);
+    EXPECT_EQ(n, 27);
+    for (size_t i = 0; i < n; i++) {
+        EXPECT_TRUE(strncmp(keys[i], "https://example.com/api/v1/users/3/", 35) == 0);
+        if (i > 0) EXPECT_TRUE(strcmp(keys[i - 1], keys[i]) < 0);
+    }
+    for (size_t i = 0; i < n; i++) free(keys[i]);
+
+    EXPECT_TRUE(trie_remove(t, "https://example.org"));
+    EXPECT_TRUE(trie_remove(t, "https://example.com/api/v1/"));
+    for (int i = 0; i < 1000; i += 3) {
+        snprintf(key, sizeof(key), "https://example.com/api/v1/users/%d/profile/%d", i % 37, i);
+        EXPECT_TRUE(trie_remove(t, key));
+    }
+    for (int i = 0; i < 1000; i++) {
+        snprintf(key, sizeof(key), "https://example.com/api/v1/users/%d/profile/%d", i % 37, i);
+        EXPECT_EQ(trie_contains(t, key), i % 3 != 0);
+    }
+
+    trie_free(t);
+}
+
+void test_trie_config() {
+    TEST(Trie_Config);
+    trie_config_t config = {false, true, 8, 0, free};
+    trie_t* t = trie_create_with_config(&config);
+
+    int *v1 = malloc(sizeof(int));
+    int *v2 = malloc(sizeof(int));
+    *v1 = 1;
+    *v2 = 2;
+    EXPECT_EQ(trie_insert(t, "Hello", v1), TRIE_OK);
+    EXPECT_EQ(trie_insert(t, "HELLO", v2), TRIE_OK);
+    EXPECT_EQ(trie_size(t), 1);
+    EXPECT_EQ(*(int *)trie_get(t, "hello"), 2);
+    EXPECT_EQ(trie_insert(t, "toolongkey", NULL), TRIE_INVALID_PARAMS);
+    EXPECT_TRUE(trie_remove(t, "hElLo"));
+    EXPECT_EQ(trie_size(t), 0);
+
+    trie_free(t);
+}
+
 int main() {
     UTEST_BEGIN();
     test_trie_create();
@@ -85,5 +235,9 @@ int main() {
     test_trie_prefix();
     test_trie_empty_key();
     test_trie_clear();
+    test_trie_ordered_traverse();
+    test_trie_node_growth_and_remove();
+    test_trie_long_shared_prefix();
+    test_trie_config();
     UTEST_END();
 }
@@ -66,6 +66,9 @@ TEST(crc32_basic) {
     crc = zip_crc32("123456789", 9);
     ASSERT_EQ(crc, 0xCBF43926);
     
+    crc = zip_crc32("\xff\xfe", 2);
+    ASSERT_EQ(crc, 0x88F83096);
+    
     crc = zip_crc32("hello", 5);
     ASSERT_TRUE(crc != 0);
 }
@@ -527,6 +530,246 @@ TEST(extract_all) {
     rmdir("/tmp/extract_all_dir");
 }
 
+static void fill_log_text(char* buf, size_t size) {
+    size_t pos = 0;
+    int line = 0;
+    while (pos < size) {
+        char tmp[96];
+        int n = snprintf(tmp, sizeof(tmp), "2024-01-01 12:00:%02d INFO worker-%d request handled ok\n",
+                         line % 60, line % 8);
+        for (int i = 0; i < n && pos < size; i++) {
+            buf[pos++] = tmp[i];
+        }
+        line++;
+    }
+}
+
+TEST(deflate_roundtrip_memory) {
+    size_t content_size = 100000;
+    char* content = (char*)malloc(content_size);
+    ASSERT_TRUE(content != NULL);
+    fill_log_text(content, content_size);
+    
+    zip_error_t error;
+    zip_writer_t* writer = zip_writer_create_memory(&error);
+    ASSERT_TRUE(writer != NULL);
+    
+    error = zip_writer_add_data(writer, "app.log", content, content_size, ZIP_COMPRESS_DEFAULT);
+    ASSERT_EQ(error, ZIP_OK);
+    ASSERT_EQ(zip_writer_finish(writer), ZIP_OK);
+    
+    size_t size;
+    const void* buffer = zip_writer_get_buffer(writer, &size);
+    ASSERT_TRUE(size < content_size / 4);
+    
+    zip_reader_t* reader = zip_reader_create_memory(buffer, size, &error);
+    ASSERT_TRUE(reader != NULL);
+    
+    zip_entry_info_t info;
+    ASSERT_EQ(zip_reader_get_entry_info(reader, 0, &info), ZIP_OK);
+    ASSERT_EQ(info.compression_method, ZIP_METHOD_DEFLATE);
+    ASSERT_EQ(info.uncompressed_size, content_size);
+    ASSERT_TRUE(info.compressed_size < content_size);
+    
+    char* output = (char*)malloc(content_size);
+    size_t output_size = content_size;
+    error = zip_reader_extract_to_memory(reader, 0, output, &output_size);
+    ASSERT_EQ(error, ZIP_OK);
+    ASSERT_EQ(output_size, content_size);
+    ASSERT_TRUE(memcmp(output, content, content_size) == 0);
+    
+    free(output);
+    free(content);
+    zip_reader_destroy(reader);
+    zip_writer_destroy(writer);
+}
+
+TEST(deflate_incompressible_falls_back_to_store) {
+    unsigned char content[4096];
+    unsigned int seed = 12345;
+    for (size_t i = 0; i < sizeof(content); i++) {
+        seed = seed * 1103515245 + 12345;
+        content[i] = (unsigned char)(seed >> 16);
+    }
+    
+    zip_error_t error;
+    zip_writer_t* writer = zip_writer_create_memory(&error);
+    ASSERT_TRUE(writer != NULL);
+    ASSERT_EQ(zip_writer_add_data(writer, "random.bin", content, sizeof(content), ZIP_COMPRESS_BEST), ZIP_OK);
+    ASSERT_EQ(zip_writer_finish(writer), ZIP_OK);
+    
+    size_t size;
+    const void* buffer = zip_writer_get_buffer(writer, &size);
+    zip_reader_t* reader = zip_reader_create_memory(buffer, size, &error);
+    ASSERT_TRUE(reader != NULL);
+    
+    zip_entry_info_t info;
+    ASSERT_EQ(zip_reader_get_entry_info(reader, 0, &info), ZIP_OK);
+    ASSERT_EQ(info.compression_method, ZIP_METHOD_STORE);
+    
+    unsigned char output[4096];
+    size_t output_size = sizeof(output);
+    ASSERT_EQ(zip_reader_extract_to_memory(reader, 0, output, &output_size), ZIP_OK);
+    ASSERT_TRUE(memcmp(output, content, sizeof(content)) == 0);
+    
+    zip_reader_destroy(reader);
+    zip_writer_destroy(writer);
+}
+
+TEST(deflate_add_file_streaming) {
+    size_t content_size = 300000;
+    char* content = (char*)malloc(content_size);
+    ASSERT_TRUE(content != NULL);
+    fill_log_text(content, content_size);
+    
+    FILE* src = fopen("/tmp/zip_stream_src.log", "wb");
+    ASSERT_TRUE(src != NULL);
+    fwrite(content, 1, content_size, src);
+    fclose(src);
+    
+    zip_error_t error;
+    zip_writer_t* writer = zip_writer_create("/tmp/zip_stream_test.zip", &error);
+    ASSERT_TRUE(writer != NULL);
+    ASSERT_EQ(zip_writer_add_file(writer, "/tmp/zip_stream_src.log", "stream.log", ZIP_COMPRESS_FAST), ZIP_OK);
+    ASSERT_EQ(zip_writer_add_data(writer, "tail.txt", "tail", 4, ZIP_COMPRESS_NONE), ZIP_OK);
+    ASSERT_EQ(zip_writer_finish(writer), ZIP_OK);
+    zip_writer_destroy(writer);
+    
+    zip_reader_t* reader = zip_reader_create("/tmp/zip_stream_test.zip", &error);
+    ASSERT_TRUE(reader != NULL);
+    
+    int index = zip_reader_find_entry(reader, "stream.log");
+    ASSERT_EQ(index, 0);
+    
+    zip_entry_info_t info;
+    ASSERT_EQ(zip_reader_get_entry_info(reader, 0, &info), ZIP_OK);
+    ASSERT_EQ(info.compression_method, ZIP_METHOD_DEFLATE);
+    ASSERT_EQ(info.uncompressed_size, content_size);
+    ASSERT_EQ(info.crc32, zip_crc32(content, content_size));
+    
+    ASSERT_EQ(zip_reader_extract_to_file(reader, 0, "/tmp/zip_stream_out.log"), ZIP_OK);
+    
+    FILE* out = fopen("/tmp/zip_stream_out.log", "rb");
+    ASSERT_TRUE(out != NULL);
+    char* output = (char*)malloc(content_size + 1);
+    size_t read_size = fread(output, 1, content_size + 1, out);
+    fclose(out);
+    ASSERT_EQ(read_size, content_size);
+    ASSERT_TRUE(memcmp(output, content, content_size) == 0);
+    
+    char tail[8];
+    size_t tail_size = sizeof(tail);
+    ASSERT_EQ(zip_reader_extract_to_memory(reader, 1, tail, &tail_size), ZIP_OK);
+    ASSERT_EQ(tail_size, 4);
+    
+    free(output);
+    free(content);
+    zip_reader_destroy(reader);
+    unlink("/tmp/zip_stream_src.log");
+    unlink("/tmp/zip_stream_out.log");
+    unlink("/tmp/zip_stream_test.zip");
+}
+
+TEST(deflate_corrupted_data) {
+    char content[2048];
+    fill_log_text(content, sizeof(content));
+    
+    zip_error_t error;
+    zip_writer_t* writer = zip_writer_create_memory(&error);
+    ASSERT_TRUE(writer != NULL);
+    ASSERT_EQ(zip_writer_add_data(writer, "a.log", content, sizeof(content), ZIP_COMPRESS_DEFAULT), ZIP_OK);
+    ASSERT_EQ(zip_writer_finish(writer), ZIP_OK);
+    
+    size_t size;
+    const void* buffer = zip_writer_get_buffer(writer, &size);
+    unsigned char* copy = (unsigned char*)malloc(size);
+    memcpy(copy, buffer, size);
+    copy[30 + 5 + 10] ^= 0x5A;
+    
+    zip_reader_t* reader = zip_reader_create_memory(copy, size, &error);
+    ASSERT_TRUE(reader != NULL);
+    
+    char output[2048];
+    size_t output_size = sizeof(output);
+    error = zip_reader_extract_to_memory(reader, 0, output, &output_size);
+    ASSERT_TRUE(error != ZIP_OK);
+    
+    zip_reader_destroy(reader);
+    free(copy);
+    zip_writer_destroy(writer);
+}
+
+TEST(parallel_add_files) {
+    const char* paths[6];
+    char path_storage[6][64];
+    char names_storage[6][32];
+    const char* names[6];
+    char contents[6][20000];
+    
+    for (int i = 0; i < 6; i++) {
+        snprintf(path_storage[i], sizeof(path_storage[i]), "/tmp/zip_parallel_%d.log", i);
+        snprintf(names_storage[i], sizeof(names_storage[i]), "part%d.log", i);
+        paths[i] = path_storage[i];
+        names[i] = names_storage[i];
+        fill_log_text(contents[i], sizeof(contents[i]));
+        contents[i][0] = (char)('A' + i);
+        FILE* f = fopen(paths[i], "wb");
+        ASSERT_TRUE(f != NULL);
+        fwrite(contents[i], 1, sizeof(contents[i]), f);
+        fclose(f);
+    }
+    
+    threadpool_t* pool = threadpool_create(2);
+    ASSERT_TRUE(pool != NULL);
+    
+    zip_error_t error;
+    zip_writer_t* writer = zip_writer_create_memory(&error);
+    ASSERT_TRUE(writer != NULL);
+    ASSERT_EQ(zip_writer_add_files_parallel(writer, paths, names, 6, ZIP_COMPRESS_DEFAULT, pool), ZIP_OK);
+    ASSERT_EQ(zip_writer_add_files_parallel(writer, paths, NULL, 2, ZIP_COMPRESS_NONE, NULL), ZIP_OK);
+    ASSERT_EQ(zip_writer_finish(writer), ZIP_OK);
+    threadpool_destroy(pool);
+    
+    size_t size;
+    const void* buffer = zip_writer_get_buffer(writer, &size);
+    zip_reader_t* reader = zip_reader_create_memory(buffer, size, &error);
+    ASSERT_TRUE(reader != NULL);
+    ASSERT_EQ(zip_reader_get_entry_count(reader), 8);
+    
+    for (int i = 0; i < 6; i++) {
+        ASSERT_EQ(zip_reader_find_entry(reader, names[i]), i);
+        char output[20000];
+        size_t output_size = sizeof(output);
+        ASSERT_EQ(zip_reader_extract_to_memory(reader, i, output, &output_size), ZIP_OK);
+        ASSERT_TRUE(memcmp(output, contents[i], sizeof(output)) == 0);
+    }
+    ASSERT_EQ(zip_reader_find_entry(reader, "zip_parallel_1.log"), 7);
+    
+    const char* missing[] = { "/tmp/zip_parallel_missing.log" };
+    ASSERT_EQ(zip_writer_add_files_parallel(writer, missing, NULL, 1, ZIP_COMPRESS_DEFAULT, NULL),
+              ZIP_ERR_ALREADY_FINISHED);
+    
+    zip_reader_destroy(reader);
+    zip_writer_destroy(writer);
+    for (int i = 0; i < 6; i++) {
+        unlink(paths[i]);
+    }
+}
+
+TEST(parallel_missing_file) {
+    zip_error_t error;
+    zip_writer_t* writer = zip_writer_create_memory(&error);
+    ASSERT_TRUE(writer != NULL);
+    
+    const char* missing[] = { "/tmp/zip_parallel_missing.log" };
+    error = zip_writer_add_files_parallel(writer, missing, NULL, 1, ZIP_COMPRESS_DEFAULT, NULL);
+    ASSERT_EQ(error, ZIP_ERR_FILE_NOT_FOUND);
+    ASSERT_EQ(zip_writer_add_files_parallel(NULL, missing, NULL, 1, ZIP_COMPRESS_DEFAULT, NULL),
+              ZIP_ERR_NULL_PTR);
+    
+    zip_writer_destroy(writer);
+}
+
 int main(void) {
     printf("\n");
     printf("═══════════════════════════════════════════════════════════════\n");
@@ -567,6 +810,16 @@ int main(void) {
     RUN_TEST(writer_file_based);
     RUN_TEST(extract_all);
     
+    printf("\nDEFLATE压缩测试:\n");
+    RUN_TEST(deflate_roundtrip_memory);
+    RUN_TEST(deflate_incompressible_falls_back_to_store);
+    RUN_TEST(deflate_add_file_streaming);
+    RUN_TEST(deflate_corrupted_data);
+    
+    printf("\n并行压缩测试:\n");
+    RUN_TEST(parallel_add_files);
+    RUN_TEST(parallel_missing_file);
+    
     printf("\n");
     printf("═══════════════════════════════════════════════════════════════\n");
     printf("测试结果: 通过 %d, 失败 %d\n", tests_passed, tests_failed);